@@ -328,6 +328,14 @@ shared libraries and run with --known-mpi-shared-libraries=1')
                        if (MPI_Neighbor_alltoallv(0,0,0,MPI_INT,0,0,0,MPI_INT,distcomm));\n\
                        if (MPI_Ineighbor_alltoallv(0,0,0,MPI_INT,0,0,0,MPI_INT,distcomm,&req));\n'):
       self.addDefine('HAVE_MPI_NEIGHBORHOOD_COLLECTIVES',1)
+      # persistent neighborhood collectives are in MPI-4, OpenMPI provides them as an extension
+      persistent_test = 'MPI_Comm distcomm = MPI_COMM_NULL; MPI_Request req;\n\
+                         if (%s(0,0,0,MPI_INT,0,0,0,MPI_INT,distcomm,MPI_INFO_NULL,&req));\n'
+      if self.checkLink('#include <mpi.h>\n',persistent_test % 'MPI_Neighbor_alltoallv_init'):
+        self.addDefine('HAVE_MPI_PERSISTENT_NEIGHBORHOOD_COLLECTIVES',1)
+      elif self.checkLink('#include <mpi.h>\n#include <mpi-ext.h>\n',persistent_test % 'MPIX_Neighbor_alltoallv_init'):
+        self.addDefine('HAVE_MPIX_NEIGHBOR_ALLTOALLV_INIT',1)
+        self.addDefine('HAVE_MPI_PERSISTENT_NEIGHBORHOOD_COLLECTIVES',1)
     if hasattr(self, 'ompi_major_version'):
       openmpi_cuda_test = '#include<mpi.h>\n #include <mpi-ext.h>\n #if defined(MPIX_CUDA_AWARE_SUPPORT) && MPIX_CUDA_AWARE_SUPPORT\n #else\n #error This OpenMPI is not CUDA-aware\n #endif\n'
       if self.checkCompile(openmpi_cuda_test):
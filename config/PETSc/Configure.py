@@ -126,7 +126,7 @@ class Configure(config.base.Configure):
                                             'unistd','sys/sysinfo','machine/endian','sys/param','sys/procfs','sys/resource',
                                             'sys/systeminfo','sys/times','sys/utsname',
                                             'sys/socket','sys/wait','netinet/in','netdb','direct','time','Ws2tcpip','sys/types',
-                                            'WindowsX','float','ieeefp','stdint','pthread','inttypes','immintrin','zmmintrin'])
+                                            'WindowsX','float','ieeefp','stdint','pthread','inttypes','immintrin','zmmintrin','linux/perf_event'])
     functions = ['access','_access','clock','drand48','getcwd','_getcwd','getdomainname','gethostname',
                  'getwd','memalign','popen','PXFGETARG','rand','getpagesize',
                  'readlink','realpath','usleep','sleep','_sleep',
@@ -580,6 +580,28 @@ prepend-path PATH "%s"
     if not self.framework.argDB['with-batch']:
       self.addDefine('USE_ISATTY',1)
 
+  def configurePerfEventCounters(self):
+    '''Check if the hardware counters used by -log_view_hwcounters can be opened on this machine
+       Virtual machines often have no PMU, and perf_event_paranoid may forbid them, so this can only be found by running a program'''
+    if self.framework.argDB['with-batch'] or not self.headers.haveHeader('linux/perf_event.h'):
+      return
+    includes = '#include <linux/perf_event.h>\n#include <sys/syscall.h>\n#include <unistd.h>\n#include <string.h>\n'
+    body = '''struct perf_event_attr attr;
+  long fd;
+  memset(&attr,0,sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = PERF_COUNT_HW_CPU_CYCLES;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  fd = syscall(SYS_perf_event_open,&attr,0,-1,-1,0);
+  if (fd < 0) return 1;
+  close((int)fd);
+'''
+    if self.checkRun(includes,body):
+      self.addDefine('HAVE_PERF_EVENT_COUNTERS',1)
+    return
+
   def configureDeprecated(self):
     '''Check if __attribute((deprecated)) is supported'''
     self.pushLanguage(self.languages.clanguage)
@@ -914,6 +936,7 @@ char assert_aligned[(sizeof(struct mystruct)==16)*2-1];
     self.executeTest(self.configureUnused)
     self.executeTest(self.configureDeprecated)
     self.executeTest(self.configureIsatty)
+    self.executeTest(self.configurePerfEventCounters)
     self.executeTest(self.configureExpect);
     self.executeTest(self.configureAlign);
     self.executeTest(self.configureFunctionName);
@@ -99,6 +99,21 @@
 #define MATAIJSELL         'aijsell'
 #define MATSEQAIJSELL      'seqaijsell'
 #define MATMPIAIJSELL      'mpiaijsell'
+#define MATAIJOMP          'aijomp'
+#define MATSEQAIJOMP       'seqaijomp'
+#define MATMPIAIJOMP       'mpiaijomp'
+#define MATAIJMIXED        'aijmixed'
+#define MATSEQAIJMIXED     'seqaijmixed'
+#define MATMPIAIJMIXED     'mpiaijmixed'
+#define MATAIJAUTO         'aijauto'
+#define MATSEQAIJAUTO      'seqaijauto'
+#define MATMPIAIJAUTO      'mpiaijauto'
+#define MATAIJVBLOCK       'aijvblock'
+#define MATSEQAIJVBLOCK    'seqaijvblock'
+#define MATMPIAIJVBLOCK    'mpiaijvblock'
+#define MATAIJDELTA        'aijdelta'
+#define MATSEQAIJDELTA     'seqaijdelta'
+#define MATMPIAIJDELTA     'mpiaijdelta'
 #define MATAIJMKL          'aijmkl'
 #define MATSEQAIJMKL       'seqaijmkl'
 #define MATMPIAIJMKL       'mpiaijmkl'
@@ -181,6 +196,8 @@
 #define MATSOLVERMATLAB          'matlab'
 #define MATSOLVERPETSC           'petsc'
 #define MATSOLVERBAS             'bas'
+#define MATSOLVERCHOWILU         'chowilu'
+#define MATSOLVERSUPERNODAL      'supernodal'
 #define MATSOLVERCUSPARSE        'cusparse'
 #define MATSOLVERCUDA            'cuda'
 
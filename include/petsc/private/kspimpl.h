@@ -104,6 +104,8 @@ struct _p_KSP {
   PetscInt      chknorm;             /* only compute/check norm if iterations is great than this */
   PetscBool     lagnorm;             /* Lag the residual norm calculation so that it is computed as part of the
                                         MPI_Allreduce() for computing the inner products for the next iteration. */
+  PetscBool     overlapreductions;   /* Start reductions before applying the preconditioner or operator that could
+                                        otherwise follow them, even if that application turns out to be unneeded */
   /* --------User (or default) routines (most return -1 on error) --------*/
   PetscErrorCode (*monitor[MAXKSPMONITORS])(KSP,PetscInt,PetscReal,void*); /* returns control to user after */
   PetscErrorCode (*monitordestroy[MAXKSPMONITORS])(void**);         /* */
@@ -257,12 +259,18 @@ PETSC_STATIC_INLINE PetscErrorCode KSP_RemoveNullSpaceTranspose(KSP ksp,Vec y)
   PetscFunctionReturn(0);
 }
 
+/*
+   The operator and preconditioner applications are where the Krylov methods spend their time between starting
+   a split reduction with PetscCommSplitReductionBegin() and needing its result, so drive its progress there
+*/
 PETSC_STATIC_INLINE PetscErrorCode KSP_MatMult(KSP ksp,Mat A,Vec x,Vec y)
 {
   PetscErrorCode ierr;
   PetscFunctionBegin;
+  ierr = PetscCommSplitReductionProgress(PetscObjectComm((PetscObject)x));CHKERRQ(ierr);
   if (!ksp->transpose_solve) {ierr = MatMult(A,x,y);CHKERRQ(ierr);}
   else                       {ierr = MatMultTranspose(A,x,y);CHKERRQ(ierr);}
+  ierr = PetscCommSplitReductionProgress(PetscObjectComm((PetscObject)x));CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -279,6 +287,7 @@ PETSC_STATIC_INLINE PetscErrorCode KSP_PCApply(KSP ksp,Vec x,Vec y)
 {
   PetscErrorCode ierr;
   PetscFunctionBegin;
+  ierr = PetscCommSplitReductionProgress(PetscObjectComm((PetscObject)x));CHKERRQ(ierr);
   if (!ksp->transpose_solve) {
     ierr = PCApply(ksp->pc,x,y);CHKERRQ(ierr);
     ierr = KSP_RemoveNullSpace(ksp,y);CHKERRQ(ierr);
@@ -286,6 +295,7 @@ PETSC_STATIC_INLINE PetscErrorCode KSP_PCApply(KSP ksp,Vec x,Vec y)
     ierr = PCApplyTranspose(ksp->pc,x,y);CHKERRQ(ierr);
     ierr = KSP_RemoveNullSpaceTranspose(ksp,y);CHKERRQ(ierr);
   }
+  ierr = PetscCommSplitReductionProgress(PetscObjectComm((PetscObject)x));CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -307,6 +317,7 @@ PETSC_STATIC_INLINE PetscErrorCode KSP_PCApplyBAorAB(KSP ksp,Vec x,Vec y,Vec w)
 {
   PetscErrorCode ierr;
   PetscFunctionBegin;
+  ierr = PetscCommSplitReductionProgress(PetscObjectComm((PetscObject)x));CHKERRQ(ierr);
   if (!ksp->transpose_solve) {
     ierr = PCApplyBAorAB(ksp->pc,ksp->pc_side,x,y,w);CHKERRQ(ierr);
     ierr = KSP_RemoveNullSpace(ksp,y);CHKERRQ(ierr);
@@ -314,6 +325,7 @@ PETSC_STATIC_INLINE PetscErrorCode KSP_PCApplyBAorAB(KSP ksp,Vec x,Vec y,Vec w)
     ierr = PCApplyBAorABTranspose(ksp->pc,ksp->pc_side,x,y,w);CHKERRQ(ierr);
     ierr = KSP_RemoveNullSpaceTranspose(ksp,y);CHKERRQ(ierr);
   }
+  ierr = PetscCommSplitReductionProgress(PetscObjectComm((PetscObject)x));CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
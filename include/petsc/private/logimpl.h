@@ -124,5 +124,11 @@ PETSC_EXTERN PetscErrorCode PetscStageLogGetClassPerfLog(PetscStageLog, int, Pet
 PETSC_EXTERN PetscErrorCode PetscEventRegLogGetEvent(PetscEventRegLog, const char [], PetscLogEvent *);
 
 PETSC_INTERN PetscErrorCode PetscLogView_Nested(PetscViewer);
+/* Hardware counters */
+PETSC_INTERN PetscErrorCode PetscLogHWCountersInitialize(void);
+PETSC_INTERN PetscErrorCode PetscLogHWCountersRead(PetscLogDouble[]);
+PETSC_INTERN PetscErrorCode PetscLogHWCountersFinalize(void);
 PETSC_INTERN PetscErrorCode PetscLogNestedEnd(void);
+PETSC_INTERN PetscErrorCode PetscLogTimelineViewFromOptions(void);
+PETSC_INTERN PetscErrorCode PetscLogTimelineFinalize(void);
 #endif /* PETSC_USE_LOG */
@@ -1709,6 +1709,8 @@ PETSC_EXTERN PetscLogEvent MAT_Scale;
 PETSC_EXTERN PetscLogEvent MAT_AssemblyBegin;
 PETSC_EXTERN PetscLogEvent MAT_AssemblyEnd;
 PETSC_EXTERN PetscLogEvent MAT_SetValues;
+PETSC_EXTERN PetscLogEvent MAT_PreallCOO;
+PETSC_EXTERN PetscLogEvent MAT_SetVCOO;
 PETSC_EXTERN PetscLogEvent MAT_GetValues;
 PETSC_EXTERN PetscLogEvent MAT_GetRow;
 PETSC_EXTERN PetscLogEvent MAT_GetRowIJ;
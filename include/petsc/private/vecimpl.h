@@ -96,6 +96,9 @@ struct _VecOps {
   PetscErrorCode (*bindtocpu)(Vec,PetscBool);
   PetscErrorCode (*getarraywrite)(Vec,PetscScalar**);
   PetscErrorCode (*restorearraywrite)(Vec,PetscScalar**);
+  PetscErrorCode (*axpydot)(Vec,PetscScalar,Vec,Vec,PetscScalar*);                                /* y = y + alpha * x, z = w^H * y */
+  PetscErrorCode (*waxpynorm)(Vec,PetscScalar,Vec,Vec,PetscReal*);                                 /* w = y + alpha * x, z = sqrt(w^H * w) */
+  PetscErrorCode (*maxpymdot)(Vec,PetscInt,const PetscScalar*,Vec*,PetscScalar*,PetscReal*);       /* y = y + alpha[j] x[j], z[j] = x[j]^H * y */
 };
 
 /*
@@ -180,6 +183,9 @@ PETSC_EXTERN PetscLogEvent VEC_Swap;
 PETSC_EXTERN PetscLogEvent VEC_AssemblyBegin;
 PETSC_EXTERN PetscLogEvent VEC_DotNorm2;
 PETSC_EXTERN PetscLogEvent VEC_AXPBYPCZ;
+PETSC_EXTERN PetscLogEvent VEC_AXPYDot;
+PETSC_EXTERN PetscLogEvent VEC_WAXPYNorm;
+PETSC_EXTERN PetscLogEvent VEC_MAXPYMDot;
 PETSC_EXTERN PetscLogEvent VEC_Ops;
 PETSC_EXTERN PetscLogEvent VEC_ViennaCLCopyToGPU;
 PETSC_EXTERN PetscLogEvent VEC_ViennaCLCopyFromGPU;
@@ -333,5 +339,6 @@ PETSC_EXTERN PetscBool      VecTaggerRegisterAllCalled;
 PETSC_EXTERN PetscErrorCode VecTaggerRegisterAll(void);
 PETSC_EXTERN PetscErrorCode VecTaggerComputeIS_FromBoxes(VecTagger,Vec,IS*);
 PETSC_EXTERN PetscMPIInt Petsc_Reduction_keyval;
+PETSC_INTERN PetscInt VecMultiThreads;
 
 #endif
@@ -52,6 +52,8 @@ typedef const char* KSPType;
 #define   KSPLGMRES     "lgmres"
 #define   KSPDGMRES     "dgmres"
 #define   KSPPGMRES     "pgmres"
+#define   KSPSGMRES     "sgmres"
+#define   KSPGCRODR     "gcrodr"
 #define KSPTCQMR      "tcqmr"
 #define KSPBCGS       "bcgs"
 #define   KSPIBCGS      "ibcgs"
@@ -214,6 +216,7 @@ PETSC_EXTERN PetscErrorCode KSPGMRESGetRestart(KSP, PetscInt*);
 PETSC_EXTERN PetscErrorCode KSPGMRESSetHapTol(KSP,PetscReal);
 
 PETSC_EXTERN PetscErrorCode KSPGMRESSetPreAllocateVectors(KSP);
+PETSC_EXTERN PetscErrorCode KSPGMRESSetContiguousBasis(KSP,PetscBool);
 PETSC_EXTERN PetscErrorCode KSPGMRESSetOrthogonalization(KSP,PetscErrorCode (*)(KSP,PetscInt));
 PETSC_EXTERN PetscErrorCode KSPGMRESGetOrthogonalization(KSP,PetscErrorCode (**)(KSP,PetscInt));
 PETSC_EXTERN PetscErrorCode KSPGMRESModifiedGramSchmidtOrthogonalization(KSP,PetscInt);
@@ -224,6 +227,27 @@ PETSC_EXTERN PetscErrorCode KSPLGMRESSetConstant(KSP);
 
 PETSC_EXTERN PetscErrorCode KSPPIPEFGMRESSetShift(KSP,PetscScalar);
 
+/*E
+    KSPSGMRESBasisType - Polynomial used by KSPSGMRES to generate the basis vectors of a block
+
+$  KSP_SGMRES_BASIS_MONOMIAL - scaled powers of the operator, only usable for small numbers of steps
+$  KSP_SGMRES_BASIS_NEWTON - products of shifted operators, the shifts are Leja ordered Ritz values
+$  KSP_SGMRES_BASIS_CHEBYSHEV - Chebyshev polynomials on an interval containing the real parts of the Ritz values
+
+   Level: intermediate
+
+.seealso: KSPSGMRES, KSPSGMRESSetBasisType(), KSPSGMRESGetBasisType(), KSPSGMRESSetSteps()
+E*/
+typedef enum {KSP_SGMRES_BASIS_MONOMIAL,KSP_SGMRES_BASIS_NEWTON,KSP_SGMRES_BASIS_CHEBYSHEV} KSPSGMRESBasisType;
+PETSC_EXTERN const char *const KSPSGMRESBasisTypes[];
+PETSC_EXTERN PetscErrorCode KSPSGMRESSetSteps(KSP,PetscInt);
+PETSC_EXTERN PetscErrorCode KSPSGMRESGetSteps(KSP,PetscInt*);
+PETSC_EXTERN PetscErrorCode KSPSGMRESSetBasisType(KSP,KSPSGMRESBasisType);
+PETSC_EXTERN PetscErrorCode KSPSGMRESGetBasisType(KSP,KSPSGMRESBasisType*);
+
+PETSC_EXTERN PetscErrorCode KSPGCRODRSetRecycleSize(KSP,PetscInt);
+PETSC_EXTERN PetscErrorCode KSPGCRODRGetRecycleSize(KSP,PetscInt*);
+
 PETSC_EXTERN PetscErrorCode KSPGCRSetRestart(KSP,PetscInt);
 PETSC_EXTERN PetscErrorCode KSPGCRGetRestart(KSP,PetscInt*);
 PETSC_EXTERN PetscErrorCode KSPGCRSetModifyPC(KSP,PetscErrorCode (*)(KSP,PetscInt,PetscReal,void*),void*,PetscErrorCode(*)(void*));
@@ -451,6 +475,8 @@ PETSC_EXTERN PetscErrorCode KSPGetNormType(KSP,KSPNormType*);
 PETSC_EXTERN PetscErrorCode KSPSetSupportedNorm(KSP ksp,KSPNormType,PCSide,PetscInt);
 PETSC_EXTERN PetscErrorCode KSPSetCheckNormIteration(KSP,PetscInt);
 PETSC_EXTERN PetscErrorCode KSPSetLagNorm(KSP,PetscBool);
+PETSC_EXTERN PetscErrorCode KSPSetOverlapReductions(KSP,PetscBool);
+PETSC_EXTERN PetscErrorCode KSPGetOverlapReductions(KSP,PetscBool*);
 
 #define KSP_DIVERGED_PCSETUP_FAILED_DEPRECATED KSP_DIVERGED_PCSETUP_FAILED PETSC_DEPRECATED_ENUM("Use KSP_DIVERGED_PC_FAILED (since version 3.11)")
 /*E
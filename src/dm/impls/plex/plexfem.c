@@ -5055,6 +5055,7 @@ PetscErrorCode DMPlexComputeJacobian_Internal(DM dm, IS cellIS, PetscReal t, Pet
   PetscInt        Nf, fieldI, fieldJ;
   PetscInt        totDim, totDimAux, cStart, cEnd, numCells, c;
   PetscBool       isMatIS, isMatISP, hasJac, hasPrec, hasDyn, hasFV = PETSC_FALSE, transform;
+  PetscErrorCode  (*setState)(Mat,Vec) = NULL;
   PetscErrorCode  ierr;
 
   PetscFunctionBegin;
@@ -5078,6 +5079,9 @@ PetscErrorCode DMPlexComputeJacobian_Internal(DM dm, IS cellIS, PetscReal t, Pet
   /* user passed in the same matrix, avoid double contributions and
      only assemble the Jacobian */
   if (hasJac && Jac == JacP) hasPrec = PETSC_FALSE;
+  /* a matrix-free Jacobian, see DMPlexSNESCreateJacobianMF(), applies the pointwise Jacobian itself */
+  ierr = PetscObjectQueryFunction((PetscObject) Jac, "DMPlexSNESJacobianMFSetState_C", &setState);CHKERRQ(ierr);
+  if (setState && hasPrec) hasJac = PETSC_FALSE;
   ierr = PetscDSHasDynamicJacobian(prob, &hasDyn);CHKERRQ(ierr);
   hasDyn = hasDyn && (X_tShift != 0.0) ? PETSC_TRUE : PETSC_FALSE;
   ierr = PetscObjectQuery((PetscObject) dm, "dmAux", (PetscObject *) &dmAux);CHKERRQ(ierr);
@@ -5173,7 +5177,7 @@ PetscErrorCode DMPlexComputeJacobian_Internal(DM dm, IS cellIS, PetscReal t, Pet
     ierr = PetscQuadratureDestroy(&qGeom);CHKERRQ(ierr);
   }
   /*   Add contribution from X_t */
-  if (hasDyn) {for (c = 0; c < numCells*totDim*totDim; ++c) elemMat[c] += X_tShift*elemMatD[c];}
+  if (hasDyn && hasJac) {for (c = 0; c < numCells*totDim*totDim; ++c) elemMat[c] += X_tShift*elemMatD[c];}
   if (hasFV) {
     PetscClassId id;
     PetscFV      fv;
@@ -28,6 +28,7 @@ PetscErrorCode KSPSolve_BCGS(KSP ksp)
   PetscScalar    rho,rhoold,alpha,beta,omega,omegaold,d1;
   Vec            X,B,V,P,R,RP,T,S;
   PetscReal      dp    = 0.0,d2;
+  PetscBool      haverho;
   KSP_BCGS       *bcgs = (KSP_BCGS*)ksp->data;
 
   PetscFunctionBegin;
@@ -73,6 +74,7 @@ PetscErrorCode KSPSolve_BCGS(KSP ksp)
 
   /* Make the initial Rp == R */
   ierr = VecCopy(R,RP);CHKERRQ(ierr);
+  ierr = VecDot(R,RP,&rho);CHKERRQ(ierr);       /*   rho <- (r,rp)      */
 
   rhoold   = 1.0;
   alpha    = 1.0;
@@ -82,7 +84,6 @@ PetscErrorCode KSPSolve_BCGS(KSP ksp)
 
   i=0;
   do {
-    ierr = VecDot(R,RP,&rho);CHKERRQ(ierr);       /*   rho <- (r,rp)      */
     beta = (rho/rhoold) * (alpha/omegaold);
     ierr = VecAXPBYPCZ(P,1.0,-omegaold*beta,beta,R,V);CHKERRQ(ierr);  /* p <- r - omega * beta* v + beta * p */
     ierr = KSP_PCApplyBAorAB(ksp,P,V,T);CHKERRQ(ierr);  /*   v <- K p           */
@@ -120,14 +121,19 @@ PetscErrorCode KSPSolve_BCGS(KSP ksp)
     omega = d1 / d2;                               /*   w <- (t's) / (t't) */
     ierr  = VecAXPBYPCZ(X,alpha,omega,1.0,P,S);CHKERRQ(ierr); /* x <- alpha * p + omega * s + x */
     ierr  = VecWAXPY(R,-omega,T,S);CHKERRQ(ierr);     /*   r <- s - w t       */
-    if (ksp->normtype != KSP_NORM_NONE && ksp->chknorm < i+2) {
-      ierr = VecNorm(R,NORM_2,&dp);CHKERRQ(ierr);
-      KSPCheckNorm(ksp,dp);
-    }
 
     rhoold   = rho;
     omegaold = omega;
 
+    /* the residual norm and the rho of the next iteration share one reduction */
+    if (ksp->normtype != KSP_NORM_NONE && ksp->chknorm < i+2) {
+      ierr = VecDotNorm2(RP,R,&rho,&dp);CHKERRQ(ierr);  /*   rho <- (r,rp), dp <- (r,r) */
+      rho  = PetscConj(rho);
+      dp   = PetscSqrtReal(dp);
+      KSPCheckNorm(ksp,dp);
+      haverho = PETSC_TRUE;
+    } else haverho = PETSC_FALSE;
+
     ierr = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
     ksp->its++;
     ksp->rnorm = dp;
@@ -136,10 +142,13 @@ PetscErrorCode KSPSolve_BCGS(KSP ksp)
     ierr = KSPMonitor(ksp,i+1,dp);CHKERRQ(ierr);
     ierr = (*ksp->converged)(ksp,i+1,dp,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
     if (ksp->reason) break;
-    if (rho == 0.0) {
+    if (rhoold == 0.0) {
       ksp->reason = KSP_DIVERGED_BREAKDOWN;
       break;
     }
+    if (!haverho) {
+      ierr = VecDot(R,RP,&rho);CHKERRQ(ierr);         /*   rho <- (r,rp)      */
+    }
     i++;
   } while (i<ksp->max_it);
 
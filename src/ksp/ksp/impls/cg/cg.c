@@ -101,12 +101,14 @@ static PetscErrorCode KSPSolve_CG(KSP ksp)
   Vec            X,B,Z,R,P,W;
   KSP_CG         *cg;
   Mat            Amat,Pmat;
-  PetscBool      diagonalscale;
+  PetscBool      diagonalscale,havez,havebeta;
+  MPI_Comm       comm;
 
   PetscFunctionBegin;
   ierr = PCGetDiagonalScale(ksp->pc,&diagonalscale);CHKERRQ(ierr);
   if (diagonalscale) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_SUP,"Krylov method %s does not support diagonal scaling",((PetscObject)ksp)->type_name);
 
+  comm          = PetscObjectComm((PetscObject)ksp->vec_rhs);
   cg            = (KSP_CG*)ksp->data;
   eigs          = ksp->calc_sings;
   stored_max_it = ksp->max_it;
@@ -128,14 +130,36 @@ static PetscErrorCode KSPSolve_CG(KSP ksp)
     ierr = VecCopy(B,R);CHKERRQ(ierr);                         /*    r <- b (x is 0)                   */
   }
 
+  /*
+     The preconditioned norm and the inner product beta <- z'*r share one reduction; with KSPSetOverlapReductions()
+     the unpreconditioned norm is reduced while z <- Br is computed, which is wasted if the iteration converges
+  */
+  havez    = PETSC_FALSE;
+  havebeta = PETSC_FALSE;
   switch (ksp->normtype) {
     case KSP_NORM_PRECONDITIONED:
       ierr = KSP_PCApply(ksp,R,Z);CHKERRQ(ierr);               /*    z <- Br                           */
-      ierr = VecNorm(Z,NORM_2,&dp);CHKERRQ(ierr);              /*    dp <- z'*z = e'*A'*B'*B*A*e       */
+      if (cg->type == KSP_CG_HERMITIAN) {
+        ierr     = VecDotNorm2(R,Z,&beta,&dp);CHKERRQ(ierr);   /*    beta <- z'*r, dp <- z'*z          */
+        beta     = PetscConj(beta);
+        dp       = PetscSqrtReal(dp);                          /*    dp <- ||z|| = ||B*A*e||           */
+        havebeta = PETSC_TRUE;
+      } else {
+        ierr = VecNorm(Z,NORM_2,&dp);CHKERRQ(ierr);            /*    dp <- z'*z = e'*A'*B'*B*A*e       */
+      }
       KSPCheckNorm(ksp,dp);
+      havez = PETSC_TRUE;
       break;
     case KSP_NORM_UNPRECONDITIONED:
-      ierr = VecNorm(R,NORM_2,&dp);CHKERRQ(ierr);              /*    dp <- r'*r = e'*A'*A*e            */
+      if (ksp->overlapreductions) {
+        ierr  = VecNormBegin(R,NORM_2,&dp);CHKERRQ(ierr);      /*    dp <- r'*r = e'*A'*A*e            */
+        ierr  = PetscCommSplitReductionBegin(comm);CHKERRQ(ierr);
+        ierr  = KSP_PCApply(ksp,R,Z);CHKERRQ(ierr);            /*    z <- Br                           */
+        ierr  = VecNormEnd(R,NORM_2,&dp);CHKERRQ(ierr);
+        havez = PETSC_TRUE;
+      } else {
+        ierr = VecNorm(R,NORM_2,&dp);CHKERRQ(ierr);            /*    dp <- r'*r = e'*A'*A*e            */
+      }
       KSPCheckNorm(ksp,dp);
       break;
     case KSP_NORM_NATURAL:
@@ -143,6 +167,8 @@ static PetscErrorCode KSPSolve_CG(KSP ksp)
       ierr = VecXDot(Z,R,&beta);CHKERRQ(ierr);                 /*    beta <- z'*r                      */
       KSPCheckDot(ksp,beta);
       dp = PetscSqrtReal(PetscAbsScalar(beta));                /*    dp <- r'*z = r'*B*r = e'*A'*B*A*e */
+      havez    = PETSC_TRUE;
+      havebeta = PETSC_TRUE;
       break;
     case KSP_NORM_NONE:
       dp = 0.0;
@@ -156,13 +182,13 @@ static PetscErrorCode KSPSolve_CG(KSP ksp)
   ierr = (*ksp->converged)(ksp,0,dp,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);     /* test for convergence */
   if (ksp->reason) PetscFunctionReturn(0);
 
-  if (ksp->normtype != KSP_NORM_PRECONDITIONED && (ksp->normtype != KSP_NORM_NATURAL)) {
+  if (!havez) {
     ierr = KSP_PCApply(ksp,R,Z);CHKERRQ(ierr);                /*     z <- Br                           */
   }
-  if (ksp->normtype != KSP_NORM_NATURAL) {
+  if (!havebeta) {
     ierr = VecXDot(Z,R,&beta);CHKERRQ(ierr);                  /*     beta <- z'*r                      */
-    KSPCheckDot(ksp,beta);
   }
+  KSPCheckDot(ksp,beta);
 
   i = 0;
   do {
@@ -205,19 +231,44 @@ static PetscErrorCode KSPSolve_CG(KSP ksp)
     a = beta/dpi;                                              /*     a = beta/p'w                     */
     if (eigs) d[i] = PetscSqrtReal(PetscAbsScalar(b))*e[i] + 1.0/a;
     ierr = VecAXPY(X,a,P);CHKERRQ(ierr);                       /*     x <- x + ap                      */
-    ierr = VecAXPY(R,-a,W);CHKERRQ(ierr);                      /*     r <- r - aw                      */
+    havez    = PETSC_FALSE;
+    havebeta = PETSC_FALSE;
+    if (ksp->normtype == KSP_NORM_UNPRECONDITIONED && ksp->chknorm < i+2) {
+      if (ksp->overlapreductions) {
+        ierr  = VecAXPY(R,-a,W);CHKERRQ(ierr);                 /*     r <- r - aw                      */
+        ierr  = VecNormBegin(R,NORM_2,&dp);CHKERRQ(ierr);      /*     dp <- r'*r                       */
+        ierr  = PetscCommSplitReductionBegin(comm);CHKERRQ(ierr);
+        ierr  = KSP_PCApply(ksp,R,Z);CHKERRQ(ierr);            /*     z <- Br                          */
+        ierr  = VecNormEnd(R,NORM_2,&dp);CHKERRQ(ierr);
+        havez = PETSC_TRUE;
+      } else {
+        ierr = VecWAXPYNorm(R,-a,W,R,&dp);CHKERRQ(ierr);       /*     r <- r - aw, dp <- r'*r          */
+      }
+      KSPCheckNorm(ksp,dp);
+    } else {
+      ierr = VecAXPY(R,-a,W);CHKERRQ(ierr);                    /*     r <- r - aw                      */
+    }
     if (ksp->normtype == KSP_NORM_PRECONDITIONED && ksp->chknorm < i+2) {
       ierr = KSP_PCApply(ksp,R,Z);CHKERRQ(ierr);               /*     z <- Br                          */
-      ierr = VecNorm(Z,NORM_2,&dp);CHKERRQ(ierr);              /*     dp <- z'*z                       */
+      if (cg->type == KSP_CG_HERMITIAN) {
+        ierr     = VecDotNorm2(R,Z,&beta,&dp);CHKERRQ(ierr);   /*     beta <- z'*r, dp <- z'*z         */
+        beta     = PetscConj(beta);
+        dp       = PetscSqrtReal(dp);
+        havebeta = PETSC_TRUE;
+      } else {
+        ierr = VecNorm(Z,NORM_2,&dp);CHKERRQ(ierr);            /*     dp <- z'*z                       */
+      }
       KSPCheckNorm(ksp,dp);
+      havez = PETSC_TRUE;
     } else if (ksp->normtype == KSP_NORM_UNPRECONDITIONED && ksp->chknorm < i+2) {
-      ierr = VecNorm(R,NORM_2,&dp);CHKERRQ(ierr);              /*     dp <- r'*r                       */
-      KSPCheckNorm(ksp,dp);
+      /* dp computed with the update of r */
     } else if (ksp->normtype == KSP_NORM_NATURAL) {
       ierr = KSP_PCApply(ksp,R,Z);CHKERRQ(ierr);               /*     z <- Br                          */
       ierr = VecXDot(Z,R,&beta);CHKERRQ(ierr);                 /*     beta <- r'*z                     */
       KSPCheckDot(ksp,beta);
       dp = PetscSqrtReal(PetscAbsScalar(beta));
+      havez    = PETSC_TRUE;
+      havebeta = PETSC_TRUE;
     } else {
       dp = 0.0;
     }
@@ -228,12 +279,14 @@ static PetscErrorCode KSPSolve_CG(KSP ksp)
     ierr = (*ksp->converged)(ksp,i+1,dp,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
     if (ksp->reason) break;
 
-    if ((ksp->normtype != KSP_NORM_PRECONDITIONED && (ksp->normtype != KSP_NORM_NATURAL)) || (ksp->chknorm >= i+2)) {
+    if (!havez) {
       ierr = KSP_PCApply(ksp,R,Z);CHKERRQ(ierr);               /*     z <- Br                          */
     }
-    if ((ksp->normtype != KSP_NORM_NATURAL) || (ksp->chknorm >= i+2)) {
+    if (!havebeta) {
       ierr = VecXDot(Z,R,&beta);CHKERRQ(ierr);                 /*     beta <- z'*r                     */
       KSPCheckDot(ksp,beta);
+    } else if (ksp->normtype == KSP_NORM_PRECONDITIONED) {
+      KSPCheckDot(ksp,beta);                                   /*     beta computed with the norm of z */
     }
 
     i++;
@@ -564,6 +617,10 @@ PETSC_INTERN PetscErrorCode KSPBuildResidual_CG(KSP ksp,Vec t,Vec v,Vec *V)
    For complex numbers there are two different CG methods, one for Hermitian symmetric matrices and one for non-Hermitian symmetric matrices. Use
    KSPCGSetType() to indicate which type you are using.
 
+   KSPMatSolve() uses the block conjugate gradient method of O'Leary [3]: all the right-hand sides share one block Krylov space, each iteration
+   does one MatMatMult(), one PCMatApply() and two reductions for the whole block, and search directions which become linearly dependent are
+   dropped. A column has converged when its residual norm satisfies the tolerances relative to its initial residual norm.
+
    Developer Notes:
     KSPSolve_CG() should actually query the matrix to determine if it is Hermitian symmetric or not and NOT require the user to
    indicate it to the KSP object.
@@ -571,11 +628,12 @@ PETSC_INTERN PetscErrorCode KSPBuildResidual_CG(KSP ksp,Vec t,Vec v,Vec *V)
    References:
 +   1. - Magnus R. Hestenes and Eduard Stiefel, Methods of Conjugate Gradients for Solving Linear Systems,
    Journal of Research of the National Bureau of Standards Vol. 49, No. 6, December 1952 Research Paper 2379
--   2. - Josef Malek and Zdenek Strakos, Preconditioning and the Conjugate Gradient Method in the Context of Solving PDEs,
+.   2. - Josef Malek and Zdenek Strakos, Preconditioning and the Conjugate Gradient Method in the Context of Solving PDEs,
     SIAM, 2014.
+-   3. - Dianne P. O'Leary, The block conjugate gradient algorithm and related methods, Linear Algebra and its Applications 29, 1980.
 
 .seealso:  KSPCreate(), KSPSetType(), KSPType (for list of available types), KSP,
-           KSPCGSetType(), KSPCGUseSingleReduction(), KSPPIPECG, KSPGROPPCG
+           KSPCGSetType(), KSPCGUseSingleReduction(), KSPPIPECG, KSPGROPPCG, KSPMatSolve()
 
 M*/
 PETSC_EXTERN PetscErrorCode KSPCreate_CG(KSP ksp)
@@ -603,6 +661,7 @@ PETSC_EXTERN PetscErrorCode KSPCreate_CG(KSP ksp)
   */
   ksp->ops->setup          = KSPSetUp_CG;
   ksp->ops->solve          = KSPSolve_CG;
+  ksp->ops->matsolve       = KSPMatSolve_CG;
   ksp->ops->destroy        = KSPDestroy_CG;
   ksp->ops->view           = KSPView_CG;
   ksp->ops->setfromoptions = KSPSetFromOptions_CG;
@@ -21,6 +21,7 @@ PETSC_INTERN PetscErrorCode KSPReset_CG(KSP);
 PETSC_INTERN PetscErrorCode KSPView_CG(KSP,PetscViewer);
 PETSC_INTERN PetscErrorCode KSPSetFromOptions_CG(PetscOptionItems *PetscOptionsObject,KSP);
 PETSC_INTERN PetscErrorCode KSPCGSetType_CG(KSP,KSPCGType);
+PETSC_INTERN PetscErrorCode KSPMatSolve_CG(KSP,Mat,Mat);
 
 /*
     The field should remain the same since it is shared by the BiCG code
@@ -0,0 +1,302 @@
+
+/*
+    Block conjugate gradient used by KSPMatSolve() with KSPCG: all the right-hand sides of a MATDENSE
+    share one block Krylov space. Each iteration performs one sparse times dense product (MatMatMult()),
+    one PCMatApply(), dense BLAS3 updates of the local rows and two reductions for the whole block.
+*/
+#include <../src/ksp/ksp/impls/cg/cgimpl.h>       /*I "petscksp.h" I*/
+#include <petscblaslapack.h>
+
+/*
+   C <- alpha op(A) B + beta C with op(A) = A or A^H, the inner dimension k may be the (possibly zero) number of local rows
+*/
+static PetscErrorCode KSPCGBlockGemm_Private(const char *transa,PetscInt m,PetscInt n,PetscInt k,PetscScalar alpha,const PetscScalar *a,PetscInt lda,const PetscScalar *b,PetscInt ldb,PetscScalar beta,PetscScalar *c,PetscInt ldc)
+{
+  PetscBLASInt   bm,bn,bk,blda,bldb,bldc;
+  PetscInt       i,j;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!m || !n) PetscFunctionReturn(0);
+  if (!k) {
+    for (j=0; j<n; j++) for (i=0; i<m; i++) c[j*ldc+i] = beta == (PetscScalar)0.0 ? 0.0 : beta*c[j*ldc+i];
+    PetscFunctionReturn(0);
+  }
+  ierr = PetscBLASIntCast(m,&bm);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(n,&bn);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(k,&bk);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(lda,&blda);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(ldb,&bldb);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(ldc,&bldc);CHKERRQ(ierr);
+  PetscStackCallBLAS("BLASgemm",BLASgemm_(transa,"N",&bm,&bn,&bk,&alpha,a,&blda,b,&bldb,&beta,c,&bldc));
+  ierr = PetscLogFlops(2.0*m*n*k);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Upper Cholesky factor G = U^H U of the Gram matrix of the search directions, a column whose pivot is
+   not larger than tol times its diagonal entry is linearly dependent on the previous ones and is dropped.
+   On output g holds U and t its pseudo-inverse T, with zero rows and columns for the dropped directions.
+*/
+static PetscErrorCode KSPCGBlockCholeskyInvert_Private(PetscInt n,PetscScalar *g,PetscScalar *t,PetscBool *drop,PetscReal tol,PetscInt *nok)
+{
+  PetscInt    i,j,k;
+  PetscScalar s;
+  PetscReal   d;
+
+  PetscFunctionBegin;
+  *nok = 0;
+  for (i=0; i<n; i++) {
+    for (j=0; j<i; j++) {
+      if (drop[j]) {g[i*n+j] = 0.0; continue;}
+      s = g[i*n+j];
+      for (k=0; k<j; k++) s -= PetscConj(g[j*n+k])*g[i*n+k];
+      g[i*n+j] = s/g[j*n+j];
+    }
+    d = PetscRealPart(g[i*n+i]);
+    for (k=0; k<i; k++) d -= PetscRealPart(PetscConj(g[i*n+k])*g[i*n+k]);
+    drop[i] = (PetscBool)!(d > 0.0 && d > tol*PetscRealPart(g[i*n+i])); /* also catches NaN */
+    if (drop[i]) {
+      for (k=0; k<=i; k++) g[i*n+k] = 0.0;
+    } else {
+      g[i*n+i] = PetscSqrtReal(d);
+      (*nok)++;
+    }
+  }
+  /* back substitution, one column of T at a time */
+  for (j=0; j<n*n; j++) t[j] = 0.0;
+  for (j=0; j<n; j++) {
+    if (drop[j]) continue;
+    t[j*n+j] = 1.0/g[j*n+j];
+    for (i=j-1; i>=0; i--) {
+      if (drop[i]) continue;
+      s = 0.0;
+      for (k=i+1; k<=j; k++) s += g[k*n+i]*t[j*n+k];
+      t[j*n+i] = -s/g[i*n+i];
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   Local contributions to the residual norms of the columns, for the norm used in the convergence test
+*/
+static PetscErrorCode KSPCGBlockNorms_Private(KSP ksp,PetscInt m,PetscInt n,const PetscScalar *r,PetscInt ldr,const PetscScalar *z,PetscInt ldz,PetscScalar *nrm)
+{
+  PetscInt i,j;
+
+  PetscFunctionBegin;
+  for (j=0; j<n; j++) {
+    PetscReal sum = 0.0;
+
+    switch (ksp->normtype) {
+    case KSP_NORM_UNPRECONDITIONED:
+      for (i=0; i<m; i++) sum += PetscRealPart(PetscConj(r[j*ldr+i])*r[j*ldr+i]);
+      break;
+    case KSP_NORM_PRECONDITIONED:
+      for (i=0; i<m; i++) sum += PetscRealPart(PetscConj(z[j*ldz+i])*z[j*ldz+i]);
+      break;
+    case KSP_NORM_NATURAL:
+      for (i=0; i<m; i++) sum += PetscRealPart(PetscConj(z[j*ldz+i])*r[j*ldr+i]);
+      break;
+    default:
+      break;
+    }
+    nrm[j] = sum;
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   Checks the convergence of every column, the block has converged when all of them have. As for KSPSolve() with
+   a zero initial guess, the tolerances of a column are relative to its initial residual norm.
+*/
+static PetscErrorCode KSPCGBlockConverged_Private(KSP ksp,PetscInt n,const PetscScalar *nrm2,PetscReal *rnorm0,PetscReal *nrm)
+{
+  PetscInt       j,nconv = 0;
+  PetscReal      rmax = 0.0;
+  PetscBool      atol = PETSC_TRUE;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  for (j=0; j<n; j++) {
+    nrm[j] = ksp->normtype == KSP_NORM_NONE ? 0.0 : PetscSqrtReal(PetscAbsReal(PetscRealPart(nrm2[j])));
+    rmax   = PetscMax(rmax,nrm[j]);
+    if (PetscIsInfOrNanReal(nrm[j])) rmax = nrm[j];
+  }
+  if (!ksp->its) for (j=0; j<n; j++) rnorm0[j] = nrm[j];
+  ierr = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+  ksp->rnorm = rmax;
+  ierr = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+  ierr = KSPLogResidualHistory(ksp,rmax);CHKERRQ(ierr);
+  ierr = KSPMonitor(ksp,ksp->its,rmax);CHKERRQ(ierr);
+
+  ksp->reason = KSP_CONVERGED_ITERATING;
+  if (PetscIsInfOrNanReal(rmax)) {
+    ksp->reason = KSP_DIVERGED_NANORINF;
+    ierr = PetscInfo(ksp,"Block conjugate gradient has created a not a number (NaN) as a residual norm, declaring divergence\n");CHKERRQ(ierr);
+  } else if (ksp->normtype != KSP_NORM_NONE) {
+    for (j=0; j<n; j++) {
+      if (nrm[j] <= PetscMax(ksp->rtol*rnorm0[j],ksp->abstol)) {
+        nconv++;
+        if (!(nrm[j] < ksp->abstol)) atol = PETSC_FALSE;
+      } else if (ksp->its && nrm[j] >= ksp->divtol*rnorm0[j]) {
+        ksp->reason = KSP_DIVERGED_DTOL;
+        ierr = PetscInfo3(ksp,"Block conjugate gradient is diverging, column %D has residual norm %14.12e at iteration %D\n",j,(double)nrm[j],ksp->its);CHKERRQ(ierr);
+        break;
+      }
+    }
+    if (!ksp->reason && nconv == n) {
+      ksp->reason = atol ? KSP_CONVERGED_ATOL : KSP_CONVERGED_RTOL;
+      ierr = PetscInfo2(ksp,"Block conjugate gradient has converged, largest residual norm %14.12e at iteration %D\n",(double)rmax,ksp->its);CHKERRQ(ierr);
+    }
+  }
+  if (!ksp->reason && ksp->its >= ksp->max_it) {
+    ksp->reason = ksp->normtype == KSP_NORM_NONE ? KSP_CONVERGED_ITS : KSP_DIVERGED_ITS;
+    ierr = PetscInfo1(ksp,"Block conjugate gradient has reached the maximum number of iterations %D\n",ksp->its);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+     KSPMatSolve_CG - Block conjugate gradient of O'Leary for a block of right-hand sides.
+
+   The Gram matrix P^H A P of the search directions is factored with a pivoted Cholesky factorization so
+   that directions which become linearly dependent, e.g., once some of the right-hand sides have converged,
+   are dropped from the block instead of causing a breakdown. With T the pseudo-inverse of its factor,
+
+     X <- X + P T T^H P^H R        R <- R - A P T T^H P^H R
+     Z <- B R                      P <- Z - P T T^H (A P)^H Z
+*/
+PetscErrorCode KSPMatSolve_CG(KSP ksp,Mat B,Mat X)
+{
+  Mat               Amat,R,Z,P,W,Q = NULL;
+  const PetscScalar *cr,*cp,*z,*q;
+  PetscScalar       *x,*r,*p,*w,*lwork,*gwork,*G,*F,*E,*T,*C;
+  PetscReal         *rnorm0,*nrm;
+  PetscBool         diagonalscale,indefinite,*drop;
+  PetscInt          i,j,m,n,ldx,ldr,ldz,ldp,ldq,ldw,nok;
+  PetscMPIInt       len;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = PCGetDiagonalScale(ksp->pc,&diagonalscale);CHKERRQ(ierr);
+  if (diagonalscale) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_SUP,"Krylov method %s does not support diagonal scaling",((PetscObject)ksp)->type_name);
+#if defined(PETSC_USE_COMPLEX)
+  if (((KSP_CG*)ksp->data)->type == KSP_CG_SYMMETRIC) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_SUP,"Block conjugate gradient only for Hermitian matrices, see KSPCGSetType()");
+#endif
+  ierr = PCGetOperators(ksp->pc,&Amat,NULL);CHKERRQ(ierr);
+  ierr = MatGetLocalSize(B,&m,NULL);CHKERRQ(ierr);
+  ierr = MatGetSize(B,NULL,&n);CHKERRQ(ierr);
+  ierr = MatDuplicate(B,MAT_DO_NOT_COPY_VALUES,&R);CHKERRQ(ierr);
+  ierr = MatDuplicate(B,MAT_DO_NOT_COPY_VALUES,&Z);CHKERRQ(ierr);
+  ierr = MatDuplicate(B,MAT_DO_NOT_COPY_VALUES,&P);CHKERRQ(ierr);
+  ierr = MatDuplicate(B,MAT_DO_NOT_COPY_VALUES,&W);CHKERRQ(ierr);
+  ierr = PetscMalloc7(2*n*n+n,&lwork,2*n*n+n,&gwork,n*n,&T,n*n,&C,n,&rnorm0,n,&nrm,n,&drop);CHKERRQ(ierr);
+  ierr = PetscMPIIntCast(2*n*n+n,&len);CHKERRQ(ierr);
+  G = gwork; F = gwork+n*n; E = gwork;
+
+  ksp->its = 0;
+  if (!ksp->guess_zero) {
+    Mat AX;
+
+    ierr = MatMatMult(Amat,X,MAT_INITIAL_MATRIX,PETSC_DEFAULT,&AX);CHKERRQ(ierr);   /*   R <- B - A X   */
+    ierr = MatCopy(B,R,SAME_NONZERO_PATTERN);CHKERRQ(ierr);
+    ierr = MatAXPY(R,-1.0,AX,SAME_NONZERO_PATTERN);CHKERRQ(ierr);
+    ierr = MatDestroy(&AX);CHKERRQ(ierr);
+  } else {
+    ierr = MatCopy(B,R,SAME_NONZERO_PATTERN);CHKERRQ(ierr);                         /*   R <- B (X is 0) */
+  }
+  ierr = PCMatApply(ksp->pc,R,Z);CHKERRQ(ierr);                                     /*   Z <- B R        */
+  ierr = MatDenseGetLDA(R,&ldr);CHKERRQ(ierr);
+  ierr = MatDenseGetLDA(Z,&ldz);CHKERRQ(ierr);
+  ierr = MatDenseGetArrayRead(R,&cr);CHKERRQ(ierr);
+  ierr = MatDenseGetArrayRead(Z,&z);CHKERRQ(ierr);
+  ierr = KSPCGBlockNorms_Private(ksp,m,n,cr,ldr,z,ldz,lwork);CHKERRQ(ierr);
+  ierr = MatDenseRestoreArrayRead(Z,&z);CHKERRQ(ierr);
+  ierr = MatDenseRestoreArrayRead(R,&cr);CHKERRQ(ierr);
+  ierr = MPIU_Allreduce(lwork,gwork,len-2*n*n,MPIU_SCALAR,MPIU_SUM,PetscObjectComm((PetscObject)ksp));CHKERRQ(ierr);
+  ierr = KSPCGBlockConverged_Private(ksp,n,gwork,rnorm0,nrm);CHKERRQ(ierr);
+  ierr = MatCopy(Z,P,SAME_NONZERO_PATTERN);CHKERRQ(ierr);                           /*   P <- Z          */
+
+  while (!ksp->reason) {
+    ksp->its++;
+    ierr = MatMatMult(Amat,P,Q ? MAT_REUSE_MATRIX : MAT_INITIAL_MATRIX,PETSC_DEFAULT,&Q);CHKERRQ(ierr); /*   Q <- A P   */
+
+    /* G <- P^H Q, F <- P^H R with a single reduction */
+    ierr = MatDenseGetLDA(P,&ldp);CHKERRQ(ierr);
+    ierr = MatDenseGetLDA(Q,&ldq);CHKERRQ(ierr);
+    ierr = MatDenseGetArrayRead(P,&cp);CHKERRQ(ierr);
+    ierr = MatDenseGetArrayRead(Q,&q);CHKERRQ(ierr);
+    ierr = MatDenseGetArrayRead(R,&cr);CHKERRQ(ierr);
+    ierr = KSPCGBlockGemm_Private("C",n,n,m,1.0,cp,ldp,q,ldq,0.0,lwork,n);CHKERRQ(ierr);
+    ierr = KSPCGBlockGemm_Private("C",n,n,m,1.0,cp,ldp,cr,ldr,0.0,lwork+n*n,n);CHKERRQ(ierr);
+    ierr = MatDenseRestoreArrayRead(R,&cr);CHKERRQ(ierr);
+    ierr = MatDenseRestoreArrayRead(Q,&q);CHKERRQ(ierr);
+    ierr = MatDenseRestoreArrayRead(P,&cp);CHKERRQ(ierr);
+    ierr = MPIU_Allreduce(lwork,gwork,len-n,MPIU_SCALAR,MPIU_SUM,PetscObjectComm((PetscObject)ksp));CHKERRQ(ierr);
+
+    for (j=0,indefinite=PETSC_FALSE; j<n; j++) if (PetscRealPart(G[j*n+j]) < 0.0) indefinite = PETSC_TRUE;
+    ierr = KSPCGBlockCholeskyInvert_Private(n,G,T,drop,PETSC_SQRT_MACHINE_EPSILON,&nok);CHKERRQ(ierr);
+    if (!nok) {
+      if (ksp->errorifnotconverged) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_NOT_CONVERGED,"Block conjugate gradient breakdown, no search direction left");
+      ksp->reason = indefinite ? KSP_DIVERGED_INDEFINITE_MAT : KSP_DIVERGED_BREAKDOWN;
+      ierr = PetscInfo(ksp,"Block conjugate gradient breakdown, no search direction left\n");CHKERRQ(ierr);
+      break;
+    }
+    if (nok < n) {ierr = PetscInfo2(ksp,"Dropping %D linearly dependent search directions at iteration %D\n",n-nok,ksp->its);CHKERRQ(ierr);}
+
+    /* C <- T T^H F */
+    ierr = KSPCGBlockGemm_Private("C",n,n,n,1.0,T,n,F,n,0.0,lwork,n);CHKERRQ(ierr);
+    ierr = KSPCGBlockGemm_Private("N",n,n,n,1.0,T,n,lwork,n,0.0,C,n);CHKERRQ(ierr);
+
+    /* X <- X + P C, R <- R - Q C */
+    ierr = MatDenseGetLDA(X,&ldx);CHKERRQ(ierr);
+    ierr = MatDenseGetArrayRead(P,&cp);CHKERRQ(ierr);
+    ierr = MatDenseGetArrayRead(Q,&q);CHKERRQ(ierr);
+    ierr = MatDenseGetArray(X,&x);CHKERRQ(ierr);
+    ierr = MatDenseGetArray(R,&r);CHKERRQ(ierr);
+    ierr = KSPCGBlockGemm_Private("N",m,n,n,1.0,cp,ldp,C,n,1.0,x,ldx);CHKERRQ(ierr);
+    ierr = KSPCGBlockGemm_Private("N",m,n,n,-1.0,q,ldq,C,n,1.0,r,ldr);CHKERRQ(ierr);
+    ierr = MatDenseRestoreArray(R,&r);CHKERRQ(ierr);
+    ierr = MatDenseRestoreArray(X,&x);CHKERRQ(ierr);
+    ierr = MatDenseRestoreArrayRead(Q,&q);CHKERRQ(ierr);
+    ierr = MatDenseRestoreArrayRead(P,&cp);CHKERRQ(ierr);
+
+    ierr = PCMatApply(ksp->pc,R,Z);CHKERRQ(ierr);                                   /*   Z <- B R        */
+
+    /* E <- Q^H Z and the residual norms with a single reduction */
+    ierr = MatDenseGetArrayRead(Q,&q);CHKERRQ(ierr);
+    ierr = MatDenseGetArrayRead(R,&cr);CHKERRQ(ierr);
+    ierr = MatDenseGetArrayRead(Z,&z);CHKERRQ(ierr);
+    ierr = KSPCGBlockGemm_Private("C",n,n,m,1.0,q,ldq,z,ldz,0.0,lwork,n);CHKERRQ(ierr);
+    ierr = KSPCGBlockNorms_Private(ksp,m,n,cr,ldr,z,ldz,lwork+n*n);CHKERRQ(ierr);
+    ierr = MatDenseRestoreArrayRead(Z,&z);CHKERRQ(ierr);
+    ierr = MatDenseRestoreArrayRead(R,&cr);CHKERRQ(ierr);
+    ierr = MatDenseRestoreArrayRead(Q,&q);CHKERRQ(ierr);
+    ierr = MPIU_Allreduce(lwork,gwork,len-n*n,MPIU_SCALAR,MPIU_SUM,PetscObjectComm((PetscObject)ksp));CHKERRQ(ierr);
+    ierr = KSPCGBlockConverged_Private(ksp,n,gwork+n*n,rnorm0,nrm);CHKERRQ(ierr);
+    if (ksp->reason) break;
+
+    /* C <- -T T^H E, P <- Z + P C */
+    ierr = KSPCGBlockGemm_Private("C",n,n,n,1.0,T,n,E,n,0.0,lwork,n);CHKERRQ(ierr);
+    ierr = KSPCGBlockGemm_Private("N",n,n,n,-1.0,T,n,lwork,n,0.0,C,n);CHKERRQ(ierr);
+    ierr = MatDenseGetLDA(W,&ldw);CHKERRQ(ierr);
+    ierr = MatDenseGetArray(P,&p);CHKERRQ(ierr);
+    ierr = MatDenseGetArrayRead(Z,&z);CHKERRQ(ierr);
+    ierr = MatDenseGetArrayWrite(W,&w);CHKERRQ(ierr);
+    ierr = KSPCGBlockGemm_Private("N",m,n,n,1.0,p,ldp,C,n,0.0,w,ldw);CHKERRQ(ierr);
+    for (j=0; j<n; j++) for (i=0; i<m; i++) p[j*ldp+i] = z[j*ldz+i] + w[j*ldw+i];
+    ierr = MatDenseRestoreArrayWrite(W,&w);CHKERRQ(ierr);
+    ierr = MatDenseRestoreArrayRead(Z,&z);CHKERRQ(ierr);
+    ierr = MatDenseRestoreArray(P,&p);CHKERRQ(ierr);
+    ierr = PetscLogFlops(1.0*m*n);CHKERRQ(ierr);
+  }
+  ierr = PetscFree7(lwork,gwork,T,C,rnorm0,nrm,drop);CHKERRQ(ierr);
+  ierr = MatDestroy(&Q);CHKERRQ(ierr);
+  ierr = MatDestroy(&W);CHKERRQ(ierr);
+  ierr = MatDestroy(&P);CHKERRQ(ierr);
+  ierr = MatDestroy(&Z);CHKERRQ(ierr);
+  ierr = MatDestroy(&R);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
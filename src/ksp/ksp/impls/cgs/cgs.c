@@ -98,8 +98,7 @@ static PetscErrorCode  KSPSolve_CGS(KSP ksp)
     ierr = VecWAXPY(T,1.0,U,Q);CHKERRQ(ierr);      /* t <- u + q           */
     ierr = VecAXPY(X,a,T);CHKERRQ(ierr);           /* x <- x + a (u + q)   */
     ierr = KSP_PCApplyBAorAB(ksp,T,AUQ,U);CHKERRQ(ierr);
-    ierr = VecAXPY(R,-a,AUQ);CHKERRQ(ierr);       /* r <- r - a K (u + q) */
-    ierr = VecDot(R,RP,&rho);CHKERRQ(ierr);         /* rho <- (r,rp)        */
+    ierr = VecAXPYDot(R,-a,AUQ,RP,&rho);CHKERRQ(ierr); /* r <- r - a K (u + q), rho <- (r,rp) */
     KSPCheckDot(ksp,rho);
     if (ksp->normtype == KSP_NORM_NATURAL) {
       dp = PetscAbsScalar(rho);
@@ -32,19 +32,26 @@ PetscErrorCode  KSPGMRESModifiedGramSchmidtOrthogonalization(KSP ksp,PetscInt it
   PetscErrorCode ierr;
   PetscInt       j;
   PetscScalar    *hh,*hes;
+  PetscReal      nrm;
 
   PetscFunctionBegin;
   ierr = PetscLogEventBegin(KSP_GMRESOrthogonalization,ksp,0,0,0);CHKERRQ(ierr);
   /* update Hessenberg matrix and do Gram-Schmidt */
   hh  = HH(0,it);
   hes = HES(0,it);
+  /* (vv(it+1), vv(0)) */
+  ierr = VecDot(VEC_VV(it+1),VEC_VV(0),hh);CHKERRQ(ierr);
   for (j=0; j<=it; j++) {
-    /* (vv(it+1), vv(j)) */
-    ierr   = VecDot(VEC_VV(it+1),VEC_VV(j),hh);CHKERRQ(ierr);
     KSPCheckDot(ksp,*hh);
     *hes++ = *hh;
-    /* vv(it+1) <- vv(it+1) - hh[it+1][j] vv(j) */
-    ierr = VecAXPY(VEC_VV(it+1),-(*hh++),VEC_VV(j));CHKERRQ(ierr);
+    /* vv(it+1) <- vv(it+1) - hh[it+1][j] vv(j) fused with the next inner product (vv(it+1), vv(j+1)), or with the norm
+       of vv(it+1) that is cached for the normalization that follows */
+    if (j < it) {
+      ierr = VecAXPYDot(VEC_VV(it+1),-(*hh),VEC_VV(j),VEC_VV(j+1),hh+1);CHKERRQ(ierr);
+    } else {
+      ierr = VecWAXPYNorm(VEC_VV(it+1),-(*hh),VEC_VV(j),VEC_VV(it+1),&nrm);CHKERRQ(ierr);
+    }
+    hh++;
   }
   ierr = PetscLogEventEnd(KSP_GMRESOrthogonalization,ksp,0,0,0);CHKERRQ(ierr);
   PetscFunctionReturn(0);
@@ -7,6 +7,60 @@
     given for correct computation of inner products.
 */
 #include <../src/ksp/ksp/impls/gmres/gmresimpl.h>
+#include <petscblaslapack.h>
+
+/*
+    With KSPGMRESSetContiguousBasis() the direction vectors VEC_VV(0),...,VEC_VV(max_k+1) are the columns of
+    the local array V = gmres->vv_array, of leading dimension the local size n.
+
+    Computes lhh[j] = <VEC_VV(it+1),VEC_VV(j)> for j0 <= j < j0+nv, a block of V^H VEC_VV(it+1), with one gemv
+    and one reduction
+*/
+static PetscErrorCode KSPGMRESContiguousMDot_Private(KSP ksp,PetscInt it,PetscInt j0,PetscInt nv,PetscScalar *lhh)
+{
+  KSP_GMRES      *gmres = (KSP_GMRES*)(ksp->data);
+  PetscErrorCode ierr;
+  PetscInt       n,j;
+  PetscBLASInt   bn,bnv,ione = 1;
+  PetscScalar    one = 1.0,zero = 0.0;
+
+  PetscFunctionBegin;
+  ierr = VecGetLocalSize(VEC_VV(0),&n);CHKERRQ(ierr);
+  if (n) {
+    ierr = PetscBLASIntCast(n,&bn);CHKERRQ(ierr);
+    ierr = PetscBLASIntCast(nv,&bnv);CHKERRQ(ierr);
+    PetscStackCallBLAS("BLASgemv",BLASgemv_("C",&bn,&bnv,&one,gmres->vv_array+j0*n,&bn,gmres->vv_array+(it+1)*n,&ione,&zero,lhh+j0,&ione));
+  } else {
+    for (j=j0; j<j0+nv; j++) lhh[j] = 0.0;
+  }
+  ierr = MPIU_Allreduce(MPI_IN_PLACE,lhh+j0,nv,MPIU_SCALAR,MPIU_SUM,PetscObjectComm((PetscObject)ksp));CHKERRQ(ierr);
+  ierr = PetscLogFlops(2.0*n*nv);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+    Computes VEC_VV(it+1) += sum_{j<=it} lhh[j] VEC_VV(j) with one gemv
+*/
+static PetscErrorCode KSPGMRESContiguousMAXPY_Private(KSP ksp,PetscInt it,const PetscScalar *lhh)
+{
+  KSP_GMRES      *gmres = (KSP_GMRES*)(ksp->data);
+  PetscErrorCode ierr;
+  PetscInt       n;
+  PetscBLASInt   bn,bnv,ione = 1;
+  PetscScalar    one = 1.0,*w;
+
+  PetscFunctionBegin;
+  ierr = VecGetLocalSize(VEC_VV(it+1),&n);CHKERRQ(ierr);
+  ierr = VecGetArray(VEC_VV(it+1),&w);CHKERRQ(ierr);
+  if (n) {
+    ierr = PetscBLASIntCast(n,&bn);CHKERRQ(ierr);
+    ierr = PetscBLASIntCast(it+1,&bnv);CHKERRQ(ierr);
+    PetscStackCallBLAS("BLASgemv",BLASgemv_("N",&bn,&bnv,&one,gmres->vv_array,&bn,lhh,&ione,&one,w,&ione));
+  }
+  ierr = VecRestoreArray(VEC_VV(it+1),&w);CHKERRQ(ierr);
+  ierr = PetscLogFlops(2.0*n*(it+1));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
 
 /*@C
      KSPGMRESClassicalGramSchmidtOrthogonalization -  This is the basic orthogonalization routine
@@ -37,16 +91,17 @@ PetscErrorCode  KSPGMRESClassicalGramSchmidtOrthogonalization(KSP ksp,PetscInt i
   KSP_GMRES      *gmres = (KSP_GMRES*)(ksp->data);
   PetscErrorCode ierr;
   PetscInt       j;
-  PetscScalar    *hh,*hes,*lhh;
+  PetscScalar    *hh,*hes,*lhh,*lhh2;
   PetscReal      hnrm, wnrm;
   PetscBool      refine = (PetscBool)(gmres->cgstype == KSP_GMRES_CGS_REFINE_ALWAYS);
 
   PetscFunctionBegin;
   ierr = PetscLogEventBegin(KSP_GMRESOrthogonalization,ksp,0,0,0);CHKERRQ(ierr);
   if (!gmres->orthogwork) {
-    ierr = PetscMalloc1(gmres->max_k + 2,&gmres->orthogwork);CHKERRQ(ierr);
+    ierr = PetscMalloc1(2*(gmres->max_k + 2),&gmres->orthogwork);CHKERRQ(ierr);
   }
-  lhh = gmres->orthogwork;
+  lhh  = gmres->orthogwork;
+  lhh2 = gmres->orthogwork + gmres->max_k + 2;
 
   /* update Hessenberg matrix and do unmodified Gram-Schmidt */
   hh  = HH(0,it);
@@ -62,7 +117,11 @@ PetscErrorCode  KSPGMRESClassicalGramSchmidtOrthogonalization(KSP ksp,PetscInt i
      This is really a matrix-vector product, with the matrix stored
      as pointer to rows
   */
-  ierr = VecMDot(VEC_VV(it+1),it+1,&(VEC_VV(0)),lhh);CHKERRQ(ierr); /* <v,vnew> */
+  if (gmres->vv_contiguous) {
+    ierr = KSPGMRESContiguousMDot_Private(ksp,it,0,it+1,lhh);CHKERRQ(ierr); /* <v,vnew> */
+  } else {
+    ierr = VecMDot(VEC_VV(it+1),it+1,&(VEC_VV(0)),lhh);CHKERRQ(ierr); /* <v,vnew> */
+  }
   for (j=0; j<=it; j++) {
     KSPCheckDot(ksp,lhh[j]);
     lhh[j] = -lhh[j];
@@ -71,8 +130,33 @@ PetscErrorCode  KSPGMRESClassicalGramSchmidtOrthogonalization(KSP ksp,PetscInt i
   /*
          This is really a matrix vector product:
          [h[0],h[1],...]*[ v[0]; v[1]; ...] subtracted from v[it+1].
+
+     It is fused with the inner products of the second pass when that one is always done,
+     otherwise with the norm of v[it+1], which is kept for the normalization that follows.
+     With KSPSetOverlapReductions() the inner products of a second pass that is only done if needed
+     are computed in the same reduction as the norm that decides it, so refining costs no reduction.
+     With a contiguous basis the update is a gemv, and the inner products and the norm one more gemv
+     over the columns 0..it+1, whose last entry is <vnew,vnew>.
   */
-  ierr = VecMAXPY(VEC_VV(it+1),it+1,lhh,&VEC_VV(0));CHKERRQ(ierr);
+  if (gmres->vv_contiguous) {
+    ierr = KSPGMRESContiguousMAXPY_Private(ksp,it,lhh);CHKERRQ(ierr);
+    if (gmres->cgstype == KSP_GMRES_CGS_REFINE_ALWAYS) {
+      ierr = KSPGMRESContiguousMDot_Private(ksp,it,0,it+1,lhh2);CHKERRQ(ierr);
+    } else if (gmres->cgstype == KSP_GMRES_CGS_REFINE_IFNEEDED) {
+      if (ksp->overlapreductions) {
+        ierr = KSPGMRESContiguousMDot_Private(ksp,it,0,it+2,lhh2);CHKERRQ(ierr);
+      } else {
+        ierr = KSPGMRESContiguousMDot_Private(ksp,it,it+1,1,lhh2);CHKERRQ(ierr);
+      }
+      wnrm = PetscSqrtReal(PetscRealPart(lhh2[it+1]));
+    }
+  } else if (gmres->cgstype == KSP_GMRES_CGS_REFINE_ALWAYS) {
+    ierr = VecMAXPYMDot(VEC_VV(it+1),it+1,lhh,&VEC_VV(0),lhh2,NULL);CHKERRQ(ierr);
+  } else if (gmres->cgstype == KSP_GMRES_CGS_REFINE_IFNEEDED && ksp->overlapreductions) {
+    ierr = VecMAXPYMDot(VEC_VV(it+1),it+1,lhh,&VEC_VV(0),lhh2,&wnrm);CHKERRQ(ierr);
+  } else {
+    ierr = VecMAXPYMDot(VEC_VV(it+1),it+1,lhh,&VEC_VV(0),NULL,&wnrm);CHKERRQ(ierr);
+  }
   /* note lhh[j] is -<v,vnew> , hence the subtraction */
   for (j=0; j<=it; j++) {
     hh[j]  -= lhh[j];     /* hh += <v,vnew> */
@@ -88,7 +172,6 @@ PetscErrorCode  KSPGMRESClassicalGramSchmidtOrthogonalization(KSP ksp,PetscInt i
     for (j=0; j<=it; j++) hnrm +=  PetscRealPart(lhh[j] * PetscConj(lhh[j]));
 
     hnrm = PetscSqrtReal(hnrm);
-    ierr = VecNorm(VEC_VV(it+1),NORM_2, &wnrm);CHKERRQ(ierr);
     if (wnrm < hnrm) {
       refine = PETSC_TRUE;
       ierr   = PetscInfo2(ksp,"Performing iterative refinement wnorm %g hnorm %g\n",(double)wnrm,(double)hnrm);CHKERRQ(ierr);
@@ -96,13 +179,23 @@ PetscErrorCode  KSPGMRESClassicalGramSchmidtOrthogonalization(KSP ksp,PetscInt i
   }
 
   if (refine) {
-    ierr = VecMDot(VEC_VV(it+1),it+1,&(VEC_VV(0)),lhh);CHKERRQ(ierr); /* <v,vnew> */
-    for (j=0; j<=it; j++) lhh[j] = -lhh[j];
-    ierr = VecMAXPY(VEC_VV(it+1),it+1,lhh,&VEC_VV(0));CHKERRQ(ierr);
-    /* note lhh[j] is -<v,vnew> , hence the subtraction */
+    if (gmres->cgstype != KSP_GMRES_CGS_REFINE_ALWAYS && !ksp->overlapreductions) {
+      if (gmres->vv_contiguous) {
+        ierr = KSPGMRESContiguousMDot_Private(ksp,it,0,it+1,lhh2);CHKERRQ(ierr); /* <v,vnew> */
+      } else {
+        ierr = VecMDot(VEC_VV(it+1),it+1,&(VEC_VV(0)),lhh2);CHKERRQ(ierr); /* <v,vnew> */
+      }
+    }
+    for (j=0; j<=it; j++) lhh2[j] = -lhh2[j];
+    if (gmres->vv_contiguous) {
+      ierr = KSPGMRESContiguousMAXPY_Private(ksp,it,lhh2);CHKERRQ(ierr);
+    } else {
+      ierr = VecMAXPYMDot(VEC_VV(it+1),it+1,lhh2,&VEC_VV(0),NULL,&wnrm);CHKERRQ(ierr);
+    }
+    /* note lhh2[j] is -<v,vnew> , hence the subtraction */
     for (j=0; j<=it; j++) {
-      hh[j]  -= lhh[j];     /* hh += <v,vnew> */
-      hes[j] -= lhh[j];     /* hes += <v,vnew> */
+      hh[j]  -= lhh2[j];     /* hh += <v,vnew> */
+      hes[j] -= lhh2[j];     /* hes += <v,vnew> */
     }
   }
   ierr = PetscLogEventEnd(KSP_GMRESOrthogonalization,ksp,0,0,0);CHKERRQ(ierr);
@@ -0,0 +1,834 @@
+/*
+    This file implements GCRO-DR, GMRES with deflated restarting and Krylov subspace recycling.
+
+    The solver keeps a recycle space U of dimension k whose image by the preconditioned operator B,
+    C = B U, has orthonormal columns. Each restart cycle first minimizes the residual over range(U),
+       x <- x + U C^H r,  r <- r - C C^H r,
+    then runs m - k steps of Arnoldi with the projected operator (I - C C^H) B,
+       B V_j = C BK + V_{j+1} Hbar,
+    and minimizes the residual over range([U V_j]). At the end of each cycle U is replaced by the k harmonic
+    Ritz vectors of B in range([U V_j]) with the harmonic Ritz values of smallest magnitude, which only needs
+    small dense computations.
+
+    The recycle space is kept from one KSPSolve() to the next. When the operator (or the preconditioner) has
+    changed, C is recomputed from U and orthonormalized again, so a sequence of related systems, for example the
+    linear systems of a Newton iteration or of a time integrator, keeps the approximate invariant subspace of the
+    slowest modes instead of rebuilding it at every solve.
+*/
+
+#include <../src/ksp/ksp/impls/gmres/gcrodr/gcrodrimpl.h>       /*I  "petscksp.h"  I*/
+#include <petscblaslapack.h>
+
+#define GCRODR_DELTA_DIRECTIONS 10
+#define GCRODR_DEFAULT_MAXK     30
+#define GCRODR_DEFAULT_K        10
+
+static PetscBool  cited = PETSC_FALSE;
+static const char citation[] =
+  "@article{Parks2006,\n"
+  "  author  = {Michael L. Parks and Eric de Sturler and Greg Mackey and Duane D. Johnson and Spandan Maiti},\n"
+  "  title   = {Recycling {K}rylov subspaces for sequences of linear systems},\n"
+  "  journal = {SIAM Journal on Scientific Computing},\n"
+  "  volume  = {28},\n"
+  "  number  = {5},\n"
+  "  pages   = {1651--1674},\n"
+  "  year    = {2006}\n"
+  "}\n";
+
+static PetscErrorCode KSPSetUp_GCRODR(KSP ksp)
+{
+  KSP_GCRODR     *gcrodr = (KSP_GCRODR*)ksp->data;
+  PetscInt       max_k = gcrodr->max_k,k = gcrodr->k,N = max_k + 1,lwork = 5*max_k,nv = max_k + k + 2;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (k >= max_k) SETERRQ2(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_OUTOFRANGE,"The recycle size %D must be smaller than the restart %D",k,max_k);
+  ierr = KSPSetUp_GMRES(ksp);CHKERRQ(ierr);
+
+  /* the recycle space is kept as long as the size of the vectors does not change, see KSPReset() */
+  if (!gcrodr->U) {
+    ierr = KSPCreateVecs(ksp,k,&gcrodr->U,k,&gcrodr->C);CHKERRQ(ierr);
+    ierr = KSPCreateVecs(ksp,k,&gcrodr->Unew,k,&gcrodr->Cnew);CHKERRQ(ierr);
+    ierr = PetscLogObjectParents(ksp,k,gcrodr->U);CHKERRQ(ierr);
+    ierr = PetscLogObjectParents(ksp,k,gcrodr->C);CHKERRQ(ierr);
+    ierr = PetscLogObjectParents(ksp,k,gcrodr->Unew);CHKERRQ(ierr);
+    ierr = PetscLogObjectParents(ksp,k,gcrodr->Cnew);CHKERRQ(ierr);
+    gcrodr->nr = 0;
+  }
+
+  ierr = PetscFree(gcrodr->vlist);CHKERRQ(ierr);
+  ierr = PetscFree6(gcrodr->gmat,gcrodr->wmat,gcrodr->amat,gcrodr->bmat,gcrodr->evec,gcrodr->pmat);CHKERRQ(ierr);
+  ierr = PetscFree6(gcrodr->qmat,gcrodr->rmat,gcrodr->eig,gcrodr->tau,gcrodr->work,gcrodr->bk);CHKERRQ(ierr);
+  ierr = PetscFree5(gcrodr->eigi,gcrodr->rwork,gcrodr->modul,gcrodr->perm,gcrodr->ccoef);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nv,&gcrodr->vlist);CHKERRQ(ierr);
+  ierr = PetscMalloc6(N*max_k,&gcrodr->gmat,N*max_k,&gcrodr->wmat,max_k*max_k,&gcrodr->amat,max_k*max_k,&gcrodr->bmat,max_k*max_k,&gcrodr->evec,max_k*k,&gcrodr->pmat);CHKERRQ(ierr);
+  ierr = PetscMalloc6(N*k,&gcrodr->qmat,k*k,&gcrodr->rmat,max_k,&gcrodr->eig,k,&gcrodr->tau,lwork,&gcrodr->work,k*max_k,&gcrodr->bk);CHKERRQ(ierr);
+  ierr = PetscMalloc5(max_k,&gcrodr->eigi,2*max_k,&gcrodr->rwork,max_k,&gcrodr->modul,max_k,&gcrodr->perm,nv,&gcrodr->ccoef);CHKERRQ(ierr);
+  ierr = PetscLogObjectMemory((PetscObject)ksp,nv*sizeof(Vec)+(2*N*max_k+3*max_k*max_k+max_k*k+N*k+k*k+max_k+k+lwork+k*max_k+nv)*sizeof(PetscScalar)+4*max_k*sizeof(PetscReal)+max_k*sizeof(PetscInt));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Orthonormalizes C by classical Gram-Schmidt with reorthogonalization and applies the same transformation to U,
+   so that C = B U still holds. Columns that are numerically dependent on the previous ones are dropped.
+*/
+static PetscErrorCode KSPGCRODROrthonormalizeRecycle(KSP ksp)
+{
+  KSP_GCRODR     *gcrodr = (KSP_GCRODR*)ksp->data;
+  PetscScalar    *c = gcrodr->ccoef;
+  PetscReal      nrm;
+  PetscInt       i,l,pass;
+  Vec            t;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  for (i=0; i<gcrodr->nr;) {
+    /* normalize first so that the dependency test is relative to the norm of the image */
+    ierr = VecNormalize(gcrodr->C[i],&nrm);CHKERRQ(ierr);
+    if (nrm > 0.0) {
+      ierr = VecScale(gcrodr->U[i],1.0/nrm);CHKERRQ(ierr);
+      nrm  = 1.0;
+      for (pass=0; pass<2 && i; pass++) {
+        ierr = VecMDot(gcrodr->C[i],i,gcrodr->C,c);CHKERRQ(ierr);
+        for (l=0; l<i; l++) c[l] = -c[l];
+        ierr = VecMAXPY(gcrodr->C[i],i,c,gcrodr->C);CHKERRQ(ierr);
+        ierr = VecMAXPY(gcrodr->U[i],i,c,gcrodr->U);CHKERRQ(ierr);
+      }
+      if (i) {ierr = VecNorm(gcrodr->C[i],NORM_2,&nrm);CHKERRQ(ierr);}
+    }
+    if (nrm > PETSC_SQRT_MACHINE_EPSILON) {
+      if (i) {
+        ierr = VecScale(gcrodr->C[i],1.0/nrm);CHKERRQ(ierr);
+        ierr = VecScale(gcrodr->U[i],1.0/nrm);CHKERRQ(ierr);
+      }
+      i++;
+    } else {
+      ierr = PetscInfo1(ksp,"Dropping the recycle vector %D, its image is numerically dependent on the previous ones\n",i);CHKERRQ(ierr);
+      gcrodr->nr--;
+      t = gcrodr->C[i]; gcrodr->C[i] = gcrodr->C[gcrodr->nr]; gcrodr->C[gcrodr->nr] = t;
+      t = gcrodr->U[i]; gcrodr->U[i] = gcrodr->U[gcrodr->nr]; gcrodr->U[gcrodr->nr] = t;
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   Recomputes C = B U when the operators, or the solve between KSPSolve() and KSPSolveTranspose(), have changed since C was computed
+*/
+static PetscErrorCode KSPGCRODRUpdateImage(KSP ksp)
+{
+  KSP_GCRODR       *gcrodr = (KSP_GCRODR*)ksp->data;
+  Mat              Amat,Pmat;
+  PetscObjectId    aid,pid;
+  PetscObjectState astate,pstate;
+  PetscInt         i;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  ierr = PCGetOperators(ksp->pc,&Amat,&Pmat);CHKERRQ(ierr);
+  ierr = PetscObjectGetId((PetscObject)Amat,&aid);CHKERRQ(ierr);
+  ierr = PetscObjectStateGet((PetscObject)Amat,&astate);CHKERRQ(ierr);
+  ierr = PetscObjectGetId((PetscObject)Pmat,&pid);CHKERRQ(ierr);
+  ierr = PetscObjectStateGet((PetscObject)Pmat,&pstate);CHKERRQ(ierr);
+  if (gcrodr->nr && (aid != gcrodr->matid || astate != gcrodr->matstate || pid != gcrodr->pmatid || pstate != gcrodr->pmatstate || ksp->transpose_solve != gcrodr->transpose)) {
+    ierr = PetscInfo1(ksp,"Operators or transposition have changed, recomputing the image of the %D recycle vectors\n",gcrodr->nr);CHKERRQ(ierr);
+    for (i=0; i<gcrodr->nr; i++) {
+      ierr = KSP_PCApplyBAorAB(ksp,gcrodr->U[i],gcrodr->C[i],VEC_TEMP_MATOP);CHKERRQ(ierr);
+    }
+    ierr = KSPGCRODROrthonormalizeRecycle(ksp);CHKERRQ(ierr);
+  }
+  gcrodr->matid     = aid;
+  gcrodr->matstate  = astate;
+  gcrodr->pmatid    = pid;
+  gcrodr->pmatstate = pstate;
+  gcrodr->transpose = ksp->transpose_solve;
+  PetscFunctionReturn(0);
+}
+
+/*
+   Minimizes the residual in VEC_VV(0) over range(U): x <- x + U C^H r and r <- r - C C^H r
+*/
+static PetscErrorCode KSPGCRODRProjectResidual(KSP ksp)
+{
+  KSP_GCRODR     *gcrodr = (KSP_GCRODR*)ksp->data;
+  PetscScalar    *c = gcrodr->ccoef;
+  PetscInt       i,nr = gcrodr->nr;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!nr) PetscFunctionReturn(0);
+  ierr = VecMDot(VEC_VV(0),nr,gcrodr->C,c);CHKERRQ(ierr);
+  ierr = VecSet(VEC_TEMP,0.0);CHKERRQ(ierr);
+  ierr = VecMAXPY(VEC_TEMP,nr,c,gcrodr->U);CHKERRQ(ierr);
+  for (i=0; i<nr; i++) c[i] = -c[i];
+  ierr = VecMAXPY(VEC_VV(0),nr,c,gcrodr->C);CHKERRQ(ierr);
+  ierr = KSPUnwindPreconditioner(ksp,VEC_TEMP,VEC_TEMP_MATOP);CHKERRQ(ierr);
+  ierr = VecAXPY(ksp->vec_sol,1.0,VEC_TEMP);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Applies the plane rotations to the column it of the Hessenberg matrix and returns the new residual norm,
+   identical to the KSPGMRES version
+*/
+static PetscErrorCode KSPGCRODRUpdateHessenberg(KSP ksp,PetscInt it,PetscBool hapend,PetscReal *res)
+{
+  KSP_GCRODR  *gcrodr = (KSP_GCRODR*)(ksp->data);
+  PetscScalar *hh,*cc,*ss,tt;
+  PetscInt    j;
+
+  PetscFunctionBegin;
+  hh = HH(0,it);
+  cc = CC(0);
+  ss = SS(0);
+
+  /* Apply all the previously computed plane rotations to the new column of the Hessenberg matrix */
+  for (j=1; j<=it; j++) {
+    tt  = *hh;
+    *hh = PetscConj(*cc) * tt + *ss * *(hh+1);
+    hh++;
+    *hh = *cc++ * *hh - (*ss++ * tt);
+  }
+
+  if (!hapend) {
+    tt = PetscSqrtScalar(PetscConj(*hh) * *hh + PetscConj(*(hh+1)) * *(hh+1));
+    if (tt == 0.0) {
+      if (ksp->errorifnotconverged) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_NOT_CONVERGED,"tt == 0.0");
+      else {
+        ksp->reason = KSP_DIVERGED_NULL;
+        PetscFunctionReturn(0);
+      }
+    }
+    *cc        = *hh / tt;
+    *ss        = *(hh+1) / tt;
+    *GRS(it+1) = -(*ss * *GRS(it));
+    *GRS(it)   = PetscConj(*cc) * *GRS(it);
+    *hh        = PetscConj(*cc) * *hh + *ss * *(hh+1);
+    *res       = PetscAbsScalar(*GRS(it+1));
+  } else *res = 0.0;
+  PetscFunctionReturn(0);
+}
+
+/*
+   Builds the solution from the least squares solution y of the cycle: vdest = vs + V y - U BK y
+*/
+static PetscErrorCode KSPGCRODRBuildSoln(PetscScalar *nrs,Vec vs,Vec vdest,KSP ksp,PetscInt it)
+{
+  KSP_GCRODR     *gcrodr = (KSP_GCRODR*)(ksp->data);
+  PetscScalar    tt,*coef = gcrodr->ccoef;
+  PetscInt       ii,k,j,i,nr = gcrodr->nr;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  /* If it is < 0, no steps have been performed */
+  if (it < 0) {
+    ierr = VecCopy(vs,vdest);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  if (*HH(it,it) != 0.0) {
+    nrs[it] = *GRS(it) / *HH(it,it);
+  } else {
+    if (ksp->errorifnotconverged) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_NOT_CONVERGED,"You reached the break down in GCRODR; HH(it,it) = 0");
+    else ksp->reason = KSP_DIVERGED_BREAKDOWN;
+
+    ierr = PetscInfo2(ksp,"Likely your matrix or preconditioner is singular. HH(it,it) is identically zero; it = %D GRS(it) = %g\n",it,(double)PetscAbsScalar(*GRS(it)));CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  for (ii=1; ii<=it; ii++) {
+    k  = it - ii;
+    tt = *GRS(k);
+    for (j=k+1; j<=it; j++) tt = tt - *HH(k,j) * nrs[j];
+    if (*HH(k,k) == 0.0) {
+      if (ksp->errorifnotconverged) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_NOT_CONVERGED,"Likely your matrix or preconditioner is singular. HH(k,k) is identically zero; k = %D\n",k);
+      else {
+        ksp->reason = KSP_DIVERGED_BREAKDOWN;
+        ierr = PetscInfo1(ksp,"Likely your matrix or preconditioner is singular. HH(k,k) is identically zero; k = %D\n",k);CHKERRQ(ierr);
+        PetscFunctionReturn(0);
+      }
+    }
+    nrs[k] = tt / *HH(k,k);
+  }
+
+  /* Accumulate the correction to the solution of the preconditioned problem in TEMP with one VecMAXPY() over [V U] */
+  for (j=0; j<=it; j++) {
+    coef[j]         = nrs[j];
+    gcrodr->vlist[j] = VEC_VV(j);
+  }
+  for (i=0; i<nr; i++) {
+    for (tt=0.0,j=0; j<=it; j++) tt += BK(i,j)*nrs[j];
+    coef[it+1+i]          = -tt;
+    gcrodr->vlist[it+1+i] = gcrodr->U[i];
+  }
+  ierr = VecSet(VEC_TEMP,0.0);CHKERRQ(ierr);
+  ierr = VecMAXPY(VEC_TEMP,it+1+nr,coef,gcrodr->vlist);CHKERRQ(ierr);
+
+  ierr = KSPUnwindPreconditioner(ksp,VEC_TEMP,VEC_TEMP_MATOP);CHKERRQ(ierr);
+  /* add solution to previous solution */
+  if (vdest != vs) {
+    ierr = VecCopy(vs,vdest);CHKERRQ(ierr);
+  }
+  ierr = VecAXPY(vdest,1.0,VEC_TEMP);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Replaces the recycle space by the harmonic Ritz vectors of B in range([U V_j]) whose harmonic Ritz values have the
+   smallest magnitude, after a cycle of j steps. With W = [U D, V_j] and What = [C, V_{j+1}], D scaling the columns of U
+   to unit norm, B W = What G with
+
+       G = [ D   BK   ]      and   What^H W = [ C^H U D     0    ]
+           [ 0   Hbar ]                     [ V^H U D  [I; 0]  ]
+
+   The harmonic Ritz pairs solve G^H G z = theta G^H What^H W z. With the Cholesky factorization G^H G = L L^H, this is
+   the standard problem L^{-1} G^H What^H W L^{-H} w = (1/theta) w, z = L^{-H} w. With P the selected vectors z and
+   G P = Q R, the new recycle space is U = W P R^{-1} and its image C = What Q.
+*/
+static PetscErrorCode KSPGCRODRUpdateRecycle(KSP ksp,PetscInt j)
+{
+#if defined(PETSC_HAVE_ESSL)
+  PetscFunctionBegin;
+  SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_SUP,"GEEV - ESSL has a different calling sequence than LAPACK");
+#else
+  KSP_GCRODR     *gcrodr = (KSP_GCRODR*)ksp->data;
+  PetscInt       p = gcrodr->nr,s = p + j,t = s + 1,kk = PetscMin(gcrodr->k,s),nsel,i,l,m,e,col;
+  PetscInt       ldg = gcrodr->max_k + 1,lda = gcrodr->max_k,ldr = gcrodr->k;
+  PetscScalar    *g = gcrodr->gmat,*w = gcrodr->wmat,*a = gcrodr->amat,*b = gcrodr->bmat,*pm = gcrodr->pmat,*q = gcrodr->qmat,*r = gcrodr->rmat;
+  PetscScalar    *c = gcrodr->ccoef,sdummy = 0.0,one = 1.0,zero = 0.0;
+  PetscReal      *d = gcrodr->modul,rmax;
+  PetscBLASInt   bs,bt,bsel,blda,bldg,bldr,lwork,idummy = 1,info;
+  Vec            *vt;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscBLASIntCast(s,&bs);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(t,&bt);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(lda,&blda);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(ldg,&bldg);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(ldr,&bldr);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(5*gcrodr->max_k,&lwork);CHKERRQ(ierr);
+
+  /* G and What^H W */
+  ierr = PetscArrayzero(g,ldg*s);CHKERRQ(ierr);
+  ierr = PetscArrayzero(w,ldg*s);CHKERRQ(ierr);
+  for (i=0; i<p; i++) gcrodr->vlist[i] = gcrodr->C[i];
+  for (m=0; m<=j; m++) gcrodr->vlist[p+m] = VEC_VV(m);
+  for (i=0; i<p; i++) {
+    /* C^H U_i, V^H U_i and U_i^H U_i with a single reduction */
+    gcrodr->vlist[t] = gcrodr->U[i];
+    ierr = VecMDot(gcrodr->U[i],t+1,gcrodr->vlist,c);CHKERRQ(ierr);
+    d[i] = PetscRealPart(c[t]) > 0.0 ? 1.0/PetscSqrtReal(PetscRealPart(c[t])) : 1.0;
+    for (l=0; l<t; l++) w[i*ldg+l] = c[l]*d[i];
+    g[i*ldg+i] = d[i];
+  }
+  for (m=0; m<j; m++) {
+    for (i=0; i<p; i++) g[(p+m)*ldg+i] = BK(i,m);
+    for (l=0; l<=m+1; l++) g[(p+m)*ldg+p+l] = *HES(l,m);
+    w[(p+m)*ldg+p+m] = 1.0;
+  }
+
+  /* A = G^H G = L L^H and B = L^{-1} G^H What^H W L^{-H} */
+  PetscStackCallBLAS("BLASgemm",BLASgemm_("C","N",&bs,&bs,&bt,&one,g,&bldg,g,&bldg,&zero,a,&blda));
+  PetscStackCallBLAS("BLASgemm",BLASgemm_("C","N",&bs,&bs,&bt,&one,g,&bldg,w,&bldg,&zero,b,&blda));
+  ierr = PetscFPTrapPush(PETSC_FP_TRAP_OFF);CHKERRQ(ierr);
+  PetscStackCallBLAS("LAPACKpotrf",LAPACKpotrf_("L",&bs,a,&blda,&info));
+  ierr = PetscFPTrapPop();CHKERRQ(ierr);
+  if (info) {
+    ierr = PetscInfo1(ksp,"Keeping the recycle space, G^H G is not numerically positive definite, potrf info %d\n",(int)info);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  PetscStackCallBLAS("BLAStrsm",BLAStrsm_("L","L","N","N",&bs,&bs,&one,a,&blda,b,&blda));
+  PetscStackCallBLAS("BLAStrsm",BLAStrsm_("R","L","C","N",&bs,&bs,&one,a,&blda,b,&blda));
+
+  /* eigenvectors of largest 1/theta */
+  ierr = PetscFPTrapPush(PETSC_FP_TRAP_OFF);CHKERRQ(ierr);
+#if defined(PETSC_USE_COMPLEX)
+  PetscStackCallBLAS("LAPACKgeev",LAPACKgeev_("N","V",&bs,b,&blda,gcrodr->eig,&sdummy,&idummy,gcrodr->evec,&blda,gcrodr->work,&lwork,gcrodr->rwork,&info));
+#else
+  PetscStackCallBLAS("LAPACKgeev",LAPACKgeev_("N","V",&bs,b,&blda,gcrodr->eig,gcrodr->eigi,&sdummy,&idummy,gcrodr->evec,&blda,gcrodr->work,&lwork,&info));
+#endif
+  ierr = PetscFPTrapPop();CHKERRQ(ierr);
+  if (info) {
+    ierr = PetscInfo1(ksp,"Keeping the recycle space, geev info %d\n",(int)info);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  for (i=0; i<s; i++) {
+#if defined(PETSC_USE_COMPLEX)
+    gcrodr->rwork[i] = PetscAbsScalar(gcrodr->eig[i]);
+#else
+    gcrodr->rwork[i] = PetscSqrtReal(gcrodr->eig[i]*gcrodr->eig[i] + gcrodr->eigi[i]*gcrodr->eigi[i]);
+#endif
+    gcrodr->perm[i] = i;
+  }
+  ierr = PetscSortRealWithPermutation(s,gcrodr->rwork,gcrodr->perm);CHKERRQ(ierr);
+  for (nsel=0,i=s-1; i>=0 && nsel<kk; i--) {
+    e = gcrodr->perm[i];
+    if (gcrodr->rwork[e] < 0.0) continue; /* already selected as part of a complex conjugate pair */
+#if !defined(PETSC_USE_COMPLEX)
+    /* the real and imaginary parts of a complex eigenvector are stored in two consecutive columns */
+    if (gcrodr->eigi[e] != 0.0) {
+      col = gcrodr->eigi[e] > 0.0 ? e : e-1;
+      gcrodr->rwork[col] = gcrodr->rwork[col+1] = -1.0;
+      if (nsel + 2 > kk) continue;
+      ierr = PetscArraycpy(pm+nsel*lda,gcrodr->evec+col*lda,s);CHKERRQ(ierr);
+      ierr = PetscArraycpy(pm+(nsel+1)*lda,gcrodr->evec+(col+1)*lda,s);CHKERRQ(ierr);
+      nsel += 2;
+      continue;
+    }
+#endif
+    col = e;
+    ierr = PetscArraycpy(pm+nsel*lda,gcrodr->evec+col*lda,s);CHKERRQ(ierr);
+    nsel++;
+  }
+  if (!nsel) PetscFunctionReturn(0);
+  ierr = PetscBLASIntCast(nsel,&bsel);CHKERRQ(ierr);
+
+  /* P = L^{-H} P and G P = Q R */
+  PetscStackCallBLAS("BLAStrsm",BLAStrsm_("L","L","C","N",&bs,&bsel,&one,a,&blda,pm,&blda));
+  PetscStackCallBLAS("BLASgemm",BLASgemm_("N","N",&bt,&bsel,&bs,&one,g,&bldg,pm,&blda,&zero,q,&bldg));
+  PetscStackCallBLAS("LAPACKgeqrf",LAPACKgeqrf_(&bt,&bsel,q,&bldg,gcrodr->tau,gcrodr->work,&lwork,&info));
+  if (info) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in LAPACK routine geqrf %d",(int)info);
+  ierr = PetscArrayzero(r,ldr*nsel);CHKERRQ(ierr);
+  for (l=0,rmax=0.0; l<nsel; l++) {
+    for (i=0; i<=l; i++) r[l*ldr+i] = q[l*ldg+i];
+    rmax = PetscMax(rmax,PetscAbsScalar(r[l*ldr+l]));
+  }
+  for (l=0; l<nsel; l++) if (PetscAbsScalar(r[l*ldr+l]) <= PETSC_SQRT_MACHINE_EPSILON*rmax) break;
+  if (l < nsel) {
+    ierr = PetscInfo2(ksp,"Only %D of the %D harmonic Ritz vectors are linearly independent\n",l,nsel);CHKERRQ(ierr);
+    nsel = l;
+    ierr = PetscBLASIntCast(nsel,&bsel);CHKERRQ(ierr);
+  }
+  if (!nsel) PetscFunctionReturn(0);
+  PetscStackCallBLAS("LAPACKorgqr",LAPACKorgqr_(&bt,&bsel,&bsel,q,&bldg,gcrodr->tau,gcrodr->work,&lwork,&info));
+  if (info) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_LIB,"Error in LAPACK routine orgqr %d",(int)info);
+  PetscStackCallBLAS("BLAStrsm",BLAStrsm_("R","U","N","N",&bs,&bsel,&one,r,&bldr,pm,&blda));
+
+  /* U = [U D, V_j] P R^{-1} and C = [C, V_{j+1}] Q */
+  for (l=0; l<nsel; l++) {
+    for (i=0; i<p; i++) {
+      gcrodr->vlist[i] = gcrodr->U[i];
+      c[i]             = d[i]*pm[l*lda+i];
+    }
+    for (m=0; m<j; m++) c[p+m] = pm[l*lda+p+m];
+    for (m=0; m<j; m++) gcrodr->vlist[p+m] = VEC_VV(m);
+    ierr = VecSet(gcrodr->Unew[l],0.0);CHKERRQ(ierr);
+    ierr = VecMAXPY(gcrodr->Unew[l],s,c,gcrodr->vlist);CHKERRQ(ierr);
+    for (i=0; i<p; i++) gcrodr->vlist[i] = gcrodr->C[i];
+    gcrodr->vlist[p+j] = VEC_VV(j);
+    ierr = VecSet(gcrodr->Cnew[l],0.0);CHKERRQ(ierr);
+    ierr = VecMAXPY(gcrodr->Cnew[l],t,q+l*ldg,gcrodr->vlist);CHKERRQ(ierr);
+  }
+  vt = gcrodr->U; gcrodr->U = gcrodr->Unew; gcrodr->Unew = vt;
+  vt = gcrodr->C; gcrodr->C = gcrodr->Cnew; gcrodr->Cnew = vt;
+  gcrodr->nr = nsel;
+  PetscFunctionReturn(0);
+#endif
+}
+
+static PetscErrorCode KSPGCRODRCycle(PetscInt *itcount,KSP ksp)
+{
+  KSP_GCRODR     *gcrodr = (KSP_GCRODR*)(ksp->data);
+  PetscReal      res_norm,res,hapbnd,tt;
+  PetscScalar    *c = gcrodr->ccoef;
+  PetscErrorCode ierr;
+  PetscInt       it = 0,i,nr = gcrodr->nr,max_j = gcrodr->max_k - gcrodr->nr;
+  PetscBool      hapend = PETSC_FALSE;
+
+  PetscFunctionBegin;
+  if (itcount) *itcount = 0;
+  ierr    = VecNormalize(VEC_VV(0),&res_norm);CHKERRQ(ierr);
+  KSPCheckNorm(ksp,res_norm);
+  res     = res_norm;
+  *GRS(0) = res_norm;
+
+  /* check for the convergence */
+  ierr       = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+  ksp->rnorm = res;
+  ierr       = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+  gcrodr->it = (it - 1);
+  ierr = KSPLogResidualHistory(ksp,res);CHKERRQ(ierr);
+  ierr = KSPMonitor(ksp,ksp->its,res);CHKERRQ(ierr);
+  if (!res) {
+    ksp->reason = KSP_CONVERGED_ATOL;
+    ierr        = PetscInfo(ksp,"Converged due to zero residual norm on entry\n");CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+
+  ierr = (*ksp->converged)(ksp,ksp->its,res,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
+  while (!ksp->reason && it < max_j && ksp->its < ksp->max_it) {
+    if (it) {
+      ierr = KSPLogResidualHistory(ksp,res);CHKERRQ(ierr);
+      ierr = KSPMonitor(ksp,ksp->its,res);CHKERRQ(ierr);
+    }
+    gcrodr->it = (it - 1);
+    if (gcrodr->vv_allocated <= it + VEC_OFFSET + 1) {
+      ierr = KSPGMRESGetNewVectors(ksp,it+1);CHKERRQ(ierr);
+    }
+    ierr = KSP_PCApplyBAorAB(ksp,VEC_VV(it),VEC_VV(1+it),VEC_TEMP_MATOP);CHKERRQ(ierr);
+
+    /* project out the image of the recycle space, BK(:,it) = C^H B v_it */
+    if (nr) {
+      ierr = VecMDot(VEC_VV(it+1),nr,gcrodr->C,&BK(0,it));CHKERRQ(ierr);
+      for (i=0; i<nr; i++) c[i] = -BK(i,it);
+      ierr = VecMAXPY(VEC_VV(it+1),nr,c,gcrodr->C);CHKERRQ(ierr);
+    }
+
+    /* update hessenberg matrix and do Gram-Schmidt */
+    ierr = (*gcrodr->orthog)(ksp,it);CHKERRQ(ierr);
+    if (ksp->reason) break;
+
+    /* vv(i+1) . vv(i+1) */
+    ierr = VecNormalize(VEC_VV(it+1),&tt);CHKERRQ(ierr);
+    KSPCheckNorm(ksp,tt);
+
+    /* save the magnitude */
+    *HH(it+1,it)  = tt;
+    *HES(it+1,it) = tt;
+
+    /* check for the happy breakdown */
+    hapbnd = PetscAbsScalar(tt / *GRS(it));
+    if (hapbnd > gcrodr->haptol) hapbnd = gcrodr->haptol;
+    if (tt < hapbnd) {
+      ierr   = PetscInfo2(ksp,"Detected happy breakdown, current hapbnd = %14.12e tt = %14.12e\n",(double)hapbnd,(double)tt);CHKERRQ(ierr);
+      hapend = PETSC_TRUE;
+    }
+    ierr = KSPGCRODRUpdateHessenberg(ksp,it,hapend,&res);CHKERRQ(ierr);
+
+    it++;
+    gcrodr->it = (it-1);   /* For converged */
+    ksp->its++;
+    ksp->rnorm = res;
+    if (ksp->reason) break;
+
+    ierr = (*ksp->converged)(ksp,ksp->its,res,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
+
+    /* Catch error in happy breakdown and signal convergence and break from loop */
+    if (hapend) {
+      if (ksp->normtype == KSP_NORM_NONE) { /* convergence test was skipped in this case */
+        ksp->reason = KSP_CONVERGED_HAPPY_BREAKDOWN;
+      } else if (!ksp->reason) {
+        if (ksp->errorifnotconverged) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_NOT_CONVERGED,"You reached the happy break down, but convergence was not indicated. Residual norm = %g",(double)res);
+        else {
+          ksp->reason = KSP_DIVERGED_BREAKDOWN;
+          break;
+        }
+      }
+    }
+  }
+
+  /* Monitor if we know that we will not return for a restart */
+  if (it && (ksp->reason || ksp->its >= ksp->max_it)) {
+    ierr = KSPLogResidualHistory(ksp,res);CHKERRQ(ierr);
+    ierr = KSPMonitor(ksp,ksp->its,res);CHKERRQ(ierr);
+  }
+
+  if (itcount) *itcount = it;
+
+  /* Form the solution (or the solution so far) */
+  ierr = KSPGCRODRBuildSoln(GRS(0),ksp->vec_sol,ksp->vec_sol,ksp,it-1);CHKERRQ(ierr);
+
+  /* the correction of this cycle is now in the solution, the recycle space can be replaced */
+  if (it && (ksp->reason >= 0 || ksp->reason == KSP_DIVERGED_ITS)) {
+    ierr = KSPGCRODRUpdateRecycle(ksp,it);CHKERRQ(ierr);
+  }
+  gcrodr->it = -1;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSolve_GCRODR(KSP ksp)
+{
+  PetscErrorCode ierr;
+  PetscInt       its,itcount;
+  KSP_GCRODR     *gcrodr    = (KSP_GCRODR*)ksp->data;
+  PetscBool      guess_zero = ksp->guess_zero;
+
+  PetscFunctionBegin;
+  ierr = PetscCitationsRegister(citation,&cited);CHKERRQ(ierr);
+  ierr = KSPGCRODRUpdateImage(ksp);CHKERRQ(ierr);
+
+  ierr     = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+  ksp->its = 0;
+  ierr     = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+
+  itcount     = 0;
+  ksp->reason = KSP_CONVERGED_ITERATING;
+  while (!ksp->reason) {
+    ierr     = KSPInitialResidual(ksp,ksp->vec_sol,VEC_TEMP,VEC_TEMP_MATOP,VEC_VV(0),ksp->vec_rhs);CHKERRQ(ierr);
+    ierr     = KSPGCRODRProjectResidual(ksp);CHKERRQ(ierr);
+    ierr     = KSPGCRODRCycle(&its,ksp);CHKERRQ(ierr);
+    itcount += its;
+    if (itcount >= ksp->max_it) {
+      if (!ksp->reason) ksp->reason = KSP_DIVERGED_ITS;
+      break;
+    }
+    ksp->guess_zero = PETSC_FALSE; /* every future call to KSPInitialResidual() will have nonzero guess */
+  }
+  ksp->guess_zero = guess_zero; /* restore if user provided nonzero initial guess */
+  ierr = PetscInfo2(ksp,"Recycle space of dimension %D after %D iterations\n",gcrodr->nr,itcount);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPBuildSolution_GCRODR(KSP ksp,Vec ptr,Vec *result)
+{
+  KSP_GCRODR     *gcrodr = (KSP_GCRODR*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!ptr) {
+    if (!gcrodr->sol_temp) {
+      ierr = VecDuplicate(ksp->vec_sol,&gcrodr->sol_temp);CHKERRQ(ierr);
+      ierr = PetscLogObjectParent((PetscObject)ksp,(PetscObject)gcrodr->sol_temp);CHKERRQ(ierr);
+    }
+    ptr = gcrodr->sol_temp;
+  }
+  if (!gcrodr->nrs) {
+    /* allocate the work area */
+    ierr = PetscMalloc1(gcrodr->max_k,&gcrodr->nrs);CHKERRQ(ierr);
+    ierr = PetscLogObjectMemory((PetscObject)ksp,gcrodr->max_k);CHKERRQ(ierr);
+  }
+
+  ierr = KSPGCRODRBuildSoln(gcrodr->nrs,ksp->vec_sol,ptr,ksp,gcrodr->it);CHKERRQ(ierr);
+  if (result) *result = ptr;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPReset_GCRODR(KSP ksp)
+{
+  KSP_GCRODR     *gcrodr = (KSP_GCRODR*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecDestroyVecs(gcrodr->k,&gcrodr->U);CHKERRQ(ierr);
+  ierr = VecDestroyVecs(gcrodr->k,&gcrodr->C);CHKERRQ(ierr);
+  ierr = VecDestroyVecs(gcrodr->k,&gcrodr->Unew);CHKERRQ(ierr);
+  ierr = VecDestroyVecs(gcrodr->k,&gcrodr->Cnew);CHKERRQ(ierr);
+  ierr = PetscFree(gcrodr->vlist);CHKERRQ(ierr);
+  ierr = PetscFree6(gcrodr->gmat,gcrodr->wmat,gcrodr->amat,gcrodr->bmat,gcrodr->evec,gcrodr->pmat);CHKERRQ(ierr);
+  ierr = PetscFree6(gcrodr->qmat,gcrodr->rmat,gcrodr->eig,gcrodr->tau,gcrodr->work,gcrodr->bk);CHKERRQ(ierr);
+  ierr = PetscFree5(gcrodr->eigi,gcrodr->rwork,gcrodr->modul,gcrodr->perm,gcrodr->ccoef);CHKERRQ(ierr);
+  gcrodr->nr    = 0;
+  gcrodr->matid = 0;
+  ierr = KSPReset_GMRES(ksp);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPDestroy_GCRODR(KSP ksp)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGCRODRSetRecycleSize_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGCRODRGetRecycleSize_C",NULL);CHKERRQ(ierr);
+  ierr = KSPReset_GCRODR(ksp);CHKERRQ(ierr);
+  ierr = KSPDestroy_GMRES(ksp);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPView_GCRODR(KSP ksp,PetscViewer viewer)
+{
+  KSP_GCRODR     *gcrodr = (KSP_GCRODR*)ksp->data;
+  PetscErrorCode ierr;
+  PetscBool      iascii,isstring;
+
+  PetscFunctionBegin;
+  ierr = KSPView_GMRES(ksp,viewer);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERSTRING,&isstring);CHKERRQ(ierr);
+  if (iascii) {
+    ierr = PetscViewerASCIIPrintf(viewer,"  recycle space of dimension %D, %D vectors currently recycled\n",gcrodr->k,gcrodr->nr);CHKERRQ(ierr);
+  } else if (isstring) {
+    ierr = PetscViewerStringSPrintf(viewer," recycle %D",gcrodr->k);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSetFromOptions_GCRODR(PetscOptionItems *PetscOptionsObject,KSP ksp)
+{
+  KSP_GCRODR     *gcrodr = (KSP_GCRODR*)ksp->data;
+  PetscInt       k;
+  PetscBool      flg;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = KSPSetFromOptions_GMRES(PetscOptionsObject,ksp);CHKERRQ(ierr);
+  ierr = PetscOptionsHead(PetscOptionsObject,"KSP GCRODR Options");CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-ksp_gcrodr_recycle_size","Dimension of the recycle space kept between restarts and solves","KSPGCRODRSetRecycleSize",gcrodr->k,&k,&flg);CHKERRQ(ierr);
+  if (flg) {ierr = KSPGCRODRSetRecycleSize(ksp,k);CHKERRQ(ierr);}
+  ierr = PetscOptionsTail();CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPGCRODRSetRecycleSize_GCRODR(KSP ksp,PetscInt k)
+{
+  KSP_GCRODR     *gcrodr = (KSP_GCRODR*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (k < 1) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_OUTOFRANGE,"Recycle size %D must be positive",k);
+  if (!ksp->setupstage) {
+    gcrodr->k = k;
+  } else if (gcrodr->k != k) {
+    /* free the data structures, including the recycle space, then create them again */
+    ierr = KSPReset_GCRODR(ksp);CHKERRQ(ierr);
+    gcrodr->k       = k;
+    ksp->setupstage = KSP_SETUP_NEW;
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPGCRODRGetRecycleSize_GCRODR(KSP ksp,PetscInt *k)
+{
+  PetscFunctionBegin;
+  *k = ((KSP_GCRODR*)ksp->data)->k;
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPGCRODRSetRecycleSize - Sets the dimension of the subspace that KSPGCRODR recycles between restarts and between solves
+
+   Logically Collective on ksp
+
+   Input Parameters:
++  ksp - the Krylov space context
+-  k - the dimension of the recycle space, defaults to 10, must be smaller than the restart
+
+   Options Database Key:
+.  -ksp_gcrodr_recycle_size <k> - the dimension of the recycle space
+
+   Notes:
+   Each restart cycle runs restart - k Arnoldi steps, the recycle space takes the place of the other k basis vectors.
+   Changing the dimension after the solver has been set up discards the current recycle space.
+
+   Level: intermediate
+
+.seealso: KSPGCRODR, KSPGCRODRGetRecycleSize(), KSPGMRESSetRestart()
+@*/
+PetscErrorCode KSPGCRODRSetRecycleSize(KSP ksp,PetscInt k)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidLogicalCollectiveInt(ksp,k,2);
+  ierr = PetscTryMethod(ksp,"KSPGCRODRSetRecycleSize_C",(KSP,PetscInt),(ksp,k));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPGCRODRGetRecycleSize - Gets the dimension of the subspace that KSPGCRODR recycles between restarts and between solves
+
+   Not Collective
+
+   Input Parameter:
+.  ksp - the Krylov space context
+
+   Output Parameter:
+.  k - the dimension of the recycle space
+
+   Level: intermediate
+
+.seealso: KSPGCRODR, KSPGCRODRSetRecycleSize()
+@*/
+PetscErrorCode KSPGCRODRGetRecycleSize(KSP ksp,PetscInt *k)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidIntPointer(k,2);
+  ierr = PetscUseMethod(ksp,"KSPGCRODRGetRecycleSize_C",(KSP,PetscInt*),(ksp,k));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*MC
+   KSPGCRODR - Implements GCRO-DR, a restarted GMRES with deflated restarting that recycles a Krylov subspace between
+   the solves of a sequence of linear systems.
+
+   At the end of each restart cycle the solver keeps the k harmonic Ritz vectors of the preconditioned operator with the
+   smallest harmonic Ritz values in the current search space. The next cycle first minimizes the residual over this
+   recycle space, then runs restart - k Arnoldi steps orthogonal to its image, so the slowest modes stay deflated across
+   restarts. The recycle space is also kept from one KSPSolve() to the next, including after KSPSetOperators() with
+   matrices of the same size; its image is then recomputed with k applications of the new preconditioned operator. The
+   same happens when KSPSolveTranspose() follows KSPSolve() or the other way around.
+
+   Options Database Keys:
++   -ksp_gmres_restart <restart> - the dimension of the search space of a cycle, recycle space included
+.   -ksp_gcrodr_recycle_size <k> - the dimension of the recycle space
+.   -ksp_gmres_haptol <tol> - sets the tolerance for "happy ending" (exact convergence)
+.   -ksp_gmres_preallocate - preallocate all the Krylov search directions initially (otherwise groups of
+                             vectors are allocated as needed)
+.   -ksp_gmres_classicalgramschmidt - use classical (unmodified) Gram-Schmidt to orthogonalize against the Krylov space (fast) (the default)
+.   -ksp_gmres_modifiedgramschmidt - use modified Gram-Schmidt in the orthogonalization (more stable, but slower)
+-   -ksp_gmres_cgs_refinement_type <refine_never,refine_ifneeded,refine_always> - determine if iterative refinement is used to increase the
+                                   stability of the classical Gram-Schmidt  orthogonalization.
+
+   Level: intermediate
+
+   Notes:
+   Left and right preconditioning are supported, but not symmetric preconditioning. The method is most useful for
+   sequences of systems whose operators change slowly, such as the linear systems of a Newton method or of an implicit
+   time integrator, or several right hand sides with the same operator. The recycle space is discarded by KSPReset(),
+   by KSPGCRODRSetRecycleSize() and by a change of the size of the vectors. It needs 4k extra vectors.
+
+   Each cycle and each solve with a changed operator needs k additional global reductions to form the small dense
+   eigenvalue problem. The eigenvalue and singular value estimates of KSPGMRES are not available.
+
+   Developer Notes:
+    This class is subclassed off of KSPGMRES, it reuses its Arnoldi orthogonalization routines.
+
+   References:
+.     1. - M. L. Parks, E. de Sturler, G. Mackey, D. D. Johnson and S. Maiti, Recycling Krylov subspaces for sequences of
+           linear systems, SIAM J. Sci. Comput. 28(5), 2006.
+
+.seealso:  KSPCreate(), KSPSetType(), KSPType (for list of available types), KSP, KSPGMRES, KSPDGMRES, KSPLGMRES,
+           KSPGCRODRSetRecycleSize(), KSPGMRESSetRestart(), KSPGMRESSetHapTol()
+M*/
+
+PETSC_EXTERN PetscErrorCode KSPCreate_GCRODR(KSP ksp)
+{
+  KSP_GCRODR     *gcrodr;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr      = PetscNewLog(ksp,&gcrodr);CHKERRQ(ierr);
+  ksp->data = (void*)gcrodr;
+
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_PRECONDITIONED,PC_LEFT,3);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_UNPRECONDITIONED,PC_RIGHT,2);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_NONE,PC_RIGHT,1);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_NONE,PC_LEFT,1);CHKERRQ(ierr);
+
+  ksp->ops->buildsolution                = KSPBuildSolution_GCRODR;
+  ksp->ops->setup                        = KSPSetUp_GCRODR;
+  ksp->ops->solve                        = KSPSolve_GCRODR;
+  ksp->ops->reset                        = KSPReset_GCRODR;
+  ksp->ops->destroy                      = KSPDestroy_GCRODR;
+  ksp->ops->view                         = KSPView_GCRODR;
+  ksp->ops->setfromoptions               = KSPSetFromOptions_GCRODR;
+
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESSetPreAllocateVectors_C",KSPGMRESSetPreAllocateVectors_GMRES);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESSetContiguousBasis_C",KSPGMRESSetContiguousBasis_GMRES);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESSetOrthogonalization_C",KSPGMRESSetOrthogonalization_GMRES);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESGetOrthogonalization_C",KSPGMRESGetOrthogonalization_GMRES);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESSetRestart_C",KSPGMRESSetRestart_GMRES);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESGetRestart_C",KSPGMRESGetRestart_GMRES);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESSetHapTol_C",KSPGMRESSetHapTol_GMRES);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESSetCGSRefinementType_C",KSPGMRESSetCGSRefinementType_GMRES);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESGetCGSRefinementType_C",KSPGMRESGetCGSRefinementType_GMRES);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGCRODRSetRecycleSize_C",KSPGCRODRSetRecycleSize_GCRODR);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGCRODRGetRecycleSize_C",KSPGCRODRGetRecycleSize_GCRODR);CHKERRQ(ierr);
+
+  gcrodr->haptol         = 1.0e-30;
+  gcrodr->q_preallocate  = 0;
+  gcrodr->delta_allocate = GCRODR_DELTA_DIRECTIONS;
+  gcrodr->orthog         = KSPGMRESClassicalGramSchmidtOrthogonalization;
+  gcrodr->nrs            = NULL;
+  gcrodr->sol_temp       = NULL;
+  gcrodr->max_k          = GCRODR_DEFAULT_MAXK;
+  gcrodr->Rsvd           = NULL;
+  gcrodr->cgstype        = KSP_GMRES_CGS_REFINE_NEVER;
+  gcrodr->orthogwork     = NULL;
+  gcrodr->k              = GCRODR_DEFAULT_K;
+  gcrodr->nr             = 0;
+  PetscFunctionReturn(0);
+}
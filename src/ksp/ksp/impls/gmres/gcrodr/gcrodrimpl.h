@@ -0,0 +1,49 @@
+#if !defined(GCRODRIMPL_H)
+#define GCRODRIMPL_H
+
+#define KSPGMRES_NO_MACROS
+#include <../src/ksp/ksp/impls/gmres/gmresimpl.h>
+
+typedef struct {
+  KSPGMRESHEADER
+
+  /* recycling specific data */
+  PetscInt         k;                   /* requested dimension of the recycle space */
+  PetscInt         nr;                  /* current dimension of the recycle space, at most k */
+  Vec              *U,*C;               /* recycle space and its image by the preconditioned operator, C = B U with C^H C = I */
+  Vec              *Unew,*Cnew;         /* the recycle space of the next cycle while it is built */
+  Vec              *vlist;              /* concatenation of the recycle vectors and the Krylov basis, for VecMDot()/VecMAXPY() */
+  PetscScalar      *bk;                 /* C^H B V of the current cycle, k x max_k */
+  PetscScalar      *ccoef;              /* coefficients of one vector in the basis C, or in the concatenation */
+  PetscObjectId    matid,pmatid;        /* operators the image C was computed with */
+  PetscObjectState matstate,pmatstate;
+  PetscBool        transpose;           /* C was computed with the transposed operators */
+
+  /* dense work space of the harmonic Ritz problem, of dimension at most max_k, stored by columns */
+  PetscScalar      *gmat;               /* B W = What gmat, (max_k+1) x max_k */
+  PetscScalar      *wmat;               /* What^H W, (max_k+1) x max_k */
+  PetscScalar      *amat,*bmat;         /* gmat^H gmat and gmat^H wmat, max_k x max_k */
+  PetscScalar      *evec;               /* eigenvectors, max_k x max_k */
+  PetscScalar      *pmat;               /* coefficients of the harmonic Ritz vectors, max_k x k */
+  PetscScalar      *qmat;               /* QR factorization of gmat pmat, (max_k+1) x k */
+  PetscScalar      *rmat;               /* triangular factor, k x k */
+  PetscScalar      *eig,*tau,*work;
+  PetscReal        *eigi,*rwork,*modul;
+  PetscInt         *perm;
+} KSP_GCRODR;
+
+#define HH(a,b)  (gcrodr->hh_origin + (b)*(gcrodr->max_k+2)+(a))
+#define HES(a,b) (gcrodr->hes_origin + (b)*(gcrodr->max_k+1)+(a))
+#define CC(a)    (gcrodr->cc_origin + (a))
+#define SS(a)    (gcrodr->ss_origin + (a))
+#define GRS(a)   (gcrodr->rs_origin + (a))
+
+#define BK(a,b)  gcrodr->bk[(b)*gcrodr->k+(a)]
+
+/* vector names, identical to KSPGMRES so that its routines can be reused */
+#define VEC_OFFSET     2
+#define VEC_TEMP       gcrodr->vecs[0]
+#define VEC_TEMP_MATOP gcrodr->vecs[1]
+#define VEC_VV(i)      gcrodr->vecs[VEC_OFFSET+i]
+
+#endif
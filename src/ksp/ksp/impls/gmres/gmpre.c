@@ -27,3 +27,45 @@ PetscErrorCode  KSPGMRESSetPreAllocateVectors(KSP ksp)
   PetscFunctionReturn(0);
 }
 
+
+/*@
+    KSPGMRESSetContiguousBasis - Causes GMRES to store its Krylov search directions as the columns
+    of one array, which lets the classical Gram-Schmidt orthogonalization work on the whole basis with BLAS
+
+    Logically Collective on ksp
+
+    Input Parameters:
++   ksp - iterative context obtained from KSPCreate
+-   flg - PETSC_TRUE to store the basis in one array
+
+    Options Database Key:
+.   -ksp_gmres_contiguous_basis <true,false> - Activates KSPGMRESSetContiguousBasis()
+
+    Notes:
+    All the search directions are allocated at setup, as with KSPGMRESSetPreAllocateVectors(). The inner products
+    of a classical Gram-Schmidt pass are then one BLAS gemv on the local rows, followed by a single reduction, and the
+    update of the new direction is another gemv. With the refine_ifneeded refinement type the norm that decides on
+    refinement is computed in the same reduction as the inner products of the second pass.
+
+    Only the standard VECSEQ and VECMPI vector types can be stored this way; for other types this option is ignored.
+
+    Only KSPGMRES and KSPGCRODR support a contiguous basis. The other types built on KSPGMRES, such as KSPFGMRES,
+    KSPLGMRES, KSPDGMRES, KSPPGMRES and KSPPIPEFGMRES, accept the option but ignore it; run with -info to see this.
+    The type must be set before this is called.
+
+    Level: advanced
+
+.seealso: KSPGMRESSetPreAllocateVectors(), KSPGMRESClassicalGramSchmidtOrthogonalization(), KSPGMRESSetCGSRefinementType()
+@*/
+PetscErrorCode  KSPGMRESSetContiguousBasis(KSP ksp,PetscBool flg)
+{
+  PetscErrorCode ierr,(*f)(KSP,PetscBool);
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidLogicalCollectiveBool(ksp,flg,2);
+  ierr = PetscObjectQueryFunction((PetscObject)ksp,"KSPGMRESSetContiguousBasis_C",&f);CHKERRQ(ierr);
+  if (f) {ierr = (*f)(ksp,flg);CHKERRQ(ierr);}
+  else if (flg) {ierr = PetscInfo1(ksp,"KSP type %s cannot store its basis in one array, ignoring the contiguous basis\n",((PetscObject)ksp)->type_name ? ((PetscObject)ksp)->type_name : "not yet set");CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
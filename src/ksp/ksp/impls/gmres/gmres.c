@@ -34,6 +34,56 @@
 static PetscErrorCode KSPGMRESUpdateHessenberg(KSP,PetscInt,PetscBool,PetscReal*);
 static PetscErrorCode KSPGMRESBuildSoln(PetscScalar*,Vec,Vec,KSP,PetscInt);
 
+/*
+    Creates the VEC_OFFSET work vectors and then the max_k+2 direction vectors as the columns of one array,
+    so that the classical Gram-Schmidt orthogonalization can apply BLAS to the whole basis. Only possible for
+    the standard vector types, otherwise vv_contiguous remains false and the vectors are created as usual.
+*/
+static PetscErrorCode KSPGMRESCreateContiguousBasis_Private(KSP ksp)
+{
+  KSP_GMRES      *gmres = (KSP_GMRES*)ksp->data;
+  PetscErrorCode ierr;
+  PetscInt       nvv = gmres->max_k + 2,n,N,bs,k;
+  PetscBool      isseq,ismpi;
+  Vec            *t,v;
+
+  PetscFunctionBegin;
+  ierr = KSPCreateVecs(ksp,1,&t,0,NULL);CHKERRQ(ierr);
+  v    = t[0];
+  ierr = PetscObjectTypeCompare((PetscObject)v,VECSEQ,&isseq);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject)v,VECMPI,&ismpi);CHKERRQ(ierr);
+  if (isseq || ismpi) {
+    ierr = VecGetLocalSize(v,&n);CHKERRQ(ierr);
+    ierr = VecGetSize(v,&N);CHKERRQ(ierr);
+    ierr = VecGetBlockSize(v,&bs);CHKERRQ(ierr);
+    ierr = KSPCreateVecs(ksp,VEC_OFFSET,&gmres->user_work[0],0,NULL);CHKERRQ(ierr);
+    ierr = PetscLogObjectParents(ksp,VEC_OFFSET,gmres->user_work[0]);CHKERRQ(ierr);
+    ierr = PetscCalloc1(nvv*n,&gmres->vv_array);CHKERRQ(ierr);
+    ierr = PetscLogObjectMemory((PetscObject)ksp,nvv*n*sizeof(PetscScalar));CHKERRQ(ierr);
+    ierr = PetscMalloc1(nvv,&gmres->user_work[1]);CHKERRQ(ierr);
+    for (k=0; k<nvv; k++) {
+      if (isseq) {
+        ierr = VecCreateSeqWithArray(PetscObjectComm((PetscObject)v),bs,n,gmres->vv_array+k*n,&gmres->user_work[1][k]);CHKERRQ(ierr);
+      } else {
+        ierr = VecCreateMPIWithArray(PetscObjectComm((PetscObject)v),bs,n,N,gmres->vv_array+k*n,&gmres->user_work[1][k]);CHKERRQ(ierr);
+      }
+    }
+    ierr = PetscLogObjectParents(ksp,nvv,gmres->user_work[1]);CHKERRQ(ierr);
+
+    gmres->mwork_alloc[0] = VEC_OFFSET;
+    gmres->mwork_alloc[1] = nvv;
+    gmres->nwork_alloc    = 2;
+    gmres->vv_allocated   = VEC_OFFSET + nvv;
+    gmres->vv_contiguous  = PETSC_TRUE;
+    for (k=0; k<VEC_OFFSET; k++) gmres->vecs[k] = gmres->user_work[0][k];
+    for (k=0; k<nvv; k++) gmres->vecs[VEC_OFFSET+k] = gmres->user_work[1][k];
+  } else {
+    ierr = PetscInfo1(ksp,"The Krylov basis cannot be contiguous for vectors of type %s\n",((PetscObject)v)->type_name);CHKERRQ(ierr);
+  }
+  ierr = VecDestroyVecs(1,&t);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode    KSPSetUp_GMRES(KSP ksp)
 {
   PetscInt       hh,hes,rs,cc;
@@ -68,6 +118,10 @@ PetscErrorCode    KSPSetUp_GMRES(KSP ksp)
   ierr = PetscMalloc1(VEC_OFFSET+2+max_k,&gmres->mwork_alloc);CHKERRQ(ierr);
   ierr = PetscLogObjectMemory((PetscObject)ksp,(VEC_OFFSET+2+max_k)*(sizeof(Vec*)+sizeof(PetscInt)) + gmres->vecs_allocated*sizeof(Vec));CHKERRQ(ierr);
 
+  if (gmres->contiguous) {
+    ierr = KSPGMRESCreateContiguousBasis_Private(ksp);CHKERRQ(ierr);
+    if (gmres->vv_contiguous) PetscFunctionReturn(0);
+  }
   if (gmres->q_preallocate) {
     gmres->vv_allocated = VEC_OFFSET + 2 + max_k;
 
@@ -291,7 +345,9 @@ PetscErrorCode KSPReset_GMRES(KSP ksp)
   ierr = PetscFree(gmres->Rsvd);CHKERRQ(ierr);
   ierr = PetscFree(gmres->Dsvd);CHKERRQ(ierr);
   ierr = PetscFree(gmres->orthogwork);CHKERRQ(ierr);
+  ierr = PetscFree(gmres->vv_array);CHKERRQ(ierr);
 
+  gmres->vv_contiguous  = PETSC_FALSE;
   gmres->vv_allocated   = 0;
   gmres->vecs_allocated = 0;
   gmres->sol_temp       = NULL;
@@ -522,6 +578,7 @@ PetscErrorCode KSPView_GMRES(KSP ksp,PetscViewer viewer)
   if (iascii) {
     ierr = PetscViewerASCIIPrintf(viewer,"  restart=%D, using %s\n",gmres->max_k,cstr);CHKERRQ(ierr);
     ierr = PetscViewerASCIIPrintf(viewer,"  happy breakdown tolerance %g\n",(double)gmres->haptol);CHKERRQ(ierr);
+    if (gmres->vv_contiguous) {ierr = PetscViewerASCIIPrintf(viewer,"  Krylov basis stored contiguously\n");CHKERRQ(ierr);}
   } else if (isstring) {
     ierr = PetscViewerStringSPrintf(viewer,"%s restart %D",cstr,gmres->max_k);CHKERRQ(ierr);
   }
@@ -575,7 +632,7 @@ PetscErrorCode KSPSetFromOptions_GMRES(PetscOptionItems *PetscOptionsObject,KSP
   PetscInt       restart;
   PetscReal      haptol;
   KSP_GMRES      *gmres = (KSP_GMRES*)ksp->data;
-  PetscBool      flg;
+  PetscBool      flg,set;
 
   PetscFunctionBegin;
   ierr = PetscOptionsHead(PetscOptionsObject,"KSP GMRES Options");CHKERRQ(ierr);
@@ -586,6 +643,8 @@ PetscErrorCode KSPSetFromOptions_GMRES(PetscOptionItems *PetscOptionsObject,KSP
   flg  = PETSC_FALSE;
   ierr = PetscOptionsBool("-ksp_gmres_preallocate","Preallocate Krylov vectors","KSPGMRESSetPreAllocateVectors",flg,&flg,NULL);CHKERRQ(ierr);
   if (flg) {ierr = KSPGMRESSetPreAllocateVectors(ksp);CHKERRQ(ierr);}
+  ierr = PetscOptionsBool("-ksp_gmres_contiguous_basis","Store the Krylov vectors in one array","KSPGMRESSetContiguousBasis",gmres->contiguous,&flg,&set);CHKERRQ(ierr);
+  if (set) {ierr = KSPGMRESSetContiguousBasis(ksp,flg);CHKERRQ(ierr);}
   ierr = PetscOptionsBoolGroupBegin("-ksp_gmres_classicalgramschmidt","Classical (unmodified) Gram-Schmidt (fast)","KSPGMRESSetOrthogonalization",&flg);CHKERRQ(ierr);
   if (flg) {ierr = KSPGMRESSetOrthogonalization(ksp,KSPGMRESClassicalGramSchmidtOrthogonalization);CHKERRQ(ierr);}
   ierr = PetscOptionsBoolGroupEnd("-ksp_gmres_modifiedgramschmidt","Modified Gram-Schmidt (slow,more stable)","KSPGMRESSetOrthogonalization",&flg);CHKERRQ(ierr);
@@ -664,6 +723,23 @@ PetscErrorCode  KSPGMRESSetPreAllocateVectors_GMRES(KSP ksp)
   PetscFunctionReturn(0);
 }
 
+PetscErrorCode  KSPGMRESSetContiguousBasis_GMRES(KSP ksp,PetscBool flg)
+{
+  KSP_GMRES      *gmres = (KSP_GMRES*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!ksp->setupstage) {
+    gmres->contiguous = flg;
+  } else if (gmres->contiguous != flg) {
+    gmres->contiguous = flg;
+    ksp->setupstage   = KSP_SETUP_NEW;
+    /* free the work vectors, then create them again */
+    ierr = KSPReset_GMRES(ksp);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode  KSPGMRESSetCGSRefinementType_GMRES(KSP ksp,KSPGMRESCGSRefinementType type)
 {
   KSP_GMRES *gmres = (KSP_GMRES*)ksp->data;
@@ -837,6 +913,7 @@ PetscErrorCode  KSPGMRESSetHapTol(KSP ksp,PetscReal tol)
 .   -ksp_gmres_haptol <tol> - sets the tolerance for "happy ending" (exact convergence)
 .   -ksp_gmres_preallocate - preallocate all the Krylov search directions initially (otherwise groups of
                              vectors are allocated as needed)
+.   -ksp_gmres_contiguous_basis - store the Krylov search directions in one array, see KSPGMRESSetContiguousBasis()
 .   -ksp_gmres_classicalgramschmidt - use classical (unmodified) Gram-Schmidt to orthogonalize against the Krylov space (fast) (the default)
 .   -ksp_gmres_modifiedgramschmidt - use modified Gram-Schmidt in the orthogonalization (more stable, but slower)
 .   -ksp_gmres_cgs_refinement_type <refine_never,refine_ifneeded,refine_always> - determine if iterative refinement is used to increase the
@@ -853,7 +930,7 @@ PetscErrorCode  KSPGMRESSetHapTol(KSP ksp,PetscReal tol)
           SIAM J. ScI. STAT. COMPUT. Vo|. 7, No. 3, July 1986.
 
 .seealso:  KSPCreate(), KSPSetType(), KSPType (for list of available types), KSP, KSPFGMRES, KSPLGMRES,
-           KSPGMRESSetRestart(), KSPGMRESSetHapTol(), KSPGMRESSetPreAllocateVectors(), KSPGMRESSetOrthogonalization(), KSPGMRESGetOrthogonalization(),
+           KSPGMRESSetRestart(), KSPGMRESSetHapTol(), KSPGMRESSetPreAllocateVectors(), KSPGMRESSetContiguousBasis(), KSPGMRESSetOrthogonalization(), KSPGMRESGetOrthogonalization(),
            KSPGMRESClassicalGramSchmidtOrthogonalization(), KSPGMRESModifiedGramSchmidtOrthogonalization(),
            KSPGMRESCGSRefinementType, KSPGMRESSetCGSRefinementType(), KSPGMRESGetCGSRefinementType(), KSPGMRESMonitorKrylov(), KSPSetPCSide()
 
@@ -887,6 +964,7 @@ PETSC_EXTERN PetscErrorCode KSPCreate_GMRES(KSP ksp)
   ksp->ops->computeritz                  = KSPComputeRitz_GMRES;
 #endif
   ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESSetPreAllocateVectors_C",KSPGMRESSetPreAllocateVectors_GMRES);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESSetContiguousBasis_C",KSPGMRESSetContiguousBasis_GMRES);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESSetOrthogonalization_C",KSPGMRESSetOrthogonalization_GMRES);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESGetOrthogonalization_C",KSPGMRESGetOrthogonalization_GMRES);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESSetRestart_C",KSPGMRESSetRestart_GMRES);CHKERRQ(ierr);
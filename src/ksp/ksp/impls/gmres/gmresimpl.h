@@ -35,6 +35,9 @@
   Vec      *vecb;                                        /* holds the last full basis vectors of the Krylov subspace to compute (harmonic) Ritz pairs */ \
   PetscInt q_preallocate;    /* 0=don't preallocate space for work vectors */ \
   PetscInt delta_allocate;    /* number of vectors to preallocaate in each block if not preallocated */ \
+  PetscBool   contiguous;     /* store the Krylov basis in one array, see KSPGMRESSetContiguousBasis() */ \
+  PetscBool   vv_contiguous;  /* the direction vectors VEC_VV(0),... are the columns of vv_array */ \
+  PetscScalar *vv_array;                                                \
   PetscInt vv_allocated;      /* number of allocated gmres direction vectors */ \
   PetscInt vecs_allocated;                              /*   total number of vecs available */ \
   /* Since we may call the user "obtain_work_vectors" several times, we have to keep track of the pointers that it has returned */ \
@@ -61,11 +64,13 @@ PETSC_INTERN PetscErrorCode KSPComputeRitz_GMRES(KSP,PetscBool,PetscBool,PetscIn
 PETSC_INTERN PetscErrorCode KSPReset_GMRES(KSP);
 PETSC_INTERN PetscErrorCode KSPDestroy_GMRES(KSP);
 PETSC_INTERN PetscErrorCode KSPGMRESGetNewVectors(KSP,PetscInt);
+PETSC_INTERN PetscErrorCode KSPBuildSolution_GMRES(KSP,Vec,Vec*);
 
 typedef PetscErrorCode (*FCN)(KSP,PetscInt); /* force argument to next function to not be extern C*/
 
 PETSC_INTERN PetscErrorCode KSPGMRESSetHapTol_GMRES(KSP,PetscReal);
 PETSC_INTERN PetscErrorCode KSPGMRESSetPreAllocateVectors_GMRES(KSP);
+PETSC_INTERN PetscErrorCode KSPGMRESSetContiguousBasis_GMRES(KSP,PetscBool);
 PETSC_INTERN PetscErrorCode KSPGMRESSetRestart_GMRES(KSP,PetscInt);
 PETSC_INTERN PetscErrorCode KSPGMRESGetRestart_GMRES(KSP,PetscInt*);
 PETSC_INTERN PetscErrorCode KSPGMRESSetOrthogonalization_GMRES(KSP,FCN);
@@ -0,0 +1,914 @@
+/*
+    This file implements SGMRES, an s-step (communication-avoiding) variant of GMRES.
+
+    Instead of one Arnoldi step at a time, each block generates s new basis vectors
+       v_{i+1} = (A v_i - theta_i v_i - beta_i v_{i-1})/sigma_i
+    with s applications of the (preconditioned) operator, so that A V(:,0:s-1) = V B with a known
+    (s+1) x s change of basis matrix B. The block is then orthogonalized against the previous
+    basis and among itself by two passes of block classical Gram-Schmidt; the second pass also
+    does a Cholesky QR of the block. All the inner products of one pass are computed with a
+    single split reduction, so a restart cycle of m steps needs 2m/s global reductions instead
+    of 2m for KSPGMRES with classical Gram-Schmidt.
+
+    The Hessenberg matrix of the Arnoldi relation is recovered from B and the coefficients of the
+    orthogonalization, and the least squares problem is then solved exactly as in KSPGMRES.
+
+    The monomial basis (theta_i = beta_i = 0) quickly becomes ill-conditioned as s increases. The Newton
+    and Chebyshev bases use the Ritz values computed during a first restart cycle, run with s = 1,
+    for the shifts or the interval of the polynomial.
+*/
+
+#include <../src/ksp/ksp/impls/gmres/sgmres/sgmresimpl.h>       /*I  "petscksp.h"  I*/
+
+#define SGMRES_DELTA_DIRECTIONS 10
+#define SGMRES_DEFAULT_MAXK     30
+#define SGMRES_DEFAULT_S        5
+
+static PetscBool  cited = PETSC_FALSE;
+static const char citation[] =
+  "@phdthesis{Hoemmen2010,\n"
+  "  author = {Mark Hoemmen},\n"
+  "  title  = {Communication-avoiding {K}rylov subspace methods},\n"
+  "  school = {EECS Department, University of California, Berkeley},\n"
+  "  year   = {2010}\n"
+  "}\n";
+
+static PetscErrorCode KSPSetUp_SGMRES(KSP ksp)
+{
+  KSP_SGMRES     *sgmres = (KSP_SGMRES*)ksp->data;
+  PetscInt       max_k = sgmres->max_k,s = sgmres->s,N = max_k + 1,k;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = KSPSetUp_GMRES(ksp);CHKERRQ(ierr);
+
+  /* the Ritz values used for the Newton and Chebyshev bases are computed with the GMRES eigenvalue routine */
+  if (!sgmres->Rsvd) {
+    ierr = PetscMalloc1((max_k + 3)*(max_k + 9),&sgmres->Rsvd);CHKERRQ(ierr);
+    ierr = PetscMalloc1(6*(max_k+2),&sgmres->Dsvd);CHKERRQ(ierr);
+    ierr = PetscLogObjectMemory((PetscObject)ksp,(max_k + 3)*(max_k + 9)*sizeof(PetscScalar)+6*(max_k+2)*sizeof(PetscReal));CHKERRQ(ierr);
+  }
+  ierr = PetscFree(sgmres->orthogwork);CHKERRQ(ierr);
+  ierr = PetscMalloc1(N+s,&sgmres->orthogwork);CHKERRQ(ierr);
+
+  ierr = PetscFree5(sgmres->sre,sgmres->sim,sgmres->scale,sgmres->rawnorm,sgmres->pivtol);CHKERRQ(ierr);
+  ierr = PetscFree6(sgmres->bmat,sgmres->dots,sgmres->cmat,sgmres->cmat2,sgmres->rmat,sgmres->rmat2);CHKERRQ(ierr);
+  ierr = PetscCalloc5(s,&sgmres->sre,s,&sgmres->sim,s,&sgmres->scale,s,&sgmres->rawnorm,s,&sgmres->pivtol);CHKERRQ(ierr);
+  ierr = PetscCalloc6((s+1)*s,&sgmres->bmat,(N+s)*s,&sgmres->dots,N*s,&sgmres->cmat,N*s,&sgmres->cmat2,s*s,&sgmres->rmat,s*s,&sgmres->rmat2);CHKERRQ(ierr);
+  ierr = PetscLogObjectMemory((PetscObject)ksp,(N+s)*sizeof(PetscScalar)+5*s*sizeof(PetscReal)+((s+1)*s+(3*N+s)*s+2*s*s)*sizeof(PetscScalar));CHKERRQ(ierr);
+  for (k=0; k<s; k++) sgmres->scale[k] = 1.0;
+  sgmres->havespectrum = PETSC_FALSE;
+  sgmres->matid        = 0;
+  PetscFunctionReturn(0);
+}
+
+/*
+   Cholesky factorization G = R^H R of the leading columns of the Hermitian n x n matrix G whose upper triangular
+   part is stored in g, R overwrites it. The factorization stops at the first column whose pivot is not larger than
+   tol[i]; nok is the number of columns that have been factored.
+*/
+static PetscErrorCode KSPSGMRESCholesky(PetscInt n,PetscScalar *g,PetscInt ld,const PetscReal *tol,PetscInt *nok)
+{
+  PetscInt    i,j,k;
+  PetscScalar t;
+  PetscReal   d;
+
+  PetscFunctionBegin;
+  for (i=0; i<n; i++) {
+    for (j=0; j<i; j++) {
+      t = g[i*ld+j];
+      for (k=0; k<j; k++) t -= PetscConj(g[j*ld+k])*g[i*ld+k];
+      g[i*ld+j] = t/g[j*ld+j];
+    }
+    d = PetscRealPart(g[i*ld+i]);
+    for (k=0; k<i; k++) d -= PetscRealPart(PetscConj(g[i*ld+k])*g[i*ld+k]);
+    if (!(d > tol[i])) break; /* also catches NaN */
+    g[i*ld+i] = PetscSqrtReal(d);
+  }
+  *nok = i;
+  PetscFunctionReturn(0);
+}
+
+/*
+   Generates VEC_VV(it+1:it+n) from VEC_VV(it) and fills the change of basis matrix BMAT.
+   Until the spectrum has been estimated, only the (scaled) monomial basis can be used.
+*/
+static PetscErrorCode KSPSGMRESMatrixPowers(KSP ksp,PetscInt it,PetscInt n)
+{
+  KSP_SGMRES         *sgmres = (KSP_SGMRES*)ksp->data;
+  KSPSGMRESBasisType basis = sgmres->havespectrum ? sgmres->basis : KSP_SGMRES_BASIS_MONOMIAL;
+  PetscReal          *sigma = sgmres->scale,c = sgmres->center,d = sgmres->halfwidth;
+  PetscInt           i;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscArrayzero(sgmres->bmat,(sgmres->s+1)*sgmres->s);CHKERRQ(ierr);
+  for (i=0; i<n; i++) {
+    Vec v = VEC_VV(it+i),w = VEC_VV(it+i+1);
+
+    ierr = KSP_PCApplyBAorAB(ksp,v,w,VEC_TEMP_MATOP);CHKERRQ(ierr);
+    switch (basis) {
+    case KSP_SGMRES_BASIS_MONOMIAL:
+      ierr = VecScale(w,1.0/sigma[i]);CHKERRQ(ierr);
+      BMAT(i+1,i) = sigma[i];
+      break;
+    case KSP_SGMRES_BASIS_NEWTON:
+#if defined(PETSC_USE_COMPLEX)
+      {
+        PetscScalar theta = PetscCMPLX(sgmres->sre[i],sgmres->sim[i]);
+
+        ierr = VecAXPBY(w,-theta/sigma[i],1.0/sigma[i],v);CHKERRQ(ierr);
+        BMAT(i,i) = theta;
+      }
+#else
+      /* complex conjugate shifts are stored consecutively, the positive imaginary part first; the pair
+         is applied in real arithmetic as (A - a I)^2 + b^2 I */
+      if (i && sgmres->sim[i] < 0.0) {
+        PetscReal a = sgmres->sre[i],b2 = sgmres->sim[i]*sgmres->sim[i];
+
+        ierr = VecAXPBYPCZ(w,-a/sigma[i],b2/(sigma[i-1]*sigma[i]),1.0/sigma[i],v,VEC_VV(it+i-1));CHKERRQ(ierr);
+        BMAT(i,i)   = a;
+        BMAT(i-1,i) = -b2/sigma[i-1];
+      } else {
+        ierr = VecAXPBY(w,-sgmres->sre[i]/sigma[i],1.0/sigma[i],v);CHKERRQ(ierr);
+        BMAT(i,i) = sgmres->sre[i];
+      }
+#endif
+      BMAT(i+1,i) = sigma[i];
+      break;
+    case KSP_SGMRES_BASIS_CHEBYSHEV:
+      /* Chebyshev polynomials of the first kind scaled to the interval [c - d, c + d] */
+      if (!i) {
+        ierr = VecAXPBY(w,-c/d,1.0/d,v);CHKERRQ(ierr);
+        BMAT(0,0) = c;
+        BMAT(1,0) = d;
+      } else {
+        ierr = VecAXPBYPCZ(w,-2.0*c/d,-1.0,2.0/d,v,VEC_VV(it+i-1));CHKERRQ(ierr);
+        BMAT(i-1,i) = 0.5*d;
+        BMAT(i,i)   = c;
+        BMAT(i+1,i) = 0.5*d;
+      }
+      break;
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   Inner products of the block W = VEC_VV(it+1:it+n) with [Q W], Q = VEC_VV(0:it), in a single reduction.
+   DOTS(k,i) = q_k^H w_i and DOTS(it+1+l,i) = w_l^H w_i
+*/
+static PetscErrorCode KSPSGMRESBlockDots(KSP ksp,PetscInt it,PetscInt n)
+{
+  KSP_SGMRES     *sgmres = (KSP_SGMRES*)ksp->data;
+  PetscInt       i;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  for (i=0; i<n; i++) {
+    ierr = VecMDotBegin(VEC_VV(it+1+i),it+1+n,&VEC_VV(0),&DOTS(0,i));CHKERRQ(ierr);
+  }
+  ierr = PetscCommSplitReductionBegin(PetscObjectComm((PetscObject)VEC_VV(0)));CHKERRQ(ierr);
+  for (i=0; i<n; i++) {
+    ierr = VecMDotEnd(VEC_VV(it+1+i),it+1+n,&VEC_VV(0),&DOTS(0,i));CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   W(:,0:n-1) <- (W - Q C) R^{-1}, column by column with one VecMAXPY() each
+*/
+static PetscErrorCode KSPSGMRESBlockUpdate(KSP ksp,PetscInt it,PetscInt n,const PetscScalar *c,const PetscScalar *r)
+{
+  KSP_SGMRES     *sgmres = (KSP_SGMRES*)ksp->data;
+  PetscScalar    *coef = sgmres->orthogwork;
+  PetscInt       i,k,ldc = sgmres->max_k+1,ldr = sgmres->s;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  for (i=0; i<n; i++) {
+    for (k=0; k<=it; k++) coef[k] = -c[i*ldc+k];
+    for (k=0; k<i; k++) coef[it+1+k] = -r[i*ldr+k];
+    ierr = VecMAXPY(VEC_VV(it+1+i),it+1+i,coef,&VEC_VV(0));CHKERRQ(ierr);
+    ierr = VecScale(VEC_VV(it+1+i),1.0/r[i*ldr+i]);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   Projection coefficients C = Q^H W and Gram matrix G = W^H W - C^H C of the projected block from DOTS
+*/
+static PetscErrorCode KSPSGMRESBlockGram(KSP ksp,PetscInt it,PetscInt n,PetscScalar *c,PetscScalar *g)
+{
+  KSP_SGMRES  *sgmres = (KSP_SGMRES*)ksp->data;
+  PetscInt    i,l,k,ldc = sgmres->max_k+1,ldr = sgmres->s;
+  PetscScalar t;
+
+  PetscFunctionBegin;
+  for (i=0; i<n; i++) {
+    for (k=0; k<=it; k++) c[i*ldc+k] = DOTS(k,i);
+    for (l=0; l<=i; l++) {
+      t = DOTS(it+1+l,i);
+      for (k=0; k<=it; k++) t -= PetscConj(c[l*ldc+k])*c[i*ldc+k];
+      g[i*ldr+l] = t;
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   Orthogonalizes W = VEC_VV(it+1:it+n) against Q = VEC_VV(0:it) and among itself, so that W = Q CMAT + W_new RMAT.
+
+   The first pass uses the Cholesky QR only if the Gram matrix is accurate enough, the second pass
+   stops at the first column that is numerically dependent on the previous ones: nok is the number of
+   new basis vectors that can be used. hapend is set if the first new vector is in the span of Q.
+*/
+static PetscErrorCode KSPSGMRESBlockOrthogonalize(KSP ksp,PetscInt it,PetscInt n,PetscInt *nok,PetscBool *hapend)
+{
+  KSP_SGMRES     *sgmres = (KSP_SGMRES*)ksp->data;
+  PetscInt       i,j,l,k,nok1,ldr = sgmres->s;
+  PetscReal      *ptol = sgmres->pivtol,tt,hapbnd;
+  PetscScalar    t;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  *hapend = PETSC_FALSE;
+
+  /* first pass: C1 = Q^H W, W <- (W - Q C1) R1^{-1} */
+  ierr = KSPSGMRESBlockDots(ksp,it,n);CHKERRQ(ierr);
+  for (i=0; i<n; i++) {
+    sgmres->rawnorm[i] = PetscSqrtReal(PetscAbsScalar(DOTS(it+1+i,i)));
+    ptol[i] = PETSC_SQRT_MACHINE_EPSILON*PetscRealPart(DOTS(it+1+i,i));
+  }
+  ierr = KSPSGMRESBlockGram(ksp,it,n,sgmres->cmat,sgmres->rmat);CHKERRQ(ierr);
+  ierr = KSPSGMRESCholesky(n,sgmres->rmat,ldr,ptol,&nok1);CHKERRQ(ierr);
+  if (nok1 < n) { /* the Gram matrix computed from the unprojected block is not accurate, only project */
+    ierr = PetscArrayzero(sgmres->rmat,ldr*ldr);CHKERRQ(ierr);
+    for (i=0; i<n; i++) RMAT(i,i) = 1.0;
+  }
+  ierr = KSPSGMRESBlockUpdate(ksp,it,n,sgmres->cmat,sgmres->rmat);CHKERRQ(ierr);
+
+  /* second pass: C2 = Q^H W, W <- (W - Q C2) R2^{-1} */
+  ierr = KSPSGMRESBlockDots(ksp,it,n);CHKERRQ(ierr);
+  ptol[0] = 0.0;
+  for (i=1; i<n; i++) ptol[i] = PETSC_SQRT_MACHINE_EPSILON*PetscRealPart(DOTS(it+1+i,i));
+  ierr = KSPSGMRESBlockGram(ksp,it,n,sgmres->cmat2,sgmres->rmat2);CHKERRQ(ierr);
+  ierr = KSPSGMRESCholesky(n,sgmres->rmat2,ldr,ptol,nok);CHKERRQ(ierr);
+
+  /* check for the happy breakdown on the first new vector, as KSPGMRES does */
+  tt = *nok ? PetscRealPart(RMAT2(0,0)*RMAT(0,0)) : 0.0;
+  hapbnd = PetscAbsScalar(tt / *GRS(it));
+  if (hapbnd > sgmres->haptol) hapbnd = sgmres->haptol;
+  if (!*nok || tt < hapbnd) {
+    ierr = PetscInfo2(ksp,"Detected happy breakdown, current hapbnd = %14.12e tt = %14.12e\n",(double)hapbnd,(double)tt);CHKERRQ(ierr);
+    *hapend     = PETSC_TRUE;
+    *nok        = 1;
+    RMAT2(0,0)  = RMAT(0,0) != 0.0 ? tt/RMAT(0,0) : 0.0;
+  } else {
+    ierr = KSPSGMRESBlockUpdate(ksp,it,*nok,sgmres->cmat2,sgmres->rmat2);CHKERRQ(ierr);
+  }
+
+  /* W = Q (C1 + C2 R1) + W_new R2 R1 */
+  for (i=0; i<*nok; i++) {
+    for (l=0; l<=i; l++) {
+      t = RMAT(l,i);
+      for (k=0; k<=it; k++) CMAT(k,i) += CMAT2(k,l)*t;
+    }
+    for (j=0; j<=i; j++) {
+      t = 0.0;
+      for (l=j; l<=i; l++) t += RMAT2(j,l)*RMAT(l,i);
+      RMAT(j,i) = t;
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   Computes the columns it:it+n-1 of the Hessenberg matrix. With V = [q_it W] = Q Rhat, where Rhat(:,0) = e_it and
+   Rhat(:,l) = [CMAT(:,l-1); RMAT(:,l-1)], the relation A V(:,0:n-1) = V BMAT gives
+      A Q(:,it:it+n-1) T = Q (Rhat BMAT - H(:,0:it-1) X)
+   where X = Rhat(0:it-1,0:n-1) and T = Rhat(it:it+n-1,0:n-1) is upper triangular.
+*/
+static PetscErrorCode KSPSGMRESBlockHessenberg(KSP ksp,PetscInt it,PetscInt n)
+{
+  KSP_SGMRES  *sgmres = (KSP_SGMRES*)ksp->data;
+  PetscInt    i,l,r,b;
+  PetscScalar *hes,t;
+
+  PetscFunctionBegin;
+  for (i=0; i<n; i++) {
+    hes = HES(0,it+i);
+    for (r=0; r<=it+i+1; r++) hes[r] = 0.0;
+    /* Rhat BMAT */
+    hes[it] += BMAT(0,i);
+    for (l=1; l<=i+1; l++) {
+      t = BMAT(l,i);
+      if (t == 0.0) continue;
+      for (r=0; r<=it; r++) hes[r] += CMAT(r,l-1)*t;
+      for (r=0; r<l; r++) hes[it+1+r] += RMAT(r,l-1)*t;
+    }
+    /* - H X */
+    if (i) {
+      for (b=0; b<it; b++) {
+        t = CMAT(b,i-1);
+        for (r=0; r<=b+1; r++) hes[r] -= *HES(r,b)*t;
+      }
+    }
+    /* T^{-1} */
+    for (l=0; l<i; l++) {
+      t = l ? RMAT(l-1,i-1) : CMAT(it,i-1);
+      for (r=0; r<=it+l+1; r++) hes[r] -= *HES(r,it+l)*t;
+    }
+    if (i) {
+      t = RMAT(i-1,i-1);
+      for (r=0; r<=it+i+1; r++) hes[r] /= t;
+    }
+    for (r=0; r<=it+i+1; r++) *HH(r,it+i) = hes[r];
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   Applies the plane rotations to the column it of the Hessenberg matrix and returns the new residual norm,
+   identical to the KSPGMRES version
+*/
+static PetscErrorCode KSPSGMRESUpdateHessenberg(KSP ksp,PetscInt it,PetscBool hapend,PetscReal *res)
+{
+  KSP_SGMRES  *sgmres = (KSP_SGMRES*)(ksp->data);
+  PetscScalar *hh,*cc,*ss,tt;
+  PetscInt    j;
+
+  PetscFunctionBegin;
+  hh = HH(0,it);
+  cc = CC(0);
+  ss = SS(0);
+
+  /* Apply all the previously computed plane rotations to the new column of the Hessenberg matrix */
+  for (j=1; j<=it; j++) {
+    tt  = *hh;
+    *hh = PetscConj(*cc) * tt + *ss * *(hh+1);
+    hh++;
+    *hh = *cc++ * *hh - (*ss++ * tt);
+  }
+
+  if (!hapend) {
+    tt = PetscSqrtScalar(PetscConj(*hh) * *hh + PetscConj(*(hh+1)) * *(hh+1));
+    if (tt == 0.0) {
+      if (ksp->errorifnotconverged) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_NOT_CONVERGED,"tt == 0.0");
+      else {
+        ksp->reason = KSP_DIVERGED_NULL;
+        PetscFunctionReturn(0);
+      }
+    }
+    *cc        = *hh / tt;
+    *ss        = *(hh+1) / tt;
+    *GRS(it+1) = -(*ss * *GRS(it));
+    *GRS(it)   = PetscConj(*cc) * *GRS(it);
+    *hh        = PetscConj(*cc) * *hh + *ss * *(hh+1);
+    *res       = PetscAbsScalar(*GRS(it+1));
+  } else *res = 0.0;
+  PetscFunctionReturn(0);
+}
+
+/*
+   Adapts the scaling of the monomial and Newton bases so that the basis vectors of the next blocks have about unit norm
+*/
+static PetscErrorCode KSPSGMRESUpdateScaling(KSP ksp,PetscInt n)
+{
+  KSP_SGMRES *sgmres = (KSP_SGMRES*)ksp->data;
+  PetscInt   i;
+  PetscReal  ratio;
+
+  PetscFunctionBegin;
+  if (sgmres->basis == KSP_SGMRES_BASIS_CHEBYSHEV) PetscFunctionReturn(0);
+  if (!sgmres->havespectrum && sgmres->basis != KSP_SGMRES_BASIS_MONOMIAL) PetscFunctionReturn(0); /* s = 1 cycle used to estimate the spectrum */
+  for (i=0; i<n; i++) {
+    ratio = i ? sgmres->rawnorm[i]/sgmres->rawnorm[i-1] : sgmres->rawnorm[0];
+    if (ratio > 0.0 && !PetscIsInfOrNanReal(ratio)) sgmres->scale[i] *= ratio;
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSGMRESCycle(PetscInt *itcount,KSP ksp)
+{
+  KSP_SGMRES     *sgmres = (KSP_SGMRES*)(ksp->data);
+  PetscReal      res;
+  PetscErrorCode ierr;
+  PetscInt       it = 0,max_k = sgmres->max_k,n,nok,i;
+  PetscBool      hapend = PETSC_FALSE;
+
+  PetscFunctionBegin;
+  if (itcount) *itcount = 0;
+  ierr     = VecNormalize(VEC_VV(0),&res);CHKERRQ(ierr);
+  KSPCheckNorm(ksp,res);
+  *GRS(0)  = res;
+
+  /* check for the convergence */
+  ierr       = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+  ksp->rnorm = res;
+  ierr       = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+  sgmres->it = (it - 1);
+  ierr = KSPLogResidualHistory(ksp,res);CHKERRQ(ierr);
+  ierr = KSPMonitor(ksp,ksp->its,res);CHKERRQ(ierr);
+  if (!res) {
+    ksp->reason = KSP_CONVERGED_ATOL;
+    ierr        = PetscInfo(ksp,"Converged due to zero residual norm on entry\n");CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+
+  ierr = (*ksp->converged)(ksp,ksp->its,res,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
+  while (!ksp->reason && it < max_k && ksp->its < ksp->max_it) {
+    n = (sgmres->havespectrum || sgmres->basis == KSP_SGMRES_BASIS_MONOMIAL) ? sgmres->s : 1;
+    n = PetscMin(n,max_k - it);
+    n = PetscMin(n,ksp->max_it - ksp->its);
+    while (sgmres->vv_allocated <= it + n + VEC_OFFSET) {
+      ierr = KSPGMRESGetNewVectors(ksp,sgmres->vv_allocated - VEC_OFFSET);CHKERRQ(ierr);
+    }
+
+    ierr = KSPSGMRESMatrixPowers(ksp,it,n);CHKERRQ(ierr);
+    ierr = KSPSGMRESBlockOrthogonalize(ksp,it,n,&nok,&hapend);CHKERRQ(ierr);
+    if (!hapend) {ierr = KSPSGMRESUpdateScaling(ksp,n);CHKERRQ(ierr);}
+    ierr = KSPSGMRESBlockHessenberg(ksp,it,nok);CHKERRQ(ierr);
+    if (nok < n) {
+      ierr = PetscInfo2(ksp,"Only %D of the %D basis vectors of the block are linearly independent\n",nok,n);CHKERRQ(ierr);
+    }
+
+    /* the residual norms of all the steps of the block are now available */
+    for (i=0; i<nok; i++) {
+      ierr = KSPSGMRESUpdateHessenberg(ksp,it,hapend,&res);CHKERRQ(ierr);
+      it++;
+      sgmres->it = (it-1);   /* For converged */
+      ksp->its++;
+      ksp->rnorm = res;
+      if (ksp->reason) break;
+
+      ierr = (*ksp->converged)(ksp,ksp->its,res,&ksp->reason,ksp->cnvP);CHKERRQ(ierr);
+
+      /* Catch error in happy breakdown and signal convergence and break from loop */
+      if (hapend) {
+        if (ksp->normtype == KSP_NORM_NONE) { /* convergence test was skipped in this case */
+          ksp->reason = KSP_CONVERGED_HAPPY_BREAKDOWN;
+        } else if (!ksp->reason) {
+          if (ksp->errorifnotconverged) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_NOT_CONVERGED,"You reached the happy break down, but convergence was not indicated. Residual norm = %g",(double)res);
+          else ksp->reason = KSP_DIVERGED_BREAKDOWN;
+        }
+      }
+      if (ksp->reason) break;
+      if (it < max_k && ksp->its < ksp->max_it) {
+        ierr = KSPLogResidualHistory(ksp,res);CHKERRQ(ierr);
+        ierr = KSPMonitor(ksp,ksp->its,res);CHKERRQ(ierr);
+      }
+    }
+  }
+
+  /* Monitor if we know that we will not return for a restart */
+  if (it && (ksp->reason || ksp->its >= ksp->max_it)) {
+    ierr = KSPLogResidualHistory(ksp,res);CHKERRQ(ierr);
+    ierr = KSPMonitor(ksp,ksp->its,res);CHKERRQ(ierr);
+  }
+
+  if (itcount) *itcount = it;
+
+  /* Form the solution (or the solution so far) */
+  ierr = KSPBuildSolution_GMRES(ksp,ksp->vec_sol,NULL);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Orders the n values (re,im) in Leja order and keeps the first s of them. For real scalars, complex conjugate
+   pairs are kept together, the one with the positive imaginary part first.
+*/
+static PetscErrorCode KSPSGMRESLejaOrder(PetscInt n,const PetscReal *re,const PetscReal *im,PetscInt s,PetscReal *sre,PetscReal *sim)
+{
+  PetscBool      *used;
+  PetscInt       i,j,k = 0,best;
+  PetscReal      w,wbest = 0.0;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscCalloc1(n,&used);CHKERRQ(ierr);
+  while (k < s) {
+    best = -1;
+    for (i=0; i<n; i++) {
+      if (used[i]) continue;
+#if !defined(PETSC_USE_COMPLEX)
+      if (im[i] < 0.0) continue;
+#endif
+      if (!k) w = PetscSqrtReal(re[i]*re[i] + im[i]*im[i]);
+      else {
+        for (w=0.0,j=0; j<k; j++) w += PetscLogReal(PetscSqrtReal((re[i]-sre[j])*(re[i]-sre[j]) + (im[i]-sim[j])*(im[i]-sim[j])));
+      }
+      if (best < 0 || w > wbest) {best = i; wbest = w;}
+    }
+    if (best < 0) { /* fewer Ritz values than s, reuse them */
+      ierr = PetscArrayzero(used,n);CHKERRQ(ierr);
+      continue;
+    }
+    used[best] = PETSC_TRUE;
+    sre[k]     = re[best];
+    sim[k++]   = im[best];
+#if !defined(PETSC_USE_COMPLEX)
+    if (sim[k-1] > 0.0) {
+      if (k < s) {
+        sre[k] = sre[k-1];
+        sim[k] = -sim[k-1];
+        k++;
+      } else sim[k-1] = 0.0; /* no room left for the conjugate, only use the real part */
+    }
+#endif
+  }
+  ierr = PetscFree(used);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Computes the Newton shifts or the Chebyshev interval from the Ritz values of the last cycle
+*/
+static PetscErrorCode KSPSGMRESComputeSpectrum(KSP ksp)
+{
+  KSP_SGMRES     *sgmres = (KSP_SGMRES*)ksp->data;
+  PetscInt       n = sgmres->it + 1,neig,i;
+  PetscReal      *re,*im,emin,emax;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (n < 1) PetscFunctionReturn(0);
+  ierr = PetscMalloc2(n,&re,n,&im);CHKERRQ(ierr);
+  ierr = KSPComputeEigenvalues_GMRES(ksp,n,re,im,&neig);CHKERRQ(ierr);
+  if (sgmres->basis == KSP_SGMRES_BASIS_NEWTON) {
+    ierr = KSPSGMRESLejaOrder(neig,re,im,sgmres->s,sgmres->sre,sgmres->sim);CHKERRQ(ierr);
+    ierr = PetscInfo3(ksp,"Newton basis from %D Ritz values, first shift %g + %g i\n",neig,(double)sgmres->sre[0],(double)sgmres->sim[0]);CHKERRQ(ierr);
+  } else {
+    emin = emax = re[0];
+    for (i=1; i<neig; i++) {
+      emin = PetscMin(emin,re[i]);
+      emax = PetscMax(emax,re[i]);
+    }
+    sgmres->center    = 0.5*(emax + emin);
+    sgmres->halfwidth = 0.5*(emax - emin);
+    if (sgmres->halfwidth <= PETSC_SQRT_MACHINE_EPSILON*PetscAbsReal(sgmres->center)) sgmres->halfwidth = sgmres->center ? 0.5*PetscAbsReal(sgmres->center) : 1.0;
+    ierr = PetscInfo2(ksp,"Chebyshev basis on the interval [%g, %g]\n",(double)(sgmres->center-sgmres->halfwidth),(double)(sgmres->center+sgmres->halfwidth));CHKERRQ(ierr);
+  }
+  for (i=0; i<sgmres->s; i++) sgmres->scale[i] = 1.0;
+  ierr = PetscFree2(re,im);CHKERRQ(ierr);
+  sgmres->havespectrum = PETSC_TRUE;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSolve_SGMRES(KSP ksp)
+{
+  PetscErrorCode   ierr;
+  PetscInt         its,itcount,i;
+  KSP_SGMRES       *sgmres     = (KSP_SGMRES*)ksp->data;
+  PetscBool        guess_zero = ksp->guess_zero;
+  Mat              Amat,Pmat;
+  PetscObjectId    id;
+  PetscObjectState state;
+
+  PetscFunctionBegin;
+  if (ksp->calc_sings && !sgmres->Rsvd) SETERRQ(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ORDER,"Must call KSPSetComputeSingularValues() before KSPSetUp() is called");
+  ierr = PetscCitationsRegister(citation,&cited);CHKERRQ(ierr);
+
+  /* the spectrum estimate is kept as long as the operator does not change */
+  ierr = PCGetOperators(ksp->pc,&Amat,&Pmat);CHKERRQ(ierr);
+  ierr = PetscObjectGetId((PetscObject)Amat,&id);CHKERRQ(ierr);
+  ierr = PetscObjectStateGet((PetscObject)Amat,&state);CHKERRQ(ierr);
+  if (id != sgmres->matid || state != sgmres->matstate) {
+    sgmres->havespectrum = PETSC_FALSE;
+    sgmres->matid        = id;
+    sgmres->matstate     = state;
+    for (i=0; i<sgmres->s; i++) sgmres->scale[i] = 1.0;
+  }
+
+  ierr     = PetscObjectSAWsTakeAccess((PetscObject)ksp);CHKERRQ(ierr);
+  ksp->its = 0;
+  ierr     = PetscObjectSAWsGrantAccess((PetscObject)ksp);CHKERRQ(ierr);
+
+  itcount     = 0;
+  ksp->reason = KSP_CONVERGED_ITERATING;
+  while (!ksp->reason) {
+    ierr     = KSPInitialResidual(ksp,ksp->vec_sol,VEC_TEMP,VEC_TEMP_MATOP,VEC_VV(0),ksp->vec_rhs);CHKERRQ(ierr);
+    ierr     = KSPSGMRESCycle(&its,ksp);CHKERRQ(ierr);
+    if (!sgmres->havespectrum && sgmres->basis != KSP_SGMRES_BASIS_MONOMIAL && its) {
+      ierr = KSPSGMRESComputeSpectrum(ksp);CHKERRQ(ierr);
+    }
+    itcount += its;
+    if (itcount >= ksp->max_it) {
+      if (!ksp->reason) ksp->reason = KSP_DIVERGED_ITS;
+      break;
+    }
+    ksp->guess_zero = PETSC_FALSE; /* every future call to KSPInitialResidual() will have nonzero guess */
+  }
+  ksp->guess_zero = guess_zero; /* restore if user provided nonzero initial guess */
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPReset_SGMRES(KSP ksp)
+{
+  KSP_SGMRES     *sgmres = (KSP_SGMRES*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree5(sgmres->sre,sgmres->sim,sgmres->scale,sgmres->rawnorm,sgmres->pivtol);CHKERRQ(ierr);
+  ierr = PetscFree6(sgmres->bmat,sgmres->dots,sgmres->cmat,sgmres->cmat2,sgmres->rmat,sgmres->rmat2);CHKERRQ(ierr);
+  sgmres->havespectrum = PETSC_FALSE;
+  ierr = KSPReset_GMRES(ksp);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPDestroy_SGMRES(KSP ksp)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPSGMRESSetSteps_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPSGMRESGetSteps_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPSGMRESSetBasisType_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPSGMRESGetBasisType_C",NULL);CHKERRQ(ierr);
+  ierr = KSPReset_SGMRES(ksp);CHKERRQ(ierr);
+  ierr = KSPDestroy_GMRES(ksp);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPView_SGMRES(KSP ksp,PetscViewer viewer)
+{
+  KSP_SGMRES     *sgmres = (KSP_SGMRES*)ksp->data;
+  PetscErrorCode ierr;
+  PetscBool      iascii,isstring;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERSTRING,&isstring);CHKERRQ(ierr);
+  if (iascii) {
+    ierr = PetscViewerASCIIPrintf(viewer,"  restart=%D, s=%D, using %s basis\n",sgmres->max_k,sgmres->s,KSPSGMRESBasisTypes[sgmres->basis]);CHKERRQ(ierr);
+    ierr = PetscViewerASCIIPrintf(viewer,"  happy breakdown tolerance %g\n",(double)sgmres->haptol);CHKERRQ(ierr);
+  } else if (isstring) {
+    ierr = PetscViewerStringSPrintf(viewer,"restart %D s %D %s basis",sgmres->max_k,sgmres->s,KSPSGMRESBasisTypes[sgmres->basis]);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSetFromOptions_SGMRES(PetscOptionItems *PetscOptionsObject,KSP ksp)
+{
+  KSP_SGMRES         *sgmres = (KSP_SGMRES*)ksp->data;
+  PetscInt           s;
+  KSPSGMRESBasisType basis;
+  PetscBool          flg;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  ierr = KSPSetFromOptions_GMRES(PetscOptionsObject,ksp);CHKERRQ(ierr);
+  ierr = PetscOptionsHead(PetscOptionsObject,"KSP s-step GMRES Options");CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-ksp_sgmres_steps","Number of basis vectors generated between two block orthogonalizations","KSPSGMRESSetSteps",sgmres->s,&s,&flg);CHKERRQ(ierr);
+  if (flg) {ierr = KSPSGMRESSetSteps(ksp,s);CHKERRQ(ierr);}
+  ierr = PetscOptionsEnum("-ksp_sgmres_basis_type","Polynomial used to generate the basis","KSPSGMRESSetBasisType",KSPSGMRESBasisTypes,(PetscEnum)sgmres->basis,(PetscEnum*)&basis,&flg);CHKERRQ(ierr);
+  if (flg) {ierr = KSPSGMRESSetBasisType(ksp,basis);CHKERRQ(ierr);}
+  ierr = PetscOptionsTail();CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSGMRESSetSteps_SGMRES(KSP ksp,PetscInt s)
+{
+  KSP_SGMRES     *sgmres = (KSP_SGMRES*)ksp->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (s < 1) SETERRQ1(PetscObjectComm((PetscObject)ksp),PETSC_ERR_ARG_OUTOFRANGE,"Number of steps %D must be positive",s);
+  if (!ksp->setupstage) {
+    sgmres->s = s;
+  } else if (sgmres->s != s) {
+    sgmres->s       = s;
+    ksp->setupstage = KSP_SETUP_NEW;
+    /* free the data structures, then create them again */
+    ierr = KSPReset_SGMRES(ksp);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSGMRESGetSteps_SGMRES(KSP ksp,PetscInt *s)
+{
+  PetscFunctionBegin;
+  *s = ((KSP_SGMRES*)ksp->data)->s;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSGMRESSetBasisType_SGMRES(KSP ksp,KSPSGMRESBasisType basis)
+{
+  KSP_SGMRES *sgmres = (KSP_SGMRES*)ksp->data;
+
+  PetscFunctionBegin;
+  if (sgmres->basis != basis) sgmres->havespectrum = PETSC_FALSE;
+  sgmres->basis = basis;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode KSPSGMRESGetBasisType_SGMRES(KSP ksp,KSPSGMRESBasisType *basis)
+{
+  PetscFunctionBegin;
+  *basis = ((KSP_SGMRES*)ksp->data)->basis;
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPSGMRESSetSteps - Sets the number of basis vectors generated between two block orthogonalizations of KSPSGMRES
+
+   Logically Collective on ksp
+
+   Input Parameters:
++  ksp - the Krylov space context
+-  s - the number of steps, defaults to 5
+
+   Options Database Key:
+.  -ksp_sgmres_steps <s> - the number of steps
+
+   Notes:
+   The number of global reductions is divided by s with respect to KSPGMRES, but the basis becomes more
+   ill-conditioned as s increases; values larger than 10 usually require the Newton or Chebyshev basis
+   and may still lead to blocks being truncated.
+
+   Level: intermediate
+
+.seealso: KSPSGMRES, KSPSGMRESGetSteps(), KSPSGMRESSetBasisType(), KSPGMRESSetRestart()
+@*/
+PetscErrorCode KSPSGMRESSetSteps(KSP ksp,PetscInt s)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidLogicalCollectiveInt(ksp,s,2);
+  ierr = PetscTryMethod(ksp,"KSPSGMRESSetSteps_C",(KSP,PetscInt),(ksp,s));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPSGMRESGetSteps - Gets the number of basis vectors generated between two block orthogonalizations of KSPSGMRES
+
+   Not Collective
+
+   Input Parameter:
+.  ksp - the Krylov space context
+
+   Output Parameter:
+.  s - the number of steps
+
+   Level: intermediate
+
+.seealso: KSPSGMRES, KSPSGMRESSetSteps()
+@*/
+PetscErrorCode KSPSGMRESGetSteps(KSP ksp,PetscInt *s)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidIntPointer(s,2);
+  ierr = PetscUseMethod(ksp,"KSPSGMRESGetSteps_C",(KSP,PetscInt*),(ksp,s));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPSGMRESSetBasisType - Sets the polynomial used by KSPSGMRES to generate the basis vectors of a block
+
+   Logically Collective on ksp
+
+   Input Parameters:
++  ksp - the Krylov space context
+-  basis - KSP_SGMRES_BASIS_NEWTON (the default), KSP_SGMRES_BASIS_CHEBYSHEV or KSP_SGMRES_BASIS_MONOMIAL
+
+   Options Database Key:
+.  -ksp_sgmres_basis_type <newton,chebyshev,monomial> - the basis
+
+   Notes:
+   The Newton and Chebyshev bases need an estimate of the spectrum of the preconditioned operator,
+   the first restart cycle of each solve with a new operator is run with s = 1 to compute its Ritz values.
+
+   Level: intermediate
+
+.seealso: KSPSGMRES, KSPSGMRESGetBasisType(), KSPSGMRESSetSteps(), KSPSGMRESBasisType
+@*/
+PetscErrorCode KSPSGMRESSetBasisType(KSP ksp,KSPSGMRESBasisType basis)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidLogicalCollectiveEnum(ksp,basis,2);
+  ierr = PetscTryMethod(ksp,"KSPSGMRESSetBasisType_C",(KSP,KSPSGMRESBasisType),(ksp,basis));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPSGMRESGetBasisType - Gets the polynomial used by KSPSGMRES to generate the basis vectors of a block
+
+   Not Collective
+
+   Input Parameter:
+.  ksp - the Krylov space context
+
+   Output Parameter:
+.  basis - the basis type
+
+   Level: intermediate
+
+.seealso: KSPSGMRES, KSPSGMRESSetBasisType()
+@*/
+PetscErrorCode KSPSGMRESGetBasisType(KSP ksp,KSPSGMRESBasisType *basis)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidPointer(basis,2);
+  ierr = PetscUseMethod(ksp,"KSPSGMRESGetBasisType_C",(KSP,KSPSGMRESBasisType*),(ksp,basis));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*MC
+   KSPSGMRES - Implements an s-step (communication-avoiding) variant of the Generalized Minimal Residual method.
+
+   Each block of s iterations first generates s basis vectors with s applications of the preconditioned operator,
+   then orthogonalizes them with two passes of block classical Gram-Schmidt and a Cholesky QR of the block, whose inner
+   products are all computed with a single reduction per pass. This divides the number of global reductions by s with
+   respect to KSPGMRES, at the price of a slightly larger number of local vector operations.
+
+   Options Database Keys:
++   -ksp_gmres_restart <restart> - the number of Krylov directions to orthogonalize against
+.   -ksp_gmres_haptol <tol> - sets the tolerance for "happy ending" (exact convergence)
+.   -ksp_gmres_preallocate - preallocate all the Krylov search directions initially (otherwise groups of
+                             vectors are allocated as needed)
+.   -ksp_sgmres_steps <s> - the number of basis vectors generated between two block orthogonalizations
+-   -ksp_sgmres_basis_type <newton,chebyshev,monomial> - the polynomial used to generate the basis
+
+   Level: intermediate
+
+   Notes:
+   Left and right preconditioning are supported, but not symmetric preconditioning. The residual norm, and thus the
+   convergence test and the monitors, are available for every step of a block but only after the whole block has been
+   orthogonalized, so up to s - 1 extra operator applications can be done at convergence.
+
+   The Newton and Chebyshev bases use the Ritz values of the first restart cycle, which is run with s = 1.
+   A block is truncated if its basis vectors are numerically linearly dependent, the solver then continues with the
+   remaining directions, see -info.
+
+   The operator is applied s times in a row with KSP_PCApplyBAorAB(), the matrix powers kernel only relies on MatMult()
+   and PCApply(), so it works with any matrix and preconditioner but does not reduce the neighbor communication.
+
+   Developer Notes:
+    This class is subclassed off of KSPGMRES, it reuses its Hessenberg matrix, least squares solve and eigenvalue estimates.
+
+   References:
++     1. - M. Hoemmen, Communication-avoiding Krylov subspace methods, PhD thesis, UC Berkeley, 2010.
+-     2. - Z. Bai, D. Hu and L. Reichel, A Newton basis GMRES implementation, IMA J. Numer. Anal. 14, 1994.
+
+.seealso:  KSPCreate(), KSPSetType(), KSPType (for list of available types), KSP, KSPGMRES, KSPPGMRES, KSPPIPEFGMRES,
+           KSPSGMRESSetSteps(), KSPSGMRESSetBasisType(), KSPGMRESSetRestart(), KSPGMRESSetHapTol()
+M*/
+
+PETSC_EXTERN PetscErrorCode KSPCreate_SGMRES(KSP ksp)
+{
+  KSP_SGMRES     *sgmres;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr      = PetscNewLog(ksp,&sgmres);CHKERRQ(ierr);
+  ksp->data = (void*)sgmres;
+
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_PRECONDITIONED,PC_LEFT,3);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_UNPRECONDITIONED,PC_RIGHT,2);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_NONE,PC_RIGHT,1);CHKERRQ(ierr);
+  ierr = KSPSetSupportedNorm(ksp,KSP_NORM_NONE,PC_LEFT,1);CHKERRQ(ierr);
+
+  ksp->ops->buildsolution                = KSPBuildSolution_GMRES;
+  ksp->ops->setup                        = KSPSetUp_SGMRES;
+  ksp->ops->solve                        = KSPSolve_SGMRES;
+  ksp->ops->reset                        = KSPReset_SGMRES;
+  ksp->ops->destroy                      = KSPDestroy_SGMRES;
+  ksp->ops->view                         = KSPView_SGMRES;
+  ksp->ops->setfromoptions               = KSPSetFromOptions_SGMRES;
+  ksp->ops->computeextremesingularvalues = KSPComputeExtremeSingularValues_GMRES;
+  ksp->ops->computeeigenvalues           = KSPComputeEigenvalues_GMRES;
+
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESSetPreAllocateVectors_C",KSPGMRESSetPreAllocateVectors_GMRES);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESSetRestart_C",KSPGMRESSetRestart_GMRES);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESGetRestart_C",KSPGMRESGetRestart_GMRES);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPGMRESSetHapTol_C",KSPGMRESSetHapTol_GMRES);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPSGMRESSetSteps_C",KSPSGMRESSetSteps_SGMRES);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPSGMRESGetSteps_C",KSPSGMRESGetSteps_SGMRES);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPSGMRESSetBasisType_C",KSPSGMRESSetBasisType_SGMRES);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)ksp,"KSPSGMRESGetBasisType_C",KSPSGMRESGetBasisType_SGMRES);CHKERRQ(ierr);
+
+  sgmres->haptol         = 1.0e-30;
+  sgmres->q_preallocate  = 0;
+  sgmres->delta_allocate = SGMRES_DELTA_DIRECTIONS;
+  sgmres->orthog         = NULL;
+  sgmres->nrs            = NULL;
+  sgmres->sol_temp       = NULL;
+  sgmres->max_k          = SGMRES_DEFAULT_MAXK;
+  sgmres->Rsvd           = NULL;
+  sgmres->cgstype        = KSP_GMRES_CGS_REFINE_NEVER;
+  sgmres->orthogwork     = NULL;
+  sgmres->s              = SGMRES_DEFAULT_S;
+  sgmres->basis          = KSP_SGMRES_BASIS_NEWTON;
+  PetscFunctionReturn(0);
+}
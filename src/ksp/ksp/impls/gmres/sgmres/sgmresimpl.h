@@ -0,0 +1,48 @@
+#if !defined(SGMRESIMPL_H)
+#define SGMRESIMPL_H
+
+#define KSPGMRES_NO_MACROS
+#include <../src/ksp/ksp/impls/gmres/gmresimpl.h>
+
+typedef struct {
+  KSPGMRESHEADER
+
+  /* s-step specific data */
+  PetscInt           s;                 /* number of basis vectors generated between two block orthogonalizations */
+  KSPSGMRESBasisType basis;             /* polynomial used to generate the basis */
+  PetscBool          havespectrum;      /* the Newton shifts or the Chebyshev interval have been estimated */
+  PetscObjectId      matid;             /* operator the spectrum was estimated for */
+  PetscObjectState   matstate;
+  PetscReal          *sre,*sim;         /* Leja ordered Ritz values used as shifts of the Newton basis */
+  PetscReal          *scale;            /* scaling of the basis vectors, adapted from block to block */
+  PetscReal          *rawnorm;          /* norms of the basis vectors before the orthogonalization */
+  PetscReal          *pivtol;           /* smallest acceptable pivots of the Cholesky factorization */
+  PetscReal          center,halfwidth;  /* interval of the Chebyshev basis */
+
+  /* dense work space of one block, stored by columns */
+  PetscScalar        *bmat;             /* change of basis matrix, A V(:,0:s-1) = V bmat, (s+1) x s */
+  PetscScalar        *dots;             /* inner products of the block against the basis, (max_k+s+1) x s */
+  PetscScalar        *cmat,*cmat2;      /* projection coefficients onto the previous basis, (max_k+1) x s */
+  PetscScalar        *rmat,*rmat2;      /* triangular factors of the block, s x s */
+} KSP_SGMRES;
+
+#define HH(a,b)  (sgmres->hh_origin + (b)*(sgmres->max_k+2)+(a))
+#define HES(a,b) (sgmres->hes_origin + (b)*(sgmres->max_k+1)+(a))
+#define CC(a)    (sgmres->cc_origin + (a))
+#define SS(a)    (sgmres->ss_origin + (a))
+#define GRS(a)   (sgmres->rs_origin + (a))
+
+#define BMAT(a,b)  sgmres->bmat[(b)*(sgmres->s+1)+(a)]
+#define DOTS(a,b)  sgmres->dots[(b)*(sgmres->max_k+sgmres->s+1)+(a)]
+#define CMAT(a,b)  sgmres->cmat[(b)*(sgmres->max_k+1)+(a)]
+#define CMAT2(a,b) sgmres->cmat2[(b)*(sgmres->max_k+1)+(a)]
+#define RMAT(a,b)  sgmres->rmat[(b)*sgmres->s+(a)]
+#define RMAT2(a,b) sgmres->rmat2[(b)*sgmres->s+(a)]
+
+/* vector names, identical to KSPGMRES so that its routines can be reused */
+#define VEC_OFFSET     2
+#define VEC_TEMP       sgmres->vecs[0]
+#define VEC_TEMP_MATOP sgmres->vecs[1]
+#define VEC_VV(i)      sgmres->vecs[VEC_OFFSET+i]
+
+#endif
@@ -74,8 +74,7 @@ static PetscErrorCode  KSPSolve_TFQMR(KSP ksp)
     ierr = VecWAXPY(Q,-a,V,U);CHKERRQ(ierr);  /* q <- u - a v         */
     ierr = VecWAXPY(T,1.0,U,Q);CHKERRQ(ierr);     /* t <- u + q           */
     ierr = KSP_PCApplyBAorAB(ksp,T,AUQ,T1);CHKERRQ(ierr);
-    ierr = VecAXPY(R,-a,AUQ);CHKERRQ(ierr);      /* r <- r - a K (u + q) */
-    ierr = VecNorm(R,NORM_2,&dp);CHKERRQ(ierr);
+    ierr = VecWAXPYNorm(R,-a,AUQ,R,&dp);CHKERRQ(ierr); /* r <- r - a K (u + q), dp <- ||r|| */
     KSPCheckNorm(ksp,dp);
     for (m=0; m<2; m++) {
       if (!m) w = PetscSqrtReal(dp*dpold);
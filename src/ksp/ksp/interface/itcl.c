@@ -442,6 +442,11 @@ PetscErrorCode  KSPSetFromOptions(KSP ksp)
     ierr = KSPSetLagNorm(ksp,flag);CHKERRQ(ierr);
   }
 
+  ierr = PetscOptionsBool("-ksp_overlap_reductions","Overlap reductions with preconditioner applications that may be unneeded","KSPSetOverlapReductions",ksp->overlapreductions,&flag,&flg);CHKERRQ(ierr);
+  if (flg) {
+    ierr = KSPSetOverlapReductions(ksp,flag);CHKERRQ(ierr);
+  }
+
   ierr = KSPGetDiagonalScale(ksp,&flag);CHKERRQ(ierr);
   ierr = PetscOptionsBool("-ksp_diagonal_scale","Diagonal scale matrix before building preconditioner","KSPSetDiagonalScale",flag,&flag,&flg);CHKERRQ(ierr);
   if (flg) {
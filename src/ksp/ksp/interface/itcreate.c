@@ -353,6 +353,69 @@ PetscErrorCode  KSPSetLagNorm(KSP ksp,PetscBool flg)
   PetscFunctionReturn(0);
 }
 
+/*@
+   KSPSetOverlapReductions - Starts the reductions of an iteration before applying the preconditioner (or operator)
+   that would otherwise only be applied once their results are known, so the communication overlaps that application.
+
+   Logically Collective on ksp
+
+   Input Parameter:
++  ksp - Krylov solver context
+-  flg - PETSC_TRUE or PETSC_FALSE
+
+   Options Database Keys:
+.  -ksp_overlap_reductions - overlap the reductions with the preconditioner application
+
+   Notes:
+   The application started during a reduction is wasted on the iteration that turns out to be the last one, and the
+   method may do extra local work to combine a reduction with one it may not need. Use this when reductions are
+   more expensive than preconditioner applications, that is on many processes.
+
+   Currently used by KSPCG with KSP_NORM_UNPRECONDITIONED, which applies the preconditioner while the residual norm
+   is reduced, and by KSPGMRES with KSP_GMRES_CGS_REFINE_IFNEEDED, which computes the inner products of the second
+   Gram-Schmidt pass together with the norm that decides if that pass is needed.
+
+   The reductions are started with PetscCommSplitReductionBegin() and progressed during the preconditioner and
+   operator applications with PetscCommSplitReductionProgress(). Since only one split reduction can be in progress
+   on a communicator, do not use this for a KSP inside the preconditioner of a pipelined method such as KSPPIPECG.
+
+   Level: advanced
+
+.seealso: KSPGetOverlapReductions(), KSPSetLagNorm(), PetscCommSplitReductionBegin(), PetscCommSplitReductionProgress()
+@*/
+PetscErrorCode  KSPSetOverlapReductions(KSP ksp,PetscBool flg)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidLogicalCollectiveBool(ksp,flg,2);
+  ksp->overlapreductions = flg;
+  PetscFunctionReturn(0);
+}
+
+/*@
+   KSPGetOverlapReductions - Gets the flag set with KSPSetOverlapReductions()
+
+   Not Collective
+
+   Input Parameter:
+.  ksp - Krylov solver context
+
+   Output Parameter:
+.  flg - PETSC_TRUE if the reductions are overlapped with the preconditioner application
+
+   Level: advanced
+
+.seealso: KSPSetOverlapReductions()
+@*/
+PetscErrorCode  KSPGetOverlapReductions(KSP ksp,PetscBool *flg)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp,KSP_CLASSID,1);
+  PetscValidBoolPointer(flg,2);
+  *flg = ksp->overlapreductions;
+  PetscFunctionReturn(0);
+}
+
 /*@
    KSPSetSupportedNorm - Sets a norm and preconditioner side supported by a KSP
 
@@ -1855,6 +1855,7 @@ PetscErrorCode KSPMonitor(KSP ksp,PetscInt it,PetscReal rnorm)
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
+  ierr = PetscLogTimelineMark("KSPIteration",it);CHKERRQ(ierr);
   for (i=0; i<n; i++) {
     ierr = (*ksp->monitor[i])(ksp,it,rnorm,ksp->monitorcontext[i]);CHKERRQ(ierr);
   }
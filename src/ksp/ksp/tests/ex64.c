@@ -0,0 +1,124 @@
+static char help[] = "Tests KSPMatSolve() with the block conjugate gradient of KSPCG against KSPSolve() column by column.\n\
+Input parameters include\n\
+  -m <m> : number of grid points in each direction\n\
+  -N <N> : number of right-hand sides\n\n";
+
+#include <petscksp.h>
+
+int main(int argc,char **args)
+{
+  Mat                A,B,X,R;
+  Vec                cb,cx;
+  KSP                ksp;
+  PetscInt           i,j,Ii,J,m = 8,N = 6,rstart,rend,its;
+  PetscScalar        v;
+  PetscReal          *norms,*bnorms,rtol,err = 0.0;
+  KSPConvergedReason reason;
+  PetscErrorCode     ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-N",&N,NULL);CHKERRQ(ierr);
+  if (N < 4) SETERRQ(PETSC_COMM_WORLD,PETSC_ERR_ARG_OUTOFRANGE,"Need at least 4 right-hand sides");
+
+  /* 2d Laplacian with a variable coefficient on the diagonal so that Jacobi is not a plain scaling */
+  ierr = MatCreateAIJ(PETSC_COMM_WORLD,PETSC_DECIDE,PETSC_DECIDE,m*m,m*m,5,NULL,5,NULL,&A);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(A,&rstart,&rend);CHKERRQ(ierr);
+  for (Ii=rstart; Ii<rend; Ii++) {
+    i = Ii/m; j = Ii - i*m; v = -1.0;
+    if (i>0)   {J = Ii - m; ierr = MatSetValues(A,1,&Ii,1,&J,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    if (i<m-1) {J = Ii + m; ierr = MatSetValues(A,1,&Ii,1,&J,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    if (j>0)   {J = Ii - 1; ierr = MatSetValues(A,1,&Ii,1,&J,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    if (j<m-1) {J = Ii + 1; ierr = MatSetValues(A,1,&Ii,1,&J,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    v = 4.0 + (Ii%5); ierr = MatSetValues(A,1,&Ii,1,&Ii,&v,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatSetOption(A,MAT_SPD,PETSC_TRUE);CHKERRQ(ierr);
+
+  /* the third column is the sum of the first two and the fourth one is zero, the block is rank deficient */
+  ierr = MatCreateDense(PETSC_COMM_WORLD,rend-rstart,PETSC_DECIDE,m*m,N,NULL,&B);CHKERRQ(ierr);
+  ierr = MatCreateDense(PETSC_COMM_WORLD,rend-rstart,PETSC_DECIDE,m*m,N,NULL,&X);CHKERRQ(ierr);
+  for (Ii=rstart; Ii<rend; Ii++) {
+    for (j=0; j<N; j++) {
+      if (j == 2) v = (Ii*7)%17 - 8.0 + (Ii*7+13)%17 - 8.0;
+      else if (j == 3) v = 0.0;
+      else v = (Ii*7+j*13)%17 - 8.0;
+      ierr = MatSetValues(B,1,&Ii,1,&j,&v,INSERT_VALUES);CHKERRQ(ierr);
+    }
+  }
+  ierr = MatAssemblyBegin(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+
+  ierr = KSPCreate(PETSC_COMM_WORLD,&ksp);CHKERRQ(ierr);
+  ierr = KSPSetOperators(ksp,A,A);CHKERRQ(ierr);
+  ierr = KSPSetType(ksp,KSPCG);CHKERRQ(ierr);
+  ierr = KSPSetTolerances(ksp,1.e-8,PETSC_DEFAULT,PETSC_DEFAULT,PETSC_DEFAULT);CHKERRQ(ierr);
+  ierr = KSPSetFromOptions(ksp);CHKERRQ(ierr);
+  ierr = KSPMatSolve(ksp,B,X);CHKERRQ(ierr);
+  ierr = KSPGetConvergedReason(ksp,&reason);CHKERRQ(ierr);
+  ierr = KSPGetIterationNumber(ksp,&its);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_WORLD,"KSPMatSolve() %s in %D iterations\n",KSPConvergedReasons[reason],its);CHKERRQ(ierr);
+
+  /* every column must satisfy the tolerance of KSPSolve() with its own right-hand side */
+  ierr = KSPGetTolerances(ksp,&rtol,NULL,NULL,NULL);CHKERRQ(ierr);
+  ierr = PetscMalloc2(N,&norms,N,&bnorms);CHKERRQ(ierr);
+  ierr = MatMatMult(A,X,MAT_INITIAL_MATRIX,PETSC_DEFAULT,&R);CHKERRQ(ierr);
+  ierr = MatAYPX(R,-1.0,B,SAME_NONZERO_PATTERN);CHKERRQ(ierr);
+  ierr = MatGetColumnNorms(R,NORM_2,norms);CHKERRQ(ierr);
+  ierr = MatGetColumnNorms(B,NORM_2,bnorms);CHKERRQ(ierr);
+  for (j=0; j<N && reason != KSP_CONVERGED_ITS; j++) {
+    if (norms[j] > 100*rtol*bnorms[j] + PETSC_SMALL) {ierr = PetscPrintf(PETSC_COMM_WORLD,"Column %D has residual norm %g for right-hand side norm %g\n",j,(double)norms[j],(double)bnorms[j]);CHKERRQ(ierr);}
+  }
+
+  /* compare with the solutions computed one at a time */
+  for (j=0; j<N && reason != KSP_CONVERGED_ITS; j++) {
+    PetscReal nrm,xnrm;
+
+    ierr = MatDenseGetColumnVecRead(B,j,&cb);CHKERRQ(ierr);
+    ierr = MatDenseGetColumnVecWrite(R,j,&cx);CHKERRQ(ierr);
+    ierr = KSPSolve(ksp,cb,cx);CHKERRQ(ierr);
+    ierr = MatDenseRestoreColumnVecWrite(R,j,&cx);CHKERRQ(ierr);
+    ierr = MatDenseRestoreColumnVecRead(B,j,&cb);CHKERRQ(ierr);
+    ierr = MatDenseGetColumnVecRead(X,j,&cx);CHKERRQ(ierr);
+    ierr = VecNorm(cx,NORM_2,&xnrm);CHKERRQ(ierr);
+    ierr = MatDenseRestoreColumnVecRead(X,j,&cx);CHKERRQ(ierr);
+    ierr = MatDenseGetColumnVecRead(R,j,&cx);CHKERRQ(ierr);
+    ierr = VecNorm(cx,NORM_2,&nrm);CHKERRQ(ierr);
+    ierr = MatDenseRestoreColumnVecRead(R,j,&cx);CHKERRQ(ierr);
+    err  = PetscMax(err,PetscAbsReal(nrm-xnrm)/PetscMax(nrm,1.0));
+  }
+  if (err > 1.e-4) {ierr = PetscPrintf(PETSC_COMM_WORLD,"KSPMatSolve() and KSPSolve() solutions differ, relative difference of the norms %g\n",(double)err);CHKERRQ(ierr);}
+
+  ierr = PetscFree2(norms,bnorms);CHKERRQ(ierr);
+  ierr = MatDestroy(&R);CHKERRQ(ierr);
+  ierr = MatDestroy(&X);CHKERRQ(ierr);
+  ierr = MatDestroy(&B);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = KSPDestroy(&ksp);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      suffix: 1
+      args: -pc_type jacobi
+
+   test:
+      suffix: 2
+      nsize: 3
+      args: -pc_type jacobi -ksp_norm_type unpreconditioned
+      output_file: output/ex64_1.out
+
+   test:
+      suffix: 3
+      nsize: 2
+      args: -pc_type bjacobi -sub_pc_type icc -N 9 -ksp_norm_type natural
+
+   test:
+      suffix: 4
+      args: -pc_type none -m 5 -ksp_max_it 3 -ksp_norm_type none
+
+TEST*/
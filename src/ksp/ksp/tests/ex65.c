@@ -0,0 +1,94 @@
+static char help[] = "Solves a linear system with the preconditioner built from a MATAIJMIXED copy of the operator.\n\
+Input parameters include\n\
+  -m <m> : number of grid points in each direction\n\n";
+
+#include <petscksp.h>
+
+int main(int argc,char **args)
+{
+  Mat                A,P;
+  Vec                x,b,u;
+  KSP                ksp;
+  PetscInt           i,j,Ii,J,m = 16,rstart,rend,its,k;
+  PetscScalar        v;
+  PetscReal          norm,unorm;
+  KSPConvergedReason reason;
+  PetscErrorCode     ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
+
+  /* 2d Laplacian with a variable coefficient on the diagonal */
+  ierr = MatCreateAIJ(PETSC_COMM_WORLD,PETSC_DECIDE,PETSC_DECIDE,m*m,m*m,5,NULL,5,NULL,&A);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(A,&rstart,&rend);CHKERRQ(ierr);
+  for (Ii=rstart; Ii<rend; Ii++) {
+    i = Ii/m; j = Ii - i*m; v = -1.0;
+    if (i>0)   {J = Ii - m; ierr = MatSetValues(A,1,&Ii,1,&J,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    if (i<m-1) {J = Ii + m; ierr = MatSetValues(A,1,&Ii,1,&J,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    if (j>0)   {J = Ii - 1; ierr = MatSetValues(A,1,&Ii,1,&J,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    if (j<m-1) {J = Ii + 1; ierr = MatSetValues(A,1,&Ii,1,&J,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    v = 4.0 + 0.1*(Ii%3); ierr = MatSetValues(A,1,&Ii,1,&Ii,&v,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatSetOption(A,MAT_SPD,PETSC_TRUE);CHKERRQ(ierr);
+
+  ierr = MatCreateVecs(A,&x,&b);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&u);CHKERRQ(ierr);
+  ierr = VecSet(u,1.0);CHKERRQ(ierr);
+  ierr = MatMult(A,u,b);CHKERRQ(ierr);
+
+  /* the Krylov method uses the operator in double precision, the preconditioner the single precision values */
+  for (k=0; k<2; k++) {
+    if (!k) {
+      ierr = MatDuplicate(A,MAT_COPY_VALUES,&P);CHKERRQ(ierr);
+    } else {
+      ierr = MatConvert(A,MATAIJMIXED,MAT_INITIAL_MATRIX,&P);CHKERRQ(ierr);
+    }
+    ierr = KSPCreate(PETSC_COMM_WORLD,&ksp);CHKERRQ(ierr);
+    ierr = KSPSetOperators(ksp,A,P);CHKERRQ(ierr);
+    ierr = KSPSetTolerances(ksp,1.e-10,PETSC_DEFAULT,PETSC_DEFAULT,PETSC_DEFAULT);CHKERRQ(ierr);
+    ierr = KSPSetFromOptions(ksp);CHKERRQ(ierr);
+    ierr = VecSet(x,0.0);CHKERRQ(ierr);
+    ierr = KSPSolve(ksp,b,x);CHKERRQ(ierr);
+    ierr = KSPGetConvergedReason(ksp,&reason);CHKERRQ(ierr);
+    ierr = KSPGetIterationNumber(ksp,&its);CHKERRQ(ierr);
+    ierr = VecAXPY(x,-1.0,u);CHKERRQ(ierr);
+    ierr = VecNorm(x,NORM_2,&norm);CHKERRQ(ierr);
+    ierr = VecNorm(u,NORM_2,&unorm);CHKERRQ(ierr);
+    /* the accuracy of the solution is not limited by the single precision of the preconditioner */
+    if (norm > 1.e-8*unorm) {ierr = PetscPrintf(PETSC_COMM_WORLD,"Relative error of the solution %g\n",(double)(norm/unorm));CHKERRQ(ierr);}
+    ierr = PetscPrintf(PETSC_COMM_WORLD,"%s preconditioner matrix: %s in %D iterations\n",k ? "Mixed" : "Double",KSPConvergedReasons[reason],its);CHKERRQ(ierr);
+    ierr = KSPDestroy(&ksp);CHKERRQ(ierr);
+    ierr = MatDestroy(&P);CHKERRQ(ierr);
+  }
+
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&u);CHKERRQ(ierr);
+  ierr = VecDestroy(&b);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   build:
+      requires: !complex double
+
+   test:
+      suffix: sor
+      nsize: 2
+      args: -ksp_type cg -pc_type sor
+
+   test:
+      suffix: bjacobi
+      nsize: 2
+      args: -ksp_type gmres -pc_type bjacobi -sub_pc_type ilu
+
+   test:
+      suffix: gamg
+      nsize: 2
+      args: -ksp_type cg -pc_type gamg -mg_levels_ksp_type chebyshev -mg_levels_pc_type sor
+
+TEST*/
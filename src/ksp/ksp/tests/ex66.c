@@ -0,0 +1,98 @@
+static char help[] = "Tests KSPSolveTranspose() after KSPSolve() with the recycle space of KSPGCRODR.\n\
+Input parameters include\n\
+  -n <n> : dimension of the nonsymmetric tridiagonal operator\n\n";
+
+#include <petscksp.h>
+
+/* true residual ||b - op(A) x|| / ||b|| */
+static PetscErrorCode CheckResidual(Mat A,Vec b,Vec x,PetscBool transpose,const char *name)
+{
+  Vec            r;
+  PetscReal      rnorm,bnorm;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecDuplicate(b,&r);CHKERRQ(ierr);
+  if (transpose) {ierr = MatMultTranspose(A,x,r);CHKERRQ(ierr);}
+  else {ierr = MatMult(A,x,r);CHKERRQ(ierr);}
+  ierr = VecAYPX(r,-1.0,b);CHKERRQ(ierr);
+  ierr = VecNorm(r,NORM_2,&rnorm);CHKERRQ(ierr);
+  ierr = VecNorm(b,NORM_2,&bnorm);CHKERRQ(ierr);
+  if (rnorm > 1.e-6*bnorm) {ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: relative residual %g\n",name,(double)(rnorm/bnorm));CHKERRQ(ierr);}
+  ierr = VecDestroy(&r);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **args)
+{
+  Mat                A;
+  Vec                x,b;
+  KSP                ksp;
+  PC                 pc;
+  PetscInt           i,n = 200,rstart,rend,col[3];
+  PetscScalar        v[3];
+  KSPConvergedReason reason;
+  PetscErrorCode     ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+
+  /* convection-diffusion like stencil with a varying diagonal, far from symmetric */
+  ierr = MatCreateAIJ(PETSC_COMM_WORLD,PETSC_DECIDE,PETSC_DECIDE,n,n,3,NULL,2,NULL,&A);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(A,&rstart,&rend);CHKERRQ(ierr);
+  for (i=rstart; i<rend; i++) {
+    col[0] = i-1; col[1] = i; col[2] = i+1;
+    v[0] = -1.6; v[1] = 2.0 + (i%7)*0.1; v[2] = -0.4;
+    if (!i) {ierr = MatSetValues(A,1,&i,2,col+1,v+1,INSERT_VALUES);CHKERRQ(ierr);}
+    else if (i == n-1) {ierr = MatSetValues(A,1,&i,2,col,v,INSERT_VALUES);CHKERRQ(ierr);}
+    else {ierr = MatSetValues(A,1,&i,3,col,v,INSERT_VALUES);CHKERRQ(ierr);}
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatCreateVecs(A,&x,&b);CHKERRQ(ierr);
+  for (i=rstart; i<rend; i++) {ierr = VecSetValue(b,i,(PetscScalar)((i*7)%17 - 8.0),INSERT_VALUES);CHKERRQ(ierr);}
+  ierr = VecAssemblyBegin(b);CHKERRQ(ierr);
+  ierr = VecAssemblyEnd(b);CHKERRQ(ierr);
+
+  ierr = KSPCreate(PETSC_COMM_WORLD,&ksp);CHKERRQ(ierr);
+  ierr = KSPSetOperators(ksp,A,A);CHKERRQ(ierr);
+  ierr = KSPSetType(ksp,KSPGCRODR);CHKERRQ(ierr);
+  ierr = KSPGMRESSetRestart(ksp,10);CHKERRQ(ierr);
+  ierr = KSPGCRODRSetRecycleSize(ksp,4);CHKERRQ(ierr);
+  ierr = KSPGetPC(ksp,&pc);CHKERRQ(ierr);
+  ierr = PCSetType(pc,PCJACOBI);CHKERRQ(ierr);
+  ierr = KSPSetTolerances(ksp,1.e-10,PETSC_DEFAULT,PETSC_DEFAULT,1000);CHKERRQ(ierr);
+  ierr = KSPSetFromOptions(ksp);CHKERRQ(ierr);
+
+  /* the second solve starts with the recycle space of the first one, built for the other operator */
+  ierr = KSPSolve(ksp,b,x);CHKERRQ(ierr);
+  ierr = KSPGetConvergedReason(ksp,&reason);CHKERRQ(ierr);
+  if (reason < 0) {ierr = PetscPrintf(PETSC_COMM_WORLD,"KSPSolve() diverged: %s\n",KSPConvergedReasons[reason]);CHKERRQ(ierr);}
+  ierr = CheckResidual(A,b,x,PETSC_FALSE,"KSPSolve()");CHKERRQ(ierr);
+  ierr = KSPSolveTranspose(ksp,b,x);CHKERRQ(ierr);
+  ierr = KSPGetConvergedReason(ksp,&reason);CHKERRQ(ierr);
+  if (reason < 0) {ierr = PetscPrintf(PETSC_COMM_WORLD,"KSPSolveTranspose() diverged: %s\n",KSPConvergedReasons[reason]);CHKERRQ(ierr);}
+  ierr = CheckResidual(A,b,x,PETSC_TRUE,"KSPSolveTranspose()");CHKERRQ(ierr);
+  /* and back */
+  ierr = KSPSolve(ksp,b,x);CHKERRQ(ierr);
+  ierr = KSPGetConvergedReason(ksp,&reason);CHKERRQ(ierr);
+  if (reason < 0) {ierr = PetscPrintf(PETSC_COMM_WORLD,"KSPSolve() diverged: %s\n",KSPConvergedReasons[reason]);CHKERRQ(ierr);}
+  ierr = CheckResidual(A,b,x,PETSC_FALSE,"KSPSolve() after KSPSolveTranspose()");CHKERRQ(ierr);
+
+  ierr = KSPDestroy(&ksp);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&b);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      suffix: 1
+      nsize: {{1 2}}
+      args: -ksp_pc_side {{left right}}
+      output_file: output/ex66_1.out
+
+TEST*/
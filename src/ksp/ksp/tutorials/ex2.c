@@ -232,6 +232,10 @@ int main(int argc,char **args)
       suffix: 4
       args: -pc_type eisenstat -ksp_monitor_short -ksp_gmres_cgs_refinement_type refine_always
 
+   test:
+      suffix: sor_multicolor
+      args: -pc_type sor -pc_sor_multicolor -mat_sor_threads {{1 2}} -ksp_monitor_short -ksp_gmres_cgs_refinement_type refine_always
+
    test:
       suffix: 5
       nsize: 2
@@ -253,6 +257,30 @@ int main(int argc,char **args)
       nsize: 4
       args: -pc_type bjacobi -pc_bjacobi_blocks 4 -ksp_monitor_short -sub_pc_type jacobi -sub_ksp_type gmres
 
+   test:
+      suffix: bjacobi_threads
+      nsize: 2
+      args: -pc_type bjacobi -pc_bjacobi_blocks 8 -pc_bjacobi_threads {{1 2}} -sub_pc_type ilu -ksp_monitor_short -m 20 -n 20
+
+   test:
+      suffix: asm_threads
+      nsize: 2
+      args: -pc_type asm -pc_asm_blocks 8 -pc_asm_threads {{1 2}} -sub_pc_type lu -ksp_monitor_short -m 20 -n 20
+
+   test:
+      suffix: chowilu_bjacobi
+      nsize: 2
+      args: -pc_type bjacobi -sub_pc_factor_mat_solver_type chowilu -ksp_monitor_short
+
+   test:
+      suffix: chowilu_asm
+      nsize: 2
+      args: -pc_type asm -sub_pc_type ilu -sub_pc_factor_mat_solver_type chowilu -sub_pc_factor_levels 1 -ksp_monitor_short
+
+   test:
+      suffix: supernodal
+      args: -ksp_type preonly -pc_type cholesky -pc_factor_mat_solver_type supernodal -pc_factor_mat_ordering_type nd -m 20 -n 20
+
    test:
       suffix: fbcgs
       args: -ksp_type fbcgs -pc_type ilu
@@ -284,6 +312,24 @@ int main(int argc,char **args)
       suffix: pipecg
       args: -ksp_monitor_short -ksp_type pipecg -m 9 -n 9
 
+   test:
+      suffix: sgmres
+      args: -ksp_monitor_short -ksp_type sgmres -m 9 -n 9
+
+   test:
+      suffix: sgmres_2
+      nsize: 2
+      args: -ksp_monitor_short -ksp_type sgmres -ksp_sgmres_basis_type chebyshev -ksp_sgmres_steps 4 -m 9 -n 9
+
+   test:
+      suffix: sgmres_3
+      args: -ksp_monitor_short -ksp_type sgmres -ksp_gmres_restart 10 -ksp_sgmres_basis_type {{monomial chebyshev}} -ksp_sgmres_steps 4 -m 30 -n 30
+      output_file: output/ex2_sgmres_3.out
+
+   test:
+      suffix: gcrodr
+      args: -ksp_monitor_short -ksp_type gcrodr -ksp_gmres_restart 10 -ksp_gcrodr_recycle_size 4 -pc_type jacobi -m 15 -n 15
+
    test:
       suffix: pipecgrr
       args: -ksp_monitor_short -ksp_type pipecgrr -m 9 -n 9
@@ -327,4 +373,24 @@ int main(int argc,char **args)
    test:
       suffix: pipeprcg_rcw
       args: -ksp_monitor_short -ksp_type pipeprcg -recompute_w false -m 9 -n 9
+
+   test:
+      suffix: overlap_reductions_cg
+      nsize: 2
+      args: -ksp_monitor_short -ksp_type cg -ksp_norm_type unpreconditioned -ksp_overlap_reductions -m 9 -n 9
+
+   test:
+      suffix: overlap_reductions_gmres
+      nsize: 2
+      args: -ksp_monitor_short -ksp_gmres_cgs_refinement_type refine_ifneeded -ksp_overlap_reductions -m 9 -n 9
+
+   test:
+      suffix: gmres_contiguous_basis
+      nsize: 2
+      args: -ksp_converged_reason -ksp_gmres_contiguous_basis -ksp_gmres_restart 100 -ksp_gmres_cgs_refinement_type {{refine_never refine_ifneeded refine_always}} -m 64 -n 64
+
+   test:
+      suffix: vec_multi_threads
+      nsize: 2
+      args: -ksp_converged_reason -vec_multi_threads 2 -ksp_gmres_restart 100 -m 64 -n 64
  TEST*/
@@ -387,6 +387,11 @@ int main(int argc,char **args)
       nsize: 5
       args: -pc_type redundant -pc_redundant_number 3 -redundant_ksp_type gmres -redundant_pc_type jacobi -psubcomm_type interlaced
 
+   test:
+      suffix: gcrodr
+      nsize: 2
+      args: -m 30 -ksp_type gcrodr -ksp_gmres_restart 6 -ksp_gcrodr_recycle_size 3 -pc_type jacobi -ksp_monitor_short -ksp_pc_side {{left right}separate output}
+
    test:
       suffix: superlu_dist
       nsize: 15
@@ -63,7 +63,7 @@ int main(int argc,char **args)
    # KSPHPDDM does either pseudo-blocking or "true" blocking, all tests should succeed with other -ksp_hpddm_type
    testset:
       nsize: 1
-      args: -pc_type {{bjacobi lu ilu mat cholesky icc none shell}shared output}
+      args: -pc_type {{bjacobi lu ilu mat cholesky icc none shell jacobi}shared output}
       test:
          suffix: 1
          output_file: output/ex77_preonly.out
@@ -32,6 +32,7 @@ static PetscErrorCode PCView_ASM(PC pc,PetscViewer viewer)
     ierr = PetscViewerASCIIPrintf(viewer,"  restriction/interpolation type - %s\n",PCASMTypes[osm->type]);CHKERRQ(ierr);
     if (osm->dm_subdomains) {ierr = PetscViewerASCIIPrintf(viewer,"  Additive Schwarz: using DM to define subdomains\n");CHKERRQ(ierr);}
     if (osm->loctype != PC_COMPOSITE_ADDITIVE) {ierr = PetscViewerASCIIPrintf(viewer,"  Additive Schwarz: local solve composition type - %s\n",PCCompositeTypes[osm->loctype]);CHKERRQ(ierr);}
+    if (osm->nthreads > 1) {ierr = PetscViewerASCIIPrintf(viewer,"  Additive Schwarz: local blocks set up and solved on %D threads\n",osm->nthreads);CHKERRQ(ierr);}
     ierr = MPI_Comm_rank(PetscObjectComm((PetscObject)pc),&rank);CHKERRQ(ierr);
     if (osm->same_local_solves) {
       if (osm->ksp) {
@@ -421,8 +422,20 @@ static PetscErrorCode PCSetUpOnBlocks_ASM(PC pc)
   KSPConvergedReason reason;
 
   PetscFunctionBegin;
+  if (osm->nthreads > 1) {
+    PetscErrorCode berr = 0;
+    /* the blocks are set up (e.g., factored) independently, errors are collected and raised once all threads are done */
+#if defined(PETSC_HAVE_OPENMP) && defined(PETSC_HAVE_THREADSAFETY)
+#pragma omp parallel for num_threads(osm->nthreads) schedule(dynamic) reduction(max:berr)
+#endif
+    for (i=0; i<osm->n_local_true; i++) {
+      PetscErrorCode ierr_i = KSPSetUp(osm->ksp[i]);
+      if (ierr_i > berr) berr = ierr_i;
+    }
+    CHKERRQ(berr);
+  }
   for (i=0; i<osm->n_local_true; i++) {
-    ierr = KSPSetUp(osm->ksp[i]);CHKERRQ(ierr);
+    if (osm->nthreads == 1) {ierr = KSPSetUp(osm->ksp[i]);CHKERRQ(ierr);}
     ierr = KSPGetConvergedReason(osm->ksp[i],&reason);CHKERRQ(ierr);
     if (reason == KSP_DIVERGED_PC_FAILED) {
       pc->failedreason = PC_SUBPC_ERROR;
@@ -431,6 +444,45 @@ static PetscErrorCode PCSetUpOnBlocks_ASM(PC pc)
   PetscFunctionReturn(0);
 }
 
+/*
+   Additive composition on several threads: restricts the local RHS to all the overlapping blocks (the 0-block is
+   already done), solves on all the blocks at the same time and then adds the block solutions to the local
+   solution in the same order as the sequential loop
+*/
+static PetscErrorCode PCASMApplyOnBlocks_Threads(PC pc,ScatterMode forward,ScatterMode reverse,PetscBool transpose)
+{
+  PC_ASM         *osm = (PC_ASM*)pc->data;
+  PetscErrorCode ierr,berr = 0;
+  PetscInt       i,n_local_true = osm->n_local_true;
+
+  PetscFunctionBegin;
+  for (i = 1; i < n_local_true; ++i) {
+    ierr = VecScatterBegin(osm->lrestriction[i], osm->lx, osm->x[i], INSERT_VALUES, forward);CHKERRQ(ierr);
+    ierr = VecScatterEnd(osm->lrestriction[i], osm->lx, osm->x[i], INSERT_VALUES, forward);CHKERRQ(ierr);
+  }
+#if defined(PETSC_HAVE_OPENMP) && defined(PETSC_HAVE_THREADSAFETY)
+#pragma omp parallel for num_threads(osm->nthreads) schedule(dynamic) reduction(max:berr)
+#endif
+  for (i = 0; i < n_local_true; ++i) {
+    PetscErrorCode ierr_i;
+    if (transpose) ierr_i = KSPSolveTranspose(osm->ksp[i], osm->x[i], osm->y[i]);
+    else ierr_i = KSPSolve(osm->ksp[i], osm->x[i], osm->y[i]);
+    if (ierr_i > berr) berr = ierr_i;
+  }
+  CHKERRQ(berr);
+  for (i = 0; i < n_local_true; ++i) {
+    ierr = KSPCheckSolve(osm->ksp[i],pc,osm->y[i]);CHKERRQ(ierr);
+    if (osm->lprolongation) { /* interpolate the non-overlapping i-block solution to the local solution */
+      ierr = VecScatterBegin(osm->lprolongation[i], osm->y[i], osm->ly, ADD_VALUES, forward);CHKERRQ(ierr);
+      ierr = VecScatterEnd(osm->lprolongation[i], osm->y[i], osm->ly, ADD_VALUES, forward);CHKERRQ(ierr);
+    } else { /* interpolate the overlapping i-block solution to the local solution */
+      ierr = VecScatterBegin(osm->lrestriction[i], osm->y[i], osm->ly, ADD_VALUES, reverse);CHKERRQ(ierr);
+      ierr = VecScatterEnd(osm->lrestriction[i], osm->y[i], osm->ly, ADD_VALUES, reverse);CHKERRQ(ierr);
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
 static PetscErrorCode PCApply_ASM(PC pc,Vec x,Vec y)
 {
   PC_ASM         *osm = (PC_ASM*)pc->data;
@@ -466,32 +518,36 @@ static PetscErrorCode PCApply_ASM(PC pc,Vec x,Vec y)
     ierr = VecScatterEnd(osm->lrestriction[0], osm->lx, osm->x[0], INSERT_VALUES, forward);CHKERRQ(ierr);
 
     /* do the local solves */
-    for (i = 0; i < n_local_true; ++i) {
+    if (osm->loctype == PC_COMPOSITE_ADDITIVE && osm->nthreads > 1) {
+      ierr = PCASMApplyOnBlocks_Threads(pc,forward,reverse,PETSC_FALSE);CHKERRQ(ierr);
+    } else {
+      for (i = 0; i < n_local_true; ++i) {
 
-      /* solve the overlapping i-block */
-      ierr = PetscLogEventBegin(PC_ApplyOnBlocks,osm->ksp[i],osm->x[i],osm->y[i],0);CHKERRQ(ierr);
-      ierr = KSPSolve(osm->ksp[i], osm->x[i], osm->y[i]);CHKERRQ(ierr);
-      ierr = KSPCheckSolve(osm->ksp[i],pc,osm->y[i]);CHKERRQ(ierr);
-      ierr = PetscLogEventEnd(PC_ApplyOnBlocks,osm->ksp[i],osm->x[i],osm->y[i],0);CHKERRQ(ierr);
+        /* solve the overlapping i-block */
+        ierr = PetscLogEventBegin(PC_ApplyOnBlocks,osm->ksp[i],osm->x[i],osm->y[i],0);CHKERRQ(ierr);
+        ierr = KSPSolve(osm->ksp[i], osm->x[i], osm->y[i]);CHKERRQ(ierr);
+        ierr = KSPCheckSolve(osm->ksp[i],pc,osm->y[i]);CHKERRQ(ierr);
+        ierr = PetscLogEventEnd(PC_ApplyOnBlocks,osm->ksp[i],osm->x[i],osm->y[i],0);CHKERRQ(ierr);
 
-      if (osm->lprolongation) { /* interpolate the non-overlapping i-block solution to the local solution (only for restrictive additive) */
-        ierr = VecScatterBegin(osm->lprolongation[i], osm->y[i], osm->ly, ADD_VALUES, forward);CHKERRQ(ierr);
-        ierr = VecScatterEnd(osm->lprolongation[i], osm->y[i], osm->ly, ADD_VALUES, forward);CHKERRQ(ierr);
-      }
-      else { /* interpolate the overlapping i-block solution to the local solution */
-        ierr = VecScatterBegin(osm->lrestriction[i], osm->y[i], osm->ly, ADD_VALUES, reverse);CHKERRQ(ierr);
-        ierr = VecScatterEnd(osm->lrestriction[i], osm->y[i], osm->ly, ADD_VALUES, reverse);CHKERRQ(ierr);
-      }
+        if (osm->lprolongation) { /* interpolate the non-overlapping i-block solution to the local solution (only for restrictive additive) */
+          ierr = VecScatterBegin(osm->lprolongation[i], osm->y[i], osm->ly, ADD_VALUES, forward);CHKERRQ(ierr);
+          ierr = VecScatterEnd(osm->lprolongation[i], osm->y[i], osm->ly, ADD_VALUES, forward);CHKERRQ(ierr);
+        }
+        else { /* interpolate the overlapping i-block solution to the local solution */
+          ierr = VecScatterBegin(osm->lrestriction[i], osm->y[i], osm->ly, ADD_VALUES, reverse);CHKERRQ(ierr);
+          ierr = VecScatterEnd(osm->lrestriction[i], osm->y[i], osm->ly, ADD_VALUES, reverse);CHKERRQ(ierr);
+        }
 
-      if (i < n_local_true-1) {
-        /* Restrict local RHS to the overlapping (i+1)-block RHS */
-        ierr = VecScatterBegin(osm->lrestriction[i+1], osm->lx, osm->x[i+1], INSERT_VALUES, forward);CHKERRQ(ierr);
-        ierr = VecScatterEnd(osm->lrestriction[i+1], osm->lx, osm->x[i+1], INSERT_VALUES, forward);CHKERRQ(ierr);
+        if (i < n_local_true-1) {
+          /* Restrict local RHS to the overlapping (i+1)-block RHS */
+          ierr = VecScatterBegin(osm->lrestriction[i+1], osm->lx, osm->x[i+1], INSERT_VALUES, forward);CHKERRQ(ierr);
+          ierr = VecScatterEnd(osm->lrestriction[i+1], osm->lx, osm->x[i+1], INSERT_VALUES, forward);CHKERRQ(ierr);
 
-        if ( osm->loctype == PC_COMPOSITE_MULTIPLICATIVE){
-          /* update the overlapping (i+1)-block RHS using the current local solution */
-          ierr = MatMult(osm->lmats[i+1], osm->ly, osm->y[i+1]);CHKERRQ(ierr);
-          ierr = VecAXPBY(osm->x[i+1],-1.,1., osm->y[i+1]); CHKERRQ(ierr);
+          if ( osm->loctype == PC_COMPOSITE_MULTIPLICATIVE){
+            /* update the overlapping (i+1)-block RHS using the current local solution */
+            ierr = MatMult(osm->lmats[i+1], osm->ly, osm->y[i+1]);CHKERRQ(ierr);
+            ierr = VecAXPBY(osm->x[i+1],-1.,1., osm->y[i+1]); CHKERRQ(ierr);
+          }
         }
       }
     }
@@ -540,26 +596,30 @@ static PetscErrorCode PCApplyTranspose_ASM(PC pc,Vec x,Vec y)
   ierr = VecScatterEnd(osm->lrestriction[0], osm->lx, osm->x[0], INSERT_VALUES, forward);CHKERRQ(ierr);
 
   /* do the local solves */
-  for (i = 0; i < n_local_true; ++i) {
+  if (osm->nthreads > 1) {
+    ierr = PCASMApplyOnBlocks_Threads(pc,forward,reverse,PETSC_TRUE);CHKERRQ(ierr);
+  } else {
+    for (i = 0; i < n_local_true; ++i) {
 
-    /* solve the overlapping i-block */
-    ierr = PetscLogEventBegin(PC_ApplyOnBlocks,osm->ksp[i],osm->x[i],osm->y[i],0);CHKERRQ(ierr);
-    ierr = KSPSolveTranspose(osm->ksp[i], osm->x[i], osm->y[i]);CHKERRQ(ierr);
-    ierr = KSPCheckSolve(osm->ksp[i],pc,osm->y[i]);CHKERRQ(ierr);
-    ierr = PetscLogEventEnd(PC_ApplyOnBlocks,osm->ksp[i],osm->x[i],osm->y[i],0);CHKERRQ(ierr);
+      /* solve the overlapping i-block */
+      ierr = PetscLogEventBegin(PC_ApplyOnBlocks,osm->ksp[i],osm->x[i],osm->y[i],0);CHKERRQ(ierr);
+      ierr = KSPSolveTranspose(osm->ksp[i], osm->x[i], osm->y[i]);CHKERRQ(ierr);
+      ierr = KSPCheckSolve(osm->ksp[i],pc,osm->y[i]);CHKERRQ(ierr);
+      ierr = PetscLogEventEnd(PC_ApplyOnBlocks,osm->ksp[i],osm->x[i],osm->y[i],0);CHKERRQ(ierr);
 
-    if (osm->lprolongation) { /* interpolate the non-overlapping i-block solution to the local solution */
-      ierr = VecScatterBegin(osm->lprolongation[i], osm->y[i], osm->ly, ADD_VALUES, forward);CHKERRQ(ierr);
-      ierr = VecScatterEnd(osm->lprolongation[i], osm->y[i], osm->ly, ADD_VALUES, forward);CHKERRQ(ierr);
-    } else { /* interpolate the overlapping i-block solution to the local solution */
-      ierr = VecScatterBegin(osm->lrestriction[i], osm->y[i], osm->ly, ADD_VALUES, reverse);CHKERRQ(ierr);
-      ierr = VecScatterEnd(osm->lrestriction[i], osm->y[i], osm->ly, ADD_VALUES, reverse);CHKERRQ(ierr);
-    }
+      if (osm->lprolongation) { /* interpolate the non-overlapping i-block solution to the local solution */
+        ierr = VecScatterBegin(osm->lprolongation[i], osm->y[i], osm->ly, ADD_VALUES, forward);CHKERRQ(ierr);
+        ierr = VecScatterEnd(osm->lprolongation[i], osm->y[i], osm->ly, ADD_VALUES, forward);CHKERRQ(ierr);
+      } else { /* interpolate the overlapping i-block solution to the local solution */
+        ierr = VecScatterBegin(osm->lrestriction[i], osm->y[i], osm->ly, ADD_VALUES, reverse);CHKERRQ(ierr);
+        ierr = VecScatterEnd(osm->lrestriction[i], osm->y[i], osm->ly, ADD_VALUES, reverse);CHKERRQ(ierr);
+      }
 
-    if (i < n_local_true-1) {
-      /* Restrict local RHS to the overlapping (i+1)-block RHS */
-      ierr = VecScatterBegin(osm->lrestriction[i+1], osm->lx, osm->x[i+1], INSERT_VALUES, forward);CHKERRQ(ierr);
-      ierr = VecScatterEnd(osm->lrestriction[i+1], osm->lx, osm->x[i+1], INSERT_VALUES, forward);CHKERRQ(ierr);
+      if (i < n_local_true-1) {
+        /* Restrict local RHS to the overlapping (i+1)-block RHS */
+        ierr = VecScatterBegin(osm->lrestriction[i+1], osm->lx, osm->x[i+1], INSERT_VALUES, forward);CHKERRQ(ierr);
+        ierr = VecScatterEnd(osm->lrestriction[i+1], osm->lx, osm->x[i+1], INSERT_VALUES, forward);CHKERRQ(ierr);
+      }
     }
   }
   /* Add the local solution to the global solution including the ghost nodes */
@@ -672,6 +732,14 @@ static PetscErrorCode PCSetFromOptions_ASM(PetscOptionItems *PetscOptionsObject,
   if (flg) {
     ierr = PCASMSetSubMatType(pc,sub_mat_type);CHKERRQ(ierr);
   }
+  ierr = PetscOptionsInt("-pc_asm_threads","Number of threads for the setup and additive solves of the local blocks","PCASM",osm->nthreads,&osm->nthreads,NULL);CHKERRQ(ierr);
+  if (osm->nthreads < 1) osm->nthreads = 1;
+#if !defined(PETSC_HAVE_OPENMP) || !defined(PETSC_HAVE_THREADSAFETY)
+  if (osm->nthreads > 1) {
+    ierr          = PetscInfo1(pc,"PETSc was not configured with OpenMP and thread safety, the local blocks use 1 thread instead of %D\n",osm->nthreads);CHKERRQ(ierr);
+    osm->nthreads = 1;
+  }
+#endif
   ierr = PetscOptionsTail();CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -1214,7 +1282,8 @@ PetscErrorCode  PCASMGetSubKSP(PC pc,PetscInt *n_local,PetscInt *first_local,KSP
 +  -pc_asm_blocks <blks> - Sets total blocks
 .  -pc_asm_overlap <ovl> - Sets overlap
 .  -pc_asm_type [basic,restrict,interpolate,none] - Sets ASM type, default is restrict
--  -pc_asm_local_type [additive, multiplicative] - Sets ASM type, default is additive
+.  -pc_asm_local_type [additive, multiplicative] - Sets ASM type, default is additive
+-  -pc_asm_threads <n> - Sets up and solves the blocks of each process on n OpenMP threads
 
      IMPORTANT: If you run with, for example, 3 blocks on 1 processor or 3 blocks on 3 processors you
       will get a different convergence rate due to the default option of -pc_asm_type restrict. Use
@@ -1231,6 +1300,11 @@ PetscErrorCode  PCASMGetSubKSP(PC pc,PetscInt *n_local,PetscInt *first_local,KSP
          and set the options directly on the resulting KSP object (you can access its PC
          with KSPGetPC())
 
+     With several blocks per process, -pc_asm_threads <n> factors (in PCSetUpOnBlocks()) and solves the blocks of
+     each process at the same time on n OpenMP threads; the multiplicative local composition still solves them one
+     after the other. This requires PETSc configured with --with-openmp and --with-threadsafety, otherwise the blocks
+     are processed one after the other.
+
    Level: beginner
 
     References:
@@ -1273,6 +1347,7 @@ PETSC_EXTERN PetscErrorCode PCCreate_ASM(PC pc)
   osm->sort_indices      = PETSC_TRUE;
   osm->dm_subdomains     = PETSC_FALSE;
   osm->sub_mat_type      = NULL;
+  osm->nthreads          = 1;
 
   pc->data                 = (void*)osm;
   pc->ops->apply           = PCApply_ASM;
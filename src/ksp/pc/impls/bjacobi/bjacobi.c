@@ -167,6 +167,14 @@ static PetscErrorCode PCSetFromOptions_BJacobi(PetscOptionItems *PetscOptionsObj
   if (flg) {ierr = PCBJacobiSetTotalBlocks(pc,blocks,NULL);CHKERRQ(ierr);}
   ierr = PetscOptionsInt("-pc_bjacobi_local_blocks","Local number of blocks","PCBJacobiSetLocalBlocks",jac->n_local,&blocks,&flg);CHKERRQ(ierr);
   if (flg) {ierr = PCBJacobiSetLocalBlocks(pc,blocks,NULL);CHKERRQ(ierr);}
+  ierr = PetscOptionsInt("-pc_bjacobi_threads","Number of threads for the setup and solves of the local blocks","PCBJACOBI",jac->nthreads,&jac->nthreads,NULL);CHKERRQ(ierr);
+  if (jac->nthreads < 1) jac->nthreads = 1;
+#if !defined(PETSC_HAVE_OPENMP) || !defined(PETSC_HAVE_THREADSAFETY)
+  if (jac->nthreads > 1) {
+    ierr          = PetscInfo1(pc,"PETSc was not configured with OpenMP and thread safety, the local blocks use 1 thread instead of %D\n",jac->nthreads);CHKERRQ(ierr);
+    jac->nthreads = 1;
+  }
+#endif
   if (jac->ksp) {
     /* The sub-KSP has already been set up (e.g., PCSetUp_BJacobi_Singleblock), but KSPSetFromOptions was not called
      * unless we had already been called. */
@@ -198,6 +206,9 @@ static PetscErrorCode PCView_BJacobi(PC pc,PetscViewer viewer)
       ierr = PetscViewerASCIIPrintf(viewer,"  using Amat local matrix, number of blocks = %D\n",jac->n);CHKERRQ(ierr);
     }
     ierr = PetscViewerASCIIPrintf(viewer,"  number of blocks = %D\n",jac->n);CHKERRQ(ierr);
+    if (jac->nthreads > 1) {
+      ierr = PetscViewerASCIIPrintf(viewer,"  local blocks set up and solved on %D threads\n",jac->nthreads);CHKERRQ(ierr);
+    }
     ierr = MPI_Comm_rank(PetscObjectComm((PetscObject)pc),&rank);CHKERRQ(ierr);
     if (jac->same_local_solves) {
       ierr = PetscViewerASCIIPrintf(viewer,"  Local solver is the same for all blocks, as in the following KSP and PC objects on rank 0:\n");CHKERRQ(ierr);
@@ -505,7 +516,8 @@ PetscErrorCode  PCBJacobiGetLocalBlocks(PC pc, PetscInt *blocks, const PetscInt
 
    Options Database Keys:
 +  -pc_use_amat - use Amat to apply block of operator in inner Krylov method
--  -pc_bjacobi_blocks <n> - use n total blocks
+.  -pc_bjacobi_blocks <n> - use n total blocks
+-  -pc_bjacobi_threads <n> - set up and solve the blocks of each process on n OpenMP threads
 
    Notes:
     Each processor can have one or more blocks, or a single block can be shared by several processes. Defaults to one block per processor.
@@ -525,6 +537,10 @@ PetscErrorCode  PCBJacobiGetLocalBlocks(PC pc, PetscInt *blocks, const PetscInt
 
      When multiple processes share a single block, each block encompasses exactly all the unknowns owned its set of processes.
 
+     With several blocks per process, -pc_bjacobi_threads <n> factors (in PCSetUpOnBlocks()) and solves the blocks of
+     each process at the same time on n OpenMP threads, so one process can use all the cores of a socket. This requires
+     PETSc configured with --with-openmp and --with-threadsafety, otherwise the blocks are processed one after the other.
+
    Level: beginner
 
 .seealso:  PCCreate(), PCSetType(), PCType (for list of available types), PC,
@@ -560,6 +576,7 @@ PETSC_EXTERN PetscErrorCode PCCreate_BJacobi(PC pc)
   jac->g_lens            = NULL;
   jac->l_lens            = NULL;
   jac->psubcomm          = NULL;
+  jac->nthreads          = 1;
 
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCBJacobiGetSubKSP_C",PCBJacobiGetSubKSP_BJacobi);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)pc,"PCBJacobiSetTotalBlocks_C",PCBJacobiSetTotalBlocks_BJacobi);CHKERRQ(ierr);
@@ -896,8 +913,20 @@ static PetscErrorCode PCSetUpOnBlocks_BJacobi_Multiblock(PC pc)
   KSPConvergedReason reason;
 
   PetscFunctionBegin;
+  if (jac->nthreads > 1) {
+    PetscErrorCode berr = 0;
+    /* the blocks are set up (e.g., factored) independently, errors are collected and raised once all threads are done */
+#if defined(PETSC_HAVE_OPENMP) && defined(PETSC_HAVE_THREADSAFETY)
+#pragma omp parallel for num_threads(jac->nthreads) schedule(dynamic) reduction(max:berr)
+#endif
+    for (i=0; i<n_local; i++) {
+      PetscErrorCode ierr_i = KSPSetUp(jac->ksp[i]);
+      if (ierr_i > berr) berr = ierr_i;
+    }
+    CHKERRQ(berr);
+  }
   for (i=0; i<n_local; i++) {
-    ierr = KSPSetUp(jac->ksp[i]);CHKERRQ(ierr);
+    if (jac->nthreads == 1) {ierr = KSPSetUp(jac->ksp[i]);CHKERRQ(ierr);}
     ierr = KSPGetConvergedReason(jac->ksp[i],&reason);CHKERRQ(ierr);
     if (reason == KSP_DIVERGED_PC_FAILED) {
       pc->failedreason = PC_SUBPC_ERROR;
@@ -907,46 +936,37 @@ static PetscErrorCode PCSetUpOnBlocks_BJacobi_Multiblock(PC pc)
 }
 
 /*
-      Preconditioner for block Jacobi
+   Solves with the i-th block; to avoid copying the subvector from x into a workspace we instead
+   make the workspace vector array point to the subpart of the array of the global vector.
 */
-static PetscErrorCode PCApply_BJacobi_Multiblock(PC pc,Vec x,Vec y)
+static PetscErrorCode PCApplyOnBlock_BJacobi_Multiblock(PC pc,PetscInt i,const PetscScalar *xin,PetscScalar *yin,PetscBool transpose)
 {
-  PC_BJacobi            *jac = (PC_BJacobi*)pc->data;
-  PetscErrorCode        ierr;
-  PetscInt              i,n_local = jac->n_local;
+  PC_BJacobi            *jac  = (PC_BJacobi*)pc->data;
   PC_BJacobi_Multiblock *bjac = (PC_BJacobi_Multiblock*)jac->data;
-  PetscScalar           *yin;
-  const PetscScalar     *xin;
+  PetscErrorCode        ierr;
 
   PetscFunctionBegin;
-  ierr = VecGetArrayRead(x,&xin);CHKERRQ(ierr);
-  ierr = VecGetArray(y,&yin);CHKERRQ(ierr);
-  for (i=0; i<n_local; i++) {
-    /*
-       To avoid copying the subvector from x into a workspace we instead
-       make the workspace vector array point to the subpart of the array of
-       the global vector.
-    */
-    ierr = VecPlaceArray(bjac->x[i],xin+bjac->starts[i]);CHKERRQ(ierr);
-    ierr = VecPlaceArray(bjac->y[i],yin+bjac->starts[i]);CHKERRQ(ierr);
-
+  ierr = VecPlaceArray(bjac->x[i],xin+bjac->starts[i]);CHKERRQ(ierr);
+  ierr = VecPlaceArray(bjac->y[i],yin+bjac->starts[i]);CHKERRQ(ierr);
+  if (transpose) {
+    ierr = PetscLogEventBegin(PC_ApplyTransposeOnBlocks,jac->ksp[i],bjac->x[i],bjac->y[i],0);CHKERRQ(ierr);
+    ierr = KSPSolveTranspose(jac->ksp[i],bjac->x[i],bjac->y[i]);CHKERRQ(ierr);
+    ierr = PetscLogEventEnd(PC_ApplyTransposeOnBlocks,jac->ksp[i],bjac->x[i],bjac->y[i],0);CHKERRQ(ierr);
+  } else {
     ierr = PetscLogEventBegin(PC_ApplyOnBlocks,jac->ksp[i],bjac->x[i],bjac->y[i],0);CHKERRQ(ierr);
     ierr = KSPSolve(jac->ksp[i],bjac->x[i],bjac->y[i]);CHKERRQ(ierr);
-    ierr = KSPCheckSolve(jac->ksp[i],pc,bjac->y[i]);CHKERRQ(ierr);
     ierr = PetscLogEventEnd(PC_ApplyOnBlocks,jac->ksp[i],bjac->x[i],bjac->y[i],0);CHKERRQ(ierr);
-
-    ierr = VecResetArray(bjac->x[i]);CHKERRQ(ierr);
-    ierr = VecResetArray(bjac->y[i]);CHKERRQ(ierr);
   }
-  ierr = VecRestoreArrayRead(x,&xin);CHKERRQ(ierr);
-  ierr = VecRestoreArray(y,&yin);CHKERRQ(ierr);
+  ierr = VecResetArray(bjac->x[i]);CHKERRQ(ierr);
+  ierr = VecResetArray(bjac->y[i]);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
 /*
-      Preconditioner for block Jacobi
+   The blocks are independent, so with several threads they are all solved first and checked afterwards,
+   since KSPCheckSolve() flags the outer PC
 */
-static PetscErrorCode PCApplyTranspose_BJacobi_Multiblock(PC pc,Vec x,Vec y)
+static PetscErrorCode PCApplyOnBlocks_BJacobi_Multiblock(PC pc,Vec x,Vec y,PetscBool transpose)
 {
   PC_BJacobi            *jac = (PC_BJacobi*)pc->data;
   PetscErrorCode        ierr;
@@ -958,21 +978,21 @@ static PetscErrorCode PCApplyTranspose_BJacobi_Multiblock(PC pc,Vec x,Vec y)
   PetscFunctionBegin;
   ierr = VecGetArrayRead(x,&xin);CHKERRQ(ierr);
   ierr = VecGetArray(y,&yin);CHKERRQ(ierr);
+  if (jac->nthreads > 1) {
+    PetscErrorCode berr = 0;
+#if defined(PETSC_HAVE_OPENMP) && defined(PETSC_HAVE_THREADSAFETY)
+#pragma omp parallel for num_threads(jac->nthreads) schedule(dynamic) reduction(max:berr)
+#endif
+    for (i=0; i<n_local; i++) {
+      PetscErrorCode ierr_i = PCApplyOnBlock_BJacobi_Multiblock(pc,i,xin,yin,transpose);
+      if (ierr_i > berr) berr = ierr_i;
+    }
+    CHKERRQ(berr);
+  }
   for (i=0; i<n_local; i++) {
-    /*
-       To avoid copying the subvector from x into a workspace we instead
-       make the workspace vector array point to the subpart of the array of
-       the global vector.
-    */
-    ierr = VecPlaceArray(bjac->x[i],xin+bjac->starts[i]);CHKERRQ(ierr);
+    if (jac->nthreads == 1) {ierr = PCApplyOnBlock_BJacobi_Multiblock(pc,i,xin,yin,transpose);CHKERRQ(ierr);}
     ierr = VecPlaceArray(bjac->y[i],yin+bjac->starts[i]);CHKERRQ(ierr);
-
-    ierr = PetscLogEventBegin(PC_ApplyTransposeOnBlocks,jac->ksp[i],bjac->x[i],bjac->y[i],0);CHKERRQ(ierr);
-    ierr = KSPSolveTranspose(jac->ksp[i],bjac->x[i],bjac->y[i]);CHKERRQ(ierr);
     ierr = KSPCheckSolve(jac->ksp[i],pc,bjac->y[i]);CHKERRQ(ierr);
-    ierr = PetscLogEventEnd(PC_ApplyTransposeOnBlocks,jac->ksp[i],bjac->x[i],bjac->y[i],0);CHKERRQ(ierr);
-
-    ierr = VecResetArray(bjac->x[i]);CHKERRQ(ierr);
     ierr = VecResetArray(bjac->y[i]);CHKERRQ(ierr);
   }
   ierr = VecRestoreArrayRead(x,&xin);CHKERRQ(ierr);
@@ -980,6 +1000,30 @@ static PetscErrorCode PCApplyTranspose_BJacobi_Multiblock(PC pc,Vec x,Vec y)
   PetscFunctionReturn(0);
 }
 
+/*
+      Preconditioner for block Jacobi
+*/
+static PetscErrorCode PCApply_BJacobi_Multiblock(PC pc,Vec x,Vec y)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PCApplyOnBlocks_BJacobi_Multiblock(pc,x,y,PETSC_FALSE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+      Preconditioner for block Jacobi
+*/
+static PetscErrorCode PCApplyTranspose_BJacobi_Multiblock(PC pc,Vec x,Vec y)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PCApplyOnBlocks_BJacobi_Multiblock(pc,x,y,PETSC_TRUE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 static PetscErrorCode PCSetUp_BJacobi_Multiblock(PC pc,Mat mat,Mat pmat)
 {
   PC_BJacobi            *jac = (PC_BJacobi*)pc->data;
@@ -20,6 +20,7 @@ typedef struct {
   PetscInt     *l_lens;           /* lens of each block */
   PetscInt     *g_lens;
   PetscSubcomm psubcomm;          /* for multiple processors per block */
+  PetscInt     nthreads;          /* number of threads for the setup and solves of multiple blocks per processor */
 } PC_BJacobi;
 
 /*
@@ -41,7 +41,7 @@ static PetscErrorCode PCApplyTranspose_SOR(PC pc,Vec x,Vec y)
 
   PetscFunctionBegin;
   ierr = MatIsSymmetricKnown(pc->pmat,&set,&sym);CHKERRQ(ierr);
-  if (!set || !sym || (jac->sym != SOR_SYMMETRIC_SWEEP && jac->sym != SOR_LOCAL_SYMMETRIC_SWEEP)) SETERRQ(PetscObjectComm((PetscObject)pc),PETSC_ERR_SUP,"Can only apply transpose of SOR if matrix is symmetric and sweep is symmetric");
+  if (!set || !sym || ((jac->sym & ~SOR_MULTICOLOR) != SOR_SYMMETRIC_SWEEP && (jac->sym & ~SOR_MULTICOLOR) != SOR_LOCAL_SYMMETRIC_SWEEP)) SETERRQ(PetscObjectComm((PetscObject)pc),PETSC_ERR_SUP,"Can only apply transpose of SOR if matrix is symmetric and sweep is symmetric");
   ierr = MatSOR(pc->pmat,x,jac->omega,(MatSORType)flag,jac->fshift,jac->its,jac->lits,y);CHKERRQ(ierr);
   ierr = MatFactorGetError(pc->pmat,(MatFactorError*)&pc->failedreason);CHKERRQ(ierr);
   PetscFunctionReturn(0);
@@ -67,7 +67,7 @@ PetscErrorCode PCSetFromOptions_SOR(PetscOptionItems *PetscOptionsObject,PC pc)
 {
   PC_SOR         *jac = (PC_SOR*)pc->data;
   PetscErrorCode ierr;
-  PetscBool      flg;
+  PetscBool      flg,multicolor = (PetscBool)!!(jac->sym & SOR_MULTICOLOR);
 
   PetscFunctionBegin;
   ierr = PetscOptionsHead(PetscOptionsObject,"(S)SOR options");CHKERRQ(ierr);
@@ -87,6 +87,8 @@ PetscErrorCode PCSetFromOptions_SOR(PetscOptionItems *PetscOptionsObject,PC pc)
   if (flg) {ierr = PCSORSetSymmetric(pc,SOR_LOCAL_BACKWARD_SWEEP);CHKERRQ(ierr);}
   ierr = PetscOptionsBoolGroupEnd("-pc_sor_local_forward","use forward sweep locally","PCSORSetSymmetric",&flg);CHKERRQ(ierr);
   if (flg) {ierr = PCSORSetSymmetric(pc,SOR_LOCAL_FORWARD_SWEEP);CHKERRQ(ierr);}
+  ierr = PetscOptionsBool("-pc_sor_multicolor","relax the rows color by color on threads (AIJ matrices)","PCSORSetSymmetric",multicolor,&multicolor,NULL);CHKERRQ(ierr);
+  jac->sym = (MatSORType)(multicolor ? (jac->sym | SOR_MULTICOLOR) : (jac->sym & ~SOR_MULTICOLOR));
   ierr = PetscOptionsTail();CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -114,6 +116,7 @@ PetscErrorCode PCView_SOR(PC pc,PetscViewer viewer)
     else if (sym & SOR_LOCAL_BACKWARD_SWEEP)                                 sortype = "local_backward";
     else                                                                     sortype = "unknown";
     ierr = PetscViewerASCIIPrintf(viewer,"  type = %s, iterations = %D, local iterations = %D, omega = %g\n",sortype,jac->its,jac->lits,(double)jac->omega);CHKERRQ(ierr);
+    if (sym & SOR_MULTICOLOR) {ierr = PetscViewerASCIIPrintf(viewer,"  multicolor sweeps\n");CHKERRQ(ierr);}
   }
   PetscFunctionReturn(0);
 }
@@ -197,15 +200,20 @@ static PetscErrorCode  PCSORGetIterations_SOR(PC pc,PetscInt *its,PetscInt *lits
     SOR_LOCAL_BACKWARD_SWEEP
     SOR_LOCAL_SYMMETRIC_SWEEP
 .ve
+   possibly ORd with SOR_MULTICOLOR
 
    Options Database Keys:
 +  -pc_sor_symmetric - Activates symmetric version
 .  -pc_sor_backward - Activates backward version
 .  -pc_sor_local_forward - Activates local forward version
 .  -pc_sor_local_symmetric - Activates local symmetric version
--  -pc_sor_local_backward - Activates local backward version
+.  -pc_sor_local_backward - Activates local backward version
+-  -pc_sor_multicolor - Adds SOR_MULTICOLOR to the flag
 
    Notes:
+   With SOR_MULTICOLOR the AIJ matrices relax their (local) rows color by color, the rows of each color on the
+   threads given by -mat_sor_threads <n>, see MatSOR().
+
    To use the Eisenstat trick with SSOR, employ the PCEISENSTAT preconditioner,
    which can be chosen with the option
 .  -pc_type eisenstat - Activates Eisenstat trick
@@ -411,7 +419,8 @@ PetscErrorCode  PCSORSetIterations(PC pc,PetscInt its,PetscInt lits)
 .  -pc_sor_omega <omega> - Sets omega
 .  -pc_sor_diagonal_shift <shift> - shift the diagonal entries; useful if the matrix has zeros on the diagonal
 .  -pc_sor_its <its> - Sets number of iterations   (default 1)
--  -pc_sor_lits <lits> - Sets number of local iterations  (default 1)
+.  -pc_sor_lits <lits> - Sets number of local iterations  (default 1)
+-  -pc_sor_multicolor - Relaxes the rows of AIJ matrices color by color, with -mat_sor_threads <n> threads for each color
 
    Level: beginner
 
@@ -433,7 +442,10 @@ PetscErrorCode  PCSORSetIterations(PC pc,PetscInt its,PetscInt lits)
           If used with KSPRICHARDSON and no monitors the convergence test is skipped to improve speed, thus it always iterates 
           the maximum number of iterations you've selected for KSP. It is usually used in this mode as a smoother for multigrid.
           
-          If omega != 1, you will need to set the MAT_USE_INODES option to PETSC_FALSE on the matrix.
+          If omega != 1, you will need to set the MAT_USE_INODES option to PETSC_FALSE on the matrix, unless -pc_sor_multicolor is used.
+
+          With -pc_sor_multicolor, as a smoother of PCMG use -mg_levels_pc_sor_multicolor, the sweeps of AIJ matrices are
+          pointwise in the order of a coloring of the rows, see MatSOR().
 
 .seealso:  PCCreate(), PCSetType(), PCType (for list of available types), PC,
            PCSORSetIterations(), PCSORSetSymmetric(), PCSORSetOmega(), PCEISENSTAT, MatSetOption()
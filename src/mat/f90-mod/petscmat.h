@@ -154,6 +154,7 @@
       PetscEnum, parameter :: SOR_EISENSTAT=32
       PetscEnum, parameter :: SOR_APPLY_UPPER=64
       PetscEnum, parameter :: SOR_APPLY_LOWER=128
+      PetscEnum, parameter :: SOR_MULTICOLOR=256
 !
 !  MatOperation
 !
@@ -444,6 +445,7 @@
 !DEC$ ATTRIBUTES DLLEXPORT::SOR_EISENSTAT
 !DEC$ ATTRIBUTES DLLEXPORT::SOR_APPLY_UPPER
 !DEC$ ATTRIBUTES DLLEXPORT::SOR_APPLY_LOWER
+!DEC$ ATTRIBUTES DLLEXPORT::SOR_MULTICOLOR
 !DEC$ ATTRIBUTES DLLEXPORT::MATOP_SET_VALUES
 !DEC$ ATTRIBUTES DLLEXPORT::MATOP_GET_ROWMATOP_RESTORE_ROW
 !DEC$ ATTRIBUTES DLLEXPORT::MATOP_MULT
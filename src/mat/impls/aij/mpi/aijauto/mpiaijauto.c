@@ -0,0 +1,147 @@
+#include <../src/mat/impls/aij/mpi/mpiaij.h>
+/*@C
+   MatCreateMPIAIJAuto - Creates a sparse parallel matrix whose local
+   portions are stored as SEQAIJAUTO matrices (a matrix class that inherits
+   from SEQAIJ but selects the fastest storage format for the matrix-vector products by timing them).
+   The same guidelines that apply to MPIAIJ matrices for preallocating the
+   matrix storage apply here as well.
+
+      Collective
+
+   Input Parameters:
++  comm - MPI communicator
+.  m - number of local rows (or PETSC_DECIDE to have calculated if M is given)
+           This value should be the same as the local size used in creating the
+           y vector for the matrix-vector product y = Ax.
+.  n - This value should be the same as the local size used in creating the
+       x vector for the matrix-vector product y = Ax. (or PETSC_DECIDE to have
+       calculated if N is given) For square matrices n is almost always m.
+.  M - number of global rows (or PETSC_DETERMINE to have calculated if m is given)
+.  N - number of global columns (or PETSC_DETERMINE to have calculated if n is given)
+.  d_nz  - number of nonzeros per row in DIAGONAL portion of local submatrix
+           (same value is used for all local rows)
+.  d_nnz - array containing the number of nonzeros in the various rows of the
+           DIAGONAL portion of the local submatrix (possibly different for each row)
+           or NULL, if d_nz is used to specify the nonzero structure.
+           The size of this array is equal to the number of local rows, i.e 'm'.
+.  o_nz  - number of nonzeros per row in the OFF-DIAGONAL portion of local
+           submatrix (same value is used for all local rows).
+-  o_nnz - array containing the number of nonzeros in the various rows of the
+           OFF-DIAGONAL portion of the local submatrix (possibly different for
+           each row) or NULL, if o_nz is used to specify the nonzero
+           structure. The size of this array is equal to the number
+           of local rows, i.e 'm'.
+
+   Output Parameter:
+.  A - the matrix
+
+   Notes:
+   If the *_nnz parameter is given then the *_nz parameter is ignored
+
+   When calling this routine with a single process communicator, a matrix of
+   type SEQAIJAUTO is returned.
+
+   The formats of the diagonal and off-diagonal blocks are selected independently on each process.
+
+   Level: intermediate
+
+.seealso: MatCreate(), MatCreateSeqAIJAuto(), MatSetValues()
+@*/
+PetscErrorCode  MatCreateMPIAIJAuto(MPI_Comm comm,PetscInt m,PetscInt n,PetscInt M,PetscInt N,PetscInt d_nz,const PetscInt d_nnz[],PetscInt o_nz,const PetscInt o_nnz[],Mat *A)
+{
+  PetscErrorCode ierr;
+  PetscMPIInt    size;
+
+  PetscFunctionBegin;
+  ierr = MatCreate(comm,A);CHKERRQ(ierr);
+  ierr = MatSetSizes(*A,m,n,M,N);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
+  if (size > 1) {
+    ierr = MatSetType(*A,MATMPIAIJAUTO);CHKERRQ(ierr);
+    ierr = MatMPIAIJSetPreallocation(*A,d_nz,d_nnz,o_nz,o_nnz);CHKERRQ(ierr);
+  } else {
+    ierr = MatSetType(*A,MATSEQAIJAUTO);CHKERRQ(ierr);
+    ierr = MatSeqAIJSetPreallocation(*A,d_nz,d_nnz);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode  MatMPIAIJSetPreallocation_MPIAIJAuto(Mat B,PetscInt d_nz,const PetscInt d_nnz[],PetscInt o_nz,const PetscInt o_nnz[])
+{
+  Mat_MPIAIJ     *b = (Mat_MPIAIJ*)B->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatMPIAIJSetPreallocation_MPIAIJ(B,d_nz,d_nnz,o_nz,o_nnz);CHKERRQ(ierr);
+  ierr = MatConvert_SeqAIJ_SeqAIJAuto(b->A,MATSEQAIJAUTO,MAT_INPLACE_MATRIX,&b->A);CHKERRQ(ierr);
+  ierr = MatConvert_SeqAIJ_SeqAIJAuto(b->B,MATSEQAIJAUTO,MAT_INPLACE_MATRIX,&b->B);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJAuto(Mat A,MatType type,MatReuse reuse,Mat *newmat)
+{
+  PetscErrorCode ierr;
+  Mat            B = *newmat;
+  Mat_MPIAIJ     *b;
+
+  PetscFunctionBegin;
+  if (reuse == MAT_INITIAL_MATRIX) {
+    ierr = MatDuplicate(A,MAT_COPY_VALUES,&B);CHKERRQ(ierr);
+  }
+
+  ierr = PetscObjectChangeTypeName((PetscObject)B,MATMPIAIJAUTO);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatMPIAIJSetPreallocation_C",MatMPIAIJSetPreallocation_MPIAIJAuto);CHKERRQ(ierr);
+
+  /* Convert the local blocks if they already exist, for example when converting an assembled matrix */
+  b = (Mat_MPIAIJ*)B->data;
+  if (b->A) {
+    ierr = MatConvert_SeqAIJ_SeqAIJAuto(b->A,MATSEQAIJAUTO,MAT_INPLACE_MATRIX,&b->A);CHKERRQ(ierr);
+  }
+  if (b->B) {
+    ierr = MatConvert_SeqAIJ_SeqAIJAuto(b->B,MATSEQAIJAUTO,MAT_INPLACE_MATRIX,&b->B);CHKERRQ(ierr);
+  }
+  *newmat = B;
+  PetscFunctionReturn(0);
+}
+
+PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJAuto(Mat A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSetType(A,MATMPIAIJ);CHKERRQ(ierr);
+  ierr = MatConvert_MPIAIJ_MPIAIJAuto(A,MATMPIAIJAUTO,MAT_INPLACE_MATRIX,&A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*MC
+   MATAIJAUTO - MATAIJAUTO = "aijauto" - A matrix type to be used for sparse matrices whose
+   format for MatMult() and MatMultAdd() is selected automatically. The first time the matrix is applied after its
+   nonzero structure has been set, a few products are timed with each of the SEQAIJ, SEQSELL, SEQAIJPERM, SEQAIJCRL and
+   SEQBAIJ formats (the latter when the nonzeros form dense blocks), and the fastest one is kept as a copy of the matrix
+   that is used by the following products. Matrices from different applications thus get a suitable format without
+   choosing -mat_type for each of them.
+
+   This matrix type is identical to MATSEQAIJAUTO when constructed with a single process communicator,
+   and MATMPIAIJAUTO otherwise.  As a result, for single process communicators,
+   MatSeqAIJSetPreallocation() is supported, and similarly MatMPIAIJSetPreallocation() is supported
+   for communicators controlling multiple processes.  It is recommended that you call both of
+   the above preallocation routines for simplicity.
+
+   Options Database Keys:
++  -mat_type aijauto - sets the matrix type to "aijauto" during a call to MatSetFromOptions()
+.  -mat_seqaij_type seqaijauto - use MATSEQAIJAUTO for all sequential AIJ matrices, including the coarse matrices computed by PCGAMG
+.  -mat_aijauto_formats <aij,sell,aijperm,aijcrl,baij> - the formats to try
+.  -mat_aijauto_trials <5> - the number of timed products with each format
+-  -mat_aijauto_sell_fill <1.5> - SEQSELL is not tried if its padding would increase the number of stored values by more than this ratio
+
+  Notes:
+  All other operations use the AIJ storage. The copy in the selected format costs additional memory, and it is updated
+  when it is used after the values of the matrix have changed. Run with -info to see the timings and the selected formats;
+  -log_view shows the products done with each format in the events "MatMult Autoaij", "MatMult Autosell" etc. and the
+  time spent selecting them in "MatAutoSelect".
+
+  Level: beginner
+
+.seealso: MatCreateMPIAIJAuto(), MatCreateSeqAIJAuto(), MATSEQAIJAUTO, MATMPIAIJAUTO, MATAIJSELL, MATAIJPERM, MATAIJCRL, MATBAIJ
+M*/
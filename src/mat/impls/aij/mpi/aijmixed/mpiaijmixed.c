@@ -0,0 +1,147 @@
+#include <../src/mat/impls/aij/mpi/mpiaij.h>
+/*@C
+   MatCreateMPIAIJMixed - Creates a sparse parallel matrix whose local
+   portions are stored as SEQAIJMIXED matrices (a matrix class that inherits
+   from SEQAIJ but uses single precision matrix values in the matrix-vector products and MatSOR()).
+   The same guidelines that apply to MPIAIJ matrices for preallocating the
+   matrix storage apply here as well.
+
+      Collective
+
+   Input Parameters:
++  comm - MPI communicator
+.  m - number of local rows (or PETSC_DECIDE to have calculated if M is given)
+           This value should be the same as the local size used in creating the
+           y vector for the matrix-vector product y = Ax.
+.  n - This value should be the same as the local size used in creating the
+       x vector for the matrix-vector product y = Ax. (or PETSC_DECIDE to have
+       calculated if N is given) For square matrices n is almost always m.
+.  M - number of global rows (or PETSC_DETERMINE to have calculated if m is given)
+.  N - number of global columns (or PETSC_DETERMINE to have calculated if n is given)
+.  d_nz  - number of nonzeros per row in DIAGONAL portion of local submatrix
+           (same value is used for all local rows)
+.  d_nnz - array containing the number of nonzeros in the various rows of the
+           DIAGONAL portion of the local submatrix (possibly different for each row)
+           or NULL, if d_nz is used to specify the nonzero structure.
+           The size of this array is equal to the number of local rows, i.e 'm'.
+.  o_nz  - number of nonzeros per row in the OFF-DIAGONAL portion of local
+           submatrix (same value is used for all local rows).
+-  o_nnz - array containing the number of nonzeros in the various rows of the
+           OFF-DIAGONAL portion of the local submatrix (possibly different for
+           each row) or NULL, if o_nz is used to specify the nonzero
+           structure. The size of this array is equal to the number
+           of local rows, i.e 'm'.
+
+   Output Parameter:
+.  A - the matrix
+
+   Notes:
+   If the *_nnz parameter is given then the *_nz parameter is ignored
+
+   When calling this routine with a single process communicator, a matrix of
+   type SEQAIJMIXED is returned.
+
+   The local rows of MatSOR() with the MPIAIJ matrix are swept with the single precision values of the diagonal block.
+
+   Level: intermediate
+
+.seealso: MatCreate(), MatCreateSeqAIJMixed(), MatSetValues()
+@*/
+PetscErrorCode  MatCreateMPIAIJMixed(MPI_Comm comm,PetscInt m,PetscInt n,PetscInt M,PetscInt N,PetscInt d_nz,const PetscInt d_nnz[],PetscInt o_nz,const PetscInt o_nnz[],Mat *A)
+{
+  PetscErrorCode ierr;
+  PetscMPIInt    size;
+
+  PetscFunctionBegin;
+  ierr = MatCreate(comm,A);CHKERRQ(ierr);
+  ierr = MatSetSizes(*A,m,n,M,N);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
+  if (size > 1) {
+    ierr = MatSetType(*A,MATMPIAIJMIXED);CHKERRQ(ierr);
+    ierr = MatMPIAIJSetPreallocation(*A,d_nz,d_nnz,o_nz,o_nnz);CHKERRQ(ierr);
+  } else {
+    ierr = MatSetType(*A,MATSEQAIJMIXED);CHKERRQ(ierr);
+    ierr = MatSeqAIJSetPreallocation(*A,d_nz,d_nnz);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode  MatMPIAIJSetPreallocation_MPIAIJMixed(Mat B,PetscInt d_nz,const PetscInt d_nnz[],PetscInt o_nz,const PetscInt o_nnz[])
+{
+  Mat_MPIAIJ     *b = (Mat_MPIAIJ*)B->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatMPIAIJSetPreallocation_MPIAIJ(B,d_nz,d_nnz,o_nz,o_nnz);CHKERRQ(ierr);
+  ierr = MatConvert_SeqAIJ_SeqAIJMixed(b->A,MATSEQAIJMIXED,MAT_INPLACE_MATRIX,&b->A);CHKERRQ(ierr);
+  ierr = MatConvert_SeqAIJ_SeqAIJMixed(b->B,MATSEQAIJMIXED,MAT_INPLACE_MATRIX,&b->B);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJMixed(Mat A,MatType type,MatReuse reuse,Mat *newmat)
+{
+  PetscErrorCode ierr;
+  Mat            B = *newmat;
+  Mat_MPIAIJ     *b;
+
+  PetscFunctionBegin;
+  if (reuse == MAT_INITIAL_MATRIX) {
+    ierr = MatDuplicate(A,MAT_COPY_VALUES,&B);CHKERRQ(ierr);
+  }
+
+  ierr = PetscObjectChangeTypeName((PetscObject)B,MATMPIAIJMIXED);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatMPIAIJSetPreallocation_C",MatMPIAIJSetPreallocation_MPIAIJMixed);CHKERRQ(ierr);
+
+  /* Convert the local blocks if they already exist, for example when converting an assembled matrix */
+  b = (Mat_MPIAIJ*)B->data;
+  if (b->A) {
+    ierr = MatConvert_SeqAIJ_SeqAIJMixed(b->A,MATSEQAIJMIXED,MAT_INPLACE_MATRIX,&b->A);CHKERRQ(ierr);
+  }
+  if (b->B) {
+    ierr = MatConvert_SeqAIJ_SeqAIJMixed(b->B,MATSEQAIJMIXED,MAT_INPLACE_MATRIX,&b->B);CHKERRQ(ierr);
+  }
+  *newmat = B;
+  PetscFunctionReturn(0);
+}
+
+PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJMixed(Mat A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSetType(A,MATMPIAIJ);CHKERRQ(ierr);
+  ierr = MatConvert_MPIAIJ_MPIAIJMixed(A,MATMPIAIJMIXED,MAT_INPLACE_MATRIX,&A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*MC
+   MATAIJMIXED - MATAIJMIXED = "aijmixed" - A matrix type to be used for sparse matrices whose
+   values are also stored in single precision, and used in single precision with vectors in full precision
+   by MatMult(), MatMultAdd(), MatMultTranspose(), MatMultTransposeAdd() and MatSOR(). These kernels are limited
+   by the memory bandwidth, so reading four byte values instead of eight makes them faster, at the price of
+   perturbing the operator by the single precision rounding. This is intended for preconditioners, for example
+   the matrices of a PCMG hierarchy smoothed with PCSOR or Chebyshev, while the Krylov method uses the operator
+   in full precision.
+
+   This matrix type is identical to MATSEQAIJMIXED when constructed with a single process communicator,
+   and MATMPIAIJMIXED otherwise.  As a result, for single process communicators,
+   MatSeqAIJSetPreallocation() is supported, and similarly MatMPIAIJSetPreallocation() is supported
+   for communicators controlling multiple processes.  It is recommended that you call both of
+   the above preallocation routines for simplicity.
+
+   Options Database Keys:
++  -mat_type aijmixed - sets the matrix type to "aijmixed" during a call to MatSetFromOptions()
+-  -mat_seqaij_type seqaijmixed - use MATSEQAIJMIXED for all sequential AIJ matrices, including the coarse matrices computed by PCGAMG
+
+  Notes:
+  The full precision values are kept and used by all other operations, such as the factorizations and the matrix-matrix products.
+  The single precision values are recomputed when they are used after the matrix has been changed. Not available for complex numbers.
+  The column indices are read as before, so with 32-bit indices MatMult() reads about 8 instead of 12 bytes per nonzero.
+  The single precision copy comes in addition to the full precision values, so the matrix takes 4 more bytes per nonzero
+  than MATAIJ; only the traffic of the kernels above is reduced, never the memory use. The factorizations, hence the ILU and
+  ICC factors of PCILU, PCICC, PCBJACOBI and PCASM, are computed and applied in full precision and gain nothing from this type.
+
+  Level: beginner
+
+.seealso: MatCreateMPIAIJMixed(), MatCreateSeqAIJMixed(), MATSEQAIJMIXED, MATMPIAIJMIXED, MATAIJPERM, MATAIJOMP
+M*/
@@ -0,0 +1,168 @@
+#include <../src/mat/impls/aij/mpi/mpiaij.h>
+/*@C
+   MatCreateMPIAIJVBlock - Creates a sparse parallel matrix whose local
+   portions are stored as SEQAIJVBLOCK matrices (a matrix class that inherits
+   from SEQAIJ but also stores the matrix as dense blocks of variable size).
+   The same guidelines that apply to MPIAIJ matrices for preallocating the
+   matrix storage apply here as well.
+
+      Collective
+
+   Input Parameters:
++  comm - MPI communicator
+.  m - number of local rows (or PETSC_DECIDE to have calculated if M is given)
+           This value should be the same as the local size used in creating the
+           y vector for the matrix-vector product y = Ax.
+.  n - This value should be the same as the local size used in creating the
+       x vector for the matrix-vector product y = Ax. (or PETSC_DECIDE to have
+       calculated if N is given) For square matrices n is almost always m.
+.  M - number of global rows (or PETSC_DETERMINE to have calculated if m is given)
+.  N - number of global columns (or PETSC_DETERMINE to have calculated if n is given)
+.  d_nz  - number of nonzeros per row in DIAGONAL portion of local submatrix
+           (same value is used for all local rows)
+.  d_nnz - array containing the number of nonzeros in the various rows of the
+           DIAGONAL portion of the local submatrix (possibly different for each row)
+           or NULL, if d_nz is used to specify the nonzero structure.
+           The size of this array is equal to the number of local rows, i.e 'm'.
+.  o_nz  - number of nonzeros per row in the OFF-DIAGONAL portion of local
+           submatrix (same value is used for all local rows).
+-  o_nnz - array containing the number of nonzeros in the various rows of the
+           OFF-DIAGONAL portion of the local submatrix (possibly different for
+           each row) or NULL, if o_nz is used to specify the nonzero
+           structure. The size of this array is equal to the number
+           of local rows, i.e 'm'.
+
+   Output Parameter:
+.  A - the matrix
+
+   Notes:
+   If the *_nnz parameter is given then the *_nz parameter is ignored
+
+   When calling this routine with a single process communicator, a matrix of
+   type SEQAIJVBLOCK is returned.
+
+   Only the diagonal block of each process is stored as dense blocks, with the variable block sizes of the matrix;
+   the off-diagonal block uses the SEQAIJ storage.
+
+   Level: intermediate
+
+.seealso: MatCreate(), MatCreateSeqAIJVBlock(), MatSetValues(), MatSetVariableBlockSizes()
+@*/
+PetscErrorCode  MatCreateMPIAIJVBlock(MPI_Comm comm,PetscInt m,PetscInt n,PetscInt M,PetscInt N,PetscInt d_nz,const PetscInt d_nnz[],PetscInt o_nz,const PetscInt o_nnz[],Mat *A)
+{
+  PetscErrorCode ierr;
+  PetscMPIInt    size;
+
+  PetscFunctionBegin;
+  ierr = MatCreate(comm,A);CHKERRQ(ierr);
+  ierr = MatSetSizes(*A,m,n,M,N);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
+  if (size > 1) {
+    ierr = MatSetType(*A,MATMPIAIJVBLOCK);CHKERRQ(ierr);
+    ierr = MatMPIAIJSetPreallocation(*A,d_nz,d_nnz,o_nz,o_nnz);CHKERRQ(ierr);
+  } else {
+    ierr = MatSetType(*A,MATSEQAIJVBLOCK);CHKERRQ(ierr);
+    ierr = MatSeqAIJSetPreallocation(*A,d_nz,d_nnz);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode  MatMPIAIJSetPreallocation_MPIAIJVBlock(Mat B,PetscInt d_nz,const PetscInt d_nnz[],PetscInt o_nz,const PetscInt o_nnz[])
+{
+  Mat_MPIAIJ     *b = (Mat_MPIAIJ*)B->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatMPIAIJSetPreallocation_MPIAIJ(B,d_nz,d_nnz,o_nz,o_nnz);CHKERRQ(ierr);
+  ierr = MatConvert_SeqAIJ_SeqAIJVBlock(b->A,MATSEQAIJVBLOCK,MAT_INPLACE_MATRIX,&b->A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   The variable block sizes of the matrix are those of its diagonal block: the ones set with MatSetVariableBlockSizes()
+   are passed to the diagonal block, otherwise the ones detected by the diagonal block are set on the matrix
+*/
+PetscErrorCode MatAssemblyEnd_MPIAIJVBlock(Mat A,MatAssemblyType mode)
+{
+  Mat_MPIAIJ     *a = (Mat_MPIAIJ*)A->data;
+  PetscBool      same;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatAssemblyEnd_MPIAIJ(A,mode);CHKERRQ(ierr);
+  if (mode == MAT_FLUSH_ASSEMBLY || A->rmap->n != A->cmap->n) PetscFunctionReturn(0);
+  if (!A->nblocks) {
+    if (a->A->nblocks) {ierr = MatSetVariableBlockSizes(A,a->A->nblocks,a->A->bsizes);CHKERRQ(ierr);}
+  } else {
+    same = (PetscBool)(A->nblocks == a->A->nblocks);
+    if (same) {ierr = PetscArraycmp(A->bsizes,a->A->bsizes,A->nblocks,&same);CHKERRQ(ierr);}
+    if (!same) {ierr = MatSetVariableBlockSizes(a->A,A->nblocks,A->bsizes);CHKERRQ(ierr);}
+  }
+  PetscFunctionReturn(0);
+}
+
+PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJVBlock(Mat A,MatType type,MatReuse reuse,Mat *newmat)
+{
+  PetscErrorCode ierr;
+  Mat            B = *newmat;
+  Mat_MPIAIJ     *b;
+
+  PetscFunctionBegin;
+  if (reuse == MAT_INITIAL_MATRIX) {
+    ierr = MatDuplicate(A,MAT_COPY_VALUES,&B);CHKERRQ(ierr);
+    if (A->nblocks) {ierr = MatSetVariableBlockSizes(B,A->nblocks,A->bsizes);CHKERRQ(ierr);}
+  }
+
+  ierr = PetscObjectChangeTypeName((PetscObject)B,MATMPIAIJVBLOCK);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatMPIAIJSetPreallocation_C",MatMPIAIJSetPreallocation_MPIAIJVBlock);CHKERRQ(ierr);
+  B->ops->assemblyend = MatAssemblyEnd_MPIAIJVBlock;
+
+  /* Convert the diagonal block if it already exists, for example when converting an assembled matrix */
+  b = (Mat_MPIAIJ*)B->data;
+  if (b->A) {
+    if (B->nblocks && B->rmap->n == B->cmap->n) {ierr = MatSetVariableBlockSizes(b->A,B->nblocks,B->bsizes);CHKERRQ(ierr);}
+    ierr = MatConvert_SeqAIJ_SeqAIJVBlock(b->A,MATSEQAIJVBLOCK,MAT_INPLACE_MATRIX,&b->A);CHKERRQ(ierr);
+    if (B->assembled && !B->nblocks && b->A->nblocks) {ierr = MatSetVariableBlockSizes(B,b->A->nblocks,b->A->bsizes);CHKERRQ(ierr);}
+  }
+  *newmat = B;
+  PetscFunctionReturn(0);
+}
+
+PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJVBlock(Mat A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSetType(A,MATMPIAIJ);CHKERRQ(ierr);
+  ierr = MatConvert_MPIAIJ_MPIAIJVBlock(A,MATMPIAIJVBLOCK,MAT_INPLACE_MATRIX,&A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*MC
+   MATAIJVBLOCK - MATAIJVBLOCK = "aijvblock" - A matrix type to be used for sparse matrices whose nonzeros form
+   dense blocks of variable size, for example the Jacobians of coupled problems with different numbers of unknowns at
+   the nodes. The blocks are the variable block sizes set with MatSetVariableBlockSizes() or, if none were set before the
+   first assembly, groups of consecutive rows with the same nonzero columns. In addition to the AIJ storage, the matrix
+   is stored as dense blocks in compressed block rows, which are used by MatMult(), MatMultAdd(), MatSOR() (block
+   Gauss-Seidel) and MatInvertVariableBlockDiagonal(). The inverses of the diagonal blocks computed for MatSOR() are
+   used by PCVPBJACOBI without extracting the blocks again.
+
+   This matrix type is identical to MATSEQAIJVBLOCK when constructed with a single process communicator,
+   and MATMPIAIJVBLOCK otherwise.  As a result, for single process communicators,
+   MatSeqAIJSetPreallocation() is supported, and similarly MatMPIAIJSetPreallocation() is supported
+   for communicators controlling multiple processes.  It is recommended that you call both of
+   the above preallocation routines for simplicity.
+
+   Options Database Keys:
++  -mat_type aijvblock - sets the matrix type to "aijvblock" during a call to MatSetFromOptions()
+-  -mat_aijvblock_max_bs <16> - the largest size of the blocks detected from the nonzero structure
+
+  Notes:
+  All other operations use the AIJ storage. The blocks cost additional memory, and their values are updated when they
+  are used after the values of the matrix have changed. Entries of the blocks that are not nonzeros of the matrix are
+  stored as zeros. Run with -info to see the detected block sizes and the number of stored values.
+
+  Level: beginner
+
+.seealso: MatCreateMPIAIJVBlock(), MatCreateSeqAIJVBlock(), MATSEQAIJVBLOCK, MATMPIAIJVBLOCK, MatSetVariableBlockSizes(), PCVPBJACOBI, MATBAIJ
+M*/
@@ -19,7 +19,7 @@
 . -mat_type aij - sets the matrix type to "aij" during a call to MatSetFromOptions()
 
   Developer Notes:
-    Subclasses include MATAIJCUSP, MATAIJCUSPARSE, MATAIJPERM, MATAIJSELL, MATAIJMKL, MATAIJCRL, and also automatically switches over to use inodes when
+    Subclasses include MATAIJCUSP, MATAIJCUSPARSE, MATAIJPERM, MATAIJSELL, MATAIJOMP, MATAIJMIXED, MATAIJAUTO, MATAIJVBLOCK, MATAIJDELTA, MATAIJMKL, MATAIJCRL, and also automatically switches over to use inodes when
    enough exist.
 
   Level: beginner
@@ -1091,6 +1091,9 @@ PetscErrorCode MatZeroRowsColumns_MPIAIJ(Mat A,PetscInt N,const PetscInt rows[],
   ierr = VecRestoreArray(lmask,&mask);CHKERRQ(ierr);
   ierr = VecDestroy(&lmask);CHKERRQ(ierr);
   ierr = PetscFree(lrows);CHKERRQ(ierr);
+  /* the values of the blocks were changed directly, derived data of the blocks must see it */
+  ierr = PetscObjectStateIncrease((PetscObject)l->A);CHKERRQ(ierr);
+  ierr = PetscObjectStateIncrease((PetscObject)l->B);CHKERRQ(ierr);
 
   /* only change matrix nonzero state if pattern was allowed to be changed */
   if (!((Mat_SeqAIJ*)(l->A->data))->keepnonzeropattern) {
@@ -1252,6 +1255,22 @@ PetscErrorCode MatScale_MPIAIJ(Mat A,PetscScalar aa)
   PetscFunctionReturn(0);
 }
 
+static PetscErrorCode MatResetCOO_MPIAIJ(Mat mat)
+{
+  Mat_MPIAIJ     *aij = (Mat_MPIAIJ*)mat->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFDestroy(&aij->coo_sf);CHKERRQ(ierr);
+  ierr = PetscFree(aij->coo_sendperm);CHKERRQ(ierr);
+  ierr = PetscFree2(aij->coo_sendbuf,aij->coo_recvbuf);CHKERRQ(ierr);
+  ierr = PetscFree4(aij->coo_Ajmap1,aij->coo_Aperm1,aij->coo_Ajmap2,aij->coo_Aperm2);CHKERRQ(ierr);
+  ierr = PetscFree4(aij->coo_Bjmap1,aij->coo_Bperm1,aij->coo_Bjmap2,aij->coo_Bperm2);CHKERRQ(ierr);
+  aij->coo_nsend = 0;
+  aij->coo_nrecv = 0;
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode MatDestroy_MPIAIJ(Mat mat)
 {
   Mat_MPIAIJ     *aij = (Mat_MPIAIJ*)mat->data;
@@ -1276,6 +1295,7 @@ PetscErrorCode MatDestroy_MPIAIJ(Mat mat)
   if (aij->Mvctx_mpi1) {ierr = VecScatterDestroy(&aij->Mvctx_mpi1);CHKERRQ(ierr);}
   ierr = PetscFree2(aij->rowvalues,aij->rowindices);CHKERRQ(ierr);
   ierr = PetscFree(aij->ld);CHKERRQ(ierr);
+  ierr = MatResetCOO_MPIAIJ(mat);CHKERRQ(ierr);
   ierr = PetscFree(mat->data);CHKERRQ(ierr);
 
   /* may be created by MatCreateMPIAIJSumSeqAIJSymbolic */
@@ -1288,6 +1308,8 @@ PetscErrorCode MatDestroy_MPIAIJ(Mat mat)
   ierr = PetscObjectComposeFunction((PetscObject)mat,"MatMPIAIJSetPreallocation_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)mat,"MatResetPreallocation_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)mat,"MatMPIAIJSetPreallocationCSR_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)mat,"MatSetPreallocationCOO_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)mat,"MatSetValuesCOO_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)mat,"MatDiagonalScaleLocal_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)mat,"MatConvert_mpiaij_mpibaij_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)mat,"MatConvert_mpiaij_mpisbaij_C",NULL);CHKERRQ(ierr);
@@ -1556,7 +1578,7 @@ PetscErrorCode MatSOR_MPIAIJ(Mat matin,Vec bb,PetscReal omega,MatSORType flag,Pe
       ierr = (*mat->B->ops->multadd)(mat->B,mat->lvec,bb,bb1);CHKERRQ(ierr);
 
       /* local sweep */
-      ierr = (*mat->A->ops->sor)(mat->A,bb1,omega,SOR_SYMMETRIC_SWEEP,fshift,lits,1,xx);CHKERRQ(ierr);
+      ierr = (*mat->A->ops->sor)(mat->A,bb1,omega,(MatSORType)(SOR_SYMMETRIC_SWEEP | (flag & SOR_MULTICOLOR)),fshift,lits,1,xx);CHKERRQ(ierr);
     }
   } else if (flag & SOR_LOCAL_FORWARD_SWEEP) {
     if (flag & SOR_ZERO_INITIAL_GUESS) {
@@ -1572,7 +1594,7 @@ PetscErrorCode MatSOR_MPIAIJ(Mat matin,Vec bb,PetscReal omega,MatSORType flag,Pe
       ierr = (*mat->B->ops->multadd)(mat->B,mat->lvec,bb,bb1);CHKERRQ(ierr);
 
       /* local sweep */
-      ierr = (*mat->A->ops->sor)(mat->A,bb1,omega,SOR_FORWARD_SWEEP,fshift,lits,1,xx);CHKERRQ(ierr);
+      ierr = (*mat->A->ops->sor)(mat->A,bb1,omega,(MatSORType)(SOR_FORWARD_SWEEP | (flag & SOR_MULTICOLOR)),fshift,lits,1,xx);CHKERRQ(ierr);
     }
   } else if (flag & SOR_LOCAL_BACKWARD_SWEEP) {
     if (flag & SOR_ZERO_INITIAL_GUESS) {
@@ -1588,7 +1610,7 @@ PetscErrorCode MatSOR_MPIAIJ(Mat matin,Vec bb,PetscReal omega,MatSORType flag,Pe
       ierr = (*mat->B->ops->multadd)(mat->B,mat->lvec,bb,bb1);CHKERRQ(ierr);
 
       /* local sweep */
-      ierr = (*mat->A->ops->sor)(mat->A,bb1,omega,SOR_BACKWARD_SWEEP,fshift,lits,1,xx);CHKERRQ(ierr);
+      ierr = (*mat->A->ops->sor)(mat->A,bb1,omega,(MatSORType)(SOR_BACKWARD_SWEEP | (flag & SOR_MULTICOLOR)),fshift,lits,1,xx);CHKERRQ(ierr);
     }
   } else if (flag & SOR_EISENSTAT) {
     Vec xx1;
@@ -2232,6 +2254,9 @@ PetscErrorCode MatAXPY_MPIAIJ(Mat Y,PetscScalar a,Mat X,MatStructure str)
     y    = (Mat_SeqAIJ*)yy->B->data;
     ierr = PetscBLASIntCast(x->nz,&bnz);CHKERRQ(ierr);
     PetscStackCallBLAS("BLASaxpy",BLASaxpy_(&bnz,&alpha,x->a,&one,y->a,&one));
+    /* the blocks may cache data derived from their values, see MATAIJMIXED */
+    ierr = PetscObjectStateIncrease((PetscObject)yy->A);CHKERRQ(ierr);
+    ierr = PetscObjectStateIncrease((PetscObject)yy->B);CHKERRQ(ierr);
     ierr = PetscObjectStateIncrease((PetscObject)Y);CHKERRQ(ierr);
     /* the MatAXPY_Basic* subroutines calls MatAssembly, so the matrix on the GPU
        will be updated */
@@ -3821,6 +3846,244 @@ PetscErrorCode MatMPIAIJSetPreallocationCSR_MPIAIJ(Mat B,const PetscInt Ii[],con
   PetscFunctionReturn(0);
 }
 
+/*
+   Splits the coordinates merged into each nonzero of a diagonal or off-diagonal block by MatCOOBuildCSR_Private() into
+   the local ones (src[e] < nlocal, stored as their position in coo_v) and the received ones (stored as their position
+   in the receive buffer)
+*/
+static PetscErrorCode MatCOOSplitMap_MPIAIJ(PetscInt nz,const PetscInt jmap[],const PetscInt perm[],const PetscInt src[],PetscInt nlocal,PetscInt **jmap1,PetscInt **perm1,PetscInt **jmap2,PetscInt **perm2)
+{
+  PetscInt       k,p,e,n1 = 0,n2 = 0;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  for (p=0; p<jmap[nz]; p++) {
+    if (src[perm[p]] < nlocal) n1++;
+    else n2++;
+  }
+  ierr = PetscMalloc4(nz+1,jmap1,n1,perm1,nz+1,jmap2,n2,perm2);CHKERRQ(ierr);
+  n1 = n2 = 0;
+  (*jmap1)[0] = (*jmap2)[0] = 0;
+  for (k=0; k<nz; k++) {
+    for (p=jmap[k]; p<jmap[k+1]; p++) {
+      e = src[perm[p]];
+      if (e < nlocal) (*perm1)[n1++] = e;
+      else            (*perm2)[n2++] = e - nlocal;
+    }
+    (*jmap1)[k+1] = n1;
+    (*jmap2)[k+1] = n2;
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   The coordinates in rows owned by other processes are packed by owner and sent once, with a PetscSF whose roots are the
+   packed coordinates on the sender and whose leaves are the receive buffer on the owner. The received coordinates are
+   then merged with the local ones into the CSR structure of the diagonal and off-diagonal blocks. MatSetValuesCOO_MPIAIJ()
+   reuses the PetscSF and the maps built here.
+*/
+static PetscErrorCode MatSetPreallocationCOO_MPIAIJ(Mat mat,PetscInt ncoo,const PetscInt coo_i[],const PetscInt coo_j[])
+{
+  Mat_MPIAIJ     *mpiaij = (Mat_MPIAIJ*)mat->data;
+  MPI_Comm       comm;
+  PetscMPIInt    rank,size,owner,nto = 0,nfrom,*toranks,*fromranks;
+  PetscInt       rstart,rend,cstart,cend,m = mat->rmap->n,k,p,r,nlocal = 0,nsend = 0,nrecv = 0,nd = 0,no = 0;
+  PetscInt       *counts,*offsets,*todata,*fromdata,*localperm,*sendi,*sendj,*recvi,*recvj;
+  PetscInt       *drows,*dcols,*dsrc,*orows,*ocols,*osrc,*nnz,*cols;
+  PetscInt       Annz,*Ai,*Aj,*Ajmap,*Aperm,Bnnz,*Bi,*Bj,*Bjmap,*Bperm;
+  PetscScalar    *zeros;
+  PetscSFNode    *iremote;
+  PetscBool      nooffproc;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectGetComm((PetscObject)mat,&comm);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
+  ierr = MatResetCOO_MPIAIJ(mat);CHKERRQ(ierr);
+  rstart = mat->rmap->rstart;
+  rend   = mat->rmap->rend;
+  cstart = mat->cmap->rstart;
+  cend   = mat->cmap->rend;
+
+  /* count the coordinates going to each process, dropping the ones with negative indices */
+  ierr = PetscCalloc2(size,&counts,size+1,&offsets);CHKERRQ(ierr);
+  for (k=0; k<ncoo; k++) {
+    if (coo_i[k] < 0 || coo_j[k] < 0) continue;
+    if (coo_i[k] >= rstart && coo_i[k] < rend) nlocal++;
+    else {
+      ierr = PetscLayoutFindOwner(mat->rmap,coo_i[k],&owner);CHKERRQ(ierr);
+      counts[owner]++;
+      nsend++;
+    }
+  }
+  for (r=0; r<size; r++) {
+    offsets[r+1] = offsets[r] + counts[r];
+    if (counts[r]) nto++;
+  }
+
+  /* pack the coordinates by owner */
+  ierr = PetscMalloc3(nlocal,&localperm,nsend,&sendi,nsend,&sendj);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nsend,&mpiaij->coo_sendperm);CHKERRQ(ierr);
+  ierr = PetscArrayzero(counts,size);CHKERRQ(ierr);
+  for (k=0,nlocal=0; k<ncoo; k++) {
+    if (coo_i[k] < 0 || coo_j[k] < 0) continue;
+    if (coo_i[k] >= rstart && coo_i[k] < rend) localperm[nlocal++] = k;
+    else {
+      ierr = PetscLayoutFindOwner(mat->rmap,coo_i[k],&owner);CHKERRQ(ierr);
+      p    = offsets[owner] + counts[owner]++;
+      sendi[p] = coo_i[k];
+      sendj[p] = coo_j[k];
+      mpiaij->coo_sendperm[p] = k;
+    }
+  }
+
+  /* tell each owner how many coordinates it gets and where they are in the packed array of the sender */
+  ierr = PetscMalloc2(nto,&toranks,2*nto,&todata);CHKERRQ(ierr);
+  for (r=0,nto=0; r<size; r++) {
+    if (!counts[r]) continue;
+    toranks[nto]     = r;
+    todata[2*nto]    = counts[r];
+    todata[2*nto+1]  = offsets[r];
+    nto++;
+  }
+  ierr = PetscCommBuildTwoSided(comm,2,MPIU_INT,nto,toranks,todata,&nfrom,&fromranks,&fromdata);CHKERRQ(ierr);
+  for (r=0; r<nfrom; r++) nrecv += fromdata[2*r];
+  ierr = PetscMalloc1(nrecv,&iremote);CHKERRQ(ierr);
+  for (r=0,p=0; r<nfrom; r++) {
+    for (k=0; k<fromdata[2*r]; k++,p++) {
+      iremote[p].rank  = fromranks[r];
+      iremote[p].index = fromdata[2*r+1] + k;
+    }
+  }
+  ierr = PetscFree2(toranks,todata);CHKERRQ(ierr);
+  ierr = PetscFree(fromranks);CHKERRQ(ierr);
+  ierr = PetscFree(fromdata);CHKERRQ(ierr);
+  ierr = PetscFree2(counts,offsets);CHKERRQ(ierr);
+
+  ierr = PetscSFCreate(comm,&mpiaij->coo_sf);CHKERRQ(ierr);
+  ierr = PetscSFSetGraph(mpiaij->coo_sf,nsend,nrecv,NULL,PETSC_OWN_POINTER,iremote,PETSC_OWN_POINTER);CHKERRQ(ierr);
+  ierr = PetscSFSetUp(mpiaij->coo_sf);CHKERRQ(ierr);
+  mpiaij->coo_nsend = nsend;
+  mpiaij->coo_nrecv = nrecv;
+  ierr = PetscMalloc2(nsend,&mpiaij->coo_sendbuf,nrecv,&mpiaij->coo_recvbuf);CHKERRQ(ierr);
+
+  ierr = PetscMalloc2(nrecv,&recvi,nrecv,&recvj);CHKERRQ(ierr);
+  ierr = PetscSFBcastBegin(mpiaij->coo_sf,MPIU_INT,sendi,recvi);CHKERRQ(ierr);
+  ierr = PetscSFBcastEnd(mpiaij->coo_sf,MPIU_INT,sendi,recvi);CHKERRQ(ierr);
+  ierr = PetscSFBcastBegin(mpiaij->coo_sf,MPIU_INT,sendj,recvj);CHKERRQ(ierr);
+  ierr = PetscSFBcastEnd(mpiaij->coo_sf,MPIU_INT,sendj,recvj);CHKERRQ(ierr);
+
+  /* split the local and received coordinates into the diagonal and the off-diagonal block; src[] numbers the local ones
+     by their position in coo_v and the received ones by nlocal plus their position in the receive buffer */
+  ierr = PetscMalloc6(nlocal+nrecv,&drows,nlocal+nrecv,&dcols,nlocal+nrecv,&dsrc,nlocal+nrecv,&orows,nlocal+nrecv,&ocols,nlocal+nrecv,&osrc);CHKERRQ(ierr);
+  for (k=0; k<nlocal+nrecv; k++) {
+    PetscInt row,col,src;
+    if (k < nlocal) {row = coo_i[localperm[k]]; col = coo_j[localperm[k]]; src = localperm[k];}
+    else            {row = recvi[k-nlocal];     col = recvj[k-nlocal];     src = ncoo + k - nlocal;}
+    if (row < rstart || row >= rend) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Received row %D that is not owned",row);
+    if (col >= cstart && col < cend) {drows[nd] = row - rstart; dcols[nd] = col - cstart; dsrc[nd++] = src;}
+    else                             {orows[no] = row - rstart; ocols[no] = col;          osrc[no++] = src;}
+  }
+  ierr = PetscFree3(localperm,sendi,sendj);CHKERRQ(ierr);
+  ierr = PetscFree2(recvi,recvj);CHKERRQ(ierr);
+
+  ierr = MatCOOBuildCSR_Private(m,nd,drows,dcols,&Annz,&Ai,&Aj,&Ajmap,&Aperm);CHKERRQ(ierr);
+  ierr = MatCOOBuildCSR_Private(m,no,orows,ocols,&Bnnz,&Bi,&Bj,&Bjmap,&Bperm);CHKERRQ(ierr);
+  ierr = MatCOOSplitMap_MPIAIJ(Annz,Ajmap,Aperm,dsrc,ncoo,&mpiaij->coo_Ajmap1,&mpiaij->coo_Aperm1,&mpiaij->coo_Ajmap2,&mpiaij->coo_Aperm2);CHKERRQ(ierr);
+  ierr = MatCOOSplitMap_MPIAIJ(Bnnz,Bjmap,Bperm,osrc,ncoo,&mpiaij->coo_Bjmap1,&mpiaij->coo_Bperm1,&mpiaij->coo_Bjmap2,&mpiaij->coo_Bperm2);CHKERRQ(ierr);
+  ierr = PetscFree6(drows,dcols,dsrc,orows,ocols,osrc);CHKERRQ(ierr);
+  ierr = PetscFree(Ajmap);CHKERRQ(ierr);
+  ierr = PetscFree(Bjmap);CHKERRQ(ierr);
+
+  /* build the nonzero structure, the entries are only in locally owned rows so the assembly communicates no values */
+  ierr = PetscMalloc1(2*m,&nnz);CHKERRQ(ierr);
+  for (r=0,p=0; r<m; r++) {
+    nnz[r]   = Ai[r+1] - Ai[r];
+    nnz[m+r] = Bi[r+1] - Bi[r];
+    p        = PetscMax(p,nnz[r]+nnz[m+r]);
+  }
+  ierr = MatMPIAIJSetPreallocation(mat,0,nnz,0,nnz+m);CHKERRQ(ierr);
+  ierr = PetscFree(nnz);CHKERRQ(ierr);
+  ierr = PetscMalloc1(p,&cols);CHKERRQ(ierr);
+  ierr = PetscCalloc1(p,&zeros);CHKERRQ(ierr);
+  for (r=0; r<m; r++) {
+    PetscInt row = rstart + r,n = 0;
+    for (k=Ai[r]; k<Ai[r+1]; k++) cols[n++] = Aj[k] + cstart;
+    for (k=Bi[r]; k<Bi[r+1]; k++) cols[n++] = Bj[k];
+    ierr = MatSetValues(mat,1,&row,n,cols,zeros,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = PetscFree(cols);CHKERRQ(ierr);
+  ierr = PetscFree(zeros);CHKERRQ(ierr);
+  ierr = PetscFree(Ai);CHKERRQ(ierr);
+  ierr = PetscFree2(Aj,Aperm);CHKERRQ(ierr);
+  ierr = PetscFree(Bi);CHKERRQ(ierr);
+  ierr = PetscFree2(Bj,Bperm);CHKERRQ(ierr);
+  nooffproc = mat->nooffprocentries;
+  ierr = MatSetOption(mat,MAT_NO_OFF_PROC_ENTRIES,PETSC_TRUE);CHKERRQ(ierr);
+  ierr = MatAssemblyBegin(mat,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(mat,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatSetOption(mat,MAT_NO_OFF_PROC_ENTRIES,nooffproc);CHKERRQ(ierr);
+  ierr = MatSetOption(mat,MAT_NEW_NONZERO_LOCATION_ERR,PETSC_TRUE);CHKERRQ(ierr);
+
+  /* the diagonal block is in the same order as the sorted coordinates, and so is the off-diagonal one since garray[] is sorted */
+  if (((Mat_SeqAIJ*)mpiaij->A->data)->nz != Annz) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Number of nonzeros %D in the diagonal block does not match the coordinates %D",((Mat_SeqAIJ*)mpiaij->A->data)->nz,Annz);
+  if (((Mat_SeqAIJ*)mpiaij->B->data)->nz != Bnnz) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Number of nonzeros %D in the off-diagonal block does not match the coordinates %D",((Mat_SeqAIJ*)mpiaij->B->data)->nz,Bnnz);
+  mpiaij->coo_nonzerostate = mat->nonzerostate;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSetValuesCOO_MPIAIJ(Mat mat,const PetscScalar v[],InsertMode imode)
+{
+  Mat_MPIAIJ     *mpiaij = (Mat_MPIAIJ*)mat->data;
+  Mat            A = mpiaij->A,B = mpiaij->B;
+  PetscInt       Annz = ((Mat_SeqAIJ*)A->data)->nz,Bnnz = ((Mat_SeqAIJ*)B->data)->nz,k,p;
+  const PetscInt *Ajmap1 = mpiaij->coo_Ajmap1,*Aperm1 = mpiaij->coo_Aperm1,*Ajmap2 = mpiaij->coo_Ajmap2,*Aperm2 = mpiaij->coo_Aperm2;
+  const PetscInt *Bjmap1 = mpiaij->coo_Bjmap1,*Bperm1 = mpiaij->coo_Bperm1,*Bjmap2 = mpiaij->coo_Bjmap2,*Bperm2 = mpiaij->coo_Bperm2;
+  PetscScalar    *Aa,*Ba,*sendbuf = mpiaij->coo_sendbuf,*recvbuf = mpiaij->coo_recvbuf;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!mpiaij->coo_sf) SETERRQ(PetscObjectComm((PetscObject)mat),PETSC_ERR_ARG_WRONGSTATE,"Must call MatSetPreallocationCOO() first");
+  if (mpiaij->coo_nonzerostate != mat->nonzerostate) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"The nonzero structure changed since MatSetPreallocationCOO() was called");
+  for (k=0; k<mpiaij->coo_nsend; k++) sendbuf[k] = v[mpiaij->coo_sendperm[k]];
+  ierr = PetscSFBcastBegin(mpiaij->coo_sf,MPIU_SCALAR,sendbuf,recvbuf);CHKERRQ(ierr);
+
+  /* overlap the communication with the local coordinates */
+  ierr = MatSeqAIJGetArray(A,&Aa);CHKERRQ(ierr);
+  ierr = MatSeqAIJGetArray(B,&Ba);CHKERRQ(ierr);
+  for (k=0; k<Annz; k++) {
+    PetscScalar sum = 0.0;
+    for (p=Ajmap1[k]; p<Ajmap1[k+1]; p++) sum += v[Aperm1[p]];
+    Aa[k] = (imode == INSERT_VALUES) ? sum : Aa[k] + sum;
+  }
+  for (k=0; k<Bnnz; k++) {
+    PetscScalar sum = 0.0;
+    for (p=Bjmap1[k]; p<Bjmap1[k+1]; p++) sum += v[Bperm1[p]];
+    Ba[k] = (imode == INSERT_VALUES) ? sum : Ba[k] + sum;
+  }
+
+  ierr = PetscSFBcastEnd(mpiaij->coo_sf,MPIU_SCALAR,sendbuf,recvbuf);CHKERRQ(ierr);
+  for (k=0; k<Annz; k++) {
+    for (p=Ajmap2[k]; p<Ajmap2[k+1]; p++) Aa[k] += recvbuf[Aperm2[p]];
+  }
+  for (k=0; k<Bnnz; k++) {
+    for (p=Bjmap2[k]; p<Bjmap2[k+1]; p++) Ba[k] += recvbuf[Bperm2[p]];
+  }
+  ierr = MatSeqAIJRestoreArray(A,&Aa);CHKERRQ(ierr);
+  ierr = MatSeqAIJRestoreArray(B,&Ba);CHKERRQ(ierr);
+  ierr = PetscLogFlops(Ajmap1[Annz] + Ajmap2[Annz] + Bjmap1[Bnnz] + Bjmap2[Bnnz]);CHKERRQ(ierr);
+
+  /* only the local blocks need to be assembled, nothing is stashed */
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyBegin(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = VecDestroy(&mpiaij->diag);CHKERRQ(ierr);
+  ierr = PetscObjectStateIncrease((PetscObject)mat);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*@
    MatMPIAIJSetPreallocationCSR - Allocates memory for a sparse parallel matrix in AIJ format
    (the default parallel PETSc format).
@@ -5720,6 +5983,11 @@ PetscErrorCode MatGetCommunicationStructs(Mat A, Vec *lvec, PetscInt *colmap[],
 PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJCRL(Mat,MatType,MatReuse,Mat*);
 PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJPERM(Mat,MatType,MatReuse,Mat*);
 PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJSELL(Mat,MatType,MatReuse,Mat*);
+PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJOMP(Mat,MatType,MatReuse,Mat*);
+PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJMixed(Mat,MatType,MatReuse,Mat*);
+PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJAuto(Mat,MatType,MatReuse,Mat*);
+PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJVBlock(Mat,MatType,MatReuse,Mat*);
+PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJDelta(Mat,MatType,MatReuse,Mat*);
 #if defined(PETSC_HAVE_MKL_SPARSE)
 PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJMKL(Mat,MatType,MatReuse,Mat*);
 #endif
@@ -5877,9 +6145,16 @@ PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJ(Mat B)
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatMPIAIJSetPreallocation_C",MatMPIAIJSetPreallocation_MPIAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatResetPreallocation_C",MatResetPreallocation_MPIAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatMPIAIJSetPreallocationCSR_C",MatMPIAIJSetPreallocationCSR_MPIAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSetPreallocationCOO_C",MatSetPreallocationCOO_MPIAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSetValuesCOO_C",MatSetValuesCOO_MPIAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatDiagonalScaleLocal_C",MatDiagonalScaleLocal_MPIAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_mpiaij_mpiaijperm_C",MatConvert_MPIAIJ_MPIAIJPERM);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_mpiaij_mpiaijsell_C",MatConvert_MPIAIJ_MPIAIJSELL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_mpiaij_mpiaijomp_C",MatConvert_MPIAIJ_MPIAIJOMP);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_mpiaij_mpiaijmixed_C",MatConvert_MPIAIJ_MPIAIJMixed);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_mpiaij_mpiaijauto_C",MatConvert_MPIAIJ_MPIAIJAuto);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_mpiaij_mpiaijvblock_C",MatConvert_MPIAIJ_MPIAIJVBlock);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_mpiaij_mpiaijdelta_C",MatConvert_MPIAIJ_MPIAIJDelta);CHKERRQ(ierr);
 #if defined(PETSC_HAVE_MKL_SPARSE)
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_mpiaij_mpiaijmkl_C",MatConvert_MPIAIJ_MPIAIJMKL);CHKERRQ(ierr);
 #endif
@@ -27,6 +27,8 @@ typedef struct { /* used by MatPtAPXXX_MPIAIJ_MPIAIJ() and MatMatMultXXX_MPIAIJ_
   PetscInt                algType;                 /* implementation algorithm */
   PetscSF                 sf;                      /* use it to communicate remote part of C */
   PetscInt                *c_othi,*c_rmti;
+  PetscInt                nthreads;                /* number of threads of the numeric phase, 0 if it is not threaded */
+  PetscInt                *aprstart;               /* rows aprstart[t],...,aprstart[t+1]-1 of A*P are computed by thread t */
 
   Mat_Merge_SeqsToMPI *merge;
 } Mat_APMPI;
@@ -69,6 +71,15 @@ typedef struct {
   /* Used by MPICUSPARSE classes */
   void * spptr;
 
+  /* Used by MatSetValuesCOO(); the jmap/perm pairs are as in Mat_SeqAIJ, 1 for the local coordinates (indexing coo_v),
+     2 for the coordinates received from other processes (indexing coo_recvbuf) */
+  PetscSF          coo_sf;                                            /* sends the values of the coordinates in rows owned by other processes */
+  PetscInt         coo_nsend,coo_nrecv;
+  PetscInt         *coo_sendperm;                                     /* position in coo_v of the coordinates sent */
+  PetscScalar      *coo_sendbuf,*coo_recvbuf;
+  PetscInt         *coo_Ajmap1,*coo_Aperm1,*coo_Ajmap2,*coo_Aperm2;   /* for the diagonal block */
+  PetscInt         *coo_Bjmap1,*coo_Bperm1,*coo_Bjmap2,*coo_Bperm2;   /* for the off-diagonal block */
+  PetscObjectState coo_nonzerostate;
 } Mat_MPIAIJ;
 
 PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJ(Mat);
@@ -166,8 +177,9 @@ extern PetscErrorCode MatDiagonalScaleLocal_MPIAIJ(Mat,Vec);
 PETSC_INTERN PetscErrorCode MatGetSeqMats_MPIAIJ(Mat,Mat*,Mat*);
 PETSC_INTERN PetscErrorCode MatSetSeqMats_MPIAIJ(Mat,IS,IS,IS,MatStructure,Mat,Mat);
 
-/* compute apa = A[i,:]*P = Ad[i,:]*P_loc + Ao*[i,:]*P_oth using sparse axpy */
-#define AProw_scalable(i,ad,ao,p_loc,p_oth,api,apj,apa) \
+/* compute apa = A[i,:]*P = Ad[i,:]*P_loc + Ao*[i,:]*P_oth using sparse axpy;
+   the _flops versions add the flops to the variable flops instead of logging them, so threads can use them */
+#define AProw_scalable_flops(i,ad,ao,p_loc,p_oth,api,apj,apa,flops) \
 {\
   PetscInt    _anz,_pnz,_j,_k,*_ai,*_aj,_row,*_pi,*_pj,_nextp,*_apJ;\
   PetscScalar *_aa,_valtmp,*_pa;\
@@ -191,7 +203,7 @@ PETSC_INTERN PetscErrorCode MatSetSeqMats_MPIAIJ(Mat,IS,IS,IS,MatStructure,Mat,M
         apa[_k] += _valtmp*_pa[_nextp++];                             \
       } \
     }                                           \
-    (void)PetscLogFlops(2.0*_pnz);              \
+    flops += 2.0*_pnz;                          \
   }                                             \
   /* off-diagonal portion of A */               \
   if (p_oth){ \
@@ -213,12 +225,12 @@ PETSC_INTERN PetscErrorCode MatSetSeqMats_MPIAIJ(Mat,IS,IS,IS,MatStructure,Mat,M
           apa[_k] += _valtmp*_pa[_nextp++];    \
         }                                      \
       }                                        \
-      (void)PetscLogFlops(2.0*_pnz);           \
+      flops += 2.0*_pnz;                       \
     } \
   }\
 }
 
-#define AProw_nonscalable(i,ad,ao,p_loc,p_oth,apa) \
+#define AProw_nonscalable_flops(i,ad,ao,p_loc,p_oth,apa,flops) \
 {\
   PetscInt    _anz,_pnz,_j,_k,*_ai,*_aj,_row,*_pi,*_pj;\
   PetscScalar *_aa,_valtmp,*_pa;                       \
@@ -238,7 +250,7 @@ PETSC_INTERN PetscErrorCode MatSetSeqMats_MPIAIJ(Mat,IS,IS,IS,MatStructure,Mat,M
     for (_k=0; _k<_pnz; _k++) {             \
       apa[_pj[_k]] += _valtmp*_pa[_k];      \
     }                                       \
-    (void)PetscLogFlops(2.0*_pnz);          \
+    flops += 2.0*_pnz;                      \
   }                                         \
   /* off-diagonal portion of A */           \
   if (p_oth){ \
@@ -257,9 +269,25 @@ PETSC_INTERN PetscErrorCode MatSetSeqMats_MPIAIJ(Mat,IS,IS,IS,MatStructure,Mat,M
       for (_k=0; _k<_pnz; _k++) {           \
         apa[_pj[_k]] += _valtmp*_pa[_k];    \
       }                                     \
-      (void)PetscLogFlops(2.0*_pnz);        \
+      flops += 2.0*_pnz;                    \
     }                                       \
   }\
 }
 
+#define AProw_scalable(i,ad,ao,p_loc,p_oth,api,apj,apa) \
+{\
+  PetscLogDouble _flops = 0.0;\
+  AProw_scalable_flops(i,ad,ao,p_loc,p_oth,api,apj,apa,_flops);\
+  (void)PetscLogFlops(_flops);\
+}
+
+#define AProw_nonscalable(i,ad,ao,p_loc,p_oth,apa) \
+{\
+  PetscLogDouble _flops = 0.0;\
+  AProw_nonscalable_flops(i,ad,ao,p_loc,p_oth,apa,_flops);\
+  (void)PetscLogFlops(_flops);\
+}
+
+PETSC_INTERN PetscErrorCode MatAPMPISetUpThreads_Private(Mat,Mat,Mat_APMPI*,PetscInt,PetscBool);
+
 #endif
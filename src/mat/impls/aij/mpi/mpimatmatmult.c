@@ -70,6 +70,7 @@ PetscErrorCode MatDestroy_MPIAIJ_MatMatMult(void *data)
   ierr = PetscFree(ptap->api);CHKERRQ(ierr);
   ierr = PetscFree(ptap->apj);CHKERRQ(ierr);
   ierr = PetscFree(ptap->apa);CHKERRQ(ierr);
+  ierr = PetscFree(ptap->aprstart);CHKERRQ(ierr);
   ierr = PetscFree(ptap);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
@@ -87,7 +88,9 @@ PetscErrorCode MatMatMultNumeric_MPIAIJ_MPIAIJ_nonscalable(Mat A,Mat P,Mat C)
   Mat_APMPI      *ptap;
   PetscInt       *api,*apj,*apJ,i,k;
   PetscInt       cstart=C->cmap->rstart;
-  PetscInt       cdnz,conz,k0,k1;
+  PetscInt       cdnz,conz,k0,k1,t,nt,pN = P->cmap->N,rows[2] = {0,cm};
+  const PetscInt *rstart = rows;
+  PetscLogDouble flops = 0.0;
   MPI_Comm       comm;
   PetscMPIInt    size;
 
@@ -115,43 +118,50 @@ PetscErrorCode MatMatMultNumeric_MPIAIJ_MPIAIJ_nonscalable(Mat A,Mat P,Mat C)
     p_oth = (Mat_SeqAIJ*)(ptap->P_oth)->data;
   }
 
-  /* get apa for storing dense row A[i,:]*P */
-  apa = ptap->apa;
-
+  /* get apa for storing dense row A[i,:]*P, one per thread */
   api = ptap->api;
   apj = ptap->apj;
-  for (i=0; i<cm; i++) {
-    /* compute apa = A[i,:]*P */
-    AProw_nonscalable(i,ad,ao,p_loc,p_oth,apa);
-
-    /* set values in C */
-    apJ  = apj + api[i];
-    cdnz = cd->i[i+1] - cd->i[i];
-    conz = co->i[i+1] - co->i[i];
-
-    /* 1st off-diagonal part of C */
-    ca = coa + co->i[i];
-    k  = 0;
-    for (k0=0; k0<conz; k0++) {
-      if (apJ[k] >= cstart) break;
-      ca[k0]      = apa[apJ[k]];
-      apa[apJ[k++]] = 0.0;
-    }
+  nt  = ptap->nthreads ? ptap->nthreads : 1;
+  if (ptap->nthreads) rstart = ptap->aprstart;
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel for num_threads(nt) schedule(static,1) reduction(+:flops) private(i,k,k0,k1,apa,apJ,ca,cdnz,conz) if(nt > 1)
+#endif
+  for (t=0; t<nt; t++) {
+    apa = ptap->apa + t*pN;
+    for (i=rstart[t]; i<rstart[t+1]; i++) {
+      /* compute apa = A[i,:]*P */
+      AProw_nonscalable_flops(i,ad,ao,p_loc,p_oth,apa,flops);
+
+      /* set values in C */
+      apJ  = apj + api[i];
+      cdnz = cd->i[i+1] - cd->i[i];
+      conz = co->i[i+1] - co->i[i];
+
+      /* 1st off-diagonal part of C */
+      ca = coa + co->i[i];
+      k  = 0;
+      for (k0=0; k0<conz; k0++) {
+        if (apJ[k] >= cstart) break;
+        ca[k0]      = apa[apJ[k]];
+        apa[apJ[k++]] = 0.0;
+      }
 
-    /* diagonal part of C */
-    ca = cda + cd->i[i];
-    for (k1=0; k1<cdnz; k1++) {
-      ca[k1]      = apa[apJ[k]];
-      apa[apJ[k++]] = 0.0;
-    }
+      /* diagonal part of C */
+      ca = cda + cd->i[i];
+      for (k1=0; k1<cdnz; k1++) {
+        ca[k1]      = apa[apJ[k]];
+        apa[apJ[k++]] = 0.0;
+      }
 
-    /* 2nd off-diagonal part of C */
-    ca = coa + co->i[i];
-    for (; k0<conz; k0++) {
-      ca[k0]      = apa[apJ[k]];
-      apa[apJ[k++]] = 0.0;
+      /* 2nd off-diagonal part of C */
+      ca = coa + co->i[i];
+      for (; k0<conz; k0++) {
+        ca[k0]      = apa[apJ[k]];
+        apa[apJ[k++]] = 0.0;
+      }
     }
   }
+  ierr = PetscLogFlops(flops);CHKERRQ(ierr);
   ierr = MatAssemblyBegin(C,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
   ierr = MatAssemblyEnd(C,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
   PetscFunctionReturn(0);
@@ -259,6 +269,7 @@ PetscErrorCode MatMatMultSymbolic_MPIAIJ_MPIAIJ_nonscalable(Mat A,Mat P,PetscRea
 
   /* malloc apa to store dense row A[i,:]*P */
   ierr = PetscCalloc1(pN,&ptap->apa);CHKERRQ(ierr);
+  ierr = MatAPMPISetUpThreads_Private(A,C,ptap,pN,PETSC_TRUE);CHKERRQ(ierr);
 
   /* set and assemble symbolic parallel matrix C */
   /*---------------------------------------------*/
@@ -92,10 +92,55 @@ PetscErrorCode MatDestroy_MPIAIJ_PtAP(void *data)
   ierr = PetscSFDestroy(&ptap->sf);CHKERRQ(ierr);
   ierr = PetscFree(ptap->c_othi);CHKERRQ(ierr);
   ierr = PetscFree(ptap->c_rmti);CHKERRQ(ierr);
+  ierr = PetscFree(ptap->aprstart);CHKERRQ(ierr);
   ierr = PetscFree(ptap);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
+/*
+   Splits the rows of AP_loc = A_loc*P among the threads given by -mat_product_threads of C, balancing the flops of the rows,
+   and the rows of the local products C_loc and C_oth when they exist. With dense, each thread gets its own row of
+   length pN in ptap->apa.
+*/
+PetscErrorCode MatAPMPISetUpThreads_Private(Mat A,Mat C,Mat_APMPI *ptap,PetscInt pN,PetscBool dense)
+{
+  PetscErrorCode ierr;
+  Mat_MPIAIJ     *a = (Mat_MPIAIJ*)A->data;
+  Mat_SeqAIJ     *ad = (Mat_SeqAIJ*)(a->A)->data,*ao = (Mat_SeqAIJ*)(a->B)->data,*p_loc,*p_oth = NULL;
+  PetscInt       i,j,am = A->rmap->n,nthreads;
+  PetscLogDouble *cost;
+
+  PetscFunctionBegin;
+  ierr = MatProductGetThreads_Private(C,&nthreads);CHKERRQ(ierr);
+  if (!nthreads) PetscFunctionReturn(0);
+  p_loc = (Mat_SeqAIJ*)(ptap->P_loc)->data;
+  if (ptap->P_oth) p_oth = (Mat_SeqAIJ*)(ptap->P_oth)->data;
+
+  ierr    = PetscMalloc1(am+1,&cost);CHKERRQ(ierr);
+  cost[0] = 0.0;
+  for (i=0; i<am; i++) {
+    cost[i+1] = cost[i] + 1.0;
+    for (j=ad->i[i]; j<ad->i[i+1]; j++) cost[i+1] += p_loc->i[ad->j[j]+1] - p_loc->i[ad->j[j]];
+    if (p_oth) {
+      for (j=ao->i[i]; j<ao->i[i+1]; j++) cost[i+1] += p_oth->i[ao->j[j]+1] - p_oth->i[ao->j[j]];
+    }
+  }
+  ierr = PetscFree(ptap->aprstart);CHKERRQ(ierr);
+  ierr = PetscMalloc1(nthreads+1,&ptap->aprstart);CHKERRQ(ierr);
+  ierr = MatProductPartitionRows_Private(am,cost,nthreads,ptap->aprstart);CHKERRQ(ierr);
+  ierr = PetscFree(cost);CHKERRQ(ierr);
+  ptap->nthreads = nthreads;
+
+  if (dense) {
+    ierr = PetscFree(ptap->apa);CHKERRQ(ierr);
+    ierr = PetscCalloc1(nthreads*pN,&ptap->apa);CHKERRQ(ierr);
+  }
+  if (ptap->C_loc) {ierr = MatSeqAIJSetUpProductThreads_Private(ptap->Rd,ptap->AP_loc,ptap->C_loc,nthreads);CHKERRQ(ierr);}
+  if (ptap->C_oth) {ierr = MatSeqAIJSetUpProductThreads_Private(ptap->Ro,ptap->AP_loc,ptap->C_oth,nthreads);CHKERRQ(ierr);}
+  ierr = PetscInfo2(C,"Split the %D rows of A*P among %D threads\n",am,nthreads);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode MatPtAPNumeric_MPIAIJ_MPIAIJ_scalable(Mat A,Mat P,Mat C)
 {
   PetscErrorCode    ierr;
@@ -144,20 +189,42 @@ PetscErrorCode MatPtAPNumeric_MPIAIJ_MPIAIJ_scalable(Mat A,Mat P,Mat C)
   api   = ap->i;
   apj   = ap->j;
   ierr = ISLocalToGlobalMappingApply(ptap->ltog,api[AP_loc->rmap->n],apj,apj);CHKERRQ(ierr);
-  for (i=0; i<am; i++) {
-    /* AP[i,:] = A[i,:]*P = Ad*P_loc Ao*P_oth */
-    apnz = api[i+1] - api[i];
-    apa = ap->a + api[i];
-    ierr = PetscArrayzero(apa,apnz);CHKERRQ(ierr);
-    AProw_scalable(i,ad,ao,p_loc,p_oth,api,apj,apa);
+  if (ptap->nthreads) {
+    PetscLogDouble flops = 0.0;
+    PetscInt       t,j,nt = ptap->nthreads;
+
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel for num_threads(nt) schedule(static,1) reduction(+:flops) private(i,j,apa)
+#endif
+    for (t=0; t<nt; t++) {
+      for (i=ptap->aprstart[t]; i<ptap->aprstart[t+1]; i++) {
+        apa = ap->a + api[i];
+        for (j=0; j<api[i+1]-api[i]; j++) apa[j] = 0.0;
+        AProw_scalable_flops(i,ad,ao,p_loc,p_oth,api,apj,apa,flops);
+      }
+    }
+    ierr = PetscLogFlops(flops);CHKERRQ(ierr);
+  } else {
+    for (i=0; i<am; i++) {
+      /* AP[i,:] = A[i,:]*P = Ad*P_loc Ao*P_oth */
+      apnz = api[i+1] - api[i];
+      apa = ap->a + api[i];
+      ierr = PetscArrayzero(apa,apnz);CHKERRQ(ierr);
+      AProw_scalable(i,ad,ao,p_loc,p_oth,api,apj,apa);
+    }
   }
   ierr = ISGlobalToLocalMappingApply(ptap->ltog,IS_GTOLM_DROP,api[AP_loc->rmap->n],apj,&nout,apj);CHKERRQ(ierr);
   if (api[AP_loc->rmap->n] != nout) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_INCOMP,"Incorrect mapping %D != %D\n",api[AP_loc->rmap->n],nout);
 
   /* 3) C_loc = Rd*AP_loc, C_oth = Ro*AP_loc */
   /* Always use scalable version since we are in the MPI scalable version */
-  ierr = MatMatMultNumeric_SeqAIJ_SeqAIJ_Scalable(ptap->Rd,AP_loc,ptap->C_loc);CHKERRQ(ierr);
-  ierr = MatMatMultNumeric_SeqAIJ_SeqAIJ_Scalable(ptap->Ro,AP_loc,ptap->C_oth);CHKERRQ(ierr);
+  if (ptap->nthreads) {
+    ierr = MatMatMultNumeric_SeqAIJ_SeqAIJ_Scalable_Threads(ptap->Rd,AP_loc,ptap->C_loc);CHKERRQ(ierr);
+    ierr = MatMatMultNumeric_SeqAIJ_SeqAIJ_Scalable_Threads(ptap->Ro,AP_loc,ptap->C_oth);CHKERRQ(ierr);
+  } else {
+    ierr = MatMatMultNumeric_SeqAIJ_SeqAIJ_Scalable(ptap->Rd,AP_loc,ptap->C_loc);CHKERRQ(ierr);
+    ierr = MatMatMultNumeric_SeqAIJ_SeqAIJ_Scalable(ptap->Ro,AP_loc,ptap->C_oth);CHKERRQ(ierr);
+  }
 
   C_loc = ptap->C_loc;
   C_oth = ptap->C_oth;
@@ -572,6 +639,8 @@ PetscErrorCode MatPtAPSymbolic_MPIAIJ_MPIAIJ_scalable(Mat A,Mat P,PetscReal fill
   ierr = ISGlobalToLocalMappingApply(ptap->ltog,IS_GTOLM_DROP,c_loc->i[ptap->C_loc->rmap->n],c_loc->j,&nout,c_loc->j);CHKERRQ(ierr);
   if (c_loc->i[ptap->C_loc->rmap->n] != nout) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_INCOMP,"Incorrect mapping %D != %D\n",c_loc->i[ptap->C_loc->rmap->n],nout);
 
+  ierr = MatAPMPISetUpThreads_Private(A,Cmpi,ptap,pN,PETSC_FALSE);CHKERRQ(ierr);
+
   /* attach the supporting struct to Cmpi for reuse */
   Cmpi->product->data    = ptap;
   Cmpi->product->view    = MatView_MPIAIJ_PtAP;
@@ -1922,6 +1991,7 @@ PetscErrorCode MatPtAPSymbolic_MPIAIJ_MPIAIJ(Mat A,Mat P,PetscReal fill,Mat Cmpi
   ierr = PetscLayoutDestroy(&rowmap);CHKERRQ(ierr);
 
   ierr = PetscCalloc1(pN,&ptap->apa);CHKERRQ(ierr);
+  ierr = MatAPMPISetUpThreads_Private(A,Cmpi,ptap,pN,PETSC_TRUE);CHKERRQ(ierr);
 
   /* attach the supporting struct to Cmpi for reuse */
   Cmpi->product->data    = ptap;
@@ -1982,14 +2052,35 @@ PetscErrorCode MatPtAPNumeric_MPIAIJ_MPIAIJ(Mat A,Mat P,Mat C)
   apa   = ptap->apa;
   api   = ap->i;
   apj   = ap->j;
-  for (i=0; i<am; i++) {
-    /* AP[i,:] = A[i,:]*P = Ad*P_loc Ao*P_oth */
-    AProw_nonscalable(i,ad,ao,p_loc,p_oth,apa);
-    apnz = api[i+1] - api[i];
-    for (j=0; j<apnz; j++) {
-      col = apj[j+api[i]];
-      ap->a[j+ap->i[i]] = apa[col];
-      apa[col] = 0.0;
+  if (ptap->nthreads) {
+    PetscLogDouble flops = 0.0;
+    PetscInt       t,nt = ptap->nthreads,pN = P->cmap->N;
+
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel for num_threads(nt) schedule(static,1) reduction(+:flops) private(i,j,col,apa)
+#endif
+    for (t=0; t<nt; t++) {
+      apa = ptap->apa + t*pN;
+      for (i=ptap->aprstart[t]; i<ptap->aprstart[t+1]; i++) {
+        AProw_nonscalable_flops(i,ad,ao,p_loc,p_oth,apa,flops);
+        for (j=api[i]; j<api[i+1]; j++) {
+          col      = apj[j];
+          ap->a[j] = apa[col];
+          apa[col] = 0.0;
+        }
+      }
+    }
+    ierr = PetscLogFlops(flops);CHKERRQ(ierr);
+  } else {
+    for (i=0; i<am; i++) {
+      /* AP[i,:] = A[i,:]*P = Ad*P_loc Ao*P_oth */
+      AProw_nonscalable(i,ad,ao,p_loc,p_oth,apa);
+      apnz = api[i+1] - api[i];
+      for (j=0; j<apnz; j++) {
+        col = apj[j+api[i]];
+        ap->a[j+ap->i[i]] = apa[col];
+        apa[col] = 0.0;
+      }
     }
   }
   /* We have modified the contents of local matrix AP_loc and must increase its ObjectState, since we are not doing AssemblyBegin/End on it. */
@@ -1166,6 +1166,9 @@ PetscErrorCode MatDestroy_SeqAIJ(Mat A)
   ierr = ISDestroy(&a->icol);CHKERRQ(ierr);
   ierr = PetscFree(a->saved_values);CHKERRQ(ierr);
   ierr = PetscFree2(a->compressedrow.i,a->compressedrow.rindex);CHKERRQ(ierr);
+  ierr = PetscFree2(a->coo_jmap,a->coo_perm);CHKERRQ(ierr);
+  ierr = MatDestroySolveLevels_SeqAIJ(A);CHKERRQ(ierr);
+  ierr = MatDestroySORColors_SeqAIJ(A);CHKERRQ(ierr);
 
   ierr = MatDestroy_SeqAIJ_Inode(A);CHKERRQ(ierr);
   ierr = PetscFree(A->data);CHKERRQ(ierr);
@@ -1206,6 +1209,8 @@ PetscErrorCode MatDestroy_SeqAIJ(Mat A)
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatIsTranspose_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatSeqAIJSetPreallocation_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatResetPreallocation_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatSetPreallocationCOO_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)A,"MatSetValuesCOO_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatSeqAIJSetPreallocationCSR_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatReorderForNonzeroDiagonal_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)A,"MatProductSetFromOptions_is_seqaij_C",NULL);CHKERRQ(ierr);
@@ -1839,6 +1844,13 @@ PetscErrorCode MatSOR_SeqAIJ(Mat A,Vec bb,PetscReal omega,MatSORType flag,PetscR
   const PetscInt    *idx,*diag;
 
   PetscFunctionBegin;
+  if (flag & SOR_MULTICOLOR) {
+    if (!(flag & (SOR_EISENSTAT | SOR_APPLY_UPPER | SOR_APPLY_LOWER))) {
+      ierr = MatSOR_SeqAIJ_MultiColor(A,bb,omega,flag,fshift,its,lits,xx);CHKERRQ(ierr);
+      PetscFunctionReturn(0);
+    }
+    flag = (MatSORType)(flag & ~SOR_MULTICOLOR);
+  }
   its = its*lits;
 
   if (fshift != a->fshift || omega != a->omega) a->idiagvalid = PETSC_FALSE; /* must recompute idiag[] */
@@ -4081,6 +4093,122 @@ PetscErrorCode  MatSeqAIJSetPreallocationCSR_SeqAIJ(Mat B,const PetscInt Ii[],co
   PetscFunctionReturn(0);
 }
 
+/*
+   MatCOOBuildCSR_Private - Sorts the n coordinates (rows[],cols[]), 0 <= rows[] < m, and merges the repeated ones.
+
+   On output ai[] and aj[] hold the compressed sparse row structure with nnz entries, and the k-th nonzero
+   receives the values of the coordinates perm[jmap[k]],...,perm[jmap[k+1]-1].  jmap[] has nnz+1 entries,
+   aj[] and perm[] have n entries.  Free with PetscFree(ai), PetscFree2(aj,perm) and PetscFree(jmap).
+*/
+PetscErrorCode MatCOOBuildCSR_Private(PetscInt m,PetscInt n,const PetscInt rows[],const PetscInt cols[],PetscInt *nnz,PetscInt **ai,PetscInt **aj,PetscInt **jmap,PetscInt **perm)
+{
+  PetscInt       *i,*j,*p,*jm,*next,k,r,q,nz;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  /* bucket the coordinates by rows, then sort the columns of each row carrying the coordinate number along */
+  ierr = PetscCalloc1(m+1,&i);CHKERRQ(ierr);
+  ierr = PetscMalloc1(m,&next);CHKERRQ(ierr);
+  ierr = PetscMalloc2(n,&j,n,&p);CHKERRQ(ierr);
+  for (k=0; k<n; k++) i[rows[k]+1]++;
+  for (r=0; r<m; r++) {i[r+1] += i[r]; next[r] = i[r];}
+  for (k=0; k<n; k++) {
+    q    = next[rows[k]]++;
+    j[q] = cols[k];
+    p[q] = k;
+  }
+  for (r=0; r<m; r++) {
+    ierr = PetscSortIntWithArray(i[r+1]-i[r],j+i[r],p+i[r]);CHKERRQ(ierr);
+  }
+
+  /* merge the repeated columns in place, jm[] marks where each group of repeated coordinates starts */
+  ierr = PetscMalloc1(n+1,&jm);CHKERRQ(ierr);
+  nz   = 0;
+  q    = 0;
+  for (r=0; r<m; r++) {
+    PetscInt rend = i[r+1];
+    for (; q<rend; q++) {
+      if (q == i[r] || j[q] != j[q-1]) {
+        j[nz]  = j[q];
+        jm[nz] = q;
+        nz++;
+      }
+    }
+    next[r] = nz;
+  }
+  jm[nz] = n;
+  for (r=0; r<m; r++) i[r+1] = next[r];
+  ierr = PetscFree(next);CHKERRQ(ierr);
+
+  *nnz  = nz;
+  *ai   = i;
+  *aj   = j;
+  *jmap = jm;
+  *perm = p;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSetPreallocationCOO_SeqAIJ(Mat A,PetscInt ncoo,const PetscInt coo_i[],const PetscInt coo_j[])
+{
+  Mat_SeqAIJ     *a;
+  PetscInt       *rows,*cols,*orig,*ai,*aj,*jmap,*perm,k,n,nz;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  /* drop the coordinates with negative indices, remembering the position of the others */
+  ierr = PetscMalloc3(ncoo,&rows,ncoo,&cols,ncoo,&orig);CHKERRQ(ierr);
+  for (k=0,n=0; k<ncoo; k++) {
+    if (coo_i[k] < 0 || coo_j[k] < 0) continue;
+    if (coo_i[k] >= A->rmap->n) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Row index %D is too large, maximum %D",coo_i[k],A->rmap->n-1);
+    if (coo_j[k] >= A->cmap->n) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Column index %D is too large, maximum %D",coo_j[k],A->cmap->n-1);
+    rows[n] = coo_i[k];
+    cols[n] = coo_j[k];
+    orig[n] = k;
+    n++;
+  }
+  ierr = MatCOOBuildCSR_Private(A->rmap->n,n,rows,cols,&nz,&ai,&aj,&jmap,&perm);CHKERRQ(ierr);
+  for (k=0; k<n; k++) perm[k] = orig[perm[k]];
+  ierr = PetscFree3(rows,cols,orig);CHKERRQ(ierr);
+
+  ierr = MatSeqAIJSetPreallocationCSR_SeqAIJ(A,ai,aj,NULL);CHKERRQ(ierr);
+  ierr = PetscFree(ai);CHKERRQ(ierr);
+  a    = (Mat_SeqAIJ*)A->data;
+  if (a->nz != nz) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Number of nonzeros %D does not match the coordinates %D, were the zero entries ignored?",a->nz,nz);
+  ierr = PetscFree2(a->coo_jmap,a->coo_perm);CHKERRQ(ierr);
+  ierr = PetscMalloc2(nz+1,&a->coo_jmap,n,&a->coo_perm);CHKERRQ(ierr);
+  ierr = PetscArraycpy(a->coo_jmap,jmap,nz+1);CHKERRQ(ierr);
+  ierr = PetscArraycpy(a->coo_perm,perm,n);CHKERRQ(ierr);
+  ierr = PetscFree(jmap);CHKERRQ(ierr);
+  ierr = PetscFree2(aj,perm);CHKERRQ(ierr);
+  a->coo_nonzerostate = A->nonzerostate;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSetValuesCOO_SeqAIJ(Mat A,const PetscScalar v[],InsertMode imode)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  const PetscInt *jmap = a->coo_jmap,*perm = a->coo_perm;
+  PetscScalar    *aa;
+  PetscInt       k,p;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!jmap) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Must call MatSetPreallocationCOO() first");
+  if (a->coo_nonzerostate != A->nonzerostate) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"The nonzero structure changed since MatSetPreallocationCOO() was called");
+  ierr = MatSeqAIJGetArray(A,&aa);CHKERRQ(ierr);
+  for (k=0; k<a->nz; k++) {
+    PetscScalar sum = 0.0;
+    for (p=jmap[k]; p<jmap[k+1]; p++) sum += v[perm[p]];
+    aa[k] = (imode == INSERT_VALUES) ? sum : aa[k] + sum;
+  }
+  ierr = MatSeqAIJRestoreArray(A,&aa);CHKERRQ(ierr);
+  ierr = PetscLogFlops(jmap[a->nz]);CHKERRQ(ierr);
+  /* no stash and no searching; this only refreshes the data derived from the values (diagonal, subclass copies) */
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 #include <../src/mat/impls/dense/seq/dense.h>
 #include <petsc/private/kernels/petscaxpy.h>
 
@@ -4161,7 +4289,9 @@ PetscErrorCode MatMatMultSymbolic_SeqDense_SeqAIJ(Mat A,Mat B,PetscReal fill,Mat
    based on compressed sparse row format.
 
    Options Database Keys:
-. -mat_type seqaij - sets the matrix type to "seqaij" during a call to MatSetFromOptions()
++ -mat_type seqaij - sets the matrix type to "seqaij" during a call to MatSetFromOptions()
+- -mat_solve_level_threads <n> - the triangular solves with the LU, ILU, Cholesky and ICC factors of the matrix computed with MATSOLVERPETSC
+                                 are level scheduled and run on n OpenMP threads
 
    Level: beginner
 
@@ -4192,7 +4322,7 @@ M*/
 . -mat_type aij - sets the matrix type to "aij" during a call to MatSetFromOptions()
 
   Developer Notes:
-    Subclasses include MATAIJCUSPARSE, MATAIJPERM, MATAIJSELL, MATAIJMKL, MATAIJCRL, and also automatically switches over to use inodes when
+    Subclasses include MATAIJCUSPARSE, MATAIJPERM, MATAIJSELL, MATAIJOMP, MATAIJMIXED, MATAIJAUTO, MATAIJVBLOCK, MATAIJDELTA, MATAIJMKL, MATAIJCRL, and also automatically switches over to use inodes when
    enough exist.
 
   Level: beginner
@@ -4426,6 +4556,11 @@ PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJ(Mat B)
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaij_seqbaij_C",MatConvert_SeqAIJ_SeqBAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaij_seqaijperm_C",MatConvert_SeqAIJ_SeqAIJPERM);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaij_seqaijsell_C",MatConvert_SeqAIJ_SeqAIJSELL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaij_seqaijomp_C",MatConvert_SeqAIJ_SeqAIJOMP);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaij_seqaijmixed_C",MatConvert_SeqAIJ_SeqAIJMixed);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaij_seqaijauto_C",MatConvert_SeqAIJ_SeqAIJAuto);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaij_seqaijvblock_C",MatConvert_SeqAIJ_SeqAIJVBlock);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaij_seqaijdelta_C",MatConvert_SeqAIJ_SeqAIJDelta);CHKERRQ(ierr);
 #if defined(PETSC_HAVE_MKL_SPARSE)
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaij_seqaijmkl_C",MatConvert_SeqAIJ_SeqAIJMKL);CHKERRQ(ierr);
 #endif
@@ -4452,6 +4587,8 @@ PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJ(Mat B)
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatSeqAIJSetPreallocation_C",MatSeqAIJSetPreallocation_SeqAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatResetPreallocation_C",MatResetPreallocation_SeqAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatSeqAIJSetPreallocationCSR_C",MatSeqAIJSetPreallocationCSR_SeqAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSetPreallocationCOO_C",MatSetPreallocationCOO_SeqAIJ);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatSetValuesCOO_C",MatSetValuesCOO_SeqAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatReorderForNonzeroDiagonal_C",MatReorderForNonzeroDiagonal_SeqAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatProductSetFromOptions_is_seqaij_C",MatProductSetFromOptions_IS_XAIJ);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)B,"MatProductSetFromOptions_seqdense_seqaij_C",MatProductSetFromOptions_SeqDense_SeqAIJ);CHKERRQ(ierr);
@@ -4597,6 +4734,7 @@ PetscErrorCode MatLoad_SeqAIJ_Binary(Mat mat, PetscViewer viewer)
   Mat_SeqAIJ     *a = (Mat_SeqAIJ*)mat->data;
   PetscErrorCode ierr;
   PetscInt       header[4],*rowlens,M,N,nz,sum,rows,cols,i;
+  PetscBool      usemmap;
 
   PetscFunctionBegin;
   ierr = PetscViewerSetUp(viewer);CHKERRQ(ierr);
@@ -4629,6 +4767,42 @@ PetscErrorCode MatLoad_SeqAIJ_Binary(Mat mat, PetscViewer viewer)
   /* check if sum(rowlens) is same as nz */
   sum = 0; for (i=0; i<M; i++) sum += rowlens[i];
   if (sum != nz) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_FILE_UNEXPECTED,"Inconsistent matrix data in file: nonzeros = %D, sum-row-lengths = %D\n",nz,sum);
+
+  ierr = PetscViewerBinaryGetUseMMap(viewer,&usemmap);CHKERRQ(ierr);
+  if (usemmap) {
+    PetscContainer owner;
+
+    /* the column indices and values are used in place in the mapped file, only the row information is allocated */
+    ierr = MatSeqXAIJFreeAIJ(mat,&a->a,&a->j,&a->i);CHKERRQ(ierr);
+    ierr = MatSeqAIJSetPreallocation_SeqAIJ(mat,MAT_SKIP_ALLOCATION,NULL);CHKERRQ(ierr);
+    if (!a->imax) {ierr = PetscMalloc1(M,&a->imax);CHKERRQ(ierr);}
+    if (!a->ilen) {ierr = PetscMalloc1(M,&a->ilen);CHKERRQ(ierr);}
+    ierr = PetscLogObjectMemory((PetscObject)mat,(3*M+1)*sizeof(PetscInt));CHKERRQ(ierr);
+    ierr = PetscArraycpy(a->imax,rowlens,M);CHKERRQ(ierr);
+    ierr = PetscArraycpy(a->ilen,rowlens,M);CHKERRQ(ierr);
+    ierr = PetscFree(rowlens);CHKERRQ(ierr);
+    /* the row pointers are not freed with the matrix since free_ij is false, the container attached to the matrix owns them */
+    ierr = PetscMalloc1(M+1,&a->i);CHKERRQ(ierr);
+    a->i[0] = 0; for (i=0; i<M; i++) a->i[i+1] = a->i[i] + a->ilen[i];
+    ierr = PetscContainerCreate(PETSC_COMM_SELF,&owner);CHKERRQ(ierr);
+    ierr = PetscContainerSetPointer(owner,a->i);CHKERRQ(ierr);
+    ierr = PetscContainerSetUserDestroy(owner,PetscContainerUserDestroyDefault);CHKERRQ(ierr);
+    ierr = PetscObjectCompose((PetscObject)mat,"MatLoad_SeqAIJ_i",(PetscObject)owner);CHKERRQ(ierr);
+    ierr = PetscContainerDestroy(&owner);CHKERRQ(ierr);
+    ierr = PetscViewerBinaryReadAllInPlace(viewer,(void**)&a->j,nz,0,nz,PETSC_INT,&owner);CHKERRQ(ierr);
+    ierr = PetscObjectCompose((PetscObject)mat,"MatLoad_SeqAIJ_j",(PetscObject)owner);CHKERRQ(ierr);
+    ierr = PetscContainerDestroy(&owner);CHKERRQ(ierr);
+    ierr = PetscViewerBinaryReadAllInPlace(viewer,(void**)&a->a,nz,0,nz,PETSC_SCALAR,&owner);CHKERRQ(ierr);
+    ierr = PetscObjectCompose((PetscObject)mat,"MatLoad_SeqAIJ_a",(PetscObject)owner);CHKERRQ(ierr);
+    ierr = PetscContainerDestroy(&owner);CHKERRQ(ierr);
+    a->singlemalloc = PETSC_FALSE;
+    a->maxnz        = nz;
+
+    ierr = MatAssemblyBegin(mat,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+    ierr = MatAssemblyEnd(mat,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+
   /* preallocate and check sizes */
   ierr = MatSeqAIJSetPreallocation_SeqAIJ(mat,0,rowlens);CHKERRQ(ierr);
   ierr = MatGetSize(mat,&rows,&cols);CHKERRQ(ierr);
@@ -5048,6 +5222,11 @@ PetscErrorCode  MatSeqAIJRegisterAll(void)
   ierr = MatSeqAIJRegister(MATSEQAIJCRL,      MatConvert_SeqAIJ_SeqAIJCRL);CHKERRQ(ierr);
   ierr = MatSeqAIJRegister(MATSEQAIJPERM,     MatConvert_SeqAIJ_SeqAIJPERM);CHKERRQ(ierr);
   ierr = MatSeqAIJRegister(MATSEQAIJSELL,     MatConvert_SeqAIJ_SeqAIJSELL);CHKERRQ(ierr);
+  ierr = MatSeqAIJRegister(MATSEQAIJOMP,      MatConvert_SeqAIJ_SeqAIJOMP);CHKERRQ(ierr);
+  ierr = MatSeqAIJRegister(MATSEQAIJMIXED,    MatConvert_SeqAIJ_SeqAIJMixed);CHKERRQ(ierr);
+  ierr = MatSeqAIJRegister(MATSEQAIJAUTO,     MatConvert_SeqAIJ_SeqAIJAuto);CHKERRQ(ierr);
+  ierr = MatSeqAIJRegister(MATSEQAIJVBLOCK,   MatConvert_SeqAIJ_SeqAIJVBlock);CHKERRQ(ierr);
+  ierr = MatSeqAIJRegister(MATSEQAIJDELTA,    MatConvert_SeqAIJ_SeqAIJDelta);CHKERRQ(ierr);
 #if defined(PETSC_HAVE_MKL_SPARSE)
   ierr = MatSeqAIJRegister(MATSEQAIJMKL,      MatConvert_SeqAIJ_SeqAIJMKL);CHKERRQ(ierr);
 #endif
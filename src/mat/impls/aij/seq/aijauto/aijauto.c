@@ -0,0 +1,512 @@
+/*
+  Defines basic operations for the MATSEQAIJAUTO matrix class.
+  This class is derived from the MATSEQAIJ class and retains the
+  compressed row storage unchanged, but selects the storage format used by
+  MatMult() and MatMultAdd() among SEQAIJ, SEQSELL, SEQAIJPERM, SEQAIJCRL and
+  SEQBAIJ by timing a few products with each of them. The selected format
+  other than SEQAIJ is kept as a "shadow" copy of the matrix, in the same way
+  as MATSEQAIJSELL. The selection is done again when the nonzero structure
+  changes; when only the values change, the shadow copy is updated.
+*/
+
+#include <../src/mat/impls/aij/seq/aij.h>
+#include <../src/mat/impls/sell/seq/sell.h>
+#include <petsctime.h>
+
+#define MATSEQAIJAUTO_NFORMATS 5
+static const char *const MatSeqAIJAutoFormats[] = {"aij","sell","aijperm","aijcrl","baij"};
+enum {MATSEQAIJAUTO_AIJ,MATSEQAIJAUTO_SELL,MATSEQAIJAUTO_AIJPERM,MATSEQAIJAUTO_AIJCRL,MATSEQAIJAUTO_BAIJ};
+
+/* The events of the products with each format, so that -log_view shows which formats were selected */
+static PetscBool     MatSeqAIJAutoEventsRegistered = PETSC_FALSE;
+static PetscLogEvent MAT_AIJAutoSelect,MAT_AIJAutoMult[MATSEQAIJAUTO_NFORMATS];
+
+typedef struct {
+  PetscInt         format;                          /* format used by MatMult(), index in MatSeqAIJAutoFormats[] */
+  PetscBool        candidate[MATSEQAIJAUTO_NFORMATS];
+  PetscInt         ntrials;                         /* number of timed products with each candidate */
+  PetscReal        sellfill;                        /* SELL is not tried when its padding would increase the storage more than this */
+  PetscInt         bs;                              /* block size of the BAIJ format */
+  Mat              S;                               /* the shadow matrix in the selected format, NULL for SEQAIJ */
+  PetscObjectState state;                           /* state of the matrix when the shadow matrix was built */
+  PetscObjectState nonzerostate;                    /* nonzero state of the matrix when the format was selected */
+  PetscErrorCode   (*mult)(Mat,Vec,Vec);            /* the SEQAIJ kernels, which use inodes when available */
+  PetscErrorCode   (*multadd)(Mat,Vec,Vec,Vec);
+} Mat_SeqAIJAuto;
+
+static PetscErrorCode MatSeqAIJAutoFinalizeEvents_Private(void)
+{
+  PetscFunctionBegin;
+  MatSeqAIJAutoEventsRegistered = PETSC_FALSE;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSeqAIJAutoRegisterEvents_Private(void)
+{
+  PetscErrorCode ierr;
+  char           name[64];
+  PetscInt       f;
+
+  PetscFunctionBegin;
+  if (MatSeqAIJAutoEventsRegistered) PetscFunctionReturn(0);
+  MatSeqAIJAutoEventsRegistered = PETSC_TRUE;
+  ierr = PetscLogEventRegister("MatAutoSelect",MAT_CLASSID,&MAT_AIJAutoSelect);CHKERRQ(ierr);
+  for (f=0; f<MATSEQAIJAUTO_NFORMATS; f++) {
+    ierr = PetscSNPrintf(name,sizeof(name),"MatMult Auto%s",MatSeqAIJAutoFormats[f]);CHKERRQ(ierr);
+    ierr = PetscLogEventRegister(name,MAT_CLASSID,&MAT_AIJAutoMult[f]);CHKERRQ(ierr);
+  }
+  ierr = PetscRegisterFinalize(MatSeqAIJAutoFinalizeEvents_Private);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Finds the largest block size bs <= 8 such that the matrix consists of dense aligned bs x bs blocks, returns 1 if there is none
+*/
+static PetscErrorCode MatSeqAIJAutoDetectBlockSize_Private(Mat A,PetscInt *bs)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  const PetscInt *ai = a->i,*aj = a->j;
+  PetscInt       b,ib,i,j,k,m = A->rmap->n,n = A->cmap->n,len;
+  PetscBool      blocked;
+
+  PetscFunctionBegin;
+  *bs = 1;
+  for (b=8; b>1; b--) {
+    if (m % b || n % b) continue;
+    blocked = PETSC_TRUE;
+    for (ib=0; ib<m && blocked; ib+=b) {
+      len = ai[ib+1] - ai[ib];
+      if (len % b) {blocked = PETSC_FALSE; break;}
+      /* the columns of the first row of the block row are complete aligned blocks */
+      for (k=0; k<len && blocked; k+=b) {
+        if (aj[ai[ib]+k] % b) blocked = PETSC_FALSE;
+        for (j=1; j<b && blocked; j++) if (aj[ai[ib]+k+j] != aj[ai[ib]+k]+j) blocked = PETSC_FALSE;
+      }
+      /* and the other rows of the block row have the same columns */
+      for (i=ib+1; i<ib+b && blocked; i++) {
+        if (ai[i+1] - ai[i] != len) {blocked = PETSC_FALSE; break;}
+        for (k=0; k<len; k++) if (aj[ai[i]+k] != aj[ai[ib]+k]) {blocked = PETSC_FALSE; break;}
+      }
+    }
+    if (blocked) {*bs = b; break;}
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   Builds the shadow matrix of A in the given format, or updates its values when the format allows it
+*/
+static PetscErrorCode MatSeqAIJAutoBuildShadow_Private(Mat A,PetscInt format,PetscInt bs,Mat *S)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  PetscInt       i,m = A->rmap->n,n = A->cmap->n,*bnnz;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  switch (format) {
+  case MATSEQAIJAUTO_AIJ:
+    ierr = MatDestroy(S);CHKERRQ(ierr);
+    break;
+  case MATSEQAIJAUTO_SELL:
+    ierr = MatConvert_SeqAIJ_SeqSELL(A,MATSEQSELL,*S ? MAT_REUSE_MATRIX : MAT_INITIAL_MATRIX,S);CHKERRQ(ierr);
+    break;
+  case MATSEQAIJAUTO_AIJPERM:
+  case MATSEQAIJAUTO_AIJCRL:
+    /* a plain SEQAIJ copy of A, converted in place */
+    ierr = MatDestroy(S);CHKERRQ(ierr);
+    ierr = MatCreate(PETSC_COMM_SELF,S);CHKERRQ(ierr);
+    ierr = MatSetSizes(*S,m,n,m,n);CHKERRQ(ierr);
+    ierr = MatSetType(*S,MATSEQAIJ);CHKERRQ(ierr);
+    ierr = MatDuplicateNoCreate_SeqAIJ(*S,A,MAT_COPY_VALUES,PETSC_TRUE);CHKERRQ(ierr);
+    if (format == MATSEQAIJAUTO_AIJPERM) {
+      ierr = MatConvert_SeqAIJ_SeqAIJPERM(*S,MATSEQAIJPERM,MAT_INPLACE_MATRIX,S);CHKERRQ(ierr);
+    } else {
+      ierr = MatConvert_SeqAIJ_SeqAIJCRL(*S,MATSEQAIJCRL,MAT_INPLACE_MATRIX,S);CHKERRQ(ierr);
+    }
+    break;
+  case MATSEQAIJAUTO_BAIJ:
+    if (!*S) {
+      ierr = PetscMalloc1(m/bs,&bnnz);CHKERRQ(ierr);
+      for (i=0; i<m/bs; i++) bnnz[i] = (a->i[i*bs+1] - a->i[i*bs])/bs;
+      ierr = MatCreateSeqBAIJ(PETSC_COMM_SELF,bs,m,n,0,bnnz,S);CHKERRQ(ierr);
+      ierr = PetscFree(bnnz);CHKERRQ(ierr);
+      ierr = MatSetOption(*S,MAT_NEW_NONZERO_ALLOCATION_ERR,PETSC_TRUE);CHKERRQ(ierr);
+    }
+    for (i=0; i<m; i++) {
+      ierr = MatSetValues(*S,1,&i,a->i[i+1]-a->i[i],a->j+a->i[i],a->a+a->i[i],INSERT_VALUES);CHKERRQ(ierr);
+    }
+    ierr = MatAssemblyBegin(*S,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+    ierr = MatAssemblyEnd(*S,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+    break;
+  default: SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Unknown format %D",format);
+  }
+  PetscFunctionReturn(0);
+}
+
+PETSC_STATIC_INLINE PetscErrorCode MatSeqAIJAutoMult_Private(Mat A,PetscInt format,Mat S,Vec xx,Vec yy)
+{
+  Mat_SeqAIJAuto *aijauto = (Mat_SeqAIJAuto*)A->spptr;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (format == MATSEQAIJAUTO_AIJ) {
+    ierr = (*aijauto->mult)(A,xx,yy);CHKERRQ(ierr);
+  } else {
+    ierr = (*S->ops->mult)(S,xx,yy);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   Times ntrials products with each candidate format and keeps the fastest one
+*/
+static PetscErrorCode MatSeqAIJAutoSelect_Private(Mat A)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJAuto *aijauto = (Mat_SeqAIJAuto*)A->spptr;
+  PetscInt       i,k,f,m = A->rmap->n,len,minlen = PETSC_MAX_INT,maxlen = 0,slicemax = 0,bs = 1;
+  PetscReal      fill = 0.0;
+  PetscLogDouble t0,t,tbest = 0.0;
+  Mat            S,Sbest = NULL;
+  Vec            x,y;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscLogEventBegin(MAT_AIJAutoSelect,A,0,0,0);CHKERRQ(ierr);
+  ierr = MatDestroy(&aijauto->S);CHKERRQ(ierr);
+  aijauto->format = MATSEQAIJAUTO_AIJ;
+  if (a->nz) {
+    /* the row lengths determine the padding of SELL, which stores slices of 8 rows with the length of their longest row */
+    for (i=0; i<m; i++) {
+      len      = a->i[i+1] - a->i[i];
+      minlen   = PetscMin(minlen,len);
+      maxlen   = PetscMax(maxlen,len);
+      slicemax = PetscMax(slicemax,len);
+      if (i%8 == 7 || i == m-1) {fill += 8*slicemax; slicemax = 0;}
+    }
+    fill /= a->nz;
+    ierr  = MatSeqAIJAutoDetectBlockSize_Private(A,&bs);CHKERRQ(ierr);
+    ierr  = PetscInfo5(A,"Row lengths from %D to %D, average %g, SELL fill ratio %g, block size %D\n",minlen,maxlen,(double)a->nz/m,(double)fill,bs);CHKERRQ(ierr);
+
+    ierr = MatCreateVecs(A,&x,&y);CHKERRQ(ierr);
+    ierr = VecSet(x,1.0);CHKERRQ(ierr);
+    aijauto->format = -1;
+    for (f=0; f<MATSEQAIJAUTO_NFORMATS; f++) {
+      if (!aijauto->candidate[f]) continue;
+      if (f == MATSEQAIJAUTO_SELL && fill > aijauto->sellfill) {
+        ierr = PetscInfo2(A,"Skip the SELL format, its fill ratio %g is above %g\n",(double)fill,(double)aijauto->sellfill);CHKERRQ(ierr);
+        continue;
+      }
+      if (f == MATSEQAIJAUTO_BAIJ && bs == 1) continue;
+      S    = NULL;
+      ierr = MatSeqAIJAutoBuildShadow_Private(A,f,bs,&S);CHKERRQ(ierr);
+      /* the first product is not timed since it brings the matrix into the cache */
+      ierr = MatSeqAIJAutoMult_Private(A,f,S,x,y);CHKERRQ(ierr);
+      ierr = PetscTime(&t0);CHKERRQ(ierr);
+      for (k=0; k<aijauto->ntrials; k++) {
+        ierr = MatSeqAIJAutoMult_Private(A,f,S,x,y);CHKERRQ(ierr);
+      }
+      ierr = PetscTime(&t);CHKERRQ(ierr);
+      t   -= t0;
+      ierr = PetscInfo3(A,"Format %s: %g seconds for %D products\n",MatSeqAIJAutoFormats[f],t,aijauto->ntrials);CHKERRQ(ierr);
+      if (aijauto->format < 0 || t < tbest) {
+        ierr            = MatDestroy(&Sbest);CHKERRQ(ierr);
+        Sbest           = S;
+        tbest           = t;
+        aijauto->format = f;
+      } else {
+        ierr = MatDestroy(&S);CHKERRQ(ierr);
+      }
+    }
+    ierr = VecDestroy(&x);CHKERRQ(ierr);
+    ierr = VecDestroy(&y);CHKERRQ(ierr);
+    if (aijauto->format < 0) aijauto->format = MATSEQAIJAUTO_AIJ;
+  }
+  aijauto->S  = Sbest;
+  aijauto->bs = bs;
+  ierr = PetscObjectStateGet((PetscObject)A,&aijauto->state);CHKERRQ(ierr);
+  aijauto->nonzerostate = A->nonzerostate;
+  ierr = PetscLogEventEnd(MAT_AIJAutoSelect,A,0,0,0);CHKERRQ(ierr);
+  ierr = PetscInfo1(A,"Selected the %s format for MatMult()\n",MatSeqAIJAutoFormats[aijauto->format]);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Select the format when the nonzero structure has changed, otherwise update the shadow matrix when the values have changed */
+static PetscErrorCode MatSeqAIJAutoUpdate_Private(Mat A)
+{
+  Mat_SeqAIJAuto   *aijauto = (Mat_SeqAIJAuto*)A->spptr;
+  PetscObjectState state;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  if (aijauto->nonzerostate != A->nonzerostate) {
+    ierr = MatSeqAIJAutoSelect_Private(A);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = PetscObjectStateGet((PetscObject)A,&state);CHKERRQ(ierr);
+  if (aijauto->state == state) PetscFunctionReturn(0);
+  if (aijauto->S) {
+    ierr = PetscLogEventBegin(MAT_Convert,A,0,0,0);CHKERRQ(ierr);
+    ierr = MatSeqAIJAutoBuildShadow_Private(A,aijauto->format,aijauto->bs,&aijauto->S);CHKERRQ(ierr);
+    ierr = PetscLogEventEnd(MAT_Convert,A,0,0,0);CHKERRQ(ierr);
+  }
+  aijauto->state = state;
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMult_SeqAIJAuto(Mat A,Vec xx,Vec yy)
+{
+  Mat_SeqAIJAuto *aijauto = (Mat_SeqAIJAuto*)A->spptr;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJAutoUpdate_Private(A);CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(MAT_AIJAutoMult[aijauto->format],A,xx,yy,0);CHKERRQ(ierr);
+  ierr = MatSeqAIJAutoMult_Private(A,aijauto->format,aijauto->S,xx,yy);CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(MAT_AIJAutoMult[aijauto->format],A,xx,yy,0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMultAdd_SeqAIJAuto(Mat A,Vec xx,Vec yy,Vec zz)
+{
+  Mat_SeqAIJAuto *aijauto = (Mat_SeqAIJAuto*)A->spptr;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJAutoUpdate_Private(A);CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(MAT_AIJAutoMult[aijauto->format],A,xx,yy,zz);CHKERRQ(ierr);
+  if (aijauto->format == MATSEQAIJAUTO_AIJ) {
+    ierr = (*aijauto->multadd)(A,xx,yy,zz);CHKERRQ(ierr);
+  } else {
+    ierr = (*aijauto->S->ops->multadd)(aijauto->S,xx,yy,zz);CHKERRQ(ierr);
+  }
+  ierr = PetscLogEventEnd(MAT_AIJAutoMult[aijauto->format],A,xx,yy,zz);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   The SEQAIJ assembly and duplication set the inode kernels when the matrix has inodes, so they are saved for the
+   SEQAIJ format before the products are overridden
+*/
+static PetscErrorCode MatSeqAIJAutoSetOps_Private(Mat A)
+{
+  Mat_SeqAIJAuto *aijauto = (Mat_SeqAIJAuto*)A->spptr;
+
+  PetscFunctionBegin;
+  aijauto->mult    = A->ops->mult    == MatMult_SeqAIJAuto    ? MatMult_SeqAIJ    : A->ops->mult;
+  aijauto->multadd = A->ops->multadd == MatMultAdd_SeqAIJAuto ? MatMultAdd_SeqAIJ : A->ops->multadd;
+  A->ops->mult     = MatMult_SeqAIJAuto;
+  A->ops->multadd  = MatMultAdd_SeqAIJAuto;
+  PetscFunctionReturn(0);
+}
+
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJAuto_SeqAIJ(Mat A,MatType type,MatReuse reuse,Mat *newmat)
+{
+  /* This routine is only called to convert a MATAIJAUTO to its base PETSc type, */
+  /* so we will ignore 'MatType type'. */
+  PetscErrorCode ierr;
+  Mat            B = *newmat;
+  Mat_SeqAIJAuto *aijauto;
+
+  PetscFunctionBegin;
+  if (reuse == MAT_INITIAL_MATRIX) {
+    ierr = MatDuplicate(A,MAT_COPY_VALUES,&B);CHKERRQ(ierr);
+  }
+  aijauto = (Mat_SeqAIJAuto*)B->spptr;
+
+  /* Reset the original function pointers. */
+  B->ops->duplicate     = MatDuplicate_SeqAIJ;
+  B->ops->assemblyend   = MatAssemblyEnd_SeqAIJ;
+  B->ops->destroy       = MatDestroy_SeqAIJ;
+  B->ops->mult          = aijauto->mult;
+  B->ops->multadd       = aijauto->multadd;
+  B->ops->diagonalscale = MatDiagonalScale_SeqAIJ;
+
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaijauto_seqaij_C",NULL);CHKERRQ(ierr);
+
+  /* Free everything in the Mat_SeqAIJAuto data structure. */
+  ierr = MatDestroy(&aijauto->S);CHKERRQ(ierr);
+  ierr = PetscFree(B->spptr);CHKERRQ(ierr);
+
+  /* Change the type of B to MATSEQAIJ. */
+  ierr = PetscObjectChangeTypeName((PetscObject)B,MATSEQAIJ);CHKERRQ(ierr);
+
+  *newmat = B;
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatDestroy_SeqAIJAuto(Mat A)
+{
+  PetscErrorCode ierr;
+  Mat_SeqAIJAuto *aijauto = (Mat_SeqAIJAuto*)A->spptr;
+
+  PetscFunctionBegin;
+  if (aijauto) {
+    /* If MatHeaderMerge() was used then this SeqAIJAuto matrix will not have a spptr. */
+    ierr = MatDestroy(&aijauto->S);CHKERRQ(ierr);
+    ierr = PetscFree(A->spptr);CHKERRQ(ierr);
+  }
+  /* Change the type of A back to SEQAIJ and use MatDestroy_SeqAIJ() to destroy everything that remains. */
+  ierr = PetscObjectChangeTypeName((PetscObject)A,MATSEQAIJ);CHKERRQ(ierr);
+  ierr = MatDestroy_SeqAIJ(A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatAssemblyEnd_SeqAIJAuto(Mat A,MatAssemblyType mode)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (mode == MAT_FLUSH_ASSEMBLY) PetscFunctionReturn(0);
+  ierr = MatAssemblyEnd_SeqAIJ(A,mode);CHKERRQ(ierr);
+  ierr = MatSeqAIJAutoSetOps_Private(A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatDuplicate_SeqAIJAuto(Mat A,MatDuplicateOption op,Mat *M)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  /* MatDuplicate_SeqAIJ() creates the duplicate with the type of A, the format is selected again when it is used */
+  ierr = MatDuplicate_SeqAIJ(A,op,M);CHKERRQ(ierr);
+  ierr = MatSeqAIJAutoSetOps_Private(*M);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   MatDiagonalScale_MPIAIJ() calls this directly on the blocks, so the state must be increased here to update the shadow matrix
+*/
+PetscErrorCode MatDiagonalScale_SeqAIJAuto(Mat A,Vec ll,Vec rr)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatDiagonalScale_SeqAIJ(A,ll,rr);CHKERRQ(ierr);
+  ierr = PetscObjectStateIncrease((PetscObject)A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* MatConvert_SeqAIJ_SeqAIJAuto converts a SeqAIJ matrix into a
+ * SeqAIJAuto matrix.  This routine is called by the MatCreate_SeqAIJAuto()
+ * routine, but can also be used to convert an assembled SeqAIJ matrix
+ * into a SeqAIJAuto one. */
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJAuto(Mat A,MatType type,MatReuse reuse,Mat *newmat)
+{
+  PetscErrorCode ierr;
+  Mat            B = *newmat;
+  Mat_SeqAIJAuto *aijauto;
+  PetscBool      sametype,flg,match;
+  char           *formats[MATSEQAIJAUTO_NFORMATS];
+  PetscInt       i,f,nformats = MATSEQAIJAUTO_NFORMATS;
+
+  PetscFunctionBegin;
+  if (reuse == MAT_INITIAL_MATRIX) {
+    ierr = MatDuplicate(A,MAT_COPY_VALUES,&B);CHKERRQ(ierr);
+  }
+  ierr = PetscObjectTypeCompare((PetscObject)A,type,&sametype);CHKERRQ(ierr);
+  if (sametype) PetscFunctionReturn(0);
+
+  ierr     = MatSeqAIJAutoRegisterEvents_Private();CHKERRQ(ierr);
+  ierr     = PetscNewLog(B,&aijauto);CHKERRQ(ierr);
+  B->spptr = (void*)aijauto;
+
+  aijauto->format       = MATSEQAIJAUTO_AIJ;
+  aijauto->ntrials      = 5;
+  aijauto->sellfill     = 1.5;
+  aijauto->bs           = 1;
+  aijauto->nonzerostate = -1; /* this will trigger the selection of the format the first time MatMult() is called */
+  for (f=0; f<MATSEQAIJAUTO_NFORMATS; f++) aijauto->candidate[f] = PETSC_TRUE;
+
+  ierr = PetscOptionsBegin(PetscObjectComm((PetscObject)B),((PetscObject)B)->prefix,"AIJAUTO Options","Mat");CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-mat_aijauto_trials","Number of timed products with each format","None",aijauto->ntrials,&aijauto->ntrials,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsReal("-mat_aijauto_sell_fill","Largest increase of the storage by the padding of SELL","None",aijauto->sellfill,&aijauto->sellfill,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsStringArray("-mat_aijauto_formats","Formats to try: aij, sell, aijperm, aijcrl, baij","None",formats,&nformats,&flg);CHKERRQ(ierr);
+  ierr = PetscOptionsEnd();CHKERRQ(ierr);
+  if (flg) {
+    for (f=0; f<MATSEQAIJAUTO_NFORMATS; f++) aijauto->candidate[f] = PETSC_FALSE;
+    for (i=0; i<nformats; i++) {
+      for (f=0; f<MATSEQAIJAUTO_NFORMATS; f++) {
+        ierr = PetscStrcasecmp(formats[i],MatSeqAIJAutoFormats[f],&match);CHKERRQ(ierr);
+        if (match) break;
+      }
+      if (f == MATSEQAIJAUTO_NFORMATS) SETERRQ1(PetscObjectComm((PetscObject)B),PETSC_ERR_ARG_WRONG,"Unknown format %s for -mat_aijauto_formats",formats[i]);
+      aijauto->candidate[f] = PETSC_TRUE;
+      ierr = PetscFree(formats[i]);CHKERRQ(ierr);
+    }
+  }
+
+  /* Set function pointers for methods that we inherit from AIJ but override. */
+  B->ops->duplicate     = MatDuplicate_SeqAIJAuto;
+  B->ops->assemblyend   = MatAssemblyEnd_SeqAIJAuto;
+  B->ops->destroy       = MatDestroy_SeqAIJAuto;
+  B->ops->diagonalscale = MatDiagonalScale_SeqAIJAuto;
+  ierr = MatSeqAIJAutoSetOps_Private(B);CHKERRQ(ierr);
+
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaijauto_seqaij_C",MatConvert_SeqAIJAuto_SeqAIJ);CHKERRQ(ierr);
+
+  ierr    = PetscObjectChangeTypeName((PetscObject)B,MATSEQAIJAUTO);CHKERRQ(ierr);
+  *newmat = B;
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   MatCreateSeqAIJAuto - Creates a sparse matrix of type SEQAIJAUTO.
+   This type inherits from AIJ and uses the same storage, but MatMult() and MatMultAdd()
+   use the fastest of the SEQAIJ, SEQSELL, SEQAIJPERM, SEQAIJCRL and SEQBAIJ formats, selected
+   by timing a few products with each of them the first time the matrix is applied. Because
+   SEQAIJAUTO is a subtype of SEQAIJ, the option "-mat_seqaij_type seqaijauto" can be used to make
+   sequential AIJ matrices (including the diagonal and off-diagonal blocks of MPIAIJ matrices)
+   default to being instances of MATSEQAIJAUTO.
+
+   Collective
+
+   Input Parameters:
++  comm - MPI communicator, set to PETSC_COMM_SELF
+.  m - number of rows
+.  n - number of columns
+.  nz - number of nonzeros per row (same for all rows)
+-  nnz - array containing the number of nonzeros in the various rows
+         (possibly different for each row) or NULL
+
+   Output Parameter:
+.  A - the matrix
+
+   Options Database Keys:
++  -mat_aijauto_formats <aij,sell,aijperm,aijcrl,baij> - the formats to try
+.  -mat_aijauto_trials <5> - the number of timed products with each format
+-  -mat_aijauto_sell_fill <1.5> - SEQSELL is not tried if its padding would increase the number of stored values by more than this ratio
+
+   Notes:
+   If nnz is given then nz is ignored
+
+   SEQBAIJ is only tried when the nonzeros form dense aligned blocks, whose size (at most 8) is detected from the nonzero structure.
+   The format is selected again when the nonzero structure changes. When only the values change, the copy in the
+   selected format is updated the next time it is used. Run with -info to see the timings and the selected format; -log_view
+   shows the products done with each format in the events "MatMult Autoaij", "MatMult Autosell" etc.
+
+   Level: intermediate
+
+.seealso: MatCreate(), MatCreateMPIAIJAuto(), MatSetValues()
+@*/
+PetscErrorCode  MatCreateSeqAIJAuto(MPI_Comm comm,PetscInt m,PetscInt n,PetscInt nz,const PetscInt nnz[],Mat *A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatCreate(comm,A);CHKERRQ(ierr);
+  ierr = MatSetSizes(*A,m,n,m,n);CHKERRQ(ierr);
+  ierr = MatSetType(*A,MATSEQAIJAUTO);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation_SeqAIJ(*A,nz,nnz);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJAuto(Mat A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSetType(A,MATSEQAIJ);CHKERRQ(ierr);
+  ierr = MatConvert_SeqAIJ_SeqAIJAuto(A,MATSEQAIJAUTO,MAT_INPLACE_MATRIX,&A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
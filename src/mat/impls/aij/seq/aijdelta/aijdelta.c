@@ -0,0 +1,439 @@
+/*
+  Defines basic operations for the MATSEQAIJDELTA matrix class.
+  This class is derived from the MATSEQAIJ class and retains the
+  compressed row storage unchanged, but MatMult(), MatMultAdd(), MatMultTranspose()
+  and MatMultTransposeAdd() read the column indices from a compressed copy of a->j:
+  each nonzero stores the difference of its column with the previous column in the
+  row in 8 or 16 bits. The values are not copied. The difference 0 cannot occur
+  within a row, so it marks the nonzeros whose full column is stored, in order, in a
+  separate array: the first nonzero of each row and those whose difference does not
+  fit. The products never read a->j.
+*/
+
+#include <../src/mat/impls/aij/seq/aij.h>
+
+typedef struct {
+  PetscInt         bits;                            /* bits of the differences, 8 or 16, 0 when the column indices are not compressed */
+  PetscInt         userbits;                        /* bits set with -mat_aijdelta_bits, 0 to select them from the memory traffic */
+  unsigned char    *d8;                             /* the differences of the columns, 0 for the nonzeros whose column is in ecol[] */
+  unsigned short   *d16;
+  PetscInt         *ecol;                           /* the columns of the nonzeros with difference 0, in the order of the nonzeros */
+  PetscObjectState nonzerostate;                    /* nonzero state of the matrix when the differences were computed */
+  PetscErrorCode   (*mult)(Mat,Vec,Vec);            /* the SEQAIJ kernels, which use inodes when available */
+  PetscErrorCode   (*multadd)(Mat,Vec,Vec,Vec);
+  PetscErrorCode   (*multtranspose)(Mat,Vec,Vec);
+  PetscErrorCode   (*multtransposeadd)(Mat,Vec,Vec,Vec);
+} Mat_SeqAIJDelta;
+
+/*
+   Computes the differences of the columns with the number of bits giving the least memory traffic for the column
+   indices, counting a PetscInt in ecol[] for the first nonzero of each nonempty row and for each difference that does
+   not fit, or keeps a->j if neither is smaller
+*/
+static PetscErrorCode MatSeqAIJDeltaEncode_Private(Mat A)
+{
+  Mat_SeqAIJ      *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJDelta *ad = (Mat_SeqAIJDelta*)A->spptr;
+  const PetscInt  *ai = a->i,*aj = a->j;
+  PetscInt        i,k,m = A->rmap->n,delta,nrows = 0,nescape8 = 0,nescape16 = 0,ne;
+  PetscReal       bytes8,bytes16,bytes;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree(ad->d8);CHKERRQ(ierr);
+  ierr = PetscFree(ad->d16);CHKERRQ(ierr);
+  ierr = PetscFree(ad->ecol);CHKERRQ(ierr);
+  ad->bits         = 0;
+  ad->nonzerostate = A->nonzerostate;
+  if (!a->nz) PetscFunctionReturn(0);
+  for (i=0; i<m; i++) {
+    if (ai[i+1] == ai[i]) continue;
+    nrows++;
+    for (k=ai[i]+1; k<ai[i+1]; k++) {
+      delta = aj[k] - aj[k-1];
+      if (delta > 255) nescape8++;
+      if (delta > PETSC_MAX_UINT16) nescape16++;
+    }
+  }
+  bytes   = (PetscReal)a->nz*sizeof(PetscInt);
+  bytes8  = (PetscReal)a->nz + (PetscReal)(nrows + nescape8)*sizeof(PetscInt);
+  bytes16 = 2.0*a->nz + (PetscReal)(nrows + nescape16)*sizeof(PetscInt);
+  if (ad->userbits) ad->bits = ad->userbits;
+  else if (bytes8 <= bytes16 && bytes8 < bytes) ad->bits = 8;
+  else if (bytes16 < bytes) ad->bits = 16;
+  ierr = PetscInfo6(A,"Column indices %g bytes, with 8 bit differences %g bytes, with 16 bit differences %g bytes, %D rows and %D and %D differences that do not fit\n",bytes,bytes8,bytes16,nrows,nescape8,nescape16);CHKERRQ(ierr);
+  ierr = PetscInfo1(A,"Using %D bit differences of the column indices\n",ad->bits);CHKERRQ(ierr);
+
+  if (ad->bits == 8) {
+    ierr = PetscMalloc1(a->nz,&ad->d8);CHKERRQ(ierr);
+    ierr = PetscMalloc1(nrows+nescape8,&ad->ecol);CHKERRQ(ierr);
+    ierr = PetscLogObjectMemory((PetscObject)A,a->nz*sizeof(unsigned char)+(nrows+nescape8)*sizeof(PetscInt));CHKERRQ(ierr);
+  } else if (ad->bits == 16) {
+    ierr = PetscMalloc1(a->nz,&ad->d16);CHKERRQ(ierr);
+    ierr = PetscMalloc1(nrows+nescape16,&ad->ecol);CHKERRQ(ierr);
+    ierr = PetscLogObjectMemory((PetscObject)A,a->nz*sizeof(unsigned short)+(nrows+nescape16)*sizeof(PetscInt));CHKERRQ(ierr);
+  } else PetscFunctionReturn(0);
+  for (ne=0,i=0; i<m; i++) {
+    for (k=ai[i]; k<ai[i+1]; k++) {
+      delta = (k == ai[i]) ? 0 : aj[k] - aj[k-1];
+      if (delta > (ad->bits == 8 ? 255 : PETSC_MAX_UINT16)) delta = 0;
+      if (!delta) ad->ecol[ne++] = aj[k];
+      if (ad->bits == 8) ad->d8[k] = (unsigned char)delta;
+      else ad->d16[k] = (unsigned short)delta;
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+PETSC_STATIC_INLINE PetscErrorCode MatSeqAIJDeltaUpdate_Private(Mat A)
+{
+  Mat_SeqAIJDelta *ad = (Mat_SeqAIJDelta*)A->spptr;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  if (ad->nonzerostate != A->nonzerostate) {ierr = MatSeqAIJDeltaEncode_Private(A);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+/*
+   The rows i of the loops are the nonempty rows ridx[i] when the compressed row format is used; col is the column of
+   the nonzero k, decoded from the difference d[k] with the previous column in the row, or read from the next entry ec
+   of ecol[] when d[k] is 0. The rows are visited in order, so ecol[] is read sequentially.
+*/
+#define MatSeqAIJDeltaMultRows_Private(d) do {                                 \
+    for (i=0; i<m; i++) {                                                       \
+      row = ridx ? ridx[i] : i;                                                 \
+      sum = add ? y[row] : 0.0;                                                 \
+      col = 0;                                                                  \
+      for (k=ii[i]; k<ii[i+1]; k++) {                                           \
+        col  = (d)[k] ? col + (d)[k] : *ec++;                                   \
+        sum += aa[k]*x[col];                                                    \
+      }                                                                         \
+      z[row] = sum;                                                             \
+    }                                                                           \
+  } while (0)
+
+#define MatSeqAIJDeltaMultTransposeRows_Private(d) do {                        \
+    for (i=0; i<m; i++) {                                                       \
+      alpha = x[ridx ? ridx[i] : i];                                            \
+      col   = 0;                                                                \
+      for (k=ii[i]; k<ii[i+1]; k++) {                                           \
+        col     = (d)[k] ? col + (d)[k] : *ec++;                                \
+        z[col] += alpha*aa[k];                                                  \
+      }                                                                         \
+    }                                                                           \
+  } while (0)
+
+/* z = A x, or z = y + A x when add is true */
+static PetscErrorCode MatSeqAIJDeltaMult_Private(Mat A,Vec xx,Vec yy,Vec zz,PetscBool add)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJDelta   *ad = (Mat_SeqAIJDelta*)A->spptr;
+  const PetscInt    *ii = a->i,*ec = ad->ecol,*ridx = NULL;
+  const MatScalar   *aa = a->a;
+  const PetscScalar *x,*y = NULL;
+  PetscScalar       *z,sum;
+  PetscInt          i,k,m = A->rmap->n,row,col;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  if (add && yy != zz) {ierr = VecGetArrayRead(yy,&y);CHKERRQ(ierr);}
+  ierr = VecGetArray(zz,&z);CHKERRQ(ierr);
+  if (add && yy == zz) y = z;
+  if (a->compressedrow.use) {
+    if (!add) {ierr = PetscArrayzero(z,m);CHKERRQ(ierr);}
+    else if (yy != zz) {ierr = PetscArraycpy(z,y,m);CHKERRQ(ierr);}
+    m    = a->compressedrow.nrows;
+    ii   = a->compressedrow.i;
+    ridx = a->compressedrow.rindex;
+  }
+  if (ad->bits == 8) MatSeqAIJDeltaMultRows_Private(ad->d8);
+  else               MatSeqAIJDeltaMultRows_Private(ad->d16);
+  ierr = PetscLogFlops(add ? 2.0*a->nz : 2.0*a->nz - a->nonzerorowcnt);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  if (add && yy != zz) {ierr = VecRestoreArrayRead(yy,&y);CHKERRQ(ierr);}
+  ierr = VecRestoreArray(zz,&z);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMult_SeqAIJDelta(Mat A,Vec xx,Vec yy)
+{
+  Mat_SeqAIJDelta *ad = (Mat_SeqAIJDelta*)A->spptr;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJDeltaUpdate_Private(A);CHKERRQ(ierr);
+  if (!ad->bits) {
+    ierr = (*ad->mult)(A,xx,yy);CHKERRQ(ierr);
+  } else {
+    ierr = MatSeqAIJDeltaMult_Private(A,xx,NULL,yy,PETSC_FALSE);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMultAdd_SeqAIJDelta(Mat A,Vec xx,Vec yy,Vec zz)
+{
+  Mat_SeqAIJDelta *ad = (Mat_SeqAIJDelta*)A->spptr;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJDeltaUpdate_Private(A);CHKERRQ(ierr);
+  if (!ad->bits) {
+    ierr = (*ad->multadd)(A,xx,yy,zz);CHKERRQ(ierr);
+  } else {
+    ierr = MatSeqAIJDeltaMult_Private(A,xx,yy,zz,PETSC_TRUE);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMultTransposeAdd_SeqAIJDelta(Mat A,Vec xx,Vec yy,Vec zz)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJDelta   *ad = (Mat_SeqAIJDelta*)A->spptr;
+  const PetscInt    *ii = a->i,*ec = ad->ecol,*ridx = NULL;
+  const MatScalar   *aa = a->a;
+  const PetscScalar *x;
+  PetscScalar       *z,alpha;
+  PetscInt          i,k,m = A->rmap->n,col;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJDeltaUpdate_Private(A);CHKERRQ(ierr);
+  if (!ad->bits) {
+    ierr = (*ad->multtransposeadd)(A,xx,yy,zz);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  if (zz != yy) {ierr = VecCopy(yy,zz);CHKERRQ(ierr);}
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArray(zz,&z);CHKERRQ(ierr);
+  if (a->compressedrow.use) {
+    m    = a->compressedrow.nrows;
+    ii   = a->compressedrow.i;
+    ridx = a->compressedrow.rindex;
+  }
+  if (ad->bits == 8) MatSeqAIJDeltaMultTransposeRows_Private(ad->d8);
+  else               MatSeqAIJDeltaMultTransposeRows_Private(ad->d16);
+  ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArray(zz,&z);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMultTranspose_SeqAIJDelta(Mat A,Vec xx,Vec yy)
+{
+  Mat_SeqAIJDelta *ad = (Mat_SeqAIJDelta*)A->spptr;
+  PetscErrorCode  ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJDeltaUpdate_Private(A);CHKERRQ(ierr);
+  if (!ad->bits) {
+    ierr = (*ad->multtranspose)(A,xx,yy);CHKERRQ(ierr);
+  } else {
+    ierr = VecSet(yy,0.0);CHKERRQ(ierr);
+    ierr = MatMultTransposeAdd_SeqAIJDelta(A,xx,yy,yy);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   The SEQAIJ assembly and duplication set the inode kernels when the matrix has inodes, so they are saved for the
+   matrices whose column indices are not compressed before the products are overridden
+*/
+static PetscErrorCode MatSeqAIJDeltaSetOps_Private(Mat A)
+{
+  Mat_SeqAIJDelta *ad = (Mat_SeqAIJDelta*)A->spptr;
+
+  PetscFunctionBegin;
+  ad->mult                     = A->ops->mult             == MatMult_SeqAIJDelta             ? MatMult_SeqAIJ             : A->ops->mult;
+  ad->multadd                  = A->ops->multadd          == MatMultAdd_SeqAIJDelta          ? MatMultAdd_SeqAIJ          : A->ops->multadd;
+  ad->multtranspose            = A->ops->multtranspose    == MatMultTranspose_SeqAIJDelta    ? MatMultTranspose_SeqAIJ    : A->ops->multtranspose;
+  ad->multtransposeadd         = A->ops->multtransposeadd == MatMultTransposeAdd_SeqAIJDelta ? MatMultTransposeAdd_SeqAIJ : A->ops->multtransposeadd;
+  A->ops->mult                 = MatMult_SeqAIJDelta;
+  A->ops->multadd              = MatMultAdd_SeqAIJDelta;
+  A->ops->multtranspose        = MatMultTranspose_SeqAIJDelta;
+  A->ops->multtransposeadd     = MatMultTransposeAdd_SeqAIJDelta;
+  PetscFunctionReturn(0);
+}
+
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJDelta_SeqAIJ(Mat A,MatType type,MatReuse reuse,Mat *newmat)
+{
+  /* This routine is only called to convert a MATAIJDELTA to its base PETSc type, */
+  /* so we will ignore 'MatType type'. */
+  PetscErrorCode  ierr;
+  Mat             B = *newmat;
+  Mat_SeqAIJDelta *ad;
+
+  PetscFunctionBegin;
+  if (reuse == MAT_INITIAL_MATRIX) {
+    ierr = MatDuplicate(A,MAT_COPY_VALUES,&B);CHKERRQ(ierr);
+  }
+  ad = (Mat_SeqAIJDelta*)B->spptr;
+
+  /* Reset the original function pointers. */
+  B->ops->duplicate        = MatDuplicate_SeqAIJ;
+  B->ops->assemblyend      = MatAssemblyEnd_SeqAIJ;
+  B->ops->destroy          = MatDestroy_SeqAIJ;
+  B->ops->mult             = ad->mult;
+  B->ops->multadd          = ad->multadd;
+  B->ops->multtranspose    = ad->multtranspose;
+  B->ops->multtransposeadd = ad->multtransposeadd;
+
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaijdelta_seqaij_C",NULL);CHKERRQ(ierr);
+
+  /* Free everything in the Mat_SeqAIJDelta data structure. */
+  ierr = PetscFree(ad->d8);CHKERRQ(ierr);
+  ierr = PetscFree(ad->d16);CHKERRQ(ierr);
+  ierr = PetscFree(ad->ecol);CHKERRQ(ierr);
+  ierr = PetscFree(B->spptr);CHKERRQ(ierr);
+
+  /* Change the type of B to MATSEQAIJ. */
+  ierr = PetscObjectChangeTypeName((PetscObject)B,MATSEQAIJ);CHKERRQ(ierr);
+
+  *newmat = B;
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatDestroy_SeqAIJDelta(Mat A)
+{
+  PetscErrorCode  ierr;
+  Mat_SeqAIJDelta *ad = (Mat_SeqAIJDelta*)A->spptr;
+
+  PetscFunctionBegin;
+  if (ad) {
+    /* If MatHeaderMerge() was used then this SeqAIJDelta matrix will not have a spptr. */
+    ierr = PetscFree(ad->d8);CHKERRQ(ierr);
+    ierr = PetscFree(ad->d16);CHKERRQ(ierr);
+    ierr = PetscFree(ad->ecol);CHKERRQ(ierr);
+    ierr = PetscFree(A->spptr);CHKERRQ(ierr);
+  }
+  /* Change the type of A back to SEQAIJ and use MatDestroy_SeqAIJ() to destroy everything that remains. */
+  ierr = PetscObjectChangeTypeName((PetscObject)A,MATSEQAIJ);CHKERRQ(ierr);
+  ierr = MatDestroy_SeqAIJ(A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatAssemblyEnd_SeqAIJDelta(Mat A,MatAssemblyType mode)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (mode == MAT_FLUSH_ASSEMBLY) PetscFunctionReturn(0);
+  ierr = MatAssemblyEnd_SeqAIJ(A,mode);CHKERRQ(ierr);
+  ierr = MatSeqAIJDeltaSetOps_Private(A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatDuplicate_SeqAIJDelta(Mat A,MatDuplicateOption op,Mat *M)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  /* MatDuplicate_SeqAIJ() creates the duplicate with the type of A, its column indices are compressed when they are used */
+  ierr = MatDuplicate_SeqAIJ(A,op,M);CHKERRQ(ierr);
+  ierr = MatSeqAIJDeltaSetOps_Private(*M);CHKERRQ(ierr);
+  ((Mat_SeqAIJDelta*)(*M)->spptr)->userbits = ((Mat_SeqAIJDelta*)A->spptr)->userbits;
+  PetscFunctionReturn(0);
+}
+
+/* MatConvert_SeqAIJ_SeqAIJDelta converts a SeqAIJ matrix into a
+ * SeqAIJDelta matrix.  This routine is called by the MatCreate_SeqAIJDelta()
+ * routine, but can also be used to convert an assembled SeqAIJ matrix
+ * into a SeqAIJDelta one. */
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJDelta(Mat A,MatType type,MatReuse reuse,Mat *newmat)
+{
+  PetscErrorCode  ierr;
+  Mat             B = *newmat;
+  Mat_SeqAIJDelta *ad;
+  PetscBool       sametype;
+
+  PetscFunctionBegin;
+  if (reuse == MAT_INITIAL_MATRIX) {
+    ierr = MatDuplicate(A,MAT_COPY_VALUES,&B);CHKERRQ(ierr);
+  }
+  ierr = PetscObjectTypeCompare((PetscObject)A,type,&sametype);CHKERRQ(ierr);
+  if (sametype) PetscFunctionReturn(0);
+
+  ierr     = PetscNewLog(B,&ad);CHKERRQ(ierr);
+  B->spptr = (void*)ad;
+
+  ad->nonzerostate = -1; /* this will trigger the compression of the column indices the first time they are used */
+
+  ierr = PetscOptionsBegin(PetscObjectComm((PetscObject)B),((PetscObject)B)->prefix,"AIJDELTA Options","Mat");CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-mat_aijdelta_bits","Bits of the differences of the column indices: 8, 16, or 0 to select them from the memory traffic","None",ad->userbits,&ad->userbits,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsEnd();CHKERRQ(ierr);
+  if (ad->userbits && ad->userbits != 8 && ad->userbits != 16) SETERRQ1(PetscObjectComm((PetscObject)B),PETSC_ERR_ARG_OUTOFRANGE,"Differences of the column indices of %D bits are not supported, use 8 or 16",ad->userbits);
+
+  /* Set function pointers for methods that we inherit from AIJ but override. */
+  B->ops->duplicate   = MatDuplicate_SeqAIJDelta;
+  B->ops->assemblyend = MatAssemblyEnd_SeqAIJDelta;
+  B->ops->destroy     = MatDestroy_SeqAIJDelta;
+  ierr = MatSeqAIJDeltaSetOps_Private(B);CHKERRQ(ierr);
+
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaijdelta_seqaij_C",MatConvert_SeqAIJDelta_SeqAIJ);CHKERRQ(ierr);
+
+  ierr    = PetscObjectChangeTypeName((PetscObject)B,MATSEQAIJDELTA);CHKERRQ(ierr);
+  *newmat = B;
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   MatCreateSeqAIJDelta - Creates a sparse matrix of type SEQAIJDELTA.
+   This type inherits from AIJ and uses the same storage, but the products with the matrix and its transpose
+   read the column indices from a compressed copy that stores the difference of each column with the previous
+   column in the row in 8 or 16 bits. Because SEQAIJDELTA is a subtype of SEQAIJ, the option
+   "-mat_seqaij_type seqaijdelta" can be used to make sequential AIJ matrices (including the diagonal and
+   off-diagonal blocks of MPIAIJ matrices) default to being instances of MATSEQAIJDELTA.
+
+   Collective
+
+   Input Parameters:
++  comm - MPI communicator, set to PETSC_COMM_SELF
+.  m - number of rows
+.  n - number of columns
+.  nz - number of nonzeros per row (same for all rows)
+-  nnz - array containing the number of nonzeros in the various rows
+         (possibly different for each row) or NULL
+
+   Output Parameter:
+.  A - the matrix
+
+   Options Database Keys:
+.  -mat_aijdelta_bits <0> - the bits of the differences, 8 or 16, or 0 to select the ones giving the least memory traffic for the column indices
+
+   Notes:
+   If nnz is given then nz is ignored
+
+   The column of the first nonzero of each nonempty row, and of the nonzeros whose difference does not fit in the bits,
+   is stored as a PetscInt in a separate array, read in order by the kernels. The compressed indices thus cost 1 or 2 bytes
+   for each nonzero plus a PetscInt for each such column, on top of the SEQAIJ storage which is kept. The differences are
+   small for matrices with a small bandwidth, for example after a reordering with MatGetOrdering() and MATORDERINGRCM.
+   When neither 8 nor 16 bits reduce the memory traffic, the SEQAIJ kernels are used. The differences are computed again
+   when the nonzero structure changes; the values are not copied.
+   Run with -info to see the memory traffic of the column indices with each number of bits.
+
+   Level: intermediate
+
+.seealso: MatCreate(), MatCreateMPIAIJDelta(), MatSetValues()
+@*/
+PetscErrorCode  MatCreateSeqAIJDelta(MPI_Comm comm,PetscInt m,PetscInt n,PetscInt nz,const PetscInt nnz[],Mat *A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatCreate(comm,A);CHKERRQ(ierr);
+  ierr = MatSetSizes(*A,m,n,m,n);CHKERRQ(ierr);
+  ierr = MatSetType(*A,MATSEQAIJDELTA);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation_SeqAIJ(*A,nz,nnz);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJDelta(Mat A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSetType(A,MATSEQAIJ);CHKERRQ(ierr);
+  ierr = MatConvert_SeqAIJ_SeqAIJDelta(A,MATSEQAIJDELTA,MAT_INPLACE_MATRIX,&A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
@@ -601,6 +601,7 @@ PetscErrorCode MatLUFactorNumeric_SeqAIJ(Mat B,Mat A,const MatFactorInfo *info)
   C->ops->matsolve          = MatMatSolve_SeqAIJ;
   C->assembled              = PETSC_TRUE;
   C->preallocated           = PETSC_TRUE;
+  ierr = MatSetUpSolveLevels_SeqAIJ(C,A);CHKERRQ(ierr);
 
   ierr = PetscLogFlops(C->cmap->n);CHKERRQ(ierr);
 
@@ -2170,6 +2171,7 @@ PetscErrorCode MatCholeskyFactorNumeric_SeqAIJ(Mat B,Mat A,const MatFactorInfo *
 
   C->assembled    = PETSC_TRUE;
   C->preallocated = PETSC_TRUE;
+  ierr = MatSetUpSolveLevels_SeqAIJ(C,A);CHKERRQ(ierr);
 
   ierr = PetscLogFlops(C->rmap->n);CHKERRQ(ierr);
 
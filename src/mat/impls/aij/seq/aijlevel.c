@@ -0,0 +1,404 @@
+/*
+    Level scheduled triangular solves for the LU, ILU, Cholesky and ICC factors of SeqAIJ matrices.
+
+    When the factors are computed the rows of each triangular factor are sorted into levels: a row only
+  depends on rows of lower levels, so all the rows of one level can be solved at the same time. The
+  solves then run level by level with the rows of each level shared among the threads, with one barrier
+  per level. All the sweeps are done in "gather" form, x[i] = (x[i] - sum_j T(i,j) x[j]) d[i]; the sweeps with
+  the transposed factors (used by MatSolveTranspose() and the U^T sweep of the Cholesky factors) use a column
+  oriented copy of the nonzero structure of the factor that points into the values of the factor.
+
+    Enabled with -mat_solve_level_threads <n> on the matrix being factored.
+*/
+
+#include <../src/mat/impls/aij/seq/aij.h>
+#if defined(PETSC_HAVE_OPENMP)
+#include <omp.h>
+#endif
+
+/*
+   One triangular sweep: the rows rows[lptr[l]],...,rows[lptr[l+1]-1] form level l, row i uses the entries
+   start[i],...,start[i]+len[i]-1 of the column indices (idx[], or the column indices of the factor if idx is NULL)
+   and of the values of the factor (through pos[] if it is set)
+*/
+typedef struct {
+  PetscInt nlevels;
+  PetscInt *lptr,*rows;
+  PetscInt *start,*len;
+  PetscInt *idx,*pos;
+} Mat_SeqAIJLevelSweep;
+
+struct _n_Mat_SeqAIJLevels {
+  PetscInt             nthreads;     /* number of threads used by the solves */
+  PetscBool            cholesky;     /* the factors are U^T D U stored as in MatCholeskyFactorNumeric_SeqAIJ() */
+  Mat_SeqAIJLevelSweep L,U;          /* sweeps of MatSolve() */
+  Mat_SeqAIJLevelSweep Ut,Lt;        /* sweeps of MatSolveTranspose() for LU factors, built on first use */
+  PetscBool            transposed;   /* Ut and Lt have been built */
+  PetscInt             nwork;        /* length of work[] */
+  PetscScalar          *work;        /* work space of MatMatSolve() */
+};
+
+static PetscErrorCode MatSeqAIJLevelSweepDestroy_Private(Mat_SeqAIJLevelSweep *s)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree(s->lptr);CHKERRQ(ierr);
+  ierr = PetscFree3(s->rows,s->start,s->len);CHKERRQ(ierr);
+  ierr = PetscFree2(s->idx,s->pos);CHKERRQ(ierr);
+  ierr = PetscMemzero(s,sizeof(*s));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Sorts the rows of a sweep, whose start[] and len[] have been set, into levels. The rows are solved in
+   the order 0,...,n-1 (or n-1,...,0 if reverse is set) by the sequential sweep, hence every row it depends on
+   has its level computed before it
+*/
+static PetscErrorCode MatSeqAIJLevelSweepSetUp_Private(Mat_SeqAIJLevelSweep *s,PetscInt n,const PetscInt *aj,PetscBool reverse)
+{
+  PetscErrorCode ierr;
+  const PetscInt *idx = s->idx ? s->idx : aj,*vi;
+  PetscInt       i,ii,j,lev,*level;
+
+  PetscFunctionBegin;
+  ierr = PetscMalloc1(n,&level);CHKERRQ(ierr);
+  s->nlevels = 0;
+  for (ii=0; ii<n; ii++) {
+    i   = reverse ? n-1-ii : ii;
+    vi  = idx + s->start[i];
+    lev = 0;
+    for (j=0; j<s->len[i]; j++) lev = PetscMax(lev,level[vi[j]]+1);
+    level[i]   = lev;
+    s->nlevels = PetscMax(s->nlevels,lev+1);
+  }
+  /* counting sort of the rows by level, the rows of each level stay in increasing order */
+  ierr = PetscCalloc1(s->nlevels+1,&s->lptr);CHKERRQ(ierr);
+  for (i=0; i<n; i++) s->lptr[level[i]+1]++;
+  for (lev=0; lev<s->nlevels; lev++) s->lptr[lev+1] += s->lptr[lev];
+  for (i=0; i<n; i++) s->rows[s->lptr[level[i]]++] = i;
+  for (lev=s->nlevels; lev>0; lev--) s->lptr[lev] = s->lptr[lev-1];
+  s->lptr[0] = 0;
+  ierr = PetscFree(level);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Allocates a sweep with n rows, lptr[] is allocated in MatSeqAIJLevelSweepSetUp_Private() once the number of levels is known
+*/
+static PetscErrorCode MatSeqAIJLevelSweepCreate_Private(Mat_SeqAIJLevelSweep *s,PetscInt n)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscMemzero(s,sizeof(*s));CHKERRQ(ierr);
+  ierr = PetscMalloc3(n,&s->rows,n,&s->start,n,&s->len);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Builds the sweep with the transpose of the triangular factor given by the sweep s, that is row i of t is column i of s
+*/
+static PetscErrorCode MatSeqAIJLevelSweepTranspose_Private(const Mat_SeqAIJLevelSweep *s,PetscInt n,const PetscInt *aj,PetscBool reverse,Mat_SeqAIJLevelSweep *t)
+{
+  PetscErrorCode ierr;
+  PetscInt       i,j,k,nz = 0;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJLevelSweepCreate_Private(t,n);CHKERRQ(ierr);
+  for (i=0; i<n; i++) nz += s->len[i];
+  ierr = PetscMalloc2(nz,&t->idx,nz,&t->pos);CHKERRQ(ierr);
+  ierr = PetscArrayzero(t->len,n);CHKERRQ(ierr);
+  for (i=0; i<n; i++) {
+    for (j=0; j<s->len[i]; j++) t->len[aj[s->start[i]+j]]++;
+  }
+  t->start[0] = 0;
+  for (i=1; i<n; i++) t->start[i] = t->start[i-1] + t->len[i-1];
+  ierr = PetscArrayzero(t->len,n);CHKERRQ(ierr);
+  for (i=0; i<n; i++) {
+    for (j=0; j<s->len[i]; j++) {
+      k = aj[s->start[i]+j];
+      t->idx[t->start[k]+t->len[k]] = i;
+      t->pos[t->start[k]+t->len[k]] = s->start[i]+j;
+      t->len[k]++;
+    }
+  }
+  ierr = MatSeqAIJLevelSweepSetUp_Private(t,n,aj,reverse);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   x[i] = (x[i] -/+ sum_j T(i,j) x[j]) * aa[diag[i]] for the nrhs columns of x, level by level.
+
+   Must be called by all the threads of a parallel region, the rows of each level are shared among the threads with an orphaned
+   worksharing loop whose implicit barrier separates the levels
+*/
+static void MatSeqAIJLevelSweep_Private(const Mat_SeqAIJLevelSweep *s,const PetscInt *aj,const MatScalar *aa,const PetscInt *diag,PetscBool add,PetscInt nrhs,PetscScalar *x,PetscInt ldx)
+{
+  const PetscInt *idx = s->idx ? s->idx : aj,*pos = s->pos;
+  PetscInt       l;
+
+  for (l=0; l<s->nlevels; l++) {
+    PetscInt k;
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp for schedule(static)
+#endif
+    for (k=s->lptr[l]; k<s->lptr[l+1]; k++) {
+      const PetscInt  i = s->rows[k],nz = s->len[i],*vi = idx + s->start[i];
+      const MatScalar *v = aa + s->start[i];
+      PetscScalar     *xc,sum;
+      PetscInt        c,j;
+
+      for (c=0; c<nrhs; c++) {
+        xc  = x + c*ldx;
+        sum = 0.0;
+        if (pos) {
+          const PetscInt *vp = pos + s->start[i];
+          for (j=0; j<nz; j++) sum += aa[vp[j]]*xc[vi[j]];
+        } else {
+          PetscSparseDensePlusDot(sum,xc,v,vi,nz);
+        }
+        sum   = add ? xc[i] + sum : xc[i] - sum;
+        xc[i] = diag ? sum*aa[diag[i]] : sum;
+      }
+    }
+  }
+}
+
+/*
+   x = inv(U) inv(L) P b for the LU factors, or x = P^T inv(U) inv(D) inv(U^T) P b for the Cholesky factors, for the nrhs columns of b
+*/
+static PetscErrorCode MatSolveLevels_SeqAIJ_Private(Mat A,PetscInt nrhs,const PetscScalar *b,PetscInt ldb,PetscScalar *x,PetscInt ldx,PetscScalar *tmp)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJLevels  *lv = a->levels;
+  PetscErrorCode    ierr;
+  PetscInt          n = A->rmap->n;
+  const PetscInt    *r,*c,*aj = a->j,*adiag = a->diag;
+  const MatScalar   *aa = a->a;
+  PetscBool         cholesky = lv->cholesky;
+
+  PetscFunctionBegin;
+  ierr = ISGetIndices(a->row,&r);CHKERRQ(ierr);
+  if (cholesky) c = r;
+  else {ierr = ISGetIndices(a->col,&c);CHKERRQ(ierr);}
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel num_threads(lv->nthreads)
+#endif
+  {
+    PetscInt i,k;
+
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp for schedule(static)
+#endif
+    for (i=0; i<n; i++) {
+      for (k=0; k<nrhs; k++) tmp[i+k*n] = b[r[i]+k*ldb];
+    }
+    if (cholesky) {
+      MatSeqAIJLevelSweep_Private(&lv->L,aj,aa,NULL,PETSC_TRUE,nrhs,tmp,n);
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp for schedule(static)
+#endif
+      for (i=0; i<n; i++) {
+        for (k=0; k<nrhs; k++) tmp[i+k*n] *= aa[adiag[i]];
+      }
+      MatSeqAIJLevelSweep_Private(&lv->U,aj,aa,NULL,PETSC_TRUE,nrhs,tmp,n);
+    } else {
+      MatSeqAIJLevelSweep_Private(&lv->L,aj,aa,NULL,PETSC_FALSE,nrhs,tmp,n);
+      MatSeqAIJLevelSweep_Private(&lv->U,aj,aa,adiag,PETSC_FALSE,nrhs,tmp,n);
+    }
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp for schedule(static)
+#endif
+    for (i=0; i<n; i++) {
+      for (k=0; k<nrhs; k++) x[c[i]+k*ldx] = tmp[i+k*n];
+    }
+  }
+  ierr = ISRestoreIndices(a->row,&r);CHKERRQ(ierr);
+  if (!cholesky) {ierr = ISRestoreIndices(a->col,&c);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSolve_SeqAIJ_Levels(Mat A,Vec bb,Vec xx)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
+  PetscErrorCode    ierr;
+  PetscInt          n = A->rmap->n;
+  const PetscScalar *b;
+  PetscScalar       *x;
+
+  PetscFunctionBegin;
+  if (!n) PetscFunctionReturn(0);
+  ierr = VecGetArrayRead(bb,&b);CHKERRQ(ierr);
+  ierr = VecGetArrayWrite(xx,&x);CHKERRQ(ierr);
+  ierr = MatSolveLevels_SeqAIJ_Private(A,1,b,n,x,n,a->solve_work);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(bb,&b);CHKERRQ(ierr);
+  ierr = VecRestoreArrayWrite(xx,&x);CHKERRQ(ierr);
+  if (a->levels->cholesky) {ierr = PetscLogFlops(4.0*a->nz - 3.0*n);CHKERRQ(ierr);}
+  else {ierr = PetscLogFlops(2.0*a->nz - n);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatMatSolve_SeqAIJ_Levels(Mat A,Mat B,Mat X)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJLevels  *lv = a->levels;
+  PetscErrorCode    ierr;
+  PetscInt          n = A->rmap->n,nrhs = B->cmap->n,ldb,ldx;
+  const PetscScalar *b;
+  PetscScalar       *x;
+  PetscBool         isdense;
+
+  PetscFunctionBegin;
+  if (!n) PetscFunctionReturn(0);
+  ierr = PetscObjectTypeCompare((PetscObject)B,MATSEQDENSE,&isdense);CHKERRQ(ierr);
+  if (!isdense) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_INCOMP,"B matrix must be a SeqDense matrix");
+  if (X != B) {
+    ierr = PetscObjectTypeCompare((PetscObject)X,MATSEQDENSE,&isdense);CHKERRQ(ierr);
+    if (!isdense) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_INCOMP,"X matrix must be a SeqDense matrix");
+  }
+  if (lv->nwork < n*nrhs) {
+    ierr      = PetscFree(lv->work);CHKERRQ(ierr);
+    lv->nwork = n*nrhs;
+    ierr      = PetscMalloc1(lv->nwork,&lv->work);CHKERRQ(ierr);
+  }
+  ierr = MatDenseGetArrayRead(B,&b);CHKERRQ(ierr);
+  ierr = MatDenseGetLDA(B,&ldb);CHKERRQ(ierr);
+  ierr = MatDenseGetArray(X,&x);CHKERRQ(ierr);
+  ierr = MatDenseGetLDA(X,&ldx);CHKERRQ(ierr);
+  /* X may be B, all of B is read into the work space before X is written */
+  ierr = MatSolveLevels_SeqAIJ_Private(A,nrhs,b,ldb,x,ldx,lv->work);CHKERRQ(ierr);
+  ierr = MatDenseRestoreArrayRead(B,&b);CHKERRQ(ierr);
+  ierr = MatDenseRestoreArray(X,&x);CHKERRQ(ierr);
+  if (lv->cholesky) {ierr = PetscLogFlops(nrhs*(4.0*a->nz - 3.0*n));CHKERRQ(ierr);}
+  else {ierr = PetscLogFlops(nrhs*(2.0*a->nz - n));CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSolveTranspose_SeqAIJ_Levels(Mat A,Vec bb,Vec xx)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJLevels  *lv = a->levels;
+  PetscErrorCode    ierr;
+  PetscInt          n = A->rmap->n;
+  const PetscInt    *r,*c,*aj = a->j,*adiag = a->diag;
+  const MatScalar   *aa = a->a;
+  const PetscScalar *b;
+  PetscScalar       *x,*tmp = a->solve_work;
+
+  PetscFunctionBegin;
+  if (!n) PetscFunctionReturn(0);
+  if (!lv->transposed) {
+    ierr = MatSeqAIJLevelSweepTranspose_Private(&lv->U,n,aj,PETSC_FALSE,&lv->Ut);CHKERRQ(ierr);
+    ierr = MatSeqAIJLevelSweepTranspose_Private(&lv->L,n,aj,PETSC_TRUE,&lv->Lt);CHKERRQ(ierr);
+    lv->transposed = PETSC_TRUE;
+    ierr = PetscInfo2(A,"Transposed triangular solves use %D and %D levels\n",lv->Ut.nlevels,lv->Lt.nlevels);CHKERRQ(ierr);
+  }
+  ierr = VecGetArrayRead(bb,&b);CHKERRQ(ierr);
+  ierr = VecGetArrayWrite(xx,&x);CHKERRQ(ierr);
+  ierr = ISGetIndices(a->row,&r);CHKERRQ(ierr);
+  ierr = ISGetIndices(a->col,&c);CHKERRQ(ierr);
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel num_threads(lv->nthreads)
+#endif
+  {
+    PetscInt i;
+
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp for schedule(static)
+#endif
+    for (i=0; i<n; i++) tmp[i] = b[c[i]];
+    MatSeqAIJLevelSweep_Private(&lv->Ut,aj,aa,adiag,PETSC_FALSE,1,tmp,n);
+    MatSeqAIJLevelSweep_Private(&lv->Lt,aj,aa,NULL,PETSC_FALSE,1,tmp,n);
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp for schedule(static)
+#endif
+    for (i=0; i<n; i++) x[r[i]] = tmp[i];
+  }
+  ierr = ISRestoreIndices(a->row,&r);CHKERRQ(ierr);
+  ierr = ISRestoreIndices(a->col,&c);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(bb,&b);CHKERRQ(ierr);
+  ierr = VecRestoreArrayWrite(xx,&x);CHKERRQ(ierr);
+  ierr = PetscLogFlops(2.0*a->nz - n);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatDestroySolveLevels_SeqAIJ(Mat A)
+{
+  Mat_SeqAIJ       *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJLevels *lv = a->levels;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  if (!lv) PetscFunctionReturn(0);
+  ierr = MatSeqAIJLevelSweepDestroy_Private(&lv->L);CHKERRQ(ierr);
+  ierr = MatSeqAIJLevelSweepDestroy_Private(&lv->U);CHKERRQ(ierr);
+  ierr = MatSeqAIJLevelSweepDestroy_Private(&lv->Ut);CHKERRQ(ierr);
+  ierr = MatSeqAIJLevelSweepDestroy_Private(&lv->Lt);CHKERRQ(ierr);
+  ierr = PetscFree(lv->work);CHKERRQ(ierr);
+  ierr = PetscFree(a->levels);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   MatSetUpSolveLevels_SeqAIJ - Called at the end of the numeric factorization of A into the factor matrix fact, with
+   -mat_solve_level_threads <n> (n > 0) on A sorts the rows of the factors into levels and replaces the triangular solves
+   of fact by the level scheduled ones
+
+   The sweeps with the transposed factors of MatSolveTranspose() are built the first time they are needed. The
+   supported factors are the ones of MatLUFactorNumeric_SeqAIJ(), MatLUFactorNumeric_SeqAIJ_Inode() and MatCholeskyFactorNumeric_SeqAIJ(),
+   the solves with inodes are replaced by row oriented ones.
+*/
+PetscErrorCode MatSetUpSolveLevels_SeqAIJ(Mat fact,Mat A)
+{
+  Mat_SeqAIJ       *a = (Mat_SeqAIJ*)fact->data;
+  Mat_SeqAIJLevels *lv;
+  PetscErrorCode   ierr;
+  PetscInt         i,n = fact->rmap->n,nthreads = 0;
+  const PetscInt   *ai = a->i,*adiag = a->diag;
+
+  PetscFunctionBegin;
+  ierr = MatDestroySolveLevels_SeqAIJ(fact);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(((PetscObject)A)->options,((PetscObject)A)->prefix,"-mat_solve_level_threads",&nthreads,NULL);CHKERRQ(ierr);
+  if (nthreads <= 0) PetscFunctionReturn(0);
+#if !defined(PETSC_HAVE_OPENMP)
+  if (nthreads > 1) {
+    ierr     = PetscInfo1(A,"PETSc was not configured with OpenMP, the level scheduled solves use 1 thread instead of %D\n",nthreads);CHKERRQ(ierr);
+    nthreads = 1;
+  }
+#endif
+  ierr = PetscNew(&lv);CHKERRQ(ierr);
+  a->levels    = lv;
+  lv->nthreads = nthreads;
+  lv->cholesky = (PetscBool)(fact->factortype == MAT_FACTOR_CHOLESKY || fact->factortype == MAT_FACTOR_ICC);
+  if (lv->cholesky) {
+    /* row k of U holds the columns larger than k in ai[k],...,ai[k+1]-2, the inverse of D(k) is at ai[k+1]-1 */
+    ierr = MatSeqAIJLevelSweepCreate_Private(&lv->U,n);CHKERRQ(ierr);
+    for (i=0; i<n; i++) {
+      lv->U.start[i] = ai[i];
+      lv->U.len[i]   = ai[i+1] - ai[i] - 1;
+    }
+    ierr = MatSeqAIJLevelSweepSetUp_Private(&lv->U,n,a->j,PETSC_TRUE);CHKERRQ(ierr);
+    ierr = MatSeqAIJLevelSweepTranspose_Private(&lv->U,n,a->j,PETSC_FALSE,&lv->L);CHKERRQ(ierr);
+    fact->ops->solve          = MatSolve_SeqAIJ_Levels;
+    fact->ops->solvetranspose = MatSolve_SeqAIJ_Levels;
+    fact->ops->matsolve       = MatMatSolve_SeqAIJ_Levels;
+  } else {
+    /* row i of L is in ai[i],...,ai[i+1]-1, row i of U is in adiag[i+1]+1,...,adiag[i]-1 and the inverse of U(i,i) is at adiag[i] */
+    ierr = MatSeqAIJLevelSweepCreate_Private(&lv->L,n);CHKERRQ(ierr);
+    ierr = MatSeqAIJLevelSweepCreate_Private(&lv->U,n);CHKERRQ(ierr);
+    for (i=0; i<n; i++) {
+      lv->L.start[i] = ai[i];
+      lv->L.len[i]   = ai[i+1] - ai[i];
+      lv->U.start[i] = adiag[i+1] + 1;
+      lv->U.len[i]   = adiag[i] - adiag[i+1] - 1;
+    }
+    ierr = MatSeqAIJLevelSweepSetUp_Private(&lv->L,n,a->j,PETSC_FALSE);CHKERRQ(ierr);
+    ierr = MatSeqAIJLevelSweepSetUp_Private(&lv->U,n,a->j,PETSC_TRUE);CHKERRQ(ierr);
+    fact->ops->solve          = MatSolve_SeqAIJ_Levels;
+    fact->ops->solvetranspose = MatSolveTranspose_SeqAIJ_Levels;
+    fact->ops->matsolve       = MatMatSolve_SeqAIJ_Levels;
+  }
+  ierr = PetscInfo4(A,"Level scheduled triangular solves with %D threads, %D and %D levels for %D rows\n",nthreads,lv->L.nlevels,lv->U.nlevels,n);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
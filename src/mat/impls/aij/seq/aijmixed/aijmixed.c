@@ -0,0 +1,503 @@
+/*
+  Defines basic operations for the MATSEQAIJMIXED matrix class.
+  This class is derived from the MATSEQAIJ class and retains the
+  compressed row storage unchanged, but keeps a single precision copy of
+  the matrix values that is used, with the vectors in full precision, by
+  MatMult(), MatMultAdd(), MatMultTranspose(), MatMultTransposeAdd() and
+  MatSOR(). These kernels are limited by the memory traffic, of which the
+  values are 8 of about 12 bytes per nonzero with 32-bit column indices;
+  reading them in single precision saves about a third of it.
+*/
+
+#include <../src/mat/impls/aij/seq/aij.h>
+
+#if defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX2__) && defined(__FMA__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_SKIP_IMMINTRIN_H_CUDAWORKAROUND)
+#define PETSC_AIJMIXED_USE_AVX2
+#include <immintrin.h>
+#endif
+
+typedef struct {
+  PetscObjectState state;  /* state of the matrix for which the single precision values were computed */
+  PetscInt         nz;     /* length of af[] */
+  float            *af;    /* single precision copy of the values */
+} Mat_SeqAIJMixed;
+
+/*
+   The inner kernel sum += \sum_j af[j]*x[aj[j]], the values are converted to full precision before the multiplication
+*/
+#if defined(PETSC_AIJMIXED_USE_AVX2)
+PETSC_STATIC_INLINE void MatSeqAIJMixedRowDot_Private(PetscScalar *sum,const PetscScalar *x,const float *af,const PetscInt *aj,PetscInt n)
+{
+  __m256d     vec_x,vec_y,vec_vals;
+  __m128d     vec_s;
+#if defined(PETSC_USE_64BIT_INDICES)
+  __m256i     vec_idx;
+#else
+  __m128i     vec_idx;
+#endif
+  PetscInt    j;
+  PetscScalar s;
+
+  vec_y = _mm256_setzero_pd();
+  for (j=0; j<n-3; j+=4) {
+#if defined(PETSC_USE_64BIT_INDICES)
+    vec_idx  = _mm256_loadu_si256((__m256i const*)(aj+j));
+    vec_x    = _mm256_i64gather_pd(x,vec_idx,8);
+#else
+    vec_idx  = _mm_loadu_si128((__m128i const*)(aj+j));
+    vec_x    = _mm256_i32gather_pd(x,vec_idx,8);
+#endif
+    vec_vals = _mm256_cvtps_pd(_mm_loadu_ps(af+j));
+    vec_y    = _mm256_fmadd_pd(vec_x,vec_vals,vec_y);
+  }
+  vec_s = _mm_add_pd(_mm256_castpd256_pd128(vec_y),_mm256_extractf128_pd(vec_y,1));
+  vec_s = _mm_hadd_pd(vec_s,vec_s);
+  s     = _mm_cvtsd_f64(vec_s);
+  for (; j<n; j++) s += (PetscScalar)af[j]*x[aj[j]];
+  *sum += s;
+}
+#else
+PETSC_STATIC_INLINE void MatSeqAIJMixedRowDot_Private(PetscScalar *sum,const PetscScalar *x,const float *af,const PetscInt *aj,PetscInt n)
+{
+  PetscInt    j;
+  PetscScalar s = 0.0;
+
+  for (j=0; j<n; j++) s += (PetscScalar)af[j]*x[aj[j]];
+  *sum += s;
+}
+#endif
+
+/*
+   Recomputes the single precision values if the matrix changed since they were last computed
+*/
+static PetscErrorCode MatSeqAIJMixedUpdate_Private(Mat A)
+{
+  Mat_SeqAIJ       *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJMixed  *aijmixed = (Mat_SeqAIJMixed*)A->spptr;
+  PetscObjectState state;
+  PetscInt         i,nz = a->i[A->rmap->n];
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectStateGet((PetscObject)A,&state);CHKERRQ(ierr);
+  if (state == aijmixed->state) PetscFunctionReturn(0);
+  if (aijmixed->nz != nz) {
+    ierr = PetscFree(aijmixed->af);CHKERRQ(ierr);
+    ierr = PetscMalloc1(nz,&aijmixed->af);CHKERRQ(ierr);
+    ierr = PetscLogObjectMemory((PetscObject)A,(nz-aijmixed->nz)*sizeof(float));CHKERRQ(ierr);
+    aijmixed->nz = nz;
+  }
+  for (i=0; i<nz; i++) aijmixed->af[i] = (float)PetscRealPart(a->a[i]);
+  aijmixed->state = state;
+  PetscFunctionReturn(0);
+}
+
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJMixed_SeqAIJ(Mat A,MatType type,MatReuse reuse,Mat *newmat)
+{
+  /* This routine is only called to convert a MATAIJMIXED to its base PETSc type, */
+  /* so we will ignore 'MatType type'. */
+  PetscErrorCode  ierr;
+  Mat             B = *newmat;
+  Mat_SeqAIJMixed *aijmixed;
+
+  PetscFunctionBegin;
+  if (reuse == MAT_INITIAL_MATRIX) {
+    ierr = MatDuplicate(A,MAT_COPY_VALUES,&B);CHKERRQ(ierr);
+  }
+  aijmixed = (Mat_SeqAIJMixed*)B->spptr;
+
+  /* Reset the original function pointers. */
+  B->ops->assemblyend      = MatAssemblyEnd_SeqAIJ;
+  B->ops->destroy          = MatDestroy_SeqAIJ;
+  B->ops->mult             = MatMult_SeqAIJ;
+  B->ops->multtranspose    = MatMultTranspose_SeqAIJ;
+  B->ops->multadd          = MatMultAdd_SeqAIJ;
+  B->ops->multtransposeadd = MatMultTransposeAdd_SeqAIJ;
+  B->ops->sor              = MatSOR_SeqAIJ;
+  B->ops->diagonalscale    = MatDiagonalScale_SeqAIJ;
+
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaijmixed_seqaij_C",NULL);CHKERRQ(ierr);
+
+  /* Free everything in the Mat_SeqAIJMixed data structure. */
+  ierr = PetscFree(aijmixed->af);CHKERRQ(ierr);
+  ierr = PetscFree(B->spptr);CHKERRQ(ierr);
+
+  /* Change the type of B to MATSEQAIJ. */
+  ierr = PetscObjectChangeTypeName((PetscObject)B,MATSEQAIJ);CHKERRQ(ierr);
+
+  *newmat = B;
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatDestroy_SeqAIJMixed(Mat A)
+{
+  PetscErrorCode  ierr;
+  Mat_SeqAIJMixed *aijmixed = (Mat_SeqAIJMixed*)A->spptr;
+
+  PetscFunctionBegin;
+  if (aijmixed) {
+    /* If MatHeaderMerge() was used then this SeqAIJMixed matrix will not have a spptr. */
+    ierr = PetscFree(aijmixed->af);CHKERRQ(ierr);
+    ierr = PetscFree(A->spptr);CHKERRQ(ierr);
+  }
+  /* Change the type of A back to SEQAIJ and use MatDestroy_SeqAIJ() to destroy everything that remains. */
+  ierr = PetscObjectChangeTypeName((PetscObject)A,MATSEQAIJ);CHKERRQ(ierr);
+  ierr = MatDestroy_SeqAIJ(A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatAssemblyEnd_SeqAIJMixed(Mat A,MatAssemblyType mode)
+{
+  PetscErrorCode ierr;
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+
+  PetscFunctionBegin;
+  if (mode == MAT_FLUSH_ASSEMBLY) PetscFunctionReturn(0);
+
+  /* Disable the inode routines since they would replace the single precision kernels */
+  a->inode.use = PETSC_FALSE;
+  ierr         = MatAssemblyEnd_SeqAIJ(A,mode);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   MatDiagonalScale_MPIAIJ() calls this directly on the blocks, so the state must be increased here to refresh the single precision values
+*/
+PetscErrorCode MatDiagonalScale_SeqAIJMixed(Mat A,Vec ll,Vec rr)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatDiagonalScale_SeqAIJ(A,ll,rr);CHKERRQ(ierr);
+  ierr = PetscObjectStateIncrease((PetscObject)A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMult_SeqAIJMixed(Mat A,Vec xx,Vec yy)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJMixed   *aijmixed = (Mat_SeqAIJMixed*)A->spptr;
+  PetscScalar       *y,sum;
+  const PetscScalar *x;
+  const float       *af;
+  const PetscInt    *aj = a->j,*ii,*ridx = NULL;
+  PetscInt          m = A->rmap->n,i;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJMixedUpdate_Private(A);CHKERRQ(ierr);
+  af   = aijmixed->af;
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArray(yy,&y);CHKERRQ(ierr);
+  if (a->compressedrow.use) { /* use compressed row format */
+    ierr = PetscArrayzero(y,m);CHKERRQ(ierr);
+    m    = a->compressedrow.nrows;
+    ii   = a->compressedrow.i;
+    ridx = a->compressedrow.rindex;
+    for (i=0; i<m; i++) {
+      sum = 0.0;
+      MatSeqAIJMixedRowDot_Private(&sum,x,af+ii[i],aj+ii[i],ii[i+1]-ii[i]);
+      y[ridx[i]] = sum;
+    }
+  } else {
+    ii = a->i;
+    for (i=0; i<m; i++) {
+      sum = 0.0;
+      MatSeqAIJMixedRowDot_Private(&sum,x,af+ii[i],aj+ii[i],ii[i+1]-ii[i]);
+      y[i] = sum;
+    }
+  }
+  ierr = PetscLogFlops(2.0*a->nz - a->nonzerorowcnt);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArray(yy,&y);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMultAdd_SeqAIJMixed(Mat A,Vec xx,Vec yy,Vec zz)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJMixed   *aijmixed = (Mat_SeqAIJMixed*)A->spptr;
+  PetscScalar       *y,*z,sum;
+  const PetscScalar *x;
+  const float       *af;
+  const PetscInt    *aj = a->j,*ii,*ridx = NULL;
+  PetscInt          m = A->rmap->n,i,r;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJMixedUpdate_Private(A);CHKERRQ(ierr);
+  af   = aijmixed->af;
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArrayPair(yy,zz,&y,&z);CHKERRQ(ierr);
+  if (a->compressedrow.use) { /* use compressed row format */
+    if (zz != yy) {
+      ierr = PetscArraycpy(z,y,m);CHKERRQ(ierr);
+    }
+    m    = a->compressedrow.nrows;
+    ii   = a->compressedrow.i;
+    ridx = a->compressedrow.rindex;
+    for (i=0; i<m; i++) {
+      r   = ridx[i];
+      sum = y[r];
+      MatSeqAIJMixedRowDot_Private(&sum,x,af+ii[i],aj+ii[i],ii[i+1]-ii[i]);
+      z[r] = sum;
+    }
+  } else {
+    ii = a->i;
+    for (i=0; i<m; i++) {
+      sum = y[i];
+      MatSeqAIJMixedRowDot_Private(&sum,x,af+ii[i],aj+ii[i],ii[i+1]-ii[i]);
+      z[i] = sum;
+    }
+  }
+  ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArrayPair(yy,zz,&y,&z);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMultTransposeAdd_SeqAIJMixed(Mat A,Vec xx,Vec zz,Vec yy)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJMixed   *aijmixed = (Mat_SeqAIJMixed*)A->spptr;
+  PetscScalar       *y,alpha;
+  const PetscScalar *x;
+  const float       *af;
+  const PetscInt    *aj = a->j,*ii,*ridx = NULL;
+  PetscInt          m = A->rmap->n,i,j;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJMixedUpdate_Private(A);CHKERRQ(ierr);
+  af   = aijmixed->af;
+  if (zz != yy) {ierr = VecCopy(zz,yy);CHKERRQ(ierr);}
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArray(yy,&y);CHKERRQ(ierr);
+  if (a->compressedrow.use) {
+    m    = a->compressedrow.nrows;
+    ii   = a->compressedrow.i;
+    ridx = a->compressedrow.rindex;
+  } else ii = a->i;
+  for (i=0; i<m; i++) {
+    alpha = ridx ? x[ridx[i]] : x[i];
+    for (j=ii[i]; j<ii[i+1]; j++) y[aj[j]] += alpha*(PetscScalar)af[j];
+  }
+  ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArray(yy,&y);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMultTranspose_SeqAIJMixed(Mat A,Vec xx,Vec yy)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecSet(yy,0.0);CHKERRQ(ierr);
+  ierr = MatMultTransposeAdd_SeqAIJMixed(A,xx,yy,yy);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   The sweeps of MatSOR_SeqAIJ() with the off-diagonal values in single precision; the inverted diagonal is kept in
+   full precision. Eisenstat's trick, SOR_APPLY_UPPER and the multicolor sweeps are passed on to MatSOR_SeqAIJ().
+*/
+PetscErrorCode MatSOR_SeqAIJMixed(Mat A,Vec bb,PetscReal omega,MatSORType flag,PetscReal fshift,PetscInt its,PetscInt lits,Vec xx)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJMixed   *aijmixed = (Mat_SeqAIJMixed*)A->spptr;
+  PetscScalar       *x,sum,*t;
+  const MatScalar   *idiag;
+  const float       *af;
+  const PetscScalar *b,*xb;
+  PetscErrorCode    ierr;
+  PetscInt          m = A->rmap->n,i;
+  const PetscInt    *ai = a->i,*aj = a->j,*diag;
+
+  PetscFunctionBegin;
+  if (flag == SOR_APPLY_UPPER || flag == SOR_APPLY_LOWER || (flag & SOR_EISENSTAT) || (flag & SOR_MULTICOLOR)) {
+    ierr = MatSOR_SeqAIJ(A,bb,omega,flag,fshift,its,lits,xx);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  its = its*lits;
+
+  if (fshift != a->fshift || omega != a->omega) a->idiagvalid = PETSC_FALSE; /* must recompute idiag[] */
+  if (!a->idiagvalid) {ierr = MatInvertDiagonal_SeqAIJ(A,omega,fshift);CHKERRQ(ierr);}
+  a->fshift = fshift;
+  a->omega  = omega;
+  ierr = MatSeqAIJMixedUpdate_Private(A);CHKERRQ(ierr);
+
+  af    = aijmixed->af;
+  diag  = a->diag;
+  t     = a->ssor_work;
+  idiag = a->idiag;
+
+  ierr = VecGetArray(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(bb,&b);CHKERRQ(ierr);
+  /* We count flops by assuming the upper triangular and lower triangular parts have the same number of nonzeros */
+  if (flag & SOR_ZERO_INITIAL_GUESS) {
+    if (flag & SOR_FORWARD_SWEEP || flag & SOR_LOCAL_FORWARD_SWEEP) {
+      for (i=0; i<m; i++) {
+        sum = 0.0;
+        MatSeqAIJMixedRowDot_Private(&sum,x,af+ai[i],aj+ai[i],diag[i]-ai[i]);
+        t[i] = b[i] - sum;
+        x[i] = t[i]*idiag[i];
+      }
+      xb   = t;
+      ierr = PetscLogFlops(a->nz);CHKERRQ(ierr);
+    } else xb = b;
+    if (flag & SOR_BACKWARD_SWEEP || flag & SOR_LOCAL_BACKWARD_SWEEP) {
+      for (i=m-1; i>=0; i--) {
+        sum = 0.0;
+        MatSeqAIJMixedRowDot_Private(&sum,x,af+diag[i]+1,aj+diag[i]+1,ai[i+1]-diag[i]-1);
+        if (xb == b) x[i] = (xb[i] - sum)*idiag[i];
+        else x[i] = (1-omega)*x[i] + (xb[i] - sum)*idiag[i]; /* omega in idiag */
+      }
+      ierr = PetscLogFlops(a->nz);CHKERRQ(ierr); /* assumes 1/2 in upper */
+    }
+    its--;
+  }
+  while (its--) {
+    if (flag & SOR_FORWARD_SWEEP || flag & SOR_LOCAL_FORWARD_SWEEP) {
+      for (i=0; i<m; i++) {
+        /* lower, saved for the backward sweep */
+        sum = 0.0;
+        MatSeqAIJMixedRowDot_Private(&sum,x,af+ai[i],aj+ai[i],diag[i]-ai[i]);
+        t[i] = b[i] - sum;
+        /* upper */
+        sum = 0.0;
+        MatSeqAIJMixedRowDot_Private(&sum,x,af+diag[i]+1,aj+diag[i]+1,ai[i+1]-diag[i]-1);
+        x[i] = (1. - omega)*x[i] + (t[i] - sum)*idiag[i]; /* omega in idiag */
+      }
+      xb   = t;
+      ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
+    } else xb = b;
+    if (flag & SOR_BACKWARD_SWEEP || flag & SOR_LOCAL_BACKWARD_SWEEP) {
+      for (i=m-1; i>=0; i--) {
+        sum = 0.0;
+        if (xb == b) {
+          /* whole matrix (no checkpointing available), without the diagonal so that it is only used in full precision through idiag[] */
+          MatSeqAIJMixedRowDot_Private(&sum,x,af+ai[i],aj+ai[i],diag[i]-ai[i]);
+          MatSeqAIJMixedRowDot_Private(&sum,x,af+diag[i]+1,aj+diag[i]+1,ai[i+1]-diag[i]-1);
+          x[i] = (1. - omega)*x[i] + (xb[i] - sum)*idiag[i]; /* omega in idiag */
+        } else { /* lower-triangular part has been saved, so only apply upper-triangular */
+          MatSeqAIJMixedRowDot_Private(&sum,x,af+diag[i]+1,aj+diag[i]+1,ai[i+1]-diag[i]-1);
+          x[i] = (1. - omega)*x[i] + (xb[i] - sum)*idiag[i]; /* omega in idiag */
+        }
+      }
+      if (xb == b) {
+        ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
+      } else {
+        ierr = PetscLogFlops(a->nz);CHKERRQ(ierr); /* assumes 1/2 in upper */
+      }
+    }
+  }
+  ierr = VecRestoreArray(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(bb,&b);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* MatConvert_SeqAIJ_SeqAIJMixed converts a SeqAIJ matrix into a
+ * SeqAIJMixed matrix.  This routine is called by the MatCreate_SeqAIJMixed()
+ * routine, but can also be used to convert an assembled SeqAIJ matrix
+ * into a SeqAIJMixed one. */
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJMixed(Mat A,MatType type,MatReuse reuse,Mat *newmat)
+{
+  PetscErrorCode  ierr;
+  Mat             B = *newmat;
+  Mat_SeqAIJ      *b;
+  Mat_SeqAIJMixed *aijmixed;
+  PetscBool       sametype;
+
+  PetscFunctionBegin;
+#if defined(PETSC_USE_COMPLEX)
+  SETERRQ(PetscObjectComm((PetscObject)A),PETSC_ERR_SUP,"MATSEQAIJMIXED is not available for complex numbers");
+#endif
+  if (reuse == MAT_INITIAL_MATRIX) {
+    ierr = MatDuplicate(A,MAT_COPY_VALUES,&B);CHKERRQ(ierr);
+  }
+  ierr = PetscObjectTypeCompare((PetscObject)A,type,&sametype);CHKERRQ(ierr);
+  if (sametype) PetscFunctionReturn(0);
+
+  ierr     = PetscNewLog(B,&aijmixed);CHKERRQ(ierr);
+  b        = (Mat_SeqAIJ*)B->data;
+  B->spptr = (void*)aijmixed;
+
+  /* Disable use of the inode routines so that the AIJMIXED ones will be used instead.
+   * This happens in MatAssemblyEnd_SeqAIJMixed as well, but the assembly end may not be called, so set it here, too. */
+  b->inode.use = PETSC_FALSE;
+
+  /* Set function pointers for methods that we inherit from AIJ but override.
+   * MatDuplicate_SeqAIJ() creates the duplicate with the type of B, so it needs no override. */
+  B->ops->assemblyend      = MatAssemblyEnd_SeqAIJMixed;
+  B->ops->destroy          = MatDestroy_SeqAIJMixed;
+  B->ops->mult             = MatMult_SeqAIJMixed;
+  B->ops->multtranspose    = MatMultTranspose_SeqAIJMixed;
+  B->ops->multadd          = MatMultAdd_SeqAIJMixed;
+  B->ops->multtransposeadd = MatMultTransposeAdd_SeqAIJMixed;
+  B->ops->sor              = MatSOR_SeqAIJMixed;
+  B->ops->diagonalscale    = MatDiagonalScale_SeqAIJMixed;
+
+  aijmixed->state = -1; /* this will trigger the computation of the single precision values the first time they are used */
+
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaijmixed_seqaij_C",MatConvert_SeqAIJMixed_SeqAIJ);CHKERRQ(ierr);
+
+  ierr    = PetscObjectChangeTypeName((PetscObject)B,MATSEQAIJMIXED);CHKERRQ(ierr);
+  *newmat = B;
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   MatCreateSeqAIJMixed - Creates a sparse matrix of type SEQAIJMIXED.
+   This type inherits from AIJ and uses the same storage, but also keeps a single precision
+   copy of the matrix values that MatMult(), MatMultAdd(), MatMultTranspose(), MatMultTransposeAdd()
+   and MatSOR() use with vectors in full precision. Because SEQAIJMIXED is a subtype of SEQAIJ,
+   the option "-mat_seqaij_type seqaijmixed" can be used to make sequential AIJ matrices (including
+   the diagonal and off-diagonal blocks of MPIAIJ matrices) default to being instances of MATSEQAIJMIXED.
+
+   Collective
+
+   Input Parameters:
++  comm - MPI communicator, set to PETSC_COMM_SELF
+.  m - number of rows
+.  n - number of columns
+.  nz - number of nonzeros per row (same for all rows)
+-  nnz - array containing the number of nonzeros in the various rows
+         (possibly different for each row) or NULL
+
+   Output Parameter:
+.  A - the matrix
+
+   Notes:
+   If nnz is given then nz is ignored
+
+   The single precision values are recomputed from the full precision ones when the matrix has changed,
+   all other operations, for example the factorizations and the matrix-matrix products, use the full precision values.
+   The single precision copy takes 4 bytes per nonzero on top of the storage of MATSEQAIJ, and the factors computed from
+   the matrix, for example by PCILU, are in full precision and no faster than those of MATSEQAIJ.
+
+   Level: intermediate
+
+.seealso: MatCreate(), MatCreateMPIAIJMixed(), MatSetValues()
+@*/
+PetscErrorCode  MatCreateSeqAIJMixed(MPI_Comm comm,PetscInt m,PetscInt n,PetscInt nz,const PetscInt nnz[],Mat *A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatCreate(comm,A);CHKERRQ(ierr);
+  ierr = MatSetSizes(*A,m,n,m,n);CHKERRQ(ierr);
+  ierr = MatSetType(*A,MATSEQAIJMIXED);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation_SeqAIJ(*A,nz,nnz);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJMixed(Mat A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSetType(A,MATSEQAIJ);CHKERRQ(ierr);
+  ierr = MatConvert_SeqAIJ_SeqAIJMixed(A,MATSEQAIJMIXED,MAT_INPLACE_MATRIX,&A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
@@ -0,0 +1,539 @@
+/*
+  Defines basic operations for the MATSEQAIJOMP matrix class.
+  This class is derived from the MATSEQAIJ class and retains the
+  compressed row storage (aka Yale sparse matrix format) unchanged, but
+  partitions the rows among threads so that each thread receives (roughly)
+  the same number of nonzeros, and uses explicit SIMD kernels for the
+  inner sparse dot products when the compiler provides them.
+*/
+
+#include <../src/mat/impls/aij/seq/aij.h>
+#if defined(PETSC_HAVE_OPENMP)
+#include <omp.h>
+#endif
+
+#if defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX2__) && defined(__FMA__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_REAL_MAT_SINGLE) && !defined(PETSC_SKIP_IMMINTRIN_H_CUDAWORKAROUND)
+#define PETSC_AIJOMP_USE_AVX2
+#include <immintrin.h>
+#endif
+
+typedef struct {
+  PetscObjectState nonzerostate; /* nonzero state for which the row partitions were computed */
+  PetscInt         nthreads;     /* number of threads used by the kernels */
+  PetscInt         *rstart;      /* rows [rstart[t],rstart[t+1]) are processed by thread t */
+  PetscInt         *cprstart;    /* same as rstart[] but for the compressed row format */
+  PetscInt         nwork;        /* length of work[] */
+  PetscScalar      *work;        /* per-thread accumulators for MatMultTranspose */
+} Mat_SeqAIJOMP;
+
+/*
+   The inner kernel sum += \sum_j aa[j]*x[aj[j]]. With AVX2 and FMA available the real and complex double
+   cases are vectorized explicitly, otherwise we fall back to PetscSparseDensePlusDot().
+*/
+#if defined(PETSC_AIJOMP_USE_AVX2) && !defined(PETSC_USE_COMPLEX)
+PETSC_STATIC_INLINE void MatSeqAIJOMPRowDot_Private(PetscScalar *sum,const PetscScalar *x,const MatScalar *aa,const PetscInt *aj,PetscInt n)
+{
+  __m256d     vec_x,vec_y,vec_vals;
+  __m128d     vec_s;
+#if defined(PETSC_USE_64BIT_INDICES)
+  __m256i     vec_idx;
+#else
+  __m128i     vec_idx;
+#endif
+  PetscInt    j;
+  PetscScalar s;
+
+  vec_y = _mm256_setzero_pd();
+  for (j=0; j<n-3; j+=4) {
+#if defined(PETSC_USE_64BIT_INDICES)
+    vec_idx  = _mm256_loadu_si256((__m256i const*)(aj+j));
+    vec_x    = _mm256_i64gather_pd(x,vec_idx,8);
+#else
+    vec_idx  = _mm_loadu_si128((__m128i const*)(aj+j));
+    vec_x    = _mm256_i32gather_pd(x,vec_idx,8);
+#endif
+    vec_vals = _mm256_loadu_pd(aa+j);
+    vec_y    = _mm256_fmadd_pd(vec_x,vec_vals,vec_y);
+  }
+  vec_s = _mm_add_pd(_mm256_castpd256_pd128(vec_y),_mm256_extractf128_pd(vec_y,1));
+  vec_s = _mm_hadd_pd(vec_s,vec_s);
+  s     = _mm_cvtsd_f64(vec_s);
+  for (; j<n; j++) s += aa[j]*x[aj[j]];
+  *sum += s;
+}
+#elif defined(PETSC_AIJOMP_USE_AVX2) && defined(PETSC_USE_COMPLEX)
+PETSC_STATIC_INLINE void MatSeqAIJOMPRowDot_Private(PetscScalar *sum,const PetscScalar *x,const MatScalar *aa,const PetscInt *aj,PetscInt n)
+{
+  __m256d     vec_x,vec_vals,vec_rr,vec_ri;
+  __m128d     vec_re,vec_im;
+  PetscInt    j;
+  PetscReal   re,im;
+  PetscScalar s = 0.0;
+
+  /* two complex numbers per register; vec_rr accumulates (ar*xr,ai*xi) and vec_ri accumulates (ar*xi,ai*xr) */
+  vec_rr = _mm256_setzero_pd();
+  vec_ri = _mm256_setzero_pd();
+  for (j=0; j<n-1; j+=2) {
+    vec_x    = _mm256_insertf128_pd(_mm256_castpd128_pd256(_mm_loadu_pd((const double*)(x+aj[j]))),_mm_loadu_pd((const double*)(x+aj[j+1])),1);
+    vec_vals = _mm256_loadu_pd((const double*)(aa+j));
+    vec_rr   = _mm256_fmadd_pd(vec_vals,vec_x,vec_rr);
+    vec_ri   = _mm256_fmadd_pd(vec_vals,_mm256_permute_pd(vec_x,0x5),vec_ri);
+  }
+  vec_re = _mm_add_pd(_mm256_castpd256_pd128(vec_rr),_mm256_extractf128_pd(vec_rr,1));
+  vec_im = _mm_add_pd(_mm256_castpd256_pd128(vec_ri),_mm256_extractf128_pd(vec_ri,1));
+  re     = _mm_cvtsd_f64(_mm_hsub_pd(vec_re,vec_re));
+  im     = _mm_cvtsd_f64(_mm_hadd_pd(vec_im,vec_im));
+  s      = PetscCMPLX(re,im);
+  for (; j<n; j++) s += aa[j]*x[aj[j]];
+  *sum += s;
+}
+#else
+PETSC_STATIC_INLINE void MatSeqAIJOMPRowDot_Private(PetscScalar *sum,const PetscScalar *x,const MatScalar *aa,const PetscInt *aj,PetscInt n)
+{
+  PetscScalar s = 0.0;
+
+  PetscSparseDensePlusDot(s,x,aa,aj,n);
+  *sum += s;
+}
+#endif
+
+/*
+   Splits the m rows described by the offsets ii[] into nt contiguous chunks of approximately equal work, where
+   the work of row i is taken to be its number of nonzeros plus one (so that empty rows are not free).
+*/
+static PetscErrorCode MatSeqAIJOMPPartitionRows_Private(PetscInt m,const PetscInt *ii,PetscInt nt,PetscInt *rstart)
+{
+  PetscInt  t,lo,hi,mid;
+  PetscReal work = (PetscReal)(ii[m] - ii[0] + m),target;
+
+  PetscFunctionBegin;
+  rstart[0]  = 0;
+  rstart[nt] = m;
+  for (t=1; t<nt; t++) {
+    /* find the first row i such that ii[i]-ii[0]+i >= t*work/nt */
+    target = t*work/nt;
+    lo     = rstart[t-1];
+    hi     = m;
+    while (lo < hi) {
+      mid = lo + (hi - lo)/2;
+      if ((PetscReal)(ii[mid] - ii[0] + mid) < target) lo = mid + 1;
+      else hi = mid;
+    }
+    rstart[t] = lo;
+  }
+  PetscFunctionReturn(0);
+}
+
+PETSC_INTERN PetscErrorCode MatSeqAIJOMP_create_partition(Mat A)
+{
+  PetscErrorCode ierr;
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJOMP  *aijomp = (Mat_SeqAIJOMP*)A->spptr;
+
+  PetscFunctionBegin;
+  if (aijomp->nonzerostate == A->nonzerostate && aijomp->rstart) PetscFunctionReturn(0); /* partition exists and matches current nonzero structure */
+  aijomp->nonzerostate = A->nonzerostate;
+  if (!aijomp->rstart) {
+    ierr = PetscMalloc2(aijomp->nthreads+1,&aijomp->rstart,aijomp->nthreads+1,&aijomp->cprstart);CHKERRQ(ierr);
+  }
+  ierr = MatSeqAIJOMPPartitionRows_Private(A->rmap->n,a->i,aijomp->nthreads,aijomp->rstart);CHKERRQ(ierr);
+  if (a->compressedrow.use) {
+    ierr = MatSeqAIJOMPPartitionRows_Private(a->compressedrow.nrows,a->compressedrow.i,aijomp->nthreads,aijomp->cprstart);CHKERRQ(ierr);
+  }
+  ierr = PetscInfo2(A,"Partitioned %D rows among %D threads\n",A->rmap->n,aijomp->nthreads);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJOMP_SeqAIJ(Mat A,MatType type,MatReuse reuse,Mat *newmat)
+{
+  /* This routine is only called to convert a MATAIJOMP to its base PETSc type, */
+  /* so we will ignore 'MatType type'. */
+  PetscErrorCode ierr;
+  Mat            B       = *newmat;
+  Mat_SeqAIJOMP  *aijomp = (Mat_SeqAIJOMP*)A->spptr;
+
+  PetscFunctionBegin;
+  if (reuse == MAT_INITIAL_MATRIX) {
+    ierr   = MatDuplicate(A,MAT_COPY_VALUES,&B);CHKERRQ(ierr);
+    aijomp = (Mat_SeqAIJOMP*)B->spptr;
+  }
+
+  /* Reset the original function pointers. */
+  B->ops->duplicate        = MatDuplicate_SeqAIJ;
+  B->ops->assemblyend      = MatAssemblyEnd_SeqAIJ;
+  B->ops->destroy          = MatDestroy_SeqAIJ;
+  B->ops->mult             = MatMult_SeqAIJ;
+  B->ops->multtranspose    = MatMultTranspose_SeqAIJ;
+  B->ops->multadd          = MatMultAdd_SeqAIJ;
+  B->ops->multtransposeadd = MatMultTransposeAdd_SeqAIJ;
+
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaijomp_seqaij_C",NULL);CHKERRQ(ierr);
+
+  /* Free everything in the Mat_SeqAIJOMP data structure. */
+  ierr = PetscFree2(aijomp->rstart,aijomp->cprstart);CHKERRQ(ierr);
+  ierr = PetscFree(aijomp->work);CHKERRQ(ierr);
+  ierr = PetscFree(B->spptr);CHKERRQ(ierr);
+
+  /* Change the type of B to MATSEQAIJ. */
+  ierr = PetscObjectChangeTypeName((PetscObject)B,MATSEQAIJ);CHKERRQ(ierr);
+
+  *newmat = B;
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatDestroy_SeqAIJOMP(Mat A)
+{
+  PetscErrorCode ierr;
+  Mat_SeqAIJOMP  *aijomp = (Mat_SeqAIJOMP*)A->spptr;
+
+  PetscFunctionBegin;
+  if (aijomp) {
+    /* If MatHeaderMerge() was used then this SeqAIJOMP matrix will not have a spptr. */
+    ierr = PetscFree2(aijomp->rstart,aijomp->cprstart);CHKERRQ(ierr);
+    ierr = PetscFree(aijomp->work);CHKERRQ(ierr);
+    ierr = PetscFree(A->spptr);CHKERRQ(ierr);
+  }
+  /* Change the type of A back to SEQAIJ and use MatDestroy_SeqAIJ() to destroy everything that remains. */
+  ierr = PetscObjectChangeTypeName((PetscObject)A,MATSEQAIJ);CHKERRQ(ierr);
+  ierr = MatDestroy_SeqAIJ(A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatDuplicate_SeqAIJOMP(Mat A,MatDuplicateOption op,Mat *M)
+{
+  PetscErrorCode ierr;
+  Mat_SeqAIJOMP  *aijomp = (Mat_SeqAIJOMP*)A->spptr;
+  Mat_SeqAIJOMP  *aijomp_dest;
+
+  PetscFunctionBegin;
+  ierr        = MatDuplicate_SeqAIJ(A,op,M);CHKERRQ(ierr);
+  aijomp_dest = (Mat_SeqAIJOMP*)(*M)->spptr;
+  ierr        = PetscFree2(aijomp_dest->rstart,aijomp_dest->cprstart);CHKERRQ(ierr);
+  ierr        = PetscFree(aijomp_dest->work);CHKERRQ(ierr);
+  aijomp_dest->nthreads     = aijomp->nthreads;
+  aijomp_dest->nwork        = 0;
+  aijomp_dest->nonzerostate = -1;
+  /* The partition is not copied, it is cheap to recompute and the duplicate may be assembled differently */
+  if ((*M)->assembled) {
+    ierr = MatSeqAIJOMP_create_partition(*M);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatAssemblyEnd_SeqAIJOMP(Mat A,MatAssemblyType mode)
+{
+  PetscErrorCode ierr;
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJOMP  *aijomp = (Mat_SeqAIJOMP*)A->spptr;
+
+  PetscFunctionBegin;
+  if (mode == MAT_FLUSH_ASSEMBLY) PetscFunctionReturn(0);
+
+  /* Disable the inode routines since they would replace the threaded MatMult() */
+  a->inode.use = PETSC_FALSE;
+  ierr         = MatAssemblyEnd_SeqAIJ(A,mode);CHKERRQ(ierr);
+
+  /* The compressed row information may have changed, so always recompute the partition */
+  aijomp->nonzerostate = -1;
+  ierr = MatSeqAIJOMP_create_partition(A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMult_SeqAIJOMP(Mat A,Vec xx,Vec yy)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJOMP     *aijomp = (Mat_SeqAIJOMP*)A->spptr;
+  PetscScalar       *y;
+  const PetscScalar *x;
+  const MatScalar   *aa = a->a;
+  const PetscInt    *aj = a->j,*ii,*ridx=NULL,*rstart;
+  PetscInt          m = A->rmap->n,nt = aijomp->nthreads,t;
+  PetscBool         usecprow = a->compressedrow.use;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJOMP_create_partition(A);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArray(yy,&y);CHKERRQ(ierr);
+  if (usecprow) { /* use compressed row format */
+    ierr   = PetscArrayzero(y,m);CHKERRQ(ierr);
+    ii     = a->compressedrow.i;
+    ridx   = a->compressedrow.rindex;
+    rstart = aijomp->cprstart;
+  } else {
+    ii     = a->i;
+    rstart = aijomp->rstart;
+  }
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel for num_threads(nt) schedule(static,1)
+#endif
+  for (t=0; t<nt; t++) {
+    PetscInt    i;
+    PetscScalar sum;
+
+    for (i=rstart[t]; i<rstart[t+1]; i++) {
+      sum = 0.0;
+      MatSeqAIJOMPRowDot_Private(&sum,x,aa+ii[i],aj+ii[i],ii[i+1]-ii[i]);
+      if (usecprow) y[ridx[i]] = sum;
+      else y[i] = sum;
+    }
+  }
+  ierr = PetscLogFlops(2.0*a->nz - a->nonzerorowcnt);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArray(yy,&y);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMultAdd_SeqAIJOMP(Mat A,Vec xx,Vec yy,Vec zz)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJOMP     *aijomp = (Mat_SeqAIJOMP*)A->spptr;
+  PetscScalar       *y,*z;
+  const PetscScalar *x;
+  const MatScalar   *aa = a->a;
+  const PetscInt    *aj = a->j,*ii,*ridx=NULL,*rstart;
+  PetscInt          m = A->rmap->n,nt = aijomp->nthreads,t;
+  PetscBool         usecprow = a->compressedrow.use;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJOMP_create_partition(A);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArrayPair(yy,zz,&y,&z);CHKERRQ(ierr);
+  if (usecprow) { /* use compressed row format */
+    if (zz != yy) {
+      ierr = PetscArraycpy(z,y,m);CHKERRQ(ierr);
+    }
+    ii     = a->compressedrow.i;
+    ridx   = a->compressedrow.rindex;
+    rstart = aijomp->cprstart;
+  } else {
+    ii     = a->i;
+    rstart = aijomp->rstart;
+  }
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel for num_threads(nt) schedule(static,1)
+#endif
+  for (t=0; t<nt; t++) {
+    PetscInt    i,r;
+    PetscScalar sum;
+
+    for (i=rstart[t]; i<rstart[t+1]; i++) {
+      r   = usecprow ? ridx[i] : i;
+      sum = y[r];
+      MatSeqAIJOMPRowDot_Private(&sum,x,aa+ii[i],aj+ii[i],ii[i+1]-ii[i]);
+      z[r] = sum;
+    }
+  }
+  ierr = PetscLogFlops(2.0*a->nz);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArrayPair(yy,zz,&y,&z);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Each chunk of rows scatters its contributions into its own accumulator (the first chunk uses y directly),
+   the accumulators are then summed into y with the columns split evenly among the chunks.
+*/
+PetscErrorCode MatMultTransposeAdd_SeqAIJOMP(Mat A,Vec xx,Vec zz,Vec yy)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJOMP     *aijomp = (Mat_SeqAIJOMP*)A->spptr;
+  PetscScalar       *y,*work;
+  const PetscScalar *x;
+  const MatScalar   *aa = a->a;
+  const PetscInt    *aj = a->j,*ii,*ridx=NULL,*rstart;
+  PetscInt          n = A->cmap->n,nt = aijomp->nthreads;
+  PetscBool         usecprow = a->compressedrow.use;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJOMP_create_partition(A);CHKERRQ(ierr);
+  if (nt > 1 && aijomp->nwork < (nt-1)*n) {
+    ierr = PetscFree(aijomp->work);CHKERRQ(ierr);
+    aijomp->nwork = (nt-1)*n;
+    ierr = PetscMalloc1(aijomp->nwork,&aijomp->work);CHKERRQ(ierr);
+  }
+  work = aijomp->work;
+  if (zz != yy) {ierr = VecCopy(zz,yy);CHKERRQ(ierr);}
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArray(yy,&y);CHKERRQ(ierr);
+  if (usecprow) {
+    ii     = a->compressedrow.i;
+    ridx   = a->compressedrow.rindex;
+    rstart = aijomp->cprstart;
+  } else {
+    ii     = a->i;
+    rstart = aijomp->rstart;
+  }
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel num_threads(nt)
+#endif
+  {
+    PetscInt    i,j,c,cs,ce,s,t;
+    PetscScalar alpha,*yt;
+
+    /* worksharing loops over the chunks, so that all of them are done even if the team has fewer than nt threads */
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp for schedule(static,1)
+#endif
+    for (t=0; t<nt; t++) {
+      if (t) {
+        yt = work + (t-1)*n;
+        for (c=0; c<n; c++) yt[c] = 0.0;
+      } else yt = y;
+      for (i=rstart[t]; i<rstart[t+1]; i++) {
+        alpha = usecprow ? x[ridx[i]] : x[i];
+        for (j=ii[i]; j<ii[i+1]; j++) yt[aj[j]] += alpha*aa[j];
+      }
+    }
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp for schedule(static,1)
+#endif
+    for (t=0; t<nt; t++) {
+      cs = (t*n)/nt;
+      ce = ((t+1)*n)/nt;
+      for (s=1; s<nt; s++) {
+        yt = work + (s-1)*n;
+        for (c=cs; c<ce; c++) y[c] += yt[c];
+      }
+    }
+  }
+  ierr = PetscLogFlops(2.0*a->nz + (nt-1)*n);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArray(yy,&y);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMultTranspose_SeqAIJOMP(Mat A,Vec xx,Vec yy)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecSet(yy,0.0);CHKERRQ(ierr);
+  ierr = MatMultTransposeAdd_SeqAIJOMP(A,xx,yy,yy);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* MatConvert_SeqAIJ_SeqAIJOMP converts a SeqAIJ matrix into a
+ * SeqAIJOMP matrix.  This routine is called by the MatCreate_SeqAIJOMP()
+ * routine, but can also be used to convert an assembled SeqAIJ matrix
+ * into a SeqAIJOMP one. */
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJOMP(Mat A,MatType type,MatReuse reuse,Mat *newmat)
+{
+  PetscErrorCode ierr;
+  Mat            B = *newmat;
+  Mat_SeqAIJ     *b;
+  Mat_SeqAIJOMP  *aijomp;
+  PetscBool      sametype;
+
+  PetscFunctionBegin;
+  if (reuse == MAT_INITIAL_MATRIX) {
+    ierr = MatDuplicate(A,MAT_COPY_VALUES,&B);CHKERRQ(ierr);
+  }
+  ierr = PetscObjectTypeCompare((PetscObject)A,type,&sametype);CHKERRQ(ierr);
+  if (sametype) PetscFunctionReturn(0);
+
+  ierr     = PetscNewLog(B,&aijomp);CHKERRQ(ierr);
+  b        = (Mat_SeqAIJ*)B->data;
+  B->spptr = (void*)aijomp;
+
+  /* Disable use of the inode routines so that the AIJOMP ones will be used instead.
+   * This happens in MatAssemblyEnd_SeqAIJOMP as well, but the assembly end may not be called, so set it here, too. */
+  b->inode.use = PETSC_FALSE;
+
+  /* Set function pointers for methods that we inherit from AIJ but override. */
+  B->ops->duplicate        = MatDuplicate_SeqAIJOMP;
+  B->ops->assemblyend      = MatAssemblyEnd_SeqAIJOMP;
+  B->ops->destroy          = MatDestroy_SeqAIJOMP;
+  B->ops->mult             = MatMult_SeqAIJOMP;
+  B->ops->multtranspose    = MatMultTranspose_SeqAIJOMP;
+  B->ops->multadd          = MatMultAdd_SeqAIJOMP;
+  B->ops->multtransposeadd = MatMultTransposeAdd_SeqAIJOMP;
+
+  aijomp->nonzerostate = -1; /* this will trigger the generation of the partition the first time through MatAssembly() */
+#if defined(PETSC_HAVE_OPENMP)
+  aijomp->nthreads = (PetscInt)omp_get_max_threads();
+#else
+  aijomp->nthreads = 1;
+#endif
+  ierr = PetscOptionsBegin(PetscObjectComm((PetscObject)A),((PetscObject)A)->prefix,"AIJOMP Options","Mat");CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-mat_aijomp_threads","Number of threads used by the matrix kernels","None",aijomp->nthreads,&aijomp->nthreads,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsEnd();CHKERRQ(ierr);
+  if (aijomp->nthreads < 1) SETERRQ1(PetscObjectComm((PetscObject)A),PETSC_ERR_ARG_OUTOFRANGE,"Number of threads %D must be positive",aijomp->nthreads);
+#if !defined(PETSC_HAVE_OPENMP)
+  if (aijomp->nthreads > 1) {
+    ierr = PetscInfo1(B,"PETSc was not configured with OpenMP; using 1 thread instead of %D\n",aijomp->nthreads);CHKERRQ(ierr);
+    aijomp->nthreads = 1;
+  }
+#endif
+
+  /* If A has already been assembled, compute the partition. */
+  if (A->assembled) {
+    ierr = MatSeqAIJOMP_create_partition(B);CHKERRQ(ierr);
+  }
+
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaijomp_seqaij_C",MatConvert_SeqAIJOMP_SeqAIJ);CHKERRQ(ierr);
+
+  ierr    = PetscObjectChangeTypeName((PetscObject)B,MATSEQAIJOMP);CHKERRQ(ierr);
+  *newmat = B;
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   MatCreateSeqAIJOMP - Creates a sparse matrix of type SEQAIJOMP.
+   This type inherits from AIJ and uses the same storage, but MatMult(), MatMultAdd(),
+   MatMultTranspose() and MatMultTransposeAdd() are split among threads by
+   assigning each thread a contiguous block of rows with approximately the same
+   number of nonzeros. The per-row kernels use explicit AVX2/FMA instructions for
+   real and complex double precision when PETSc is compiled with those enabled.
+   Because SEQAIJOMP is a subtype of SEQAIJ, the option "-mat_seqaij_type seqaijomp" can be used to make
+   sequential AIJ matrices (including the diagonal and off-diagonal blocks of MPIAIJ matrices)
+   default to being instances of MATSEQAIJOMP.
+
+   Collective
+
+   Input Parameters:
++  comm - MPI communicator, set to PETSC_COMM_SELF
+.  m - number of rows
+.  n - number of columns
+.  nz - number of nonzeros per row (same for all rows)
+-  nnz - array containing the number of nonzeros in the various rows
+         (possibly different for each row) or NULL
+
+   Output Parameter:
+.  A - the matrix
+
+   Options Database Keys:
+.  -mat_aijomp_threads <n> - number of threads to use, defaults to the OpenMP maximum number of threads
+
+   Notes:
+   If nnz is given then nz is ignored
+
+   Without OpenMP support (configure --with-openmp) a single thread is used.
+
+   Level: intermediate
+
+.seealso: MatCreate(), MatCreateMPIAIJOMP(), MatSetValues()
+@*/
+PetscErrorCode  MatCreateSeqAIJOMP(MPI_Comm comm,PetscInt m,PetscInt n,PetscInt nz,const PetscInt nnz[],Mat *A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatCreate(comm,A);CHKERRQ(ierr);
+  ierr = MatSetSizes(*A,m,n,m,n);CHKERRQ(ierr);
+  ierr = MatSetType(*A,MATSEQAIJOMP);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation_SeqAIJ(*A,nz,nnz);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJOMP(Mat A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSetType(A,MATSEQAIJ);CHKERRQ(ierr);
+  ierr = MatConvert_SeqAIJ_SeqAIJOMP(A,MATSEQAIJOMP,MAT_INPLACE_MATRIX,&A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
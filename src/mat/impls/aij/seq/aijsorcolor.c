@@ -0,0 +1,178 @@
+/*
+    Multicolor SOR for SeqAIJ matrices, used by MatSOR() when the flag SOR_MULTICOLOR is set.
+
+    The rows are colored so that no two rows of the same color are coupled (a distance one coloring of the graph of
+  A + A^T, computed with MatColoring), and the rows of each color are sorted. A sweep relaxes the colors one after the
+  other; the rows of one color only use values of the other colors, so they are relaxed at the same time by the threads,
+  with one barrier per color. The forward sweep takes the colors in increasing order and the backward sweep in
+  decreasing order, so the symmetric sweep is symmetric. The iteration is Gauss-Seidel in the ordering of the colors,
+  which converges somewhat slower than in the natural ordering but does not serialize the process.
+
+    The number of threads is set with -mat_sor_threads <n> and the coloring algorithm with -mat_sor_coloring_type
+  <greedy>; both are read when the colors are computed, on the first MatSOR() after each change of the nonzero structure.
+*/
+
+#include <../src/mat/impls/aij/seq/aij.h>
+#if defined(PETSC_HAVE_OPENMP)
+#include <omp.h>
+#endif
+
+struct _n_Mat_SeqAIJSORColors {
+  PetscInt         nthreads;      /* number of threads of the sweeps */
+  PetscInt         ncolors;       /* number of colors */
+  PetscInt         *cstart;       /* the rows of color c are rows[cstart[c]],...,rows[cstart[c+1]-1] */
+  PetscInt         *rows;
+  PetscObjectState nonzerostate;  /* nonzero state of the matrix when the colors were computed */
+};
+
+PetscErrorCode MatDestroySORColors_SeqAIJ(Mat A)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ*)A->data;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!a->sorcolors) PetscFunctionReturn(0);
+  ierr = PetscFree2(a->sorcolors->cstart,a->sorcolors->rows);CHKERRQ(ierr);
+  ierr = PetscFree(a->sorcolors);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Colors the graph of A + A^T, the graph of A itself is used when its nonzero structure is known to be symmetric
+*/
+static PetscErrorCode MatSeqAIJSetUpSORColors_Private(Mat A)
+{
+  Mat_SeqAIJ            *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJSORColors   *sc = a->sorcolors;
+  Mat                   S;
+  MatColoring           mc;
+  ISColoring            iscoloring;
+  const ISColoringValue *colors;
+  char                  type[256] = MATCOLORINGGREEDY;
+  PetscInt              i,k,c,m = A->rmap->n,n,nc,nthreads = 1;
+  PetscErrorCode        ierr;
+
+  PetscFunctionBegin;
+  if (sc && sc->nonzerostate == A->nonzerostate) PetscFunctionReturn(0);
+  if (A->rmap->n != A->cmap->n) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_SIZ,"Multicolor SOR requires a square matrix, not %D by %D",A->rmap->n,A->cmap->n);
+  ierr = MatDestroySORColors_SeqAIJ(A);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(((PetscObject)A)->options,((PetscObject)A)->prefix,"-mat_sor_threads",&nthreads,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetString(((PetscObject)A)->options,((PetscObject)A)->prefix,"-mat_sor_coloring_type",type,sizeof(type),NULL);CHKERRQ(ierr);
+  if (nthreads < 1) nthreads = 1;
+#if !defined(PETSC_HAVE_OPENMP)
+  if (nthreads > 1) {
+    ierr     = PetscInfo1(A,"PETSc was not configured with OpenMP, the multicolor SOR uses 1 thread instead of %D\n",nthreads);CHKERRQ(ierr);
+    nthreads = 1;
+  }
+#endif
+
+  if ((A->symmetric_set && A->symmetric) || (A->structurally_symmetric_set && A->structurally_symmetric)) {
+    ierr = PetscObjectReference((PetscObject)A);CHKERRQ(ierr);
+    S    = A;
+  } else {
+    ierr = MatTranspose(A,MAT_INITIAL_MATRIX,&S);CHKERRQ(ierr);
+    ierr = MatAXPY(S,1.0,A,DIFFERENT_NONZERO_PATTERN);CHKERRQ(ierr);
+  }
+  ierr = MatColoringCreate(S,&mc);CHKERRQ(ierr);
+  ierr = MatColoringSetDistance(mc,1);CHKERRQ(ierr);
+  ierr = MatColoringSetType(mc,type);CHKERRQ(ierr);
+  ierr = MatColoringApply(mc,&iscoloring);CHKERRQ(ierr);
+  ierr = MatColoringDestroy(&mc);CHKERRQ(ierr);
+  ierr = MatDestroy(&S);CHKERRQ(ierr);
+  ierr = ISColoringGetColors(iscoloring,&n,&nc,&colors);CHKERRQ(ierr);
+
+  /* the rows of a color may not be coupled, whatever the coloring algorithm */
+  for (i=0; i<m; i++) {
+    for (k=a->i[i]; k<a->i[i+1]; k++) {
+      if (a->j[k] != i && colors[a->j[k]] == colors[i]) SETERRQ3(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Rows %D and %D are coupled but both have color %D",i,a->j[k],(PetscInt)colors[i]);
+    }
+  }
+
+  ierr = PetscNew(&sc);CHKERRQ(ierr);
+  ierr = PetscMalloc2(nc+1,&sc->cstart,m,&sc->rows);CHKERRQ(ierr);
+  ierr = PetscArrayzero(sc->cstart,nc+1);CHKERRQ(ierr);
+  for (i=0; i<m; i++) sc->cstart[colors[i]+1]++;
+  for (c=0; c<nc; c++) sc->cstart[c+1] += sc->cstart[c];
+  for (i=0; i<m; i++) sc->rows[sc->cstart[colors[i]]++] = i;
+  for (c=nc; c>0; c--) sc->cstart[c] = sc->cstart[c-1];
+  sc->cstart[0]    = 0;
+  sc->ncolors      = nc;
+  sc->nthreads     = nthreads;
+  sc->nonzerostate = A->nonzerostate;
+  a->sorcolors     = sc;
+  ierr = ISColoringDestroy(&iscoloring);CHKERRQ(ierr);
+  ierr = PetscLogObjectMemory((PetscObject)A,(nc+1+m)*sizeof(PetscInt));CHKERRQ(ierr);
+  ierr = PetscInfo4(A,"Multicolor SOR with %D colors (%s) for %D rows on %D threads\n",nc,type,m,nthreads);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   x[i] = (1 - omega) x[i] + omega (b[i] - sum_{j != i} A(i,j) x[j]) / (A(i,i) + fshift), color by color, with omega in idiag[]
+
+   Must be called by all the threads of a parallel region, the rows of each color are shared among the threads with an orphaned
+   worksharing loop whose implicit barrier separates the colors
+*/
+static void MatSeqAIJSORColorSweep_Private(const Mat_SeqAIJSORColors *sc,PetscBool backward,const PetscInt *ai,const PetscInt *aj,const MatScalar *aa,const PetscScalar *mdiag,const PetscScalar *idiag,PetscReal omega,const PetscScalar *b,PetscScalar *x)
+{
+  PetscInt l;
+
+  for (l=0; l<sc->ncolors; l++) {
+    const PetscInt c = backward ? sc->ncolors - 1 - l : l;
+    PetscInt       k;
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp for schedule(static)
+#endif
+    for (k=sc->cstart[c]; k<sc->cstart[c+1]; k++) {
+      const PetscInt  i = sc->rows[k],n = ai[i+1] - ai[i],*idx = aj + ai[i];
+      const MatScalar *v = aa + ai[i];
+      PetscScalar     sum = b[i];
+
+      PetscSparseDenseMinusDot(sum,x,v,idx,n);
+      x[i] = (1. - omega)*x[i] + (sum + mdiag[i]*x[i])*idiag[i];
+    }
+  }
+}
+
+PetscErrorCode MatSOR_SeqAIJ_MultiColor(Mat A,Vec bb,PetscReal omega,MatSORType flag,PetscReal fshift,PetscInt its,PetscInt lits,Vec xx)
+{
+  Mat_SeqAIJ          *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJSORColors *sc;
+  const PetscScalar   *b,*idiag,*mdiag;
+  PetscScalar         *x;
+  PetscBool           forward,backward;
+  PetscErrorCode      ierr;
+
+  PetscFunctionBegin;
+  if ((flag & SOR_EISENSTAT) || (flag & SOR_APPLY_UPPER) || (flag & SOR_APPLY_LOWER)) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Multicolor SOR only supports forward, backward and symmetric sweeps");
+  its = its*lits;
+  ierr = MatSeqAIJSetUpSORColors_Private(A);CHKERRQ(ierr);
+  sc   = a->sorcolors;
+
+  if (fshift != a->fshift || omega != a->omega) a->idiagvalid = PETSC_FALSE; /* must recompute idiag[] */
+  if (!a->idiagvalid) {ierr = MatInvertDiagonal_SeqAIJ(A,omega,fshift);CHKERRQ(ierr);}
+  a->fshift = fshift;
+  a->omega  = omega;
+  idiag     = a->idiag;
+  mdiag     = a->mdiag;
+  forward   = (PetscBool)((flag & SOR_FORWARD_SWEEP) || (flag & SOR_LOCAL_FORWARD_SWEEP));
+  backward  = (PetscBool)((flag & SOR_BACKWARD_SWEEP) || (flag & SOR_LOCAL_BACKWARD_SWEEP));
+
+  ierr = VecGetArray(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(bb,&b);CHKERRQ(ierr);
+  if (flag & SOR_ZERO_INITIAL_GUESS) {ierr = PetscArrayzero(x,A->rmap->n);CHKERRQ(ierr);}
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel num_threads(sc->nthreads) if(sc->nthreads > 1)
+#endif
+  {
+    PetscInt it;
+
+    for (it=0; it<its; it++) {
+      if (forward)  MatSeqAIJSORColorSweep_Private(sc,PETSC_FALSE,a->i,a->j,a->a,mdiag,idiag,omega,b,x);
+      if (backward) MatSeqAIJSORColorSweep_Private(sc,PETSC_TRUE,a->i,a->j,a->a,mdiag,idiag,omega,b,x);
+    }
+  }
+  ierr = PetscLogFlops(its*((forward ? 1 : 0) + (backward ? 1 : 0))*(2.0*a->nz + 4.0*A->rmap->n));CHKERRQ(ierr);
+  ierr = VecRestoreArray(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(bb,&b);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
@@ -0,0 +1,650 @@
+/*
+  Defines basic operations for the MATSEQAIJVBLOCK matrix class.
+  This class is derived from the MATSEQAIJ class and retains the
+  compressed row storage unchanged, but also stores the matrix as dense
+  blocks of variable size, whose rows and columns are the node blocks set with
+  MatSetVariableBlockSizes() or detected from the nonzero structure. The blocks
+  are a "shadow" copy of the matrix, in the same way as MATSEQAIJSELL, that is
+  used by MatMult(), MatMultAdd(), MatSOR() (block Gauss-Seidel) and
+  MatInvertVariableBlockDiagonal() (used by PCVPBJACOBI).
+*/
+
+#include <../src/mat/impls/aij/seq/aij.h>
+#include <petsc/private/kernels/blockinvert.h>
+
+typedef struct {
+  PetscInt         maxbs;                           /* largest size of the blocks detected from the nonzero structure */
+  PetscBool        useblocks;                       /* the blocks are built, PETSC_FALSE when the matrix is not square */
+  PetscInt         nb;                              /* number of block rows, and of block columns */
+  PetscInt         *bstart;                         /* first row of each block row */
+  PetscInt         *rowblock;                       /* block row of each row */
+  PetscInt         *bi,*bj,*bdiag;                  /* the blocks in compressed block rows, bdiag[] is -1 for a missing diagonal block */
+  PetscInt         *boff;                           /* offset of each block in bv */
+  MatScalar        *bv;                             /* the dense blocks, in column major order */
+  PetscInt         *ioff;                           /* offset of the inverse of each diagonal block in idiag */
+  MatScalar        *idiag;                          /* the inverses of the diagonal blocks, in column major order */
+  PetscBool        idiagvalid;
+  PetscInt         *pos;                            /* work array for the position of the blocks in a block row */
+  PetscObjectState state;                           /* state of the matrix when the values of the blocks were set */
+  PetscObjectState nonzerostate;                    /* nonzero state of the matrix when the blocks were built */
+  PetscErrorCode   (*mult)(Mat,Vec,Vec);            /* the SEQAIJ kernels, which use inodes when available */
+  PetscErrorCode   (*multadd)(Mat,Vec,Vec,Vec);
+  PetscErrorCode   (*sor)(Mat,Vec,PetscReal,MatSORType,PetscReal,PetscInt,PetscInt,Vec);
+} Mat_SeqAIJVBlock;
+
+/*
+   Groups consecutive rows with the same nonzero columns into blocks of at most maxbs rows, and sets them as the
+   variable block sizes of the matrix
+*/
+static PetscErrorCode MatSeqAIJVBlockDetectBlocks_Private(Mat A)
+{
+  Mat_SeqAIJ       *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJVBlock *vb = (Mat_SeqAIJVBlock*)A->spptr;
+  const PetscInt   *ai = a->i,*aj = a->j;
+  PetscInt         i,k,m = A->rmap->n,len,nblocks = 0,*bsizes,bsmin = PETSC_MAX_INT,bsmax = 0;
+  PetscBool        same;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscMalloc1(m,&bsizes);CHKERRQ(ierr);
+  for (i=0; i<m; i+=bsizes[nblocks++]) {
+    len = ai[i+1] - ai[i];
+    k   = 1;
+    /* empty rows are not grouped, their blocks would be singular */
+    while (len && i+k < m && k < vb->maxbs && ai[i+k+1] - ai[i+k] == len) {
+      ierr = PetscArraycmp(aj+ai[i],aj+ai[i+k],len,&same);CHKERRQ(ierr);
+      if (!same) break;
+      k++;
+    }
+    bsizes[nblocks] = k;
+    bsmin           = PetscMin(bsmin,k);
+    bsmax           = PetscMax(bsmax,k);
+  }
+  ierr = MatSetVariableBlockSizes(A,nblocks,bsizes);CHKERRQ(ierr);
+  ierr = PetscFree(bsizes);CHKERRQ(ierr);
+  ierr = PetscInfo3(A,"Detected %D blocks of sizes %D to %D from the nonzero structure\n",nblocks,m ? bsmin : 0,bsmax);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSeqAIJVBlockDestroyBlocks_Private(Mat A)
+{
+  Mat_SeqAIJVBlock *vb = (Mat_SeqAIJVBlock*)A->spptr;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree3(vb->bstart,vb->ioff,vb->pos);CHKERRQ(ierr);
+  ierr = PetscFree(vb->rowblock);CHKERRQ(ierr);
+  ierr = PetscFree3(vb->bi,vb->bdiag,vb->bj);CHKERRQ(ierr);
+  ierr = PetscFree2(vb->boff,vb->idiag);CHKERRQ(ierr);
+  ierr = PetscFree(vb->bv);CHKERRQ(ierr);
+  vb->nb         = 0;
+  vb->useblocks  = PETSC_FALSE;
+  vb->idiagvalid = PETSC_FALSE;
+  PetscFunctionReturn(0);
+}
+
+/*
+   Builds the block structure from the variable block sizes of the matrix: block (I,J) is stored when any of its entries
+   is a nonzero of the AIJ storage
+*/
+static PetscErrorCode MatSeqAIJVBlockBuildBlocks_Private(Mat A)
+{
+  Mat_SeqAIJ       *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJVBlock *vb = (Mat_SeqAIJVBlock*)A->spptr;
+  const PetscInt   *ai = a->i,*aj = a->j,*bsizes;
+  PetscInt         i,k,ib,jb,m = A->rmap->n,nb,nbnz,nbv = 0,*mark;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJVBlockDestroyBlocks_Private(A);CHKERRQ(ierr);
+  if (A->rmap->n != A->cmap->n) PetscFunctionReturn(0);
+  if (!A->nblocks && m) {ierr = MatSeqAIJVBlockDetectBlocks_Private(A);CHKERRQ(ierr);}
+  ierr = MatGetVariableBlockSizes(A,&nb,&bsizes);CHKERRQ(ierr);
+
+  vb->nb = nb;
+  ierr   = PetscMalloc3(nb+1,&vb->bstart,nb+1,&vb->ioff,nb,&vb->pos);CHKERRQ(ierr);
+  ierr   = PetscMalloc1(m,&vb->rowblock);CHKERRQ(ierr);
+  vb->bstart[0] = 0;
+  vb->ioff[0]   = 0;
+  for (ib=0; ib<nb; ib++) {
+    vb->bstart[ib+1] = vb->bstart[ib] + bsizes[ib];
+    vb->ioff[ib+1]   = vb->ioff[ib] + bsizes[ib]*bsizes[ib];
+    for (i=vb->bstart[ib]; i<vb->bstart[ib+1]; i++) vb->rowblock[i] = ib;
+  }
+
+  /* count the blocks of each block row, marking the block columns already found in it */
+  mark = vb->pos;
+  for (jb=0; jb<nb; jb++) mark[jb] = -1;
+  nbnz = 0;
+  for (ib=0; ib<nb; ib++) {
+    for (i=vb->bstart[ib]; i<vb->bstart[ib+1]; i++) {
+      for (k=ai[i]; k<ai[i+1]; k++) {
+        jb = vb->rowblock[aj[k]];
+        if (mark[jb] != ib) {mark[jb] = ib; nbnz++;}
+      }
+    }
+  }
+  ierr = PetscMalloc3(nb+1,&vb->bi,nb,&vb->bdiag,nbnz,&vb->bj);CHKERRQ(ierr);
+  for (jb=0; jb<nb; jb++) mark[jb] = -1;
+  vb->bi[0] = 0;
+  for (ib=0; ib<nb; ib++) {
+    vb->bi[ib+1] = vb->bi[ib];
+    for (i=vb->bstart[ib]; i<vb->bstart[ib+1]; i++) {
+      for (k=ai[i]; k<ai[i+1]; k++) {
+        jb = vb->rowblock[aj[k]];
+        if (mark[jb] != ib) {mark[jb] = ib; vb->bj[vb->bi[ib+1]++] = jb;}
+      }
+    }
+    ierr = PetscSortInt(vb->bi[ib+1]-vb->bi[ib],vb->bj+vb->bi[ib]);CHKERRQ(ierr);
+    vb->bdiag[ib] = -1;
+    for (k=vb->bi[ib]; k<vb->bi[ib+1]; k++) if (vb->bj[k] == ib) vb->bdiag[ib] = k;
+  }
+  ierr = PetscMalloc2(nbnz+1,&vb->boff,vb->ioff[nb],&vb->idiag);CHKERRQ(ierr);
+  vb->boff[0] = 0;
+  for (ib=0; ib<nb; ib++) {
+    for (k=vb->bi[ib]; k<vb->bi[ib+1]; k++) {
+      vb->boff[k+1] = vb->boff[k] + bsizes[ib]*bsizes[vb->bj[k]];
+    }
+  }
+  nbv  = vb->boff[nbnz];
+  ierr = PetscMalloc1(nbv,&vb->bv);CHKERRQ(ierr);
+  ierr = PetscLogObjectMemory((PetscObject)A,(nbv+vb->ioff[nb])*sizeof(MatScalar)+(4*nb+m+2*nbnz)*sizeof(PetscInt));CHKERRQ(ierr);
+  ierr = PetscInfo4(A,"%D block rows with %D blocks, %D stored values for %D nonzeros\n",nb,nbnz,nbv,a->nz);CHKERRQ(ierr);
+  vb->useblocks = PETSC_TRUE;
+  PetscFunctionReturn(0);
+}
+
+/* Copies the values of the AIJ storage into the blocks, the entries of the blocks that are not nonzeros are zero */
+static PetscErrorCode MatSeqAIJVBlockSetValues_Private(Mat A)
+{
+  Mat_SeqAIJ       *a = (Mat_SeqAIJ*)A->data;
+  Mat_SeqAIJVBlock *vb = (Mat_SeqAIJVBlock*)A->spptr;
+  const PetscInt   *ai = a->i,*aj = a->j,*bstart = vb->bstart,*rowblock = vb->rowblock;
+  const MatScalar  *aa = a->a;
+  PetscInt         i,k,ib,jb,bs,*pos = vb->pos;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscArrayzero(vb->bv,vb->boff[vb->bi[vb->nb]]);CHKERRQ(ierr);
+  for (ib=0; ib<vb->nb; ib++) {
+    bs = bstart[ib+1] - bstart[ib];
+    for (k=vb->bi[ib]; k<vb->bi[ib+1]; k++) pos[vb->bj[k]] = k;
+    for (i=bstart[ib]; i<bstart[ib+1]; i++) {
+      for (k=ai[i]; k<ai[i+1]; k++) {
+        jb = rowblock[aj[k]];
+        vb->bv[vb->boff[pos[jb]] + (i - bstart[ib]) + (aj[k] - bstart[jb])*bs] = aa[k];
+      }
+    }
+  }
+  vb->idiagvalid = PETSC_FALSE;
+  PetscFunctionReturn(0);
+}
+
+/* Builds the blocks when the nonzero structure or the block sizes have changed, otherwise updates their values when the values have changed */
+static PetscErrorCode MatSeqAIJVBlockUpdate_Private(Mat A)
+{
+  Mat_SeqAIJVBlock *vb = (Mat_SeqAIJVBlock*)A->spptr;
+  PetscObjectState state;
+  PetscInt         ib;
+  PetscBool        rebuild;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  rebuild = (PetscBool)(vb->nonzerostate != A->nonzerostate);
+  /* MatSetVariableBlockSizes() may have been called after the assembly */
+  if (!rebuild && vb->useblocks) {
+    if (A->nblocks != vb->nb) rebuild = PETSC_TRUE;
+    for (ib=0; ib<vb->nb && !rebuild; ib++) if (A->bsizes[ib] != vb->bstart[ib+1] - vb->bstart[ib]) rebuild = PETSC_TRUE;
+  }
+  ierr = PetscObjectStateGet((PetscObject)A,&state);CHKERRQ(ierr);
+  if (!rebuild && vb->state == state) PetscFunctionReturn(0);
+  ierr = PetscLogEventBegin(MAT_Convert,A,0,0,0);CHKERRQ(ierr);
+  if (rebuild) {
+    ierr = MatSeqAIJVBlockBuildBlocks_Private(A);CHKERRQ(ierr);
+    vb->nonzerostate = A->nonzerostate;
+  }
+  if (vb->useblocks) {ierr = MatSeqAIJVBlockSetValues_Private(A);CHKERRQ(ierr);}
+  ierr = PetscLogEventEnd(MAT_Convert,A,0,0,0);CHKERRQ(ierr);
+  vb->state = state;
+  PetscFunctionReturn(0);
+}
+
+/* Inverts the diagonal blocks, as MatInvertVariableBlockDiagonal_SeqAIJ() but without extracting them from the AIJ storage */
+static PetscErrorCode MatSeqAIJVBlockInvertDiagonal_Private(Mat A)
+{
+  Mat_SeqAIJVBlock *vb = (Mat_SeqAIJVBlock*)A->spptr;
+  PetscInt         ib,bs,bsmax = 0,ipvt[5],*v_pivots = NULL;
+  MatScalar        *diag,work[25],*v_work = NULL;
+  const PetscReal  shift = 0.0;
+  PetscBool        allowzeropivot,zeropivotdetected = PETSC_FALSE;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  if (vb->idiagvalid) PetscFunctionReturn(0);
+  allowzeropivot = PetscNot(A->erroriffailure);
+  for (ib=0; ib<vb->nb; ib++) bsmax = PetscMax(bsmax,vb->bstart[ib+1] - vb->bstart[ib]);
+  if (bsmax > 7) {
+    ierr = PetscMalloc2(bsmax,&v_work,bsmax,&v_pivots);CHKERRQ(ierr);
+  }
+  for (ib=0; ib<vb->nb; ib++) {
+    bs   = vb->bstart[ib+1] - vb->bstart[ib];
+    diag = vb->idiag + vb->ioff[ib];
+    /* a missing diagonal block is zero, its inversion fails with a zero pivot */
+    if (vb->bdiag[ib] >= 0) {
+      ierr = PetscArraycpy(diag,vb->bv+vb->boff[vb->bdiag[ib]],bs*bs);CHKERRQ(ierr);
+    } else {
+      ierr = PetscArrayzero(diag,bs*bs);CHKERRQ(ierr);
+    }
+    /* the inverse of a block stored in column major order is the inverse in column major order */
+    switch (bs) {
+    case 1:
+      *diag = 1.0/(*diag);
+      break;
+    case 2:
+      ierr = PetscKernel_A_gets_inverse_A_2(diag,shift,allowzeropivot,&zeropivotdetected);CHKERRQ(ierr);
+      break;
+    case 3:
+      ierr = PetscKernel_A_gets_inverse_A_3(diag,shift,allowzeropivot,&zeropivotdetected);CHKERRQ(ierr);
+      break;
+    case 4:
+      ierr = PetscKernel_A_gets_inverse_A_4(diag,shift,allowzeropivot,&zeropivotdetected);CHKERRQ(ierr);
+      break;
+    case 5:
+      ierr = PetscKernel_A_gets_inverse_A_5(diag,ipvt,work,shift,allowzeropivot,&zeropivotdetected);CHKERRQ(ierr);
+      break;
+    case 6:
+      ierr = PetscKernel_A_gets_inverse_A_6(diag,shift,allowzeropivot,&zeropivotdetected);CHKERRQ(ierr);
+      break;
+    case 7:
+      ierr = PetscKernel_A_gets_inverse_A_7(diag,shift,allowzeropivot,&zeropivotdetected);CHKERRQ(ierr);
+      break;
+    default:
+      ierr = PetscKernel_A_gets_inverse_A(bs,diag,v_pivots,v_work,allowzeropivot,&zeropivotdetected);CHKERRQ(ierr);
+    }
+    if (zeropivotdetected) A->factorerrortype = MAT_FACTOR_NUMERIC_ZEROPIVOT;
+  }
+  if (bsmax > 7) {
+    ierr = PetscFree2(v_work,v_pivots);CHKERRQ(ierr);
+  }
+  vb->idiagvalid = PETSC_TRUE;
+  PetscFunctionReturn(0);
+}
+
+/* y_I = y_I + sum of the blocks of block row I times x, skipping the block at position kskip */
+PETSC_STATIC_INLINE void MatSeqAIJVBlockMultRow_Private(Mat_SeqAIJVBlock *vb,PetscInt ib,PetscInt kskip,const PetscScalar *x,PetscScalar *y)
+{
+  const PetscInt  *bstart = vb->bstart,*bj = vb->bj;
+  const MatScalar *v;
+  PetscInt        k,r,c,bs = bstart[ib+1] - bstart[ib],bsj;
+  PetscScalar     xc;
+
+  for (k=vb->bi[ib]; k<vb->bi[ib+1]; k++) {
+    if (k == kskip) continue;
+    v   = vb->bv + vb->boff[k];
+    bsj = bstart[bj[k]+1] - bstart[bj[k]];
+    for (c=0; c<bsj; c++) {
+      xc = x[bstart[bj[k]]+c];
+      for (r=0; r<bs; r++) y[r] += v[r]*xc;
+      v += bs;
+    }
+  }
+}
+
+PetscErrorCode MatMult_SeqAIJVBlock(Mat A,Vec xx,Vec yy)
+{
+  Mat_SeqAIJVBlock  *vb = (Mat_SeqAIJVBlock*)A->spptr;
+  const PetscScalar *x;
+  PetscScalar       *y;
+  PetscInt          ib;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJVBlockUpdate_Private(A);CHKERRQ(ierr);
+  if (!vb->useblocks) {
+    ierr = (*vb->mult)(A,xx,yy);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArray(yy,&y);CHKERRQ(ierr);
+  ierr = PetscArrayzero(y,A->rmap->n);CHKERRQ(ierr);
+  for (ib=0; ib<vb->nb; ib++) MatSeqAIJVBlockMultRow_Private(vb,ib,-1,x,y+vb->bstart[ib]);
+  ierr = PetscLogFlops(PetscMax(2.0*vb->boff[vb->bi[vb->nb]] - A->rmap->n,0));CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArray(yy,&y);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatMultAdd_SeqAIJVBlock(Mat A,Vec xx,Vec yy,Vec zz)
+{
+  Mat_SeqAIJVBlock  *vb = (Mat_SeqAIJVBlock*)A->spptr;
+  const PetscScalar *x;
+  PetscScalar       *z;
+  PetscInt          ib;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJVBlockUpdate_Private(A);CHKERRQ(ierr);
+  if (!vb->useblocks) {
+    ierr = (*vb->multadd)(A,xx,yy,zz);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  if (yy != zz) {ierr = VecCopy(yy,zz);CHKERRQ(ierr);}
+  ierr = VecGetArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArray(zz,&z);CHKERRQ(ierr);
+  for (ib=0; ib<vb->nb; ib++) MatSeqAIJVBlockMultRow_Private(vb,ib,-1,x,z+vb->bstart[ib]);
+  ierr = PetscLogFlops(2.0*vb->boff[vb->bi[vb->nb]]);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArray(zz,&z);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Relaxes block row I: x_I = (1-omega) x_I + omega D_I^{-1} (b_I - sum_{J != I} A_IJ x_J), with s a work array of the size of the block */
+PETSC_STATIC_INLINE void MatSeqAIJVBlockRelax_Private(Mat_SeqAIJVBlock *vb,PetscInt ib,PetscReal omega,const PetscScalar *b,PetscScalar *x,PetscScalar *s)
+{
+  const MatScalar *idiag = vb->idiag + vb->ioff[ib];
+  PetscInt        r,c,bs = vb->bstart[ib+1] - vb->bstart[ib];
+  PetscScalar     *xI = x + vb->bstart[ib],t;
+
+  for (r=0; r<bs; r++) s[r] = 0.0;
+  MatSeqAIJVBlockMultRow_Private(vb,ib,vb->bdiag[ib],x,s);
+  for (r=0; r<bs; r++) s[r] = b[vb->bstart[ib]+r] - s[r];
+  for (r=0; r<bs; r++) {
+    t = 0.0;
+    for (c=0; c<bs; c++) t += idiag[r+c*bs]*s[c];
+    xI[r] = (1.0-omega)*xI[r] + omega*t;
+  }
+}
+
+/*
+   Block Gauss-Seidel with relaxation, sweeping the block rows forward and/or backward. The Eisenstat
+   trick, the application of the triangular parts, the multicolor sweeps and diagonal shifts use the point SOR of SEQAIJ.
+*/
+PetscErrorCode MatSOR_SeqAIJVBlock(Mat A,Vec bb,PetscReal omega,MatSORType flag,PetscReal fshift,PetscInt its,PetscInt lits,Vec xx)
+{
+  Mat_SeqAIJVBlock  *vb = (Mat_SeqAIJVBlock*)A->spptr;
+  const PetscScalar *b;
+  PetscScalar       *x,*s;
+  PetscInt          ib,bsmax = 0,sweeps = 0;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJVBlockUpdate_Private(A);CHKERRQ(ierr);
+  if (!vb->useblocks || fshift != 0.0 || (flag & SOR_MULTICOLOR) || (flag & SOR_EISENSTAT) || (flag & SOR_APPLY_UPPER) || (flag & SOR_APPLY_LOWER)) {
+    ierr = (*vb->sor)(A,bb,omega,flag,fshift,its,lits,xx);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  its = its*lits;
+  if (its <= 0) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONG,"Relaxation requires global its %D and local its %D both positive",its,lits);
+  ierr = MatSeqAIJVBlockInvertDiagonal_Private(A);CHKERRQ(ierr);
+  for (ib=0; ib<vb->nb; ib++) bsmax = PetscMax(bsmax,vb->bstart[ib+1] - vb->bstart[ib]);
+  ierr = PetscMalloc1(bsmax,&s);CHKERRQ(ierr);
+
+  if (flag & SOR_ZERO_INITIAL_GUESS) {ierr = VecSet(xx,0.0);CHKERRQ(ierr);}
+  ierr = VecGetArray(xx,&x);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(bb,&b);CHKERRQ(ierr);
+  while (its--) {
+    if ((flag & SOR_FORWARD_SWEEP) || (flag & SOR_LOCAL_FORWARD_SWEEP)) {
+      for (ib=0; ib<vb->nb; ib++) MatSeqAIJVBlockRelax_Private(vb,ib,omega,b,x,s);
+      sweeps++;
+    }
+    if ((flag & SOR_BACKWARD_SWEEP) || (flag & SOR_LOCAL_BACKWARD_SWEEP)) {
+      for (ib=vb->nb-1; ib>=0; ib--) MatSeqAIJVBlockRelax_Private(vb,ib,omega,b,x,s);
+      sweeps++;
+    }
+  }
+  ierr = PetscLogFlops(sweeps*(2.0*vb->boff[vb->bi[vb->nb]] + 2.0*vb->ioff[vb->nb]));CHKERRQ(ierr);
+  ierr = VecRestoreArray(xx,&x);CHKERRQ(ierr);
+  ierr = VecRestoreArrayRead(bb,&b);CHKERRQ(ierr);
+  ierr = PetscFree(s);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Copies the inverses of the diagonal blocks, which are stored in the same layout as the one used by PCVPBJACOBI, when the
+   block sizes are those of the stored blocks
+*/
+PetscErrorCode MatInvertVariableBlockDiagonal_SeqAIJVBlock(Mat A,PetscInt nblocks,const PetscInt *bsizes,PetscScalar *diag)
+{
+  Mat_SeqAIJVBlock *vb = (Mat_SeqAIJVBlock*)A->spptr;
+  PetscInt         ib;
+  PetscBool        same;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJVBlockUpdate_Private(A);CHKERRQ(ierr);
+  same = (PetscBool)(vb->useblocks && nblocks == vb->nb);
+  for (ib=0; ib<nblocks && same; ib++) if (bsizes[ib] != vb->bstart[ib+1] - vb->bstart[ib]) same = PETSC_FALSE;
+  if (!same) {
+    ierr = MatInvertVariableBlockDiagonal_SeqAIJ(A,nblocks,bsizes,diag);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = MatSeqAIJVBlockInvertDiagonal_Private(A);CHKERRQ(ierr);
+  ierr = PetscArraycpy(diag,vb->idiag,vb->ioff[vb->nb]);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   The SEQAIJ assembly and duplication set the inode kernels when the matrix has inodes, so they are saved for the
+   matrices that are not square before the operations are overridden
+*/
+static PetscErrorCode MatSeqAIJVBlockSetOps_Private(Mat A)
+{
+  Mat_SeqAIJVBlock *vb = (Mat_SeqAIJVBlock*)A->spptr;
+
+  PetscFunctionBegin;
+  vb->mult     = A->ops->mult    == MatMult_SeqAIJVBlock    ? MatMult_SeqAIJ    : A->ops->mult;
+  vb->multadd  = A->ops->multadd == MatMultAdd_SeqAIJVBlock ? MatMultAdd_SeqAIJ : A->ops->multadd;
+  vb->sor      = A->ops->sor     == MatSOR_SeqAIJVBlock     ? MatSOR_SeqAIJ     : A->ops->sor;
+  A->ops->mult    = MatMult_SeqAIJVBlock;
+  A->ops->multadd = MatMultAdd_SeqAIJVBlock;
+  A->ops->sor     = MatSOR_SeqAIJVBlock;
+  PetscFunctionReturn(0);
+}
+
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJVBlock_SeqAIJ(Mat A,MatType type,MatReuse reuse,Mat *newmat)
+{
+  /* This routine is only called to convert a MATAIJVBLOCK to its base PETSc type, */
+  /* so we will ignore 'MatType type'. */
+  PetscErrorCode   ierr;
+  Mat              B = *newmat;
+  Mat_SeqAIJVBlock *vb;
+
+  PetscFunctionBegin;
+  if (reuse == MAT_INITIAL_MATRIX) {
+    ierr = MatDuplicate(A,MAT_COPY_VALUES,&B);CHKERRQ(ierr);
+  }
+  vb = (Mat_SeqAIJVBlock*)B->spptr;
+
+  /* Reset the original function pointers. */
+  B->ops->duplicate                   = MatDuplicate_SeqAIJ;
+  B->ops->assemblyend                 = MatAssemblyEnd_SeqAIJ;
+  B->ops->destroy                     = MatDestroy_SeqAIJ;
+  B->ops->mult                        = vb->mult;
+  B->ops->multadd                     = vb->multadd;
+  B->ops->sor                         = vb->sor;
+  B->ops->diagonalscale               = MatDiagonalScale_SeqAIJ;
+  B->ops->invertvariableblockdiagonal = MatInvertVariableBlockDiagonal_SeqAIJ;
+
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaijvblock_seqaij_C",NULL);CHKERRQ(ierr);
+
+  /* Free everything in the Mat_SeqAIJVBlock data structure. */
+  ierr = MatSeqAIJVBlockDestroyBlocks_Private(B);CHKERRQ(ierr);
+  ierr = PetscFree(B->spptr);CHKERRQ(ierr);
+
+  /* Change the type of B to MATSEQAIJ. */
+  ierr = PetscObjectChangeTypeName((PetscObject)B,MATSEQAIJ);CHKERRQ(ierr);
+
+  *newmat = B;
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatDestroy_SeqAIJVBlock(Mat A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (A->spptr) {
+    /* If MatHeaderMerge() was used then this SeqAIJVBlock matrix will not have a spptr. */
+    ierr = MatSeqAIJVBlockDestroyBlocks_Private(A);CHKERRQ(ierr);
+    ierr = PetscFree(A->spptr);CHKERRQ(ierr);
+  }
+  /* Change the type of A back to SEQAIJ and use MatDestroy_SeqAIJ() to destroy everything that remains. */
+  ierr = PetscObjectChangeTypeName((PetscObject)A,MATSEQAIJ);CHKERRQ(ierr);
+  ierr = MatDestroy_SeqAIJ(A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   The block sizes are detected at the first assembly if none were set, so that PCVPBJACOBI can use them; the blocks
+   are built the first time they are used
+*/
+PetscErrorCode MatAssemblyEnd_SeqAIJVBlock(Mat A,MatAssemblyType mode)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (mode == MAT_FLUSH_ASSEMBLY) PetscFunctionReturn(0);
+  ierr = MatAssemblyEnd_SeqAIJ(A,mode);CHKERRQ(ierr);
+  ierr = MatSeqAIJVBlockSetOps_Private(A);CHKERRQ(ierr);
+  if (!A->nblocks && A->rmap->n && A->rmap->n == A->cmap->n) {
+    ierr = MatSeqAIJVBlockDetectBlocks_Private(A);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode MatDuplicate_SeqAIJVBlock(Mat A,MatDuplicateOption op,Mat *M)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  /* MatDuplicate_SeqAIJ() creates the duplicate with the type of A, its blocks are built when they are used */
+  ierr = MatDuplicate_SeqAIJ(A,op,M);CHKERRQ(ierr);
+  ierr = MatSeqAIJVBlockSetOps_Private(*M);CHKERRQ(ierr);
+  if (A->nblocks) {ierr = MatSetVariableBlockSizes(*M,A->nblocks,A->bsizes);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+/*
+   MatDiagonalScale_MPIAIJ() calls this directly on the blocks, so the state must be increased here to update the blocks
+*/
+PetscErrorCode MatDiagonalScale_SeqAIJVBlock(Mat A,Vec ll,Vec rr)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatDiagonalScale_SeqAIJ(A,ll,rr);CHKERRQ(ierr);
+  ierr = PetscObjectStateIncrease((PetscObject)A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* MatConvert_SeqAIJ_SeqAIJVBlock converts a SeqAIJ matrix into a
+ * SeqAIJVBlock matrix.  This routine is called by the MatCreate_SeqAIJVBlock()
+ * routine, but can also be used to convert an assembled SeqAIJ matrix
+ * into a SeqAIJVBlock one. */
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJVBlock(Mat A,MatType type,MatReuse reuse,Mat *newmat)
+{
+  PetscErrorCode   ierr;
+  Mat              B = *newmat;
+  Mat_SeqAIJVBlock *vb;
+  PetscBool        sametype;
+
+  PetscFunctionBegin;
+  if (reuse == MAT_INITIAL_MATRIX) {
+    ierr = MatDuplicate(A,MAT_COPY_VALUES,&B);CHKERRQ(ierr);
+    if (A->nblocks) {ierr = MatSetVariableBlockSizes(B,A->nblocks,A->bsizes);CHKERRQ(ierr);}
+  }
+  ierr = PetscObjectTypeCompare((PetscObject)A,type,&sametype);CHKERRQ(ierr);
+  if (sametype) PetscFunctionReturn(0);
+
+  ierr     = PetscNewLog(B,&vb);CHKERRQ(ierr);
+  B->spptr = (void*)vb;
+
+  vb->maxbs        = 16;
+  vb->nonzerostate = -1; /* this will trigger the building of the blocks the first time they are used */
+
+  ierr = PetscOptionsBegin(PetscObjectComm((PetscObject)B),((PetscObject)B)->prefix,"AIJVBLOCK Options","Mat");CHKERRQ(ierr);
+  ierr = PetscOptionsInt("-mat_aijvblock_max_bs","Largest size of the blocks detected from the nonzero structure","MatSetVariableBlockSizes",vb->maxbs,&vb->maxbs,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsEnd();CHKERRQ(ierr);
+  if (vb->maxbs < 1) SETERRQ1(PetscObjectComm((PetscObject)B),PETSC_ERR_ARG_OUTOFRANGE,"Largest block size %D must be positive",vb->maxbs);
+
+  /* Set function pointers for methods that we inherit from AIJ but override. */
+  B->ops->duplicate                   = MatDuplicate_SeqAIJVBlock;
+  B->ops->assemblyend                 = MatAssemblyEnd_SeqAIJVBlock;
+  B->ops->destroy                     = MatDestroy_SeqAIJVBlock;
+  B->ops->diagonalscale               = MatDiagonalScale_SeqAIJVBlock;
+  B->ops->invertvariableblockdiagonal = MatInvertVariableBlockDiagonal_SeqAIJVBlock;
+  ierr = MatSeqAIJVBlockSetOps_Private(B);CHKERRQ(ierr);
+
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatConvert_seqaijvblock_seqaij_C",MatConvert_SeqAIJVBlock_SeqAIJ);CHKERRQ(ierr);
+
+  /* an assembled matrix gets its block sizes as it would at its assembly */
+  if (B->assembled && !B->nblocks && B->rmap->n && B->rmap->n == B->cmap->n) {
+    ierr = MatSeqAIJVBlockDetectBlocks_Private(B);CHKERRQ(ierr);
+  }
+
+  ierr    = PetscObjectChangeTypeName((PetscObject)B,MATSEQAIJVBLOCK);CHKERRQ(ierr);
+  *newmat = B;
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   MatCreateSeqAIJVBlock - Creates a sparse matrix of type SEQAIJVBLOCK.
+   This type inherits from AIJ and uses the same storage, but also stores the matrix as dense blocks
+   whose rows and columns are the variable sized blocks set with MatSetVariableBlockSizes(), or detected from
+   the nonzero structure. MatMult(), MatMultAdd(), MatSOR() and MatInvertVariableBlockDiagonal() use the blocks.
+   Because SEQAIJVBLOCK is a subtype of SEQAIJ, the option "-mat_seqaij_type seqaijvblock" can be used to make
+   sequential AIJ matrices default to being instances of MATSEQAIJVBLOCK.
+
+   Collective
+
+   Input Parameters:
++  comm - MPI communicator, set to PETSC_COMM_SELF
+.  m - number of rows
+.  n - number of columns
+.  nz - number of nonzeros per row (same for all rows)
+-  nnz - array containing the number of nonzeros in the various rows
+         (possibly different for each row) or NULL
+
+   Output Parameter:
+.  A - the matrix
+
+   Options Database Keys:
+.  -mat_aijvblock_max_bs <16> - the largest size of the blocks detected from the nonzero structure
+
+   Notes:
+   If nnz is given then nz is ignored
+
+   If MatSetVariableBlockSizes() has not been called before the first final assembly, consecutive rows with the same
+   nonzero columns are grouped into blocks and set as the variable block sizes of the matrix. Node blocks whose rows
+   do not all have the same nonzero columns must be set with MatSetVariableBlockSizes(). Entries of the blocks that are
+   not nonzeros of the matrix are stored as zeros.
+
+   MatSOR() is a block Gauss-Seidel method with relaxation, using the inverses of the diagonal blocks; the
+   Eisenstat trick, the application of the triangular parts and diagonal shifts use the point SOR of SEQAIJ.
+   Matrices that are not square use the SEQAIJ operations.
+
+   Level: intermediate
+
+.seealso: MatCreate(), MatCreateMPIAIJVBlock(), MatSetValues(), MatSetVariableBlockSizes(), PCVPBJACOBI
+@*/
+PetscErrorCode  MatCreateSeqAIJVBlock(MPI_Comm comm,PetscInt m,PetscInt n,PetscInt nz,const PetscInt nnz[],Mat *A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatCreate(comm,A);CHKERRQ(ierr);
+  ierr = MatSetSizes(*A,m,n,m,n);CHKERRQ(ierr);
+  ierr = MatSetType(*A,MATSEQAIJVBLOCK);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation_SeqAIJ(*A,nz,nnz);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJVBlock(Mat A)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSetType(A,MATSEQAIJ);CHKERRQ(ierr);
+  ierr = MatConvert_SeqAIJ_SeqAIJVBlock(A,MATSEQAIJVBLOCK,MAT_INPLACE_MATRIX,&A);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
@@ -0,0 +1,332 @@
+/*
+    Provides the ILU(k) factorization of SeqAIJ matrices computed by fixed-point sweeps, following
+  E. Chow and A. Patel, Fine-grained parallel incomplete LU factorization, SIAM J. Sci. Comput. 37 (2015).
+
+    The nonzero pattern of the factors is the one computed by MatILUFactorSymbolic_SeqAIJ(). Each sweep
+  recomputes every nonzero of the factors from the values of the previous sweep with
+
+      L(i,j) = (A(i,j) - sum_{k<j} L(i,k) U(k,j)) / U(j,j)   for i > j
+      U(i,j) =  A(i,j) - sum_{k<i} L(i,k) U(k,j)             for i <= j
+
+  so all the nonzeros are independent and the rows are shared among the OpenMP threads. The factors are
+  stored exactly like the ones of MatLUFactorNumeric_SeqAIJ() and use the same triangular solves.
+*/
+
+#include <../src/mat/impls/aij/seq/aij.h>
+#if defined(PETSC_HAVE_OPENMP)
+#include <omp.h>
+#endif
+
+typedef struct {
+  PetscInt    sweeps;               /* number of fixed-point sweeps */
+  PetscInt    nthreads;             /* number of threads used by the sweeps */
+  PetscInt    *ucptr,*ucrow,*ucpos; /* strictly upper triangular part of U by columns: column j has the rows ucrow[ucptr[j]],...,ucrow[ucptr[j+1]-1]
+                                       (in increasing order) whose values are at ucpos[] in the values of the factor */
+  PetscInt    *amap;                /* position in the values of the factor of each nonzero of A */
+  PetscScalar *av,*work;            /* values of A on the pattern of the factor and values of the previous sweep */
+} Mat_SeqAIJChowILU;
+
+static PetscErrorCode MatChowILUDestroy_Private(void *ptr)
+{
+  Mat_SeqAIJChowILU *chow = (Mat_SeqAIJChowILU*)ptr;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree3(chow->ucptr,chow->ucrow,chow->ucpos);CHKERRQ(ierr);
+  ierr = PetscFree(chow->amap);CHKERRQ(ierr);
+  ierr = PetscFree2(chow->av,chow->work);CHKERRQ(ierr);
+  ierr = PetscFree(chow);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatFactorGetSolverType_seqaij_chowilu(Mat A,MatSolverType *type)
+{
+  PetscFunctionBegin;
+  *type = MATSOLVERCHOWILU;
+  PetscFunctionReturn(0);
+}
+
+/*
+   sum_k L(i,k) U(k,j) over the k < kmax in both row i of L, given by the entries lstart,...,lend-1 of the factor, and column j of U
+*/
+PETSC_STATIC_INLINE PetscScalar MatChowILURowColDot_Private(const PetscInt *bj,const PetscScalar *x,PetscInt lstart,PetscInt lend,const Mat_SeqAIJChowILU *chow,PetscInt j,PetscInt kmax,PetscLogDouble *flops)
+{
+  PetscInt    q = lstart,t = chow->ucptr[j],tend = chow->ucptr[j+1],kq,kt;
+  PetscScalar sum = 0.0;
+
+  while (q < lend && t < tend) {
+    kq = bj[q];
+    kt = chow->ucrow[t];
+    if (kq >= kmax || kt >= kmax) break;
+    if (kq == kt) {
+      sum += x[q]*x[chow->ucpos[t]];
+      q++; t++;
+      *flops += 2.0;
+    } else if (kq < kt) q++;
+    else t++;
+  }
+  return sum;
+}
+
+static PetscErrorCode MatLUFactorNumeric_SeqAIJ_ChowILU(Mat B,Mat A,const MatFactorInfo *info)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data,*b = (Mat_SeqAIJ*)B->data;
+  Mat_SeqAIJChowILU *chow;
+  PetscContainer    container;
+  PetscErrorCode    ierr;
+  PetscInt          i,p,n = A->rmap->n,s,nz;
+  const PetscInt    *bi = b->i,*bj = b->j,*bdiag = b->diag;
+  PetscScalar       *x,*y,*t;
+  PetscLogDouble    flops = 0.0;
+  FactorShiftCtx    sctx;
+  PetscReal         rs;
+  PetscBool         row_identity,col_identity;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectQuery((PetscObject)B,"MatChowILU",(PetscObject*)&container);CHKERRQ(ierr);
+  if (!container) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Must call MatILUFactorSymbolic() first");
+  ierr = PetscContainerGetPointer(container,(void**)&chow);CHKERRQ(ierr);
+  nz   = bdiag[0] + 1;
+
+  /* MatPivotSetUp(): initialize the shift context as MatLUFactorNumeric_SeqAIJ() does */
+  ierr = PetscMemzero(&sctx,sizeof(FactorShiftCtx));CHKERRQ(ierr);
+  if (info->shifttype == (PetscReal)MAT_SHIFT_POSITIVE_DEFINITE) { /* set sctx.shift_top=max{rs} */
+    sctx.shift_top = info->zeropivot;
+    for (i=0; i<n; i++) {
+      rs = 0.0;
+      for (p=a->i[i]; p<a->i[i+1]; p++) {
+        if (a->j[p] == i) rs -= PetscAbsScalar(a->a[p]) + PetscRealPart(a->a[p]);
+        rs += PetscAbsScalar(a->a[p]);
+      }
+      if (rs > sctx.shift_top) sctx.shift_top = rs;
+    }
+    sctx.shift_top *= 1.1;
+    sctx.nshift_max = 5;
+    sctx.shift_lo   = 0.;
+    sctx.shift_hi   = 1.;
+  }
+
+  do {
+    sctx.newshift = PETSC_FALSE;
+
+    /* the values of A + shift I on the pattern of the factor; the initial guess is L = strictly lower part of A scaled by the diagonal and U = upper part of A */
+    ierr = PetscArrayzero(chow->av,nz);CHKERRQ(ierr);
+    for (p=0; p<a->i[n]; p++) chow->av[chow->amap[p]] += a->a[p];
+    for (i=0; i<n; i++) chow->av[bdiag[i]] += sctx.shift_amount;
+    x    = b->a;
+    y    = chow->work;
+    ierr = PetscArraycpy(x,chow->av,nz);CHKERRQ(ierr);
+    for (i=0; i<n; i++) {
+      for (p=bi[i]; p<bi[i+1]; p++) {
+        if (chow->av[bdiag[bj[p]]] != (PetscScalar)0.0) x[p] /= chow->av[bdiag[bj[p]]];
+      }
+    }
+
+    for (s=0; s<chow->sweeps; s++) {
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel for num_threads(chow->nthreads) schedule(dynamic,32) reduction(+:flops)
+#endif
+      for (i=0; i<n; i++) {
+        PetscInt    q,j;
+        PetscScalar sum,d;
+
+        /* row i of L */
+        for (q=bi[i]; q<bi[i+1]; q++) {
+          j    = bj[q];
+          sum  = chow->av[q] - MatChowILURowColDot_Private(bj,x,bi[i],q,chow,j,j,&flops);
+          d    = x[bdiag[j]];
+          y[q] = d != (PetscScalar)0.0 ? sum/d : x[q];
+        }
+        /* diagonal and row i of U */
+        y[bdiag[i]] = chow->av[bdiag[i]] - MatChowILURowColDot_Private(bj,x,bi[i],bi[i+1],chow,i,i,&flops);
+        for (q=bdiag[i+1]+1; q<bdiag[i]; q++) {
+          y[q] = chow->av[q] - MatChowILURowColDot_Private(bj,x,bi[i],bi[i+1],chow,bj[q],i,&flops);
+        }
+      }
+      t = x; x = y; y = t;
+    }
+    if (x != b->a) {ierr = PetscArraycpy(b->a,x,nz);CHKERRQ(ierr);}
+
+    /* check the pivots and store the inverse of the diagonal of U as MatLUFactorNumeric_SeqAIJ() does */
+    B->factorerrortype = MAT_FACTOR_NOERROR;
+    for (i=0; i<n; i++) {
+      rs = 0.0;
+      for (p=bi[i]; p<bi[i+1]; p++) rs += PetscAbsScalar(b->a[p]);
+      for (p=bdiag[i+1]+1; p<bdiag[i]; p++) rs += PetscAbsScalar(b->a[p]);
+      sctx.rs = rs;
+      sctx.pv = b->a[bdiag[i]];
+      ierr    = MatPivotCheck(B,A,info,&sctx,i);CHKERRQ(ierr);
+      if (sctx.newshift || B->factorerrortype) break;
+      b->a[bdiag[i]] = 1.0/sctx.pv; /* sctx.pv might be updated in the case of MAT_SHIFT_INBLOCKS */
+    }
+
+    /* MatPivotRefine() */
+    if (info->shifttype == (PetscReal)MAT_SHIFT_POSITIVE_DEFINITE && !sctx.newshift && sctx.shift_fraction>0 && sctx.nshift<sctx.nshift_max) {
+      sctx.shift_hi       = sctx.shift_fraction;
+      sctx.shift_fraction = (sctx.shift_hi+sctx.shift_lo)/2.;
+      sctx.shift_amount   = sctx.shift_fraction * sctx.shift_top;
+      sctx.newshift       = PETSC_TRUE;
+      sctx.nshift++;
+    }
+  } while (sctx.newshift);
+  if (sctx.nshift) {
+    if (info->shifttype == (PetscReal)MAT_SHIFT_POSITIVE_DEFINITE) {
+      ierr = PetscInfo4(A,"number of shift_pd tries %D, shift_amount %g, diagonal shifted up by %e fraction top_value %e\n",sctx.nshift,(double)sctx.shift_amount,(double)sctx.shift_fraction,(double)sctx.shift_top);CHKERRQ(ierr);
+    } else if (info->shifttype == (PetscReal)MAT_SHIFT_NONZERO) {
+      ierr = PetscInfo2(A,"number of shift_nz tries %D, shift_amount %g\n",sctx.nshift,(double)sctx.shift_amount);CHKERRQ(ierr);
+    } else if (info->shifttype == (PetscReal)MAT_SHIFT_INBLOCKS) {
+      ierr = PetscInfo2(A,"number of shift_inblocks applied %D, each shift_amount %g\n",sctx.nshift,(double)info->shiftamount);CHKERRQ(ierr);
+    }
+  }
+
+  ierr = ISIdentity(b->row,&row_identity);CHKERRQ(ierr);
+  ierr = ISIdentity(b->icol,&col_identity);CHKERRQ(ierr);
+  if (b->inode.size) {
+    B->ops->solve = MatSolve_SeqAIJ_Inode;
+  } else if (row_identity && col_identity) {
+    B->ops->solve = MatSolve_SeqAIJ_NaturalOrdering;
+  } else {
+    B->ops->solve = MatSolve_SeqAIJ;
+  }
+  B->ops->solveadd          = MatSolveAdd_SeqAIJ;
+  B->ops->solvetranspose    = MatSolveTranspose_SeqAIJ;
+  B->ops->solvetransposeadd = MatSolveTransposeAdd_SeqAIJ;
+  B->ops->matsolve          = MatMatSolve_SeqAIJ;
+  B->assembled              = PETSC_TRUE;
+  B->preallocated           = PETSC_TRUE;
+  ierr = MatSetUpSolveLevels_SeqAIJ(B,A);CHKERRQ(ierr);
+
+  ierr = PetscLogFlops(flops + nz);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatILUFactorSymbolic_SeqAIJ_ChowILU(Mat fact,Mat A,IS isrow,IS iscol,const MatFactorInfo *info)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ*)A->data,*b;
+  Mat_SeqAIJChowILU *chow;
+  PetscContainer    container;
+  PetscErrorCode    ierr;
+  PetscInt          i,j,k,p,n = A->rmap->n,nz,*marker;
+  const PetscInt    *bi,*bj,*bdiag,*r,*ic;
+
+  PetscFunctionBegin;
+  ierr = MatILUFactorSymbolic_SeqAIJ(fact,A,isrow,iscol,info);CHKERRQ(ierr);
+  fact->ops->lufactornumeric = MatLUFactorNumeric_SeqAIJ_ChowILU;
+  b     = (Mat_SeqAIJ*)fact->data;
+  bi    = b->i;
+  bj    = b->j;
+  bdiag = b->diag;
+  nz    = bdiag[0] + 1;
+
+  ierr = PetscNew(&chow);CHKERRQ(ierr);
+  chow->sweeps = 3;
+#if defined(PETSC_HAVE_OPENMP)
+  chow->nthreads = omp_get_max_threads();
+#else
+  chow->nthreads = 1;
+#endif
+  ierr = PetscOptionsGetInt(((PetscObject)A)->options,((PetscObject)A)->prefix,"-mat_chowilu_sweeps",&chow->sweeps,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(((PetscObject)A)->options,((PetscObject)A)->prefix,"-mat_chowilu_threads",&chow->nthreads,NULL);CHKERRQ(ierr);
+  if (chow->sweeps < 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Number of sweeps %D must be nonnegative",chow->sweeps);
+  if (chow->nthreads < 1) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Number of threads %D must be positive",chow->nthreads);
+#if !defined(PETSC_HAVE_OPENMP)
+  if (chow->nthreads > 1) {
+    ierr = PetscInfo1(A,"PETSc was not configured with OpenMP, the sweeps use 1 thread instead of %D\n",chow->nthreads);CHKERRQ(ierr);
+    chow->nthreads = 1;
+  }
+#endif
+
+  /* columns of the strictly upper triangular part of U, the rows are visited in increasing order so each column is sorted */
+  ierr = PetscMalloc3(n+1,&chow->ucptr,nz,&chow->ucrow,nz,&chow->ucpos);CHKERRQ(ierr);
+  ierr = PetscArrayzero(chow->ucptr,n+1);CHKERRQ(ierr);
+  for (i=0; i<n; i++) {
+    for (p=bdiag[i+1]+1; p<bdiag[i]; p++) chow->ucptr[bj[p]+1]++;
+  }
+  for (i=0; i<n; i++) chow->ucptr[i+1] += chow->ucptr[i];
+  for (i=0; i<n; i++) {
+    for (p=bdiag[i+1]+1; p<bdiag[i]; p++) {
+      j = bj[p];
+      chow->ucrow[chow->ucptr[j]] = i;
+      chow->ucpos[chow->ucptr[j]] = p;
+      chow->ucptr[j]++;
+    }
+  }
+  for (i=n; i>0; i--) chow->ucptr[i] = chow->ucptr[i-1];
+  chow->ucptr[0] = 0;
+
+  /* position in the factor of every nonzero of A, row r[i] of A is row i of the factor and column c of A is column ic[c] */
+  ierr = PetscMalloc1(a->i[n],&chow->amap);CHKERRQ(ierr);
+  ierr = PetscMalloc2(nz,&chow->av,nz,&chow->work);CHKERRQ(ierr);
+  ierr = PetscMalloc1(n,&marker);CHKERRQ(ierr);
+  for (i=0; i<n; i++) marker[i] = -1;
+  ierr = ISGetIndices(isrow,&r);CHKERRQ(ierr);
+  ierr = ISGetIndices(b->icol,&ic);CHKERRQ(ierr);
+  for (i=0; i<n; i++) {
+    for (p=bi[i]; p<bi[i+1]; p++) marker[bj[p]] = p;
+    marker[i] = bdiag[i];
+    for (p=bdiag[i+1]+1; p<bdiag[i]; p++) marker[bj[p]] = p;
+    for (p=a->i[r[i]]; p<a->i[r[i]+1]; p++) {
+      k = ic[a->j[p]];
+      if (marker[k] < 0) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Nonzero (%D,%D) of the matrix is not in the pattern of the factor",r[i],a->j[p]);
+      chow->amap[p] = marker[k];
+    }
+    for (p=bi[i]; p<bi[i+1]; p++) marker[bj[p]] = -1;
+    marker[i] = -1;
+    for (p=bdiag[i+1]+1; p<bdiag[i]; p++) marker[bj[p]] = -1;
+  }
+  ierr = ISRestoreIndices(isrow,&r);CHKERRQ(ierr);
+  ierr = ISRestoreIndices(b->icol,&ic);CHKERRQ(ierr);
+  ierr = PetscFree(marker);CHKERRQ(ierr);
+
+  ierr = PetscContainerCreate(PETSC_COMM_SELF,&container);CHKERRQ(ierr);
+  ierr = PetscContainerSetPointer(container,chow);CHKERRQ(ierr);
+  ierr = PetscContainerSetUserDestroy(container,MatChowILUDestroy_Private);CHKERRQ(ierr);
+  ierr = PetscObjectCompose((PetscObject)fact,"MatChowILU",(PetscObject)container);CHKERRQ(ierr);
+  ierr = PetscContainerDestroy(&container);CHKERRQ(ierr);
+  ierr = PetscInfo2(A,"Fixed-point ILU with %D sweeps on %D threads\n",chow->sweeps,chow->nthreads);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*MC
+  MATSOLVERCHOWILU - ILU(k) factorization of SeqAIJ matrices computed with the fine-grained parallel fixed-point
+  sweeps of Chow and Patel, the nonzeros of the factors being updated by several OpenMP threads
+
+  Works with MATSEQAIJ matrices, including the blocks of PCBJACOBI and PCASM
+
+  Options Database Keys:
++ -pc_factor_mat_solver_type chowilu - selects this factorization for PCILU
+. -pc_factor_levels <k> - number of levels of fill
+. -mat_chowilu_sweeps <3> - number of fixed-point sweeps, given on the matrix being factored
+- -mat_chowilu_threads <n> - number of OpenMP threads used by the sweeps, defaults to the maximum number of OpenMP threads
+
+  Level: intermediate
+
+  Notes:
+    Each sweep computes all the nonzeros of the factors from the values of the previous sweep (a Jacobi-type iteration), so the
+    factors do not depend on the number of threads. The initial guess is L = strictly lower triangular part of A scaled by the diagonal of A,
+    U = upper triangular part of A. The sweeps converge to the factors of PCILU with MATSOLVERPETSC, in a number of sweeps that is at most the
+    number of rows, but a few sweeps usually give a preconditioner of similar quality.
+
+    The triangular solves are the ones of MATSOLVERPETSC, they can be level scheduled with -mat_solve_level_threads
+
+    The shifts of -pc_factor_shift_type and -pc_factor_shift_amount are applied as with MATSOLVERPETSC: the NONZERO and
+    POSITIVE_DEFINITE shifts add a multiple of the identity to the matrix and redo the sweeps until all the pivots pass the check,
+    while the INBLOCKS shift replaces the small pivots in the final factors only (the sweeps do not see it).
+
+.seealso: PCFactorSetMatSolverType(), MatSolverType, PCFactorSetLevels(), PCILU, MATSOLVERPETSC
+M*/
+
+PETSC_INTERN PetscErrorCode MatGetFactor_seqaij_chowilu(Mat A,MatFactorType ftype,Mat *B)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (ftype != MAT_FACTOR_ILU) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Factor type not supported");
+  ierr = MatGetFactor_seqaij_petsc(A,ftype,B);CHKERRQ(ierr);
+  (*B)->ops->ilufactorsymbolic = MatILUFactorSymbolic_SeqAIJ_ChowILU;
+  (*B)->ops->lufactorsymbolic  = NULL;
+  ierr = PetscObjectComposeFunction((PetscObject)*B,"MatFactorGetSolverType_C",MatFactorGetSolverType_seqaij_chowilu);CHKERRQ(ierr);
+  ierr = PetscFree((*B)->solvertype);CHKERRQ(ierr);
+  ierr = PetscStrallocpy(MATSOLVERCHOWILU,&(*B)->solvertype);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
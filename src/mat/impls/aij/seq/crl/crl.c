@@ -142,7 +142,7 @@ PetscErrorCode MatMult_AIJCRL(Mat A,Vec xx,Vec yy)
 #endif
 
 #endif
-  ierr = PetscLogFlops(2.0*aijcrl->nz - m);CHKERRQ(ierr);
+  ierr = PetscLogFlops(PetscMax(2.0*aijcrl->nz - m,0));CHKERRQ(ierr);
   ierr = VecRestoreArrayRead(xx,&x);CHKERRQ(ierr);
   ierr = VecRestoreArray(yy,&y);CHKERRQ(ierr);
   PetscFunctionReturn(0);
@@ -68,6 +68,7 @@ PetscErrorCode MatMatMultSymbolic_SeqAIJ_SeqAIJ(Mat A,Mat B,PetscReal fill,Mat C
   Mat_Product         *product = C->product;
   MatProductAlgorithm alg;
   PetscBool           flg;
+  PetscInt            nthreads;
 
   PetscFunctionBegin;
   if (product) {
@@ -79,49 +80,49 @@ PetscErrorCode MatMatMultSymbolic_SeqAIJ_SeqAIJ(Mat A,Mat B,PetscReal fill,Mat C
   ierr = PetscStrcmp(alg,"sorted",&flg);CHKERRQ(ierr);
   if (flg) {
     ierr = MatMatMultSymbolic_SeqAIJ_SeqAIJ_Sorted(A,B,fill,C);CHKERRQ(ierr);
-    PetscFunctionReturn(0);
+    goto next;
   }
 
   /* scalable */
   ierr = PetscStrcmp(alg,"scalable",&flg);CHKERRQ(ierr);
   if (flg) {
     ierr = MatMatMultSymbolic_SeqAIJ_SeqAIJ_Scalable(A,B,fill,C);CHKERRQ(ierr);
-    PetscFunctionReturn(0);
+    goto next;
   }
 
   /* scalable_fast */
   ierr = PetscStrcmp(alg,"scalable_fast",&flg);CHKERRQ(ierr);
   if (flg) {
     ierr = MatMatMultSymbolic_SeqAIJ_SeqAIJ_Scalable_fast(A,B,fill,C);CHKERRQ(ierr);
-    PetscFunctionReturn(0);
+    goto next;
   }
 
   /* heap */
   ierr = PetscStrcmp(alg,"heap",&flg);CHKERRQ(ierr);
   if (flg) {
     ierr = MatMatMultSymbolic_SeqAIJ_SeqAIJ_Heap(A,B,fill,C);CHKERRQ(ierr);
-    PetscFunctionReturn(0);
+    goto next;
   }
 
   /* btheap */
   ierr = PetscStrcmp(alg,"btheap",&flg);CHKERRQ(ierr);
   if (flg) {
     ierr = MatMatMultSymbolic_SeqAIJ_SeqAIJ_BTHeap(A,B,fill,C);CHKERRQ(ierr);
-    PetscFunctionReturn(0);
+    goto next;
   }
 
   /* llcondensed */
   ierr = PetscStrcmp(alg,"llcondensed",&flg);CHKERRQ(ierr);
   if (flg) {
     ierr = MatMatMultSymbolic_SeqAIJ_SeqAIJ_LLCondensed(A,B,fill,C);CHKERRQ(ierr);
-    PetscFunctionReturn(0);
+    goto next;
   }
 
   /* rowmerge */
   ierr = PetscStrcmp(alg,"rowmerge",&flg);CHKERRQ(ierr);
   if (flg) {
     ierr = MatMatMultSymbolic_SeqAIJ_SeqAIJ_RowMerge(A,B,fill,C);CHKERRQ(ierr);
-    PetscFunctionReturn(0);
+    goto next;
   }
 
 #if defined(PETSC_HAVE_HYPRE)
@@ -133,6 +134,11 @@ PetscErrorCode MatMatMultSymbolic_SeqAIJ_SeqAIJ(Mat A,Mat B,PetscReal fill,Mat C
 #endif
 
   SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Mat Product Algorithm is not supported");
+
+next:
+  /* split the rows of C among threads for the numeric phases, see matmatmultthreads.c */
+  ierr = MatProductGetThreads_Private(C,&nthreads);CHKERRQ(ierr);
+  if (nthreads) {ierr = MatSeqAIJSetUpProductThreads_Private(A,B,C,nthreads);CHKERRQ(ierr);}
   PetscFunctionReturn(0);
 }
 
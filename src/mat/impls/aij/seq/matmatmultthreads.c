@@ -0,0 +1,243 @@
+/*
+    Threaded numeric phases of the products of AIJ matrices.
+
+    With -mat_product_threads <n> the rows of C = A*B for SeqAIJ matrices, and the rows of A_loc*P in MatPtAP() and
+  MatMatMult() of MPIAIJ matrices, are split in the symbolic phase into n contiguous chunks with about the same number
+  of flops. The numeric phases then compute the chunks on OpenMP threads, each with its own dense accumulator when the
+  algorithm uses one. The nonzero structure of a product is fixed after the symbolic phase, so the split is reused by
+  all the numeric phases, for example when the Jacobian passed to PCGAMG changes at every Newton step.
+*/
+
+#include <../src/mat/impls/aij/seq/aij.h>
+
+typedef struct {
+  PetscInt    nthreads;
+  PetscInt    *rstart;   /* chunk t holds the rows rstart[t],...,rstart[t+1]-1 of C */
+  PetscInt    nwork;     /* length of the dense accumulator of each chunk */
+  PetscScalar *work;     /* dense accumulators, allocated on the first numeric phase that needs them */
+} Mat_SeqAIJProductThreads;
+
+static PetscErrorCode MatSeqAIJProductThreadsDestroy_Private(void *ptr)
+{
+  Mat_SeqAIJProductThreads *pt = (Mat_SeqAIJProductThreads*)ptr;
+  PetscErrorCode           ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree(pt->rstart);CHKERRQ(ierr);
+  ierr = PetscFree(pt->work);CHKERRQ(ierr);
+  ierr = PetscFree(pt);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Gets the number of threads of the numeric phases of the product C from -mat_product_threads, 0 if they are not threaded
+*/
+PetscErrorCode MatProductGetThreads_Private(Mat C,PetscInt *nthreads)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  *nthreads = 0;
+  ierr = PetscOptionsGetInt(((PetscObject)C)->options,((PetscObject)C)->prefix,"-mat_product_threads",nthreads,NULL);CHKERRQ(ierr);
+  if (*nthreads < 0) *nthreads = 0;
+#if !defined(PETSC_HAVE_OPENMP)
+  if (*nthreads > 1) {
+    ierr      = PetscInfo1(C,"PETSc was not configured with OpenMP, the numeric products use 1 thread instead of %D\n",*nthreads);CHKERRQ(ierr);
+    *nthreads = 1;
+  }
+#endif
+  PetscFunctionReturn(0);
+}
+
+/*
+   Splits the m rows into nt contiguous chunks of approximately equal cost, where cost[i] is the cost of the rows 0,...,i-1
+*/
+PetscErrorCode MatProductPartitionRows_Private(PetscInt m,const PetscLogDouble *cost,PetscInt nt,PetscInt *rstart)
+{
+  PetscInt       t,lo,hi,mid;
+  PetscLogDouble target;
+
+  PetscFunctionBegin;
+  rstart[0]  = 0;
+  rstart[nt] = m;
+  for (t=1; t<nt; t++) {
+    /* find the first row i such that cost[i] >= t*cost[m]/nt */
+    target = t*cost[m]/nt;
+    lo     = rstart[t-1];
+    hi     = m;
+    while (lo < hi) {
+      mid = lo + (hi - lo)/2;
+      if (cost[mid] < target) lo = mid + 1;
+      else hi = mid;
+    }
+    rstart[t] = lo;
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   Splits the rows of the product C = A*B, whose symbolic phase is done, among nthreads threads and switches its
+   numeric phase to the threaded version of the kernel set by the symbolic phase
+*/
+PetscErrorCode MatSeqAIJSetUpProductThreads_Private(Mat A,Mat B,Mat C,PetscInt nthreads)
+{
+  Mat_SeqAIJ               *a = (Mat_SeqAIJ*)A->data,*b = (Mat_SeqAIJ*)B->data;
+  Mat_SeqAIJProductThreads *pt;
+  PetscContainer           container;
+  PetscLogDouble           *cost;
+  PetscInt                 i,j,m = A->rmap->n;
+  const PetscInt           *ai = a->i,*aj = a->j,*bi = b->i;
+  PetscErrorCode           ierr;
+
+  PetscFunctionBegin;
+  if (nthreads <= 0) PetscFunctionReturn(0);
+  if (C->ops->matmultnumeric == MatMatMultNumeric_SeqAIJ_SeqAIJ_Sorted) {
+    C->ops->matmultnumeric = MatMatMultNumeric_SeqAIJ_SeqAIJ_Sorted_Threads;
+  } else if (C->ops->matmultnumeric == MatMatMultNumeric_SeqAIJ_SeqAIJ_Scalable) {
+    C->ops->matmultnumeric = MatMatMultNumeric_SeqAIJ_SeqAIJ_Scalable_Threads;
+  } else if (C->ops->matmultnumeric != MatMatMultNumeric_SeqAIJ_SeqAIJ_Sorted_Threads && C->ops->matmultnumeric != MatMatMultNumeric_SeqAIJ_SeqAIJ_Scalable_Threads) {
+    ierr = PetscInfo(C,"The numeric phase of this product has no threaded version\n");CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+
+  ierr = PetscNew(&pt);CHKERRQ(ierr);
+  pt->nthreads = nthreads;
+  ierr = PetscMalloc1(nthreads+1,&pt->rstart);CHKERRQ(ierr);
+  /* the cost of a row is the number of flops of its sparse axpys, plus one so that empty rows are not free */
+  ierr    = PetscMalloc1(m+1,&cost);CHKERRQ(ierr);
+  cost[0] = 0.0;
+  for (i=0; i<m; i++) {
+    cost[i+1] = cost[i] + 1.0;
+    for (j=ai[i]; j<ai[i+1]; j++) cost[i+1] += bi[aj[j]+1] - bi[aj[j]];
+  }
+  ierr = MatProductPartitionRows_Private(m,cost,nthreads,pt->rstart);CHKERRQ(ierr);
+  ierr = PetscFree(cost);CHKERRQ(ierr);
+
+  ierr = PetscContainerCreate(PETSC_COMM_SELF,&container);CHKERRQ(ierr);
+  ierr = PetscContainerSetPointer(container,pt);CHKERRQ(ierr);
+  ierr = PetscContainerSetUserDestroy(container,MatSeqAIJProductThreadsDestroy_Private);CHKERRQ(ierr);
+  ierr = PetscObjectCompose((PetscObject)C,"__PETSc__product_threads",(PetscObject)container);CHKERRQ(ierr);
+  ierr = PetscObjectDereference((PetscObject)container);CHKERRQ(ierr);
+  ierr = PetscInfo2(C,"Split the %D rows of the product among %D threads\n",m,nthreads);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSeqAIJGetProductThreads_Private(Mat C,Mat_SeqAIJProductThreads **pt)
+{
+  PetscContainer container;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectQuery((PetscObject)C,"__PETSc__product_threads",(PetscObject*)&container);CHKERRQ(ierr);
+  if (!container) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_PLIB,"The rows of the product have not been split among threads");
+  ierr = PetscContainerGetPointer(container,(void**)pt);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Same as MatMatMultNumeric_SeqAIJ_SeqAIJ_Sorted() with one dense accumulator of length B->cmap->N per chunk of rows
+*/
+PetscErrorCode MatMatMultNumeric_SeqAIJ_SeqAIJ_Sorted_Threads(Mat A,Mat B,Mat C)
+{
+  PetscErrorCode           ierr;
+  PetscLogDouble           flops = 0.0;
+  Mat_SeqAIJ               *a = (Mat_SeqAIJ*)A->data,*b = (Mat_SeqAIJ*)B->data,*c = (Mat_SeqAIJ*)C->data;
+  const PetscInt           *ai = a->i,*aj = a->j,*bi = b->i,*bj = b->j,*ci = c->i,*cj = c->j;
+  const PetscScalar        *aa = a->a,*ba = b->a;
+  PetscScalar              *ca;
+  Mat_SeqAIJProductThreads *pt;
+  PetscInt                 t,nt,cm = C->rmap->n;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJGetProductThreads_Private(C,&pt);CHKERRQ(ierr);
+  if (!c->a) {
+    ierr      = PetscMalloc1(ci[cm]+1,&c->a);CHKERRQ(ierr);
+    c->free_a = PETSC_TRUE;
+  }
+  ca = c->a;
+  if (pt->nwork != B->cmap->N) {
+    ierr      = PetscFree(pt->work);CHKERRQ(ierr);
+    pt->nwork = B->cmap->N;
+    ierr      = PetscCalloc1(pt->nthreads*pt->nwork,&pt->work);CHKERRQ(ierr);
+  }
+  nt = pt->nthreads;
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel for num_threads(nt) schedule(static,1) reduction(+:flops)
+#endif
+  for (t=0; t<nt; t++) {
+    PetscScalar *ab_dense = pt->work + t*pt->nwork,valtmp;
+    PetscInt    i,j,k,brow;
+
+    for (i=pt->rstart[t]; i<pt->rstart[t+1]; i++) {
+      for (j=ai[i]; j<ai[i+1]; j++) {
+        brow   = aj[j];
+        valtmp = aa[j];
+        for (k=bi[brow]; k<bi[brow+1]; k++) ab_dense[bj[k]] += valtmp*ba[k];
+        flops += 2*(bi[brow+1] - bi[brow]);
+      }
+      /* gather the row and zero the accumulator for the next row */
+      for (k=ci[i]; k<ci[i+1]; k++) {
+        ca[k]           = ab_dense[cj[k]];
+        ab_dense[cj[k]] = 0.0;
+      }
+      flops += ci[i+1] - ci[i];
+    }
+  }
+  ierr = MatAssemblyBegin(C,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(C,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = PetscLogFlops(flops);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Same as MatMatMultNumeric_SeqAIJ_SeqAIJ_Scalable(), the rows of B are merged into the row of C so no work space is needed
+*/
+PetscErrorCode MatMatMultNumeric_SeqAIJ_SeqAIJ_Scalable_Threads(Mat A,Mat B,Mat C)
+{
+  PetscErrorCode           ierr;
+  PetscLogDouble           flops = 0.0;
+  Mat_SeqAIJ               *a = (Mat_SeqAIJ*)A->data,*b = (Mat_SeqAIJ*)B->data,*c = (Mat_SeqAIJ*)C->data;
+  const PetscInt           *ai = a->i,*aj = a->j,*bi = b->i,*bj = b->j,*ci = c->i,*cj = c->j;
+  const PetscScalar        *aa = a->a,*ba = b->a;
+  PetscScalar              *ca;
+  Mat_SeqAIJProductThreads *pt;
+  PetscInt                 t,nt,cm = C->rmap->n;
+
+  PetscFunctionBegin;
+  ierr = MatSeqAIJGetProductThreads_Private(C,&pt);CHKERRQ(ierr);
+  if (!c->a) {
+    ierr      = PetscMalloc1(ci[cm]+1,&c->a);CHKERRQ(ierr);
+    c->free_a = PETSC_TRUE;
+  }
+  ca = c->a;
+  nt = pt->nthreads;
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel for num_threads(nt) schedule(static,1) reduction(+:flops)
+#endif
+  for (t=0; t<nt; t++) {
+    PetscScalar    *cai,valtmp;
+    const PetscInt *cji,*bjj;
+    PetscInt       i,j,k,brow,bnz,nextb;
+
+    for (i=pt->rstart[t]; i<pt->rstart[t+1]; i++) {
+      cai = ca + ci[i];
+      cji = cj + ci[i];
+      for (k=0; k<ci[i+1]-ci[i]; k++) cai[k] = 0.0;
+      for (j=ai[i]; j<ai[i+1]; j++) {
+        brow   = aj[j];
+        bnz    = bi[brow+1] - bi[brow];
+        bjj    = bj + bi[brow];
+        valtmp = aa[j];
+        nextb  = 0;
+        for (k=0; nextb<bnz; k++) {
+          if (cji[k] == bjj[nextb]) cai[k] += valtmp*ba[bi[brow]+nextb++];
+        }
+        flops += 2*bnz;
+      }
+    }
+  }
+  ierr = MatAssemblyBegin(C,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(C,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = PetscLogFlops(flops);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
@@ -0,0 +1,585 @@
+/*
+    Provides a supernodal left-looking sparse Cholesky factorization A = L L^H of SeqAIJ and SeqSBAIJ (block size 1) matrices.
+
+    The consecutive columns of L with the same nonzero structure below the diagonal are found from the elimination tree and
+  grouped into supernodes. Each supernode is stored as a dense block, by columns, with the rows of its nonzero structure, so
+  the update of a supernode by each of its descendants is one gemm(), the factorization of its diagonal block one potrf() and
+  the computation of the rows below the diagonal block one trsm(). The triangular solves are done the same way.
+*/
+
+#include <../src/mat/impls/sbaij/seq/sbaij.h>
+#include <petscblaslapack.h>
+
+typedef struct {
+  PetscInt    n;
+  PetscInt    *perm;                /* row k of the permuted matrix is row perm[k] of the matrix */
+  PetscInt    *acptr,*arow,*aidx;   /* lower triangular part of the permuted matrix by columns: column j has the rows arow[acptr[j]],...,arow[acptr[j+1]-1]
+                                       whose values are at aidx[] in the values of the matrix, or at -1-aidx[] for the values that must be conjugated */
+  PetscInt    nsuper;               /* number of supernodes */
+  PetscInt    *sfirst;              /* supernode s has the columns sfirst[s],...,sfirst[s+1]-1 */
+  PetscInt    *rptr,*rows;          /* supernode s has the rows rows[rptr[s]],...,rows[rptr[s+1]-1] in increasing order, its own columns first */
+  PetscInt    *vptr;                /* the dense block of supernode s, stored by columns with leading dimension rptr[s+1]-rptr[s], starts at val[vptr[s]] */
+  PetscInt    *colsuper;            /* supernode of each column */
+  PetscScalar *val;
+  PetscInt    maxcols,maxoff;       /* largest number of columns and of rows below the diagonal block of the supernodes */
+  PetscLogDouble nzl;               /* number of nonzeros of L */
+  PetscInt    *map,*head,*lnext,*pos; /* work space of the numeric factorization */
+  PetscScalar *work;                /* work space of the updates */
+  PetscScalar *swork;               /* work space of the solves with one right hand side */
+} Mat_SeqSupernodal;
+
+static PetscErrorCode MatSeqSupernodalReset_Private(Mat_SeqSupernodal *sn)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree(sn->perm);CHKERRQ(ierr);
+  ierr = PetscFree3(sn->acptr,sn->arow,sn->aidx);CHKERRQ(ierr);
+  ierr = PetscFree4(sn->sfirst,sn->rptr,sn->vptr,sn->colsuper);CHKERRQ(ierr);
+  ierr = PetscFree(sn->rows);CHKERRQ(ierr);
+  ierr = PetscFree(sn->val);CHKERRQ(ierr);
+  ierr = PetscFree4(sn->map,sn->head,sn->lnext,sn->pos);CHKERRQ(ierr);
+  ierr = PetscFree2(sn->work,sn->swork);CHKERRQ(ierr);
+  sn->nsuper = 0;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatDestroy_SeqSupernodal(Mat F)
+{
+  Mat_SeqSupernodal *sn = (Mat_SeqSupernodal*)F->data;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSeqSupernodalReset_Private(sn);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)F,"MatFactorGetSolverType_C",NULL);CHKERRQ(ierr);
+  ierr = PetscFree(F->data);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatView_SeqSupernodal(Mat F,PetscViewer viewer)
+{
+  Mat_SeqSupernodal *sn = (Mat_SeqSupernodal*)F->data;
+  PetscErrorCode    ierr;
+  PetscBool         iascii;
+  PetscViewerFormat format;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
+  if (iascii) {
+    ierr = PetscViewerGetFormat(viewer,&format);CHKERRQ(ierr);
+    if (format == PETSC_VIEWER_ASCII_INFO) {
+      ierr = PetscViewerASCIIPrintf(viewer,"Supernodal Cholesky: %D supernodes, largest supernode %D columns, %g nonzeros in the factor\n",sn->nsuper,sn->maxcols,(double)sn->nzl);CHKERRQ(ierr);
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatGetInfo_SeqSupernodal(Mat F,MatInfoType flag,MatInfo *info)
+{
+  Mat_SeqSupernodal *sn = (Mat_SeqSupernodal*)F->data;
+
+  PetscFunctionBegin;
+  info->block_size        = 1.0;
+  info->nz_used           = sn->nzl;
+  info->nz_allocated      = sn->nsuper ? (PetscLogDouble)sn->vptr[sn->nsuper] : 0.0;
+  info->nz_unneeded       = info->nz_allocated - info->nz_used;
+  info->assemblies        = 0.0;
+  info->mallocs           = 0.0;
+  info->memory            = ((PetscObject)F)->mem;
+  info->fill_ratio_given  = 0.0;
+  info->fill_ratio_needed = 0.0;
+  info->factor_mallocs    = 0.0;
+  PetscFunctionReturn(0);
+}
+
+/*
+   Solves L L^H X = X for the nrhs columns of the permuted right hand sides X with BLAS 3, w is work space of size maxoff*nrhs
+*/
+static PetscErrorCode MatSolve_SeqSupernodal_Private(Mat F,PetscInt nrhs,PetscScalar *x,PetscInt ldx,PetscScalar *w)
+{
+  Mat_SeqSupernodal *sn = (Mat_SeqSupernodal*)F->data;
+  PetscInt          s,c,t,f,*srows;
+  PetscBLASInt      nc,nr,m,nb,ld;
+  PetscScalar       one = 1.0,mone = -1.0,zero = 0.0,*Ls,*xc,*wc;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscBLASIntCast(nrhs,&nb);CHKERRQ(ierr);
+  ierr = PetscBLASIntCast(ldx,&ld);CHKERRQ(ierr);
+  /* L Y = X */
+  for (s=0; s<sn->nsuper; s++) {
+    f     = sn->sfirst[s];
+    srows = sn->rows + sn->rptr[s];
+    Ls    = sn->val + sn->vptr[s];
+    ierr  = PetscBLASIntCast(sn->sfirst[s+1]-f,&nc);CHKERRQ(ierr);
+    ierr  = PetscBLASIntCast(sn->rptr[s+1]-sn->rptr[s],&nr);CHKERRQ(ierr);
+    m     = nr - nc;
+    PetscStackCallBLAS("BLAStrsm",BLAStrsm_("L","L","N","N",&nc,&nb,&one,Ls,&nr,x+f,&ld));
+    if (m) {
+      PetscStackCallBLAS("BLASgemm",BLASgemm_("N","N",&m,&nb,&nc,&one,Ls+nc,&nr,x+f,&ld,&zero,w,&m));
+      for (c=0; c<nrhs; c++) {
+        xc = x + c*ldx; wc = w + c*m;
+        for (t=0; t<m; t++) xc[srows[nc+t]] -= wc[t];
+      }
+    }
+  }
+  /* L^H X = Y */
+  for (s=sn->nsuper-1; s>=0; s--) {
+    f     = sn->sfirst[s];
+    srows = sn->rows + sn->rptr[s];
+    Ls    = sn->val + sn->vptr[s];
+    ierr  = PetscBLASIntCast(sn->sfirst[s+1]-f,&nc);CHKERRQ(ierr);
+    ierr  = PetscBLASIntCast(sn->rptr[s+1]-sn->rptr[s],&nr);CHKERRQ(ierr);
+    m     = nr - nc;
+    if (m) {
+      for (c=0; c<nrhs; c++) {
+        xc = x + c*ldx; wc = w + c*m;
+        for (t=0; t<m; t++) wc[t] = xc[srows[nc+t]];
+      }
+      PetscStackCallBLAS("BLASgemm",BLASgemm_("C","N",&nc,&nb,&m,&mone,Ls+nc,&nr,w,&m,&one,x+f,&ld));
+    }
+    PetscStackCallBLAS("BLAStrsm",BLAStrsm_("L","L","C","N",&nc,&nb,&one,Ls,&nr,x+f,&ld));
+  }
+  ierr = PetscLogFlops(nrhs*(4.0*sn->nzl - 2.0*sn->n));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Solves L L^H x = x for one permuted right hand side; the dense blocks are too thin for BLAS to pay off with a single vector
+*/
+static PetscErrorCode MatSolve_SeqSupernodal_One(Mat F,PetscScalar *x)
+{
+  Mat_SeqSupernodal *sn = (Mat_SeqSupernodal*)F->data;
+  PetscInt          s,j,t,f,nc,nr;
+  const PetscInt    *srows;
+  const PetscScalar *Ls,*Lc;
+  PetscScalar       xj;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  for (s=0; s<sn->nsuper; s++) {
+    f     = sn->sfirst[s];
+    nc    = sn->sfirst[s+1] - f;
+    nr    = sn->rptr[s+1] - sn->rptr[s];
+    srows = sn->rows + sn->rptr[s];
+    Ls    = sn->val + sn->vptr[s];
+    for (j=0; j<nc; j++) {
+      Lc = Ls + j*nr;
+      xj = x[f+j] /= Lc[j];
+      for (t=j+1; t<nr; t++) x[srows[t]] -= Lc[t]*xj;
+    }
+  }
+  for (s=sn->nsuper-1; s>=0; s--) {
+    f     = sn->sfirst[s];
+    nc    = sn->sfirst[s+1] - f;
+    nr    = sn->rptr[s+1] - sn->rptr[s];
+    srows = sn->rows + sn->rptr[s];
+    Ls    = sn->val + sn->vptr[s];
+    for (j=nc-1; j>=0; j--) {
+      Lc = Ls + j*nr;
+      xj = x[f+j];
+      for (t=j+1; t<nr; t++) xj -= PetscConj(Lc[t])*x[srows[t]];
+      x[f+j] = xj/PetscConj(Lc[j]);
+    }
+  }
+  ierr = PetscLogFlops(4.0*sn->nzl - 2.0*sn->n);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSolve_SeqSupernodal(Mat F,Vec b,Vec x)
+{
+  Mat_SeqSupernodal *sn = (Mat_SeqSupernodal*)F->data;
+  PetscInt          k,n = sn->n;
+  const PetscInt    *perm = sn->perm;
+  const PetscScalar *ba;
+  PetscScalar       *xa,*y = sn->swork;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = VecGetArrayRead(b,&ba);CHKERRQ(ierr);
+  for (k=0; k<n; k++) y[k] = ba[perm[k]];
+  ierr = VecRestoreArrayRead(b,&ba);CHKERRQ(ierr);
+  ierr = MatSolve_SeqSupernodal_One(F,y);CHKERRQ(ierr);
+  ierr = VecGetArrayWrite(x,&xa);CHKERRQ(ierr);
+  for (k=0; k<n; k++) xa[perm[k]] = y[k];
+  ierr = VecRestoreArrayWrite(x,&xa);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatMatSolve_SeqSupernodal(Mat F,Mat B,Mat X)
+{
+  Mat_SeqSupernodal *sn = (Mat_SeqSupernodal*)F->data;
+  PetscInt          k,c,n = sn->n,nrhs,ldb,ldx;
+  const PetscInt    *perm = sn->perm;
+  const PetscScalar *ba;
+  PetscScalar       *xa,*y;
+  PetscBool         flg;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompareAny((PetscObject)B,&flg,MATSEQDENSE,MATMPIDENSE,NULL);CHKERRQ(ierr);
+  if (!flg) SETERRQ(PetscObjectComm((PetscObject)B),PETSC_ERR_ARG_WRONG,"Matrix B must be MATDENSE matrix");
+  ierr = PetscObjectTypeCompareAny((PetscObject)X,&flg,MATSEQDENSE,MATMPIDENSE,NULL);CHKERRQ(ierr);
+  if (!flg) SETERRQ(PetscObjectComm((PetscObject)X),PETSC_ERR_ARG_WRONG,"Matrix X must be MATDENSE matrix");
+  ierr = MatGetSize(B,NULL,&nrhs);CHKERRQ(ierr);
+  ierr = MatDenseGetLDA(B,&ldb);CHKERRQ(ierr);
+  ierr = MatDenseGetLDA(X,&ldx);CHKERRQ(ierr);
+  ierr = PetscMalloc1((n+sn->maxoff)*nrhs,&y);CHKERRQ(ierr);
+  ierr = MatDenseGetArrayRead(B,&ba);CHKERRQ(ierr);
+  for (c=0; c<nrhs; c++) {
+    for (k=0; k<n; k++) y[k+c*n] = ba[perm[k]+c*ldb];
+  }
+  ierr = MatDenseRestoreArrayRead(B,&ba);CHKERRQ(ierr);
+  ierr = MatSolve_SeqSupernodal_Private(F,nrhs,y,n,y+n*nrhs);CHKERRQ(ierr);
+  ierr = MatDenseGetArray(X,&xa);CHKERRQ(ierr);
+  for (c=0; c<nrhs; c++) {
+    for (k=0; k<n; k++) xa[perm[k]+c*ldx] = y[k+c*n];
+  }
+  ierr = MatDenseRestoreArray(X,&xa);CHKERRQ(ierr);
+  ierr = PetscFree(y);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatCholeskyFactorNumeric_SeqSupernodal(Mat F,Mat A,const MatFactorInfo *info)
+{
+  Mat_SeqSupernodal *sn = (Mat_SeqSupernodal*)F->data;
+  PetscInt          s,d,dn,j,t,a,b,f,l,p1,p2,*srows,*drows,nsuper = sn->nsuper;
+  PetscInt          *map = sn->map,*head = sn->head,*lnext = sn->lnext,*pos = sn->pos;
+  const PetscInt    *arow = sn->arow,*aidx = sn->aidx;
+  const PetscScalar *aa;
+  PetscScalar       *Ls,*Ld,*Lc,*W = sn->work,*Wc,one = 1.0,zero = 0.0;
+  PetscBLASInt      nc,nr,ncd,nrd,m,k,ierr_lapack;
+  PetscBool         sbaij;
+  PetscLogDouble    flops = 0.0;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject)A,MATSEQSBAIJ,&sbaij);CHKERRQ(ierr);
+  if (sbaij) aa = ((Mat_SeqSBAIJ*)A->data)->a;
+  else aa = ((Mat_SeqAIJ*)A->data)->a;
+  F->factorerrortype = MAT_FACTOR_NOERROR;
+  ierr = PetscArrayzero(sn->val,sn->vptr[nsuper]);CHKERRQ(ierr);
+  for (s=0; s<nsuper; s++) head[s] = -1;
+
+  for (s=0; s<nsuper; s++) {
+    f     = sn->sfirst[s];
+    l     = sn->sfirst[s+1];
+    srows = sn->rows + sn->rptr[s];
+    Ls    = sn->val + sn->vptr[s];
+    ierr  = PetscBLASIntCast(l-f,&nc);CHKERRQ(ierr);
+    ierr  = PetscBLASIntCast(sn->rptr[s+1]-sn->rptr[s],&nr);CHKERRQ(ierr);
+    for (t=0; t<nr; t++) map[srows[t]] = t;
+
+    /* the columns of the matrix */
+    for (j=f; j<l; j++) {
+      Lc = Ls + (j-f)*nr;
+      for (t=sn->acptr[j]; t<sn->acptr[j+1]; t++) {
+        if (aidx[t] >= 0) Lc[map[arow[t]]] += aa[aidx[t]];
+        else Lc[map[arow[t]]] += PetscConj(aa[-1-aidx[t]]);
+      }
+    }
+
+    /* the updates of the descendants whose next rows are columns of this supernode */
+    for (d=head[s]; d>=0; d=dn) {
+      dn    = lnext[d];
+      drows = sn->rows + sn->rptr[d];
+      Ld    = sn->val + sn->vptr[d];
+      ierr  = PetscBLASIntCast(sn->sfirst[d+1]-sn->sfirst[d],&ncd);CHKERRQ(ierr);
+      ierr  = PetscBLASIntCast(sn->rptr[d+1]-sn->rptr[d],&nrd);CHKERRQ(ierr);
+      p1    = pos[d];
+      for (p2=p1; p2<nrd && drows[p2]<l; p2++) ;
+      ierr  = PetscBLASIntCast(nrd-p1,&m);CHKERRQ(ierr);
+      ierr  = PetscBLASIntCast(p2-p1,&k);CHKERRQ(ierr);
+      /* W = L_d(p1:end,:) L_d(p1:p2-1,:)^H */
+      PetscStackCallBLAS("BLASgemm",BLASgemm_("N","C",&m,&k,&ncd,&one,Ld+p1,&nrd,Ld+p1,&nrd,&zero,W,&m));
+      flops += 2.0*m*k*ncd;
+      for (b=0; b<k; b++) {
+        Lc = Ls + (drows[p1+b]-f)*nr;
+        Wc = W + b*m;
+        for (a=b; a<m; a++) Lc[map[drows[p1+a]]] -= Wc[a];
+      }
+      if (p2 < nrd) {
+        pos[d]   = p2;
+        t        = sn->colsuper[drows[p2]];
+        lnext[d] = head[t];
+        head[t]  = d;
+      }
+    }
+
+    ierr = PetscFPTrapPush(PETSC_FP_TRAP_OFF);CHKERRQ(ierr);
+    PetscStackCallBLAS("LAPACKpotrf",LAPACKpotrf_("L",&nc,Ls,&nr,&ierr_lapack));
+    ierr = PetscFPTrapPop();CHKERRQ(ierr);
+    if (ierr_lapack) {
+      j = f + ierr_lapack - 1;
+      if (A->erroriffailure) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_MAT_CH_ZRPVT,"Matrix is not positive definite, zero or negative pivot in row %D value %g",sn->perm[j],(double)PetscRealPart(Ls[(j-f)*(nr+1)]));
+      ierr = PetscInfo2(A,"Matrix is not positive definite, zero or negative pivot in row %D value %g\n",sn->perm[j],(double)PetscRealPart(Ls[(j-f)*(nr+1)]));CHKERRQ(ierr);
+      F->factorerrortype             = MAT_FACTOR_NUMERIC_ZEROPIVOT;
+      F->factorerror_zeropivot_value = PetscAbsScalar(Ls[(j-f)*(nr+1)]);
+      F->factorerror_zeropivot_row   = sn->perm[j];
+      break;
+    }
+    flops += nc*(nc+1.0)*(2.0*nc+1.0)/6.0;
+    if (nr > nc) {
+      m = nr - nc;
+      PetscStackCallBLAS("BLAStrsm",BLAStrsm_("R","L","C","N",&m,&nc,&one,Ls,&nr,Ls+nc,&nr));
+      flops   += 1.0*m*nc*nc;
+      pos[s]   = nc;
+      t        = sn->colsuper[srows[nc]];
+      lnext[s] = head[t];
+      head[t]  = s;
+    }
+  }
+  ierr = PetscLogFlops(flops);CHKERRQ(ierr);
+
+  F->ops->solve    = MatSolve_SeqSupernodal;
+  F->ops->matsolve = MatMatSolve_SeqSupernodal;
+#if !defined(PETSC_USE_COMPLEX)
+  F->ops->solvetranspose    = MatSolve_SeqSupernodal;
+  F->ops->matsolvetranspose = MatMatSolve_SeqSupernodal;
+#endif
+  F->assembled    = PETSC_TRUE;
+  F->preallocated = PETSC_TRUE;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatCholeskyFactorSymbolic_SeqSupernodal(Mat F,Mat A,IS perm,const MatFactorInfo *info)
+{
+  Mat_SeqSupernodal *sn = (Mat_SeqSupernodal*)F->data;
+  PetscInt          n = A->rmap->n,i,j,k,r,c,t,s,nsuper,nzrows,*iperm,*lptr,*lcol,*parent,*anc,*mark,*cc,*cpos,*rpos;
+  const PetscInt    *ai,*aj,*pidx;
+  PetscBool         sbaij;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = MatSeqSupernodalReset_Private(sn);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject)A,MATSEQSBAIJ,&sbaij);CHKERRQ(ierr);
+  if (sbaij) {
+    ai = ((Mat_SeqSBAIJ*)A->data)->i;
+    aj = ((Mat_SeqSBAIJ*)A->data)->j;
+  } else {
+    ai = ((Mat_SeqAIJ*)A->data)->i;
+    aj = ((Mat_SeqAIJ*)A->data)->j;
+  }
+  sn->n = n;
+  ierr = PetscMalloc1(n,&sn->perm);CHKERRQ(ierr);
+  ierr = PetscMalloc4(n,&iperm,n,&parent,n,&anc,n,&mark);CHKERRQ(ierr);
+  if (perm) {
+    ierr = ISGetIndices(perm,&pidx);CHKERRQ(ierr);
+    ierr = PetscArraycpy(sn->perm,pidx,n);CHKERRQ(ierr);
+    ierr = ISRestoreIndices(perm,&pidx);CHKERRQ(ierr);
+  } else {
+    for (k=0; k<n; k++) sn->perm[k] = k;
+  }
+  for (k=0; k<n; k++) iperm[sn->perm[k]] = k;
+
+  /* lower triangular part of the permuted matrix, by columns for the values and by rows (without the diagonal) for the structure;
+     the upper triangular part of a SeqSBAIJ matrix is mirrored, while only the lower triangular part of a SeqAIJ matrix is used */
+  ierr = PetscCalloc1(n+1,&lptr);CHKERRQ(ierr);
+  ierr = PetscCalloc3(n+1,&sn->acptr,ai[n],&sn->arow,ai[n],&sn->aidx);CHKERRQ(ierr);
+  for (r=0; r<n; r++) {
+    for (t=ai[r]; t<ai[r+1]; t++) {
+      i = iperm[r]; j = iperm[aj[t]];
+      if (i < j) {
+        if (!sbaij) continue;
+        k = i; i = j; j = k;
+      }
+      sn->acptr[j+1]++;
+      if (i > j) lptr[i+1]++;
+    }
+  }
+  for (k=0; k<n; k++) {
+    sn->acptr[k+1] += sn->acptr[k];
+    lptr[k+1]      += lptr[k];
+  }
+  ierr = PetscMalloc1(lptr[n],&lcol);CHKERRQ(ierr);
+  ierr = PetscMalloc2(n,&cpos,n,&rpos);CHKERRQ(ierr);
+  ierr = PetscArraycpy(cpos,sn->acptr,n);CHKERRQ(ierr);
+  ierr = PetscArraycpy(rpos,lptr,n);CHKERRQ(ierr);
+  for (r=0; r<n; r++) {
+    for (t=ai[r]; t<ai[r+1]; t++) {
+      i = iperm[r]; j = iperm[aj[t]];
+      if (i < j) {
+        if (!sbaij) continue;
+        k = i; i = j; j = k;
+        sn->aidx[cpos[j]] = -1-t;
+      } else sn->aidx[cpos[j]] = t;
+      sn->arow[cpos[j]++] = i;
+      if (i > j) lcol[rpos[i]++] = j;
+    }
+  }
+
+  /* elimination tree, with path compression through the ancestors anc[] */
+  for (k=0; k<n; k++) {
+    parent[k] = -1;
+    anc[k]    = -1;
+    for (t=lptr[k]; t<lptr[k+1]; t++) {
+      for (j=lcol[t]; j!=-1 && j<k; j=i) {
+        i      = anc[j];
+        anc[j] = k;
+        if (i == -1) parent[j] = k;
+      }
+    }
+  }
+
+  /* number of nonzeros below the diagonal of each column of L, from the row subtrees of the elimination tree */
+  ierr = PetscCalloc1(n,&cc);CHKERRQ(ierr);
+  for (i=0; i<n; i++) {
+    mark[i] = i;
+    for (t=lptr[i]; t<lptr[i+1]; t++) {
+      for (k=lcol[t]; mark[k]!=i; k=parent[k]) {
+        mark[k] = i;
+        cc[k]++;
+      }
+    }
+  }
+
+  /* fundamental supernodes: column j joins the supernode of column j-1 if it is its parent and L(:,j-1) has the structure of L(:,j) plus j */
+  nsuper = 0;
+  for (j=0; j<n; j++) {
+    if (!j || parent[j-1] != j || cc[j-1] != cc[j]+1) nsuper++;
+  }
+  sn->nsuper = nsuper;
+  ierr = PetscMalloc4(nsuper+1,&sn->sfirst,nsuper+1,&sn->rptr,nsuper+1,&sn->vptr,n,&sn->colsuper);CHKERRQ(ierr);
+  sn->maxcols = 0;
+  sn->maxoff  = 0;
+  sn->nzl     = 0.0;
+  s           = -1;
+  for (j=0; j<n; j++) {
+    if (!j || parent[j-1] != j || cc[j-1] != cc[j]+1) sn->sfirst[++s] = j;
+    sn->colsuper[j] = s;
+  }
+  sn->sfirst[nsuper] = n;
+  sn->rptr[0] = 0;
+  sn->vptr[0] = 0;
+  for (s=0; s<nsuper; s++) {
+    c              = sn->sfirst[s+1] - sn->sfirst[s];
+    k              = cc[sn->sfirst[s+1]-1];
+    sn->rptr[s+1]  = sn->rptr[s] + c + k;
+    sn->vptr[s+1]  = sn->vptr[s] + (c + k)*c;
+    sn->maxcols    = PetscMax(sn->maxcols,c);
+    sn->maxoff     = PetscMax(sn->maxoff,k);
+    sn->nzl       += c*(c+1.0)/2.0 + 1.0*c*k;
+  }
+
+  /* rows of the supernodes: the columns, then the rows below found when the row subtrees visit the last column of the supernode */
+  nzrows = sn->rptr[nsuper];
+  ierr = PetscMalloc1(nzrows,&sn->rows);CHKERRQ(ierr);
+  for (s=0; s<nsuper; s++) {
+    for (j=sn->sfirst[s]; j<sn->sfirst[s+1]; j++) sn->rows[sn->rptr[s]+j-sn->sfirst[s]] = j;
+    rpos[s] = sn->rptr[s] + sn->sfirst[s+1] - sn->sfirst[s];
+  }
+  for (i=0; i<n; i++) mark[i] = -1;
+  for (i=0; i<n; i++) {
+    mark[i] = i;
+    for (t=lptr[i]; t<lptr[i+1]; t++) {
+      for (k=lcol[t]; mark[k]!=i; k=parent[k]) {
+        mark[k] = i;
+        s       = sn->colsuper[k];
+        if (k == sn->sfirst[s+1]-1) sn->rows[rpos[s]++] = i;
+      }
+    }
+  }
+
+  ierr = PetscFree(cc);CHKERRQ(ierr);
+  ierr = PetscFree2(cpos,rpos);CHKERRQ(ierr);
+  ierr = PetscFree(lcol);CHKERRQ(ierr);
+  ierr = PetscFree(lptr);CHKERRQ(ierr);
+  ierr = PetscFree4(iperm,parent,anc,mark);CHKERRQ(ierr);
+
+  ierr = PetscMalloc1(sn->vptr[nsuper],&sn->val);CHKERRQ(ierr);
+  ierr = PetscMalloc4(n,&sn->map,nsuper,&sn->head,nsuper,&sn->lnext,nsuper,&sn->pos);CHKERRQ(ierr);
+  ierr = PetscMalloc2(sn->maxoff*PetscMin(sn->maxoff,sn->maxcols),&sn->work,n,&sn->swork);CHKERRQ(ierr);
+  ierr = PetscLogObjectMemory((PetscObject)F,sn->vptr[nsuper]*sizeof(PetscScalar)+(nzrows+n)*sizeof(PetscInt));CHKERRQ(ierr);
+  ierr = PetscInfo4(F,"%D supernodes, largest supernode %D columns, %g nonzeros in the factor, %D nonzeros stored\n",nsuper,sn->maxcols,(double)sn->nzl,sn->vptr[nsuper]);CHKERRQ(ierr);
+
+  F->ops->choleskyfactornumeric = MatCholeskyFactorNumeric_SeqSupernodal;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatFactorGetSolverType_seqaij_supernodal(Mat A,MatSolverType *type)
+{
+  PetscFunctionBegin;
+  *type = MATSOLVERSUPERNODAL;
+  PetscFunctionReturn(0);
+}
+
+/*MC
+  MATSOLVERSUPERNODAL = "supernodal" - A supernodal left-looking sparse Cholesky factorization of sequential matrices that does
+  its dense work with the BLAS 3 and LAPACK kernels gemm(), trsm() and potrf()
+
+  Works with MATSEQAIJ and MATSEQSBAIJ (block size 1) matrices
+
+  Use -pc_type cholesky -pc_factor_mat_solver_type supernodal to use this direct solver, for example on the coarse grid of PCMG with
+  -mg_coarse_pc_type cholesky -mg_coarse_pc_factor_mat_solver_type supernodal
+
+  Level: intermediate
+
+  Notes:
+    The matrix must be symmetric (Hermitian for complex numbers) positive definite. Only the lower triangular part of a MATSEQAIJ
+    matrix, after the ordering, is used.
+
+    The supernodes are the fundamental supernodes of the elimination tree, so a fill reducing ordering, for example
+    -pc_factor_mat_ordering_type nd, gives both less fill and larger supernodes.
+
+    The shift options of PCFactor are not used.
+
+.seealso: PCCholesky, PCFactorSetMatSolverType(), MatSolverType, MATSOLVERPETSC, MATSOLVERCHOLMOD
+M*/
+
+static PetscErrorCode MatGetFactor_seq_supernodal(Mat A,MatFactorType ftype,Mat *F)
+{
+  Mat               B;
+  Mat_SeqSupernodal *sn;
+  PetscInt          n = A->rmap->n,bs;
+  const char        *prefix;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  if (ftype != MAT_FACTOR_CHOLESKY) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Factor type not supported");
+  ierr = MatGetBlockSize(A,&bs);CHKERRQ(ierr);
+  if (bs != 1) SETERRQ1(PetscObjectComm((PetscObject)A),PETSC_ERR_SUP,"Only block size 1 is supported, given %D",bs);
+#if defined(PETSC_USE_COMPLEX)
+  if (!A->hermitian) SETERRQ(PetscObjectComm((PetscObject)A),PETSC_ERR_SUP,"Only for Hermitian matrices");
+#endif
+  ierr = MatCreate(PetscObjectComm((PetscObject)A),&B);CHKERRQ(ierr);
+  ierr = MatSetSizes(B,n,n,n,n);CHKERRQ(ierr);
+  ierr = PetscStrallocpy(MATSOLVERSUPERNODAL,&((PetscObject)B)->type_name);CHKERRQ(ierr);
+  ierr = MatGetOptionsPrefix(A,&prefix);CHKERRQ(ierr);
+  ierr = MatSetOptionsPrefix(B,prefix);CHKERRQ(ierr);
+  ierr = MatSetUp(B);CHKERRQ(ierr);
+  ierr = PetscNewLog(B,&sn);CHKERRQ(ierr);
+  B->data = sn;
+
+  B->ops->getinfo                = MatGetInfo_SeqSupernodal;
+  B->ops->view                   = MatView_SeqSupernodal;
+  B->ops->choleskyfactorsymbolic = MatCholeskyFactorSymbolic_SeqSupernodal;
+  B->ops->destroy                = MatDestroy_SeqSupernodal;
+  ierr = PetscObjectComposeFunction((PetscObject)B,"MatFactorGetSolverType_C",MatFactorGetSolverType_seqaij_supernodal);CHKERRQ(ierr);
+  B->factortype   = MAT_FACTOR_CHOLESKY;
+  B->assembled    = PETSC_TRUE;
+  B->preallocated = PETSC_TRUE;
+  B->useordering  = PETSC_TRUE;
+
+  ierr = PetscFree(B->solvertype);CHKERRQ(ierr);
+  ierr = PetscStrallocpy(MATSOLVERSUPERNODAL,&B->solvertype);CHKERRQ(ierr);
+  *F   = B;
+  PetscFunctionReturn(0);
+}
+
+PETSC_INTERN PetscErrorCode MatGetFactor_seqaij_supernodal(Mat A,MatFactorType ftype,Mat *F)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatGetFactor_seq_supernodal(A,ftype,F);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PETSC_INTERN PetscErrorCode MatGetFactor_seqsbaij_supernodal(Mat A,MatFactorType ftype,Mat *F)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatGetFactor_seq_supernodal(A,ftype,F);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
@@ -32,6 +32,17 @@ PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJPERM(Mat);
 PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJSELL(Mat);
 PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJSELL(Mat);
 
+PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJOMP(Mat);
+PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJOMP(Mat);
+PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJMixed(Mat);
+PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJMixed(Mat);
+PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJAuto(Mat);
+PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJAuto(Mat);
+PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJVBlock(Mat);
+PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJVBlock(Mat);
+PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJDelta(Mat);
+PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJDelta(Mat);
+
 #if defined(PETSC_HAVE_MKL_SPARSE)
 PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJMKL(Mat);
 PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJMKL(Mat);
@@ -128,6 +139,26 @@ PetscErrorCode  MatRegisterAll(void)
   ierr = MatRegister(MATMPIAIJSELL,     MatCreate_MPIAIJSELL);CHKERRQ(ierr);
   ierr = MatRegister(MATSEQAIJSELL,     MatCreate_SeqAIJSELL);CHKERRQ(ierr);
 
+  ierr = MatRegisterRootName(MATAIJOMP, MATSEQAIJOMP,MATMPIAIJOMP);CHKERRQ(ierr);
+  ierr = MatRegister(MATMPIAIJOMP,      MatCreate_MPIAIJOMP);CHKERRQ(ierr);
+  ierr = MatRegister(MATSEQAIJOMP,      MatCreate_SeqAIJOMP);CHKERRQ(ierr);
+
+  ierr = MatRegisterRootName(MATAIJMIXED, MATSEQAIJMIXED,MATMPIAIJMIXED);CHKERRQ(ierr);
+  ierr = MatRegister(MATMPIAIJMIXED,    MatCreate_MPIAIJMixed);CHKERRQ(ierr);
+  ierr = MatRegister(MATSEQAIJMIXED,    MatCreate_SeqAIJMixed);CHKERRQ(ierr);
+
+  ierr = MatRegisterRootName(MATAIJAUTO, MATSEQAIJAUTO,MATMPIAIJAUTO);CHKERRQ(ierr);
+  ierr = MatRegister(MATMPIAIJAUTO,     MatCreate_MPIAIJAuto);CHKERRQ(ierr);
+  ierr = MatRegister(MATSEQAIJAUTO,     MatCreate_SeqAIJAuto);CHKERRQ(ierr);
+
+  ierr = MatRegisterRootName(MATAIJVBLOCK, MATSEQAIJVBLOCK,MATMPIAIJVBLOCK);CHKERRQ(ierr);
+  ierr = MatRegister(MATMPIAIJVBLOCK,   MatCreate_MPIAIJVBlock);CHKERRQ(ierr);
+  ierr = MatRegister(MATSEQAIJVBLOCK,   MatCreate_SeqAIJVBlock);CHKERRQ(ierr);
+
+  ierr = MatRegisterRootName(MATAIJDELTA, MATSEQAIJDELTA,MATMPIAIJDELTA);CHKERRQ(ierr);
+  ierr = MatRegister(MATMPIAIJDELTA,    MatCreate_MPIAIJDelta);CHKERRQ(ierr);
+  ierr = MatRegister(MATSEQAIJDELTA,    MatCreate_SeqAIJDelta);CHKERRQ(ierr);
+
 #if defined(PETSC_HAVE_MKL_SPARSE)
   ierr = MatRegisterRootName(MATAIJMKL, MATSEQAIJMKL,MATMPIAIJMKL);CHKERRQ(ierr);
   ierr = MatRegister(MATMPIAIJMKL,      MatCreate_MPIAIJMKL);CHKERRQ(ierr);
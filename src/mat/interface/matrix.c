@@ -17,7 +17,7 @@ PetscLogEvent MAT_MultTransposeConstrained, MAT_MultTransposeAdd, MAT_Solve, MAT
 PetscLogEvent MAT_SolveTransposeAdd, MAT_SOR, MAT_ForwardSolve, MAT_BackwardSolve, MAT_LUFactor, MAT_LUFactorSymbolic;
 PetscLogEvent MAT_LUFactorNumeric, MAT_CholeskyFactor, MAT_CholeskyFactorSymbolic, MAT_CholeskyFactorNumeric, MAT_ILUFactor;
 PetscLogEvent MAT_ILUFactorSymbolic, MAT_ICCFactorSymbolic, MAT_Copy, MAT_Convert, MAT_Scale, MAT_AssemblyBegin;
-PetscLogEvent MAT_AssemblyEnd, MAT_SetValues, MAT_GetValues, MAT_GetRow, MAT_GetRowIJ, MAT_CreateSubMats, MAT_GetOrdering, MAT_RedundantMat, MAT_GetSeqNonzeroStructure;
+PetscLogEvent MAT_AssemblyEnd, MAT_SetValues, MAT_PreallCOO, MAT_SetVCOO, MAT_GetValues, MAT_GetRow, MAT_GetRowIJ, MAT_CreateSubMats, MAT_GetOrdering, MAT_RedundantMat, MAT_GetSeqNonzeroStructure;
 PetscLogEvent MAT_IncreaseOverlap, MAT_Partitioning, MAT_PartitioningND, MAT_Coarsen, MAT_ZeroEntries, MAT_Load, MAT_View, MAT_AXPY, MAT_FDColoringCreate;
 PetscLogEvent MAT_FDColoringSetUp, MAT_FDColoringApply,MAT_Transpose,MAT_FDColoringFunction, MAT_CreateSubMat;
 PetscLogEvent MAT_TransposeColoringCreate;
@@ -3921,13 +3921,21 @@ PetscErrorCode MatSolveTransposeAdd(Mat mat,Vec b,Vec y,Vec x)
 .     SOR_APPLY_UPPER, SOR_APPLY_LOWER - applies
          upper/lower triangular part of matrix to
          vector (with omega)
--     SOR_ZERO_INITIAL_GUESS - zero initial guess
+.     SOR_ZERO_INITIAL_GUESS - zero initial guess
+-     SOR_MULTICOLOR - with the forward, backward and symmetric sweeps, relaxes the rows color by color
+         so that the rows of each color are relaxed at the same time by threads (AIJ matrices only, ignored by other formats)
 
    Notes:
    SOR_LOCAL_FORWARD_SWEEP, SOR_LOCAL_BACKWARD_SWEEP, and
    SOR_LOCAL_SYMMETRIC_SWEEP perform separate independent smoothings
    on each processor.
 
+   SOR_MULTICOLOR colors the rows of the (local) matrix so that the rows of each color are not coupled, and sweeps
+   the colors in order (in reverse order for the backward sweep). The rows of each color are relaxed by
+   -mat_sor_threads <n> OpenMP threads. The colors are computed by MatColoring (see -mat_sor_coloring_type <greedy>)
+   on the first use after each change of the nonzero structure. This is Gauss-Seidel in a different ordering of the
+   unknowns, so it usually needs a few more iterations than the natural ordering.
+
    Application programmers will not generally use MatSOR() directly,
    but instead will employ the KSP/PC interface.
 
@@ -0,0 +1,113 @@
+static char help[] = "Tests MatMult(), MatMultAdd(), MatMultTranspose() and MatMultTransposeAdd() for MATAIJOMP against MATAIJ.\n\
+Input parameters include\n\
+  -m <m> : number of grid points in each direction\n\
+  -empty <k> : only fill every k-th row so that the compressed row format is used\n\
+  -nested : also compare the transpose products called from inside an OpenMP parallel region\n\n";
+
+#include <petscmat.h>
+#if defined(PETSC_HAVE_OPENMP)
+#include <omp.h>
+#endif
+
+int main(int argc,char **args)
+{
+  Mat            A,B;
+  PetscInt       i,j,k,Ii,J,m = 8,empty = 0,rstart,rend;
+  PetscScalar    v;
+#if defined(PETSC_USE_COMPLEX)
+  PetscScalar    shift = 0.1*PETSC_i;
+#else
+  PetscScalar    shift = 0.1;
+#endif
+  PetscBool      flg,nested = PETSC_FALSE;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-empty",&empty,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-nested",&nested,NULL);CHKERRQ(ierr);
+
+  /* 2d Laplacian with an extra long-range coupling, so rows have different lengths */
+  ierr = MatCreate(PETSC_COMM_WORLD,&A);CHKERRQ(ierr);
+  ierr = MatSetSizes(A,PETSC_DECIDE,PETSC_DECIDE,m*m,m*m);CHKERRQ(ierr);
+  ierr = MatSetType(A,MATAIJ);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation(A,6,NULL);CHKERRQ(ierr);
+  ierr = MatMPIAIJSetPreallocation(A,6,NULL,6,NULL);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(A,&rstart,&rend);CHKERRQ(ierr);
+  for (Ii=rstart; Ii<rend; Ii++) {
+    if (empty && (Ii%empty)) continue;
+    i = Ii/m; j = Ii - i*m;
+    if (i>0)   {J = Ii - m; v = -1.0 + shift; ierr = MatSetValues(A,1,&Ii,1,&J,&v,ADD_VALUES);CHKERRQ(ierr);}
+    if (i<m-1) {J = Ii + m; v = -1.0; ierr = MatSetValues(A,1,&Ii,1,&J,&v,ADD_VALUES);CHKERRQ(ierr);}
+    if (j>0)   {J = Ii - 1; v = -1.0; ierr = MatSetValues(A,1,&Ii,1,&J,&v,ADD_VALUES);CHKERRQ(ierr);}
+    if (j<m-1) {J = Ii + 1; v = -1.0 - 2.0*shift; ierr = MatSetValues(A,1,&Ii,1,&J,&v,ADD_VALUES);CHKERRQ(ierr);}
+    if (!(Ii%3)) {J = (Ii + m*m/2)%(m*m); v = 0.5; ierr = MatSetValues(A,1,&Ii,1,&J,&v,ADD_VALUES);CHKERRQ(ierr);}
+    v = 4.0 + Ii; ierr = MatSetValues(A,1,&Ii,1,&Ii,&v,ADD_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+
+  for (k=0; k<2; k++) {
+    ierr = MatConvert(A,MATAIJOMP,MAT_INITIAL_MATRIX,&B);CHKERRQ(ierr);
+    if (k) { /* change the values and reassemble, the partition must be kept up to date */
+      ierr = MatScale(B,2.0);CHKERRQ(ierr);
+      ierr = MatScale(A,2.0);CHKERRQ(ierr);
+      ierr = MatAssemblyBegin(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+      ierr = MatAssemblyEnd(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+    }
+    ierr = MatMultEqual(A,B,5,&flg);CHKERRQ(ierr);
+    if (!flg) {ierr = PetscPrintf(PETSC_COMM_WORLD,"Error in MatMult()\n");CHKERRQ(ierr);}
+    ierr = MatMultAddEqual(A,B,5,&flg);CHKERRQ(ierr);
+    if (!flg) {ierr = PetscPrintf(PETSC_COMM_WORLD,"Error in MatMultAdd()\n");CHKERRQ(ierr);}
+    ierr = MatMultTransposeEqual(A,B,5,&flg);CHKERRQ(ierr);
+    if (!flg) {ierr = PetscPrintf(PETSC_COMM_WORLD,"Error in MatMultTranspose()\n");CHKERRQ(ierr);}
+    ierr = MatMultTransposeAddEqual(A,B,5,&flg);CHKERRQ(ierr);
+    if (!flg) {ierr = PetscPrintf(PETSC_COMM_WORLD,"Error in MatMultTransposeAdd()\n");CHKERRQ(ierr);}
+#if defined(PETSC_HAVE_OPENMP)
+    if (nested) {
+      PetscErrorCode ierrt = 0,ierrta = 0;
+      PetscBool      flgt = PETSC_FALSE,flgta = PETSC_FALSE;
+
+      /* the kernels are then in a nested region whose team has a single thread, fewer than -mat_aijomp_threads */
+      omp_set_max_active_levels(1);
+#pragma omp parallel num_threads(2)
+#pragma omp single
+      {
+        ierrt  = MatMultTransposeEqual(A,B,5,&flgt);
+        ierrta = MatMultTransposeAddEqual(A,B,5,&flgta);
+      }
+      CHKERRQ(ierrt);CHKERRQ(ierrta);
+      if (!flgt) {ierr = PetscPrintf(PETSC_COMM_WORLD,"Error in nested MatMultTranspose()\n");CHKERRQ(ierr);}
+      if (!flgta) {ierr = PetscPrintf(PETSC_COMM_WORLD,"Error in nested MatMultTransposeAdd()\n");CHKERRQ(ierr);}
+    }
+#endif
+    ierr = MatDestroy(&B);CHKERRQ(ierr);
+  }
+
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      suffix: 1
+      args: -mat_aijomp_threads 3
+
+   test:
+      suffix: 2
+      nsize: 2
+      args: -mat_aijomp_threads 2 -empty 5
+
+   test:
+      suffix: 3
+      args: -mat_aijomp_threads 4 -empty 3 -m 5
+
+   test:
+      suffix: nested
+      requires: openmp
+      args: -mat_aijomp_threads 4 -nested
+      output_file: output/ex302_1.out
+
+TEST*/
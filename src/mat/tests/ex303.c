@@ -0,0 +1,107 @@
+static char help[] = "Tests MatSetPreallocationCOO() and MatSetValuesCOO() against MatSetValues().\n\
+Input parameters include\n\
+  -n <n> : number of elements of the one dimensional mesh\n\n";
+
+#include <petscmat.h>
+
+/* Sets the same values as MatSetValuesCOO() with MatSetValues() */
+static PetscErrorCode SetValuesReference(Mat B,PetscInt ncoo,const PetscInt coo_i[],const PetscInt coo_j[],const PetscScalar coo_v[],InsertMode imode)
+{
+  PetscInt       k;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (imode == INSERT_VALUES) {ierr = MatZeroEntries(B);CHKERRQ(ierr);}
+  for (k=0; k<ncoo; k++) {
+    ierr = MatSetValues(B,1,coo_i+k,1,coo_j+k,coo_v+k,ADD_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **args)
+{
+  Mat            A,B;
+  PetscInt       n = 20,N,nel = PETSC_DECIDE,estart,e,k,ncoo,*coo_i,*coo_j;
+  PetscScalar    *coo_v;
+  PetscInt       pass;
+  PetscBool      flg;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  N    = n+1;
+
+  /* each process owns a contiguous set of linear elements, the rows of the shared nodes are owned by one of them only;
+     every element also couples to a far away node, to populate the off-diagonal block, and has one ignored entry */
+  ierr = PetscSplitOwnership(PETSC_COMM_WORLD,&nel,&n);CHKERRQ(ierr);
+  ierr = MPI_Scan(&nel,&estart,1,MPIU_INT,MPI_SUM,PETSC_COMM_WORLD);CHKERRQ(ierr);
+  estart -= nel;
+  ncoo  = 7*nel;
+  ierr = PetscMalloc3(ncoo,&coo_i,ncoo,&coo_j,ncoo,&coo_v);CHKERRQ(ierr);
+  for (e=estart,k=0; e<estart+nel; e++) {
+    coo_i[k] = e;   coo_j[k++] = e;
+    coo_i[k] = e;   coo_j[k++] = e+1;
+    coo_i[k] = e+1; coo_j[k++] = e;
+    coo_i[k] = e+1; coo_j[k++] = e+1;
+    coo_i[k] = e;   coo_j[k++] = (e+N/2)%N;
+    coo_i[k] = (e+N/2)%N; coo_j[k++] = e;
+    coo_i[k] = -1;  coo_j[k++] = e;
+  }
+
+  ierr = MatCreate(PETSC_COMM_WORLD,&A);CHKERRQ(ierr);
+  ierr = MatSetSizes(A,PETSC_DECIDE,PETSC_DECIDE,N,N);CHKERRQ(ierr);
+  ierr = MatSetFromOptions(A);CHKERRQ(ierr);
+  ierr = MatSetPreallocationCOO(A,ncoo,coo_i,coo_j);CHKERRQ(ierr);
+
+  ierr = MatCreate(PETSC_COMM_WORLD,&B);CHKERRQ(ierr);
+  ierr = MatSetSizes(B,PETSC_DECIDE,PETSC_DECIDE,N,N);CHKERRQ(ierr);
+  ierr = MatSetType(B,MATAIJ);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation(B,8,NULL);CHKERRQ(ierr);
+  ierr = MatMPIAIJSetPreallocation(B,8,NULL,8,NULL);CHKERRQ(ierr);
+
+  for (pass=0; pass<3; pass++) {
+    InsertMode imode = pass == 1 ? ADD_VALUES : INSERT_VALUES;
+
+    for (k=0; k<ncoo; k++) coo_v[k] = 1.0 + pass + 0.1*(estart*7+k);
+    ierr = MatSetValuesCOO(A,coo_v,imode);CHKERRQ(ierr);
+    ierr = SetValuesReference(B,ncoo,coo_i,coo_j,coo_v,imode);CHKERRQ(ierr);
+    ierr = MatMultEqual(A,B,5,&flg);CHKERRQ(ierr);
+    if (!flg) {ierr = PetscPrintf(PETSC_COMM_WORLD,"Error in MatSetValuesCOO() with %s\n",imode == INSERT_VALUES ? "INSERT_VALUES" : "ADD_VALUES");CHKERRQ(ierr);}
+    ierr = MatMultTransposeEqual(A,B,5,&flg);CHKERRQ(ierr);
+    if (!flg) {ierr = PetscPrintf(PETSC_COMM_WORLD,"Error in MatSetValuesCOO() with %s, transpose\n",imode == INSERT_VALUES ? "INSERT_VALUES" : "ADD_VALUES");CHKERRQ(ierr);}
+  }
+
+  ierr = PetscFree3(coo_i,coo_j,coo_v);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = MatDestroy(&B);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      suffix: 1
+      args: -n 6
+
+   test:
+      suffix: 2
+      nsize: 3
+      args: -n 6
+      output_file: output/ex303_1.out
+
+   test:
+      suffix: baij
+      nsize: 2
+      args: -n 6 -mat_type baij
+      output_file: output/ex303_1.out
+
+   test:
+      suffix: aijomp
+      nsize: 2
+      args: -n 6 -mat_type aijomp
+      output_file: output/ex303_1.out
+
+TEST*/
@@ -0,0 +1,187 @@
+static char help[] = "Tests the level scheduled triangular solves (-lev_mat_solve_level_threads) of SeqAIJ factors against the sequential ones.\n\
+Input parameters include\n\
+  -m <m>          : number of grid points in each direction\n\
+  -factor <type>  : lu, ilu, cholesky or icc\n\
+  -ordering <ord> : matrix ordering used by the factorization\n\n";
+
+#include <petscmat.h>
+
+int main(int argc,char **args)
+{
+  Mat            A,Alev,F,Flev,B,X,Xlev;
+  Vec            b,x,xlev;
+  IS             row,col;
+  MatFactorInfo  info;
+  MatFactorType  ftype = MAT_FACTOR_ILU;
+  char           factor[16] = "ilu",ordering[256] = MATORDERINGND;
+  PetscInt       i,j,Ii,J,m = 10,nrhs = 5,rstart,rend;
+  PetscScalar    v;
+  PetscReal      nrm,err = 0.0;
+  PetscBool      cholesky,flg;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetString(NULL,NULL,"-factor",factor,sizeof(factor),NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetString(NULL,NULL,"-ordering",ordering,sizeof(ordering),NULL);CHKERRQ(ierr);
+  ierr = PetscStrcmp(factor,"lu",&flg);CHKERRQ(ierr);
+  if (flg) ftype = MAT_FACTOR_LU;
+  ierr = PetscStrcmp(factor,"cholesky",&flg);CHKERRQ(ierr);
+  if (flg) ftype = MAT_FACTOR_CHOLESKY;
+  ierr = PetscStrcmp(factor,"icc",&flg);CHKERRQ(ierr);
+  if (flg) ftype = MAT_FACTOR_ICC;
+  cholesky = (PetscBool)(ftype == MAT_FACTOR_CHOLESKY || ftype == MAT_FACTOR_ICC);
+
+  /* 2d Laplacian, with a convection term when the factors are not symmetric, plus a far away coupling to create long dependency chains */
+  ierr = MatCreateSeqAIJ(PETSC_COMM_SELF,m*m,m*m,7,NULL,&A);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(A,&rstart,&rend);CHKERRQ(ierr);
+  for (Ii=rstart; Ii<rend; Ii++) {
+    i = Ii/m; j = Ii - i*m;
+    if (i>0)   {J = Ii - m; v = -1.0; ierr = MatSetValues(A,1,&Ii,1,&J,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    if (i<m-1) {J = Ii + m; v = -1.0; ierr = MatSetValues(A,1,&Ii,1,&J,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    if (j>0)   {J = Ii - 1; v = cholesky ? -1.0 : -1.5; ierr = MatSetValues(A,1,&Ii,1,&J,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    if (j<m-1) {J = Ii + 1; v = cholesky ? -1.0 : -0.5; ierr = MatSetValues(A,1,&Ii,1,&J,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    J = (Ii + m*m/2) % (m*m);
+    if (J != Ii) {
+      v = -0.1;
+      ierr = MatSetValues(A,1,&Ii,1,&J,&v,INSERT_VALUES);CHKERRQ(ierr);
+      ierr = MatSetValues(A,1,&J,1,&Ii,&v,INSERT_VALUES);CHKERRQ(ierr);
+    }
+    v = 4.5 + (Ii%3); ierr = MatSetValues(A,1,&Ii,1,&Ii,&v,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  if (cholesky) {ierr = MatSetOption(A,MAT_SYMMETRIC,PETSC_TRUE);CHKERRQ(ierr);}
+
+  /* the level scheduled solves are selected with the options prefix of the factored matrix */
+  ierr = MatDuplicate(A,MAT_COPY_VALUES,&Alev);CHKERRQ(ierr);
+  ierr = MatSetOptionsPrefix(Alev,"lev_");CHKERRQ(ierr);
+
+  ierr = MatFactorInfoInitialize(&info);CHKERRQ(ierr);
+  info.levels = 1;
+  info.fill   = 1.0;
+  ierr = MatGetOrdering(A,ordering,&row,&col);CHKERRQ(ierr);
+  ierr = MatGetFactor(A,MATSOLVERPETSC,ftype,&F);CHKERRQ(ierr);
+  ierr = MatGetFactor(Alev,MATSOLVERPETSC,ftype,&Flev);CHKERRQ(ierr);
+  switch (ftype) {
+  case MAT_FACTOR_LU:
+    ierr = MatLUFactorSymbolic(F,A,row,col,&info);CHKERRQ(ierr);
+    ierr = MatLUFactorSymbolic(Flev,Alev,row,col,&info);CHKERRQ(ierr);
+    break;
+  case MAT_FACTOR_ILU:
+    ierr = MatILUFactorSymbolic(F,A,row,col,&info);CHKERRQ(ierr);
+    ierr = MatILUFactorSymbolic(Flev,Alev,row,col,&info);CHKERRQ(ierr);
+    break;
+  case MAT_FACTOR_CHOLESKY:
+    ierr = MatCholeskyFactorSymbolic(F,A,row,&info);CHKERRQ(ierr);
+    ierr = MatCholeskyFactorSymbolic(Flev,Alev,row,&info);CHKERRQ(ierr);
+    break;
+  default:
+    ierr = MatICCFactorSymbolic(F,A,row,&info);CHKERRQ(ierr);
+    ierr = MatICCFactorSymbolic(Flev,Alev,row,&info);CHKERRQ(ierr);
+    break;
+  }
+
+  ierr = MatCreateVecs(A,&x,&b);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&xlev);CHKERRQ(ierr);
+  ierr = MatCreateSeqDense(PETSC_COMM_SELF,m*m,nrhs,NULL,&B);CHKERRQ(ierr);
+  ierr = MatCreateSeqDense(PETSC_COMM_SELF,m*m,nrhs,NULL,&X);CHKERRQ(ierr);
+  ierr = MatCreateSeqDense(PETSC_COMM_SELF,m*m,nrhs,NULL,&Xlev);CHKERRQ(ierr);
+  for (Ii=0; Ii<m*m; Ii++) {
+    for (j=0; j<nrhs; j++) {
+      v = (Ii*7+j*13)%17 - 8.0;
+      ierr = MatSetValues(B,1,&Ii,1,&j,&v,INSERT_VALUES);CHKERRQ(ierr);
+    }
+  }
+  ierr = MatAssemblyBegin(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatGetColumnVector(B,b,1);CHKERRQ(ierr);
+
+  /* the numeric factorization is done twice to check that the schedule is rebuilt correctly */
+  for (i=0; i<2; i++) {
+    if (i) {ierr = MatScale(A,2.0);CHKERRQ(ierr);ierr = MatScale(Alev,2.0);CHKERRQ(ierr);}
+    if (cholesky) {
+      ierr = MatCholeskyFactorNumeric(F,A,&info);CHKERRQ(ierr);
+      ierr = MatCholeskyFactorNumeric(Flev,Alev,&info);CHKERRQ(ierr);
+    } else {
+      ierr = MatLUFactorNumeric(F,A,&info);CHKERRQ(ierr);
+      ierr = MatLUFactorNumeric(Flev,Alev,&info);CHKERRQ(ierr);
+    }
+
+    ierr = MatSolve(F,b,x);CHKERRQ(ierr);
+    ierr = MatSolve(Flev,b,xlev);CHKERRQ(ierr);
+    ierr = VecAXPY(xlev,-1.0,x);CHKERRQ(ierr);
+    ierr = VecNorm(xlev,NORM_INFINITY,&nrm);CHKERRQ(ierr);
+    err  = PetscMax(err,nrm);
+
+    ierr = MatSolveTranspose(F,b,x);CHKERRQ(ierr);
+    ierr = MatSolveTranspose(Flev,b,xlev);CHKERRQ(ierr);
+    ierr = VecAXPY(xlev,-1.0,x);CHKERRQ(ierr);
+    ierr = VecNorm(xlev,NORM_INFINITY,&nrm);CHKERRQ(ierr);
+    err  = PetscMax(err,nrm);
+
+    /* MatMatSolve() is not provided by the sequential Cholesky factors, compare with the solves of the individual columns */
+    ierr = MatMatSolve(Flev,B,Xlev);CHKERRQ(ierr);
+    if (cholesky) {
+      for (j=0; j<nrhs; j++) {
+        ierr = MatGetColumnVector(B,b,j);CHKERRQ(ierr);
+        ierr = MatSolve(F,b,x);CHKERRQ(ierr);
+        ierr = MatGetColumnVector(Xlev,xlev,j);CHKERRQ(ierr);
+        ierr = VecAXPY(xlev,-1.0,x);CHKERRQ(ierr);
+        ierr = VecNorm(xlev,NORM_INFINITY,&nrm);CHKERRQ(ierr);
+        err  = PetscMax(err,nrm);
+      }
+      ierr = MatGetColumnVector(B,b,1);CHKERRQ(ierr);
+    } else {
+      ierr = MatMatSolve(F,B,X);CHKERRQ(ierr);
+      ierr = MatAXPY(Xlev,-1.0,X,SAME_NONZERO_PATTERN);CHKERRQ(ierr);
+      ierr = MatNorm(Xlev,NORM_INFINITY,&nrm);CHKERRQ(ierr);
+      err  = PetscMax(err,nrm);
+    }
+  }
+  if (err > 100*PETSC_MACHINE_EPSILON) {ierr = PetscPrintf(PETSC_COMM_SELF,"Level scheduled and sequential solves differ by %g\n",(double)err);CHKERRQ(ierr);}
+
+  ierr = ISDestroy(&row);CHKERRQ(ierr);
+  ierr = ISDestroy(&col);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&xlev);CHKERRQ(ierr);
+  ierr = VecDestroy(&b);CHKERRQ(ierr);
+  ierr = MatDestroy(&B);CHKERRQ(ierr);
+  ierr = MatDestroy(&X);CHKERRQ(ierr);
+  ierr = MatDestroy(&Xlev);CHKERRQ(ierr);
+  ierr = MatDestroy(&F);CHKERRQ(ierr);
+  ierr = MatDestroy(&Flev);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = MatDestroy(&Alev);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      suffix: ilu
+      args: -lev_mat_solve_level_threads 2
+      output_file: output/ex304.out
+
+   test:
+      suffix: lu
+      args: -lev_mat_solve_level_threads 3 -factor lu -ordering rcm -m 12
+      output_file: output/ex304.out
+
+   test:
+      suffix: lu_natural
+      args: -lev_mat_solve_level_threads 1 -factor lu -ordering natural -mat_no_inode
+      output_file: output/ex304.out
+
+   test:
+      suffix: icc
+      args: -lev_mat_solve_level_threads 2 -factor icc
+      output_file: output/ex304.out
+
+   test:
+      suffix: cholesky
+      args: -lev_mat_solve_level_threads 2 -factor cholesky -ordering natural
+      output_file: output/ex304.out
+
+TEST*/
@@ -0,0 +1,117 @@
+static char help[] = "Tests the fixed-point ILU factorization MATSOLVERCHOWILU against the ILU factorization of MATSOLVERPETSC.\n\
+Input parameters include\n\
+  -m <m>          : number of grid points in each direction\n\
+  -levels <k>     : levels of fill\n\
+  -ordering <ord> : matrix ordering used by the factorization\n\
+  -zero_pivot     : makes the first diagonal entry zero\n\
+  -shift_type <t> : shift type of the factorization, with -shift_amount <a>\n\n";
+
+#include <petscmat.h>
+
+int main(int argc,char **args)
+{
+  Mat            A,F,Fchow;
+  Vec            b,x,xchow;
+  IS             row,col;
+  MatFactorInfo  info;
+  MatSolverType  stype;
+  char           ordering[256] = MATORDERINGNATURAL;
+  PetscInt       i,j,Ii,J,m = 8,levels = 0;
+  MatFactorShiftType shifttype = MAT_SHIFT_NONE;
+  PetscReal      shiftamount = 0.0;
+  PetscBool      zeropivot = PETSC_FALSE;
+  PetscScalar    v;
+  PetscReal      nrm,xnrm;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-levels",&levels,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetString(NULL,NULL,"-ordering",ordering,sizeof(ordering),NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-zero_pivot",&zeropivot,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetEnum(NULL,NULL,"-shift_type",MatFactorShiftTypes,(PetscEnum*)&shifttype,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetReal(NULL,NULL,"-shift_amount",&shiftamount,NULL);CHKERRQ(ierr);
+
+  /* 2d convection-diffusion */
+  ierr = MatCreateSeqAIJ(PETSC_COMM_SELF,m*m,m*m,5,NULL,&A);CHKERRQ(ierr);
+  for (Ii=0; Ii<m*m; Ii++) {
+    i = Ii/m; j = Ii - i*m;
+    if (i>0)   {J = Ii - m; v = -1.0; ierr = MatSetValues(A,1,&Ii,1,&J,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    if (i<m-1) {J = Ii + m; v = -1.0; ierr = MatSetValues(A,1,&Ii,1,&J,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    if (j>0)   {J = Ii - 1; v = -1.5; ierr = MatSetValues(A,1,&Ii,1,&J,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    if (j<m-1) {J = Ii + 1; v = -0.5; ierr = MatSetValues(A,1,&Ii,1,&J,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    v = (zeropivot && !Ii) ? 0.0 : 4.5 + (Ii%3); ierr = MatSetValues(A,1,&Ii,1,&Ii,&v,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+
+  ierr = MatFactorInfoInitialize(&info);CHKERRQ(ierr);
+  info.levels = levels;
+  info.fill   = 1.0;
+  info.shifttype   = (PetscReal)shifttype;
+  info.shiftamount = shiftamount;
+  ierr = MatGetOrdering(A,ordering,&row,&col);CHKERRQ(ierr);
+  ierr = MatGetFactor(A,MATSOLVERPETSC,MAT_FACTOR_ILU,&F);CHKERRQ(ierr);
+  ierr = MatGetFactor(A,MATSOLVERCHOWILU,MAT_FACTOR_ILU,&Fchow);CHKERRQ(ierr);
+  ierr = MatFactorGetSolverType(Fchow,&stype);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_SELF,"Solver type %s\n",stype);CHKERRQ(ierr);
+  ierr = MatILUFactorSymbolic(F,A,row,col,&info);CHKERRQ(ierr);
+  ierr = MatILUFactorSymbolic(Fchow,A,row,col,&info);CHKERRQ(ierr);
+
+  ierr = MatCreateVecs(A,&x,&b);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&xchow);CHKERRQ(ierr);
+  for (Ii=0; Ii<m*m; Ii++) {
+    v    = (Ii*7)%17 - 8.0;
+    ierr = VecSetValues(b,1,&Ii,&v,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = VecAssemblyBegin(b);CHKERRQ(ierr);
+  ierr = VecAssemblyEnd(b);CHKERRQ(ierr);
+
+  /* the numeric factorization is done twice, the second time with different values */
+  for (i=0; i<2; i++) {
+    if (i) {ierr = MatShift(A,1.0);CHKERRQ(ierr);}
+    ierr = MatLUFactorNumeric(F,A,&info);CHKERRQ(ierr);
+    ierr = MatLUFactorNumeric(Fchow,A,&info);CHKERRQ(ierr);
+    ierr = MatSolve(F,b,x);CHKERRQ(ierr);
+    ierr = MatSolve(Fchow,b,xchow);CHKERRQ(ierr);
+    ierr = VecNorm(x,NORM_2,&xnrm);CHKERRQ(ierr);
+    ierr = VecAXPY(xchow,-1.0,x);CHKERRQ(ierr);
+    ierr = VecNorm(xchow,NORM_2,&nrm);CHKERRQ(ierr);
+    nrm /= xnrm;
+    if (nrm < 1.e-10) {ierr = PetscPrintf(PETSC_COMM_SELF,"Factorization %D: the factors are the ILU factors\n",i);CHKERRQ(ierr);}
+    else {ierr = PetscPrintf(PETSC_COMM_SELF,"Factorization %D: relative difference of the solves with the ILU factors %.1e\n",i,(double)nrm);CHKERRQ(ierr);}
+  }
+
+  ierr = ISDestroy(&row);CHKERRQ(ierr);
+  ierr = ISDestroy(&col);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&xchow);CHKERRQ(ierr);
+  ierr = VecDestroy(&b);CHKERRQ(ierr);
+  ierr = MatDestroy(&F);CHKERRQ(ierr);
+  ierr = MatDestroy(&Fchow);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      suffix: 1
+      args: -mat_chowilu_sweeps 70
+
+   test:
+      suffix: 2
+      args: -mat_chowilu_sweeps 70 -mat_chowilu_threads 2 -levels 2 -ordering rcm
+      output_file: output/ex305_1.out
+
+   test:
+      suffix: 3
+      args: -mat_chowilu_sweeps 3 -levels 1
+
+   test:
+      suffix: shift
+      args: -mat_chowilu_sweeps 70 -zero_pivot -shift_type {{nonzero positive_definite}} -shift_amount 0.5
+      output_file: output/ex305_1.out
+
+TEST*/
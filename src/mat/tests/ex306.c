@@ -0,0 +1,139 @@
+static char help[] = "Tests the supernodal Cholesky factorization MATSOLVERSUPERNODAL against the Cholesky factorization of MATSOLVERPETSC.\n\
+Input parameters include\n\
+  -m <m>          : number of grid points in each direction\n\
+  -mat_type <t>   : seqaij or seqsbaij\n\
+  -ordering <ord> : matrix ordering used by the factorization\n\n";
+
+#include <petscmat.h>
+
+int main(int argc,char **args)
+{
+  Mat            A,F,Fsn,B,Xsn;
+  Vec            b,x,xsn;
+  IS             row,col,rowref,colref;
+  MatFactorInfo  info;
+  MatSolverType  stype;
+  char           ordering[256] = MATORDERINGND;
+  PetscInt       i,j,k,Ii,J,m = 6,nrhs = 3;
+  PetscScalar    v;
+  PetscReal      nrm,err = 0.0;
+  PetscBool      sbaij;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetString(NULL,NULL,"-ordering",ordering,sizeof(ordering),NULL);CHKERRQ(ierr);
+
+  /* 3d Laplacian with a varying diagonal */
+  ierr = MatCreate(PETSC_COMM_SELF,&A);CHKERRQ(ierr);
+  ierr = MatSetSizes(A,m*m*m,m*m*m,m*m*m,m*m*m);CHKERRQ(ierr);
+  ierr = MatSetType(A,MATSEQAIJ);CHKERRQ(ierr);
+  ierr = MatSetFromOptions(A);CHKERRQ(ierr);
+  ierr = MatSeqAIJSetPreallocation(A,7,NULL);CHKERRQ(ierr);
+  ierr = MatSeqSBAIJSetPreallocation(A,1,4,NULL);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject)A,MATSEQSBAIJ,&sbaij);CHKERRQ(ierr);
+  if (sbaij) {ierr = MatSetOption(A,MAT_IGNORE_LOWER_TRIANGULAR,PETSC_TRUE);CHKERRQ(ierr);}
+  for (Ii=0; Ii<m*m*m; Ii++) {
+    i = Ii/(m*m); j = (Ii/m)%m; k = Ii%m;
+    v = -1.0;
+    if (i>0)   {J = Ii - m*m; ierr = MatSetValues(A,1,&Ii,1,&J,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    if (i<m-1) {J = Ii + m*m; ierr = MatSetValues(A,1,&Ii,1,&J,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    if (j>0)   {J = Ii - m;   ierr = MatSetValues(A,1,&Ii,1,&J,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    if (j<m-1) {J = Ii + m;   ierr = MatSetValues(A,1,&Ii,1,&J,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    if (k>0)   {J = Ii - 1;   ierr = MatSetValues(A,1,&Ii,1,&J,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    if (k<m-1) {J = Ii + 1;   ierr = MatSetValues(A,1,&Ii,1,&J,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    v = 6.0 + 0.1*(Ii%5); ierr = MatSetValues(A,1,&Ii,1,&Ii,&v,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatSetOption(A,MAT_SYMMETRIC,PETSC_TRUE);CHKERRQ(ierr);
+  ierr = MatSetOption(A,MAT_HERMITIAN,PETSC_TRUE);CHKERRQ(ierr);
+
+  ierr = MatFactorInfoInitialize(&info);CHKERRQ(ierr);
+  ierr = MatGetOrdering(A,ordering,&row,&col);CHKERRQ(ierr);
+  /* the Cholesky factorization of MATSOLVERPETSC does not reorder SBAIJ matrices */
+  ierr = MatGetOrdering(A,sbaij ? MATORDERINGNATURAL : ordering,&rowref,&colref);CHKERRQ(ierr);
+  ierr = MatGetFactor(A,MATSOLVERPETSC,MAT_FACTOR_CHOLESKY,&F);CHKERRQ(ierr);
+  ierr = MatGetFactor(A,MATSOLVERSUPERNODAL,MAT_FACTOR_CHOLESKY,&Fsn);CHKERRQ(ierr);
+  ierr = MatFactorGetSolverType(Fsn,&stype);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_SELF,"Solver type %s\n",stype);CHKERRQ(ierr);
+  ierr = MatCholeskyFactorSymbolic(F,A,rowref,&info);CHKERRQ(ierr);
+  ierr = MatCholeskyFactorSymbolic(Fsn,A,row,&info);CHKERRQ(ierr);
+
+  ierr = MatCreateVecs(A,&x,&b);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&xsn);CHKERRQ(ierr);
+  ierr = MatCreateSeqDense(PETSC_COMM_SELF,m*m*m,nrhs,NULL,&B);CHKERRQ(ierr);
+  ierr = MatCreateSeqDense(PETSC_COMM_SELF,m*m*m,nrhs,NULL,&Xsn);CHKERRQ(ierr);
+  for (Ii=0; Ii<m*m*m; Ii++) {
+    for (j=0; j<nrhs; j++) {
+      v = (Ii*7+j*13)%17 - 8.0;
+      ierr = MatSetValues(B,1,&Ii,1,&j,&v,INSERT_VALUES);CHKERRQ(ierr);
+    }
+  }
+  ierr = MatAssemblyBegin(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+
+  /* the numeric factorization is done twice, the second time with different values */
+  for (i=0; i<2; i++) {
+    if (i) {ierr = MatShift(A,1.0);CHKERRQ(ierr);}
+    ierr = MatCholeskyFactorNumeric(F,A,&info);CHKERRQ(ierr);
+    ierr = MatCholeskyFactorNumeric(Fsn,A,&info);CHKERRQ(ierr);
+    for (j=0; j<nrhs; j++) {
+      ierr = MatGetColumnVector(B,b,j);CHKERRQ(ierr);
+      ierr = MatSolve(F,b,x);CHKERRQ(ierr);
+      ierr = MatSolve(Fsn,b,xsn);CHKERRQ(ierr);
+      ierr = VecAXPY(xsn,-1.0,x);CHKERRQ(ierr);
+      ierr = VecNorm(xsn,NORM_INFINITY,&nrm);CHKERRQ(ierr);
+      err  = PetscMax(err,nrm);
+    }
+    /* MatMatSolve() is not provided by the sequential Cholesky factors, compare with the solves of the individual columns */
+    ierr = MatMatSolve(Fsn,B,Xsn);CHKERRQ(ierr);
+    for (j=0; j<nrhs; j++) {
+      ierr = MatGetColumnVector(B,b,j);CHKERRQ(ierr);
+      ierr = MatSolve(F,b,x);CHKERRQ(ierr);
+      ierr = MatGetColumnVector(Xsn,xsn,j);CHKERRQ(ierr);
+      ierr = VecAXPY(xsn,-1.0,x);CHKERRQ(ierr);
+      ierr = VecNorm(xsn,NORM_INFINITY,&nrm);CHKERRQ(ierr);
+      err  = PetscMax(err,nrm);
+    }
+  }
+  if (err > PETSC_SMALL) {ierr = PetscPrintf(PETSC_COMM_SELF,"Supernodal and sequential solves differ by %g\n",(double)err);CHKERRQ(ierr);}
+
+  ierr = ISDestroy(&row);CHKERRQ(ierr);
+  ierr = ISDestroy(&col);CHKERRQ(ierr);
+  ierr = ISDestroy(&rowref);CHKERRQ(ierr);
+  ierr = ISDestroy(&colref);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&xsn);CHKERRQ(ierr);
+  ierr = VecDestroy(&b);CHKERRQ(ierr);
+  ierr = MatDestroy(&B);CHKERRQ(ierr);
+  ierr = MatDestroy(&Xsn);CHKERRQ(ierr);
+  ierr = MatDestroy(&F);CHKERRQ(ierr);
+  ierr = MatDestroy(&Fsn);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      suffix: aij
+      output_file: output/ex306.out
+
+   test:
+      suffix: sbaij
+      args: -mat_type seqsbaij
+      output_file: output/ex306.out
+
+   test:
+      suffix: natural
+      args: -ordering natural -m 5
+      output_file: output/ex306.out
+
+   test:
+      suffix: sbaij_rcm
+      args: -mat_type seqsbaij -ordering rcm -m 7
+      output_file: output/ex306.out
+
+TEST*/
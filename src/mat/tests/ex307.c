@@ -0,0 +1,192 @@
+static char help[] = "Tests that MATAIJMIXED applies its values in single precision and keeps them in full precision.\n\
+Input parameters include\n\
+  -m <m> : number of grid points in each direction\n\n";
+
+/*
+   The products of MATAIJMIXED are compared with those of a MATAIJ matrix whose values have been rounded to single
+   precision, so they must agree up to the rounding of the sums in double precision. MatSOR() of MATAIJMIXED keeps the
+   diagonal in full precision, so it is compared with a MATAIJ matrix whose off-diagonal values only have been rounded.
+*/
+
+#include <petscmat.h>
+
+/* R gets the values of A rounded to single precision, except the diagonal if rounddiag is false */
+static PetscErrorCode MatRoundToSingle(Mat A,PetscBool rounddiag,Mat R)
+{
+  PetscInt          Ii,k,ncols,rstart,rend;
+  const PetscInt    *cols;
+  const PetscScalar *vals;
+  PetscScalar       *rvals;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = MatZeroEntries(R);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(A,&rstart,&rend);CHKERRQ(ierr);
+  for (Ii=rstart; Ii<rend; Ii++) {
+    ierr = MatGetRow(A,Ii,&ncols,&cols,&vals);CHKERRQ(ierr);
+    ierr = PetscMalloc1(ncols,&rvals);CHKERRQ(ierr);
+    for (k=0; k<ncols; k++) rvals[k] = (cols[k] == Ii && !rounddiag) ? vals[k] : (PetscScalar)(float)PetscRealPart(vals[k]);
+    ierr = MatSetValues(R,1,&Ii,ncols,cols,rvals,INSERT_VALUES);CHKERRQ(ierr);
+    ierr = PetscFree(rvals);CHKERRQ(ierr);
+    ierr = MatRestoreRow(A,Ii,&ncols,&cols,&vals);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(R,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(R,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* reports when the result z of MATAIJMIXED differs from the result y of the rounded MATAIJ matrix; z is overwritten */
+static PetscErrorCode CheckResult(Vec y,Vec z,PetscInt i,const char op[])
+{
+  PetscReal      ynrm,nrm;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecNorm(y,NORM_INFINITY,&ynrm);CHKERRQ(ierr);
+  ierr = VecAXPY(z,-1.0,y);CHKERRQ(ierr);
+  ierr = VecNorm(z,NORM_INFINITY,&nrm);CHKERRQ(ierr);
+  if (nrm > 1.e-12*ynrm) {ierr = PetscPrintf(PETSC_COMM_WORLD,"%D: %s differs by %g\n",i,op,(double)(nrm/ynrm));CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **args)
+{
+  Mat            A,B,F,R;
+  Vec            x,y,z,b;
+  PetscInt       i,j,Ii,J,m = 10,rstart,rend,rows[3];
+  PetscScalar    v;
+  PetscReal      nrmA,nrmB;
+  PetscBool      flg;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
+
+  /* 2d convection-diffusion with values that are not exact in single precision */
+  ierr = MatCreateAIJ(PETSC_COMM_WORLD,PETSC_DECIDE,PETSC_DECIDE,m*m,m*m,5,NULL,5,NULL,&A);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(A,&rstart,&rend);CHKERRQ(ierr);
+  for (Ii=rstart; Ii<rend; Ii++) {
+    i = Ii/m; j = Ii - i*m;
+    if (i>0)   {J = Ii - m; v = -1.0/3.0; ierr = MatSetValues(A,1,&Ii,1,&J,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    if (i<m-1) {J = Ii + m; v = -1.0/7.0; ierr = MatSetValues(A,1,&Ii,1,&J,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    if (j>0)   {J = Ii - 1; v = -1.1;     ierr = MatSetValues(A,1,&Ii,1,&J,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    if (j<m-1) {J = Ii + 1; v = -0.3;     ierr = MatSetValues(A,1,&Ii,1,&J,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    v = 3.1 + 0.01*(Ii%7); ierr = MatSetValues(A,1,&Ii,1,&Ii,&v,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatConvert(A,MATAIJMIXED,MAT_INITIAL_MATRIX,&B);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompareAny((PetscObject)B,&flg,MATSEQAIJMIXED,MATMPIAIJMIXED,"");CHKERRQ(ierr);
+  if (!flg) SETERRQ(PETSC_COMM_WORLD,PETSC_ERR_PLIB,"Wrong matrix type");
+  ierr = MatDuplicate(A,MAT_DO_NOT_COPY_VALUES,&F);CHKERRQ(ierr);
+  ierr = MatDuplicate(A,MAT_DO_NOT_COPY_VALUES,&R);CHKERRQ(ierr);
+
+  ierr = MatCreateVecs(A,&x,&y);CHKERRQ(ierr);
+  ierr = VecDuplicate(y,&z);CHKERRQ(ierr);
+  ierr = VecDuplicate(y,&b);CHKERRQ(ierr);
+  for (Ii=rstart; Ii<rend; Ii++) {
+    v    = (Ii*7)%17 - 8.1;
+    ierr = VecSetValues(x,1,&Ii,&v,INSERT_VALUES);CHKERRQ(ierr);
+    v    = (Ii*5)%13 - 6.2;
+    ierr = VecSetValues(b,1,&Ii,&v,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = VecAssemblyBegin(x);CHKERRQ(ierr);
+  ierr = VecAssemblyEnd(x);CHKERRQ(ierr);
+  ierr = VecAssemblyBegin(b);CHKERRQ(ierr);
+  ierr = VecAssemblyEnd(b);CHKERRQ(ierr);
+
+  /* the single precision values must follow changes of the matrix values, also when the blocks are changed directly */
+  rows[0] = 1; rows[1] = (m*m)/2; rows[2] = m*m-2;
+  for (i=0; i<5; i++) {
+    if (i == 1) {
+      ierr = MatShift(A,1.0);CHKERRQ(ierr);
+      ierr = MatShift(B,1.0);CHKERRQ(ierr);
+    } else if (i == 2) {
+      ierr = MatDiagonalScale(A,b,x);CHKERRQ(ierr);
+      ierr = MatDiagonalScale(B,b,x);CHKERRQ(ierr);
+    } else if (i == 3) {
+      ierr = MatZeroRows(A,3,rows,2.0,NULL,NULL);CHKERRQ(ierr);
+      ierr = MatZeroRows(B,3,rows,2.0,NULL,NULL);CHKERRQ(ierr);
+    } else if (i == 4) {
+      rows[0] = m; rows[1] = (m*m)/2+1; rows[2] = m*m-1;
+      ierr = MatZeroRowsColumns(A,3,rows,2.0,NULL,NULL);CHKERRQ(ierr);
+      ierr = MatZeroRowsColumns(B,3,rows,2.0,NULL,NULL);CHKERRQ(ierr);
+    }
+    ierr = MatRoundToSingle(A,PETSC_TRUE,F);CHKERRQ(ierr);
+    ierr = MatRoundToSingle(A,PETSC_FALSE,R);CHKERRQ(ierr);
+
+    /* all other operations use the values in full precision */
+    ierr = MatNorm(A,NORM_FROBENIUS,&nrmA);CHKERRQ(ierr);
+    ierr = MatNorm(B,NORM_FROBENIUS,&nrmB);CHKERRQ(ierr);
+    if (nrmA != nrmB) {ierr = PetscPrintf(PETSC_COMM_WORLD,"%D: the values are not kept in full precision\n",i);CHKERRQ(ierr);}
+
+    ierr = MatMult(F,x,y);CHKERRQ(ierr);
+    ierr = MatMult(B,x,z);CHKERRQ(ierr);
+    ierr = CheckResult(y,z,i,"MatMult");CHKERRQ(ierr);
+
+    ierr = MatMultAdd(F,x,b,y);CHKERRQ(ierr);
+    ierr = MatMultAdd(B,x,b,z);CHKERRQ(ierr);
+    ierr = CheckResult(y,z,i,"MatMultAdd");CHKERRQ(ierr);
+
+    ierr = MatMultTranspose(F,x,y);CHKERRQ(ierr);
+    ierr = MatMultTranspose(B,x,z);CHKERRQ(ierr);
+    ierr = CheckResult(y,z,i,"MatMultTranspose");CHKERRQ(ierr);
+
+    ierr = VecCopy(b,y);CHKERRQ(ierr);
+    ierr = VecCopy(b,z);CHKERRQ(ierr);
+    ierr = MatMultTransposeAdd(F,x,y,y);CHKERRQ(ierr);
+    ierr = MatMultTransposeAdd(B,x,z,z);CHKERRQ(ierr);
+    ierr = CheckResult(y,z,i,"MatMultTransposeAdd");CHKERRQ(ierr);
+
+    /* the symmetric sweep saves the lower triangular part, the backward sweep alone uses whole rows */
+    ierr = VecCopy(x,y);CHKERRQ(ierr);
+    ierr = VecCopy(x,z);CHKERRQ(ierr);
+    ierr = MatSOR(R,b,1.2,SOR_LOCAL_SYMMETRIC_SWEEP,0.0,2,1,y);CHKERRQ(ierr);
+    ierr = MatSOR(B,b,1.2,SOR_LOCAL_SYMMETRIC_SWEEP,0.0,2,1,z);CHKERRQ(ierr);
+    ierr = CheckResult(y,z,i,"MatSOR symmetric");CHKERRQ(ierr);
+
+    ierr = VecCopy(x,y);CHKERRQ(ierr);
+    ierr = VecCopy(x,z);CHKERRQ(ierr);
+    ierr = MatSOR(R,b,1.0,SOR_LOCAL_FORWARD_SWEEP | SOR_ZERO_INITIAL_GUESS,0.0,1,2,y);CHKERRQ(ierr);
+    ierr = MatSOR(B,b,1.0,SOR_LOCAL_FORWARD_SWEEP | SOR_ZERO_INITIAL_GUESS,0.0,1,2,z);CHKERRQ(ierr);
+    ierr = CheckResult(y,z,i,"MatSOR forward");CHKERRQ(ierr);
+
+    ierr = VecCopy(x,y);CHKERRQ(ierr);
+    ierr = VecCopy(x,z);CHKERRQ(ierr);
+    ierr = MatSOR(R,b,0.8,SOR_LOCAL_BACKWARD_SWEEP,0.0,2,1,y);CHKERRQ(ierr);
+    ierr = MatSOR(B,b,0.8,SOR_LOCAL_BACKWARD_SWEEP,0.0,2,1,z);CHKERRQ(ierr);
+    ierr = CheckResult(y,z,i,"MatSOR backward");CHKERRQ(ierr);
+  }
+
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = VecDestroy(&z);CHKERRQ(ierr);
+  ierr = VecDestroy(&b);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = MatDestroy(&B);CHKERRQ(ierr);
+  ierr = MatDestroy(&F);CHKERRQ(ierr);
+  ierr = MatDestroy(&R);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   build:
+      requires: !complex !single
+
+   test:
+      suffix: 1
+
+   test:
+      suffix: 2
+      nsize: 3
+      output_file: output/ex307_1.out
+
+   test:
+      suffix: 3
+      nsize: 2
+      args: -m 3
+      output_file: output/ex307_1.out
+
+TEST*/
@@ -0,0 +1,117 @@
+static char help[] = "Tests the threaded numeric phases of MatPtAP() and MatMatMult() of AIJ matrices (-mat_product_threads).\n\
+Input parameters include\n\
+  -m <m>        : number of grid points in each direction\n\
+  -nthreads <n> : number of threads of the threaded products\n\n";
+
+#include <petscmat.h>
+
+int main(int argc,char **args)
+{
+  Mat            A,P,C[2],D[2];
+  PetscInt       i,j,Ii,J,m = 12,mc,rstart,rend,k,nthreads = 3;
+  PetscScalar    v;
+  PetscObject    container;
+  PetscMPIInt    size;
+  PetscBool      flg;
+  char           str[16];
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-nthreads",&nthreads,NULL);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(PETSC_COMM_WORLD,&size);CHKERRQ(ierr);
+  mc   = m/2 + 1;
+
+  /* 2d Laplacian with a variable diagonal */
+  ierr = MatCreateAIJ(PETSC_COMM_WORLD,PETSC_DECIDE,PETSC_DECIDE,m*m,m*m,5,NULL,5,NULL,&A);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(A,&rstart,&rend);CHKERRQ(ierr);
+  for (Ii=rstart; Ii<rend; Ii++) {
+    i = Ii/m; j = Ii - i*m; v = -1.0;
+    if (i>0)   {J = Ii - m; ierr = MatSetValues(A,1,&Ii,1,&J,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    if (i<m-1) {J = Ii + m; ierr = MatSetValues(A,1,&Ii,1,&J,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    if (j>0)   {J = Ii - 1; ierr = MatSetValues(A,1,&Ii,1,&J,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    if (j<m-1) {J = Ii + 1; ierr = MatSetValues(A,1,&Ii,1,&J,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    v = 4.0 + 0.1*(Ii%5); ierr = MatSetValues(A,1,&Ii,1,&Ii,&v,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+
+  /* interpolation from the grid with every other point in each direction */
+  ierr = MatCreateAIJ(PETSC_COMM_WORLD,rend-rstart,PETSC_DECIDE,m*m,mc*mc,2,NULL,2,NULL,&P);CHKERRQ(ierr);
+  for (Ii=rstart; Ii<rend; Ii++) {
+    i = Ii/m; j = Ii - i*m; v = 0.5;
+    J    = (i/2)*mc + j/2;
+    ierr = MatSetValues(P,1,&Ii,1,&J,&v,ADD_VALUES);CHKERRQ(ierr);
+    J    = ((i+1)/2)*mc + (j+1)/2;
+    ierr = MatSetValues(P,1,&Ii,1,&J,&v,ADD_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(P,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(P,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+
+  /* the products with k = 1 split their rows among threads in the symbolic phase */
+  for (k=0; k<2; k++) {
+    if (k) {
+      ierr = PetscSNPrintf(str,sizeof(str),"%D",nthreads);CHKERRQ(ierr);
+      ierr = PetscOptionsSetValue(NULL,"-mat_product_threads",str);CHKERRQ(ierr);
+    }
+    ierr = MatPtAP(A,P,MAT_INITIAL_MATRIX,2.0,&C[k]);CHKERRQ(ierr);
+    ierr = MatMatMult(A,P,MAT_INITIAL_MATRIX,2.0,&D[k]);CHKERRQ(ierr);
+    ierr = PetscOptionsClearValue(NULL,"-mat_product_threads");CHKERRQ(ierr);
+  }
+  /* the split of the rows is attached to a sequential product by its symbolic phase */
+  if (size == 1) {
+    ierr = PetscObjectQuery((PetscObject)D[1],"__PETSc__product_threads",&container);CHKERRQ(ierr);
+    if (!container) {ierr = PetscPrintf(PETSC_COMM_WORLD,"The numeric phase of MatMatMult is not threaded\n");CHKERRQ(ierr);}
+    ierr = PetscObjectQuery((PetscObject)D[0],"__PETSc__product_threads",&container);CHKERRQ(ierr);
+    if (container) {ierr = PetscPrintf(PETSC_COMM_WORLD,"The numeric phase of MatMatMult is threaded without -mat_product_threads\n");CHKERRQ(ierr);}
+  }
+
+  /* the numeric phases must follow changes of the values with the same nonzero pattern */
+  for (i=0; i<3; i++) {
+    if (i == 1) {
+      ierr = MatShift(A,1.0);CHKERRQ(ierr);
+    } else if (i == 2) {
+      ierr = MatScale(P,0.3);CHKERRQ(ierr);
+    }
+    for (k=0; k<2; k++) {
+      if (i) {
+        ierr = MatPtAP(A,P,MAT_REUSE_MATRIX,2.0,&C[k]);CHKERRQ(ierr);
+        ierr = MatMatMult(A,P,MAT_REUSE_MATRIX,2.0,&D[k]);CHKERRQ(ierr);
+      }
+    }
+    /* the threads only change the order in which the rows are computed, not the order of the sums in a row */
+    ierr = MatEqual(C[0],C[1],&flg);CHKERRQ(ierr);
+    if (!flg) {ierr = PetscPrintf(PETSC_COMM_WORLD,"%D: the threaded MatPtAP differs\n",i);CHKERRQ(ierr);}
+    ierr = MatEqual(D[0],D[1],&flg);CHKERRQ(ierr);
+    if (!flg) {ierr = PetscPrintf(PETSC_COMM_WORLD,"%D: the threaded MatMatMult differs\n",i);CHKERRQ(ierr);}
+  }
+
+  for (k=0; k<2; k++) {
+    ierr = MatDestroy(&C[k]);CHKERRQ(ierr);
+    ierr = MatDestroy(&D[k]);CHKERRQ(ierr);
+  }
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = MatDestroy(&P);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      suffix: 1
+      args: -matmatmult_via {{sorted scalable}}
+
+   test:
+      suffix: 2
+      nsize: 3
+      args: -matptap_via {{scalable nonscalable}} -matmatmult_via nonscalable
+      output_file: output/ex308_1.out
+
+   test:
+      suffix: 3
+      nsize: 2
+      args: -matptap_via {{scalable nonscalable}} -m 3 -nthreads 4
+      output_file: output/ex308_1.out
+
+TEST*/
@@ -0,0 +1,170 @@
+static char help[] = "Tests the products of MATAIJAUTO, whose format for MatMult() is selected by timing, against those of MATAIJ.\n\
+Input parameters include\n\
+  -m <m>     : number of grid points in each direction\n\
+  -dof <dof> : number of coupled unknowns at each grid point\n\n";
+
+#include <petscmat.h>
+
+/* Checks the number of times the format of MATAIJAUTO matrices has been selected, from the MatAutoSelect event */
+static PetscErrorCode CheckSelections(PetscInt i,PetscInt nselexpected)
+{
+#if defined(PETSC_USE_LOG)
+  PetscLogEvent      event;
+  PetscEventPerfInfo info;
+  PetscMPIInt        size;
+  PetscErrorCode     ierr;
+#endif
+
+  PetscFunctionBegin;
+#if defined(PETSC_USE_LOG)
+  /* in parallel the diagonal and off-diagonal blocks select their formats separately */
+  ierr = MPI_Comm_size(PETSC_COMM_WORLD,&size);CHKERRQ(ierr);
+  if (size > 1) PetscFunctionReturn(0);
+  ierr = PetscLogEventGetId("MatAutoSelect",&event);CHKERRQ(ierr);
+  ierr = PetscLogEventGetPerfInfo(PETSC_DETERMINE,event,&info);CHKERRQ(ierr);
+  if (info.count != nselexpected) {ierr = PetscPrintf(PETSC_COMM_WORLD,"%D: %d selections of the format instead of %D\n",i,info.count,nselexpected);CHKERRQ(ierr);}
+#endif
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **args)
+{
+  Mat            A,B,C;
+  Vec            x,b;
+  PetscInt       i,j,c,d,k,node,Ii,J,m = 10,dof = 1,rstart,rend,nb[5],nselexpected = 0,rows[3];
+  PetscScalar    v;
+  PetscBool      flg;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-dof",&dof,NULL);CHKERRQ(ierr);
+  ierr = PetscLogDefaultBegin();CHKERRQ(ierr);
+
+  /* 2d Laplacian with dof coupled unknowns at each grid point, so the nonzeros form dof x dof blocks */
+  ierr = MatCreateAIJ(PETSC_COMM_WORLD,PETSC_DECIDE,PETSC_DECIDE,m*m*dof,m*m*dof,5*dof,NULL,5*dof,NULL,&A);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(A,&rstart,&rend);CHKERRQ(ierr);
+  for (Ii=rstart; Ii<rend; Ii++) {
+    node = Ii/dof; i = node/m; j = node - i*m; c = Ii - node*dof; k = 0;
+    nb[k++] = node;
+    if (i>0)   nb[k++] = node - m;
+    if (i<m-1) nb[k++] = node + m;
+    if (j>0)   nb[k++] = node - 1;
+    if (j<m-1) nb[k++] = node + 1;
+    while (k--) {
+      for (d=0; d<dof; d++) {
+        J    = nb[k]*dof + d;
+        v    = (nb[k] == node) ? (c == d ? 4.0 + 0.1*(Ii%7) : 0.3) : -1.0/(1.0 + c + d);
+        ierr = MatSetValues(A,1,&Ii,1,&J,&v,INSERT_VALUES);CHKERRQ(ierr);
+      }
+    }
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatConvert(A,MATAIJAUTO,MAT_INITIAL_MATRIX,&B);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompareAny((PetscObject)B,&flg,MATSEQAIJAUTO,MATMPIAIJAUTO,"");CHKERRQ(ierr);
+  if (!flg) SETERRQ(PETSC_COMM_WORLD,PETSC_ERR_PLIB,"Wrong matrix type");
+
+  ierr = MatCreateVecs(A,&x,&b);CHKERRQ(ierr);
+  for (Ii=rstart; Ii<rend; Ii++) {
+    v    = (Ii*7)%17 - 8.1;
+    ierr = VecSetValues(x,1,&Ii,&v,INSERT_VALUES);CHKERRQ(ierr);
+    v    = (Ii*5)%13 - 6.2;
+    ierr = VecSetValues(b,1,&Ii,&v,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = VecAssemblyBegin(x);CHKERRQ(ierr);
+  ierr = VecAssemblyEnd(x);CHKERRQ(ierr);
+  ierr = VecAssemblyBegin(b);CHKERRQ(ierr);
+  ierr = VecAssemblyEnd(b);CHKERRQ(ierr);
+
+  /* the copy in the selected format must follow changes of the values, and of the nonzero structure */
+  for (i=0; i<7; i++) {
+    if (i == 1) {
+      ierr = MatShift(A,1.0);CHKERRQ(ierr);
+      ierr = MatShift(B,1.0);CHKERRQ(ierr);
+    } else if (i == 2) {
+      ierr = MatDiagonalScale(A,b,x);CHKERRQ(ierr);
+      ierr = MatDiagonalScale(B,b,x);CHKERRQ(ierr);
+      ierr = MatScale(A,0.5);CHKERRQ(ierr);
+      ierr = MatScale(B,0.5);CHKERRQ(ierr);
+    } else if (i == 3) {
+      ierr = MatAXPY(B,2.0,A,SAME_NONZERO_PATTERN);CHKERRQ(ierr);
+      ierr = MatScale(A,3.0);CHKERRQ(ierr);
+    } else if (i == 4) {
+      /* a new nonzero in each row selects the format again */
+      ierr = MatSetOption(A,MAT_NEW_NONZERO_ALLOCATION_ERR,PETSC_FALSE);CHKERRQ(ierr);
+      ierr = MatSetOption(B,MAT_NEW_NONZERO_ALLOCATION_ERR,PETSC_FALSE);CHKERRQ(ierr);
+      for (Ii=rstart; Ii<rend; Ii++) {
+        J    = (Ii + m*m*dof/2) % (m*m*dof);
+        v    = 0.01;
+        ierr = MatSetValues(A,1,&Ii,1,&J,&v,ADD_VALUES);CHKERRQ(ierr);
+        ierr = MatSetValues(B,1,&Ii,1,&J,&v,ADD_VALUES);CHKERRQ(ierr);
+      }
+      ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+      ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+      ierr = MatAssemblyBegin(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+      ierr = MatAssemblyEnd(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+    } else if (i == 5) {
+      /* the blocks of MPIAIJ are changed directly, the nonzero structure is kept */
+      ierr = MatSetOption(A,MAT_KEEP_NONZERO_PATTERN,PETSC_TRUE);CHKERRQ(ierr);
+      ierr = MatSetOption(B,MAT_KEEP_NONZERO_PATTERN,PETSC_TRUE);CHKERRQ(ierr);
+      rows[0] = 1; rows[1] = (m*m*dof)/2; rows[2] = m*m*dof-2;
+      ierr = MatZeroRows(A,3,rows,2.0,NULL,NULL);CHKERRQ(ierr);
+      ierr = MatZeroRows(B,3,rows,2.0,NULL,NULL);CHKERRQ(ierr);
+    } else if (i == 6) {
+      rows[0] = m*dof; rows[1] = (m*m*dof)/2+1; rows[2] = m*m*dof-1;
+      ierr = MatZeroRowsColumns(A,3,rows,2.0,NULL,NULL);CHKERRQ(ierr);
+      ierr = MatZeroRowsColumns(B,3,rows,2.0,NULL,NULL);CHKERRQ(ierr);
+    }
+    ierr = MatMultEqual(A,B,3,&flg);CHKERRQ(ierr);
+    if (!flg) {ierr = PetscPrintf(PETSC_COMM_WORLD,"%D: MatMult differs\n",i);CHKERRQ(ierr);}
+    /* the format is selected by the first product after the nonzero structure has changed, not when only the values change */
+    if (!i || i == 4) nselexpected++;
+    ierr = CheckSelections(i,nselexpected);CHKERRQ(ierr);
+    ierr = MatMultAddEqual(A,B,3,&flg);CHKERRQ(ierr);
+    if (!flg) {ierr = PetscPrintf(PETSC_COMM_WORLD,"%D: MatMultAdd differs\n",i);CHKERRQ(ierr);}
+    ierr = MatMultTransposeEqual(A,B,3,&flg);CHKERRQ(ierr);
+    if (!flg) {ierr = PetscPrintf(PETSC_COMM_WORLD,"%D: MatMultTranspose differs\n",i);CHKERRQ(ierr);}
+
+    /* a duplicate selects its own format */
+    ierr = MatDuplicate(B,MAT_COPY_VALUES,&C);CHKERRQ(ierr);
+    ierr = MatMultEqual(A,C,3,&flg);CHKERRQ(ierr);
+    if (!flg) {ierr = PetscPrintf(PETSC_COMM_WORLD,"%D: MatMult of the duplicate differs\n",i);CHKERRQ(ierr);}
+    nselexpected++;
+    ierr = CheckSelections(i,nselexpected);CHKERRQ(ierr);
+    ierr = MatDestroy(&C);CHKERRQ(ierr);
+  }
+
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&b);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = MatDestroy(&B);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      suffix: 1
+      args: -dof {{1 3}} -mat_aijauto_formats {{aij sell aijperm aijcrl baij}}
+
+   test:
+      suffix: 2
+      nsize: 3
+      args: -dof {{1 2}}
+      output_file: output/ex309_1.out
+
+   test:
+      suffix: 3
+      nsize: 2
+      args: -m 3 -dof 2 -mat_aijauto_formats sell,baij -mat_aijauto_sell_fill 10
+      output_file: output/ex309_1.out
+
+   test:
+      suffix: 4
+      nsize: 2
+      args: -dof {{1 2}} -mat_aijauto_formats {{aij sell aijcrl baij}}
+      output_file: output/ex309_1.out
+
+TEST*/
@@ -86,4 +86,14 @@ int main(int argc,char **args)
    test:
       filter: grep -v "MPI processes"
 
+   testset:
+      args: -viewer_binary_mmap
+      filter: grep -v "MPI processes" | sed -e "s/mpiaij/seqaij/g"
+      output_file: output/ex31_1.out
+      test:
+         suffix: mmap
+      test:
+         suffix: mmap_2
+         nsize: 3
+
 TEST*/
@@ -0,0 +1,175 @@
+static char help[] = "Tests MATAIJVBLOCK, which stores the matrix as dense blocks of variable size, against MATAIJ and MATBAIJ.\n\
+Input parameters include\n\
+  -n <n>     : number of nodes\n\
+  -dof <dof> : number of unknowns at each node, by default the nodes have 3, 4 and 7 unknowns in turn\n\n";
+
+#include <petscmat.h>
+
+int main(int argc,char **args)
+{
+  Mat            A,B,C;
+  Vec            x,y,z,b;
+  PetscInt       n = 12,dof = 0,ndof[3] = {3,4,7},p,q,r,c,Ii,J,nstart,nend,*first,nlocal,k,nb,it,*bsizes;
+  PetscInt       i,ndiag,ncols,cols[35];
+  const PetscInt *vbsizes;
+  PetscScalar    v[35],*diagA,*diagB;
+  PetscReal      nrm,ynrm,bnrm,dnrm,tol = 1.e-12;
+  PetscBool      flg;
+  PetscMPIInt    rank,size;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = MPI_Comm_rank(PETSC_COMM_WORLD,&rank);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(PETSC_COMM_WORLD,&size);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-dof",&dof,NULL);CHKERRQ(ierr);
+  if (dof) ndof[0] = ndof[1] = ndof[2] = dof;
+
+  /* each process owns whole nodes, coupled densely with the nodes up to two away */
+  ierr   = PetscMalloc1(n+1,&first);CHKERRQ(ierr);
+  first[0] = 0;
+  for (p=0; p<n; p++) first[p+1] = first[p] + ndof[p%3];
+  nstart = (rank*n)/size;
+  nend   = ((rank+1)*n)/size;
+  nlocal = first[nend] - first[nstart];
+  ierr   = MatCreate(PETSC_COMM_WORLD,&A);CHKERRQ(ierr);
+  ierr   = MatSetSizes(A,nlocal,nlocal,PETSC_DETERMINE,PETSC_DETERMINE);CHKERRQ(ierr);
+  if (dof) {ierr = MatSetBlockSize(A,dof);CHKERRQ(ierr);}
+  ierr   = MatSetType(A,MATAIJ);CHKERRQ(ierr);
+  ierr   = MatSeqAIJSetPreallocation(A,35,NULL);CHKERRQ(ierr);
+  ierr   = MatMPIAIJSetPreallocation(A,35,NULL,28,NULL);CHKERRQ(ierr);
+  for (p=nstart; p<nend; p++) {
+    for (r=0; r<ndof[p%3]; r++) {
+      Ii    = first[p] + r;
+      ncols = 0;
+      for (q=PetscMax(p-2,0); q<PetscMin(p+3,n); q++) {
+        for (c=0; c<ndof[q%3]; c++) {
+          J             = first[q] + c;
+          cols[ncols]   = J;
+          v[ncols++]    = (q == p) ? (r == c ? 20.0 + 0.1*(Ii%5) : 1.0/(1.0 + r + c)) : -1.0/(2.0 + r + c + PetscAbsInt(p-q));
+        }
+      }
+      ierr = MatSetValues(A,1,&Ii,ncols,cols,v,INSERT_VALUES);CHKERRQ(ierr);
+    }
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+
+  ierr = MatCreateVecs(A,&x,&y);CHKERRQ(ierr);
+  ierr = VecDuplicate(y,&z);CHKERRQ(ierr);
+  ierr = VecDuplicate(y,&b);CHKERRQ(ierr);
+  for (Ii=first[nstart]; Ii<first[nend]; Ii++) {
+    v[0] = (Ii*7)%17 - 8.1;
+    ierr = VecSetValues(x,1,&Ii,v,INSERT_VALUES);CHKERRQ(ierr);
+    v[0] = (Ii*5)%13 - 6.2;
+    ierr = VecSetValues(b,1,&Ii,v,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = VecAssemblyBegin(x);CHKERRQ(ierr);
+  ierr = VecAssemblyEnd(x);CHKERRQ(ierr);
+  ierr = VecAssemblyBegin(b);CHKERRQ(ierr);
+  ierr = VecAssemblyEnd(b);CHKERRQ(ierr);
+
+  /* the blocks are the nodes detected from the nonzero structure (k = 0), then pairs of nodes set by the user (k = 1) */
+  for (k=0; k<2; k++) {
+    if (k) {
+      ierr = PetscMalloc1(nend-nstart,&bsizes);CHKERRQ(ierr);
+      for (nb=0,p=nstart; p<nend; p+=2) bsizes[nb++] = first[PetscMin(p+2,nend)] - first[p];
+      ierr = MatSetVariableBlockSizes(A,nb,bsizes);CHKERRQ(ierr);
+      ierr = PetscFree(bsizes);CHKERRQ(ierr);
+    }
+    ierr = MatConvert(A,MATAIJVBLOCK,MAT_INITIAL_MATRIX,&B);CHKERRQ(ierr);
+    ierr = MatGetVariableBlockSizes(B,&nb,&vbsizes);CHKERRQ(ierr);
+    if (k) {
+      /* the blocks that were set are kept */
+      for (i=0; i<nb; i++) {
+        p = nstart + 2*i;
+        if (vbsizes[i] != first[PetscMin(p+2,nend)] - first[p]) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Block %D has size %D",i,vbsizes[i]);
+      }
+    } else {
+      /* the detected blocks are nodes, or several nodes when their rows have the same nonzero columns in the diagonal block of the process */
+      for (Ii=first[nstart],p=nstart,i=0; i<nb; i++) {
+        Ii += vbsizes[i];
+        while (first[p] < Ii) p++;
+        if (first[p] != Ii) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Block %D is not made of nodes",i);
+      }
+    }
+
+    for (it=0; it<2; it++) {
+      /* the blocks must follow the changes of the values */
+      if (it) {
+        ierr = MatScale(A,2.0);CHKERRQ(ierr);
+        ierr = MatScale(B,2.0);CHKERRQ(ierr);
+        ierr = MatShift(A,1.0);CHKERRQ(ierr);
+        ierr = MatShift(B,1.0);CHKERRQ(ierr);
+      }
+      ierr = MatMultEqual(A,B,3,&flg);CHKERRQ(ierr);
+      if (!flg) {ierr = PetscPrintf(PETSC_COMM_WORLD,"%D: MatMult differs\n",k);CHKERRQ(ierr);}
+      ierr = MatMultAddEqual(A,B,3,&flg);CHKERRQ(ierr);
+      if (!flg) {ierr = PetscPrintf(PETSC_COMM_WORLD,"%D: MatMultAdd differs\n",k);CHKERRQ(ierr);}
+
+      /* the inverses of the diagonal blocks used by PCVPBJACOBI */
+      for (ndiag=0,i=0; i<nb; i++) ndiag += vbsizes[i]*vbsizes[i];
+      ierr = PetscMalloc2(ndiag,&diagA,ndiag,&diagB);CHKERRQ(ierr);
+      ierr = MatInvertVariableBlockDiagonal(A,nb,vbsizes,diagA);CHKERRQ(ierr);
+      ierr = MatInvertVariableBlockDiagonal(B,nb,vbsizes,diagB);CHKERRQ(ierr);
+      for (nrm=0.0,dnrm=0.0,i=0; i<ndiag; i++) {
+        nrm  = PetscMax(nrm,PetscAbsScalar(diagA[i]-diagB[i]));
+        dnrm = PetscMax(dnrm,PetscAbsScalar(diagA[i]));
+      }
+      ierr = MPIU_Allreduce(MPI_IN_PLACE,&nrm,1,MPIU_REAL,MPIU_MAX,PETSC_COMM_WORLD);CHKERRQ(ierr);
+      ierr = MPIU_Allreduce(MPI_IN_PLACE,&dnrm,1,MPIU_REAL,MPIU_MAX,PETSC_COMM_WORLD);CHKERRQ(ierr);
+      if (nrm > tol*dnrm) {ierr = PetscPrintf(PETSC_COMM_WORLD,"%D: MatInvertVariableBlockDiagonal differs by %g\n",k,(double)(nrm/dnrm));CHKERRQ(ierr);}
+      ierr = PetscFree2(diagA,diagB);CHKERRQ(ierr);
+    }
+
+    /* block SOR with the same blocks as BAIJ is the SOR of BAIJ, or the point SOR of AIJ for blocks of size 1; the
+       detected blocks may merge several nodes though, then there is no reference */
+    for (flg=(PetscBool)(dof > 0),i=0; i<nb; i++) if (vbsizes[i] != dof) flg = PETSC_FALSE;
+    ierr = MPIU_Allreduce(MPI_IN_PLACE,&flg,1,MPIU_BOOL,MPI_LAND,PETSC_COMM_WORLD);CHKERRQ(ierr);
+    if (flg) {
+      ierr = MatConvert(A,dof == 1 ? MATAIJ : MATBAIJ,MAT_INITIAL_MATRIX,&C);CHKERRQ(ierr);
+      ierr = MatSOR(C,b,1.0,(MatSORType)(SOR_ZERO_INITIAL_GUESS | SOR_LOCAL_SYMMETRIC_SWEEP),0.0,2,1,y);CHKERRQ(ierr);
+      ierr = MatSOR(B,b,1.0,(MatSORType)(SOR_ZERO_INITIAL_GUESS | SOR_LOCAL_SYMMETRIC_SWEEP),0.0,2,1,z);CHKERRQ(ierr);
+      ierr = VecNorm(y,NORM_INFINITY,&ynrm);CHKERRQ(ierr);
+      ierr = VecAXPY(z,-1.0,y);CHKERRQ(ierr);
+      ierr = VecNorm(z,NORM_INFINITY,&nrm);CHKERRQ(ierr);
+      if (nrm > tol*ynrm) {ierr = PetscPrintf(PETSC_COMM_WORLD,"%D: MatSOR differs by %g\n",k,(double)(nrm/ynrm));CHKERRQ(ierr);}
+      ierr = MatDestroy(&C);CHKERRQ(ierr);
+    }
+
+    /* the relaxations converge to the solution */
+    ierr = VecSet(z,0.0);CHKERRQ(ierr);
+    for (it=0; it<20; it++) {
+      ierr = MatSOR(B,b,0.9,SOR_LOCAL_SYMMETRIC_SWEEP,0.0,1,1,z);CHKERRQ(ierr);
+    }
+    ierr = MatMult(B,z,y);CHKERRQ(ierr);
+    ierr = VecAXPY(y,-1.0,b);CHKERRQ(ierr);
+    ierr = VecNorm(y,NORM_2,&nrm);CHKERRQ(ierr);
+    ierr = VecNorm(b,NORM_2,&bnrm);CHKERRQ(ierr);
+    if (nrm > 1.e-10*bnrm) {ierr = PetscPrintf(PETSC_COMM_WORLD,"%D: relative residual of MatSOR %g\n",k,(double)(nrm/bnrm));CHKERRQ(ierr);}
+    ierr = MatDestroy(&B);CHKERRQ(ierr);
+  }
+
+  ierr = PetscFree(first);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = VecDestroy(&z);CHKERRQ(ierr);
+  ierr = VecDestroy(&b);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      suffix: 1
+      nsize: {{1 3}}
+
+   test:
+      suffix: 2
+      nsize: {{1 2 3}}
+      args: -dof {{1 2 3}}
+      output_file: output/ex310_1.out
+
+TEST*/
@@ -0,0 +1,152 @@
+static char help[] = "Tests that the products of MATAIJDELTA, which compresses the column indices, are those of MATAIJ.\n\
+Input parameters include\n\
+  -n <n> : number of rows, each row couples with the rows 1 and 300 away and with one row half of the matrix away\n\n";
+
+#include <petscmat.h>
+
+int main(int argc,char **args)
+{
+  Mat            A,B,C;
+  Vec            x,y,z,b,xt,yt,zt;
+  PetscInt       i,k,Ii,J,n = 1000,rstart,rend,cols[7],ncols;
+  PetscScalar    v[7];
+  PetscBool      flg;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+
+  /*
+     the differences of the columns of a row are 1, 300 (which needs 16 bits) and about n/2 (which may not fit in 16 bits),
+     so the full columns stored for the differences that do not fit come in the middle of the rows; every tenth row is
+     empty
+  */
+  ierr = MatCreateAIJ(PETSC_COMM_WORLD,PETSC_DECIDE,PETSC_DECIDE,n,n,7,NULL,7,NULL,&A);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(A,&rstart,&rend);CHKERRQ(ierr);
+  for (Ii=rstart; Ii<rend; Ii++) {
+    if (Ii%10 == 9) continue;
+    ncols = 0;
+    if (Ii >= 300)    {cols[ncols] = Ii - 300; v[ncols++] = -0.5;}
+    if (Ii > 0)       {cols[ncols] = Ii - 1;   v[ncols++] = -1.0;}
+    cols[ncols] = Ii; v[ncols++] = 4.0 + 0.1*(Ii%7);
+    if (Ii < n-1)     {cols[ncols] = Ii + 1;   v[ncols++] = -1.0;}
+    if (Ii < n-300)   {cols[ncols] = Ii + 300; v[ncols++] = -0.5;}
+    cols[ncols] = (Ii + n/2) % n; v[ncols++] = 0.01*(Ii%3);
+    ierr = MatSetValues(A,1,&Ii,ncols,cols,v,ADD_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  /* without inodes the AIJ kernels sum the entries of a row in the same order, so the products must be identical */
+  ierr = MatSetOption(A,MAT_USE_INODES,PETSC_FALSE);CHKERRQ(ierr);
+  ierr = MatConvert(A,MATAIJDELTA,MAT_INITIAL_MATRIX,&B);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompareAny((PetscObject)B,&flg,MATSEQAIJDELTA,MATMPIAIJDELTA,"");CHKERRQ(ierr);
+  if (!flg) SETERRQ(PETSC_COMM_WORLD,PETSC_ERR_PLIB,"Wrong matrix type");
+
+  ierr = MatCreateVecs(A,&x,&y);CHKERRQ(ierr);
+  ierr = VecDuplicate(y,&z);CHKERRQ(ierr);
+  ierr = VecDuplicate(y,&b);CHKERRQ(ierr);
+  for (Ii=rstart; Ii<rend; Ii++) {
+    v[0] = (Ii*7)%17 - 8.1;
+    ierr = VecSetValues(x,1,&Ii,v,INSERT_VALUES);CHKERRQ(ierr);
+    v[0] = (Ii*5)%13 - 6.2;
+    ierr = VecSetValues(b,1,&Ii,v,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = VecAssemblyBegin(x);CHKERRQ(ierr);
+  ierr = VecAssemblyEnd(x);CHKERRQ(ierr);
+  ierr = VecAssemblyBegin(b);CHKERRQ(ierr);
+  ierr = VecAssemblyEnd(b);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&xt);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&yt);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&zt);CHKERRQ(ierr);
+  ierr = VecCopy(b,xt);CHKERRQ(ierr);
+
+  /* the compressed column indices must follow changes of the nonzero structure, the values are shared with AIJ */
+  for (i=0; i<3; i++) {
+    if (i == 1) {
+      ierr = MatScale(A,2.0);CHKERRQ(ierr);
+      ierr = MatScale(B,2.0);CHKERRQ(ierr);
+      ierr = MatDiagonalScale(A,b,x);CHKERRQ(ierr);
+      ierr = MatDiagonalScale(B,b,x);CHKERRQ(ierr);
+    } else if (i == 2) {
+      /* new nonzeros in the first rows of each process, with differences of the columns that fit in 8 bits */
+      ierr = MatSetOption(A,MAT_NEW_NONZERO_ALLOCATION_ERR,PETSC_FALSE);CHKERRQ(ierr);
+      ierr = MatSetOption(B,MAT_NEW_NONZERO_ALLOCATION_ERR,PETSC_FALSE);CHKERRQ(ierr);
+      for (Ii=rstart; Ii<PetscMin(rstart+100,rend); Ii++) {
+        for (k=0; k<3; k++) {
+          J    = (Ii + 3 + 50*k) % n;
+          v[0] = 0.02*k;
+          ierr = MatSetValues(A,1,&Ii,1,&J,v,ADD_VALUES);CHKERRQ(ierr);
+          ierr = MatSetValues(B,1,&Ii,1,&J,v,ADD_VALUES);CHKERRQ(ierr);
+        }
+      }
+      ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+      ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+      ierr = MatAssemblyBegin(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+      ierr = MatAssemblyEnd(B,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+    }
+    ierr = MatMult(A,x,y);CHKERRQ(ierr);
+    ierr = MatMult(B,x,z);CHKERRQ(ierr);
+    ierr = VecEqual(z,y,&flg);CHKERRQ(ierr);
+    if (!flg) {ierr = PetscPrintf(PETSC_COMM_WORLD,"%D: MatMult differs\n",i);CHKERRQ(ierr);}
+
+    ierr = MatMultAdd(A,x,b,y);CHKERRQ(ierr);
+    ierr = MatMultAdd(B,x,b,z);CHKERRQ(ierr);
+    ierr = VecEqual(z,y,&flg);CHKERRQ(ierr);
+    if (!flg) {ierr = PetscPrintf(PETSC_COMM_WORLD,"%D: MatMultAdd differs\n",i);CHKERRQ(ierr);}
+
+    ierr = VecCopy(b,z);CHKERRQ(ierr);
+    ierr = MatMultAdd(B,x,z,z);CHKERRQ(ierr);
+    ierr = MatMultAdd(A,x,b,y);CHKERRQ(ierr);
+    ierr = VecEqual(z,y,&flg);CHKERRQ(ierr);
+    if (!flg) {ierr = PetscPrintf(PETSC_COMM_WORLD,"%D: MatMultAdd in place differs\n",i);CHKERRQ(ierr);}
+
+    ierr = MatMultTranspose(A,xt,yt);CHKERRQ(ierr);
+    ierr = MatMultTranspose(B,xt,zt);CHKERRQ(ierr);
+    ierr = VecEqual(zt,yt,&flg);CHKERRQ(ierr);
+    if (!flg) {ierr = PetscPrintf(PETSC_COMM_WORLD,"%D: MatMultTranspose differs\n",i);CHKERRQ(ierr);}
+
+    ierr = MatMultTransposeAdd(A,xt,x,yt);CHKERRQ(ierr);
+    ierr = MatMultTransposeAdd(B,xt,x,zt);CHKERRQ(ierr);
+    ierr = VecEqual(zt,yt,&flg);CHKERRQ(ierr);
+    if (!flg) {ierr = PetscPrintf(PETSC_COMM_WORLD,"%D: MatMultTransposeAdd differs\n",i);CHKERRQ(ierr);}
+
+    /* a duplicate compresses its own column indices, the conversion back to AIJ uses the AIJ kernels */
+    ierr = MatDuplicate(B,MAT_COPY_VALUES,&C);CHKERRQ(ierr);
+    ierr = MatMult(A,x,y);CHKERRQ(ierr);
+    ierr = MatMult(C,x,z);CHKERRQ(ierr);
+    ierr = VecEqual(z,y,&flg);CHKERRQ(ierr);
+    if (!flg) {ierr = PetscPrintf(PETSC_COMM_WORLD,"%D: MatMult of the duplicate differs\n",i);CHKERRQ(ierr);}
+    ierr = MatConvert(C,MATAIJ,MAT_INPLACE_MATRIX,&C);CHKERRQ(ierr);
+    ierr = MatMult(C,x,z);CHKERRQ(ierr);
+    ierr = VecEqual(z,y,&flg);CHKERRQ(ierr);
+    if (!flg) {ierr = PetscPrintf(PETSC_COMM_WORLD,"%D: MatMult of the conversion to AIJ differs\n",i);CHKERRQ(ierr);}
+    ierr = MatDestroy(&C);CHKERRQ(ierr);
+  }
+
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = VecDestroy(&z);CHKERRQ(ierr);
+  ierr = VecDestroy(&b);CHKERRQ(ierr);
+  ierr = VecDestroy(&xt);CHKERRQ(ierr);
+  ierr = VecDestroy(&yt);CHKERRQ(ierr);
+  ierr = VecDestroy(&zt);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = MatDestroy(&B);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      suffix: 1
+      nsize: {{1 3}}
+      args: -mat_aijdelta_bits {{0 8 16}}
+
+   test:
+      suffix: 2
+      nsize: {{1 2}}
+      args: -n 140000
+      output_file: output/ex311_1.out
+
+TEST*/
@@ -0,0 +1,118 @@
+static char help[] = "Tests MatSOR() of AIJ matrices with SOR_MULTICOLOR.\n\
+Input parameters include\n\
+  -m <m>       : number of grid points in each direction\n\
+  -omega <w>   : relaxation factor\n\
+  -nonsymmetric: couple some grid points with a point two to the right, but not the other way\n\n";
+
+#include <petscmat.h>
+
+/* relative residual of x after its sweeps of type flag from a zero initial guess */
+static PetscErrorCode Relax(Mat A,Vec b,PetscReal omega,MatSORType flag,PetscInt its,Vec x,PetscReal *rnorm)
+{
+  Vec            r;
+  PetscReal      bnorm;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecDuplicate(b,&r);CHKERRQ(ierr);
+  ierr = MatSOR(A,b,omega,(MatSORType)(flag | SOR_ZERO_INITIAL_GUESS | SOR_MULTICOLOR),0.0,its,1,x);CHKERRQ(ierr);
+  ierr = MatMult(A,x,r);CHKERRQ(ierr);
+  ierr = VecAXPY(r,-1.0,b);CHKERRQ(ierr);
+  ierr = VecNorm(r,NORM_2,rnorm);CHKERRQ(ierr);
+  ierr = VecNorm(b,NORM_2,&bnorm);CHKERRQ(ierr);
+  *rnorm /= bnorm;
+  ierr = VecDestroy(&r);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **args)
+{
+  Mat            A,B;
+  Vec            x,y,b;
+  PetscInt       i,j,k,Ii,J,m = 16,rstart,rend,its = 40;
+  PetscScalar    v;
+  PetscReal      omega = 1.0,rnorm,diff;
+  PetscBool      nonsymmetric = PETSC_FALSE;
+  MatSORType     sweeps[3] = {SOR_LOCAL_FORWARD_SWEEP,SOR_LOCAL_BACKWARD_SWEEP,SOR_LOCAL_SYMMETRIC_SWEEP};
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&args,(char*)0,help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-m",&m,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetReal(NULL,NULL,"-omega",&omega,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL,NULL,"-nonsymmetric",&nonsymmetric,NULL);CHKERRQ(ierr);
+
+  /* 2d Laplacian with a diagonal shift, so that the relaxations converge quickly */
+  ierr = MatCreateAIJ(PETSC_COMM_WORLD,PETSC_DECIDE,PETSC_DECIDE,m*m,m*m,6,NULL,6,NULL,&A);CHKERRQ(ierr);
+  ierr = MatGetOwnershipRange(A,&rstart,&rend);CHKERRQ(ierr);
+  for (Ii=rstart; Ii<rend; Ii++) {
+    i = Ii/m; j = Ii - i*m;
+    v = 6.0 + 0.1*(Ii%3);
+    ierr = MatSetValues(A,1,&Ii,1,&Ii,&v,INSERT_VALUES);CHKERRQ(ierr);
+    v = -1.0;
+    if (i>0)   {J = Ii - m; ierr = MatSetValues(A,1,&Ii,1,&J,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    if (i<m-1) {J = Ii + m; ierr = MatSetValues(A,1,&Ii,1,&J,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    if (j>0)   {J = Ii - 1; ierr = MatSetValues(A,1,&Ii,1,&J,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    if (j<m-1) {J = Ii + 1; ierr = MatSetValues(A,1,&Ii,1,&J,&v,INSERT_VALUES);CHKERRQ(ierr);}
+    if (nonsymmetric && j<m-2 && Ii%5 == 0) {J = Ii + 2; v = -0.3; ierr = MatSetValues(A,1,&Ii,1,&J,&v,INSERT_VALUES);CHKERRQ(ierr);}
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+
+  ierr = MatCreateVecs(A,&x,&b);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&y);CHKERRQ(ierr);
+  for (Ii=rstart; Ii<rend; Ii++) {
+    v    = (Ii*5)%13 - 6.2;
+    ierr = VecSetValues(b,1,&Ii,&v,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = VecAssemblyBegin(b);CHKERRQ(ierr);
+  ierr = VecAssemblyEnd(b);CHKERRQ(ierr);
+
+  /* the multicolor sweeps converge, also after a change of the nonzero structure (k = 1) */
+  for (k=0; k<2; k++) {
+    if (k) {
+      ierr = MatSetOption(A,MAT_NEW_NONZERO_ALLOCATION_ERR,PETSC_FALSE);CHKERRQ(ierr);
+      for (Ii=rstart; Ii<rend; Ii++) {
+        i = Ii/m; j = Ii - i*m;
+        if (i>0 && j>0) {J = Ii - m - 1; v = -0.2; ierr = MatSetValues(A,1,&Ii,1,&J,&v,INSERT_VALUES);CHKERRQ(ierr);}
+        if (i<m-1 && j<m-1) {J = Ii + m + 1; v = -0.2; ierr = MatSetValues(A,1,&Ii,1,&J,&v,INSERT_VALUES);CHKERRQ(ierr);}
+      }
+      ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+      ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+    }
+    for (i=0; i<3; i++) {
+      ierr = Relax(A,b,omega,sweeps[i],its,x,&rnorm);CHKERRQ(ierr);
+      if (rnorm > 1.e-8) {ierr = PetscPrintf(PETSC_COMM_WORLD,"%D: relative residual of the multicolor sweeps %D is %g\n",k,(PetscInt)sweeps[i],(double)rnorm);CHKERRQ(ierr);}
+    }
+  }
+
+  /* the rows of a color are independent, so the sweeps do not depend on the number of threads */
+  ierr = PetscOptionsSetValue(NULL,"-mat_sor_threads","3");CHKERRQ(ierr);
+  ierr = MatDuplicate(A,MAT_COPY_VALUES,&B);CHKERRQ(ierr);
+  ierr = Relax(A,b,omega,SOR_LOCAL_SYMMETRIC_SWEEP,2,x,&rnorm);CHKERRQ(ierr);
+  ierr = Relax(B,b,omega,SOR_LOCAL_SYMMETRIC_SWEEP,2,y,&rnorm);CHKERRQ(ierr);
+  ierr = VecAXPY(y,-1.0,x);CHKERRQ(ierr);
+  ierr = VecNorm(y,NORM_INFINITY,&diff);CHKERRQ(ierr);
+  if (diff != 0.0) {ierr = PetscPrintf(PETSC_COMM_WORLD,"The sweeps with 3 threads differ by %g\n",(double)diff);CHKERRQ(ierr);}
+  ierr = MatDestroy(&B);CHKERRQ(ierr);
+
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = VecDestroy(&b);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      suffix: 1
+      nsize: {{1 2}}
+      args: -nonsymmetric {{0 1}}
+
+   test:
+      suffix: 2
+      args: -omega 1.2 -mat_sor_coloring_type jp
+      output_file: output/ex312_1.out
+
+TEST*/
@@ -450,3 +450,180 @@ PetscErrorCode MatBindToCPU(Mat A,PetscBool flg)
   PetscFunctionReturn(0);
 #endif
 }
+
+typedef struct {
+  PetscInt n,*i,*j; /* the coordinates given to MatSetPreallocationCOO() */
+} MatCOO_Basic;
+
+static PetscErrorCode MatCOODestroy_Basic(void *ptr)
+{
+  MatCOO_Basic   *coo = (MatCOO_Basic*)ptr;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree2(coo->i,coo->j);CHKERRQ(ierr);
+  ierr = PetscFree(coo);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSetPreallocationCOO_Basic(Mat A,PetscInt ncoo,const PetscInt coo_i[],const PetscInt coo_j[])
+{
+  Mat            preallocator;
+  PetscContainer container;
+  MatCOO_Basic   *coo;
+  PetscInt       n;
+  PetscScalar    zero = 0.0;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = MatCreate(PetscObjectComm((PetscObject)A),&preallocator);CHKERRQ(ierr);
+  ierr = MatSetType(preallocator,MATPREALLOCATOR);CHKERRQ(ierr);
+  ierr = MatSetSizes(preallocator,A->rmap->n,A->cmap->n,A->rmap->N,A->cmap->N);CHKERRQ(ierr);
+  ierr = MatSetBlockSizesFromMats(preallocator,A,A);CHKERRQ(ierr);
+  ierr = MatSetUp(preallocator);CHKERRQ(ierr);
+  for (n=0; n<ncoo; n++) {
+    ierr = MatSetValues(preallocator,1,coo_i+n,1,coo_j+n,&zero,INSERT_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(preallocator,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(preallocator,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatPreallocatorPreallocate(preallocator,PETSC_TRUE,A);CHKERRQ(ierr);
+  ierr = MatDestroy(&preallocator);CHKERRQ(ierr);
+
+  /* keep a copy of the coordinates, MatSetValuesCOO_Basic() replays them through MatSetValues() */
+  ierr = PetscNew(&coo);CHKERRQ(ierr);
+  coo->n = ncoo;
+  ierr = PetscMalloc2(ncoo,&coo->i,ncoo,&coo->j);CHKERRQ(ierr);
+  ierr = PetscArraycpy(coo->i,coo_i,ncoo);CHKERRQ(ierr);
+  ierr = PetscArraycpy(coo->j,coo_j,ncoo);CHKERRQ(ierr);
+  ierr = PetscContainerCreate(PETSC_COMM_SELF,&container);CHKERRQ(ierr);
+  ierr = PetscContainerSetPointer(container,coo);CHKERRQ(ierr);
+  ierr = PetscContainerSetUserDestroy(container,MatCOODestroy_Basic);CHKERRQ(ierr);
+  ierr = PetscObjectCompose((PetscObject)A,"__PETSc_MatCOO_Basic",(PetscObject)container);CHKERRQ(ierr);
+  ierr = PetscContainerDestroy(&container);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatSetValuesCOO_Basic(Mat A,const PetscScalar coo_v[],InsertMode imode)
+{
+  PetscContainer container;
+  MatCOO_Basic   *coo;
+  PetscInt       n;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectQuery((PetscObject)A,"__PETSc_MatCOO_Basic",(PetscObject*)&container);CHKERRQ(ierr);
+  if (!container) SETERRQ(PetscObjectComm((PetscObject)A),PETSC_ERR_ARG_WRONGSTATE,"Must call MatSetPreallocationCOO() first");
+  ierr = PetscContainerGetPointer(container,(void**)&coo);CHKERRQ(ierr);
+  if (imode == INSERT_VALUES) {
+    ierr = MatZeroEntries(A);CHKERRQ(ierr);
+  }
+  for (n=0; n<coo->n; n++) {
+    ierr = MatSetValues(A,1,coo->i+n,1,coo->j+n,coo_v+n,ADD_VALUES);CHKERRQ(ierr);
+  }
+  ierr = MatAssemblyBegin(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  ierr = MatAssemblyEnd(A,MAT_FINAL_ASSEMBLY);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   MatSetPreallocationCOO - set preallocation for matrices using a coordinate format of the entries
+
+   Collective on Mat
+
+   Input Arguments:
++  A - matrix being preallocated
+.  ncoo - number of entries in the locally owned part of the coordinate format
+.  coo_i - row indices
+-  coo_j - column indices
+
+   Level: beginner
+
+   Notes:
+   The indices coo_i and coo_j are global and may be owned by any process; entries in rows owned by
+   other processes are sent to their owner. Entries with negative row or column indices are ignored.
+   Repeated entries are allowed; their values are summed by MatSetValuesCOO().
+
+   This routine computes the nonzero structure of the matrix, assembles it with zero values and records
+   how the values passed to MatSetValuesCOO() are to be mapped to the matrix storage, so that all the communication
+   and searching is done once. It is intended for applications that assemble matrices with the same nonzero
+   structure many times, for example time dependent finite element problems.
+
+   Types that do not provide a specialized implementation (currently only MATSEQAIJ and MATMPIAIJ and their
+   subclasses do) fall back to MatSetValues() followed by MatAssemblyBegin()/MatAssemblyEnd().
+
+.seealso: MatSetValuesCOO(), MatSeqAIJSetPreallocation(), MatMPIAIJSetPreallocation(), MatSeqBAIJSetPreallocation(), MatMPIBAIJSetPreallocation()
+@*/
+PetscErrorCode MatSetPreallocationCOO(Mat A,PetscInt ncoo,const PetscInt coo_i[],const PetscInt coo_j[])
+{
+  PetscErrorCode (*f)(Mat,PetscInt,const PetscInt[],const PetscInt[]) = NULL;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(A,MAT_CLASSID,1);
+  PetscValidType(A,1);
+  if (ncoo) PetscValidIntPointer(coo_i,3);
+  if (ncoo) PetscValidIntPointer(coo_j,4);
+  if (ncoo < 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Number of entries cannot be negative %D",ncoo);
+  ierr = PetscLayoutSetUp(A->rmap);CHKERRQ(ierr);
+  ierr = PetscLayoutSetUp(A->cmap);CHKERRQ(ierr);
+  if (PetscDefined(USE_DEBUG)) {
+    PetscInt i;
+    for (i=0; i<ncoo; i++) {
+      if (coo_i[i] >= A->rmap->N) SETERRQ3(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Row index %D of entry %D is too large, maximum %D",coo_i[i],i,A->rmap->N-1);
+      if (coo_j[i] >= A->cmap->N) SETERRQ3(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Column index %D of entry %D is too large, maximum %D",coo_j[i],i,A->cmap->N-1);
+    }
+  }
+  ierr = PetscObjectQueryFunction((PetscObject)A,"MatSetPreallocationCOO_C",&f);CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(MAT_PreallCOO,A,0,0,0);CHKERRQ(ierr);
+  if (f) {
+    ierr = (*f)(A,ncoo,coo_i,coo_j);CHKERRQ(ierr);
+  } else {
+    ierr = MatSetPreallocationCOO_Basic(A,ncoo,coo_i,coo_j);CHKERRQ(ierr);
+  }
+  ierr = PetscLogEventEnd(MAT_PreallCOO,A,0,0,0);CHKERRQ(ierr);
+  A->preallocated = PETSC_TRUE;
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   MatSetValuesCOO - set values at once in a matrix preallocated using MatSetPreallocationCOO()
+
+   Collective on Mat
+
+   Input Arguments:
++  A - matrix being filled
+.  coo_v - the values, in the same order as the coordinates given to MatSetPreallocationCOO()
+-  imode - the insert mode
+
+   Level: beginner
+
+   Notes:
+   With INSERT_VALUES the matrix entries are replaced by the (summed) values given in coo_v and the entries not given
+   are zeroed; with ADD_VALUES the values are added to the current matrix entries.
+
+   The matrix is assembled on return, there is no need to call MatAssemblyBegin()/MatAssemblyEnd().
+   No searching is done and the values in rows owned by other processes are communicated with a single
+   message to each of the processes recorded by MatSetPreallocationCOO().
+
+.seealso: MatSetPreallocationCOO(), MatSetValues(), InsertMode, INSERT_VALUES, ADD_VALUES
+@*/
+PetscErrorCode MatSetValuesCOO(Mat A,const PetscScalar coo_v[],InsertMode imode)
+{
+  PetscErrorCode (*f)(Mat,const PetscScalar[],InsertMode) = NULL;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(A,MAT_CLASSID,1);
+  PetscValidType(A,1);
+  PetscValidLogicalCollectiveEnum(A,imode,3);
+  if (imode != INSERT_VALUES && imode != ADD_VALUES) SETERRQ(PetscObjectComm((PetscObject)A),PETSC_ERR_ARG_OUTOFRANGE,"Only INSERT_VALUES and ADD_VALUES are supported");
+  ierr = PetscObjectQueryFunction((PetscObject)A,"MatSetValuesCOO_C",&f);CHKERRQ(ierr);
+  ierr = PetscLogEventBegin(MAT_SetVCOO,A,0,0,0);CHKERRQ(ierr);
+  if (f) {
+    ierr = (*f)(A,coo_v,imode);CHKERRQ(ierr);
+  } else {
+    ierr = MatSetValuesCOO_Basic(A,coo_v,imode);CHKERRQ(ierr);
+  }
+  ierr = PetscLogEventEnd(MAT_SetVCOO,A,0,0,0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
@@ -3856,6 +3856,7 @@ PetscErrorCode  SNESMonitor(SNES snes,PetscInt iter,PetscReal rnorm)
   PetscInt       i,n = snes->numbermonitors;
 
   PetscFunctionBegin;
+  ierr = PetscLogTimelineMark("SNESIteration",iter);CHKERRQ(ierr);
   ierr = VecLockReadPush(snes->vec_sol);CHKERRQ(ierr);
   for (i=0; i<n; i++) {
     ierr = (*snes->monitor[i])(snes,iter,rnorm,snes->monitorcontext[i]);CHKERRQ(ierr);
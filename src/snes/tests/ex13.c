@@ -0,0 +1,242 @@
+static char help[] = "Tests the matrix-free Jacobian of DMPlexSNESCreateJacobianMF() against the assembled Jacobian.\n\
+The nonlinear problem on tensor product cells couples the components and has all the pointwise Jacobian terms.\n\
+Input parameters include\n\
+  -dim <dim>  : dimension of the mesh\n\
+  -cells <n>  : number of cells in each direction\n\
+  -nc <nc>    : number of components of the field\n\
+  -solve      : also solve the problem with the matrix-free Jacobian\n\n";
+
+#include <petscdmplex.h>
+#include <petscsnes.h>
+#include <petscds.h>
+
+/* -div((1 + u_c^2) grad u_c + a d_{d+1} u_c) + b.grad u_c + u_c^3 + u_{c+1}/2 = 1 */
+static void f0_u(PetscInt dim, PetscInt Nf, PetscInt NfAux,
+                 const PetscInt uOff[], const PetscInt uOff_x[], const PetscScalar u[], const PetscScalar u_t[], const PetscScalar u_x[],
+                 const PetscInt aOff[], const PetscInt aOff_x[], const PetscScalar a[], const PetscScalar a_t[], const PetscScalar a_x[],
+                 PetscReal t, const PetscReal x[], PetscInt numConstants, const PetscScalar constants[], PetscScalar f0[])
+{
+  const PetscInt Nc = uOff[1] - uOff[0];
+  PetscInt       c, d;
+
+  for (c = 0; c < Nc; ++c) {
+    f0[c] = u[c]*u[c]*u[c] + 0.5*u[(c+1)%Nc] - 1.0;
+    for (d = 0; d < dim; ++d) f0[c] += (d+1.0)*0.3*u_x[c*dim+d];
+  }
+}
+
+static void f1_u(PetscInt dim, PetscInt Nf, PetscInt NfAux,
+                 const PetscInt uOff[], const PetscInt uOff_x[], const PetscScalar u[], const PetscScalar u_t[], const PetscScalar u_x[],
+                 const PetscInt aOff[], const PetscInt aOff_x[], const PetscScalar a[], const PetscScalar a_t[], const PetscScalar a_x[],
+                 PetscReal t, const PetscReal x[], PetscInt numConstants, const PetscScalar constants[], PetscScalar f1[])
+{
+  const PetscInt Nc = uOff[1] - uOff[0];
+  PetscInt       c, d;
+
+  for (c = 0; c < Nc; ++c) {
+    for (d = 0; d < dim; ++d) f1[c*dim+d] = (1.0 + u[c]*u[c])*u_x[c*dim+d] + 0.2*(1.0 + x[0])*u_x[c*dim+(d+1)%dim];
+  }
+}
+
+static void g0_uu(PetscInt dim, PetscInt Nf, PetscInt NfAux,
+                  const PetscInt uOff[], const PetscInt uOff_x[], const PetscScalar u[], const PetscScalar u_t[], const PetscScalar u_x[],
+                  const PetscInt aOff[], const PetscInt aOff_x[], const PetscScalar a[], const PetscScalar a_t[], const PetscScalar a_x[],
+                  PetscReal t, PetscReal u_tShift, const PetscReal x[], PetscInt numConstants, const PetscScalar constants[], PetscScalar g0[])
+{
+  const PetscInt Nc = uOff[1] - uOff[0];
+  PetscInt       c;
+
+  for (c = 0; c < Nc; ++c) {
+    g0[c*Nc+c]        += 3.0*u[c]*u[c];
+    g0[c*Nc+(c+1)%Nc] += 0.5;
+  }
+}
+
+static void g1_uu(PetscInt dim, PetscInt Nf, PetscInt NfAux,
+                  const PetscInt uOff[], const PetscInt uOff_x[], const PetscScalar u[], const PetscScalar u_t[], const PetscScalar u_x[],
+                  const PetscInt aOff[], const PetscInt aOff_x[], const PetscScalar a[], const PetscScalar a_t[], const PetscScalar a_x[],
+                  PetscReal t, PetscReal u_tShift, const PetscReal x[], PetscInt numConstants, const PetscScalar constants[], PetscScalar g1[])
+{
+  const PetscInt Nc = uOff[1] - uOff[0];
+  PetscInt       c, d;
+
+  for (c = 0; c < Nc; ++c) {
+    for (d = 0; d < dim; ++d) g1[(c*Nc+c)*dim+d] = (d+1.0)*0.3;
+  }
+}
+
+static void g2_uu(PetscInt dim, PetscInt Nf, PetscInt NfAux,
+                  const PetscInt uOff[], const PetscInt uOff_x[], const PetscScalar u[], const PetscScalar u_t[], const PetscScalar u_x[],
+                  const PetscInt aOff[], const PetscInt aOff_x[], const PetscScalar a[], const PetscScalar a_t[], const PetscScalar a_x[],
+                  PetscReal t, PetscReal u_tShift, const PetscReal x[], PetscInt numConstants, const PetscScalar constants[], PetscScalar g2[])
+{
+  const PetscInt Nc = uOff[1] - uOff[0];
+  PetscInt       c, d;
+
+  for (c = 0; c < Nc; ++c) {
+    for (d = 0; d < dim; ++d) g2[(c*Nc+c)*dim+d] = 2.0*u[c]*u_x[c*dim+d];
+  }
+}
+
+static void g3_uu(PetscInt dim, PetscInt Nf, PetscInt NfAux,
+                  const PetscInt uOff[], const PetscInt uOff_x[], const PetscScalar u[], const PetscScalar u_t[], const PetscScalar u_x[],
+                  const PetscInt aOff[], const PetscInt aOff_x[], const PetscScalar a[], const PetscScalar a_t[], const PetscScalar a_x[],
+                  PetscReal t, PetscReal u_tShift, const PetscReal x[], PetscInt numConstants, const PetscScalar constants[], PetscScalar g3[])
+{
+  const PetscInt Nc = uOff[1] - uOff[0];
+  PetscInt       c, d;
+
+  for (c = 0; c < Nc; ++c) {
+    for (d = 0; d < dim; ++d) {
+      g3[((c*Nc+c)*dim+d)*dim+d]         += 1.0 + u[c]*u[c];
+      g3[((c*Nc+c)*dim+d)*dim+(d+1)%dim] += 0.2*(1.0 + x[0]);
+    }
+  }
+}
+
+static PetscErrorCode zero(PetscInt dim, PetscReal time, const PetscReal x[], PetscInt Nc, PetscScalar *u, void *ctx)
+{
+  PetscInt c;
+  for (c = 0; c < Nc; ++c) u[c] = 0.0;
+  return 0;
+}
+
+int main(int argc, char **argv)
+{
+  DM             dm, dmDist;
+  PetscFE        fe;
+  PetscDS        ds;
+  SNES           snes;
+  KSP            ksp;
+  PC             pc;
+  Mat            J, A;
+  Vec            u, locU, y, z, w;
+  PetscRandom    rand;
+  PetscInt       dim = 2, Nc = 1, cells[3] = {3, 3, 3}, n = 3, d;
+  const PetscInt id = 1;
+  PetscReal      nrm, ynrm;
+  PetscBool      solve = PETSC_FALSE, flg;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc, &argv, NULL, help);if (ierr) return ierr;
+  ierr = PetscOptionsGetInt(NULL, NULL, "-dim", &dim, NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL, NULL, "-nc", &Nc, NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL, NULL, "-cells", &n, NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetBool(NULL, NULL, "-solve", &solve, NULL);CHKERRQ(ierr);
+  for (d = 0; d < dim; ++d) cells[d] = n;
+  ierr = DMPlexCreateBoxMesh(PETSC_COMM_WORLD, dim, PETSC_FALSE, cells, NULL, NULL, NULL, PETSC_TRUE, &dm);CHKERRQ(ierr);
+  ierr = DMPlexDistribute(dm, 0, NULL, &dmDist);CHKERRQ(ierr);
+  if (dmDist) {
+    ierr = DMDestroy(&dm);CHKERRQ(ierr);
+    dm   = dmDist;
+  }
+  ierr = DMSetFromOptions(dm);CHKERRQ(ierr);
+  ierr = PetscFECreateDefault(PETSC_COMM_WORLD, dim, Nc, PETSC_FALSE, NULL, -1, &fe);CHKERRQ(ierr);
+  ierr = DMSetField(dm, 0, NULL, (PetscObject) fe);CHKERRQ(ierr);
+  ierr = PetscFEDestroy(&fe);CHKERRQ(ierr);
+  ierr = DMCreateDS(dm);CHKERRQ(ierr);
+  ierr = DMGetDS(dm, &ds);CHKERRQ(ierr);
+  ierr = PetscDSSetResidual(ds, 0, f0_u, f1_u);CHKERRQ(ierr);
+  ierr = PetscDSSetJacobian(ds, 0, 0, g0_uu, g1_uu, g2_uu, g3_uu);CHKERRQ(ierr);
+  ierr = DMAddBoundary(dm, DM_BC_ESSENTIAL, "wall", "marker", 0, 0, NULL, (void (*)(void)) zero, 1, &id, NULL);CHKERRQ(ierr);
+  ierr = DMPlexSetSNESLocalFEM(dm, NULL, NULL, NULL);CHKERRQ(ierr);
+
+  /* a nonzero linearization point, with the boundary values */
+  ierr = DMCreateGlobalVector(dm, &u);CHKERRQ(ierr);
+  ierr = VecDuplicate(u, &y);CHKERRQ(ierr);
+  ierr = VecDuplicate(u, &z);CHKERRQ(ierr);
+  ierr = PetscRandomCreate(PETSC_COMM_WORLD, &rand);CHKERRQ(ierr);
+  ierr = PetscRandomSetInterval(rand, -1.0, 1.0);CHKERRQ(ierr);
+  ierr = VecSetRandom(u, rand);CHKERRQ(ierr);
+  ierr = DMGetLocalVector(dm, &locU);CHKERRQ(ierr);
+  ierr = DMGlobalToLocalBegin(dm, u, INSERT_VALUES, locU);CHKERRQ(ierr);
+  ierr = DMGlobalToLocalEnd(dm, u, INSERT_VALUES, locU);CHKERRQ(ierr);
+  ierr = DMPlexInsertBoundaryValues(dm, PETSC_TRUE, locU, 0.0, NULL, NULL, NULL);CHKERRQ(ierr);
+
+  ierr = DMCreateMatrix(dm, &J);CHKERRQ(ierr);
+  ierr = DMPlexSNESCreateJacobianMF(dm, &A);CHKERRQ(ierr);
+  ierr = DMPlexSNESComputeJacobianFEM(dm, locU, J, J, NULL);CHKERRQ(ierr);
+  ierr = DMPlexSNESComputeJacobianFEM(dm, locU, A, A, NULL);CHKERRQ(ierr);
+  /* the actions by sum factorization agree with the assembled Jacobian up to rounding */
+  ierr = MatMultEqual(J, A, 3, &flg);CHKERRQ(ierr);
+  if (!flg) {ierr = PetscPrintf(PETSC_COMM_WORLD, "MatMult of the matrix-free Jacobian differs\n");CHKERRQ(ierr);}
+  ierr = MatMultTransposeEqual(J, A, 3, &flg);CHKERRQ(ierr);
+  if (!flg) {ierr = PetscPrintf(PETSC_COMM_WORLD, "MatMultTranspose of the matrix-free Jacobian differs\n");CHKERRQ(ierr);}
+  /* the diagonal used by PCJACOBI and Chebyshev is computed without assembling the element matrices */
+  ierr = MatGetDiagonal(J, y);CHKERRQ(ierr);
+  ierr = MatGetDiagonal(A, z);CHKERRQ(ierr);
+  ierr = VecNorm(y, NORM_INFINITY, &ynrm);CHKERRQ(ierr);
+  ierr = VecAXPY(z, -1.0, y);CHKERRQ(ierr);
+  ierr = VecNorm(z, NORM_INFINITY, &nrm);CHKERRQ(ierr);
+  if (nrm > 1.e-10*ynrm) {ierr = PetscPrintf(PETSC_COMM_WORLD, "MatGetDiagonal of the matrix-free Jacobian differs by %g\n", (double) (nrm/ynrm));CHKERRQ(ierr);}
+  /* the matrix-free Jacobian as the operator only, the preconditioner is assembled */
+  ierr = DMPlexSNESComputeJacobianFEM(dm, locU, A, J, NULL);CHKERRQ(ierr);
+  ierr = MatMultEqual(J, A, 3, &flg);CHKERRQ(ierr);
+  if (!flg) {ierr = PetscPrintf(PETSC_COMM_WORLD, "MatMult of the matrix-free Jacobian with an assembled preconditioner differs\n");CHKERRQ(ierr);}
+
+  /* as between two Newton steps, PCJACOBI must use the diagonal at the new linearization point */
+  ierr = KSPCreate(PETSC_COMM_WORLD, &ksp);CHKERRQ(ierr);
+  ierr = KSPSetOperators(ksp, A, A);CHKERRQ(ierr);
+  ierr = KSPGetPC(ksp, &pc);CHKERRQ(ierr);
+  ierr = PCSetType(pc, PCJACOBI);CHKERRQ(ierr);
+  ierr = KSPSetUp(ksp);CHKERRQ(ierr);
+  ierr = PCApply(pc, y, z);CHKERRQ(ierr); /* PCJACOBI gets the diagonal at its first application */
+  ierr = VecScale(u, 2.0);CHKERRQ(ierr);
+  ierr = DMGlobalToLocalBegin(dm, u, INSERT_VALUES, locU);CHKERRQ(ierr);
+  ierr = DMGlobalToLocalEnd(dm, u, INSERT_VALUES, locU);CHKERRQ(ierr);
+  ierr = DMPlexInsertBoundaryValues(dm, PETSC_TRUE, locU, 0.0, NULL, NULL, NULL);CHKERRQ(ierr);
+  ierr = DMPlexSNESComputeJacobianFEM(dm, locU, A, A, NULL);CHKERRQ(ierr);
+  ierr = KSPSetUp(ksp);CHKERRQ(ierr);
+  ierr = VecDuplicate(u, &w);CHKERRQ(ierr);
+  ierr = VecSetRandom(y, rand);CHKERRQ(ierr);
+  ierr = PCApply(pc, y, z);CHKERRQ(ierr);
+  ierr = MatGetDiagonal(A, w);CHKERRQ(ierr);
+  ierr = VecPointwiseDivide(w, y, w);CHKERRQ(ierr);
+  ierr = VecNorm(w, NORM_INFINITY, &ynrm);CHKERRQ(ierr);
+  ierr = VecAXPY(z, -1.0, w);CHKERRQ(ierr);
+  ierr = VecNorm(z, NORM_INFINITY, &nrm);CHKERRQ(ierr);
+  if (nrm > 1.e-12*ynrm) {ierr = PetscPrintf(PETSC_COMM_WORLD, "PCJACOBI was not set up again after the linearization point changed\n");CHKERRQ(ierr);}
+  ierr = VecDestroy(&w);CHKERRQ(ierr);
+  ierr = KSPDestroy(&ksp);CHKERRQ(ierr);
+  ierr = DMRestoreLocalVector(dm, &locU);CHKERRQ(ierr);
+
+  if (solve) {
+    ierr = SNESCreate(PETSC_COMM_WORLD, &snes);CHKERRQ(ierr);
+    ierr = SNESSetDM(snes, dm);CHKERRQ(ierr);
+    ierr = SNESSetJacobian(snes, A, A, NULL, NULL);CHKERRQ(ierr);
+    ierr = SNESSetFromOptions(snes);CHKERRQ(ierr);
+    ierr = VecSet(u, 0.0);CHKERRQ(ierr);
+    ierr = SNESSolve(snes, NULL, u);CHKERRQ(ierr);
+    ierr = SNESDestroy(&snes);CHKERRQ(ierr);
+  }
+
+  ierr = PetscRandomDestroy(&rand);CHKERRQ(ierr);
+  ierr = MatDestroy(&J);CHKERRQ(ierr);
+  ierr = MatDestroy(&A);CHKERRQ(ierr);
+  ierr = VecDestroy(&u);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = VecDestroy(&z);CHKERRQ(ierr);
+  ierr = DMDestroy(&dm);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      suffix: 2d
+      nsize: {{1 2}}
+      args: -petscspace_degree {{1 2 4}} -nc {{1 2}}
+      output_file: output/ex13_1.out
+
+   test:
+      suffix: 3d
+      nsize: {{1 3}}
+      args: -dim 3 -cells 2 -petscspace_degree {{1 2}} -nc {{1 3}} -dm_plex_jacobian_mf_batch_size 3
+      output_file: output/ex13_1.out
+
+   test:
+      suffix: solve
+      args: -dim 3 -cells 2 -petscspace_degree 4 -solve -snes_converged_reason -ksp_type gmres -pc_type jacobi -ksp_rtol 1.e-10 -snes_rtol 1.e-8
+
+TEST*/
@@ -1130,4 +1130,17 @@ PetscErrorCode NonlinearGS(SNES snes, Vec X, Vec B, void *ctx)
      args: -log_view -log_view_memory -da_refine 4
      filter: grep MatFDColorSetUp | wc -w | xargs  -I % sh -c "expr % \> 21"
 
+   test:
+     suffix: logviewhwcounters
+     requires: define(PETSC_USE_LOG) define(PETSC_HAVE_PERF_EVENT_COUNTERS)
+     args: -log_view -log_view_hwcounters -da_refine 1
+     filter: grep -E "^MatMult " | sed -E "s/^MatMult( +[^ ]+){24}$/MatMult row complete/"
+
+   test:
+     suffix: logtimeline
+     nsize: 2
+     requires: define(PETSC_USE_LOG)
+     args: -log_timeline stdout -da_refine 1
+     filter: grep -c SNESIteration
+
 TEST*/
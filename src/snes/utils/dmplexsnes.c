@@ -1264,9 +1264,11 @@ PetscErrorCode DMPlexComputeJacobianAction(DM dm, IS cellIS, PetscReal t, PetscR
   We form the residual one batch of elements at a time. This allows us to offload work onto an accelerator,
   like a GPU, or vectorize on a multicore machine.
 
+  A matrix-free Jacobian from DMPlexSNESCreateJacobianMF() is not assembled, its linearization point is set to X.
+
   Level: developer
 
-.seealso: FormFunctionLocal()
+.seealso: FormFunctionLocal(), DMPlexSNESCreateJacobianMF()
 @*/
 PetscErrorCode DMPlexSNESComputeJacobianFEM(DM dm, Vec X, Mat Jac, Mat JacP,void *user)
 {
@@ -1274,9 +1276,17 @@ PetscErrorCode DMPlexSNESComputeJacobianFEM(DM dm, Vec X, Mat Jac, Mat JacP,void
   IS             allcellIS;
   PetscBool      hasJac, hasPrec;
   PetscInt       Nds, s, depth;
+  PetscErrorCode (*setState)(Mat,Vec) = NULL, (*setStateP)(Mat,Vec) = NULL;
   PetscErrorCode ierr;
 
   PetscFunctionBegin;
+  ierr = PetscObjectQueryFunction((PetscObject) Jac,  "DMPlexSNESJacobianMFSetState_C", &setState);CHKERRQ(ierr);
+  ierr = PetscObjectQueryFunction((PetscObject) JacP, "DMPlexSNESJacobianMFSetState_C", &setStateP);CHKERRQ(ierr);
+  if (setState) {ierr = (*setState)(Jac, X);CHKERRQ(ierr);}
+  if (setStateP) {
+    if (JacP != Jac) {ierr = (*setStateP)(JacP, X);CHKERRQ(ierr);}
+    PetscFunctionReturn(0);
+  }
   ierr = DMGetNumDS(dm, &Nds);CHKERRQ(ierr);
   ierr = DMSNESConvertPlex(dm, &plex, PETSC_TRUE);CHKERRQ(ierr);
   ierr = DMPlexGetDepth(plex, &depth);CHKERRQ(ierr);
@@ -1301,7 +1311,7 @@ PetscErrorCode DMPlexSNESComputeJacobianFEM(DM dm, Vec X, Mat Jac, Mat JacP,void
     if (!s) {
       ierr = PetscDSHasJacobian(ds, &hasJac);CHKERRQ(ierr);
       ierr = PetscDSHasJacobianPreconditioner(ds, &hasPrec);CHKERRQ(ierr);
-      if (hasJac && hasPrec) {ierr = MatZeroEntries(Jac);CHKERRQ(ierr);}
+      if (hasJac && hasPrec && !setState) {ierr = MatZeroEntries(Jac);CHKERRQ(ierr);}
       ierr = MatZeroEntries(JacP);CHKERRQ(ierr);
     }
     ierr = DMPlexComputeJacobian_Internal(plex, cellIS, 0.0, 0.0, X, NULL, Jac, JacP, user);CHKERRQ(ierr);
@@ -0,0 +1,700 @@
+#include <petsc/private/dmpleximpl.h>   /*I "petscdmplex.h" I*/
+#include <petsc/private/snesimpl.h>     /*I "petscsnes.h"   I*/
+#include <petscds.h>
+#include <petscfe.h>
+
+/*
+  Matrix-free application of the Jacobian of a PetscFE discretization on tensor product cells (quadrilaterals and
+  hexahedra), by sum factorization.
+
+  The Lagrange basis of degree k on a tensor product cell is the product of dim 1D Lagrange bases, and the quadrature
+  of the PetscFE is the tensor product of a 1D Gauss rule. The values and the reference derivatives of a function at
+  the quadrature points are then computed one direction at a time, with the nq x nb 1D tabulations B and D of the basis
+  and of its derivative, in O(dim (k+1)^{dim+1}) operations per cell instead of O((k+1)^{2 dim}) for the element matrix.
+  The transposed contractions integrate against the test functions.
+
+  The pointwise Jacobian g0, g1, g2, g3 of the PetscDS is evaluated at the linearization point once, and stored at each
+  quadrature point in reference coordinates, multiplied by the quadrature weight and the Jacobian determinant: with the
+  slots s = 0 for the value and s = 1 + d for the reference derivative in direction d of each component, the coupling
+  of the slots r and s is K[r][s]. Applying the operator is then interpolation, multiplication by K and integration.
+
+  The cells are processed in batches, and the data of the cells of a batch is interleaved, the cell being the fastest
+  index, so that the innermost loops of the contractions and of the multiplication by K run over the cells of the
+  batch with unit stride and are vectorized by the compiler.
+*/
+
+typedef struct {
+  DM              dm;
+  Vec             locX;        /* linearization point, with the boundary values */
+  PetscBool       Kvalid;      /* K corresponds to locX */
+  PetscInt        dim, Nc;     /* dimension of the cells and number of components of the field */
+  PetscInt        nb, nq;      /* number of 1D basis functions and of 1D quadrature points */
+  PetscInt        Nbt, Nqt;    /* nb^dim and nq^dim */
+  PetscInt        nK;          /* number of slots, Nc*(dim+1) */
+  PetscInt        numCells, bs, numBatches;
+  PetscInt       *cells;       /* the local cells, in the order of the batches */
+  PetscInt       *cmap;        /* local index of the dof of component c and lexicographic index l of cell e, cmap[(e*Nc+c)*Nbt+l], or -1 for the padding cells */
+  PetscReal      *B, *D;       /* B[q*nb+i] = phi_i(xi_q), D[q*nb+i] = phi_i'(xi_q) */
+  PetscQuadrature quad;        /* the tensor product quadrature, the first direction being the fastest */
+  PetscScalar    *K;           /* K[(((batch*Nqt+q)*nK+r)*nK+s)*bs+e] */
+  PetscScalar    *work;
+  PetscLogDouble  flops;       /* flops of one application to one cell */
+} DMPlexJacobianMF;
+
+/*
+   out[o][p][i] = sum_j M[p][j] in[o][j][i] for 0 <= i < inner, where M is nout x nin, or M^T when M is nin x nout
+*/
+PETSC_STATIC_INLINE void DMPlexJacobianMFContract_Private(PetscInt inner, PetscInt nin, PetscInt nout, PetscInt outer, const PetscReal M[], PetscBool transpose, const PetscScalar in[], PetscScalar out[])
+{
+  PetscInt o, p, j, i;
+
+  for (o = 0; o < outer; ++o) {
+    for (p = 0; p < nout; ++p) {
+      PetscScalar *y = &out[(o*nout+p)*inner];
+
+      for (i = 0; i < inner; ++i) y[i] = 0.0;
+      for (j = 0; j < nin; ++j) {
+        const PetscReal    m = transpose ? M[j*nout+p] : M[p*nin+j];
+        const PetscScalar *x = &in[(o*nin+j)*inner];
+
+        for (i = 0; i < inner; ++i) y[i] += m*x[i];
+      }
+    }
+  }
+}
+
+/*
+   Applies M[dim-1] x ... x M[0], each nq x nb, or its transpose, to the nb^dim (or nq^dim) values of each cell of a batch
+*/
+static void DMPlexJacobianMFTensor_Private(DMPlexJacobianMF *mf, const PetscReal *M[], PetscBool transpose, const PetscScalar in[], PetscScalar out[])
+{
+  const PetscInt     nin  = transpose ? mf->nq : mf->nb;
+  const PetscInt     nout = transpose ? mf->nb : mf->nq;
+  const PetscInt     half = PetscMax(mf->Nbt, mf->Nqt)*mf->bs;
+  const PetscScalar *x    = in;
+  PetscScalar       *y;
+  PetscInt           inner = mf->bs, outer = 1, d;
+
+  for (d = 1; d < mf->dim; ++d) outer *= nin;
+  for (d = 0; d < mf->dim; ++d) {
+    y = (d == mf->dim-1) ? out : &mf->work[(d%2)*half];
+    DMPlexJacobianMFContract_Private(inner, nin, nout, outer, M[d], transpose, x, y);
+    x      = y;
+    inner *= nout;
+    outer /= nin;
+  }
+}
+
+/* The 1D matrices of slot s: the derivative in direction s-1, the values in the other directions */
+static void DMPlexJacobianMFSlot_Private(DMPlexJacobianMF *mf, PetscInt s, const PetscReal *M[])
+{
+  PetscInt d;
+
+  for (d = 0; d < mf->dim; ++d) M[d] = (s == d+1) ? mf->D : mf->B;
+}
+
+static PetscErrorCode DMPlexJacobianMFGather_Private(DMPlexJacobianMF *mf, PetscInt batch, const PetscScalar x[], PetscScalar xe[])
+{
+  const PetscInt  bs = mf->bs, N = mf->Nc*mf->Nbt;
+  const PetscInt *cmap = &mf->cmap[batch*bs*N];
+  PetscInt        e, l;
+
+  PetscFunctionBegin;
+  for (e = 0; e < bs; ++e) {
+    for (l = 0; l < N; ++l) xe[l*bs+e] = cmap[e*N+l] >= 0 ? x[cmap[e*N+l]] : 0.0;
+  }
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode DMPlexJacobianMFScatter_Private(DMPlexJacobianMF *mf, PetscInt batch, const PetscScalar ze[], PetscScalar z[])
+{
+  const PetscInt  bs = mf->bs, N = mf->Nc*mf->Nbt;
+  const PetscInt *cmap = &mf->cmap[batch*bs*N];
+  PetscInt        e, l;
+
+  PetscFunctionBegin;
+  for (e = 0; e < bs; ++e) {
+    for (l = 0; l < N; ++l) if (cmap[e*N+l] >= 0) z[cmap[e*N+l]] += ze[l*bs+e];
+  }
+  PetscFunctionReturn(0);
+}
+
+/* U[(s*Nqt+q)*bs+e], the value or reference derivative of slot s at the quadrature point q of the cell e of the batch */
+static PetscErrorCode DMPlexJacobianMFInterpolate_Private(DMPlexJacobianMF *mf, const PetscScalar xe[], PetscScalar U[])
+{
+  const PetscReal *M[3];
+  PetscInt         c, s;
+
+  PetscFunctionBegin;
+  for (c = 0; c < mf->Nc; ++c) {
+    for (s = 0; s <= mf->dim; ++s) {
+      DMPlexJacobianMFSlot_Private(mf, s, M);
+      DMPlexJacobianMFTensor_Private(mf, M, PETSC_FALSE, &xe[c*mf->Nbt*mf->bs], &U[(c*(mf->dim+1)+s)*mf->Nqt*mf->bs]);
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+/*
+   Evaluates the pointwise Jacobian at the linearization point and stores K for all the cells
+*/
+static PetscErrorCode DMPlexJacobianMFSetUpCoefficients_Private(DMPlexJacobianMF *mf)
+{
+  const PetscInt     dim = mf->dim, Nc = mf->Nc, nK = mf->nK, bs = mf->bs, Nqt = mf->Nqt;
+  PetscDS            ds;
+  PetscPointJac      g0_func, g1_func, g2_func, g3_func;
+  DMField            coordField;
+  PetscFEGeom       *geom;
+  IS                 cellIS;
+  const PetscReal   *weights;
+  const PetscScalar *constants, *x;
+  PetscScalar       *xe, *U, *u, *u_x, *g0, *g1, *g2, *g3;
+  PetscInt          *uOff, *uOff_x, numConstants, batch, e, q, c, cc, d, dd, r, s;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  if (mf->Kvalid) PetscFunctionReturn(0);
+  ierr = DMGetDS(mf->dm, &ds);CHKERRQ(ierr);
+  ierr = PetscDSGetJacobian(ds, 0, 0, &g0_func, &g1_func, &g2_func, &g3_func);CHKERRQ(ierr);
+  ierr = PetscDSGetComponentOffsets(ds, &uOff);CHKERRQ(ierr);
+  ierr = PetscDSGetComponentDerivativeOffsets(ds, &uOff_x);CHKERRQ(ierr);
+  ierr = PetscDSGetConstants(ds, &numConstants, &constants);CHKERRQ(ierr);
+  ierr = PetscQuadratureGetData(mf->quad, NULL, NULL, NULL, NULL, &weights);CHKERRQ(ierr);
+  ierr = DMGetCoordinateField(mf->dm, &coordField);CHKERRQ(ierr);
+  ierr = ISCreateGeneral(PETSC_COMM_SELF, mf->numCells, mf->cells, PETSC_USE_POINTER, &cellIS);CHKERRQ(ierr);
+  ierr = DMFieldCreateFEGeom(coordField, cellIS, mf->quad, PETSC_FALSE, &geom);CHKERRQ(ierr);
+  ierr = ISDestroy(&cellIS);CHKERRQ(ierr);
+  ierr = PetscMalloc4(Nc*mf->Nbt*bs, &xe, nK*Nqt*bs, &U, Nc, &u, Nc*dim, &u_x);CHKERRQ(ierr);
+  ierr = PetscMalloc4(Nc*Nc, &g0, Nc*Nc*dim, &g1, Nc*Nc*dim, &g2, Nc*Nc*dim*dim, &g3);CHKERRQ(ierr);
+  ierr = PetscArrayzero(mf->K, mf->numBatches*Nqt*nK*nK*bs);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(mf->locX, &x);CHKERRQ(ierr);
+  for (batch = 0; batch < mf->numBatches; ++batch) {
+    ierr = DMPlexJacobianMFGather_Private(mf, batch, x, xe);CHKERRQ(ierr);
+    ierr = DMPlexJacobianMFInterpolate_Private(mf, xe, U);CHKERRQ(ierr);
+    for (e = 0; e < PetscMin(bs, mf->numCells - batch*bs); ++e) {
+      const PetscInt cind = batch*bs + e;
+
+      for (q = 0; q < Nqt; ++q) {
+        const PetscReal *invJ = &geom->invJ[(cind*Nqt+q)*dim*dim];
+        const PetscReal  w    = weights[q]*geom->detJ[cind*Nqt+q];
+        PetscScalar     *Kq   = &mf->K[(batch*Nqt+q)*nK*nK*bs+e];
+
+        /* the state and its physical gradient, grad u = J^{-T} grad_ref u */
+        for (c = 0; c < Nc; ++c) {
+          u[c] = U[(c*(dim+1)*Nqt+q)*bs+e];
+          for (d = 0; d < dim; ++d) {
+            u_x[c*dim+d] = 0.0;
+            for (dd = 0; dd < dim; ++dd) u_x[c*dim+d] += invJ[dd*dim+d]*U[((c*(dim+1)+1+dd)*Nqt+q)*bs+e];
+          }
+        }
+        ierr = PetscArrayzero(g0, Nc*Nc);CHKERRQ(ierr);
+        ierr = PetscArrayzero(g1, Nc*Nc*dim);CHKERRQ(ierr);
+        ierr = PetscArrayzero(g2, Nc*Nc*dim);CHKERRQ(ierr);
+        ierr = PetscArrayzero(g3, Nc*Nc*dim*dim);CHKERRQ(ierr);
+        if (g0_func) g0_func(dim, 1, 0, uOff, uOff_x, u, NULL, u_x, NULL, NULL, NULL, NULL, NULL, 0.0, 0.0, &geom->v[(cind*Nqt+q)*dim], numConstants, constants, g0);
+        if (g1_func) g1_func(dim, 1, 0, uOff, uOff_x, u, NULL, u_x, NULL, NULL, NULL, NULL, NULL, 0.0, 0.0, &geom->v[(cind*Nqt+q)*dim], numConstants, constants, g1);
+        if (g2_func) g2_func(dim, 1, 0, uOff, uOff_x, u, NULL, u_x, NULL, NULL, NULL, NULL, NULL, 0.0, 0.0, &geom->v[(cind*Nqt+q)*dim], numConstants, constants, g2);
+        if (g3_func) g3_func(dim, 1, 0, uOff, uOff_x, u, NULL, u_x, NULL, NULL, NULL, NULL, NULL, 0.0, 0.0, &geom->v[(cind*Nqt+q)*dim], numConstants, constants, g3);
+        /* to reference coordinates: the physical derivative d is sum_dd invJ[dd][d] times the reference derivative dd */
+        for (c = 0; c < Nc; ++c) {
+          for (cc = 0; cc < Nc; ++cc) {
+            const PetscInt gc = c*Nc+cc;
+
+            for (r = 0; r <= dim; ++r) {
+              for (s = 0; s <= dim; ++s) {
+                PetscScalar k = 0.0;
+
+                if (!r && !s) k = g0[gc];
+                else if (!r) {
+                  for (d = 0; d < dim; ++d) k += g1[gc*dim+d]*invJ[(s-1)*dim+d];
+                } else if (!s) {
+                  for (d = 0; d < dim; ++d) k += invJ[(r-1)*dim+d]*g2[gc*dim+d];
+                } else {
+                  for (d = 0; d < dim; ++d) {
+                    for (dd = 0; dd < dim; ++dd) k += invJ[(r-1)*dim+d]*g3[(gc*dim+d)*dim+dd]*invJ[(s-1)*dim+dd];
+                  }
+                }
+                Kq[((c*(dim+1)+r)*nK+cc*(dim+1)+s)*bs] = w*k;
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+  ierr = VecRestoreArrayRead(mf->locX, &x);CHKERRQ(ierr);
+  ierr = PetscFree4(xe, U, u, u_x);CHKERRQ(ierr);
+  ierr = PetscFree4(g0, g1, g2, g3);CHKERRQ(ierr);
+  ierr = PetscFEGeomDestroy(&geom);CHKERRQ(ierr);
+  mf->Kvalid = PETSC_TRUE;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode DMPlexJacobianMFApply_Private(Mat J, Vec Y, Vec Z, PetscBool transpose)
+{
+  DMPlexJacobianMF  *mf;
+  const PetscReal   *M[3];
+  const PetscScalar *y;
+  PetscScalar       *z, *ye, *U, *F, *tmp;
+  Vec                locY, locZ;
+  PetscInt           batch, q, r, s, e, c, l;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  ierr = MatShellGetContext(J, (void **) &mf);CHKERRQ(ierr);
+  ierr = DMPlexJacobianMFSetUpCoefficients_Private(mf);CHKERRQ(ierr);
+  ierr = DMGetLocalVector(mf->dm, &locY);CHKERRQ(ierr);
+  ierr = DMGetLocalVector(mf->dm, &locZ);CHKERRQ(ierr);
+  /* the constrained dofs are not unknowns */
+  ierr = VecSet(locY, 0.0);CHKERRQ(ierr);
+  ierr = DMGlobalToLocalBegin(mf->dm, Y, INSERT_VALUES, locY);CHKERRQ(ierr);
+  ierr = DMGlobalToLocalEnd(mf->dm, Y, INSERT_VALUES, locY);CHKERRQ(ierr);
+  ierr = VecSet(locZ, 0.0);CHKERRQ(ierr);
+  ierr = PetscMalloc4(mf->Nc*mf->Nbt*mf->bs, &ye, mf->nK*mf->Nqt*mf->bs, &U, mf->nK*mf->Nqt*mf->bs, &F, mf->Nbt*mf->bs, &tmp);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(locY, &y);CHKERRQ(ierr);
+  ierr = VecGetArray(locZ, &z);CHKERRQ(ierr);
+  for (batch = 0; batch < mf->numBatches; ++batch) {
+    const PetscInt n = mf->Nqt*mf->bs;
+
+    ierr = DMPlexJacobianMFGather_Private(mf, batch, y, ye);CHKERRQ(ierr);
+    ierr = DMPlexJacobianMFInterpolate_Private(mf, ye, U);CHKERRQ(ierr);
+    for (q = 0; q < mf->Nqt; ++q) {
+      const PetscScalar *Kq = &mf->K[(batch*mf->Nqt+q)*mf->nK*mf->nK*mf->bs];
+
+      for (r = 0; r < mf->nK; ++r) {
+        PetscScalar *f = &F[r*n+q*mf->bs];
+
+        for (e = 0; e < mf->bs; ++e) f[e] = 0.0;
+        for (s = 0; s < mf->nK; ++s) {
+          const PetscScalar *k = transpose ? &Kq[(s*mf->nK+r)*mf->bs] : &Kq[(r*mf->nK+s)*mf->bs];
+          const PetscScalar *u = &U[s*n+q*mf->bs];
+
+          for (e = 0; e < mf->bs; ++e) f[e] += k[e]*u[e];
+        }
+      }
+    }
+    /* integrate against the test functions */
+    for (c = 0; c < mf->Nc; ++c) {
+      PetscScalar *ze = &ye[c*mf->Nbt*mf->bs];
+
+      for (l = 0; l < mf->Nbt*mf->bs; ++l) ze[l] = 0.0;
+      for (s = 0; s <= mf->dim; ++s) {
+        DMPlexJacobianMFSlot_Private(mf, s, M);
+        DMPlexJacobianMFTensor_Private(mf, M, PETSC_TRUE, &F[(c*(mf->dim+1)+s)*n], tmp);
+        for (l = 0; l < mf->Nbt*mf->bs; ++l) ze[l] += tmp[l];
+      }
+    }
+    ierr = DMPlexJacobianMFScatter_Private(mf, batch, ye, z);CHKERRQ(ierr);
+  }
+  ierr = VecRestoreArrayRead(locY, &y);CHKERRQ(ierr);
+  ierr = VecRestoreArray(locZ, &z);CHKERRQ(ierr);
+  ierr = PetscFree4(ye, U, F, tmp);CHKERRQ(ierr);
+  ierr = VecSet(Z, 0.0);CHKERRQ(ierr);
+  ierr = DMLocalToGlobalBegin(mf->dm, locZ, ADD_VALUES, Z);CHKERRQ(ierr);
+  ierr = DMLocalToGlobalEnd(mf->dm, locZ, ADD_VALUES, Z);CHKERRQ(ierr);
+  ierr = DMRestoreLocalVector(mf->dm, &locY);CHKERRQ(ierr);
+  ierr = DMRestoreLocalVector(mf->dm, &locZ);CHKERRQ(ierr);
+  ierr = PetscLogFlops(mf->numCells*mf->flops);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatMult_DMPlexJacobianMF(Mat J, Vec Y, Vec Z)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = DMPlexJacobianMFApply_Private(J, Y, Z, PETSC_FALSE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatMultTranspose_DMPlexJacobianMF(Mat J, Vec Y, Vec Z)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = DMPlexJacobianMFApply_Private(J, Y, Z, PETSC_TRUE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   The diagonal entry of the dof l of component c is sum_{r,s} sum_q K[c r][c s](q) T_r(q,l) T_s(q,l), where T_r is the
+   tensor product of the 1D matrices of slot r: it is the transposed contraction of K[c r][c s] with the products, entry
+   by entry, of the 1D matrices of the slots r and s.
+*/
+static PetscErrorCode MatGetDiagonal_DMPlexJacobianMF(Mat J, Vec diag)
+{
+  DMPlexJacobianMF *mf;
+  const PetscReal  *M[3];
+  PetscReal        *P, *Mr[3], *Ms[3];
+  PetscScalar      *de, *Kc, *tmp, *d;
+  Vec               locD;
+  PetscInt          batch, q, r, s, e, c, l, dir, k, n;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = MatShellGetContext(J, (void **) &mf);CHKERRQ(ierr);
+  ierr = DMPlexJacobianMFSetUpCoefficients_Private(mf);CHKERRQ(ierr);
+  n    = mf->nq*mf->nb;
+  ierr = PetscMalloc4(mf->Nc*mf->Nbt*mf->bs, &de, mf->Nqt*mf->bs, &Kc, mf->Nbt*mf->bs, &tmp, mf->dim*n, &P);CHKERRQ(ierr);
+  ierr = DMGetLocalVector(mf->dm, &locD);CHKERRQ(ierr);
+  ierr = VecSet(locD, 0.0);CHKERRQ(ierr);
+  ierr = VecGetArray(locD, &d);CHKERRQ(ierr);
+  for (batch = 0; batch < mf->numBatches; ++batch) {
+    ierr = PetscArrayzero(de, mf->Nc*mf->Nbt*mf->bs);CHKERRQ(ierr);
+    for (r = 0; r <= mf->dim; ++r) {
+      for (s = 0; s <= mf->dim; ++s) {
+        DMPlexJacobianMFSlot_Private(mf, r, (const PetscReal **) Mr);
+        DMPlexJacobianMFSlot_Private(mf, s, (const PetscReal **) Ms);
+        for (dir = 0; dir < mf->dim; ++dir) {
+          for (k = 0; k < n; ++k) P[dir*n+k] = Mr[dir][k]*Ms[dir][k];
+          M[dir] = &P[dir*n];
+        }
+        for (c = 0; c < mf->Nc; ++c) {
+          const PetscInt row = c*(mf->dim+1)+r, col = c*(mf->dim+1)+s;
+
+          for (q = 0; q < mf->Nqt; ++q) {
+            const PetscScalar *Kq = &mf->K[(((batch*mf->Nqt+q)*mf->nK+row)*mf->nK+col)*mf->bs];
+
+            for (e = 0; e < mf->bs; ++e) Kc[q*mf->bs+e] = Kq[e];
+          }
+          DMPlexJacobianMFTensor_Private(mf, M, PETSC_TRUE, Kc, tmp);
+          for (l = 0; l < mf->Nbt*mf->bs; ++l) de[c*mf->Nbt*mf->bs+l] += tmp[l];
+        }
+      }
+    }
+    ierr = DMPlexJacobianMFScatter_Private(mf, batch, de, d);CHKERRQ(ierr);
+  }
+  ierr = VecRestoreArray(locD, &d);CHKERRQ(ierr);
+  ierr = PetscFree4(de, Kc, tmp, P);CHKERRQ(ierr);
+  ierr = VecSet(diag, 0.0);CHKERRQ(ierr);
+  ierr = DMLocalToGlobalBegin(mf->dm, locD, ADD_VALUES, diag);CHKERRQ(ierr);
+  ierr = DMLocalToGlobalEnd(mf->dm, locD, ADD_VALUES, diag);CHKERRQ(ierr);
+  ierr = DMRestoreLocalVector(mf->dm, &locD);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatView_DMPlexJacobianMF(Mat J, PetscViewer viewer)
+{
+  DMPlexJacobianMF *mf;
+  PetscBool         iascii;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectTypeCompare((PetscObject) viewer, PETSCVIEWERASCII, &iascii);CHKERRQ(ierr);
+  if (!iascii) PetscFunctionReturn(0);
+  ierr = MatShellGetContext(J, (void **) &mf);CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer, "Matrix-free PetscFE Jacobian by sum factorization\n");CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer, "  %D components, %D basis functions and %D quadrature points per direction\n", mf->Nc, mf->nb, mf->nq);CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer, "  cells processed in batches of %D\n", mf->bs);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode MatDestroy_DMPlexJacobianMF(Mat J)
+{
+  DMPlexJacobianMF *mf;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = MatShellGetContext(J, (void **) &mf);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject) J, "DMPlexSNESJacobianMFSetState_C", NULL);CHKERRQ(ierr);
+  ierr = VecDestroy(&mf->locX);CHKERRQ(ierr);
+  ierr = PetscQuadratureDestroy(&mf->quad);CHKERRQ(ierr);
+  ierr = PetscFree3(mf->cells, mf->cmap, mf->work);CHKERRQ(ierr);
+  ierr = PetscFree2(mf->B, mf->D);CHKERRQ(ierr);
+  ierr = PetscFree(mf->K);CHKERRQ(ierr);
+  ierr = DMDestroy(&mf->dm);CHKERRQ(ierr);
+  ierr = PetscFree(mf);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Called by DMPlexSNESComputeJacobianFEM() with the local solution, instead of assembling the matrix */
+static PetscErrorCode DMPlexSNESJacobianMFSetState_MF(Mat J, Vec locX)
+{
+  DMPlexJacobianMF *mf;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  ierr = MatShellGetContext(J, (void **) &mf);CHKERRQ(ierr);
+  ierr = VecCopy(locX, mf->locX);CHKERRQ(ierr);
+  mf->Kvalid = PETSC_FALSE;
+  /* the operator has changed, a preconditioner built from it, for example from its diagonal, must be set up again */
+  ierr = PetscObjectStateIncrease((PetscObject) J);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Finds the 1D basis of the PetscFE: the dofs are point evaluations at a tensor product of 1D nodes, the basis functions
+   are the products of the 1D Lagrange polynomials of the nodes, which is checked on the tabulation of the PetscFE. Sets
+   the component and the lexicographic index of each basis function.
+*/
+static PetscErrorCode DMPlexJacobianMFSetUpBasis_Private(DMPlexJacobianMF *mf, PetscFE fe, PetscInt comp[], PetscInt lex[])
+{
+  const PetscInt   dim = mf->dim, Nc = mf->Nc;
+  PetscDualSpace   sp;
+  PetscQuadrature  f;
+  PetscTabulation  T;
+  const PetscReal *fpoints, *fweights, *qpoints;
+  PetscReal       *nodes, *xq, *wq, *points, *weights, err = 0.0;
+  PetscInt         Nb, nb, b, c, d, i, j, m, q, qNc, Np, idx[3];
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFEGetDimension(fe, &Nb);CHKERRQ(ierr);
+  ierr = PetscFEGetDualSpace(fe, &sp);CHKERRQ(ierr);
+  ierr = PetscMalloc1(Nb, &nodes);CHKERRQ(ierr);
+  /* the distinct coordinates of the nodes in the first direction */
+  for (nb = 0, b = 0; b < Nb; ++b) {
+    ierr = PetscDualSpaceGetFunctional(sp, b, &f);CHKERRQ(ierr);
+    ierr = PetscQuadratureGetData(f, NULL, &qNc, &Np, &fpoints, &fweights);CHKERRQ(ierr);
+    if (Np != 1) SETERRQ(PETSC_COMM_SELF, PETSC_ERR_SUP, "Sum factorization requires a Lagrange element, whose dofs are point evaluations");
+    for (i = 0; i < nb; ++i) if (PetscAbsReal(nodes[i] - fpoints[0]) < 1.e-10) break;
+    if (i == nb) nodes[nb++] = fpoints[0];
+  }
+  ierr = PetscSortReal(nb, nodes);CHKERRQ(ierr);
+  mf->nb  = nb;
+  mf->Nbt = 1;
+  for (d = 0; d < dim; ++d) mf->Nbt *= nb;
+  if (Nb != Nc*mf->Nbt) SETERRQ3(PETSC_COMM_SELF, PETSC_ERR_SUP, "Sum factorization requires a tensor product element, the %D dofs are not %D components on a tensor product of %D nodes", Nb, Nc, nb);
+  for (b = 0; b < Nb; ++b) {
+    ierr = PetscDualSpaceGetFunctional(sp, b, &f);CHKERRQ(ierr);
+    ierr = PetscQuadratureGetData(f, NULL, &qNc, NULL, &fpoints, &fweights);CHKERRQ(ierr);
+    for (lex[b] = 0, d = dim-1; d >= 0; --d) {
+      for (i = 0; i < nb; ++i) if (PetscAbsReal(nodes[i] - fpoints[d]) < 1.e-10) break;
+      if (i == nb) SETERRQ(PETSC_COMM_SELF, PETSC_ERR_SUP, "Sum factorization requires a tensor product element, the nodes are not a tensor product");
+      lex[b] = lex[b]*nb + i;
+    }
+    for (comp[b] = 0, c = 1; c < qNc; ++c) if (PetscAbsReal(fweights[c]) > PetscAbsReal(fweights[comp[b]])) comp[b] = c;
+  }
+
+  /* the 1D quadrature, as many points as the quadrature of the PetscFE */
+  ierr = PetscMalloc2(mf->nq, &xq, mf->nq, &wq);CHKERRQ(ierr);
+  ierr = PetscDTGaussQuadrature(mf->nq, -1.0, 1.0, xq, wq);CHKERRQ(ierr);
+  ierr = PetscMalloc2(mf->nq*nb, &mf->B, mf->nq*nb, &mf->D);CHKERRQ(ierr);
+  for (q = 0; q < mf->nq; ++q) {
+    for (i = 0; i < nb; ++i) {
+      PetscReal phi = 1.0, dphi = 0.0;
+
+      for (j = 0; j < nb; ++j) {
+        if (j == i) continue;
+        phi *= (xq[q] - nodes[j])/(nodes[i] - nodes[j]);
+      }
+      for (m = 0; m < nb; ++m) {
+        PetscReal t = 1.0/(nodes[i] - nodes[m]);
+
+        if (m == i) continue;
+        for (j = 0; j < nb; ++j) if (j != i && j != m) t *= (xq[q] - nodes[j])/(nodes[i] - nodes[j]);
+        dphi += t;
+      }
+      mf->B[q*nb+i] = phi;
+      mf->D[q*nb+i] = dphi;
+    }
+  }
+  ierr = PetscMalloc1(mf->Nqt*dim, &points);CHKERRQ(ierr);
+  ierr = PetscMalloc1(mf->Nqt, &weights);CHKERRQ(ierr);
+  for (q = 0; q < mf->Nqt; ++q) {
+    for (weights[q] = 1.0, m = q, d = 0; d < dim; ++d, m /= mf->nq) {
+      points[q*dim+d] = xq[m%mf->nq];
+      weights[q]     *= wq[m%mf->nq];
+    }
+  }
+  ierr = PetscQuadratureCreate(PETSC_COMM_SELF, &mf->quad);CHKERRQ(ierr);
+  ierr = PetscQuadratureSetData(mf->quad, dim, 1, mf->Nqt, points, weights);CHKERRQ(ierr);
+  ierr = PetscFree2(xq, wq);CHKERRQ(ierr);
+  ierr = PetscFree(nodes);CHKERRQ(ierr);
+
+  /* compare the products of the 1D basis with the tabulation of the PetscFE */
+  ierr = PetscQuadratureGetData(mf->quad, NULL, NULL, NULL, &qpoints, NULL);CHKERRQ(ierr);
+  ierr = PetscFECreateTabulation(fe, 1, mf->Nqt, qpoints, 1, &T);CHKERRQ(ierr);
+  for (q = 0; q < mf->Nqt; ++q) {
+    for (m = q, d = 0; d < dim; ++d, m /= mf->nq) idx[d] = m%mf->nq;
+    for (b = 0; b < Nb; ++b) {
+      PetscInt  lb[3];
+      PetscReal val = 1.0, der[3];
+
+      for (m = lex[b], d = 0; d < dim; ++d, m /= nb) lb[d] = m%nb;
+      for (d = 0; d < dim; ++d) {
+        der[d] = 1.0;
+        for (j = 0; j < dim; ++j) der[d] *= (j == d ? mf->D : mf->B)[idx[j]*nb+lb[j]];
+        val *= mf->B[idx[d]*nb+lb[d]];
+      }
+      for (c = 0; c < Nc; ++c) {
+        err = PetscMax(err, PetscAbsReal(T->T[0][(q*Nb+b)*Nc+c] - (c == comp[b] ? val : 0.0)));
+        for (d = 0; d < dim; ++d) err = PetscMax(err, PetscAbsReal(T->T[1][((q*Nb+b)*Nc+c)*dim+d] - (c == comp[b] ? der[d] : 0.0)));
+      }
+    }
+  }
+  ierr = PetscTabulationDestroy(&T);CHKERRQ(ierr);
+  if (err > 1.e-8) SETERRQ1(PETSC_COMM_SELF, PETSC_ERR_SUP, "Sum factorization requires a tensor product Lagrange element, the basis differs from the products of the 1D basis by %g", (double) err);
+  PetscFunctionReturn(0);
+}
+
+/*@
+  DMPlexSNESCreateJacobianMF - Create a matrix-free Jacobian for a PetscFE discretization on tensor product cells, applied by sum factorization
+
+  Collective on dm
+
+  Input Parameter:
+. dm - The mesh, with a single PetscFE field and quadrilateral or hexahedral cells
+
+  Output Parameter:
+. J - The Jacobian, a MATSHELL
+
+  Options Database Keys:
+. -dm_plex_jacobian_mf_batch_size <8> - number of cells processed together
+
+  Notes:
+  The matrix applies the pointwise Jacobian of the PetscDS of the dm (see PetscDSSetJacobian()) without assembling it.
+  The values and the derivatives at the quadrature points are computed with the tensor product structure of the
+  Lagrange basis and of the quadrature, one direction at a time, in O((k+1)^(dim+1)) operations per cell for degree k,
+  and the matrix stores (Nc (dim+1))^2 coefficients per quadrature point instead of the (k+1)^(2 dim) entries of the
+  element matrices. This is worthwhile for high degrees, for which assembling the matrix is both slow and memory hungry.
+  MatMult(), MatMultTranspose() and MatGetDiagonal() are supported, so the matrix can be used with PCJACOBI and
+  KSPCHEBYSHEV, for example as the smoother of PCMG.
+
+  The matrix is given to SNESSetJacobian() in place of an assembled matrix: DMPlexSNESComputeJacobianFEM() then sets
+  its linearization point instead of assembling it. If it is only the first (Amat) matrix, the second one is assembled
+  as usual, with the Jacobian preconditioner of the PetscDS if there is one. The matrix uses the linearization point
+  zero until then.
+
+  The PetscFE must be a tensor product Lagrange element with the default Gauss quadrature; the pointwise Jacobian cannot
+  use auxiliary fields, and the boundary integrals of PetscDSSetBdJacobian() are not included.
+
+  Level: intermediate
+
+.seealso: DMPlexSNESComputeJacobianFEM(), DMPlexSetSNESLocalFEM(), PetscDSSetJacobian(), DMPlexComputeJacobianAction()
+@*/
+PetscErrorCode DMPlexSNESCreateJacobianMF(DM dm, Mat *J)
+{
+  DMPlexJacobianMF *mf;
+  DM                plex, dmAux;
+  PetscDS           ds;
+  PetscFE           fe;
+  PetscObject       obj;
+  PetscClassId      id;
+  PetscQuadrature   feQuad;
+  PetscDualSpace    sp;
+  PetscSection      section, anchorSection;
+  IS                cellIS, anchorIS;
+  Vec               L, G;
+  PetscScalar      *l, *vals;
+  const PetscInt   *cells;
+  PetscInt         *comp, *lex;
+  PetscInt          Nds, Nf, cdim, depth, Nq, Nb, cStart, cEnd, c, b, n, N, coneSize, fStart, k;
+  PetscBool         transform;
+  PetscBdPointJac   bd0, bd1, bd2, bd3;
+  PetscErrorCode    ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(dm, DM_CLASSID, 1);
+  PetscValidPointer(J, 2);
+  ierr = DMConvert(dm, DMPLEX, &plex);CHKERRQ(ierr);
+  ierr = DMGetNumDS(plex, &Nds);CHKERRQ(ierr);
+  ierr = DMGetDS(plex, &ds);CHKERRQ(ierr);
+  ierr = PetscDSGetNumFields(ds, &Nf);CHKERRQ(ierr);
+  if (Nds != 1 || Nf != 1) SETERRQ2(PetscObjectComm((PetscObject) dm), PETSC_ERR_SUP, "The matrix-free Jacobian requires a single field in a single PetscDS, not %D fields in %D PetscDS", Nf, Nds);
+  ierr = PetscDSGetDiscretization(ds, 0, &obj);CHKERRQ(ierr);
+  ierr = PetscObjectGetClassId(obj, &id);CHKERRQ(ierr);
+  if (id != PETSCFE_CLASSID) SETERRQ(PetscObjectComm((PetscObject) dm), PETSC_ERR_SUP, "The matrix-free Jacobian requires a PetscFE discretization");
+  fe   = (PetscFE) obj;
+  ierr = PetscObjectQuery((PetscObject) dm, "dmAux", (PetscObject *) &dmAux);CHKERRQ(ierr);
+  if (dmAux) SETERRQ(PetscObjectComm((PetscObject) dm), PETSC_ERR_SUP, "The matrix-free Jacobian does not support auxiliary fields");
+  ierr = PetscDSGetBdJacobian(ds, 0, 0, &bd0, &bd1, &bd2, &bd3);CHKERRQ(ierr);
+  if (bd0 || bd1 || bd2 || bd3) SETERRQ(PetscObjectComm((PetscObject) dm), PETSC_ERR_SUP, "The matrix-free Jacobian does not support boundary Jacobians");
+  ierr = DMHasBasisTransform(plex, &transform);CHKERRQ(ierr);
+  if (transform) SETERRQ(PetscObjectComm((PetscObject) dm), PETSC_ERR_SUP, "The matrix-free Jacobian does not support a basis transformation");
+  ierr = DMPlexGetAnchors(plex, &anchorSection, &anchorIS);CHKERRQ(ierr);
+  if (anchorSection) SETERRQ(PetscObjectComm((PetscObject) dm), PETSC_ERR_SUP, "The matrix-free Jacobian does not support constraints by anchors");
+  ierr = PetscFEGetDualSpace(fe, &sp);CHKERRQ(ierr);
+  ierr = PetscDualSpaceGetDeRahm(sp, &k);CHKERRQ(ierr);
+  if (k) SETERRQ(PetscObjectComm((PetscObject) dm), PETSC_ERR_SUP, "The matrix-free Jacobian requires an H^1 (Lagrange) element");
+
+  ierr = PetscNew(&mf);CHKERRQ(ierr);
+  mf->dm = plex;
+  mf->bs = 8;
+  ierr = PetscOptionsGetInt(((PetscObject) dm)->options, ((PetscObject) dm)->prefix, "-dm_plex_jacobian_mf_batch_size", &mf->bs, NULL);CHKERRQ(ierr);
+  if (mf->bs < 1) SETERRQ1(PetscObjectComm((PetscObject) dm), PETSC_ERR_ARG_OUTOFRANGE, "The batch size %D must be positive", mf->bs);
+  ierr = DMGetDimension(plex, &mf->dim);CHKERRQ(ierr);
+  ierr = DMGetCoordinateDim(plex, &cdim);CHKERRQ(ierr);
+  if (cdim != mf->dim) SETERRQ2(PetscObjectComm((PetscObject) dm), PETSC_ERR_SUP, "The matrix-free Jacobian requires the coordinate dimension %D to be the dimension %D", cdim, mf->dim);
+  if (mf->dim < 1 || mf->dim > 3) SETERRQ1(PetscObjectComm((PetscObject) dm), PETSC_ERR_SUP, "Invalid dimension %D", mf->dim);
+  {
+    DM refdm;
+
+    ierr = PetscDualSpaceGetDM(sp, &refdm);CHKERRQ(ierr);
+    ierr = DMPlexGetHeightStratum(refdm, 0, &fStart, NULL);CHKERRQ(ierr);
+    ierr = DMPlexGetConeSize(refdm, fStart, &coneSize);CHKERRQ(ierr);
+    if (coneSize != 2*mf->dim) SETERRQ(PetscObjectComm((PetscObject) dm), PETSC_ERR_SUP, "The matrix-free Jacobian requires tensor product cells");
+  }
+  ierr = PetscFEGetNumComponents(fe, &mf->Nc);CHKERRQ(ierr);
+  ierr = PetscFEGetDimension(fe, &Nb);CHKERRQ(ierr);
+  ierr = PetscFEGetQuadrature(fe, &feQuad);CHKERRQ(ierr);
+  ierr = PetscQuadratureGetData(feQuad, NULL, NULL, &Nq, NULL, NULL);CHKERRQ(ierr);
+  mf->nq  = (PetscInt) (PetscPowReal((PetscReal) Nq, 1.0/mf->dim) + 0.5);
+  mf->Nqt = 1;
+  for (c = 0; c < mf->dim; ++c) mf->Nqt *= mf->nq;
+  if (mf->Nqt != Nq) SETERRQ2(PetscObjectComm((PetscObject) dm), PETSC_ERR_SUP, "The matrix-free Jacobian requires a tensor product quadrature, %D points is not a power %D", Nq, mf->dim);
+  mf->nK = mf->Nc*(mf->dim+1);
+  ierr = PetscMalloc2(Nb, &comp, Nb, &lex);CHKERRQ(ierr);
+  ierr = DMPlexJacobianMFSetUpBasis_Private(mf, fe, comp, lex);CHKERRQ(ierr);
+
+  /* the cells, and the local indices of their closures, found with a local vector that holds its own indices */
+  ierr = DMPlexGetDepth(plex, &depth);CHKERRQ(ierr);
+  ierr = DMGetStratumIS(plex, "dim", depth, &cellIS);CHKERRQ(ierr);
+  if (!cellIS) {ierr = DMGetStratumIS(plex, "depth", depth, &cellIS);CHKERRQ(ierr);}
+  ierr = ISGetPointRange(cellIS, &cStart, &cEnd, &cells);CHKERRQ(ierr);
+  mf->numCells   = cEnd - cStart;
+  mf->numBatches = (mf->numCells + mf->bs - 1)/mf->bs;
+  ierr = PetscMalloc3(mf->numCells, &mf->cells, mf->numBatches*mf->bs*Nb, &mf->cmap, 2*PetscMax(mf->Nbt, mf->Nqt)*mf->bs, &mf->work);CHKERRQ(ierr);
+  ierr = DMGetLocalSection(plex, &section);CHKERRQ(ierr);
+  ierr = DMCreateLocalVector(plex, &L);CHKERRQ(ierr);
+  ierr = VecGetLocalSize(L, &n);CHKERRQ(ierr);
+  ierr = VecGetArray(L, &l);CHKERRQ(ierr);
+  for (b = 0; b < n; ++b) l[b] = b;
+  ierr = VecRestoreArray(L, &l);CHKERRQ(ierr);
+  for (c = cStart; c < cEnd; ++c) {
+    const PetscInt cind = c - cStart;
+    PetscInt       csize = 0;
+
+    mf->cells[cind] = cells ? cells[c] : c;
+    vals = NULL;
+    ierr = DMPlexVecGetClosure(plex, section, L, mf->cells[cind], &csize, &vals);CHKERRQ(ierr);
+    if (csize != Nb) SETERRQ3(PETSC_COMM_SELF, PETSC_ERR_PLIB, "Closure of cell %D has %D dofs, not %D", mf->cells[cind], csize, Nb);
+    for (b = 0; b < Nb; ++b) mf->cmap[(cind*mf->Nc+comp[b])*mf->Nbt+lex[b]] = (PetscInt) PetscRealPart(vals[b]);
+    ierr = DMPlexVecRestoreClosure(plex, section, L, mf->cells[cind], &csize, &vals);CHKERRQ(ierr);
+  }
+  for (b = mf->numCells*Nb; b < mf->numBatches*mf->bs*Nb; ++b) mf->cmap[b] = -1;
+  ierr = ISRestorePointRange(cellIS, &cStart, &cEnd, &cells);CHKERRQ(ierr);
+  ierr = ISDestroy(&cellIS);CHKERRQ(ierr);
+  ierr = VecDestroy(&L);CHKERRQ(ierr);
+  ierr = PetscFree2(comp, lex);CHKERRQ(ierr);
+  ierr = DMCreateLocalVector(plex, &mf->locX);CHKERRQ(ierr);
+  ierr = VecSet(mf->locX, 0.0);CHKERRQ(ierr);
+  ierr = PetscMalloc1(mf->numBatches*mf->Nqt*mf->nK*mf->nK*mf->bs, &mf->K);CHKERRQ(ierr);
+  {
+    PetscLogDouble sum = 0.0, stage;
+    PetscInt       d;
+
+    /* one tensor contraction costs 2 sum_d nq^(d+1) nb^(dim-d) flops per cell, either way */
+    for (d = 0; d < mf->dim; ++d) {
+      for (stage = 2.0, k = 0; k <= d; ++k) stage *= mf->nq;
+      for (k = d; k < mf->dim; ++k) stage *= mf->nb;
+      sum += stage;
+    }
+    mf->flops = 2.0*mf->nK*sum + 2.0*mf->nK*mf->nK*mf->Nqt;
+  }
+
+  ierr = DMCreateGlobalVector(plex, &G);CHKERRQ(ierr);
+  ierr = VecGetLocalSize(G, &n);CHKERRQ(ierr);
+  ierr = VecGetSize(G, &N);CHKERRQ(ierr);
+  ierr = VecDestroy(&G);CHKERRQ(ierr);
+  ierr = MatCreateShell(PetscObjectComm((PetscObject) dm), n, n, N, N, mf, J);CHKERRQ(ierr);
+  ierr = MatShellSetOperation(*J, MATOP_MULT, (void (*)(void)) MatMult_DMPlexJacobianMF);CHKERRQ(ierr);
+  ierr = MatShellSetOperation(*J, MATOP_MULT_TRANSPOSE, (void (*)(void)) MatMultTranspose_DMPlexJacobianMF);CHKERRQ(ierr);
+  ierr = MatShellSetOperation(*J, MATOP_GET_DIAGONAL, (void (*)(void)) MatGetDiagonal_DMPlexJacobianMF);CHKERRQ(ierr);
+  ierr = MatShellSetOperation(*J, MATOP_VIEW, (void (*)(void)) MatView_DMPlexJacobianMF);CHKERRQ(ierr);
+  ierr = MatShellSetOperation(*J, MATOP_DESTROY, (void (*)(void)) MatDestroy_DMPlexJacobianMF);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject) *J, "DMPlexSNESJacobianMFSetState_C", DMPlexSNESJacobianMFSetState_MF);CHKERRQ(ierr);
+  ierr = PetscLogObjectMemory((PetscObject) *J, mf->numBatches*mf->bs*(Nb*sizeof(PetscInt) + mf->Nqt*mf->nK*mf->nK*sizeof(PetscScalar)));CHKERRQ(ierr);
+  ierr = PetscInfo5(*J, "Sum factorization with %D basis functions and %D quadrature points per direction, %D cells in %D batches of %D\n", mf->nb, mf->nq, mf->numCells, mf->numBatches, mf->bs);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
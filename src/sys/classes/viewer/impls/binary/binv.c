@@ -1,4 +1,13 @@
 #include <petsc/private/viewerimpl.h>    /*I   "petscviewer.h"   I*/
+#if defined(PETSC_HAVE_MMAP)
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#if defined(PETSC_HAVE_UNISTD_H)
+#include <unistd.h>
+#endif
+#endif
 
 typedef struct  {
   int           fdes;                 /* file descriptor, ignored if using MPI IO */
@@ -19,8 +28,16 @@ typedef struct  {
   PetscBool     skipheader;           /* don't write header, only raw data */
   PetscBool     matlabheaderwritten;  /* if format is PETSC_VIEWER_BINARY_MATLAB has the MATLAB .info header been written yet */
   PetscBool     setfromoptionscalled;
+  PetscBool     usemmap;              /* map the file into memory for reading */
+  PetscBool     mmaphugepages;        /* advise the kernel to use huge pages for the mapping */
+  PetscContainer mapping;             /* the mapped file, referenced by the objects using it in place */
 } PetscViewer_Binary;
 
+typedef struct {
+  void   *addr;
+  size_t len;
+} PetscViewerBinaryMMap;
+
 #if defined(PETSC_HAVE_MPIIO)
 static PetscErrorCode PetscViewerBinarySyncMPIIO(PetscViewer viewer)
 {
@@ -322,6 +339,100 @@ static PetscErrorCode PetscViewerBinaryGetUseMPIIO_Binary(PetscViewer viewer,Pet
 }
 #endif
 
+/*@
+    PetscViewerBinarySetUseMMap - Sets a binary viewer to map the file into memory with mmap() for reading. Must be called
+        before PetscViewerFileSetName()
+
+    Logically Collective on PetscViewer
+
+    Input Parameters:
++   viewer - the PetscViewer; must be a binary
+-   use - PETSC_TRUE means the file will be mapped
+
+    Options Database:
++   -viewer_binary_mmap : Flag for mapping the file
+-   -viewer_binary_mmap_hugepages : Advise the kernel to use huge pages for the mapping
+
+    Level: advanced
+
+    Notes:
+    Every process maps the file, so it must be accessible from all of them. PetscViewerBinaryReadAll() then copies
+    the part of each process directly from the mapping instead of receiving it from the first process, and
+    PetscViewerBinaryReadAllInPlace() gives access to it without any copy; MatLoad() uses this for the column indices
+    and values of MATSEQAIJ matrices.
+
+    The mapping is private: PETSc binary files are big-endian, on little-endian machines the data is byte swapped in place
+    and the pages touched become private copies of the file content. On big-endian machines the pages stay shared with
+    the file system cache.
+
+    Only used for reading, and not together with MPI-IO. If mmap() is not available, this function does nothing.
+
+.seealso: PetscViewerFileSetMode(), PetscViewerCreate(), PetscViewerSetType(), PetscViewerBinaryOpen(),
+          PetscViewerBinaryGetUseMMap(), PetscViewerBinaryReadAllInPlace(), PetscViewerBinarySetUseMPIIO()
+@*/
+PetscErrorCode PetscViewerBinarySetUseMMap(PetscViewer viewer,PetscBool use)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(viewer,PETSC_VIEWER_CLASSID,1);
+  PetscValidLogicalCollectiveBool(viewer,use,2);
+  ierr = PetscTryMethod(viewer,"PetscViewerBinarySetUseMMap_C",(PetscViewer,PetscBool),(viewer,use));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#if defined(PETSC_HAVE_MMAP)
+static PetscErrorCode PetscViewerBinarySetUseMMap_Binary(PetscViewer viewer,PetscBool use)
+{
+  PetscViewer_Binary *vbinary = (PetscViewer_Binary*)viewer->data;
+  PetscFunctionBegin;
+  if (viewer->setupcalled && vbinary->usemmap != use) SETERRQ1(PetscObjectComm((PetscObject)viewer),PETSC_ERR_ORDER,"Cannot change mmap to %s after setup",PetscBools[use]);
+  vbinary->usemmap = use;
+  PetscFunctionReturn(0);
+}
+#endif
+
+/*@
+    PetscViewerBinaryGetUseMMap - Returns PETSC_TRUE if the binary viewer reads the file through a memory mapping
+
+    Not Collective
+
+    Input Parameter:
+.   viewer - PetscViewer context, obtained from PetscViewerBinaryOpen()
+
+    Output Parameter:
+.   use - PETSC_TRUE if the file is mapped
+
+    Level: advanced
+
+    Note:
+    If mmap() is not available, or if the viewer is not used for reading, this function returns PETSC_FALSE
+
+.seealso: PetscViewerBinaryOpen(), PetscViewerBinarySetUseMMap(), PetscViewerBinaryReadAllInPlace()
+@*/
+PetscErrorCode PetscViewerBinaryGetUseMMap(PetscViewer viewer,PetscBool *use)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(viewer,PETSC_VIEWER_CLASSID,1);
+  PetscValidBoolPointer(use,2);
+  *use = PETSC_FALSE;
+  ierr = PetscTryMethod(viewer,"PetscViewerBinaryGetUseMMap_C",(PetscViewer,PetscBool*),(viewer,use));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+#if defined(PETSC_HAVE_MMAP)
+static PetscErrorCode PetscViewerBinaryGetUseMMap_Binary(PetscViewer viewer,PetscBool *use)
+{
+  PetscViewer_Binary *vbinary = (PetscViewer_Binary*)viewer->data;
+
+  PetscFunctionBegin;
+  *use = (PetscBool)(vbinary->usemmap && vbinary->filemode == FILE_MODE_READ);
+  PetscFunctionReturn(0);
+}
+#endif
+
 /*@
     PetscViewerBinarySetFlowControl - Sets how many messages are allowed to outstanding at the same time during parallel IO reads/writes
 
@@ -809,6 +920,7 @@ static PetscErrorCode PetscViewerFileClose_BinarySTDIO(PetscViewer v)
     }
   }
   ierr = PetscFree(vbinary->ogzfilename);CHKERRQ(ierr);
+  ierr = PetscContainerDestroy(&vbinary->mapping);CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -873,6 +985,10 @@ static PetscErrorCode PetscViewerDestroy_Binary(PetscViewer v)
 #if defined(PETSC_HAVE_MPIIO)
   ierr = PetscObjectComposeFunction((PetscObject)v,"PetscViewerBinaryGetUseMPIIO_C",NULL);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)v,"PetscViewerBinarySetUseMPIIO_C",NULL);CHKERRQ(ierr);
+#endif
+#if defined(PETSC_HAVE_MMAP)
+  ierr = PetscObjectComposeFunction((PetscObject)v,"PetscViewerBinaryGetUseMMap_C",NULL);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)v,"PetscViewerBinarySetUseMMap_C",NULL);CHKERRQ(ierr);
 #endif
   PetscFunctionReturn(0);
 }
@@ -898,7 +1014,9 @@ $    FILE_MODE_APPEND - open existing file for binary output
 .    -viewer_binary_skip_info -
 .    -viewer_binary_skip_options -
 .    -viewer_binary_skip_header -
--    -viewer_binary_mpiio -
+.    -viewer_binary_mpiio -
+.    -viewer_binary_mmap -
+-    -viewer_binary_mmap_hugepages -
 
    Level: beginner
 
@@ -914,7 +1032,7 @@ $    FILE_MODE_APPEND - open existing file for binary output
 .seealso: PetscViewerASCIIOpen(), PetscViewerPushFormat(), PetscViewerDestroy(),
           VecView(), MatView(), VecLoad(), MatLoad(), PetscViewerBinaryGetDescriptor(),
           PetscViewerBinaryGetInfoPointer(), PetscFileMode, PetscViewer, PetscViewerBinaryRead(), PetscViewerBinarySetUseMPIIO(),
-          PetscViewerBinaryGetUseMPIIO(), PetscViewerBinaryGetMPIIOOffset()
+          PetscViewerBinaryGetUseMPIIO(), PetscViewerBinaryGetMPIIOOffset(), PetscViewerBinarySetUseMMap()
 @*/
 PetscErrorCode PetscViewerBinaryOpen(MPI_Comm comm,const char name[],PetscFileMode mode,PetscViewer *viewer)
 {
@@ -1045,6 +1163,45 @@ PetscErrorCode PetscViewerBinaryWrite(PetscViewer viewer,const void *data,PetscI
   PetscFunctionReturn(0);
 }
 
+#if defined(PETSC_HAVE_MMAP)
+/*
+   Returns the location in the mapped file of the part of this process of the next total items,
+   and moves the file position of the first process after them
+*/
+static PetscErrorCode PetscViewerBinaryMMapLocate(PetscViewer viewer,PetscInt count,PetscInt *start,PetscInt total,size_t dsize,char **data)
+{
+  PetscViewer_Binary    *vbinary = (PetscViewer_Binary*)viewer->data;
+  MPI_Comm              comm = PetscObjectComm((PetscObject)viewer);
+  PetscViewerBinaryMMap *map;
+  PetscMPIInt           rank,size;
+  PetscInt64            offset = 0;
+  off_t                 off;
+  PetscErrorCode        ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscContainerGetPointer(vbinary->mapping,(void**)&map);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
+  if (*start == PETSC_DETERMINE) {
+    ierr = MPI_Scan(&count,start,1,MPIU_INT,MPI_SUM,comm);CHKERRQ(ierr);
+    *start -= count;
+  }
+  if (total == PETSC_DETERMINE) {
+    total = *start + count;
+    ierr = MPI_Bcast(&total,1,MPIU_INT,size-1,comm);CHKERRQ(ierr);
+  }
+  if (!rank) {
+    ierr   = PetscBinarySeek(vbinary->fdes,0,PETSC_BINARY_SEEK_CUR,&off);CHKERRQ(ierr);
+    offset = (PetscInt64)off;
+    ierr   = PetscBinarySeek(vbinary->fdes,(off_t)(total*dsize),PETSC_BINARY_SEEK_CUR,&off);CHKERRQ(ierr);
+  }
+  ierr = MPI_Bcast(&offset,1,MPIU_INT64,0,comm);CHKERRQ(ierr);
+  if ((size_t)offset + (size_t)(*start+count)*dsize > map->len) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_FILE_READ,"Read past end of file");
+  *data = (char*)map->addr + offset + (size_t)(*start)*dsize;
+  PetscFunctionReturn(0);
+}
+#endif
+
 static PetscErrorCode PetscViewerBinaryWriteReadAll(PetscViewer viewer,PetscBool write,void *data,PetscInt count,PetscInt start,PetscInt total,PetscDataType dtype)
 {
   MPI_Comm       comm = PetscObjectComm((PetscObject)viewer);
@@ -1094,6 +1251,17 @@ static PetscErrorCode PetscViewerBinaryWriteReadAll(PetscViewer viewer,PetscBool
     ierr = PetscViewerBinaryAddMPIIOOffset(viewer,off);CHKERRQ(ierr);
     PetscFunctionReturn(0);
   }
+#endif
+#if defined(PETSC_HAVE_MMAP)
+  if (!write && ((PetscViewer_Binary*)viewer->data)->mapping) {
+    char *mdata;
+
+    /* each process copies its part from the mapping, the file content is left untouched */
+    ierr = PetscViewerBinaryMMapLocate(viewer,count,&start,total,(size_t)dsize,&mdata);CHKERRQ(ierr);
+    ierr = PetscMemcpy(data,mdata,count*dsize);CHKERRQ(ierr);
+    if (!PetscBinaryBigEndian()) {ierr = PetscByteSwap(data,dtype,count);CHKERRQ(ierr);}
+    PetscFunctionReturn(0);
+  }
 #endif
   {
     int         fdes;
@@ -1169,6 +1337,73 @@ PetscErrorCode PetscViewerBinaryReadAll(PetscViewer viewer,void *data,PetscInt c
   PetscFunctionReturn(0);
 }
 
+/*@C
+   PetscViewerBinaryReadAllInPlace - reads from a binary file from all processes, without copying the data if the file is mapped into memory
+
+   Collective
+
+   Input Parameters:
++  viewer - the binary viewer
+.  count - local number of items of data to read
+.  start - local start, can be PETSC_DETERMINE
+.  total - global number of items of data to read, can be PETSC_DETERMINE
+-  dtype - type of data to read
+
+   Output Parameters:
++  data - location of the data
+-  owner - container owning the data
+
+   Level: developer
+
+   Notes:
+   If the viewer maps the file (see PetscViewerBinarySetUseMMap()), data points into the mapping; otherwise, or if the data is
+   not suitably aligned in the file, it is read into new memory. In both cases the data stays valid as long as owner exists,
+   it is usually composed with the object using the data with PetscObjectCompose() and then released with PetscContainerDestroy().
+
+   The data read in place is byte swapped in the mapping if needed, it must not be read again from the same viewer.
+
+.seealso: PetscViewerBinaryOpen(), PetscViewerBinarySetUseMMap(), PetscViewerBinaryReadAll()
+@*/
+PetscErrorCode PetscViewerBinaryReadAllInPlace(PetscViewer viewer,void **data,PetscInt count,PetscInt start,PetscInt total,PetscDataType dtype,PetscContainer *owner)
+{
+  PetscViewer_Binary *vbinary;
+  size_t             dsize;
+  char               *mdata = NULL;
+  PetscErrorCode     ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecificType(viewer,PETSC_VIEWER_CLASSID,1,PETSCVIEWERBINARY);
+  PetscValidPointer(data,2);
+  PetscValidPointer(owner,7);
+  ierr = PetscViewerSetUp(viewer);CHKERRQ(ierr);
+  vbinary = (PetscViewer_Binary*)viewer->data;
+  ierr = PetscDataTypeGetSize(dtype,&dsize);CHKERRQ(ierr);
+#if defined(PETSC_HAVE_MMAP)
+  if (vbinary->mapping) {
+    ierr = PetscViewerBinaryMMapLocate(viewer,count,&start,total,dsize,&mdata);CHKERRQ(ierr);
+    if (!((PETSC_UINTPTR_T)mdata % PetscMin(dsize,sizeof(PetscInt64)))) {
+      if (!PetscBinaryBigEndian()) {ierr = PetscByteSwap(mdata,dtype,count);CHKERRQ(ierr);}
+      ierr   = PetscObjectReference((PetscObject)vbinary->mapping);CHKERRQ(ierr);
+      *data  = mdata;
+      *owner = vbinary->mapping;
+      PetscFunctionReturn(0);
+    }
+    ierr = PetscInfo(viewer,"Data is not aligned in the mapped file, copying it\n");CHKERRQ(ierr);
+  }
+#endif
+  ierr = PetscMalloc(count*dsize,data);CHKERRQ(ierr);
+  if (mdata) {
+    ierr = PetscMemcpy(*data,mdata,count*dsize);CHKERRQ(ierr);
+    if (!PetscBinaryBigEndian()) {ierr = PetscByteSwap(*data,dtype,count);CHKERRQ(ierr);}
+  } else {
+    ierr = PetscViewerBinaryReadAll(viewer,*data,count,start,total,dtype);CHKERRQ(ierr);
+  }
+  ierr = PetscContainerCreate(PETSC_COMM_SELF,owner);CHKERRQ(ierr);
+  ierr = PetscContainerSetPointer(*owner,*data);CHKERRQ(ierr);
+  ierr = PetscContainerSetUserDestroy(*owner,PetscContainerUserDestroyDefault);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*@C
    PetscViewerBinaryWriteAll - writes to a binary file from all processes
 
@@ -1415,6 +1650,50 @@ static PetscErrorCode PetscViewerFileSetUp_BinaryMPIIO(PetscViewer viewer)
 }
 #endif
 
+#if defined(PETSC_HAVE_MMAP)
+static PetscErrorCode PetscViewerBinaryMMapDestroy(void *ctx)
+{
+  PetscViewerBinaryMMap *map = (PetscViewerBinaryMMap*)ctx;
+  PetscErrorCode        ierr;
+
+  PetscFunctionBegin;
+  if (map->len && munmap(map->addr,map->len)) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SYS,"munmap() failed");
+  ierr = PetscFree(map);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Every process maps the whole file; the mapping is private and writable so that the data can be byte swapped in place
+*/
+static PetscErrorCode PetscViewerFileSetUp_BinaryMMap(PetscViewer viewer,const char fname[])
+{
+  PetscViewer_Binary    *vbinary = (PetscViewer_Binary*)viewer->data;
+  PetscViewerBinaryMMap *map;
+  struct stat           st;
+  int                   fd;
+  PetscErrorCode        ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscNew(&map);CHKERRQ(ierr);
+  ierr = PetscContainerCreate(PETSC_COMM_SELF,&vbinary->mapping);CHKERRQ(ierr);
+  ierr = PetscContainerSetPointer(vbinary->mapping,map);CHKERRQ(ierr);
+  ierr = PetscContainerSetUserDestroy(vbinary->mapping,PetscViewerBinaryMMapDestroy);CHKERRQ(ierr);
+  fd = open(fname,O_RDONLY);
+  if (fd < 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_FILE_OPEN,"Cannot open file %s for mapping",fname);
+  if (fstat(fd,&st)) {close(fd); SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_FILE_READ,"Cannot get the size of file %s",fname);}
+  if (st.st_size) {
+    map->addr = mmap(NULL,(size_t)st.st_size,PROT_READ | PROT_WRITE,MAP_PRIVATE,fd,0);
+    if (map->addr == MAP_FAILED) {close(fd); SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_SYS,"mmap() failed on file %s",fname);}
+    map->len = (size_t)st.st_size;
+#if defined(MADV_HUGEPAGE)
+    if (vbinary->mmaphugepages && madvise(map->addr,map->len,MADV_HUGEPAGE)) {ierr = PetscInfo(viewer,"madvise(MADV_HUGEPAGE) failed, using normal pages\n");CHKERRQ(ierr);}
+#endif
+  }
+  close(fd);
+  PetscFunctionReturn(0);
+}
+#endif
+
 static PetscErrorCode PetscViewerFileSetUp_BinarySTDIO(PetscViewer viewer)
 {
   PetscViewer_Binary *vbinary = (PetscViewer_Binary*)viewer->data;
@@ -1455,6 +1734,9 @@ static PetscErrorCode PetscViewerFileSetUp_BinarySTDIO(PetscViewer viewer)
     }
     ierr = PetscBinaryOpen(fname,mode,&vbinary->fdes);CHKERRQ(ierr);
   }
+#if defined(PETSC_HAVE_MMAP)
+  if (vbinary->usemmap && vbinary->filemode == FILE_MODE_READ) {ierr = PetscViewerFileSetUp_BinaryMMap(viewer,fname);CHKERRQ(ierr);}
+#endif
   PetscFunctionReturn(0);
 }
 
@@ -1503,6 +1785,7 @@ static PetscErrorCode PetscViewerSetUp_Binary(PetscViewer viewer)
   ierr = PetscViewerFileClose_Binary(viewer);CHKERRQ(ierr);
 
   ierr = PetscViewerBinaryGetUseMPIIO(viewer,&usempiio);CHKERRQ(ierr);
+  if (usempiio && vbinary->usemmap && vbinary->filemode == FILE_MODE_READ) SETERRQ(PetscObjectComm((PetscObject)viewer),PETSC_ERR_SUP,"Cannot use both MPI-IO and mmap for reading");
   if (usempiio) {
 #if defined(PETSC_HAVE_MPIIO)
     ierr = PetscViewerFileSetUp_BinaryMPIIO(viewer);CHKERRQ(ierr);
@@ -1527,7 +1810,7 @@ static PetscErrorCode PetscViewerView_Binary(PetscViewer v,PetscViewer viewer)
   PetscFunctionBegin;
   ierr = PetscViewerBinaryGetUseMPIIO(v,&usempiio);CHKERRQ(ierr);
   ierr = PetscViewerASCIIPrintf(viewer,"Filename: %s\n",fname);CHKERRQ(ierr);
-  ierr = PetscViewerASCIIPrintf(viewer,"Mode: %s (%s)\n",fmode,usempiio ? "mpiio" : "stdio");CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer,"Mode: %s (%s)\n",fmode,usempiio ? "mpiio" : (vbinary->mapping ? "mmap" : "stdio"));CHKERRQ(ierr);
   PetscFunctionReturn(0);
 }
 
@@ -1551,6 +1834,12 @@ static PetscErrorCode PetscViewerSetFromOptions_Binary(PetscOptionItems *PetscOp
   ierr = PetscOptionsBool("-viewer_binary_mpiio","Use MPI-IO functionality to write/read binary file","PetscViewerBinarySetUseMPIIO",binary->usempiio,&binary->usempiio,NULL);CHKERRQ(ierr);
 #else
   ierr = PetscOptionsBool("-viewer_binary_mpiio","Use MPI-IO functionality to write/read binary file (NOT AVAILABLE)","PetscViewerBinarySetUseMPIIO",PETSC_FALSE,NULL,NULL);CHKERRQ(ierr);
+#endif
+#if defined(PETSC_HAVE_MMAP)
+  ierr = PetscOptionsBool("-viewer_binary_mmap","Map the file into memory for reading","PetscViewerBinarySetUseMMap",binary->usemmap,&binary->usemmap,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsBool("-viewer_binary_mmap_hugepages","Advise the kernel to use huge pages for the mapping","PetscViewerBinarySetUseMMap",binary->mmaphugepages,&binary->mmaphugepages,NULL);CHKERRQ(ierr);
+#else
+  ierr = PetscOptionsBool("-viewer_binary_mmap","Map the file into memory for reading (NOT AVAILABLE)","PetscViewerBinarySetUseMMap",PETSC_FALSE,NULL,NULL);CHKERRQ(ierr);
 #endif
   ierr = PetscOptionsTail();CHKERRQ(ierr);
   binary->setfromoptionscalled = PETSC_TRUE;
@@ -1603,6 +1892,9 @@ PETSC_EXTERN PetscErrorCode PetscViewerCreate_Binary(PetscViewer v)
   vbinary->storecompressed = PETSC_FALSE;
   vbinary->ogzfilename     = NULL;
   vbinary->flowcontrol     = 256; /* seems a good number for Cray XT-5 */
+  vbinary->usemmap         = PETSC_FALSE;
+  vbinary->mmaphugepages   = PETSC_FALSE;
+  vbinary->mapping         = NULL;
 
   vbinary->setfromoptionscalled = PETSC_FALSE;
 
@@ -1622,6 +1914,10 @@ PETSC_EXTERN PetscErrorCode PetscViewerCreate_Binary(PetscViewer v)
 #if defined(PETSC_HAVE_MPIIO)
   ierr = PetscObjectComposeFunction((PetscObject)v,"PetscViewerBinaryGetUseMPIIO_C",PetscViewerBinaryGetUseMPIIO_Binary);CHKERRQ(ierr);
   ierr = PetscObjectComposeFunction((PetscObject)v,"PetscViewerBinarySetUseMPIIO_C",PetscViewerBinarySetUseMPIIO_Binary);CHKERRQ(ierr);
+#endif
+#if defined(PETSC_HAVE_MMAP)
+  ierr = PetscObjectComposeFunction((PetscObject)v,"PetscViewerBinaryGetUseMMap_C",PetscViewerBinaryGetUseMMap_Binary);CHKERRQ(ierr);
+  ierr = PetscObjectComposeFunction((PetscObject)v,"PetscViewerBinarySetUseMMap_C",PetscViewerBinarySetUseMMap_Binary);CHKERRQ(ierr);
 #endif
   PetscFunctionReturn(0);
 }
@@ -128,6 +128,7 @@ PETSC_INTERN PetscErrorCode PetscLogInitialize(void)
   }
   PetscLogPHC = PetscLogObjCreateDefault;
   PetscLogPHD = PetscLogObjDestroyDefault;
+  ierr = PetscLogHWCountersInitialize();CHKERRQ(ierr);
   /* Setup default logging structures */
   ierr = PetscStageLogCreate(&petsc_stageLog);CHKERRQ(ierr);
   ierr = PetscStageLogRegister(petsc_stageLog, "Main Stage", &stage);CHKERRQ(ierr);
@@ -148,7 +149,10 @@ PETSC_INTERN PetscErrorCode PetscLogFinalize(void)
   ierr = PetscFree(petsc_actions);CHKERRQ(ierr);
   ierr = PetscFree(petsc_objects);CHKERRQ(ierr);
   ierr = PetscLogNestedEnd();CHKERRQ(ierr);
+  ierr = PetscLogTimelineFinalize();CHKERRQ(ierr);
   ierr = PetscLogSet(NULL, NULL);CHKERRQ(ierr);
+  ierr = PetscLogHWCountersFinalize();CHKERRQ(ierr);
+  PetscLogHWCounters          = PETSC_FALSE;
 
   /* Resetting phase */
   ierr = PetscLogGetStageLog(&stageLog);CHKERRQ(ierr);
@@ -1392,6 +1396,7 @@ PetscErrorCode  PetscLogView_Default(PetscViewer viewer)
   PetscLogDouble     fracStageTime, fracStageFlops, fracStageMess, fracStageMessLen, fracStageRed;
   PetscLogDouble     min, max, tot, ratio, avg, x, y;
   PetscLogDouble     minf, maxf, totf, ratf, mint, maxt, tott, ratt, ratC, totm, totml, totr, mal, malmax, emalmax;
+  PetscLogDouble     hw[PETSC_LOG_HW_COUNTERS], hwzero[PETSC_LOG_HW_COUNTERS] = {0.0, 0.0, 0.0, 0.0};
   #if defined(PETSC_HAVE_VIENNACL) || defined(PETSC_HAVE_CUDA) 
   PetscLogDouble     cct, gct, csz, gsz, gmaxt, gflops, gflopr, fracgflops;
   #endif
@@ -1597,6 +1602,11 @@ PetscErrorCode  PetscLogView_Default(PetscViewer viewer)
     ierr = PetscFPrintf(comm, fd, "   MMalloc Mbytes: Increase in high water mark of allocated memory (sum over all calls to event)\n");CHKERRQ(ierr);
     ierr = PetscFPrintf(comm, fd, "   RMI Mbytes: Increase in resident memory (sum over all calls to event)\n");CHKERRQ(ierr);
   }
+  if (PetscLogHWCounters) {
+    ierr = PetscFPrintf(comm, fd, "   Gcycle: 10e-9 * (sum of the cycles spent in user space over all processors)\n");CHKERRQ(ierr);
+    ierr = PetscFPrintf(comm, fd, "   IPC: instructions per cycle, %%Miss: percent of the last level cache references that missed\n");CHKERRQ(ierr);
+    ierr = PetscFPrintf(comm, fd, "   EstGB/s: 10e-9 * 64 * (sum of the cache misses over all processors)/(max time over all processors), an estimate of the memory traffic\n");CHKERRQ(ierr);
+  }
   #if defined(PETSC_HAVE_VIENNACL) || defined(PETSC_HAVE_CUDA) 
   ierr = PetscFPrintf(comm, fd, "   GPU Mflop/s: 10e-6 * (sum of flop on GPU over all processors)/(max GPU time over all processors)\n");CHKERRQ(ierr);
   ierr = PetscFPrintf(comm, fd, "   CpuToGpu Count: total number of CPU to GPU copies per processor\n");CHKERRQ(ierr);
@@ -1614,6 +1624,9 @@ PetscErrorCode  PetscLogView_Default(PetscViewer viewer)
   if (PetscLogMemory) {
     ierr = PetscFPrintf(comm, fd,"  Malloc EMalloc MMalloc RMI");CHKERRQ(ierr);
   } 
+  if (PetscLogHWCounters) {
+    ierr = PetscFPrintf(comm, fd,"  ------- Hardware -------");CHKERRQ(ierr);
+  }
   #if defined(PETSC_HAVE_VIENNACL) || defined(PETSC_HAVE_CUDA) 
   ierr = PetscFPrintf(comm, fd,"   GPU    - CpuToGpu -   - GpuToCpu - GPU");CHKERRQ(ierr);
   #endif
@@ -1622,6 +1635,9 @@ PetscErrorCode  PetscLogView_Default(PetscViewer viewer)
   if (PetscLogMemory) {
     ierr = PetscFPrintf(comm, fd," Mbytes Mbytes Mbytes Mbytes");CHKERRQ(ierr);
   }
+  if (PetscLogHWCounters) {
+    ierr = PetscFPrintf(comm, fd," Gcycle  IPC %%Miss EstGB/s");CHKERRQ(ierr);
+  }
   #if defined(PETSC_HAVE_VIENNACL) || defined(PETSC_HAVE_CUDA) 
   ierr = PetscFPrintf(comm, fd," Mflop/s Count   Size   Count   Size  %%F");CHKERRQ(ierr); 
   #endif
@@ -1630,6 +1646,9 @@ PetscErrorCode  PetscLogView_Default(PetscViewer viewer)
   if (PetscLogMemory) {
     ierr = PetscFPrintf(comm, fd,"-----------------------------");CHKERRQ(ierr);
   }
+  if (PetscLogHWCounters) {
+    ierr = PetscFPrintf(comm, fd,"--------------------------");CHKERRQ(ierr);
+  }
   #if defined(PETSC_HAVE_VIENNACL) || defined(PETSC_HAVE_CUDA) 
   ierr = PetscFPrintf(comm, fd,"---------------------------------------");CHKERRQ(ierr); 
   #endif
@@ -1690,6 +1709,9 @@ PetscErrorCode  PetscLogView_Default(PetscViewer viewer)
           ierr  = MPI_Allreduce(&eventInfo[event].mallocIncrease, &malmax,1, MPIU_PETSCLOGDOUBLE, MPI_SUM, comm);CHKERRQ(ierr);
           ierr  = MPI_Allreduce(&eventInfo[event].mallocIncreaseEvent, &emalmax,1, MPIU_PETSCLOGDOUBLE, MPI_SUM, comm);CHKERRQ(ierr);
         }
+        if (PetscLogHWCounters) {
+          ierr  = MPI_Allreduce(eventInfo[event].hwCounters,  hw,     PETSC_LOG_HW_COUNTERS, MPIU_PETSCLOGDOUBLE, MPI_SUM, comm);CHKERRQ(ierr);
+        }
         #if defined(PETSC_HAVE_VIENNACL) || defined(PETSC_HAVE_CUDA) 
         ierr  = MPI_Allreduce(&eventInfo[event].CpuToGpuCount,    &cct,   1, MPIU_PETSCLOGDOUBLE, MPI_SUM, comm);CHKERRQ(ierr);
         ierr  = MPI_Allreduce(&eventInfo[event].GpuToCpuCount,    &gct,   1, MPIU_PETSCLOGDOUBLE, MPI_SUM, comm);CHKERRQ(ierr);
@@ -1718,6 +1740,9 @@ PetscErrorCode  PetscLogView_Default(PetscViewer viewer)
           ierr  = MPI_Allreduce(&zero,                        &malmax, 1, MPIU_PETSCLOGDOUBLE, MPI_SUM, comm);CHKERRQ(ierr);
           ierr  = MPI_Allreduce(&zero,                        &emalmax,1, MPIU_PETSCLOGDOUBLE, MPI_SUM, comm);CHKERRQ(ierr);
         }
+        if (PetscLogHWCounters) {
+          ierr  = MPI_Allreduce(hwzero,                       hw,     PETSC_LOG_HW_COUNTERS, MPIU_PETSCLOGDOUBLE, MPI_SUM, comm);CHKERRQ(ierr);
+        }
         #if defined(PETSC_HAVE_VIENNACL) || defined(PETSC_HAVE_CUDA) 
         ierr  = MPI_Allreduce(&zero,                          &cct,    1, MPIU_PETSCLOGDOUBLE, MPI_SUM, comm);CHKERRQ(ierr);
         ierr  = MPI_Allreduce(&zero,                          &gct,    1, MPIU_PETSCLOGDOUBLE, MPI_SUM, comm);CHKERRQ(ierr);
@@ -1761,6 +1786,9 @@ PetscErrorCode  PetscLogView_Default(PetscViewer viewer)
         if (PetscLogMemory) {
           ierr = PetscFPrintf(comm, fd," %5.0f   %5.0f   %5.0f   %5.0f",mal/1.0e6,emalmax/1.0e6,malmax/1.0e6,mem/1.0e6);CHKERRQ(ierr);
         } 
+        if (PetscLogHWCounters) {
+          ierr = PetscFPrintf(comm, fd," %6.2f %4.2f %5.1f %7.2f",hw[0]/1.0e9,hw[0] != 0.0 ? hw[1]/hw[0] : 0.0,hw[2] != 0.0 ? 100.0*hw[3]/hw[2] : 0.0,maxt != 0.0 ? 64.0*hw[3]/(1.0e9*maxt) : 0.0);CHKERRQ(ierr);
+        }
         #if defined(PETSC_HAVE_VIENNACL) || defined(PETSC_HAVE_CUDA)
         if (totf  != 0.0) fracgflops = gflops/totf;  else fracgflops = 0.0;
         if (gmaxt != 0.0) gflopr     = gflops/gmaxt; else gflopr     = 0.0;
@@ -1776,6 +1804,9 @@ PetscErrorCode  PetscLogView_Default(PetscViewer viewer)
   if (PetscLogMemory) {
     ierr = PetscFPrintf(comm, fd, "-----------------------------");CHKERRQ(ierr);
   }
+  if (PetscLogHWCounters) {
+    ierr = PetscFPrintf(comm, fd, "--------------------------");CHKERRQ(ierr);
+  }
   #if defined(PETSC_HAVE_VIENNACL) || defined(PETSC_HAVE_CUDA) 
   ierr = PetscFPrintf(comm, fd, "---------------------------------------");CHKERRQ(ierr); 
   #endif
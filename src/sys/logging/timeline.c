@@ -0,0 +1,271 @@
+/*
+     Records the beginning and end of every event, and marks such as the solver iterations, with their time stamps so
+   that the order of the computation on each process can be viewed as a timeline (Chrome trace format, viewable with
+   chrome://tracing or https://ui.perfetto.dev).
+*/
+#include <petsc/private/logimpl.h>  /*I    "petscsys.h"   I*/
+#include <petscviewer.h>
+
+#if defined(PETSC_USE_LOG)
+
+typedef struct {
+  PetscLogDouble time;   /* time stamp on the clock of this process */
+  const char     *name;  /* name of the event or of the mark, not copied */
+  PetscInt       value;  /* value attached to a mark, for example the iteration number */
+  char           phase;  /* 'B' for the beginning of an event, 'E' for its end, 'i' for a mark */
+} PetscLogTimelineRecord;
+
+static PetscLogTimelineRecord *PetscLogTimelineRecords = NULL;
+static PetscInt               PetscLogTimelineMax      = 100000;
+static PetscInt64             PetscLogTimelineCount    = 0;     /* number of records since the beginning, the oldest are overwritten */
+static PetscErrorCode         (*PetscLogTimelinePLB)(PetscLogEvent,int,PetscObject,PetscObject,PetscObject,PetscObject) = NULL;
+static PetscErrorCode         (*PetscLogTimelinePLE)(PetscLogEvent,int,PetscObject,PetscObject,PetscObject,PetscObject) = NULL;
+
+PETSC_STATIC_INLINE void PetscLogTimelineAdd_Private(char phase,const char *name,PetscInt value)
+{
+  PetscLogTimelineRecord *record = &PetscLogTimelineRecords[PetscLogTimelineCount++ % PetscLogTimelineMax];
+
+  PetscTime(&record->time);
+  record->name  = name;
+  record->value = value;
+  record->phase = phase;
+}
+
+static PetscErrorCode PetscLogEventBeginTimeline(PetscLogEvent event,int t,PetscObject o1,PetscObject o2,PetscObject o3,PetscObject o4)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  /* after the handler that is chained, so that the synchronization of -log_sync is not part of the event */
+  if (PetscLogTimelinePLB) {ierr = (*PetscLogTimelinePLB)(event,t,o1,o2,o3,o4);CHKERRQ(ierr);}
+  PetscLogTimelineAdd_Private('B',petsc_stageLog->eventLog->eventInfo[event].name,-1);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscLogEventEndTimeline(PetscLogEvent event,int t,PetscObject o1,PetscObject o2,PetscObject o3,PetscObject o4)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscLogTimelineAdd_Private('E',petsc_stageLog->eventLog->eventInfo[event].name,-1);
+  if (PetscLogTimelinePLE) {ierr = (*PetscLogTimelinePLE)(event,t,o1,o2,o3,o4);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+/*@C
+  PetscLogTimelineBegin - Records the time stamps of the beginning and end of every event, in addition to the
+  logging already active, so that the order of the computation on each process can be viewed with PetscLogTimelineView()
+
+  Logically Collective on PETSC_COMM_WORLD
+
+  Options Database Keys:
++ -log_timeline [filename] - Activates PetscLogTimelineBegin() and saves the timeline in filename (default timeline.json) in PetscFinalize()
+- -log_timeline_max <n> - Number of records kept on each process, when more are generated the oldest ones are overwritten (default 100000)
+
+  Notes:
+  This must be called after PetscLogDefaultBegin() or PetscLogNestedBegin() since it wraps the current logging
+  functions; PetscLogDefaultBegin() is called if no logging is active. The timeline is kept in a circular buffer of
+  fixed size in memory, recording an event takes one call to PetscTime().
+
+  KSP and SNES add a mark with PetscLogTimelineMark() at each iteration, the time spent in communication shows up
+  in the events that wait for the messages, such as VecScatterEnd, SFBcastOpEnd or VecNorm.
+
+  Level: advanced
+
+.seealso: PetscLogTimelineView(), PetscLogTimelineMark(), PetscLogDefaultBegin(), PetscLogTraceBegin()
+@*/
+PetscErrorCode PetscLogTimelineBegin(void)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (PetscLogTimelineRecords) PetscFunctionReturn(0);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-log_timeline_max",&PetscLogTimelineMax,NULL);CHKERRQ(ierr);
+  if (PetscLogTimelineMax < 1) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Number of records %D must be positive",PetscLogTimelineMax);
+  ierr = PetscMalloc1(PetscLogTimelineMax,&PetscLogTimelineRecords);CHKERRQ(ierr);
+  PetscLogTimelineCount = 0;
+  if (!PetscLogPLB) {ierr = PetscLogDefaultBegin();CHKERRQ(ierr);}
+  PetscLogTimelinePLB = PetscLogPLB;
+  PetscLogTimelinePLE = PetscLogPLE;
+  ierr = PetscLogSet(PetscLogEventBeginTimeline,PetscLogEventEndTimeline);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@C
+  PetscLogTimelineMark - Adds a mark, such as the beginning of an iteration, to the timeline
+
+  Not Collective
+
+  Input Parameters:
++ name - the name of the mark, it must be a string that persists until PetscFinalize(), such as a literal
+- value - a value shown with the mark, for example the iteration number
+
+  Notes:
+  Does nothing if PetscLogTimelineBegin() has not been called.
+
+  Level: advanced
+
+.seealso: PetscLogTimelineBegin(), PetscLogTimelineView()
+@*/
+PetscErrorCode PetscLogTimelineMark(const char name[],PetscInt value)
+{
+  PetscFunctionBegin;
+  if (PetscLogTimelineRecords) PetscLogTimelineAdd_Private('i',name,value);
+  PetscFunctionReturn(0);
+}
+
+/*
+   Estimates the offset of the clock of each process to the clock of the first process of comm, keeping the
+   shortest of a few round trips (Cristian's algorithm)
+*/
+static PetscErrorCode PetscLogTimelineClockOffset_Private(PetscViewer viewer,PetscLogDouble *offset)
+{
+  MPI_Comm       comm;
+  PetscMPIInt    rank,size,r,tag;
+  PetscInt       k;
+  PetscLogDouble t0,t1,tr,rtt,best;
+  MPI_Status     status;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscObjectGetComm((PetscObject)viewer,&comm);CHKERRQ(ierr);
+  ierr = PetscObjectGetNewTag((PetscObject)viewer,&tag);CHKERRQ(ierr);
+  ierr = MPI_Comm_rank(comm,&rank);CHKERRQ(ierr);
+  ierr = MPI_Comm_size(comm,&size);CHKERRQ(ierr);
+  *offset = 0.0;
+  if (!rank) {
+    for (r=1; r<size; r++) {
+      best = PETSC_MAX_REAL;
+      for (k=0; k<10; k++) {
+        PetscTime(&t0);
+        ierr = MPI_Send(&t0,1,MPIU_PETSCLOGDOUBLE,r,tag,comm);CHKERRQ(ierr);
+        ierr = MPI_Recv(&tr,1,MPIU_PETSCLOGDOUBLE,r,tag,comm,&status);CHKERRQ(ierr);
+        PetscTime(&t1);
+        rtt = t1 - t0;
+        if (rtt < best) {best = rtt; *offset = tr - 0.5*(t0 + t1);}
+      }
+      ierr = MPI_Send(offset,1,MPIU_PETSCLOGDOUBLE,r,tag,comm);CHKERRQ(ierr);
+    }
+    *offset = 0.0;
+  } else {
+    for (k=0; k<10; k++) {
+      ierr = MPI_Recv(&t0,1,MPIU_PETSCLOGDOUBLE,0,tag,comm,&status);CHKERRQ(ierr);
+      PetscTime(&tr);
+      ierr = MPI_Send(&tr,1,MPIU_PETSCLOGDOUBLE,0,tag,comm);CHKERRQ(ierr);
+    }
+    ierr = MPI_Recv(offset,1,MPIU_PETSCLOGDOUBLE,0,tag,comm,&status);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*@C
+  PetscLogTimelineView - Saves the timeline recorded since PetscLogTimelineBegin() in the Chrome trace format
+
+  Collective on PetscViewer
+
+  Input Parameter:
+. viewer - an ASCII viewer, usually opened on a file with the extension .json
+
+  Notes:
+  Each process appears as a separate track. The time stamps are corrected for the offsets between the clocks of the
+  processes, estimated with a few message round trips, and are given in microseconds since the start of
+  PetscInitialize() on the first process. When the circular buffer overflowed, only the most recent records are saved.
+
+  The file can be opened with chrome://tracing in the Chrome browser or with https://ui.perfetto.dev
+
+  Level: advanced
+
+.seealso: PetscLogTimelineBegin(), PetscLogTimelineMark(), PetscLogView()
+@*/
+PetscErrorCode PetscLogTimelineView(PetscViewer viewer)
+{
+  PetscLogTimelineRecord *record;
+  PetscMPIInt            rank;
+  PetscInt64             i,first;
+  PetscInt               open = 0;
+  PetscLogDouble         offset,base = petsc_BaseTime,ts;
+  PetscBool              isascii;
+  char                   *chunk;
+  size_t                 len = 0,chunksize = 65536,n;
+  PetscErrorCode         ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(viewer,PETSC_VIEWER_CLASSID,1);
+  if (!PetscLogTimelineRecords) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"Must use -log_timeline or PetscLogTimelineBegin() before calling this routine");
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&isascii);CHKERRQ(ierr);
+  if (!isascii) SETERRQ(PetscObjectComm((PetscObject)viewer),PETSC_ERR_SUP,"Currently can only view the timeline to ASCII");
+  ierr = MPI_Comm_rank(PetscObjectComm((PetscObject)viewer),&rank);CHKERRQ(ierr);
+  ierr = PetscLogTimelineClockOffset_Private(viewer,&offset);CHKERRQ(ierr);
+  ierr = MPI_Bcast(&base,1,MPIU_PETSCLOGDOUBLE,0,PetscObjectComm((PetscObject)viewer));CHKERRQ(ierr);
+
+  ierr = PetscMalloc1(chunksize,&chunk);CHKERRQ(ierr);
+  ierr = PetscSNPrintf(chunk,chunksize,"%s{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":0,\"args\":{\"name\":\"rank %d\"}}",rank ? ",\n" : "[",rank,rank);CHKERRQ(ierr);
+  ierr = PetscStrlen(chunk,&len);CHKERRQ(ierr);
+  first = PetscMax(0,PetscLogTimelineCount - PetscLogTimelineMax);
+  ierr = PetscViewerASCIIPushSynchronized(viewer);CHKERRQ(ierr);
+  for (i=first; i<PetscLogTimelineCount; i++) {
+    record = &PetscLogTimelineRecords[i % PetscLogTimelineMax];
+    /* when the buffer overflowed, skip the ends of the events whose beginning was overwritten */
+    if (record->phase == 'B') open++;
+    else if (record->phase == 'E') {
+      if (!open) continue;
+      open--;
+    }
+    if (chunksize - len < 256) {
+      ierr = PetscViewerASCIISynchronizedPrintf(viewer,"%s",chunk);CHKERRQ(ierr);
+      len  = 0;
+    }
+    ts = 1.e6*(record->time - offset - base);
+    if (record->phase == 'i') {
+      ierr = PetscSNPrintfCount(chunk+len,chunksize-len,",\n{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,\"pid\":%d,\"tid\":0,\"args\":{\"value\":%D}}",&n,record->name,ts,rank,record->value);CHKERRQ(ierr);
+    } else {
+      ierr = PetscSNPrintfCount(chunk+len,chunksize-len,",\n{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":%d,\"tid\":0}",&n,record->name,record->phase,ts,rank);CHKERRQ(ierr);
+    }
+    len += n-1;
+  }
+  ierr = PetscViewerASCIISynchronizedPrintf(viewer,"%s",chunk);CHKERRQ(ierr);
+  ierr = PetscViewerFlush(viewer);CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPopSynchronized(viewer);CHKERRQ(ierr);
+  ierr = PetscViewerASCIIPrintf(viewer,"\n]\n");CHKERRQ(ierr);
+  ierr = PetscFree(chunk);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   PetscLogTimelineViewFromOptions - Saves the timeline in the file given with -log_timeline, called in PetscFinalize()
+*/
+PetscErrorCode PetscLogTimelineViewFromOptions(void)
+{
+  PetscViewer    viewer;
+  char           name[PETSC_MAX_PATH_LEN];
+  PetscBool      flg;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!PetscLogTimelineRecords) PetscFunctionReturn(0);
+  ierr = PetscStrcpy(name,"timeline.json");CHKERRQ(ierr);
+  ierr = PetscOptionsGetString(NULL,NULL,"-log_timeline",name,sizeof(name),&flg);CHKERRQ(ierr);
+  if (!flg) PetscFunctionReturn(0);
+  if (!name[0]) {ierr = PetscStrcpy(name,"timeline.json");CHKERRQ(ierr);}
+  ierr = PetscViewerASCIIOpen(PETSC_COMM_WORLD,name,&viewer);CHKERRQ(ierr);
+  ierr = PetscLogTimelineView(viewer);CHKERRQ(ierr);
+  ierr = PetscViewerDestroy(&viewer);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   PetscLogTimelineFinalize - Frees the records, called in PetscLogFinalize()
+*/
+PetscErrorCode PetscLogTimelineFinalize(void)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscFree(PetscLogTimelineRecords);CHKERRQ(ierr);
+  PetscLogTimelineCount = 0;
+  PetscLogTimelinePLB   = NULL;
+  PetscLogTimelinePLE   = NULL;
+  PetscFunctionReturn(0);
+}
+
+#endif /* PETSC_USE_LOG */
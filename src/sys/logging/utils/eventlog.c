@@ -9,6 +9,7 @@
 
 PetscBool PetscLogSyncOn = PETSC_FALSE;
 PetscBool PetscLogMemory = PETSC_FALSE;
+PetscBool PetscLogHWCounters = PETSC_FALSE;
 #if defined(PETSC_HAVE_VIENNACL) || defined(PETSC_HAVE_CUDA) 
 PetscBool PetscLogGpuTraffic = PETSC_FALSE;
 #endif
@@ -163,6 +164,10 @@ PetscErrorCode PetscEventPerfInfoClear(PetscEventPerfInfo *eventInfo)
   eventInfo->numMessages   = 0.0;
   eventInfo->messageLength = 0.0;
   eventInfo->numReductions = 0.0;
+  eventInfo->hwCounters[0] = 0.0;
+  eventInfo->hwCounters[1] = 0.0;
+  eventInfo->hwCounters[2] = 0.0;
+  eventInfo->hwCounters[3] = 0.0;
   #if defined(PETSC_HAVE_VIENNACL) || defined(PETSC_HAVE_CUDA) 
   eventInfo->CpuToGpuCount = 0.0;
   eventInfo->GpuToCpuCount = 0.0;
@@ -666,6 +671,12 @@ PetscErrorCode PetscLogEventBeginDefault(PetscLogEvent event,int t,PetscObject o
     eventLog->eventInfo[event].mallocIncrease -= usage;
     ierr = PetscMallocPushMaximumUsage((int)event);CHKERRQ(ierr);
   }
+  if (PetscLogHWCounters) {
+    PetscLogDouble hw[PETSC_LOG_HW_COUNTERS];
+    int            i;
+    ierr = PetscLogHWCountersRead(hw);CHKERRQ(ierr);
+    for (i=0; i<PETSC_LOG_HW_COUNTERS; i++) eventLog->eventInfo[event].hwCounters[i] -= hw[i];
+  }
   #if defined(PETSC_HAVE_VIENNACL) || defined(PETSC_HAVE_CUDA) 
   eventLog->eventInfo[event].CpuToGpuCount -= petsc_ctog_ct;
   eventLog->eventInfo[event].GpuToCpuCount -= petsc_gtoc_ct;
@@ -713,6 +724,12 @@ PetscErrorCode PetscLogEventEndDefault(PetscLogEvent event,int t,PetscObject o1,
     ierr = PetscMallocGetMaximumUsage(&usage);CHKERRQ(ierr);
     eventLog->eventInfo[event].mallocIncrease += usage;
   }
+  if (PetscLogHWCounters) {
+    PetscLogDouble hw[PETSC_LOG_HW_COUNTERS];
+    int            i;
+    ierr = PetscLogHWCountersRead(hw);CHKERRQ(ierr);
+    for (i=0; i<PETSC_LOG_HW_COUNTERS; i++) eventLog->eventInfo[event].hwCounters[i] += hw[i];
+  }
   #if defined(PETSC_HAVE_VIENNACL) || defined(PETSC_HAVE_CUDA) 
   eventLog->eventInfo[event].CpuToGpuCount += petsc_ctog_ct;
   eventLog->eventInfo[event].GpuToCpuCount += petsc_gtoc_ct;
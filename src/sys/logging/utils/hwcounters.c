@@ -0,0 +1,114 @@
+/*
+     Hardware performance counters accumulated by the default event logging, see -log_view_hwcounters.
+
+     The counters are read through the Linux perf_event_open() interface, all of them in one group so that a
+   single read() returns consistent values. Only the user space activity of the calling thread is counted.
+*/
+#include <petsc/private/logimpl.h>  /*I    "petscsys.h"   I*/
+
+#if defined(PETSC_HAVE_LINUX_PERF_EVENT_H)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#if !defined(SYS_perf_event_open)
+#undef PETSC_HAVE_LINUX_PERF_EVENT_H
+#endif
+#endif
+
+#if defined(PETSC_HAVE_LINUX_PERF_EVENT_H)
+static int PetscLogHWCountersFd[PETSC_LOG_HW_COUNTERS] = {-1,-1,-1,-1};
+static const unsigned long long PetscLogHWCountersConfig[PETSC_LOG_HW_COUNTERS] = {PERF_COUNT_HW_CPU_CYCLES,PERF_COUNT_HW_INSTRUCTIONS,PERF_COUNT_HW_CACHE_REFERENCES,PERF_COUNT_HW_CACHE_MISSES};
+static const char *const PetscLogHWCountersName[PETSC_LOG_HW_COUNTERS] = {"cycles","instructions","cache references","cache misses"};
+#endif
+
+/*
+   PetscLogHWCountersInitialize - Opens and starts the hardware counters, turns PetscLogHWCounters off if they are not available
+
+   Collective on PETSC_COMM_WORLD, the counters are either used on all processes or on none so that PetscLogView() stays collective
+*/
+PetscErrorCode PetscLogHWCountersInitialize(void)
+{
+  PetscBool              avail;
+  PetscErrorCode         ierr;
+#if defined(PETSC_HAVE_LINUX_PERF_EVENT_H)
+  struct perf_event_attr attr;
+  int                    i,fd;
+#endif
+
+  PetscFunctionBegin;
+  if (!PetscLogHWCounters) PetscFunctionReturn(0);
+#if defined(PETSC_HAVE_LINUX_PERF_EVENT_H)
+  for (i=0; i<PETSC_LOG_HW_COUNTERS; i++) {
+    ierr = PetscMemzero(&attr,sizeof(attr));CHKERRQ(ierr);
+    attr.type           = PERF_TYPE_HARDWARE;
+    attr.size           = sizeof(attr);
+    attr.config         = PetscLogHWCountersConfig[i];
+    attr.disabled       = i ? 0 : 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+    attr.read_format    = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    fd = (int)syscall(SYS_perf_event_open,&attr,0,-1,PetscLogHWCountersFd[0],0);
+    if (fd < 0) {
+      ierr = PetscInfo2(NULL,"Hardware counter for %s is not available, perf_event_open() failed with: %s\n",PetscLogHWCountersName[i],strerror(errno));CHKERRQ(ierr);
+      break;
+    }
+    PetscLogHWCountersFd[i] = fd;
+  }
+  avail = (PetscBool)(i == PETSC_LOG_HW_COUNTERS);
+  if (avail && (ioctl(PetscLogHWCountersFd[0],PERF_EVENT_IOC_RESET,PERF_IOC_FLAG_GROUP) || ioctl(PetscLogHWCountersFd[0],PERF_EVENT_IOC_ENABLE,PERF_IOC_FLAG_GROUP))) {
+    ierr  = PetscInfo1(NULL,"Unable to start the hardware counters: %s\n",strerror(errno));CHKERRQ(ierr);
+    avail = PETSC_FALSE;
+  }
+#else
+  ierr  = PetscInfo(NULL,"Hardware counters are not available, PETSc was not configured with linux/perf_event.h\n");CHKERRQ(ierr);
+  avail = PETSC_FALSE;
+#endif
+  ierr = MPIU_Allreduce(&avail,&PetscLogHWCounters,1,MPIU_BOOL,MPI_LAND,PETSC_COMM_WORLD);CHKERRQ(ierr);
+  if (!PetscLogHWCounters) {ierr = PetscLogHWCountersFinalize();CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+/*
+   PetscLogHWCountersRead - Returns the current values of the counters, scaled when the kernel had to multiplex them
+*/
+PetscErrorCode PetscLogHWCountersRead(PetscLogDouble values[])
+{
+#if defined(PETSC_HAVE_LINUX_PERF_EVENT_H)
+  unsigned long long buf[3+PETSC_LOG_HW_COUNTERS];
+  PetscLogDouble     scale = 1.0;
+  int                i;
+#endif
+
+  PetscFunctionBegin;
+#if defined(PETSC_HAVE_LINUX_PERF_EVENT_H)
+  /* layout of PERF_FORMAT_GROUP: number of counters, time enabled, time running, then the values */
+  if (read(PetscLogHWCountersFd[0],buf,sizeof(buf)) != (ssize_t)sizeof(buf)) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_SYS,"Unable to read the hardware counters: %s",strerror(errno));
+  if (buf[2] && buf[2] < buf[1]) scale = (PetscLogDouble)buf[1]/(PetscLogDouble)buf[2];
+  for (i=0; i<PETSC_LOG_HW_COUNTERS; i++) values[i] = scale*(PetscLogDouble)buf[3+i];
+#else
+  SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP_SYS,"Hardware counters are not available");
+#endif
+  PetscFunctionReturn(0);
+}
+
+/*
+   PetscLogHWCountersFinalize - Closes the hardware counters
+*/
+PetscErrorCode PetscLogHWCountersFinalize(void)
+{
+#if defined(PETSC_HAVE_LINUX_PERF_EVENT_H)
+  int i;
+#endif
+
+  PetscFunctionBegin;
+#if defined(PETSC_HAVE_LINUX_PERF_EVENT_H)
+  for (i=PETSC_LOG_HW_COUNTERS-1; i>=0; i--) {
+    if (PetscLogHWCountersFd[i] >= 0) close(PetscLogHWCountersFd[i]);
+    PetscLogHWCountersFd[i] = -1;
+  }
+#endif
+  PetscFunctionReturn(0);
+}
@@ -911,6 +911,11 @@ static PetscErrorCode PetscLogNestedTreePrintLine(PetscViewer viewer,PetscEventP
     ierr = PetscPrintXMLNestedLinePerfResults(viewer, "mflops", time>=timeMx*0.001 ? 1e-6*perfInfo.flops/time : 0, 0, 0.01, 1.05);CHKERRQ(ierr);
     ierr = PetscPrintXMLNestedLinePerfResults(viewer, "mbps",time>=timeMx*0.001 ? perfInfo.messageLength/(1024*1024*time) : 0, 0, 0.01, 1.05);CHKERRQ(ierr);
     ierr = PetscPrintXMLNestedLinePerfResults(viewer, "nreductsps", time>=timeMx*0.001 ? perfInfo.numReductions/time : 0, 0, 0.01, 1.05);CHKERRQ(ierr);
+    if (PetscLogHWCounters) {
+      ierr = PetscPrintXMLNestedLinePerfResults(viewer, "ipc", perfInfo.hwCounters[0]>0 ? perfInfo.hwCounters[1]/perfInfo.hwCounters[0] : 0, 0, 0.01, 1.05);CHKERRQ(ierr);
+      ierr = PetscPrintXMLNestedLinePerfResults(viewer, "llcmissrate", perfInfo.hwCounters[2]>0 ? perfInfo.hwCounters[3]/perfInfo.hwCounters[2] : 0, 0, 0.001, 1.05);CHKERRQ(ierr);
+      ierr = PetscPrintXMLNestedLinePerfResults(viewer, "estmbps", time>=timeMx*0.001 ? 64*perfInfo.hwCounters[3]/(1024*1024*time) : 0, 0, 0.01, 1.05);CHKERRQ(ierr);
+    }
   }
   PetscFunctionReturn(0);
 }
@@ -1028,7 +1033,7 @@ static PetscErrorCode PetscLogNestedTreePrint(PetscViewer viewer, PetscNestedEve
     countsPerCall = 0;
   } else {
   /* Set the values for a timer that was activated in this process */
-    int           i;
+    int           i,j;
     PetscLogEvent dftEvent   = tree[iStart].dftEvent;
 
     parentCount    = countParents( tree, eventPerfInfo, iStart);
@@ -1041,6 +1046,7 @@ static PetscErrorCode PetscLogNestedTreePrint(PetscViewer viewer, PetscNestedEve
     otherPerfInfo.numMessages   = 0;
     otherPerfInfo.messageLength = 0;
     otherPerfInfo.numReductions = 0;
+    for (j=0; j<PETSC_LOG_HW_COUNTERS; j++) otherPerfInfo.hwCounters[j] = 0;
 
     for (i=0; i<nChildren; i++) {
       /* For all child counters: subtract the child values from self-timers */
@@ -1053,6 +1059,7 @@ static PetscErrorCode PetscLogNestedTreePrint(PetscViewer viewer, PetscNestedEve
       selfPerfInfo.numMessages   -= childPerfInfo.numMessages;
       selfPerfInfo.messageLength -= childPerfInfo.messageLength;
       selfPerfInfo.numReductions -= childPerfInfo.numReductions;
+      for (j=0; j<PETSC_LOG_HW_COUNTERS; j++) selfPerfInfo.hwCounters[j] -= childPerfInfo.hwCounters[j];
 
       if ((children[i].val/totalTime) < THRESHOLD) {
         /* Add them to 'other' if the time is ignored in the output */
@@ -1061,6 +1068,7 @@ static PetscErrorCode PetscLogNestedTreePrint(PetscViewer viewer, PetscNestedEve
         otherPerfInfo.numMessages   += childPerfInfo.numMessages;
         otherPerfInfo.messageLength += childPerfInfo.messageLength;
         otherPerfInfo.numReductions += childPerfInfo.numReductions;
+        for (j=0; j<PETSC_LOG_HW_COUNTERS; j++) otherPerfInfo.hwCounters[j] += childPerfInfo.hwCounters[j];
       }
     }
   }
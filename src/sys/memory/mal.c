@@ -198,6 +198,7 @@ PetscErrorCode (*PetscTrFree)(void*,int,const char[],const char[])
 PetscErrorCode (*PetscTrRealloc)(size_t,int,const char[],const char[],void**)          = PetscReallocAlign;
 
 PETSC_INTERN PetscBool petscsetmallocvisited;
+PETSC_INTERN PetscErrorCode PetscMallocPoolDestroy_Private(void);
 PetscBool petscsetmallocvisited = PETSC_FALSE;
 
 /*@C
@@ -245,7 +246,10 @@ PetscErrorCode PetscMallocSet(PetscErrorCode (*imalloc)(size_t,PetscBool,int,con
 @*/
 PetscErrorCode PetscMallocClear(void)
 {
+  PetscErrorCode ierr;
+
   PetscFunctionBegin;
+  ierr = PetscMallocPoolDestroy_Private();CHKERRQ(ierr);
   PetscTrMalloc         = PetscMallocAlign;
   PetscTrFree           = PetscFreeAlign;
   PetscTrRealloc        = PetscReallocAlign;
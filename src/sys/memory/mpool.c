@@ -0,0 +1,309 @@
+/*
+    Pool allocator: keeps freed blocks in free lists by size class so that the many objects and work arrays of the
+    same size created and destroyed at each step of a solver are recycled without going back to the system malloc(),
+    and provides arena scopes for transient work space.
+*/
+#include <petscsys.h>             /*I   "petscsys.h"   I*/
+
+/*
+   These are defined in mal.c and ensure that malloced space is PetscScalar aligned
+*/
+PETSC_EXTERN PetscErrorCode PetscMallocAlign(size_t,PetscBool,int,const char[],const char[],void**);
+PETSC_EXTERN PetscErrorCode PetscFreeAlign(void*,int,const char[],const char[]);
+PETSC_EXTERN PetscErrorCode PetscReallocAlign(size_t,int,const char[],const char[],void**);
+
+/*
+   Every block starts with a header of PETSC_MEMALIGN bytes so that the user space stays aligned. The magic number is
+   combined with the address to recognize space that was not obtained from the pool (for example with PetscMallocSetDRAM()).
+*/
+typedef struct {
+  PETSC_UINTPTR_T magic;
+  int             cls;   /* size class, PETSC_POOL_LARGE for space from the system, -2-level for space from an arena */
+  int             size;  /* requested size for space from an arena, needed by realloc */
+} PetscPoolHeader;
+
+#define PETSC_POOL_MAGIC      ((PETSC_UINTPTR_T)0x5ca1ab1e5ca1ab1e)
+#define PETSC_POOL_HEADER     (((sizeof(PetscPoolHeader)+PETSC_MEMALIGN-1)/PETSC_MEMALIGN)*PETSC_MEMALIGN)
+#define PETSC_POOL_LARGE      (-1)
+#define PETSC_POOL_MIN_SHIFT  6              /* smallest class is 64 bytes */
+#define PETSC_POOL_MAX_CLASS  (1+4*(8*(int)sizeof(size_t)-PETSC_POOL_MIN_SHIFT))
+#define PETSC_POOL_MAX_ARENAS 32
+
+#define PetscPoolHeaderOf(ptr) ((PetscPoolHeader*)((char*)(ptr) - PETSC_POOL_HEADER))
+
+typedef struct _n_PetscPoolChunk *PetscPoolChunk;
+struct _n_PetscPoolChunk {
+  PetscPoolChunk next;
+  size_t         size,used;
+  char           *data;
+};
+
+typedef struct {
+  PetscPoolChunk chunk;  /* chunk and position when the scope was pushed */
+  size_t         used;
+  PetscInt       live;   /* number of allocations of the scope that have not been freed */
+} PetscPoolArena;
+
+static void           *PetscPoolFreeList[PETSC_POOL_MAX_CLASS];  /* the first bytes of a free block point to the next one */
+static size_t         PetscPoolMaxSize    = 8*1024*1024;         /* larger requests go to the system */
+static size_t         PetscPoolCacheSize  = 128*1024*1024;       /* free space kept in the lists, above it frees go to the system */
+static size_t         PetscPoolCached     = 0;
+static PetscPoolChunk PetscPoolChunks     = NULL,PetscPoolCurrent = NULL;
+static PetscPoolArena PetscPoolArenas[PETSC_POOL_MAX_ARENAS];
+static int            PetscPoolNArenas    = 0;
+static PetscBool      PetscPoolActive     = PETSC_FALSE;
+
+/* Size class of a block of size bytes (including the header), there are four classes between two powers of two */
+PETSC_STATIC_INLINE int PetscPoolClass(size_t bytes,size_t *csize)
+{
+  size_t base,step;
+  int    k = 0;
+
+  if (bytes <= ((size_t)1 << PETSC_POOL_MIN_SHIFT)) {*csize = (size_t)1 << PETSC_POOL_MIN_SHIFT; return 0;}
+  for (base=(bytes-1)>>1; base; base>>=1) k++;
+  base   = (size_t)1 << k;
+  step   = base >> 2;
+  *csize = base + step*(1 + (bytes-1-base)/step);
+  return 1 + 4*(k-PETSC_POOL_MIN_SHIFT) + (int)((bytes-1-base)/step);
+}
+
+/* Size of the blocks of a class, the inverse of PetscPoolClass() */
+PETSC_STATIC_INLINE size_t PetscPoolClassSize(int cls)
+{
+  size_t base;
+
+  if (!cls) return (size_t)1 << PETSC_POOL_MIN_SHIFT;
+  base = (size_t)1 << (PETSC_POOL_MIN_SHIFT + (cls-1)/4);
+  return base + (base >> 2)*(1 + (cls-1)%4);
+}
+
+static PetscErrorCode PetscPoolMallocArena(size_t a,int line,const char func[],const char file[],void **result)
+{
+  PetscPoolArena  *arena = &PetscPoolArenas[PetscPoolNArenas-1];
+  PetscPoolChunk  chunk  = PetscPoolCurrent;
+  PetscPoolHeader *header;
+  size_t          need   = PETSC_POOL_HEADER + ((a+PETSC_MEMALIGN-1)/PETSC_MEMALIGN)*PETSC_MEMALIGN;
+  PetscErrorCode  ierr;
+
+  if (!chunk || chunk->used + need > chunk->size) {
+    /* chunks after the current one were used by scopes that have been popped, reuse them when large enough */
+    if (chunk && chunk->next && chunk->next->size >= need) {
+      chunk = chunk->next;
+    } else {
+      PetscPoolChunk newchunk;
+      size_t         size = PetscMax(need,(size_t)1024*1024);
+
+      ierr = PetscMallocAlign(sizeof(struct _n_PetscPoolChunk),PETSC_FALSE,line,func,file,(void**)&newchunk);if (ierr) return ierr;
+      ierr = PetscMallocAlign(size,PETSC_FALSE,line,func,file,(void**)&newchunk->data);if (ierr) return ierr;
+      newchunk->size = size;
+      if (chunk) {newchunk->next = chunk->next; chunk->next = newchunk;}
+      else       {newchunk->next = PetscPoolChunks; PetscPoolChunks = newchunk;}
+      chunk = newchunk;
+    }
+    chunk->used      = 0;
+    PetscPoolCurrent = chunk;
+  }
+  header          = (PetscPoolHeader*)(chunk->data + chunk->used);
+  chunk->used    += need;
+  header->cls     = -2 - (PetscPoolNArenas-1);
+  header->size    = (int)a;
+  *result         = (char*)header + PETSC_POOL_HEADER;
+  header->magic   = PETSC_POOL_MAGIC ^ (PETSC_UINTPTR_T)*result;
+  arena->live++;
+  return 0;
+}
+
+static PetscErrorCode PetscPoolMalloc(size_t a,PetscBool clear,int line,const char func[],const char file[],void **result)
+{
+  PetscPoolHeader *header;
+  size_t          csize;
+  int             cls;
+  PetscErrorCode  ierr;
+
+  if (!a) {*result = NULL; return 0;}
+  if (PetscPoolNArenas && a <= (size_t)PETSC_MPI_INT_MAX) {
+    ierr = PetscPoolMallocArena(a,line,func,file,result);if (ierr) return ierr;
+  } else if (a > PetscPoolMaxSize) {
+    ierr = PetscMallocAlign(PETSC_POOL_HEADER+a,PETSC_FALSE,line,func,file,(void**)&header);if (ierr) return ierr;
+    header->cls = PETSC_POOL_LARGE;
+    *result     = (char*)header + PETSC_POOL_HEADER;
+  } else {
+    cls = PetscPoolClass(PETSC_POOL_HEADER+a,&csize);
+    if (PetscPoolFreeList[cls]) {
+      header                 = (PetscPoolHeader*)PetscPoolFreeList[cls];
+      PetscPoolFreeList[cls] = *(void**)header;
+      PetscPoolCached       -= csize;
+    } else {
+      ierr = PetscMallocAlign(csize,PETSC_FALSE,line,func,file,(void**)&header);if (ierr) return ierr;
+    }
+    header->cls = cls;
+    *result     = (char*)header + PETSC_POOL_HEADER;
+  }
+  header        = PetscPoolHeaderOf(*result);
+  header->magic = PETSC_POOL_MAGIC ^ (PETSC_UINTPTR_T)*result;
+  if (clear) {ierr = PetscMemzero(*result,a);if (ierr) return ierr;}
+  return 0;
+}
+
+static PetscErrorCode PetscPoolFree(void *ptr,int line,const char func[],const char file[])
+{
+  PetscPoolHeader *header;
+  size_t          csize;
+  int             cls;
+
+  if (!ptr) return 0;
+  header = PetscPoolHeaderOf(ptr);
+  if (header->magic != (PETSC_POOL_MAGIC ^ (PETSC_UINTPTR_T)ptr)) return PetscFreeAlign(ptr,line,func,file);
+  header->magic = 0;
+  cls           = header->cls;
+  if (cls == PETSC_POOL_LARGE) return PetscFreeAlign(header,line,func,file);
+  if (cls < PETSC_POOL_LARGE) {
+    PetscInt level = -2 - cls;
+    if (level >= PetscPoolNArenas) return PetscError(PETSC_COMM_SELF,line,func,file,PETSC_ERR_ARG_WRONGSTATE,PETSC_ERROR_INITIAL,"Freeing space of an arena scope that has been popped");
+    PetscPoolArenas[level].live--;
+    return 0;
+  }
+  csize = PetscPoolClassSize(cls);
+  if (PetscPoolCached + csize > PetscPoolCacheSize) return PetscFreeAlign(header,line,func,file);
+  *(void**)header        = PetscPoolFreeList[cls];
+  PetscPoolFreeList[cls] = header;
+  PetscPoolCached       += csize;
+  return 0;
+}
+
+static PetscErrorCode PetscPoolRealloc(size_t a,int line,const char func[],const char file[],void **result)
+{
+  PetscPoolHeader *header;
+  size_t          old;
+  void            *newresult;
+  PetscErrorCode  ierr;
+
+  if (!*result) return PetscPoolMalloc(a,PETSC_FALSE,line,func,file,result);
+  if (!a) {
+    ierr    = PetscPoolFree(*result,line,func,file);if (ierr) return ierr;
+    *result = NULL;
+    return 0;
+  }
+  header = PetscPoolHeaderOf(*result);
+  if (header->magic != (PETSC_POOL_MAGIC ^ (PETSC_UINTPTR_T)*result)) return PetscReallocAlign(a,line,func,file,result);
+  if (header->cls == PETSC_POOL_LARGE && a > PetscPoolMaxSize) {
+    ierr          = PetscReallocAlign(PETSC_POOL_HEADER+a,line,func,file,(void**)&header);if (ierr) return ierr;
+    *result       = (char*)header + PETSC_POOL_HEADER;
+    header->magic = PETSC_POOL_MAGIC ^ (PETSC_UINTPTR_T)*result;
+    return 0;
+  }
+  if (header->cls >= 0) {
+    old = PetscPoolClassSize(header->cls) - PETSC_POOL_HEADER;
+    if (a <= old) return 0;
+  } else if (header->cls == PETSC_POOL_LARGE) old = PetscPoolMaxSize;
+  else old = (size_t)header->size;
+  ierr = PetscPoolMalloc(a,PETSC_FALSE,line,func,file,&newresult);if (ierr) return ierr;
+  ierr = PetscMemcpy(newresult,*result,PetscMin(a,old));if (ierr) return ierr;
+  ierr = PetscPoolFree(*result,line,func,file);if (ierr) return ierr;
+  *result = newresult;
+  return 0;
+}
+
+/*@C
+   PetscMallocArenaPush - Starts a scope in which the allocations are taken consecutively from large chunks of memory
+   and are released together by PetscMallocArenaPop()
+
+   Not Collective
+
+   Notes:
+   This is meant for transient work space created and destroyed within one operation, it avoids the cost of
+   many small allocations and the fragmentation of the heap. All the space allocated after PetscMallocArenaPush()
+   must be freed before the matching PetscMallocArenaPop(); PetscFree() does not return the space, it is reused
+   after PetscMallocArenaPop(). Scopes can be nested.
+
+   Only has an effect when the pool allocator is used (-malloc_pool), otherwise it does nothing.
+
+   Level: developer
+
+.seealso: PetscMallocArenaPop(), PetscMallocSet()
+@*/
+PetscErrorCode PetscMallocArenaPush(void)
+{
+  PetscFunctionBegin;
+  if (!PetscPoolActive) PetscFunctionReturn(0);
+  if (PetscPoolNArenas == PETSC_POOL_MAX_ARENAS) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Too many nested arena scopes, at most %d",PETSC_POOL_MAX_ARENAS);
+  PetscPoolArenas[PetscPoolNArenas].chunk = PetscPoolCurrent;
+  PetscPoolArenas[PetscPoolNArenas].used  = PetscPoolCurrent ? PetscPoolCurrent->used : 0;
+  PetscPoolArenas[PetscPoolNArenas].live  = 0;
+  PetscPoolNArenas++;
+  PetscFunctionReturn(0);
+}
+
+/*@C
+   PetscMallocArenaPop - Ends the scope started with PetscMallocArenaPush() and makes its space available again
+
+   Not Collective
+
+   Level: developer
+
+.seealso: PetscMallocArenaPush()
+@*/
+PetscErrorCode PetscMallocArenaPop(void)
+{
+  PetscPoolArena *arena;
+
+  PetscFunctionBegin;
+  if (!PetscPoolActive) PetscFunctionReturn(0);
+  if (!PetscPoolNArenas) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"PetscMallocArenaPop() without PetscMallocArenaPush()");
+  arena = &PetscPoolArenas[PetscPoolNArenas-1];
+  if (arena->live) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_WRONGSTATE,"%D allocations made since PetscMallocArenaPush() have not been freed",arena->live);
+  PetscPoolCurrent = arena->chunk;
+  if (PetscPoolCurrent) PetscPoolCurrent->used = arena->used;
+  else if (PetscPoolChunks) {PetscPoolCurrent = PetscPoolChunks; PetscPoolCurrent->used = 0;}
+  PetscPoolNArenas--;
+  PetscFunctionReturn(0);
+}
+
+/*
+   PetscSetUsePoolMalloc_Private - Makes PetscMalloc() use the pool allocator, see -malloc_pool
+*/
+PETSC_INTERN PetscErrorCode PetscSetUsePoolMalloc_Private(void)
+{
+  PetscInt       size;
+  PetscBool      flg;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-malloc_pool_max_size",&size,&flg);CHKERRQ(ierr);
+  if (flg) PetscPoolMaxSize = (size_t)size;
+  ierr = PetscOptionsGetInt(NULL,NULL,"-malloc_pool_cache_size",&size,&flg);CHKERRQ(ierr);
+  if (flg) PetscPoolCacheSize = (size_t)size;
+  ierr = PetscMallocSet(PetscPoolMalloc,PetscPoolFree,PetscPoolRealloc);CHKERRQ(ierr);
+  PetscPoolActive = PETSC_TRUE;
+  PetscFunctionReturn(0);
+}
+
+/*
+   PetscMallocPoolDestroy_Private - Returns the cached blocks and the arena chunks to the system, called by PetscMallocClear()
+*/
+PETSC_INTERN PetscErrorCode PetscMallocPoolDestroy_Private(void)
+{
+  PetscPoolChunk chunk;
+  void           *block;
+  int            i;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!PetscPoolActive) PetscFunctionReturn(0);
+  for (i=0; i<PETSC_POOL_MAX_CLASS; i++) {
+    while ((block = PetscPoolFreeList[i])) {
+      PetscPoolFreeList[i] = *(void**)block;
+      ierr = PetscFreeAlign(block,__LINE__,PETSC_FUNCTION_NAME,__FILE__);CHKERRQ(ierr);
+    }
+  }
+  while ((chunk = PetscPoolChunks)) {
+    PetscPoolChunks = chunk->next;
+    ierr = PetscFreeAlign(chunk->data,__LINE__,PETSC_FUNCTION_NAME,__FILE__);CHKERRQ(ierr);
+    ierr = PetscFreeAlign(chunk,__LINE__,PETSC_FUNCTION_NAME,__FILE__);CHKERRQ(ierr);
+  }
+  PetscPoolCurrent = NULL;
+  PetscPoolNArenas = 0;
+  PetscPoolCached  = 0;
+  PetscPoolActive  = PETSC_FALSE;
+  PetscFunctionReturn(0);
+}
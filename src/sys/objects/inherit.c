@@ -47,6 +47,10 @@ PetscErrorCode  PetscHeaderCreate_Private(PetscObject h,PetscClassId classid,con
   h->refct                 = 1;
 #if defined(PETSC_HAVE_SAWS)
   h->amsmem                = PETSC_FALSE;
+#endif
+#if defined(PETSC_HAVE_THREADSAFETY) && defined(PETSC_HAVE_OPENMP)
+  /* objects may be created by several threads, e.g. the factors of the blocks of PCBJACOBI and PCASM */
+#pragma omp atomic capture
 #endif
   h->id                    = idcnt++;
   h->parentid              = 0;
@@ -13,6 +13,7 @@ EXTERN_C_END
 
 #if defined(PETSC_USE_LOG)
 PETSC_INTERN PetscErrorCode PetscLogFinalize(void);
+PETSC_INTERN PetscErrorCode PetscLogTimelineViewFromOptions(void);
 #endif
 
 #if defined(PETSC_SERIALIZE_FUNCTIONS)
@@ -695,6 +696,9 @@ PetscInt PetscNumOMPThreads;
 .  -malloc - Indicates use of PETSc error-checking malloc (on by default for debug version of libraries) (deprecated, use -malloc_debug)
 .  -malloc no - Indicates not to use error-checking malloc (deprecated, use -malloc_debug no)
 .  -malloc_debug - check for memory corruption at EVERY malloc or free, see PetscMallocSetDebug()
+.  -malloc_pool - keep freed space in free lists by size class and reuse it, see PetscMallocArenaPush(); with debugging PETSc it requires -malloc_debug 0, not available with --with-threadsafety
+.  -malloc_pool_max_size <bytes> - larger allocations are not pooled (default 8 MB)
+.  -malloc_pool_cache_size <bytes> - maximum amount of freed space kept by the pool (default 128 MB)
 .  -malloc_dump - prints a list of all unfreed memory at the end of the run
 .  -malloc_test - like -malloc_dump -malloc_debug, but only active for debugging builds, ignored in optimized build. May want to set in PETSC_OPTIONS environmental variable
 .  -malloc_view - show a list of all allocated memory during PetscFinalize()
@@ -727,12 +731,14 @@ PetscInt PetscNumOMPThreads;
         hangs without running in the debugger).  See PetscLogTraceBegin().
 .  -log_view [:filename:format] - Prints summary of flop and timing information to screen or file, see PetscLogView().
 .  -log_view_memory - Includes in the summary from -log_view the memory used in each method, see PetscLogView().
+.  -log_view_hwcounters - Includes in the summary from -log_view the hardware counters (cycles, instructions, cache misses) of each method, Linux only, see PetscLogView().
 .  -log_summary [filename] - (Deprecated, use -log_view) Prints summary of flop and timing information to screen. If the filename is specified the
         summary is written to the file.  See PetscLogView().
 .  -log_exclude: <vec,mat,pc,ksp,snes> - excludes subset of object classes from logging
 .  -log_all [filename] - Logs extensive profiling information  See PetscLogDump().
 .  -log [filename] - Logs basic profiline information  See PetscLogDump().
 .  -log_mpe [filename] - Creates a logfile viewable by the utility Jumpshot (in MPICH distribution)
+.  -log_timeline [filename] - Saves a timeline of the events on each process in the Chrome trace format, see PetscLogTimelineBegin()
 .  -viewfromoptions on,off - Enable or disable XXXSetFromOptions() calls, for applications with many small solves turn this off
 -  -check_pointer_intensity 0,1,2 - if pointers are checked for validity (debug version only), using 0 will result in faster code
 
@@ -1349,6 +1355,7 @@ PetscErrorCode  PetscFinalize(void)
   ierr = PetscOptionsPushGetViewerOff(PETSC_FALSE);CHKERRQ(ierr);
   ierr = PetscLogViewFromOptions();CHKERRQ(ierr);
   ierr = PetscOptionsPopGetViewerOff();CHKERRQ(ierr);
+  ierr = PetscLogTimelineViewFromOptions();CHKERRQ(ierr);
 
   mname[0] = 0;
   ierr = PetscOptionsGetString(NULL,NULL,"-log_summary",mname,sizeof(mname),&flg1);CHKERRQ(ierr);
@@ -0,0 +1,80 @@
+static char help[] = "Tests the pool allocator (-malloc_pool) and PetscMallocArenaPush()/PetscMallocArenaPop().\n\n";
+
+#include <petscvec.h>
+
+int main(int argc,char **argv)
+{
+  PetscScalar    *a[64],*b;
+  PetscInt       i,j,n,*idx;
+  PetscReal      nrm;
+  Vec            x,y;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&argv,NULL,help);if (ierr) return ierr;
+
+  /* allocations of many sizes, freed in a different order, then allocated again */
+  for (i=0; i<64; i++) {
+    ierr = PetscMalloc1(1+i*i*37,&a[i]);CHKERRQ(ierr);
+    for (j=0; j<1+i*i*37; j++) a[i][j] = (PetscScalar)i;
+  }
+  for (i=0; i<64; i+=2) {ierr = PetscFree(a[i]);CHKERRQ(ierr);}
+  for (i=0; i<64; i+=2) {ierr = PetscCalloc1(1+i*i*37,&a[i]);CHKERRQ(ierr);}
+  for (i=0; i<64; i++) {
+    for (j=0; j<1+i*i*37; j++) {
+      if (a[i][j] != (PetscScalar)(i%2 ? i : 0)) SETERRQ2(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Wrong value in allocation %D entry %D",i,j);
+    }
+    ierr = PetscFree(a[i]);CHKERRQ(ierr);
+  }
+
+  /* realloc keeps the content, also when moving to another size class */
+  ierr = PetscMalloc1(10,&idx);CHKERRQ(ierr);
+  for (i=0; i<10; i++) idx[i] = i;
+  for (n=20; n<200000; n*=3) {
+    ierr = PetscRealloc(n*sizeof(PetscInt),&idx);CHKERRQ(ierr);
+    for (i=n/3; i<n; i++) idx[i] = i;
+  }
+  for (i=0; i<n/3; i++) if (idx[i] != i) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_PLIB,"Wrong value after realloc at %D",i);
+  ierr = PetscFree(idx);CHKERRQ(ierr);
+
+  /* nested arena scopes with objects created and destroyed inside them */
+  ierr = VecCreateSeq(PETSC_COMM_SELF,100,&x);CHKERRQ(ierr);
+  ierr = VecSet(x,1.0);CHKERRQ(ierr);
+  for (i=0; i<3; i++) {
+    ierr = PetscMallocArenaPush();CHKERRQ(ierr);
+    ierr = VecDuplicate(x,&y);CHKERRQ(ierr);
+    ierr = VecCopy(x,y);CHKERRQ(ierr);
+    ierr = PetscMallocArenaPush();CHKERRQ(ierr);
+    ierr = PetscMalloc1(3000000,&b);CHKERRQ(ierr);
+    b[2999999] = 2.0;
+    ierr = VecScale(y,PetscRealPart(b[2999999]));CHKERRQ(ierr);
+    ierr = PetscFree(b);CHKERRQ(ierr);
+    ierr = PetscMallocArenaPop();CHKERRQ(ierr);
+    ierr = VecAXPY(x,1.0,y);CHKERRQ(ierr);
+    ierr = VecDestroy(&y);CHKERRQ(ierr);
+    ierr = PetscMallocArenaPop();CHKERRQ(ierr);
+  }
+  ierr = VecNorm(x,NORM_1,&nrm);CHKERRQ(ierr);
+  ierr = PetscPrintf(PETSC_COMM_SELF,"Norm %g\n",(double)nrm);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      suffix: 0
+
+   test:
+      suffix: pool
+      requires: !define(PETSC_HAVE_THREADSAFETY)
+      args: -malloc_debug 0 -malloc_pool
+      output_file: output/ex55_0.out
+
+   test:
+      suffix: pool_small
+      requires: !define(PETSC_HAVE_THREADSAFETY)
+      args: -malloc_debug 0 -malloc_pool -malloc_pool_max_size 1000 -malloc_pool_cache_size 10000
+      output_file: output/ex55_0.out
+
+TEST*/
@@ -3,12 +3,20 @@
 
 #if defined(PETSC_HAVE_MPI_NEIGHBORHOOD_COLLECTIVES)
 
+#if defined(PETSC_HAVE_MPIX_NEIGHBOR_ALLTOALLV_INIT)
+#include <mpi-ext.h>
+#define MPIU_Neighbor_alltoallv_init MPIX_Neighbor_alltoallv_init
+#elif defined(PETSC_HAVE_MPI_PERSISTENT_NEIGHBORHOOD_COLLECTIVES)
+#define MPIU_Neighbor_alltoallv_init MPI_Neighbor_alltoallv_init
+#endif
+
 typedef struct {
   SFBASICHEADER;
   MPI_Comm      comms[2];       /* Communicators with distributed topology in both directions */
   PetscBool     initialized[2]; /* Are the two communicators initialized? */
   PetscMPIInt   *rootdispls,*rootcounts,*leafdispls,*leafcounts; /* displs/counts for non-distinguished ranks */
   PetscInt      rootdegree,leafdegree;
+  PetscBool     persistent;     /* Use persistent neighborhood collectives, created once per link and direction */
 } PetscSF_Neighbor;
 
 /*===================================================================================*/
@@ -44,9 +52,40 @@ static PetscErrorCode PetscSFGetDistComm_Neighbor(PetscSF sf,PetscSFDirection di
   PetscFunctionReturn(0);
 }
 
+/* Create the persistent neighborhood alltoallv of a link in one direction, unless it was already created. The request
+   stays valid for the lifetime of the link since with persistent requests the link always uses its own buffers */
+static PetscErrorCode PetscSFNeighborInitPersistent(PetscSF sf,PetscInt outdegree,PetscInt indegree,void *sendbuf,const PetscMPIInt *sendcounts,const PetscMPIInt *sdispls,void *recvbuf,const PetscMPIInt *recvcounts,const PetscMPIInt *rdispls,MPI_Datatype unit,MPI_Comm distcomm,MPI_Request *req)
+{
+#if defined(MPIU_Neighbor_alltoallv_init)
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (*req == MPI_REQUEST_NULL && (outdegree || indegree)) {
+    ierr = MPIU_Neighbor_alltoallv_init(sendbuf,sendcounts,sdispls,unit,recvbuf,recvcounts,rdispls,unit,distcomm,MPI_INFO_NULL,req);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+#else
+  SETERRQ(PetscObjectComm((PetscObject)sf),PETSC_ERR_SUP_SYS,"Persistent neighborhood collectives need MPI-4 or MPIX_Neighbor_alltoallv_init()");
+#endif
+}
+
 /*===================================================================================*/
 /*              Implementations of SF public APIs                                    */
 /*===================================================================================*/
+static PetscErrorCode PetscSFSetFromOptions_Neighbor(PetscOptionItems *PetscOptionsObject,PetscSF sf)
+{
+  PetscSF_Neighbor *dat = (PetscSF_Neighbor*)sf->data;
+  PetscErrorCode   ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscOptionsHead(PetscOptionsObject,"PetscSF Neighbor options");CHKERRQ(ierr);
+#if defined(MPIU_Neighbor_alltoallv_init)
+  ierr = PetscOptionsBool("-sf_neighbor_persistent","Use persistent neighborhood collectives, created once and started on each communication","None",dat->persistent,&dat->persistent,NULL);CHKERRQ(ierr);
+#endif
+  ierr = PetscOptionsTail();CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 static PetscErrorCode PetscSFSetUp_Neighbor(PetscSF sf)
 {
   PetscErrorCode   ierr;
@@ -56,7 +95,8 @@ static PetscErrorCode PetscSFSetUp_Neighbor(PetscSF sf)
   PetscMPIInt      m,n;
 
   PetscFunctionBegin;
-  /* SFNeighbor inherits from Basic */
+  /* SFNeighbor inherits from Basic. A persistent request is bound to its buffers, so always use the buffers of the link */
+  dat->remotebuffered = dat->persistent;
   ierr = PetscSFSetUp_Basic(sf);CHKERRQ(ierr);
   /* SFNeighbor specific */
   sf->persistent  = PETSC_FALSE;
@@ -89,6 +129,7 @@ static PetscErrorCode PetscSFReset_Neighbor(PetscSF sf)
 
   PetscFunctionBegin;
   if (dat->inuse) SETERRQ(PetscObjectComm((PetscObject)sf),PETSC_ERR_ARG_WRONGSTATE,"Outstanding operation has not been completed");
+  ierr = PetscSFReset_Basic(sf);CHKERRQ(ierr); /* Common part, done first since it frees the persistent requests using the arrays and communicators below */
   ierr = PetscFree4(dat->rootdispls,dat->rootcounts,dat->leafdispls,dat->leafcounts);CHKERRQ(ierr);
   for (i=0; i<2; i++) {
     if (dat->initialized[i]) {
@@ -96,7 +137,6 @@ static PetscErrorCode PetscSFReset_Neighbor(PetscSF sf)
       dat->initialized[i] = PETSC_FALSE;
     }
   }
-  ierr = PetscSFReset_Basic(sf);CHKERRQ(ierr); /* Common part */
   PetscFunctionReturn(0);
 }
 
@@ -125,7 +165,12 @@ static PetscErrorCode PetscSFBcastAndOpBegin_Neighbor(PetscSF sf,MPI_Datatype un
   /* Do neighborhood alltoallv for remote ranks */
   ierr = PetscSFGetDistComm_Neighbor(sf,PETSCSF_ROOT2LEAF,&distcomm);CHKERRQ(ierr);
   ierr = PetscSFLinkGetMPIBuffersAndRequests(sf,link,PETSCSF_ROOT2LEAF,&rootbuf,&leafbuf,&req,NULL);CHKERRQ(ierr);
-  ierr = MPI_Start_ineighbor_alltoallv(dat->rootdegree,dat->leafdegree,rootbuf,dat->rootcounts,dat->rootdispls,unit,leafbuf,dat->leafcounts,dat->leafdispls,unit,distcomm,req);CHKERRQ(ierr);
+  if (dat->persistent) {
+    ierr = PetscSFNeighborInitPersistent(sf,dat->rootdegree,dat->leafdegree,rootbuf,dat->rootcounts,dat->rootdispls,leafbuf,dat->leafcounts,dat->leafdispls,unit,distcomm,req);CHKERRQ(ierr);
+    ierr = MPI_Start_ineighbor_persistent(dat->rootdegree,dat->leafdegree,dat->rootcounts,unit,dat->leafcounts,unit,req);CHKERRQ(ierr);
+  } else {
+    ierr = MPI_Start_ineighbor_alltoallv(dat->rootdegree,dat->leafdegree,rootbuf,dat->rootcounts,dat->rootdispls,unit,leafbuf,dat->leafcounts,dat->leafdispls,unit,distcomm,req);CHKERRQ(ierr);
+  }
   ierr = PetscSFLinkBcastAndOpLocal(sf,link,rootdata,leafdata,op);
   PetscFunctionReturn(0);
 }
@@ -145,7 +190,12 @@ PETSC_STATIC_INLINE PetscErrorCode PetscSFLeafToRootBegin_Neighbor(PetscSF sf,MP
   /* Do neighborhood alltoallv for remote ranks */
   ierr = PetscSFGetDistComm_Neighbor(sf,PETSCSF_LEAF2ROOT,&distcomm);CHKERRQ(ierr);
   ierr = PetscSFLinkGetMPIBuffersAndRequests(sf,link,PETSCSF_LEAF2ROOT,&rootbuf,&leafbuf,&req,NULL);CHKERRQ(ierr);
-  ierr = MPI_Start_ineighbor_alltoallv(dat->leafdegree,dat->rootdegree,leafbuf,dat->leafcounts,dat->leafdispls,unit,rootbuf,dat->rootcounts,dat->rootdispls,unit,distcomm,req);CHKERRQ(ierr);
+  if (dat->persistent) {
+    ierr = PetscSFNeighborInitPersistent(sf,dat->leafdegree,dat->rootdegree,leafbuf,dat->leafcounts,dat->leafdispls,rootbuf,dat->rootcounts,dat->rootdispls,unit,distcomm,req);CHKERRQ(ierr);
+    ierr = MPI_Start_ineighbor_persistent(dat->leafdegree,dat->rootdegree,dat->leafcounts,unit,dat->rootcounts,unit,req);CHKERRQ(ierr);
+  } else {
+    ierr = MPI_Start_ineighbor_alltoallv(dat->leafdegree,dat->rootdegree,leafbuf,dat->leafcounts,dat->leafdispls,unit,rootbuf,dat->rootcounts,dat->rootdispls,unit,distcomm,req);CHKERRQ(ierr);
+  }
   *out = link;
   PetscFunctionReturn(0);
 }
@@ -206,6 +256,7 @@ PETSC_INTERN PetscErrorCode PetscSFCreate_Neighbor(PetscSF sf)
   sf->ops->ReduceEnd            = PetscSFReduceEnd_Basic;
   sf->ops->GetLeafRanks         = PetscSFGetLeafRanks_Basic;
   sf->ops->View                 = PetscSFView_Basic;
+  sf->ops->SetFromOptions       = PetscSFSetFromOptions_Neighbor;
 
   sf->ops->SetUp                = PetscSFSetUp_Neighbor;
   sf->ops->Reset                = PetscSFReset_Neighbor;
@@ -753,6 +753,17 @@ PetscErrorCode PetscSFLinkDestroy(PetscSF sf,PetscSFLink *avail)
       if (link->reqs[i] != MPI_REQUEST_NULL) {ierr = MPI_Request_free(&link->reqs[i]);CHKERRQ(ierr);}
     }
     ierr = PetscFree(link->reqs);CHKERRQ(ierr);
+#if defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+    if (link->shminited) { /* Remote host buffers are owned by the shared memory windows. Freeing them is collective on the node */
+      for (i=0; i<2; i++) {
+        ierr = MPI_Win_unlock_all(link->shmwin[i]);CHKERRQ(ierr);
+        ierr = MPI_Win_free(&link->shmwin[i]);CHKERRQ(ierr);
+      }
+      link->rootbuf_alloc[PETSCSF_REMOTE][PETSC_MEMTYPE_HOST] = NULL;
+      link->leafbuf_alloc[PETSCSF_REMOTE][PETSC_MEMTYPE_HOST] = NULL;
+      ierr = PetscFree2(link->shmrootsrc,link->shmleafsrc);CHKERRQ(ierr);
+    }
+#endif
     for (i=PETSCSF_LOCAL; i<=PETSCSF_REMOTE; i++) {
 #if defined(PETSC_HAVE_CUDA)
       ierr = PetscFreeWithMemType(PETSC_MEMTYPE_DEVICE,link->rootbuf_alloc[i][PETSC_MEMTYPE_DEVICE]);CHKERRQ(ierr);
@@ -1659,7 +1670,7 @@ PetscErrorCode PetscSFSetUpPackFields(PetscSF sf)
     if (sf->rmine[i] != sf->leafstart[0]+i) {sf->leafcontig[0] = PETSC_FALSE; break;}
   }
   for (i=sf->roffset[sf->ndranks],j=0; i<sf->roffset[sf->nranks]; i++,j++) { /* remote */
-    if (sf->rmine[i] != sf->leafstart[1]+j) {sf->leafcontig[1] = PETSC_FALSE; break;}
+    if (bas->remotebuffered || sf->rmine[i] != sf->leafstart[1]+j) {sf->leafcontig[1] = PETSC_FALSE; break;}
   }
 
   /* If not, see if we can have per-rank optimizations by doing index analysis */
@@ -1677,7 +1688,7 @@ PetscErrorCode PetscSFSetUpPackFields(PetscSF sf)
     if (bas->irootloc[i] != bas->rootstart[0]+i) {bas->rootcontig[0] = PETSC_FALSE; break;}
   }
   for (i=bas->ioffset[bas->ndiranks],j=0; i<bas->ioffset[bas->niranks]; i++,j++) {
-    if (bas->irootloc[i] != bas->rootstart[1]+j) {bas->rootcontig[1] = PETSC_FALSE; break;}
+    if (bas->remotebuffered || bas->irootloc[i] != bas->rootstart[1]+j) {bas->rootcontig[1] = PETSC_FALSE; break;}
   }
 
   if (!bas->rootcontig[0]) {ierr = PetscSFCreatePackOpt(bas->ndiranks,              bas->ioffset,               bas->irootloc, &bas->rootpackopt[0]);CHKERRQ(ierr);}
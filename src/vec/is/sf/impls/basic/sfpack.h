@@ -160,6 +160,13 @@ struct _n_PetscSFLink {
   PetscBool    rootreqsinited[2][2][2];      /* Are root requests initialized? Also in layout of [PETSCSF_DIRECTION][PETSC_MEMTYPE][rootdirect_mpi]*/
   PetscBool    leafreqsinited[2][2][2];      /* Are leaf requests initialized? Also in layout of [PETSCSF_DIRECTION][PETSC_MEMTYPE][leafdirect_mpi]*/
   MPI_Request  *reqs;                        /* An array of length (nrootreqs+nleafreqs)*8. Pointers in rootreqs[][][] and leafreqs[][][] point here */
+#if defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+  /* Only used by SFShm */
+  PetscBool    shminited;                    /* Are root/leafbuf_alloc[PETSCSF_REMOTE][PETSC_MEMTYPE_HOST] in the shared memory windows below? */
+  MPI_Win      shmwin[2];                    /* Shared memory windows of the remote root and leaf buffers, in layout of [root/leaf] */
+  char         **shmrootsrc;                 /* [nranks-ndranks] Segments of my leaves in rootbuf of on-node peers, NULL for off-node ranks */
+  char         **shmleafsrc;                 /* [niranks-ndiranks] Segments of my roots in leafbuf of on-node peers, NULL for off-node ranks */
+#endif
   PetscSFLink  next;
 };
 
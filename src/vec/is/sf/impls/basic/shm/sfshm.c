@@ -0,0 +1,438 @@
+#include <../src/vec/is/sf/impls/basic/sfpack.h>
+#include <../src/vec/is/sf/impls/basic/sfbasic.h>
+
+#if defined(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+
+/* SFShm inherits the graph setup and packing of SFBasic. Remote ranks on the same node (on-node peers) do not exchange
+   messages. Instead, the remote root/leaf buffers of each link live in MPI-3 shared memory windows and receivers unpack
+   directly from the packed buffers of their on-node peers. Only edges to ranks on other nodes go through MPI.
+
+   Buffers are reused by later communications with the same link, so a communication synchronizes on-node ranks twice:
+   once when the buffers are packed and can be read by peers, and once when peers are done reading them.
+*/
+typedef struct {
+  SFBASICHEADER;
+  MPI_Comm      shmcomm;        /* Communicator of ranks of the SF on this node */
+  PetscBool     active;         /* Does any rank on this node have on-node peers? If not, there is nothing to synchronize */
+  PetscMPIInt   *rootshmranks;  /* [niranks-ndiranks] Rank in shmcomm of remote ranks referencing my roots, MPI_PROC_NULL if off-node */
+  PetscMPIInt   *leafshmranks;  /* [nranks-ndranks] Rank in shmcomm of remote ranks owning roots of my leaves, MPI_PROC_NULL if off-node */
+  PetscInt      *rootpeeroffset;/* [niranks-ndiranks] For on-node peers, offset (in units) of edges of my roots in the peer's leafbuf */
+  PetscInt      *leafpeeroffset;/* [nranks-ndranks] For on-node peers, offset (in units) of edges of my leaves in the peer's rootbuf */
+} PetscSF_Shm;
+
+/*===================================================================================*/
+/*              Internal routines                                                    */
+/*===================================================================================*/
+
+/* Make the packed buffers of on-node peers visible, or make sure peers are done reading my buffers */
+PETSC_STATIC_INLINE PetscErrorCode PetscSFShmSync(PetscSF sf,PetscSFLink link)
+{
+  PetscErrorCode ierr;
+  PetscSF_Shm    *dat = (PetscSF_Shm*)sf->data;
+
+  PetscFunctionBegin;
+  if (!dat->active) PetscFunctionReturn(0);
+  ierr = MPI_Win_sync(link->shmwin[0]);CHKERRQ(ierr);
+  ierr = MPI_Win_sync(link->shmwin[1]);CHKERRQ(ierr);
+  ierr = MPI_Barrier(dat->shmcomm);CHKERRQ(ierr);
+  ierr = MPI_Win_sync(link->shmwin[0]);CHKERRQ(ierr);
+  ierr = MPI_Win_sync(link->shmwin[1]);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* Create a link, and the first time a link is used, move its remote buffers to shared memory. Collective on the node, which
+   is fine since links are created in the same order on all ranks */
+static PetscErrorCode PetscSFShmLinkCreate(PetscSF sf,MPI_Datatype unit,PetscMemType rootmtype,const void *rootdata,PetscMemType leafmtype,const void *leafdata,MPI_Op op,PetscSFOperation sfop,PetscSFLink *mylink)
+{
+  PetscErrorCode ierr;
+  PetscSF_Shm    *dat = (PetscSF_Shm*)sf->data;
+  PetscSFLink    link;
+  PetscInt       i,nrootranks,ndrootranks,nleafranks,ndleafranks;
+  MPI_Aint       size;
+  PetscMPIInt    dispunit;
+  MPI_Info       info;
+  char           *rootbase,*leafbase,*base;
+
+  PetscFunctionBegin;
+  if (rootmtype != PETSC_MEMTYPE_HOST || leafmtype != PETSC_MEMTYPE_HOST) SETERRQ(PetscObjectComm((PetscObject)sf),PETSC_ERR_SUP,"PETSCSFSHM only supports data in host memory");
+  ierr = PetscSFLinkCreate(sf,unit,rootmtype,rootdata,leafmtype,leafdata,op,sfop,&link);CHKERRQ(ierr);
+  if (dat->active && !link->shminited) {
+    ierr = PetscSFGetRootInfo_Basic(sf,&nrootranks,&ndrootranks,NULL,NULL,NULL);CHKERRQ(ierr);
+    ierr = PetscSFGetLeafInfo_Basic(sf,&nleafranks,&ndleafranks,NULL,NULL,NULL,NULL);CHKERRQ(ierr);
+    ierr = MPI_Info_create(&info);CHKERRQ(ierr);
+    ierr = MPI_Info_set(info,"alloc_shared_noncontig","true");CHKERRQ(ierr); /* Let each rank allocate its part close to itself */
+    ierr = MPI_Win_allocate_shared((MPI_Aint)(dat->rootbuflen[PETSCSF_REMOTE]*link->unitbytes),1,info,dat->shmcomm,&rootbase,&link->shmwin[0]);CHKERRQ(ierr);
+    ierr = MPI_Win_allocate_shared((MPI_Aint)(sf->leafbuflen[PETSCSF_REMOTE]*link->unitbytes),1,info,dat->shmcomm,&leafbase,&link->shmwin[1]);CHKERRQ(ierr);
+    ierr = MPI_Info_free(&info);CHKERRQ(ierr);
+    ierr = MPI_Win_lock_all(MPI_MODE_NOCHECK,link->shmwin[0]);CHKERRQ(ierr);
+    ierr = MPI_Win_lock_all(MPI_MODE_NOCHECK,link->shmwin[1]);CHKERRQ(ierr);
+
+    /* Replace the buffers allocated by PetscSFLinkCreate() */
+    ierr = PetscFree(link->rootbuf_alloc[PETSCSF_REMOTE][PETSC_MEMTYPE_HOST]);CHKERRQ(ierr);
+    ierr = PetscFree(link->leafbuf_alloc[PETSCSF_REMOTE][PETSC_MEMTYPE_HOST]);CHKERRQ(ierr);
+    if (dat->rootbuflen[PETSCSF_REMOTE]) link->rootbuf_alloc[PETSCSF_REMOTE][PETSC_MEMTYPE_HOST] = link->rootbuf[PETSCSF_REMOTE][PETSC_MEMTYPE_HOST] = rootbase;
+    if (sf->leafbuflen[PETSCSF_REMOTE])  link->leafbuf_alloc[PETSCSF_REMOTE][PETSC_MEMTYPE_HOST] = link->leafbuf[PETSCSF_REMOTE][PETSC_MEMTYPE_HOST] = leafbase;
+
+    /* Where to unpack from for on-node peers */
+    ierr = PetscCalloc2(nleafranks-ndleafranks,&link->shmrootsrc,nrootranks-ndrootranks,&link->shmleafsrc);CHKERRQ(ierr);
+    for (i=0; i<nleafranks-ndleafranks; i++) {
+      if (dat->leafshmranks[i] == MPI_PROC_NULL) continue;
+      ierr = MPI_Win_shared_query(link->shmwin[0],dat->leafshmranks[i],&size,&dispunit,&base);CHKERRQ(ierr);
+      link->shmrootsrc[i] = base + dat->leafpeeroffset[i]*link->unitbytes;
+    }
+    for (i=0; i<nrootranks-ndrootranks; i++) {
+      if (dat->rootshmranks[i] == MPI_PROC_NULL) continue;
+      ierr = MPI_Win_shared_query(link->shmwin[1],dat->rootshmranks[i],&size,&dispunit,&base);CHKERRQ(ierr);
+      link->shmleafsrc[i] = base + dat->rootpeeroffset[i]*link->unitbytes;
+    }
+    link->shminited = PETSC_TRUE;
+  }
+  *mylink = link;
+  PetscFunctionReturn(0);
+}
+
+/* Post receives from and sends to off-node ranks in the given direction. Buffers of on-node ranks are not touched */
+static PetscErrorCode PetscSFShmStartMPI(PetscSF sf,PetscSFLink link,PetscSFDirection direction)
+{
+  PetscErrorCode    ierr;
+  PetscSF_Shm       *dat = (PetscSF_Shm*)sf->data;
+  PetscInt          i,j,nrootranks,ndrootranks,nleafranks,ndleafranks;
+  const PetscInt    *rootoffset,*leafoffset;
+  const PetscMPIInt *rootranks,*leafranks;
+  MPI_Request       *rootreqs,*leafreqs;
+  char              *rootbuf,*leafbuf;
+  PetscMPIInt       n;
+  MPI_Comm          comm = PetscObjectComm((PetscObject)sf);
+
+  PetscFunctionBegin;
+  ierr = PetscSFGetRootInfo_Basic(sf,&nrootranks,&ndrootranks,&rootranks,&rootoffset,NULL);CHKERRQ(ierr);
+  ierr = PetscSFGetLeafInfo_Basic(sf,&nleafranks,&ndleafranks,&leafranks,&leafoffset,NULL,NULL);CHKERRQ(ierr);
+  ierr = PetscSFLinkGetMPIBuffersAndRequests(sf,link,direction,(void**)&rootbuf,(void**)&leafbuf,&rootreqs,&leafreqs);CHKERRQ(ierr);
+  if (direction == PETSCSF_ROOT2LEAF) {
+    for (i=ndleafranks,j=0; i<nleafranks; i++) {
+      if (dat->leafshmranks[i-ndleafranks] != MPI_PROC_NULL) continue;
+      ierr = PetscMPIIntCast(leafoffset[i+1]-leafoffset[i],&n);CHKERRQ(ierr);
+      ierr = MPI_Irecv(leafbuf+(leafoffset[i]-leafoffset[ndleafranks])*link->unitbytes,n,link->unit,leafranks[i],link->tag,comm,&leafreqs[j++]);CHKERRQ(ierr);
+    }
+    for (i=ndrootranks,j=0; i<nrootranks; i++) {
+      if (dat->rootshmranks[i-ndrootranks] != MPI_PROC_NULL) continue;
+      ierr = PetscMPIIntCast(rootoffset[i+1]-rootoffset[i],&n);CHKERRQ(ierr);
+      ierr = MPI_Isend(rootbuf+(rootoffset[i]-rootoffset[ndrootranks])*link->unitbytes,n,link->unit,rootranks[i],link->tag,comm,&rootreqs[j++]);CHKERRQ(ierr);
+    }
+  } else {
+    for (i=ndrootranks,j=0; i<nrootranks; i++) {
+      if (dat->rootshmranks[i-ndrootranks] != MPI_PROC_NULL) continue;
+      ierr = PetscMPIIntCast(rootoffset[i+1]-rootoffset[i],&n);CHKERRQ(ierr);
+      ierr = MPI_Irecv(rootbuf+(rootoffset[i]-rootoffset[ndrootranks])*link->unitbytes,n,link->unit,rootranks[i],link->tag,comm,&rootreqs[j++]);CHKERRQ(ierr);
+    }
+    for (i=ndleafranks,j=0; i<nleafranks; i++) {
+      if (dat->leafshmranks[i-ndleafranks] != MPI_PROC_NULL) continue;
+      ierr = PetscMPIIntCast(leafoffset[i+1]-leafoffset[i],&n);CHKERRQ(ierr);
+      ierr = MPI_Isend(leafbuf+(leafoffset[i]-leafoffset[ndleafranks])*link->unitbytes,n,link->unit,leafranks[i],link->tag,comm,&leafreqs[j++]);CHKERRQ(ierr);
+    }
+  }
+  PetscFunctionReturn(0);
+}
+
+/* Unpack the remote part of data rank by rank, reading segments of on-node ranks directly from their shared buffers.
+
+   Input Arguments:
++  nranks,ndranks - Number of ranks and distinguished ranks
+.  offset   - Offsets of the ranks in indices[] and in buf
+.  indices  - Indices of the entries in data
+.  shmsrc   - Segments in the buffers of on-node peers, NULL for off-node ranks
+.  buf      - My buffer, with data received from off-node ranks
+-  op       - Operation after unpack
+
+   Output Arguments:
+.  data     - The data to unpack to
+*/
+static PetscErrorCode PetscSFShmUnpack(PetscSF sf,PetscSFLink link,PetscInt nranks,PetscInt ndranks,const PetscInt *offset,const PetscInt *indices,char **shmsrc,const char *buf,void *data,MPI_Op op)
+{
+  PetscErrorCode ierr;
+  PetscInt       i,k;
+  const char     *src;
+  PetscErrorCode (*UnpackAndOp)(PetscSFLink,PetscInt,PetscInt,PetscSFPackOpt,const PetscInt*,void*,const void*) = NULL;
+
+  PetscFunctionBegin;
+  ierr = PetscLogEventBegin(PETSCSF_Unpack,sf,0,0,0);CHKERRQ(ierr);
+  ierr = PetscSFLinkGetUnpackAndOp(link,PETSC_MEMTYPE_HOST,op,PETSC_FALSE,&UnpackAndOp);CHKERRQ(ierr);
+  for (i=ndranks; i<nranks; i++) {
+    src = (shmsrc && shmsrc[i-ndranks]) ? shmsrc[i-ndranks] : buf + (offset[i]-offset[ndranks])*link->unitbytes;
+    if (UnpackAndOp) {
+      ierr = (*UnpackAndOp)(link,offset[i+1]-offset[i],0,NULL,indices+offset[i],data,src);CHKERRQ(ierr);
+    } else {
+#if defined(PETSC_HAVE_MPI_REDUCE_LOCAL)
+      for (k=offset[i]; k<offset[i+1]; k++) {ierr = MPI_Reduce_local(src+(k-offset[i])*link->unitbytes,(char*)data+indices[k]*link->unitbytes,1,link->unit,op);CHKERRQ(ierr);}
+#else
+      SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"No unpacking reduction operation for this MPI_Op");
+#endif
+    }
+  }
+  if (op != MPIU_REPLACE && link->basicunit == MPIU_SCALAR) {ierr = PetscLogFlops((offset[nranks]-offset[ndranks])*link->bs);CHKERRQ(ierr);}
+  ierr = PetscLogEventEnd(PETSCSF_Unpack,sf,0,0,0);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*===================================================================================*/
+/*              Implementations of SF public APIs                                    */
+/*===================================================================================*/
+static PetscErrorCode PetscSFSetUp_Shm(PetscSF sf)
+{
+  PetscErrorCode    ierr;
+  PetscSF_Shm       *dat = (PetscSF_Shm*)sf->data;
+  PetscInt          i,j,nrootranks,ndrootranks,nleafranks,ndleafranks,nrootshm = 0,nleafshm = 0,*sendoffset;
+  const PetscInt    *rootoffset,*leafoffset;
+  const PetscMPIInt *rootranks,*leafranks;
+  PetscMPIInt       tag[2],hasshm,anyshm;
+  PetscShmComm      pshmcomm;
+  MPI_Request       *reqs;
+  MPI_Comm          comm;
+
+  PetscFunctionBegin;
+  /* SFShm inherits from Basic. Always pack remote data into the link buffers since they are what peers read */
+  dat->remotebuffered = PETSC_TRUE;
+  ierr = PetscSFSetUp_Basic(sf);CHKERRQ(ierr);
+  /* SFShm specific */
+  sf->persistent      = PETSC_FALSE;
+
+  ierr = PetscObjectGetComm((PetscObject)sf,&comm);CHKERRQ(ierr);
+  ierr = PetscShmCommGet(comm,&pshmcomm);CHKERRQ(ierr);
+  ierr = PetscShmCommGetMpiShmComm(pshmcomm,&dat->shmcomm);CHKERRQ(ierr);
+  ierr = PetscSFGetRootInfo_Basic(sf,&nrootranks,&ndrootranks,&rootranks,&rootoffset,NULL);CHKERRQ(ierr);
+  ierr = PetscSFGetLeafInfo_Basic(sf,&nleafranks,&ndleafranks,&leafranks,&leafoffset,NULL,NULL);CHKERRQ(ierr);
+  ierr = PetscMalloc4(nrootranks-ndrootranks,&dat->rootshmranks,nleafranks-ndleafranks,&dat->leafshmranks,nrootranks-ndrootranks,&dat->rootpeeroffset,nleafranks-ndleafranks,&dat->leafpeeroffset);CHKERRQ(ierr);
+  for (i=ndrootranks; i<nrootranks; i++) {
+    ierr = PetscShmCommGlobalToLocal(pshmcomm,rootranks[i],&dat->rootshmranks[i-ndrootranks]);CHKERRQ(ierr);
+    if (dat->rootshmranks[i-ndrootranks] != MPI_PROC_NULL) nrootshm++;
+  }
+  for (i=ndleafranks; i<nleafranks; i++) {
+    ierr = PetscShmCommGlobalToLocal(pshmcomm,leafranks[i],&dat->leafshmranks[i-ndleafranks]);CHKERRQ(ierr);
+    if (dat->leafshmranks[i-ndleafranks] != MPI_PROC_NULL) nleafshm++;
+  }
+  hasshm = (nrootshm || nleafshm) ? 1 : 0;
+  ierr = MPIU_Allreduce(&hasshm,&anyshm,1,MPI_INT,MPI_MAX,dat->shmcomm);CHKERRQ(ierr);
+  dat->active = anyshm ? PETSC_TRUE : PETSC_FALSE;
+
+  /* Tell on-node peers where their edges are in my buffers. Roots referenced by a peer are at a known offset in my rootbuf,
+     and leaves referencing roots of a peer are at a known offset in my leafbuf */
+  ierr = PetscObjectGetNewTag((PetscObject)sf,&tag[0]);CHKERRQ(ierr);
+  ierr = PetscObjectGetNewTag((PetscObject)sf,&tag[1]);CHKERRQ(ierr);
+  ierr = PetscMalloc2(2*(nrootshm+nleafshm),&reqs,nrootshm+nleafshm,&sendoffset);CHKERRQ(ierr);
+  for (i=ndrootranks,j=0; i<nrootranks; i++) {
+    if (dat->rootshmranks[i-ndrootranks] == MPI_PROC_NULL) continue;
+    ierr = MPI_Irecv(&dat->rootpeeroffset[i-ndrootranks],1,MPIU_INT,rootranks[i],tag[1],comm,&reqs[j]);CHKERRQ(ierr);
+    sendoffset[j] = rootoffset[i]-rootoffset[ndrootranks];
+    ierr = MPI_Isend(&sendoffset[j],1,MPIU_INT,rootranks[i],tag[0],comm,&reqs[nrootshm+nleafshm+j]);CHKERRQ(ierr);
+    j++;
+  }
+  for (i=ndleafranks; i<nleafranks; i++) {
+    if (dat->leafshmranks[i-ndleafranks] == MPI_PROC_NULL) continue;
+    ierr = MPI_Irecv(&dat->leafpeeroffset[i-ndleafranks],1,MPIU_INT,leafranks[i],tag[0],comm,&reqs[j]);CHKERRQ(ierr);
+    sendoffset[j] = leafoffset[i]-leafoffset[ndleafranks];
+    ierr = MPI_Isend(&sendoffset[j],1,MPIU_INT,leafranks[i],tag[1],comm,&reqs[nrootshm+nleafshm+j]);CHKERRQ(ierr);
+    j++;
+  }
+  ierr = MPI_Waitall(2*(nrootshm+nleafshm),reqs,MPI_STATUSES_IGNORE);CHKERRQ(ierr);
+  ierr = PetscFree2(reqs,sendoffset);CHKERRQ(ierr);
+
+  /* Only off-node ranks need MPI requests */
+  dat->nrootreqs = nrootranks-ndrootranks-nrootshm;
+  sf->nleafreqs  = nleafranks-ndleafranks-nleafshm;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFReset_Shm(PetscSF sf)
+{
+  PetscErrorCode ierr;
+  PetscSF_Shm    *dat = (PetscSF_Shm*)sf->data;
+
+  PetscFunctionBegin;
+  ierr = PetscSFReset_Basic(sf);CHKERRQ(ierr); /* Common part, which also frees the shared memory windows of the links */
+  ierr = PetscFree4(dat->rootshmranks,dat->leafshmranks,dat->rootpeeroffset,dat->leafpeeroffset);CHKERRQ(ierr);
+  dat->active = PETSC_FALSE;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFDestroy_Shm(PetscSF sf)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = PetscSFReset_Shm(sf);CHKERRQ(ierr);
+  ierr = PetscFree(sf->data);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFBcastAndOpBegin_Shm(PetscSF sf,MPI_Datatype unit,PetscMemType rootmtype,const void *rootdata,PetscMemType leafmtype,void *leafdata,MPI_Op op)
+{
+  PetscErrorCode ierr;
+  PetscSFLink    link = NULL;
+
+  PetscFunctionBegin;
+  ierr = PetscSFShmLinkCreate(sf,unit,rootmtype,rootdata,leafmtype,leafdata,op,PETSCSF_BCAST,&link);CHKERRQ(ierr);
+  ierr = PetscSFLinkPackRootData(sf,link,PETSCSF_REMOTE,rootdata);CHKERRQ(ierr);
+  ierr = PetscSFShmStartMPI(sf,link,PETSCSF_ROOT2LEAF);CHKERRQ(ierr);
+  ierr = PetscSFLinkBcastAndOpLocal(sf,link,rootdata,leafdata,op);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFBcastAndOpEnd_Shm(PetscSF sf,MPI_Datatype unit,const void *rootdata,void *leafdata,MPI_Op op)
+{
+  PetscErrorCode ierr;
+  PetscSFLink    link = NULL;
+
+  PetscFunctionBegin;
+  ierr = PetscSFLinkGetInUse(sf,unit,rootdata,leafdata,PETSC_OWN_POINTER,&link);CHKERRQ(ierr);
+  ierr = PetscSFShmSync(sf,link);CHKERRQ(ierr); /* Root buffers of on-node peers are packed */
+  ierr = PetscSFLinkMPIWaitall(sf,link,PETSCSF_ROOT2LEAF);CHKERRQ(ierr);
+  ierr = PetscSFShmUnpack(sf,link,sf->nranks,sf->ndranks,sf->roffset,sf->rmine,link->shmrootsrc,link->leafbuf[PETSCSF_REMOTE][PETSC_MEMTYPE_HOST],leafdata,op);CHKERRQ(ierr);
+  ierr = PetscSFShmSync(sf,link);CHKERRQ(ierr); /* Peers are done with my root buffer */
+  ierr = PetscSFLinkReclaim(sf,&link);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFLeafToRootBegin_Shm(PetscSF sf,MPI_Datatype unit,PetscMemType leafmtype,const void *leafdata,PetscMemType rootmtype,void *rootdata,MPI_Op op,PetscSFOperation sfop,PetscSFLink *out)
+{
+  PetscErrorCode ierr;
+  PetscSFLink    link = NULL;
+
+  PetscFunctionBegin;
+  ierr = PetscSFShmLinkCreate(sf,unit,rootmtype,rootdata,leafmtype,leafdata,op,sfop,&link);CHKERRQ(ierr);
+  ierr = PetscSFLinkPackLeafData(sf,link,PETSCSF_REMOTE,leafdata);CHKERRQ(ierr);
+  ierr = PetscSFShmStartMPI(sf,link,PETSCSF_LEAF2ROOT);CHKERRQ(ierr);
+  *out = link;
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFReduceBegin_Shm(PetscSF sf,MPI_Datatype unit,PetscMemType leafmtype,const void *leafdata,PetscMemType rootmtype,void *rootdata,MPI_Op op)
+{
+  PetscErrorCode ierr;
+  PetscSFLink    link = NULL;
+
+  PetscFunctionBegin;
+  ierr = PetscSFLeafToRootBegin_Shm(sf,unit,leafmtype,leafdata,rootmtype,rootdata,op,PETSCSF_REDUCE,&link);CHKERRQ(ierr);
+  ierr = PetscSFLinkReduceLocal(sf,link,leafdata,rootdata,op);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFReduceEnd_Shm(PetscSF sf,MPI_Datatype unit,const void *leafdata,void *rootdata,MPI_Op op)
+{
+  PetscErrorCode ierr;
+  PetscSF_Shm    *dat = (PetscSF_Shm*)sf->data;
+  PetscSFLink    link = NULL;
+
+  PetscFunctionBegin;
+  ierr = PetscSFLinkGetInUse(sf,unit,rootdata,leafdata,PETSC_OWN_POINTER,&link);CHKERRQ(ierr);
+  ierr = PetscSFShmSync(sf,link);CHKERRQ(ierr);
+  ierr = PetscSFLinkMPIWaitall(sf,link,PETSCSF_LEAF2ROOT);CHKERRQ(ierr);
+  ierr = PetscSFShmUnpack(sf,link,dat->niranks,dat->ndiranks,dat->ioffset,dat->irootloc,link->shmleafsrc,link->rootbuf[PETSCSF_REMOTE][PETSC_MEMTYPE_HOST],rootdata,op);CHKERRQ(ierr);
+  ierr = PetscSFShmSync(sf,link);CHKERRQ(ierr);
+  ierr = PetscSFLinkReclaim(sf,&link);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFFetchAndOpBegin_Shm(PetscSF sf,MPI_Datatype unit,PetscMemType rootmtype,void *rootdata,PetscMemType leafmtype,const void *leafdata,void *leafupdate,MPI_Op op)
+{
+  PetscErrorCode ierr;
+  PetscSFLink    link = NULL;
+
+  PetscFunctionBegin;
+  ierr = PetscSFLeafToRootBegin_Shm(sf,unit,leafmtype,leafdata,rootmtype,rootdata,op,PETSCSF_FETCH,&link);CHKERRQ(ierr);
+  ierr = PetscSFLinkFetchAndOpLocal(sf,link,rootdata,leafdata,leafupdate,op);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFFetchAndOpEnd_Shm(PetscSF sf,MPI_Datatype unit,void *rootdata,const void *leafdata,void *leafupdate,MPI_Op op)
+{
+  PetscErrorCode ierr;
+  PetscSF_Shm    *dat = (PetscSF_Shm*)sf->data;
+  PetscSFLink    link = NULL;
+  PetscInt       i;
+  char           *rootbuf;
+
+  PetscFunctionBegin;
+  ierr = PetscSFLinkGetInUse(sf,unit,rootdata,leafdata,PETSC_OWN_POINTER,&link);CHKERRQ(ierr);
+  ierr = PetscSFShmSync(sf,link);CHKERRQ(ierr);
+  ierr = PetscSFLinkMPIWaitall(sf,link,PETSCSF_LEAF2ROOT);CHKERRQ(ierr);
+  /* Fetch-and-op leaves the old root values in rootbuf, so leaf data of on-node peers is copied in rootbuf as well */
+  rootbuf = link->rootbuf[PETSCSF_REMOTE][PETSC_MEMTYPE_HOST];
+  for (i=dat->ndiranks; i<dat->niranks; i++) {
+    if (!link->shmleafsrc || !link->shmleafsrc[i-dat->ndiranks]) continue;
+    ierr = PetscArraycpy(rootbuf+(dat->ioffset[i]-dat->ioffset[dat->ndiranks])*link->unitbytes,link->shmleafsrc[i-dat->ndiranks],(dat->ioffset[i+1]-dat->ioffset[i])*link->unitbytes);CHKERRQ(ierr);
+  }
+  ierr = PetscSFLinkFetchRootData(sf,link,PETSCSF_REMOTE,rootdata,op);CHKERRQ(ierr);
+  /* Bcast rootbuf to leafupdate */
+  ierr = PetscSFShmStartMPI(sf,link,PETSCSF_ROOT2LEAF);CHKERRQ(ierr);
+  ierr = PetscSFShmSync(sf,link);CHKERRQ(ierr);
+  ierr = PetscSFLinkMPIWaitall(sf,link,PETSCSF_ROOT2LEAF);CHKERRQ(ierr);
+  ierr = PetscSFShmUnpack(sf,link,sf->nranks,sf->ndranks,sf->roffset,sf->rmine,link->shmrootsrc,link->leafbuf[PETSCSF_REMOTE][PETSC_MEMTYPE_HOST],leafupdate,MPIU_REPLACE);CHKERRQ(ierr);
+  ierr = PetscSFShmSync(sf,link);CHKERRQ(ierr);
+  ierr = PetscSFLinkReclaim(sf,&link);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode PetscSFView_Shm(PetscSF sf,PetscViewer viewer)
+{
+  PetscErrorCode ierr;
+  PetscSF_Shm    *dat = (PetscSF_Shm*)sf->data;
+  PetscBool      iascii;
+  PetscMPIInt    rank;
+
+  PetscFunctionBegin;
+  ierr = PetscSFView_Basic(sf,viewer);CHKERRQ(ierr);
+  ierr = PetscObjectTypeCompare((PetscObject)viewer,PETSCVIEWERASCII,&iascii);CHKERRQ(ierr);
+  if (iascii && sf->setupcalled) {
+    ierr = MPI_Comm_rank(PetscObjectComm((PetscObject)sf),&rank);CHKERRQ(ierr);
+    ierr = PetscViewerASCIIPushSynchronized(viewer);CHKERRQ(ierr);
+    ierr = PetscViewerASCIISynchronizedPrintf(viewer,"  [%d] Off-node ranks: referencing my roots %d, owning roots of my leaves %d\n",rank,(int)dat->nrootreqs,(int)sf->nleafreqs);CHKERRQ(ierr);
+    ierr = PetscViewerFlush(viewer);CHKERRQ(ierr);
+    ierr = PetscViewerASCIIPopSynchronized(viewer);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
+/*MC
+   PETSCSFSHM - PetscSF type that communicates with ranks on the same node through MPI-3 shared memory
+
+   Level: intermediate
+
+   Notes:
+   The graph setup and the packing of data are the same as in PETSCSFBASIC. The root and leaf buffers for remote
+   communication are allocated in shared memory windows so that ranks on the same node unpack directly from the packed
+   buffers of each other, without handing data to MPI. Only edges to ranks on other nodes use MPI messages.
+
+   Since buffers are read by other ranks, all ranks of the node synchronize at the end of each communication.
+   This type only supports data in host memory.
+
+   Options Database Keys:
+.  -noshared - treat all ranks as if they were on different nodes, useful for debugging
+
+.seealso: PetscSFCreate(), PetscSFSetType(), PETSCSFBASIC, PETSCSFNEIGHBOR, PetscShmCommGet()
+M*/
+
+PETSC_INTERN PetscErrorCode PetscSFCreate_Shm(PetscSF sf)
+{
+  PetscErrorCode ierr;
+  PetscSF_Shm    *dat;
+
+  PetscFunctionBegin;
+  sf->ops->CreateEmbeddedSF     = PetscSFCreateEmbeddedSF_Basic;
+  sf->ops->GetLeafRanks         = PetscSFGetLeafRanks_Basic;
+  sf->ops->View                 = PetscSFView_Shm;
+
+  sf->ops->SetUp                = PetscSFSetUp_Shm;
+  sf->ops->Reset                = PetscSFReset_Shm;
+  sf->ops->Destroy              = PetscSFDestroy_Shm;
+  sf->ops->BcastAndOpBegin      = PetscSFBcastAndOpBegin_Shm;
+  sf->ops->BcastAndOpEnd        = PetscSFBcastAndOpEnd_Shm;
+  sf->ops->ReduceBegin          = PetscSFReduceBegin_Shm;
+  sf->ops->ReduceEnd            = PetscSFReduceEnd_Shm;
+  sf->ops->FetchAndOpBegin      = PetscSFFetchAndOpBegin_Shm;
+  sf->ops->FetchAndOpEnd        = PetscSFFetchAndOpEnd_Shm;
+
+  ierr = PetscNewLog(sf,&dat);CHKERRQ(ierr);
+  sf->data = (void*)dat;
+  PetscFunctionReturn(0);
+}
+#endif
@@ -27,7 +27,8 @@ const char *const PetscSFDuplicateOptions[] = {"CONFONLY","RANKS","GRAPH","Petsc
    Options Database Keys:
 +  -sf_type basic     -Use MPI persistent Isend/Irecv for communication (Default)
 .  -sf_type window    -Use MPI-3 one-sided window for communication
--  -sf_type neighbor  -Use MPI-3 neighborhood collectives for communication
+.  -sf_type neighbor  -Use MPI-3 neighborhood collectives for communication
+-  -sf_type shm       -Use MPI-3 shared memory for ranks on the same node and MPI Isend/Irecv for the others
 
    Level: intermediate
 
@@ -270,8 +271,10 @@ PetscErrorCode PetscSFSetUp(PetscSF sf)
 .  -sf_use_default_stream - Assume callers of SF computed the input root/leafdata with the default cuda stream. SF will also
                             use the default stream to process data. Therefore, no stream synchronization is needed between SF and its caller (default: true).
                             If true, this option only works with -use_cuda_aware_mpi 1.
--  -sf_use_stream_aware_mpi  - Assume the underlying MPI is cuda-stream aware and SF won't sync streams for send/recv buffers passed to MPI (default: false).
+.  -sf_use_stream_aware_mpi  - Assume the underlying MPI is cuda-stream aware and SF won't sync streams for send/recv buffers passed to MPI (default: false).
                                If true, this option only works with -use_cuda_aware_mpi 1.
+-  -sf_neighbor_persistent - With -sf_type neighbor, use persistent neighborhood collectives (MPI-4 or the MPIX extension of OpenMPI), which are
+                             created once per communication pattern and data type and then only started (default: false).
 
    Level: intermediate
 @*/
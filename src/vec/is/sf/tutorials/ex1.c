@@ -599,4 +599,23 @@ int main(int argc,char **argv)
       nsize: 4
       args: -sf_type basic -test_all -test_bcastop 0 -test_fetchandop 0
 
+   test:
+      suffix: 10_neighbor_persistent
+      nsize: 4
+      args: -sf_type neighbor -sf_neighbor_persistent -test_all -test_bcastop 0 -test_fetchandop 0
+      output_file: output/ex1_10_neighbor.out
+      requires: define(PETSC_HAVE_MPI_PERSISTENT_NEIGHBORHOOD_COLLECTIVES)
+
+   test:
+      suffix: 10_shm
+      nsize: 4
+      args: -sf_type shm -test_all -test_bcastop 0 -test_fetchandop 0
+      requires: define(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+
+   test:
+      suffix: 10_shm_noshared
+      nsize: 4
+      args: -sf_type shm -noshared -test_all -test_bcastop 0 -test_fetchandop 0
+      requires: define(PETSC_HAVE_MPI_PROCESS_SHARED_MEMORY)
+
 TEST*/
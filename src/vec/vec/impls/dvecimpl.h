@@ -22,6 +22,9 @@ PETSC_INTERN PetscErrorCode VecSet_Seq(Vec,PetscScalar);
 PETSC_INTERN PetscErrorCode VecMAXPY_Seq(Vec,PetscInt,const PetscScalar*,Vec*);
 PETSC_INTERN PetscErrorCode VecAYPX_Seq(Vec,PetscScalar,Vec);
 PETSC_INTERN PetscErrorCode VecWAXPY_Seq(Vec,PetscScalar,Vec,Vec);
+PETSC_INTERN PetscErrorCode VecAXPYDot_Seq(Vec,PetscScalar,Vec,Vec,PetscScalar*);
+PETSC_INTERN PetscErrorCode VecWAXPYNorm_Seq(Vec,PetscScalar,Vec,Vec,PetscReal*);
+PETSC_INTERN PetscErrorCode VecMAXPYMDot_Seq(Vec,PetscInt,const PetscScalar*,Vec*,PetscScalar*,PetscReal*);
 PETSC_INTERN PetscErrorCode VecAXPBYPCZ_Seq(Vec,PetscScalar,PetscScalar,PetscScalar,Vec,Vec);
 PETSC_INTERN PetscErrorCode VecMaxPointwiseDivide_Seq(Vec,Vec,PetscReal*);
 PETSC_INTERN PetscErrorCode VecPlaceArray_Seq(Vec,const PetscScalar*);
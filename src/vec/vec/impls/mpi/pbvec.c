@@ -481,7 +481,17 @@ static struct _VecOps DvOps = { VecDuplicate_MPI, /* 1 */
                                 VecStrideSubSetGather_Default,
                                 VecStrideSubSetScatter_Default,
                                 0,
-                                0
+                                0,
+                                0,
+                                0,
+                                0,
+                                0,
+                                0,
+                                0,
+                                0,
+                                VecAXPYDot_MPI,
+                                VecWAXPYNorm_MPI,
+                                VecMAXPYMDot_MPI
 };
 
 /*
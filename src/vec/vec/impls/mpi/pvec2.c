@@ -39,6 +39,58 @@ PetscErrorCode VecMTDot_MPI(Vec xin,PetscInt nv,const Vec y[],PetscScalar *z)
   PetscFunctionReturn(0);
 }
 
+PetscErrorCode VecAXPYDot_MPI(Vec yin,PetscScalar alpha,Vec xin,Vec zin,PetscScalar *z)
+{
+  PetscScalar    work;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecAXPYDot_Seq(yin,alpha,xin,zin,&work);CHKERRQ(ierr);
+  ierr = MPIU_Allreduce(&work,z,1,MPIU_SCALAR,MPIU_SUM,PetscObjectComm((PetscObject)yin));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+PetscErrorCode VecWAXPYNorm_MPI(Vec win,PetscScalar alpha,Vec xin,Vec yin,PetscReal *z)
+{
+  PetscReal      sum,work;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecWAXPYNorm_Seq(win,alpha,xin,yin,&work);CHKERRQ(ierr);
+  work = work*work;
+  ierr = MPIU_Allreduce(&work,&sum,1,MPIU_REAL,MPIU_SUM,PetscObjectComm((PetscObject)win));CHKERRQ(ierr);
+  *z   = PetscSqrtReal(sum);
+  PetscFunctionReturn(0);
+}
+
+/* the inner products and the square of the norm are summed in a single reduction */
+PetscErrorCode VecMAXPYMDot_MPI(Vec yin,PetscInt nv,const PetscScalar *alpha,Vec *x,PetscScalar *z,PetscReal *nrm)
+{
+  PetscScalar    awork[2*129],*work = awork,*sum;
+  PetscReal      lnrm;
+  PetscInt       nr = (z ? nv : 0) + (nrm ? 1 : 0);
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (!nr) {
+    ierr = VecMAXPY_Seq(yin,nv,alpha,x);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  if (nr > 129) {
+    ierr = PetscMalloc1(2*nr,&work);CHKERRQ(ierr);
+  }
+  sum  = work + nr;
+  ierr = VecMAXPYMDot_Seq(yin,nv,alpha,x,z ? work : NULL,nrm ? &lnrm : NULL);CHKERRQ(ierr);
+  if (nrm) work[nr-1] = lnrm*lnrm;
+  ierr = MPIU_Allreduce(work,sum,nr,MPIU_SCALAR,MPIU_SUM,PetscObjectComm((PetscObject)yin));CHKERRQ(ierr);
+  if (z) {ierr = PetscArraycpy(z,sum,nv);CHKERRQ(ierr);}
+  if (nrm) *nrm = PetscSqrtReal(PetscRealPart(sum[nr-1]));
+  if (nr > 129) {
+    ierr = PetscFree(work);CHKERRQ(ierr);
+  }
+  PetscFunctionReturn(0);
+}
+
 #include <../src/vec/vec/impls/seq/ftn-kernels/fnorm.h>
 PetscErrorCode VecNorm_MPI(Vec xin,NormType type,PetscReal *z)
 {
@@ -820,7 +820,17 @@ static struct _VecOps DvOps = {VecDuplicate_Seq, /* 1 */
                                VecStrideSubSetGather_Default,
                                VecStrideSubSetScatter_Default,
                                0,
-                               0
+                               0,
+                               0,
+                               0,
+                               0,
+                               0,
+                               0,
+                               0,
+                               0,
+                               VecAXPYDot_Seq,
+                               VecWAXPYNorm_Seq,
+                               VecMAXPYMDot_Seq
 };
 
 
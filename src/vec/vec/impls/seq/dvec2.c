@@ -6,7 +6,151 @@
 #include <../src/vec/vec/impls/dvecimpl.h>
 #include <petsc/private/kernels/petscaxpy.h>
 
+/*
+   Tiled kernels of VecMDot_Seq(), VecMAXPY_Seq() and VecMAXPYMDot_Seq() for many vectors, such as long Krylov bases.
+
+   The entries are traversed in strips of VEC_MULTI_STRIP: a strip of x stays in cache while the inner products with,
+   or the updates by, all the y[j] are accumulated, so x is read (and written) once instead of once per group of four
+   y[j]. The y[j] are taken in the groups and the entries in the order of the untiled kernels, so with one thread the
+   results are identical to theirs.
+
+   With -vec_multi_threads <n> the entries are split into n contiguous chunks of at least a strip, processed by OpenMP
+   threads. The partial inner products of the chunks are added in order, so the results only depend on the number of
+   threads.
+*/
+PetscInt VecMultiThreads = 1;
+
+#define VEC_MULTI_STRIP 512
+
+/* first entry of chunk t of the nt chunks of n entries, aligned to 8 entries */
+#define VecMultiChunk(n,nt,t) ((t) == (nt) ? (n) : ((n)/(nt)*(t)) & ~(PetscInt)0x7)
+
+PETSC_STATIC_INLINE PetscInt VecMultiGetThreads_Private(PetscInt n)
+{
+  return PetscMax(1,PetscMin(VecMultiThreads,n/VEC_MULTI_STRIP));
+}
+
+/* z[j] = sum_{lo<=i<hi} x[i] conj(y[j][i]) */
+static void VecMDotTiled_Private(PetscInt lo,PetscInt hi,const PetscScalar *x,PetscInt nv,const PetscScalar *const *y,PetscScalar *z)
+{
+  PetscInt          i,j,k,m,r = (hi-lo)&0x3;
+  PetscScalar       s0,s1,s2,s3,x0,x1,x2,x3;
+  const PetscScalar *y0,*y1,*y2,*y3,*xs;
+
+  for (j=0; j<nv; j++) {
+    s0 = 0.0;
+    for (k=lo+r-1; k>=lo; k--) s0 += x[k]*PetscConj(y[j][k]);
+    z[j] = s0;
+  }
+  for (i=lo+r; i<hi; i+=VEC_MULTI_STRIP) {
+    m  = PetscMin(VEC_MULTI_STRIP,hi-i);
+    xs = x + i;
+    for (j=0; j<nv-3; j+=4) {
+      y0 = y[j] + i; y1 = y[j+1] + i; y2 = y[j+2] + i; y3 = y[j+3] + i;
+      s0 = z[j];     s1 = z[j+1];     s2 = z[j+2];     s3 = z[j+3];
+      for (k=0; k<m; k+=4) {
+        x0 = xs[k]; x1 = xs[k+1]; x2 = xs[k+2]; x3 = xs[k+3];
+        s0 += x0*PetscConj(y0[k]) + x1*PetscConj(y0[k+1]) + x2*PetscConj(y0[k+2]) + x3*PetscConj(y0[k+3]);
+        s1 += x0*PetscConj(y1[k]) + x1*PetscConj(y1[k+1]) + x2*PetscConj(y1[k+2]) + x3*PetscConj(y1[k+3]);
+        s2 += x0*PetscConj(y2[k]) + x1*PetscConj(y2[k+1]) + x2*PetscConj(y2[k+2]) + x3*PetscConj(y2[k+3]);
+        s3 += x0*PetscConj(y3[k]) + x1*PetscConj(y3[k+1]) + x2*PetscConj(y3[k+2]) + x3*PetscConj(y3[k+3]);
+      }
+      z[j] = s0; z[j+1] = s1; z[j+2] = s2; z[j+3] = s3;
+    }
+    for (; j<nv; j++) {
+      y0 = y[j] + i;
+      s0 = z[j];
+      for (k=0; k<m; k+=4) s0 += xs[k]*PetscConj(y0[k]) + xs[k+1]*PetscConj(y0[k+1]) + xs[k+2]*PetscConj(y0[k+2]) + xs[k+3]*PetscConj(y0[k+3]);
+      z[j] = s0;
+    }
+  }
+}
+
+static PetscErrorCode VecMDot_Seq_Multi(Vec xin,PetscInt nv,const Vec yin[],PetscScalar *z)
+{
+  PetscErrorCode    ierr;
+  PetscInt          n = xin->map->n,nt = VecMultiGetThreads_Private(n),j,t;
+  const PetscScalar *x,**yy;
+  PetscScalar       *work;
 
+  PetscFunctionBegin;
+  ierr = PetscMalloc2(nv,&yy,nt > 1 ? nt*nv : 0,&work);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(xin,&x);CHKERRQ(ierr);
+  for (j=0; j<nv; j++) {ierr = VecGetArrayRead(yin[j],&yy[j]);CHKERRQ(ierr);}
+  if (nt == 1) VecMDotTiled_Private(0,n,x,nv,yy,z);
+  else {
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel for num_threads(nt) schedule(static,1)
+#endif
+    for (t=0; t<nt; t++) VecMDotTiled_Private(VecMultiChunk(n,nt,t),VecMultiChunk(n,nt,t+1),x,nv,yy,work+t*nv);
+    for (j=0; j<nv; j++) {
+      z[j] = work[j];
+      for (t=1; t<nt; t++) z[j] += work[t*nv+j];
+    }
+  }
+  for (j=0; j<nv; j++) {ierr = VecRestoreArrayRead(yin[j],&yy[j]);CHKERRQ(ierr);}
+  ierr = VecRestoreArrayRead(xin,&x);CHKERRQ(ierr);
+  ierr = PetscFree2(yy,work);CHKERRQ(ierr);
+  ierr = PetscLogFlops(PetscMax(nv*(2.0*n-1),0.0));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* x[i] += sum_j alpha[j] y[j][i] for lo <= i < hi */
+static void VecMAXPYTiled_Private(PetscInt lo,PetscInt hi,PetscScalar *x,PetscInt nv,const PetscScalar *alpha,const PetscScalar *const *y)
+{
+  PetscInt          i,j,k,m,r = nv&0x3;
+  PetscScalar       a0,a1,a2,a3,*xs;
+  const PetscScalar *y0,*y1,*y2,*y3;
+
+  for (i=lo; i<hi; i+=VEC_MULTI_STRIP) {
+    m  = PetscMin(VEC_MULTI_STRIP,hi-i);
+    xs = x + i;
+    switch (r) {
+    case 3:
+      a0 = alpha[0]; a1 = alpha[1]; a2 = alpha[2];
+      y0 = y[0] + i; y1 = y[1] + i; y2 = y[2] + i;
+      for (k=0; k<m; k++) xs[k] += a0*y0[k] + a1*y1[k] + a2*y2[k];
+      break;
+    case 2:
+      a0 = alpha[0]; a1 = alpha[1];
+      y0 = y[0] + i; y1 = y[1] + i;
+      for (k=0; k<m; k++) xs[k] += a0*y0[k] + a1*y1[k];
+      break;
+    case 1:
+      a0 = alpha[0];
+      y0 = y[0] + i;
+      for (k=0; k<m; k++) xs[k] += a0*y0[k];
+      break;
+    }
+    for (j=r; j<nv; j+=4) {
+      a0 = alpha[j]; a1 = alpha[j+1]; a2 = alpha[j+2]; a3 = alpha[j+3];
+      y0 = y[j] + i; y1 = y[j+1] + i; y2 = y[j+2] + i; y3 = y[j+3] + i;
+      for (k=0; k<m; k++) xs[k] += a0*y0[k] + a1*y1[k] + a2*y2[k] + a3*y3[k];
+    }
+  }
+}
+
+static PetscErrorCode VecMAXPY_Seq_Multi(Vec xin,PetscInt nv,const PetscScalar *alpha,Vec *y)
+{
+  PetscErrorCode    ierr;
+  PetscInt          n = xin->map->n,nt = VecMultiGetThreads_Private(n),j,t;
+  const PetscScalar **yy;
+  PetscScalar       *xx;
+
+  PetscFunctionBegin;
+  ierr = PetscMalloc1(nv,&yy);CHKERRQ(ierr);
+  ierr = VecGetArray(xin,&xx);CHKERRQ(ierr);
+  for (j=0; j<nv; j++) {ierr = VecGetArrayRead(y[j],&yy[j]);CHKERRQ(ierr);}
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel for num_threads(nt) schedule(static,1) if(nt > 1)
+#endif
+  for (t=0; t<nt; t++) VecMAXPYTiled_Private(VecMultiChunk(n,nt,t),VecMultiChunk(n,nt,t+1),xx,nv,alpha,yy);
+  for (j=0; j<nv; j++) {ierr = VecRestoreArrayRead(y[j],&yy[j]);CHKERRQ(ierr);}
+  ierr = VecRestoreArray(xin,&xx);CHKERRQ(ierr);
+  ierr = PetscFree(yy);CHKERRQ(ierr);
+  ierr = PetscLogFlops(nv*2.0*n);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
 
 #if defined(PETSC_USE_FORTRAN_KERNEL_MDOT)
 #include <../src/vec/vec/impls/seq/ftn-kernels/fmdot.h>
@@ -100,6 +244,10 @@ PetscErrorCode VecMDot_Seq(Vec xin,PetscInt nv,const Vec yin[],PetscScalar *z)
   Vec               *yy;
 
   PetscFunctionBegin;
+  if (VecMultiGetThreads_Private(n) > 1 || (nv > 4 && n > VEC_MULTI_STRIP)) {
+    ierr = VecMDot_Seq_Multi(xin,nv,yin,z);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
   sum0 = 0.;
   sum1 = 0.;
   sum2 = 0.;
@@ -565,6 +713,10 @@ PetscErrorCode VecMAXPY_Seq(Vec xin, PetscInt nv,const PetscScalar *alpha,Vec *y
 #endif
 
   PetscFunctionBegin;
+  if (VecMultiGetThreads_Private(n) > 1 || (nv > 4 && n > VEC_MULTI_STRIP)) {
+    ierr = VecMAXPY_Seq_Multi(xin,nv,alpha,y);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
   ierr = PetscLogFlops(nv*2.0*n);CHKERRQ(ierr);
   ierr = VecGetArray(xin,&xx);CHKERRQ(ierr);
   switch (j_rem=nv&0x3) {
@@ -711,6 +863,141 @@ PetscErrorCode VecWAXPY_Seq(Vec win, PetscScalar alpha,Vec xin,Vec yin)
   PetscFunctionReturn(0);
 }
 
+/*
+   The fused operations below do in one pass over the vectors what would otherwise take two or three; the inner
+   product or norm is accumulated on the entries just updated, while they are still in registers or cache.
+*/
+PetscErrorCode VecAXPYDot_Seq(Vec yin,PetscScalar alpha,Vec xin,Vec zin,PetscScalar *z)
+{
+  PetscErrorCode    ierr;
+  PetscInt          i,n = yin->map->n;
+  PetscScalar       *yy,sum = 0.0;
+  const PetscScalar *xx,*zz;
+
+  PetscFunctionBegin;
+  ierr = VecGetArray(yin,&yy);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(xin,&xx);CHKERRQ(ierr);
+  if (zin == yin) zz = yy;
+  else if (zin == xin) zz = xx;
+  else {ierr = VecGetArrayRead(zin,&zz);CHKERRQ(ierr);}
+  for (i=0; i<n; i++) {
+    yy[i] += alpha*xx[i];
+    sum   += yy[i]*PetscConj(zz[i]);
+  }
+  *z   = sum;
+  if (zin != yin && zin != xin) {ierr = VecRestoreArrayRead(zin,&zz);CHKERRQ(ierr);}
+  ierr = VecRestoreArrayRead(xin,&xx);CHKERRQ(ierr);
+  ierr = VecRestoreArray(yin,&yy);CHKERRQ(ierr);
+  ierr = PetscLogFlops(4.0*n);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/* w may be the same vector as y, which gives a VecAXPY() followed by VecNorm() */
+PetscErrorCode VecWAXPYNorm_Seq(Vec win,PetscScalar alpha,Vec xin,Vec yin,PetscReal *z)
+{
+  PetscErrorCode    ierr;
+  PetscInt          i,n = win->map->n;
+  PetscScalar       *ww;
+  PetscReal         sum = 0.0;
+  const PetscScalar *xx,*yy;
+
+  PetscFunctionBegin;
+  ierr = VecGetArray(win,&ww);CHKERRQ(ierr);
+  ierr = VecGetArrayRead(xin,&xx);CHKERRQ(ierr);
+  if (yin == win) yy = ww;
+  else {ierr = VecGetArrayRead(yin,&yy);CHKERRQ(ierr);}
+  for (i=0; i<n; i++) {
+    ww[i] = yy[i] + alpha*xx[i];
+    sum  += PetscRealPart(ww[i]*PetscConj(ww[i]));
+  }
+  *z   = PetscSqrtReal(sum);
+  if (yin != win) {ierr = VecRestoreArrayRead(yin,&yy);CHKERRQ(ierr);}
+  ierr = VecRestoreArrayRead(xin,&xx);CHKERRQ(ierr);
+  ierr = VecRestoreArray(win,&ww);CHKERRQ(ierr);
+  ierr = PetscLogFlops(4.0*n);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*
+   y is updated by strips of VEC_MAXPYMDOT_STRIP entries: all the x[j] are added to a strip, then the inner products
+   with the x[j] and the norm of the strip are accumulated, so the x[j] are read from memory only once. val and nrm
+   may be NULL. The entries lo <= i < hi are done, val and nrm get the contributions of these entries.
+*/
+#define VEC_MAXPYMDOT_STRIP 256
+static void VecMAXPYMDotTiled_Private(PetscInt lo,PetscInt hi,PetscScalar *yy,PetscInt nv,const PetscScalar *alpha,const PetscScalar *const *xx,PetscScalar *val,PetscReal *nrm)
+{
+  PetscInt          i,j,k,m;
+  PetscScalar       *ys;
+  const PetscScalar *xs;
+  PetscReal         sum = 0.0;
+
+  if (val) for (j=0; j<nv; j++) val[j] = 0.0;
+  for (i=lo; i<hi; i+=VEC_MAXPYMDOT_STRIP) {
+    m  = PetscMin(VEC_MAXPYMDOT_STRIP,hi-i);
+    ys = yy + i;
+    for (j=0; j<nv; j++) {
+      const PetscScalar a = alpha[j];
+
+      xs = xx[j] + i;
+      for (k=0; k<m; k++) ys[k] += a*xs[k];
+    }
+    if (val) {
+      for (j=0; j<nv; j++) {
+        PetscScalar dot = 0.0;
+
+        xs = xx[j] + i;
+        for (k=0; k<m; k++) dot += ys[k]*PetscConj(xs[k]);
+        val[j] += dot;
+      }
+    }
+    if (nrm) {
+      for (k=0; k<m; k++) sum += PetscRealPart(ys[k]*PetscConj(ys[k]));
+    }
+  }
+  if (nrm) *nrm = sum;
+}
+
+PetscErrorCode VecMAXPYMDot_Seq(Vec yin,PetscInt nv,const PetscScalar *alpha,Vec *x,PetscScalar *val,PetscReal *nrm)
+{
+  PetscErrorCode    ierr;
+  PetscInt          j,t,n = yin->map->n,nt = VecMultiGetThreads_Private(n);
+  PetscScalar       *yy,*work;
+  const PetscScalar **xx;
+  PetscReal         sum,*nwork;
+
+  PetscFunctionBegin;
+  if (!val && !nrm) {
+    ierr = VecMAXPY_Seq(yin,nv,alpha,x);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = PetscMalloc3(nv,&xx,nt > 1 && val ? nt*nv : 0,&work,nt,&nwork);CHKERRQ(ierr);
+  ierr = VecGetArray(yin,&yy);CHKERRQ(ierr);
+  for (j=0; j<nv; j++) {ierr = VecGetArrayRead(x[j],&xx[j]);CHKERRQ(ierr);}
+  if (nt == 1) VecMAXPYMDotTiled_Private(0,n,yy,nv,alpha,xx,val,nrm ? &nwork[0] : NULL);
+  else {
+#if defined(PETSC_HAVE_OPENMP)
+#pragma omp parallel for num_threads(nt) schedule(static,1)
+#endif
+    for (t=0; t<nt; t++) VecMAXPYMDotTiled_Private(VecMultiChunk(n,nt,t),VecMultiChunk(n,nt,t+1),yy,nv,alpha,xx,val ? work+t*nv : NULL,nrm ? &nwork[t] : NULL);
+    if (val) {
+      for (j=0; j<nv; j++) {
+        val[j] = work[j];
+        for (t=1; t<nt; t++) val[j] += work[t*nv+j];
+      }
+    }
+  }
+  if (nrm) {
+    sum = nwork[0];
+    for (t=1; t<nt; t++) sum += nwork[t];
+    *nrm = PetscSqrtReal(sum);
+  }
+  for (j=0; j<nv; j++) {ierr = VecRestoreArrayRead(x[j],&xx[j]);CHKERRQ(ierr);}
+  ierr = VecRestoreArray(yin,&yy);CHKERRQ(ierr);
+  ierr = PetscFree3(xx,work,nwork);CHKERRQ(ierr);
+  ierr = PetscLogFlops(2.0*nv*n + (val ? 2.0*nv*n : 0.0) + (nrm ? 2.0*n : 0.0));CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 PetscErrorCode VecMaxPointwiseDivide_Seq(Vec xin,Vec yin,PetscReal *max)
 {
   PetscErrorCode    ierr;
@@ -1114,6 +1114,9 @@ static PetscErrorCode VecBindToCPU_SeqAIJViennaCL(Vec V,PetscBool flg)
     V->ops->aypx            = VecAYPX_Seq;
     V->ops->waxpy           = VecWAXPY_Seq;
     V->ops->dotnorm2        = NULL;
+    V->ops->axpydot         = VecAXPYDot_Seq;
+    V->ops->waxpynorm       = VecWAXPYNorm_Seq;
+    V->ops->maxpymdot       = VecMAXPYMDot_Seq;
     V->ops->placearray      = VecPlaceArray_Seq;
     V->ops->replacearray    = VecReplaceArray_Seq;
     V->ops->resetarray      = VecResetArray_Seq;
@@ -1143,6 +1146,9 @@ static PetscErrorCode VecBindToCPU_SeqAIJViennaCL(Vec V,PetscBool flg)
     V->ops->aypx            = VecAYPX_SeqViennaCL;
     V->ops->waxpy           = VecWAXPY_SeqViennaCL;
     V->ops->dotnorm2        = VecDotNorm2_SeqViennaCL;
+    V->ops->axpydot         = NULL;
+    V->ops->waxpynorm       = NULL;
+    V->ops->maxpymdot       = NULL;
     V->ops->placearray      = VecPlaceArray_SeqViennaCL;
     V->ops->replacearray    = VecReplaceArray_SeqViennaCL;
     V->ops->resetarray      = VecResetArray_SeqViennaCL;
@@ -183,6 +183,9 @@ PetscErrorCode  VecInitializePackage(void)
   ierr = PetscLogEventRegister("VecAXPBYCZ",       VEC_CLASSID,&VEC_AXPBYPCZ);CHKERRQ(ierr);
   ierr = PetscLogEventRegister("VecWAXPY",         VEC_CLASSID,&VEC_WAXPY);CHKERRQ(ierr);
   ierr = PetscLogEventRegister("VecMAXPY",         VEC_CLASSID,&VEC_MAXPY);CHKERRQ(ierr);
+  ierr = PetscLogEventRegister("VecAXPYDot",       VEC_CLASSID,&VEC_AXPYDot);CHKERRQ(ierr);
+  ierr = PetscLogEventRegister("VecWAXPYNorm",     VEC_CLASSID,&VEC_WAXPYNorm);CHKERRQ(ierr);
+  ierr = PetscLogEventRegister("VecMAXPYMDot",     VEC_CLASSID,&VEC_MAXPYMDot);CHKERRQ(ierr);
   ierr = PetscLogEventRegister("VecSwap",          VEC_CLASSID,&VEC_Swap);CHKERRQ(ierr);
   ierr = PetscLogEventRegister("VecOps",           VEC_CLASSID,&VEC_Ops);CHKERRQ(ierr);
   ierr = PetscLogEventRegister("VecAssemblyBegin", VEC_CLASSID,&VEC_AssemblyBegin);CHKERRQ(ierr);
@@ -237,6 +240,15 @@ PetscErrorCode  VecInitializePackage(void)
     if (pkg) {ierr = PetscLogEventExcludeClass(VEC_CLASSID);CHKERRQ(ierr);}
     if (pkg) {ierr = PetscLogEventExcludeClass(VEC_SCATTER_CLASSID);CHKERRQ(ierr);}
   }
+  /* Threads of the local parts of VecMDot(), VecMAXPY() and VecMAXPYMDot() */
+  ierr = PetscOptionsGetInt(NULL,NULL,"-vec_multi_threads",&VecMultiThreads,NULL);CHKERRQ(ierr);
+  if (VecMultiThreads < 1) VecMultiThreads = 1;
+#if !defined(PETSC_HAVE_OPENMP)
+  if (VecMultiThreads > 1) {
+    ierr            = PetscInfo1(NULL,"PETSc was not configured with OpenMP, the multiple vector operations use 1 thread instead of %D\n",VecMultiThreads);CHKERRQ(ierr);
+    VecMultiThreads = 1;
+  }
+#endif
 
   /*
     Create the special MPI reduction operation that may be used by VecNorm/DotBegin()
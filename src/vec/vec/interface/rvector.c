@@ -1217,6 +1217,188 @@ PetscErrorCode  VecMAXPY(Vec y,PetscInt nv,const PetscScalar alpha[],Vec x[])
   PetscFunctionReturn(0);
 }
 
+/*@
+   VecAXPYDot - Computes y = y + alpha x and the inner product of the updated y with z, in a single pass over the vectors
+
+   Collective on Vec
+
+   Input Parameters:
++  y - the vector to update
+.  alpha - the scalar
+.  x - the vector added to y
+-  z - the vector of the inner product, it may be x or y
+
+   Output Parameters:
++  y - the updated vector
+-  val - the inner product of the updated y with z, as VecDot(y,z,val) would compute it
+
+   Level: intermediate
+
+   Notes:
+    x and y MUST be different vectors
+
+    This is the same as VecAXPY() followed by VecDot(), but the entries of y are read and written once and, in parallel,
+    there is a single reduction. Vector types that do not provide the fused operation call VecAXPY() and VecDot().
+
+.seealso:  VecAXPY(), VecDot(), VecWAXPYNorm(), VecMAXPYMDot()
+@*/
+PetscErrorCode  VecAXPYDot(Vec y,PetscScalar alpha,Vec x,Vec z,PetscScalar *val)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(y,VEC_CLASSID,1);
+  PetscValidHeaderSpecific(x,VEC_CLASSID,3);
+  PetscValidHeaderSpecific(z,VEC_CLASSID,4);
+  PetscValidScalarPointer(val,5);
+  PetscValidType(y,1);
+  PetscValidType(x,3);
+  PetscValidType(z,4);
+  PetscCheckSameTypeAndComm(x,3,y,1);
+  PetscCheckSameTypeAndComm(y,1,z,4);
+  VecCheckSameSize(x,3,y,1);
+  VecCheckSameSize(y,1,z,4);
+  if (x == y) SETERRQ(PetscObjectComm((PetscObject)x),PETSC_ERR_ARG_IDN,"x and y cannot be the same vector");
+  PetscValidLogicalCollectiveScalar(y,alpha,2);
+  if (!y->ops->axpydot) {
+    ierr = VecAXPY(y,alpha,x);CHKERRQ(ierr);
+    ierr = VecDot(y,z,val);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = VecSetErrorIfLocked(y,1);CHKERRQ(ierr);
+
+  ierr = PetscLogEventBegin(VEC_AXPYDot,x,y,z,0);CHKERRQ(ierr);
+  ierr = (*y->ops->axpydot)(y,alpha,x,z,val);CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(VEC_AXPYDot,x,y,z,0);CHKERRQ(ierr);
+  ierr = PetscObjectStateIncrease((PetscObject)y);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   VecWAXPYNorm - Computes w = alpha x + y and the 2-norm of w, in a single pass over the vectors
+
+   Collective on Vec
+
+   Input Parameters:
++  alpha - the scalar
+-  x, y  - the vectors
+
+   Output Parameters:
++  w - the result, it may be y
+-  nrm - the 2-norm of w
+
+   Level: intermediate
+
+   Notes:
+    w cannot be x. With w = y this is VecAXPY() followed by VecNorm(), otherwise VecWAXPY() followed by VecNorm(), in
+    one pass and, in parallel, with a single reduction. The norm is cached in w, so a later VecNorm() or VecNormalize()
+    of w does not recompute it. Vector types that do not provide the fused operation call the separate operations.
+
+.seealso:  VecWAXPY(), VecAXPY(), VecNorm(), VecAXPYDot(), VecMAXPYMDot()
+@*/
+PetscErrorCode  VecWAXPYNorm(Vec w,PetscScalar alpha,Vec x,Vec y,PetscReal *nrm)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(w,VEC_CLASSID,1);
+  PetscValidHeaderSpecific(x,VEC_CLASSID,3);
+  PetscValidHeaderSpecific(y,VEC_CLASSID,4);
+  PetscValidRealPointer(nrm,5);
+  PetscValidType(w,1);
+  PetscValidType(x,3);
+  PetscValidType(y,4);
+  PetscCheckSameTypeAndComm(x,3,y,4);
+  PetscCheckSameTypeAndComm(y,4,w,1);
+  VecCheckSameSize(x,3,y,4);
+  VecCheckSameSize(x,3,w,1);
+  if (w == x) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_SUP,"Result vector w cannot be same as input vector x");
+  PetscValidLogicalCollectiveScalar(y,alpha,2);
+  if (!w->ops->waxpynorm) {
+    if (w == y) {ierr = VecAXPY(w,alpha,x);CHKERRQ(ierr);}
+    else {ierr = VecWAXPY(w,alpha,x,y);CHKERRQ(ierr);}
+    ierr = VecNorm(w,NORM_2,nrm);CHKERRQ(ierr);
+    PetscFunctionReturn(0);
+  }
+  ierr = VecSetErrorIfLocked(w,1);CHKERRQ(ierr);
+
+  ierr = PetscLogEventBegin(VEC_WAXPYNorm,x,y,w,0);CHKERRQ(ierr);
+  ierr = (*w->ops->waxpynorm)(w,alpha,x,y,nrm);CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(VEC_WAXPYNorm,x,y,w,0);CHKERRQ(ierr);
+  ierr = PetscObjectStateIncrease((PetscObject)w);CHKERRQ(ierr);
+  ierr = PetscObjectComposedDataSetReal((PetscObject)w,NormIds[NORM_2],*nrm);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+/*@
+   VecMAXPYMDot - Computes y = y + sum alpha[i] x[i], then the inner products of the updated y with the x[i] and its
+   2-norm, in a single pass over the vectors
+
+   Collective on Vec
+
+   Input Parameters:
++  y - the vector to update
+.  nv - number of scalars and x-vectors
+.  alpha - array of scalars
+-  x - array of vectors
+
+   Output Parameters:
++  y - the updated vector
+.  val - the inner products, as VecMDot(y,nv,x,val) would compute them, or NULL
+-  nrm - the 2-norm of the updated y, or NULL
+
+   Level: intermediate
+
+   Notes:
+    y cannot be any of the x vectors, val cannot be alpha
+
+    This fuses the VecMAXPY() of classical Gram-Schmidt with the VecMDot() of its second pass, or with the VecNorm()
+    that normalizes the new vector. All the values are summed in a single reduction. The norm is cached in y, so a later
+    VecNorm() or VecNormalize() of y does not recompute it. Vector types that do not provide the fused operation call
+    the separate operations.
+
+.seealso:  VecMAXPY(), VecMDot(), VecNorm(), VecAXPYDot(), VecWAXPYNorm()
+@*/
+PetscErrorCode  VecMAXPYMDot(Vec y,PetscInt nv,const PetscScalar alpha[],Vec x[],PetscScalar val[],PetscReal *nrm)
+{
+  PetscErrorCode ierr;
+  PetscInt       i;
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(y,VEC_CLASSID,1);
+  PetscValidLogicalCollectiveInt(y,nv,2);
+  if (nv < 0) SETERRQ1(PETSC_COMM_SELF,PETSC_ERR_ARG_OUTOFRANGE,"Number of vectors (given %D) cannot be negative",nv);
+  if (!nv) {
+    if (nrm) {ierr = VecNorm(y,NORM_2,nrm);CHKERRQ(ierr);}
+    PetscFunctionReturn(0);
+  }
+  PetscValidScalarPointer(alpha,3);
+  PetscValidPointer(x,4);
+  PetscValidHeaderSpecific(*x,VEC_CLASSID,4);
+  if (val) PetscValidScalarPointer(val,5);
+  if (nrm) PetscValidRealPointer(nrm,6);
+  PetscValidType(y,1);
+  PetscValidType(*x,4);
+  PetscCheckSameTypeAndComm(y,1,*x,4);
+  VecCheckSameSize(y,1,*x,4);
+  if (val == alpha) SETERRQ(PETSC_COMM_SELF,PETSC_ERR_ARG_IDN,"val and alpha cannot be the same array");
+  for (i=0; i<nv; i++) PetscValidLogicalCollectiveScalar(y,alpha[i],3);
+  if (!y->ops->maxpymdot) {
+    ierr = VecMAXPY(y,nv,alpha,x);CHKERRQ(ierr);
+    if (val) {ierr = VecMDot(y,nv,x,val);CHKERRQ(ierr);}
+    if (nrm) {ierr = VecNorm(y,NORM_2,nrm);CHKERRQ(ierr);}
+    PetscFunctionReturn(0);
+  }
+  ierr = VecSetErrorIfLocked(y,1);CHKERRQ(ierr);
+
+  ierr = PetscLogEventBegin(VEC_MAXPYMDot,*x,y,0,0);CHKERRQ(ierr);
+  ierr = (*y->ops->maxpymdot)(y,nv,alpha,x,val,nrm);CHKERRQ(ierr);
+  ierr = PetscLogEventEnd(VEC_MAXPYMDot,*x,y,0,0);CHKERRQ(ierr);
+  ierr = PetscObjectStateIncrease((PetscObject)y);CHKERRQ(ierr);
+  if (nrm) {ierr = PetscObjectComposedDataSetReal((PetscObject)y,NormIds[NORM_2],*nrm);CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
 /*@
    VecGetSubVector - Gets a vector representing part of another vector
 
@@ -249,6 +249,16 @@ int main(int argc,char **args)
       nsize: 12
       output_file: output/ex46_1_p12.out
 
+   testset:
+      args: -viewer_binary_mmap
+      test:
+         suffix: mmap_1
+         output_file: output/ex46_1_p1.out
+      test:
+         suffix: mmap_2
+         nsize: 6
+         output_file: output/ex46_1_p6.out
+
    testset:
       requires: mpiio
       args: -usempiio
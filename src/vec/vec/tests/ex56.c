@@ -0,0 +1,167 @@
+static char help[] = "Tests that VecAXPYDot(), VecWAXPYNorm() and VecMAXPYMDot() give the results of the separate operations with a single reduction.\n\n";
+
+#include <petscvec.h>
+
+static PetscErrorCode CheckVec(Vec u,Vec v,const char *name)
+{
+  Vec            d;
+  PetscReal      nrm,unrm;
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  ierr = VecDuplicate(u,&d);CHKERRQ(ierr);
+  ierr = VecWAXPY(d,-1.0,u,v);CHKERRQ(ierr);
+  ierr = VecNorm(d,NORM_2,&nrm);CHKERRQ(ierr);
+  ierr = VecNorm(u,NORM_2,&unrm);CHKERRQ(ierr);
+  if (nrm > 1.e-12*unrm) {ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: vectors differ by %g\n",name,(double)(nrm/unrm));CHKERRQ(ierr);}
+  ierr = VecDestroy(&d);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
+static PetscErrorCode CheckScalar(PetscScalar a,PetscScalar b,const char *name)
+{
+  PetscErrorCode ierr;
+
+  PetscFunctionBegin;
+  if (PetscAbsScalar(a-b) > 1.e-12*PetscAbsScalar(b)) {ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: values differ %g %g\n",name,(double)PetscAbsScalar(a),(double)PetscAbsScalar(b));CHKERRQ(ierr);}
+  PetscFunctionReturn(0);
+}
+
+/* a fused operation does a single reduction in parallel, and none on one process; nred holds the count of the event so far */
+static PetscErrorCode CheckReductions(const char event[],PetscLogDouble *nred)
+{
+#if defined(PETSC_USE_LOG)
+  PetscMPIInt        size;
+  PetscLogEvent      id;
+  PetscEventPerfInfo info;
+  PetscLogDouble     nexp;
+  PetscErrorCode     ierr;
+#endif
+
+  PetscFunctionBegin;
+#if defined(PETSC_USE_LOG)
+  ierr = MPI_Comm_size(PETSC_COMM_WORLD,&size);CHKERRQ(ierr);
+  ierr = PetscLogEventGetId(event,&id);CHKERRQ(ierr);
+  ierr = PetscLogEventGetPerfInfo(PETSC_DETERMINE,id,&info);CHKERRQ(ierr);
+  nexp = size > 1 ? 1.0 : 0.0;
+#if defined(PETSC_USE_DEBUG)
+  nexp *= 2.0; /* MPIU_Allreduce() first checks the calling line with a reduction of its own */
+#endif
+  if (info.numReductions - *nred != nexp) {ierr = PetscPrintf(PETSC_COMM_WORLD,"%s: %g reductions\n",event,(double)(info.numReductions - *nred));CHKERRQ(ierr);}
+  *nred = info.numReductions;
+#endif
+  PetscFunctionReturn(0);
+}
+
+int main(int argc,char **argv)
+{
+  Vec            x,y,z,y2,*X;
+  PetscInt       n = 1003,nv = 5,i;
+  PetscScalar    alpha = 0.7,dot,dot2,*alphas,*dots,*dots2;
+  PetscReal      nrm,nrm2;
+  PetscLogDouble nred[3] = {0.0,0.0,0.0};
+  PetscBool      available;
+  PetscRandom    rand;
+  PetscErrorCode ierr;
+
+  ierr = PetscInitialize(&argc,&argv,(char*)0,help);if (ierr) return ierr;
+#if defined(PETSC_USE_LOG)
+  ierr = PetscLogDefaultBegin();CHKERRQ(ierr);
+#endif
+  ierr = PetscOptionsGetInt(NULL,NULL,"-n",&n,NULL);CHKERRQ(ierr);
+  ierr = PetscOptionsGetInt(NULL,NULL,"-nv",&nv,NULL);CHKERRQ(ierr);
+  ierr = PetscRandomCreate(PETSC_COMM_WORLD,&rand);CHKERRQ(ierr);
+  ierr = PetscRandomSetFromOptions(rand);CHKERRQ(ierr);
+  ierr = VecCreate(PETSC_COMM_WORLD,&x);CHKERRQ(ierr);
+  ierr = VecSetSizes(x,PETSC_DECIDE,n);CHKERRQ(ierr);
+  ierr = VecSetFromOptions(x);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&y);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&z);CHKERRQ(ierr);
+  ierr = VecDuplicate(x,&y2);CHKERRQ(ierr);
+  ierr = VecSetRandom(x,rand);CHKERRQ(ierr);
+  ierr = VecSetRandom(y,rand);CHKERRQ(ierr);
+  ierr = VecSetRandom(z,rand);CHKERRQ(ierr);
+
+  /* y + alpha x and its inner product with z, x and itself */
+  ierr = VecCopy(y,y2);CHKERRQ(ierr);
+  ierr = VecAXPYDot(y,alpha,x,z,&dot);CHKERRQ(ierr);
+  ierr = CheckReductions("VecAXPYDot",&nred[0]);CHKERRQ(ierr);
+  ierr = VecAXPY(y2,alpha,x);CHKERRQ(ierr);
+  ierr = VecDot(y2,z,&dot2);CHKERRQ(ierr);
+  ierr = CheckVec(y2,y,"VecAXPYDot");CHKERRQ(ierr);
+  ierr = CheckScalar(dot,dot2,"VecAXPYDot");CHKERRQ(ierr);
+  ierr = VecAXPYDot(y,alpha,x,x,&dot);CHKERRQ(ierr);
+  ierr = CheckReductions("VecAXPYDot",&nred[0]);CHKERRQ(ierr);
+  ierr = VecAXPY(y2,alpha,x);CHKERRQ(ierr);
+  ierr = VecDot(y2,x,&dot2);CHKERRQ(ierr);
+  ierr = CheckScalar(dot,dot2,"VecAXPYDot with z = x");CHKERRQ(ierr);
+  ierr = VecAXPYDot(y,-alpha,x,y,&dot);CHKERRQ(ierr);
+  ierr = CheckReductions("VecAXPYDot",&nred[0]);CHKERRQ(ierr);
+  ierr = VecAXPY(y2,-alpha,x);CHKERRQ(ierr);
+  ierr = VecDot(y2,y2,&dot2);CHKERRQ(ierr);
+  ierr = CheckScalar(dot,dot2,"VecAXPYDot with z = y");CHKERRQ(ierr);
+
+  /* w = alpha x + y and its norm, in place or not */
+  ierr = VecWAXPYNorm(z,alpha,x,y,&nrm);CHKERRQ(ierr);
+  ierr = CheckReductions("VecWAXPYNorm",&nred[1]);CHKERRQ(ierr);
+  ierr = VecWAXPY(y2,alpha,x,y);CHKERRQ(ierr);
+  ierr = VecNorm(y2,NORM_2,&nrm2);CHKERRQ(ierr);
+  ierr = CheckVec(y2,z,"VecWAXPYNorm");CHKERRQ(ierr);
+  ierr = CheckScalar(nrm,nrm2,"VecWAXPYNorm");CHKERRQ(ierr);
+  ierr = VecNormAvailable(z,NORM_2,&available,&nrm2);CHKERRQ(ierr);
+  if (!available || nrm2 != nrm) {ierr = PetscPrintf(PETSC_COMM_WORLD,"VecWAXPYNorm: norm not cached\n");CHKERRQ(ierr);}
+  ierr = VecCopy(y,y2);CHKERRQ(ierr);
+  ierr = VecWAXPYNorm(y,alpha,x,y,&nrm);CHKERRQ(ierr);
+  ierr = CheckReductions("VecWAXPYNorm",&nred[1]);CHKERRQ(ierr);
+  ierr = VecAXPY(y2,alpha,x);CHKERRQ(ierr);
+  ierr = VecNorm(y2,NORM_2,&nrm2);CHKERRQ(ierr);
+  ierr = CheckVec(y2,y,"VecWAXPYNorm with w = y");CHKERRQ(ierr);
+  ierr = CheckScalar(nrm,nrm2,"VecWAXPYNorm with w = y");CHKERRQ(ierr);
+
+  /* y + sum alpha[i] X[i], its inner products with the X[i] and its norm */
+  ierr = VecDuplicateVecs(x,nv,&X);CHKERRQ(ierr);
+  ierr = PetscMalloc3(nv,&alphas,nv,&dots,nv,&dots2);CHKERRQ(ierr);
+  for (i=0; i<nv; i++) {
+    ierr      = VecSetRandom(X[i],rand);CHKERRQ(ierr);
+    alphas[i] = -1.0/(i+1);
+  }
+  ierr = VecCopy(y,y2);CHKERRQ(ierr);
+  ierr = VecMAXPYMDot(y,nv,alphas,X,dots,&nrm);CHKERRQ(ierr);
+  ierr = CheckReductions("VecMAXPYMDot",&nred[2]);CHKERRQ(ierr);
+  ierr = VecMAXPY(y2,nv,alphas,X);CHKERRQ(ierr);
+  ierr = VecMDot(y2,nv,X,dots2);CHKERRQ(ierr);
+  ierr = VecNorm(y2,NORM_2,&nrm2);CHKERRQ(ierr);
+  ierr = CheckVec(y2,y,"VecMAXPYMDot");CHKERRQ(ierr);
+  for (i=0; i<nv; i++) {ierr = CheckScalar(dots[i],dots2[i],"VecMAXPYMDot");CHKERRQ(ierr);}
+  ierr = CheckScalar(nrm,nrm2,"VecMAXPYMDot");CHKERRQ(ierr);
+  ierr = VecMAXPYMDot(y,nv,alphas,X,dots,NULL);CHKERRQ(ierr);
+  ierr = CheckReductions("VecMAXPYMDot",&nred[2]);CHKERRQ(ierr);
+  ierr = VecMAXPY(y2,nv,alphas,X);CHKERRQ(ierr);
+  ierr = VecMDot(y2,nv,X,dots2);CHKERRQ(ierr);
+  for (i=0; i<nv; i++) {ierr = CheckScalar(dots[i],dots2[i],"VecMAXPYMDot without norm");CHKERRQ(ierr);}
+  ierr = VecMAXPYMDot(y,nv,alphas,X,NULL,&nrm);CHKERRQ(ierr);
+  ierr = CheckReductions("VecMAXPYMDot",&nred[2]);CHKERRQ(ierr);
+  ierr = VecMAXPY(y2,nv,alphas,X);CHKERRQ(ierr);
+  ierr = VecNorm(y2,NORM_2,&nrm2);CHKERRQ(ierr);
+  ierr = CheckScalar(nrm,nrm2,"VecMAXPYMDot without inner products");CHKERRQ(ierr);
+  ierr = CheckVec(y2,y,"VecMAXPYMDot without inner products");CHKERRQ(ierr);
+
+  ierr = PetscFree3(alphas,dots,dots2);CHKERRQ(ierr);
+  ierr = VecDestroyVecs(nv,&X);CHKERRQ(ierr);
+  ierr = VecDestroy(&x);CHKERRQ(ierr);
+  ierr = VecDestroy(&y);CHKERRQ(ierr);
+  ierr = VecDestroy(&z);CHKERRQ(ierr);
+  ierr = VecDestroy(&y2);CHKERRQ(ierr);
+  ierr = PetscRandomDestroy(&rand);CHKERRQ(ierr);
+  ierr = PetscFinalize();
+  return ierr;
+}
+
+/*TEST
+
+   test:
+      nsize: {{1 3}}
+      args: -nv {{1 5 130}}
+      output_file: output/ex56_1.out
+
+TEST*/
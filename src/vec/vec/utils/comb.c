@@ -195,6 +195,39 @@ PetscErrorCode PetscSplitReductionEnd(PetscSplitReduction *sr)
   PetscFunctionReturn(0);
 }
 
+/*@
+   PetscCommSplitReductionProgress - Drives an asynchronous split-mode reduction started with PetscCommSplitReductionBegin()
+
+   Collective but not synchronizing
+
+   Input Arguments:
+   comm - communicator on which split reduction may have been started
+
+   Level: advanced
+
+   Notes:
+   Many MPI implementations only advance a nonblocking reduction while the process is inside the MPI library. Calling
+   this between pieces of local work, such as around MatMult() or PCApply() in the Krylov methods, lets the reduction
+   complete during that work so the following VecXxxEnd() does not have to wait for it.
+
+   Does nothing if there is no pending reduction on the communicator; it never creates the split reduction data.
+
+.seealso: PetscCommSplitReductionBegin(), VecNormBegin(), VecNormEnd(), VecDotBegin(), VecDotEnd(), VecMDotBegin(), VecMDotEnd()
+@*/
+PetscErrorCode PetscCommSplitReductionProgress(MPI_Comm comm)
+{
+  PetscErrorCode      ierr;
+  PetscSplitReduction *sr;
+  PetscMPIInt         flag;
+
+  PetscFunctionBegin;
+  if (Petsc_Reduction_keyval == MPI_KEYVAL_INVALID) PetscFunctionReturn(0);
+  ierr = MPI_Comm_get_attr(comm,Petsc_Reduction_keyval,(void**)&sr,&flag);CHKERRQ(ierr);
+  if (!flag || sr->state != STATE_PENDING || sr->request == MPI_REQUEST_NULL) PetscFunctionReturn(0);
+  ierr = MPI_Test(&sr->request,&flag,MPI_STATUS_IGNORE);CHKERRQ(ierr);
+  PetscFunctionReturn(0);
+}
+
 /*
    PetscSplitReductionApply - Actually do the communication required for a split phase reduction
 */